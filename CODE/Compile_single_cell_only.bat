@@ -1,4 +1,4 @@
-echo.
-PATH C:\Users\fbsmac\Documents\MinGW\bin
-:: Single cell: native (standard non-spatial)
-g++ Single_cell_native_main.cc lib/Arguments.c lib/Initialisation.c  lib/Model.c lib/Model*.cpp lib/Read_write_state.c lib/Outputs.cpp -o model_single_cell_native.exe
+echo.
+PATH C:\Users\fbsmac\Documents\MinGW\bin
+:: Single cell: native (standard non-spatial)
+g++ Single_cell_native_main.cc lib/Arguments.c lib/Initialisation.c  lib/Model.c lib/Model*.cpp lib/Read_write_state.c lib/Outputs.cpp lib/Output_writer.cpp lib/Output_container.cpp lib/Output_reduced.cpp lib/Checkpoint.cpp lib/Steady_state.cpp lib/Periodic_orbit.cpp lib/Restitution.cpp lib/Sensitivity.cpp -o model_single_cell_native.exe
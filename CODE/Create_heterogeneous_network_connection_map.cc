@@ -239,7 +239,7 @@ int main(int argc, char *argv[])
     SC_set_array_sizes(&SC, Tissue.NX, Tissue.NY, Tissue.NZ);   // Sets array sizes in SC struct from tissue settings
     SC_array_allocation_N3(&SC, SC.NX, SC.NY, SC.NZ);           // Allocates arrays of size NX*NY*NZ || geo and 3D->1D geo index
     printf(">Spatial coupling NX*NY*NZ arrays allocated\n");
-    select_tissue_geometry_function(Tissue, &SC, PATH, "Heterogeneous_connection_maps");  // lib/Tissue.cpp
+    select_tissue_geometry_function(Tissue, &SC, PATH, "Heterogeneous_connection_maps", true);  // lib/Tissue.cpp
     printf("\tGeometry size (X*Y*Z, %d * %d * %d) || Ncells = %d\n\n", Tissue.NX, SC.NY, SC.NZ, SC.N);
     
     // NETWORK calc Njunc based on geo
@@ -391,8 +391,9 @@ int main(int argc, char *argv[])
 
     }
     // delete
-    delete [] SC.geo;
-    delete [] SC.geo_index;
+    delete [] SC.brick;
+    free(SC.brick_geo);
+    free(SC.brick_index);
 
     delete [] Rand;
     delete [] Scale_map;
@@ -79,6 +79,7 @@
 #include "lib/Model.h"
 #include "lib/Read_write_state.h"
 #include "lib/Outputs.h"
+#include "lib/Output_container.h"
 #include "lib/Spatial_coupling.h"
 #include "lib/Tissue.h"
 
@@ -104,6 +105,10 @@ int main(int argc, char *argv[])
     int start_time, end_time, interval; // over which to convert data
     const char * variable;              // variable to read/write (Vm/Cai/CaSR)
     bool write_vtk = true;              // Whether to write vtk file
+    const char * vtk_format = "legacy"; // legacy (ASCII .vtk), vti or vtu (binary) || lib/Outputs.cpp
+    const char * vtk_precision = "float";
+    const char * vtk_compression = "Off";
+    const char * data_format = "bin";   // bin (one file per frame) or container (Spatial_data.msc) || lib/Output_container.cpp
     bool write_data = false;            // Whether to write plain text data file
     bool write_regions = false;
     //bool model_type_native = true;      // for native or integrated tissue models
@@ -209,6 +214,47 @@ int main(int argc, char *argv[])
         }
             
 
+        else if (strcmp(argv[counter], "Vtk_format") == 0)
+        {
+            vtk_format = argv[counter+1];
+            if (strcmp(vtk_format, "legacy") != 0 && strcmp(vtk_format, "vti") != 0 && strcmp(vtk_format, "vtu") != 0)
+            {
+                printf("ERROR: Vtk_format can only be legacy, vti or vtu\n");
+                exit(1);
+            }
+            counter++;
+        }
+        else if (strcmp(argv[counter], "Vtk_precision") == 0)
+        {
+            vtk_precision = argv[counter+1];
+            if (strcmp(vtk_precision, "float") != 0 && strcmp(vtk_precision, "double") != 0)
+            {
+                printf("ERROR: Vtk_precision can only be float or double\n");
+                exit(1);
+            }
+            counter++;
+        }
+        else if (strcmp(argv[counter], "Vtk_compression") == 0)
+        {
+            vtk_compression = argv[counter+1];
+            if (strcmp(vtk_compression, "Off") != 0 && strcmp(vtk_compression, "zlib") != 0)
+            {
+                printf("ERROR: Vtk_compression can only be Off or zlib\n");
+                exit(1);
+            }
+            counter++;
+        }
+        else if (strcmp(argv[counter], "Data_format") == 0)
+        {
+            data_format = argv[counter+1];
+            if (strcmp(data_format, "bin") != 0 && strcmp(data_format, "container") != 0)
+            {
+                printf("ERROR: Data_format can only be bin or container\n");
+                exit(1);
+            }
+            counter++;
+        }
+
         else
         {
             printf("ERROR: \"%s\" is not a valid argument for this post processing\n", argv[counter]);
@@ -216,6 +262,8 @@ int main(int argc, char *argv[])
             printf("\tReference [text]\tResults_Reference [text]\tModel [text]\tTissue_order  [1D/2D/3D/geo]\t Tissue_model [basic, ...]\tModel_type [native/integrated]\n");
             printf("\tVarianble [Vm/Cai/CaSR]\tstart_time [int]\tend_time [int]\tinterval [n ms]\n");
             printf("\tWrite_vtk [On/Off]\tWrite_data [On/Off]");
+            printf("\tVtk_format [legacy/vti/vtu]\tVtk_precision [float/double]\tVtk_compression [Off/zlib]\n");
+            printf("\tData_format [bin/container]\n");
             exit(1);
         }
         counter++;
@@ -289,7 +337,7 @@ int main(int argc, char *argv[])
     SC_set_array_sizes(&SC, Tissue.NX, Tissue.NY, Tissue.NZ);   // Sets array sizes in SC struct from tissue settings
     SC_array_allocation_N3(&SC, SC.NX, SC.NY, SC.NZ);           // Allocates arrays of size NX*NY*NZ || geo and 3D->1D geo index
     printf(">Spatial coupling NX*NY*NZ arrays allocated\n");
-    select_tissue_geometry_function(Tissue, &SC, PATH, directory);  // lib/Tissue.cpp
+    select_tissue_geometry_function(Tissue, &SC, PATH, directory, true);  // lib/Tissue.cpp
     printf("\tGeometry size (X*Y*Z, %d * %d * %d) || Ncells = %d\n\n", Tissue.NX, SC.NY, SC.NZ, SC.N);
 
     // Allocate variable
@@ -297,17 +345,34 @@ int main(int argc, char *argv[])
 
     int iteration;
 
+    // Unstructured vtk: cell coordinates and celltypes written once || lib/Outputs.cpp
+    if (write_vtk == true && strcmp(vtk_format, "vtu") == 0) vtk_xml_geometry_output(directory, sr_dir, SC, vtk_compression);
+
+    // Container: open once and read frames by random access || lib/Output_container.cpp
+    Output_container container;
+    if (strcmp(data_format, "container") == 0)
+    {
+        output_container_open(&container, directory, sr_dir, "Spatial_data.msc");
+        printf("Container %s opened: NX = %d NY = %d NZ = %d Ncells = %d, %lld frames\n", container.filename, container.NX, container.NY, container.NZ, container.N, (long long)container.Nframes);
+        if (container.N != SC.N || container.NX != SC.NX || container.NY != SC.NY || container.NZ != SC.NZ)
+        {
+            printf("ERROR: container geometry (%d * %d * %d, Ncells = %d) does not match the geometry set up from the arguments (%d * %d * %d, Ncells = %d)\n", container.NX, container.NY, container.NZ, container.N, SC.NX, SC.NY, SC.NZ, SC.N);
+            exit(1);
+        }
+    }
+
     for (iteration = start_time; iteration <= end_time; iteration += interval)
     {
         // Read in binary data || lib/Outputs.cpp
-        array_1D_binary_read(variable, directory, sr_dir, V, SC, iteration);
+        if (strcmp(data_format, "container") == 0) output_container_read_frame(&container, variable, iteration, V); // lib/Output_container.cpp
+        else array_1D_binary_read(variable, directory, sr_dir, V, SC, iteration);
 
         // Output as vtk
         if (write_vtk == true) 
         {
-            sprintf(filename_out, "%s/%s/%s_output_%04d.vtk", directory, sr_dir, variable, iteration);
+            sprintf(filename_out, "%s/%s/%s_output_%04d.%s", directory, sr_dir, variable, iteration, strcmp(vtk_format, "legacy") == 0 ? "vtk" : vtk_format);
             printf("Creating visualisation file %s\n", filename_out);
-            vtk_3D_output(variable, directory, sr_dir, V, SC, iteration);
+            vtk_3D_output_format(variable, directory, sr_dir, V, SC, iteration, vtk_format, vtk_precision, vtk_compression);
 
             if (write_regions == true)
             {
@@ -327,10 +392,13 @@ int main(int argc, char *argv[])
         }
     }
 
+    if (strcmp(data_format, "container") == 0) output_container_close(&container);
+
     // delete
     delete [] V;
-    delete [] SC.geo;
-    delete [] SC.geo_index;
+    delete [] SC.brick;
+    free(SC.brick_geo);
+    free(SC.brick_index);
     free(directory);
     free(results_dir);
     free(sr_dir);
@@ -0,0 +1,225 @@
+// Source code associated with  ===========================  //
+// "Multi-scale cardiac simulation framework" =============  //
+// For simulation of cardiac cellular and tissue dynamics =  //
+// from the spatial cellular to full organ scales. ========  //
+// With implementation of multiple, published cell models =  //
+// as well as novel models developed in my lab. ===========  //
+// ========================================================  //
+// This file: Converts text geometry, fibre ===============  //
+// and map files to binary inputs =========================  //
+// ========================================================  //
+// GNU 3 LICENSE TEXT =====================================  //
+// COPYRIGHT (C) 2016-2019 MICHAEL A. COLMAN ==============  //
+// THIS PROGRAM IS FREE SOFTWARE: YOU CAN REDISTRIBUTE IT =  //
+// AND/OR MODIFY IT UNDER THE TERMS OF THE GNU GENERAL ====  //
+// PUBLIC LICENSE AS PUBLISHED BY THE FREE SOFTWARE =======  //
+// FOUNDATION, EITHER VERSION 3 OF THE LICENSE, OR (AT YOUR  //
+// OPTION) ANY LATER VERSION. =============================  //
+// THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE=  //
+// USEFUL, BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE =====  //
+// IMPLIED WARRANTY OF MERCHANTABILITY OR FITNESS FOR A ===  //
+// PARTICULAR PURPOSE.  SEE THE GNU GENERAL PUBLIC LICENSE=  //
+// FOR MORE DETAILS. ======================================  //
+// YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL =====  //
+// PUBLIC LICENSE ALONG WITH THIS PROGRAM.  IF NOT, SEE ===  //
+// <https://www.gnu.org/licenses/>. =======================  //
+// ========================================================  //
+// ADDITIONAL LICENSE TEXT ================================  //
+// THIS SOFTWARE IS PROVIDED OPEN SOURCE AND MAY BE FREELY=  //
+// USED, DISTRIBUTED AND UPDATED, PROVIDED: ===============  //
+//  (i) THE APPROPRIATE WORK(S) IS(ARE) CITED. THIS =======  //
+//      PERTAINS TO THE CITATION OF COLMAN 2019 PLOS COMP =  //
+//      BIOL (FOR THIS IMPLEMTATION) AND ALL WORKS ========  //
+//      ASSOCIATED WITH THE SPECIFIC MODELS AND COMPONENTS=  //
+//      USED IN PARTICULAR SIMULATIONS. IT IS THE USER'S ==  //
+//      RESPONSIBILITY TO ENSURE ALL RELEVANT WORKS ARE ===  //
+//      CITED. PLEASE SEE FULL DOCUMENTATION AND ON-SCREEN=  //
+//      DISCLAIMER OUTPUTS FOR A GUIDE. ===================  //
+//  (ii) ALL OF THIS TEXT IS RETAINED WITHIN OR ASSOCIATED=  //
+//      WITH THE SOURCE CODE AND/OR BINARY FORM OF THE ====  //
+//      SOFTWARE. =========================================  //
+// ========================================================  //
+// ANY INTENDED COMMERCIAL USE OF THIS SOFTWARE MUST BE BY   //
+// EXPRESS PERMISSION OF MICHAEL A COLMAN ONLY. IN NO EVENT  //
+// ARE THE COPYRIGHT HOLDERS LIABLE FOR ANY DIRECT, =======  //
+// INDIRECT INCIDENTAL, SPECIAL, EXEMPLARY OR CONSEQUENTIAL  //
+// DAMAGES ASSOCIATED WITH USE OF THIS SOFTWARE ===========  //
+// ========================================================  //
+// THIS SOFTWARE CONTAINS IMPLEMENTATIONS OF MODELS AND ===  //
+// COMPONENTS WHICH I (MICHAEL COLMAN) DID NOT DEVELOP.====  //
+// ALL OF THESE COMPONENTS HAVE BEEN CODED FROM PROVIDED ==  //
+// SOURCE CODE OR INFORMATION IN THE PUBLICATIONS. ========  //
+// I CLAIM NO RIGHTS OR INTELLECTUAL PROPERTY OWNERSHIP ===  //
+// FOR THESE MODELS AND COMPONENTS, OTHER THAN THEIR ======  //
+// SPECIFIC IMPLEMENTATION IN THIS CODE PACKAGE. FURTHER TO  //
+// THE ABOVE STATEMENT, ANY INDTENDED COMMERCIAL USE OF ===  //
+// THOSE COMPONENTS MUST BE BY EXPRESS PERMISSION OF THE ==  //
+// ORIGINAL COPYRIGHT HOLDERS. ============================  //
+// WHERE IMPLEMENTED FROM PROVIDED CODE, ANY DISCLAIMERS ==  //
+// PRESENT IN THE ORIGINAL CODE HAVE BEEN RETAINED IN THE =  //
+// RELEVANT FILE. =========================================  //
+// ========================================================  //
+// Contact: m.a.colman@leeds.ac.uk ========================  //
+// For updates, corrections etc, please check: ============  //
+// 1. http://physicsoftheheart.com/ =======================  //
+// 2. https://github.com/michaelcolman ====================  //
+// ========================================================  //
+
+// Converts text geometry, fibre and map input files (whitespace separated, one value per voxel of 
+// the NX*NY*NZ box) to the binary input format (lib/Binary_inputs.h), read by the tissue and cell
+// models in place of the text file. Text is parsed in parallel (OpenMP).
+// Types:   geo      -> int     (geometry; box indexed only)
+//          map_int  -> int     (stimulus, phase and other integer maps)
+//          map      -> double  (D, ISO, remodelling, SRF... maps)
+//          fibre    -> float   (OX/OY/OZ, theta/phi; Components 3 for {root}_orientation.dat)
+// Indexing cell stores one entry per tissue cell only (requires the Geometry file).
+// Usage examples:
+//   ./convert_inputs Input Tissue_geometries/Canine_vent_geo.dat Type geo NX 128 NY 128 NZ 115
+//   ./convert_inputs Input Tissue_geometries/Canine_vent_OX.dat Type fibre NX 128 NY 128 NZ 115 Indexing cell Geometry Tissue_geometries/Canine_vent_geo.dat
+// The output (default: Input with extension .bin) replaces the text file by setting its name in 
+// the tissue model (or by renaming it to the text file name).
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <cstring>
+#include <omp.h>
+
+#include "lib/Structs.h"
+#include "lib/Spatial_coupling.h"
+#include "lib/Binary_inputs.h"
+
+using namespace std;
+
+int main(int argc, char *argv[])
+{
+    const char * input      = NULL;
+    const char * geometry   = NULL;         // geometry file (text or binary) for cell indexing
+    const char * type       = NULL;         // geo, map_int, map or fibre
+    const char * indexing   = "box";        // box or cell
+    char output[1000];
+    int components  = 1;
+    int NX = 0, NY = 0, NZ = 0;
+    int Nthreads    = 0;                    // 0 = OpenMP default
+    output[0] = '\0';
+
+    int counter = 1;
+    while (counter < argc)
+    {
+        if (counter + 1 >= argc)
+        {
+            printf("ERROR: argument \"%s\" requires a value\n", argv[counter]);
+            exit(1);
+        }
+        if      (strcmp(argv[counter], "Input") == 0)               input       = argv[counter+1];
+        else if (strcmp(argv[counter], "Output") == 0)              sprintf(output, "%s", argv[counter+1]);
+        else if (strcmp(argv[counter], "Geometry") == 0)            geometry    = argv[counter+1];
+        else if (strcmp(argv[counter], "Components") == 0)          components  = atoi(argv[counter+1]);
+        else if (strcmp(argv[counter], "NX") == 0)                  NX          = atoi(argv[counter+1]);
+        else if (strcmp(argv[counter], "NY") == 0)                  NY          = atoi(argv[counter+1]);
+        else if (strcmp(argv[counter], "NZ") == 0)                  NZ          = atoi(argv[counter+1]);
+        else if (strcmp(argv[counter], "Threads") == 0)             Nthreads    = atoi(argv[counter+1]);
+        else if (strcmp(argv[counter], "Type") == 0)
+        {
+            type = argv[counter+1];
+            if (strcmp(type, "geo") != 0 && strcmp(type, "map_int") != 0 && strcmp(type, "map") != 0 && strcmp(type, "fibre") != 0)
+            {
+                printf("ERROR: Type can only be geo, map_int, map or fibre\n");
+                exit(1);
+            }
+        }
+        else if (strcmp(argv[counter], "Indexing") == 0)
+        {
+            indexing = argv[counter+1];
+            if (strcmp(indexing, "box") != 0 && strcmp(indexing, "cell") != 0)
+            {
+                printf("ERROR: Indexing can only be box or cell\n");
+                exit(1);
+            }
+        }
+        else
+        {
+            printf("ERROR: \"%s\" is not a valid argument for this conversion\n", argv[counter]);
+            printf("Please use ONLY:\n");
+            printf("\tInput [file]\tOutput [file]\tType [geo/map_int/map/fibre]\tComponents [n]\n");
+            printf("\tNX [int]\tNY [int]\tNZ [int]\tIndexing [box/cell]\tGeometry [file]\tThreads [n]\n");
+            exit(1);
+        }
+        counter += 2;
+    }
+
+    if (input == NULL || type == NULL || NX < 1 || NY < 1 || NZ < 1 || components < 1)
+    {
+        printf("ERROR: Input, Type and NX, NY, NZ must be given (e.g. Input Tissue_geometries/geo.dat Type geo NX 100 NY 100 NZ 50)\n");
+        exit(1);
+    }
+    if (strcmp(indexing, "cell") == 0 && (geometry == NULL || strcmp(type, "geo") == 0))
+    {
+        printf("ERROR: cell indexing requires the Geometry file, and is not valid for Type geo\n");
+        exit(1);
+    }
+    if (Nthreads > 0) omp_set_num_threads(Nthreads);
+    if (output[0] == '\0')
+    {
+        sprintf(output, "%s", input);
+        char *dot = strrchr(output, '.');
+        if (dot != NULL && strchr(dot, '/') == NULL) *dot = '\0';
+        strcat(output, ".bin");
+    }
+    if (strcmp(output, input) == 0)
+    {
+        printf("ERROR: Output must differ from Input\n");
+        exit(1);
+    }
+
+    double start = omp_get_wtime();
+    int64_t N3 = (int64_t)NX*NY*NZ;
+    double *values;
+    int64_t count = binary_input_parse_text(input, &values);
+    if (count < N3*components)
+    {
+        printf("ERROR: %s has %lld values; NX*NY*NZ*Components = %lld\n", input, (long long)count, (long long)(N3*components));
+        exit(1);
+    }
+    if (count > N3*components) printf("WARNING: %s has %lld values; only the first %lld are used (as the text readers)\n", input, (long long)count, (long long)(N3*components));
+    count = N3;
+
+    // Cell indexing: keep tissue voxels only (1D cell order, as the Ncell arrays)
+    if (strcmp(indexing, "cell") == 0)
+    {
+        SC_variables sc;
+        memset(&sc, 0, sizeof(SC_variables));
+        SC_set_array_sizes(&sc, NX, NY, NZ);
+        SC_array_allocation_N3(&sc, NX, NY, NZ);    // lib/Spatial_coupling.cpp
+        if (binary_input_check(geometry) == true) binary_input_read_geo(geometry, &sc);
+        else
+        {
+            double *geo_values;
+            if (binary_input_parse_text(geometry, &geo_values) < N3)
+            {
+                printf("ERROR: geometry %s has fewer than NX*NY*NZ values\n", geometry);
+                exit(1);
+            }
+            for (int64_t idx = 0; idx < N3; idx++) SC_set_geo(&sc, idx, (int)geo_values[idx]);
+            free(geo_values);
+        }
+        count = 0;
+        for (int64_t idx = 0; idx < N3; idx++)
+        {
+            if (SC_geo(&sc, idx) <= 0) continue;
+            for (int c = 0; c < components; c++) values[count*components + c] = values[idx*components + c];
+            count++;
+        }
+        delete [] sc.brick;
+        free(sc.brick_geo);
+        free(sc.brick_index);
+    }
+
+    int bi_type = BI_FLOAT64;
+    if (strcmp(type, "geo") == 0 || strcmp(type, "map_int") == 0) bi_type = BI_INT32;
+    else if (strcmp(type, "fibre") == 0) bi_type = BI_FLOAT32;
+
+    binary_input_write(output, bi_type, components, strcmp(indexing, "cell") == 0 ? BI_CELL : BI_BOX, NX, NY, NZ, count, values, input);
+    printf("%s -> %s || %s, %s indexed, %lld entries of %d values (%.2f s)\n", input, output, type, indexing, (long long)count, components, omp_get_wtime() - start);
+    free(values);
+    return 0;
+}
@@ -0,0 +1,384 @@
+// Source code associated with  ===========================  //
+// "Multi-scale cardiac simulation framework" =============  //
+// For simulation of cardiac cellular and tissue dynamics =  //
+// from the spatial cellular to full organ scales. ========  //
+// With implementation of multiple, published cell models =  //
+// as well as novel models developed in my lab. ===========  //
+// ========================================================  //
+// This file: Standalone parallel converter ===============  //
+// of spatial binary outputs to vtk =======================  //
+// ========================================================  //
+// GNU 3 LICENSE TEXT =====================================  //
+// COPYRIGHT (C) 2016-2019 MICHAEL A. COLMAN ==============  //
+// THIS PROGRAM IS FREE SOFTWARE: YOU CAN REDISTRIBUTE IT =  //
+// AND/OR MODIFY IT UNDER THE TERMS OF THE GNU GENERAL ====  //
+// PUBLIC LICENSE AS PUBLISHED BY THE FREE SOFTWARE =======  //
+// FOUNDATION, EITHER VERSION 3 OF THE LICENSE, OR (AT YOUR  //
+// OPTION) ANY LATER VERSION. =============================  //
+// THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE=  //
+// USEFUL, BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE =====  //
+// IMPLIED WARRANTY OF MERCHANTABILITY OR FITNESS FOR A ===  //
+// PARTICULAR PURPOSE.  SEE THE GNU GENERAL PUBLIC LICENSE=  //
+// FOR MORE DETAILS. ======================================  //
+// YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL =====  //
+// PUBLIC LICENSE ALONG WITH THIS PROGRAM.  IF NOT, SEE ===  //
+// <https://www.gnu.org/licenses/>. =======================  //
+// ========================================================  //
+// ADDITIONAL LICENSE TEXT ================================  //
+// THIS SOFTWARE IS PROVIDED OPEN SOURCE AND MAY BE FREELY=  //
+// USED, DISTRIBUTED AND UPDATED, PROVIDED: ===============  //
+//  (i) THE APPROPRIATE WORK(S) IS(ARE) CITED. THIS =======  //
+//      PERTAINS TO THE CITATION OF COLMAN 2019 PLOS COMP =  //
+//      BIOL (FOR THIS IMPLEMTATION) AND ALL WORKS ========  //
+//      ASSOCIATED WITH THE SPECIFIC MODELS AND COMPONENTS=  //
+//      USED IN PARTICULAR SIMULATIONS. IT IS THE USER'S ==  //
+//      RESPONSIBILITY TO ENSURE ALL RELEVANT WORKS ARE ===  //
+//      CITED. PLEASE SEE FULL DOCUMENTATION AND ON-SCREEN=  //
+//      DISCLAIMER OUTPUTS FOR A GUIDE. ===================  //
+//  (ii) ALL OF THIS TEXT IS RETAINED WITHIN OR ASSOCIATED=  //
+//      WITH THE SOURCE CODE AND/OR BINARY FORM OF THE ====  //
+//      SOFTWARE. =========================================  //
+// ========================================================  //
+// ANY INTENDED COMMERCIAL USE OF THIS SOFTWARE MUST BE BY   //
+// EXPRESS PERMISSION OF MICHAEL A COLMAN ONLY. IN NO EVENT  //
+// ARE THE COPYRIGHT HOLDERS LIABLE FOR ANY DIRECT, =======  //
+// INDIRECT INCIDENTAL, SPECIAL, EXEMPLARY OR CONSEQUENTIAL  //
+// DAMAGES ASSOCIATED WITH USE OF THIS SOFTWARE ===========  //
+// ========================================================  //
+// THIS SOFTWARE CONTAINS IMPLEMENTATIONS OF MODELS AND ===  //
+// COMPONENTS WHICH I (MICHAEL COLMAN) DID NOT DEVELOP.====  //
+// ALL OF THESE COMPONENTS HAVE BEEN CODED FROM PROVIDED ==  //
+// SOURCE CODE OR INFORMATION IN THE PUBLICATIONS. ========  //
+// I CLAIM NO RIGHTS OR INTELLECTUAL PROPERTY OWNERSHIP ===  //
+// FOR THESE MODELS AND COMPONENTS, OTHER THAN THEIR ======  //
+// SPECIFIC IMPLEMENTATION IN THIS CODE PACKAGE. FURTHER TO  //
+// THE ABOVE STATEMENT, ANY INDTENDED COMMERCIAL USE OF ===  //
+// THOSE COMPONENTS MUST BE BY EXPRESS PERMISSION OF THE ==  //
+// ORIGINAL COPYRIGHT HOLDERS. ============================  //
+// WHERE IMPLEMENTED FROM PROVIDED CODE, ANY DISCLAIMERS ==  //
+// PRESENT IN THE ORIGINAL CODE HAVE BEEN RETAINED IN THE =  //
+// RELEVANT FILE. =========================================  //
+// ========================================================  //
+// Contact: m.a.colman@leeds.ac.uk ========================  //
+// For updates, corrections etc, please check: ============  //
+// 1. http://physicsoftheheart.com/ =======================  //
+// 2. https://github.com/michaelcolman ====================  //
+// ========================================================  //
+
+// Converts binary spatial outputs (.bin files or Spatial_data.msc container) to vtk without re-running 
+// any tissue or cell setup: the geometry is read from the sidecar (Geometry_index.msc) or container.
+// Frames are converted in parallel (OpenMP), each thread holding only one frame at a time.
+// Usage example:
+//   ./convert_spatial Results_dir Outputs_tissue_native/Spatial_Results_X Variable Vm,Cai start_time 100 end_time 500 interval 5
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <cstring>
+#include <omp.h>
+
+#include "lib/Structs.h"
+#include "lib/Spatial_coupling.h"
+#include "lib/Outputs.h"
+#include "lib/Output_container.h"
+
+using namespace std;
+
+// Splits path into parent directory and final component (Outputs functions take dir and dir2)
+void split_path(const char *path, char *dir, char *dir2)
+{
+    char p[1000];
+    sprintf(p, "%s", path);
+    int len = strlen(p);
+    while (len > 1 && p[len-1] == '/') p[--len] = '\0';
+    char *slash = strrchr(p, '/');
+    if (slash == NULL) { sprintf(dir, "."); sprintf(dir2, "%s", p); }
+    else { *slash = '\0'; sprintf(dir, "%s", p); sprintf(dir2, "%s", slash+1); }
+}
+
+typedef struct{
+    char    variable[OC_VAR_LENGTH];
+    int     count;
+}Convert_frame;
+
+int main(int argc, char *argv[])
+{
+    const char * results_dir    = NULL;         // spatial results directory of the simulation
+    const char * output_dir     = NULL;         // where vtk is written (default results_dir)
+    char variables[1000];                       // comma separated list
+    const char * data_format    = "auto";       // auto (container if present), bin or container
+    const char * vtk_format     = "vti";        // legacy, vti or vtu || lib/Outputs.cpp
+    const char * vtk_precision  = "float";
+    const char * vtk_compression = "Off";
+    const char * region_celltypes = NULL;       // comma separated list of celltypes to keep (default all)
+    int start_time  = 0;
+    int end_time    = -1;                       // -1 = all frames in container (required for bin)
+    int interval    = 1;
+    int X_min = 0, Y_min = 0, Z_min = 0;
+    int X_max = -1, Y_max = -1, Z_max = -1;     // -1 = to edge of box
+    int Nthreads    = 0;                        // 0 = OpenMP default
+    sprintf(variables, "Vm");
+
+    int counter = 1;
+    while (counter < argc)
+    {
+        if (counter + 1 >= argc)
+        {
+            printf("ERROR: argument \"%s\" requires a value\n", argv[counter]);
+            exit(1);
+        }
+        if      (strcmp(argv[counter], "Results_dir") == 0)         results_dir     = argv[counter+1];
+        else if (strcmp(argv[counter], "Output_dir") == 0)          output_dir      = argv[counter+1];
+        else if (strcmp(argv[counter], "Variable") == 0)            sprintf(variables, "%s", argv[counter+1]);
+        else if (strcmp(argv[counter], "start_time") == 0)          start_time      = atoi(argv[counter+1]);
+        else if (strcmp(argv[counter], "end_time") == 0)            end_time        = atoi(argv[counter+1]);
+        else if (strcmp(argv[counter], "interval") == 0)            interval        = atoi(argv[counter+1]);
+        else if (strcmp(argv[counter], "Region_celltypes") == 0)    region_celltypes = argv[counter+1];
+        else if (strcmp(argv[counter], "X_min") == 0)               X_min           = atoi(argv[counter+1]);
+        else if (strcmp(argv[counter], "X_max") == 0)               X_max           = atoi(argv[counter+1]);
+        else if (strcmp(argv[counter], "Y_min") == 0)               Y_min           = atoi(argv[counter+1]);
+        else if (strcmp(argv[counter], "Y_max") == 0)               Y_max           = atoi(argv[counter+1]);
+        else if (strcmp(argv[counter], "Z_min") == 0)               Z_min           = atoi(argv[counter+1]);
+        else if (strcmp(argv[counter], "Z_max") == 0)               Z_max           = atoi(argv[counter+1]);
+        else if (strcmp(argv[counter], "Threads") == 0)             Nthreads        = atoi(argv[counter+1]);
+        else if (strcmp(argv[counter], "Data_format") == 0)
+        {
+            data_format = argv[counter+1];
+            if (strcmp(data_format, "auto") != 0 && strcmp(data_format, "bin") != 0 && strcmp(data_format, "container") != 0)
+            {
+                printf("ERROR: Data_format can only be auto, bin or container\n");
+                exit(1);
+            }
+        }
+        else if (strcmp(argv[counter], "Vtk_format") == 0)
+        {
+            vtk_format = argv[counter+1];
+            if (strcmp(vtk_format, "legacy") != 0 && strcmp(vtk_format, "vti") != 0 && strcmp(vtk_format, "vtu") != 0)
+            {
+                printf("ERROR: Vtk_format can only be legacy, vti or vtu\n");
+                exit(1);
+            }
+        }
+        else if (strcmp(argv[counter], "Vtk_precision") == 0)
+        {
+            vtk_precision = argv[counter+1];
+            if (strcmp(vtk_precision, "float") != 0 && strcmp(vtk_precision, "double") != 0)
+            {
+                printf("ERROR: Vtk_precision can only be float or double\n");
+                exit(1);
+            }
+        }
+        else if (strcmp(argv[counter], "Vtk_compression") == 0)
+        {
+            vtk_compression = argv[counter+1];
+            if (strcmp(vtk_compression, "Off") != 0 && strcmp(vtk_compression, "zlib") != 0)
+            {
+                printf("ERROR: Vtk_compression can only be Off or zlib\n");
+                exit(1);
+            }
+#ifndef MSCSF_ZLIB
+            if (strcmp(vtk_compression, "zlib") == 0)
+            {
+                printf("ERROR: Vtk_compression zlib requires the code to be compiled with zlib (see Makefile)\n");
+                exit(1);
+            }
+#endif
+        }
+        else
+        {
+            printf("ERROR: \"%s\" is not a valid argument for this post processing\n", argv[counter]);
+            printf("Please use ONLY:\n");
+            printf("\tResults_dir [path]\tOutput_dir [path]\tVariable [Vm or list e.g. Vm,Cai]\tData_format [auto/bin/container]\n");
+            printf("\tstart_time [int]\tend_time [int]\tinterval [n ms]\tThreads [n]\n");
+            printf("\tRegion_celltypes [list e.g. 1,2]\t{X/Y/Z}_min [int]\t{X/Y/Z}_max [int]\n");
+            printf("\tVtk_format [legacy/vti/vtu]\tVtk_precision [float/double]\tVtk_compression [Off/zlib]\n");
+            exit(1);
+        }
+        counter += 2;
+    }
+
+    if (results_dir == NULL)
+    {
+        printf("ERROR: Results_dir must be given (e.g. Results_dir Outputs_tissue_native/Spatial_Results_X)\n");
+        exit(1);
+    }
+    if (output_dir == NULL) output_dir = results_dir;
+    if (interval < 1) interval = 1;
+    if (Nthreads > 0) omp_set_num_threads(Nthreads);
+
+    char dir[1000], dir2[1000], out_dir[1000], out_dir2[1000], str[2000];
+    split_path(results_dir, dir, dir2);
+    split_path(output_dir, out_dir, out_dir2);
+    sprintf(str, "mkdir -p %s", output_dir);
+    system(str);
+
+    // Geometry from container or sidecar || lib/Output_container.cpp
+    if (strcmp(data_format, "auto") == 0)
+    {
+        sprintf(str, "%s/%s/Spatial_data.msc", dir, dir2);
+        FILE *test = fopen(str, "rb");
+        data_format = (test != NULL) ? "container" : "bin";
+        if (test != NULL) fclose(test);
+    }
+    bool container_mode = (strcmp(data_format, "container") == 0);
+    const char *geometry_name = container_mode ? "Spatial_data.msc" : "Geometry_index.msc";
+
+    Output_container geometry;
+    output_container_open(&geometry, dir, dir2, geometry_name);
+    printf("Geometry read from %s: NX = %d NY = %d NZ = %d Ncells = %d\n", geometry.filename, geometry.NX, geometry.NY, geometry.NZ, geometry.N);
+
+    // Region: sub-box and/or celltypes; sub-box cell order is the same (x fastest) as the full box
+    if (X_max < 0 || X_max >= geometry.NX) X_max = geometry.NX - 1;
+    if (Y_max < 0 || Y_max >= geometry.NY) Y_max = geometry.NY - 1;
+    if (Z_max < 0 || Z_max >= geometry.NZ) Z_max = geometry.NZ - 1;
+    if (X_min < 0) X_min = 0;
+    if (Y_min < 0) Y_min = 0;
+    if (Z_min < 0) Z_min = 0;
+    if (X_min > X_max || Y_min > Y_max || Z_min > Z_max)
+    {
+        printf("ERROR: region X %d-%d Y %d-%d Z %d-%d is empty\n", X_min, X_max, Y_min, Y_max, Z_min, Z_max);
+        exit(1);
+    }
+    bool keep_celltype[1000];
+    for (int i = 0; i < 1000; i++) keep_celltype[i] = (region_celltypes == NULL);
+    if (region_celltypes != NULL)
+    {
+        char list[1000];
+        sprintf(list, "%s", region_celltypes);
+        for (char *tok = strtok(list, ","); tok != NULL; tok = strtok(NULL, ","))
+        {
+            int ct = atoi(tok);
+            if (ct > 0 && ct < 1000) keep_celltype[ct] = true;
+        }
+    }
+
+    SC_variables SC;
+    SC.NX = X_max - X_min + 1;
+    SC.NY = Y_max - Y_min + 1;
+    SC.NZ = Z_max - Z_min + 1;
+    SC_array_allocation_N3(&SC, SC.NX, SC.NY, SC.NZ);  // lib/Spatial_coupling.cpp
+    int *cell_map = new int [geometry.N];       // region cell -> full cell
+    SC.N = 0;
+    for (int n = 0; n < geometry.N; n++)
+    {
+        int idx = geometry.cell_box_index[n];
+        int x = idx % geometry.NX;
+        int y = (idx / geometry.NX) % geometry.NY;
+        int z = idx / (geometry.NX*geometry.NY);
+        int ct = geometry.celltype[n];
+        if (x < X_min || x > X_max || y < Y_min || y > Y_max || z < Z_min || z > Z_max) continue;
+        if (ct <= 0 || ct >= 1000 || keep_celltype[ct] == false) continue;
+        SC_set_geo(&SC, (x-X_min) + SC.NX*(y-Y_min) + SC.NX*SC.NY*(z-Z_min), ct);
+        cell_map[SC.N++] = n;
+    }
+    bool full_region = (SC.N == geometry.N);
+    printf("Region: X %d-%d Y %d-%d Z %d-%d, %d of %d cells\n", X_min, X_max, Y_min, Y_max, Z_min, Z_max, SC.N, geometry.N);
+    if (SC.N == 0)
+    {
+        printf("ERROR: no cells in the selected region\n");
+        exit(1);
+    }
+
+    // Frame list
+    int Nvariables = 0;
+    char variable_list[100][OC_VAR_LENGTH];
+    for (char *tok = strtok(variables, ","); tok != NULL && Nvariables < 100; tok = strtok(NULL, ","))
+        snprintf(variable_list[Nvariables++], OC_VAR_LENGTH, "%s", tok);
+
+    int Nframes_alloc = 1024, Nframes = 0;
+    Convert_frame *frames = (Convert_frame*)malloc(Nframes_alloc*sizeof(Convert_frame));
+    for (int v = 0; v < Nvariables; v++)
+    {
+        if (container_mode)
+        {
+            for (int64_t i = 0; i < geometry.Nframes; i++)
+            {
+                Output_container_entry *e = &geometry.index[i];
+                if (strcmp(e->variable, variable_list[v]) != 0) continue;
+                if (e->count < start_time || (end_time >= 0 && e->count > end_time) || (e->count - start_time) % interval != 0) continue;
+                if (Nframes == Nframes_alloc) frames = (Convert_frame*)realloc(frames, (Nframes_alloc *= 2)*sizeof(Convert_frame));
+                sprintf(frames[Nframes].variable, "%s", e->variable);
+                frames[Nframes++].count = e->count;
+            }
+        }
+        else
+        {
+            if (end_time < 0)
+            {
+                printf("ERROR: end_time must be given when converting .bin files\n");
+                exit(1);
+            }
+            for (int t = start_time; t <= end_time; t += interval)
+            {
+                sprintf(str, "%s/%s/%s_output_%04d.bin", dir, dir2, variable_list[v], t);
+                FILE *test = fopen(str, "rb");
+                if (test == NULL) continue;
+                fclose(test);
+                if (Nframes == Nframes_alloc) frames = (Convert_frame*)realloc(frames, (Nframes_alloc *= 2)*sizeof(Convert_frame));
+                sprintf(frames[Nframes].variable, "%s", variable_list[v]);
+                frames[Nframes++].count = t;
+            }
+        }
+    }
+    if (Nframes == 0)
+    {
+        printf("ERROR: no frames of %s found in %s for the selected times\n", variables, results_dir);
+        exit(1);
+    }
+
+    // Unstructured vtk: region cell coordinates and celltypes written once || lib/Outputs.cpp
+    if (strcmp(vtk_format, "vtu") == 0) vtk_xml_geometry_output(out_dir, out_dir2, SC, vtk_compression);
+
+    int Nthreads_used = omp_get_max_threads();
+    printf("Converting %d frames (%s, %s) on %d threads; frame buffers %.1f MB\n", Nframes, data_format, vtk_format, Nthreads_used,
+            Nthreads_used*(geometry.N + SC.N)*sizeof(double)/1e6);
+    double t0 = omp_get_wtime();
+    int Nerrors = 0;
+
+    #pragma omp parallel
+    {
+        // Per-thread frame buffers and (container) file handle
+        double *full    = new double [geometry.N];
+        double *region  = full_region ? full : new double [SC.N];
+        Output_container oc;
+        if (container_mode) output_container_open(&oc, dir, dir2, "Spatial_data.msc");
+
+        #pragma omp for schedule(dynamic)
+        for (int f = 0; f < Nframes; f++)
+        {
+            if (container_mode) output_container_read_frame(&oc, frames[f].variable, frames[f].count, full);
+            else
+            {
+                char filename[2000];
+                sprintf(filename, "%s/%s/%s_output_%04d.bin", dir, dir2, frames[f].variable, frames[f].count);
+                FILE *in = fopen(filename, "rb");
+                if (in == NULL || fread(full, sizeof(double), geometry.N, in) != (size_t)geometry.N)
+                {
+                    printf("WARNING: cannot read %s (incomplete?); skipped\n", filename);
+                    if (in != NULL) fclose(in);
+                    #pragma omp atomic
+                    Nerrors++;
+                    continue;
+                }
+                fclose(in);
+            }
+            if (!full_region) for (int n = 0; n < SC.N; n++) region[n] = full[cell_map[n]];
+            vtk_3D_output_format(frames[f].variable, out_dir, out_dir2, region, SC, frames[f].count, vtk_format, vtk_precision, vtk_compression);   // lib/Outputs.cpp
+        }
+
+        if (container_mode) output_container_close(&oc);
+        if (!full_region) delete [] region;
+        delete [] full;
+    }
+
+    double t1 = omp_get_wtime();
+    printf("Converted %d frames in %.2f s (%.1f frames/s)", Nframes - Nerrors, t1 - t0, (Nframes - Nerrors)/(t1 - t0));
+    if (Nerrors > 0) printf("; %d frames skipped", Nerrors);
+    printf("\n");
+
+    free(frames);
+    delete [] cell_map;
+    delete [] SC.brick;
+    free(SC.brick_geo);
+    free(SC.brick_index);
+    output_container_close(&geometry);
+} // end main
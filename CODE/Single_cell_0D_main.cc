@@ -85,6 +85,7 @@
 #include "lib/MersenneTwister.h"
 #include "lib/Spontaneous_release_functions.h"
 #include "lib/myofilament.hpp"
+#include "lib/Single_cell.h"
 
 using namespace std;
 
@@ -261,103 +262,16 @@ int main(int argc, char *argv[])
 	printf(">Variables and structs declared\n");
 	// End Initialise simulation structs and variables ==//|
 
-	// Set model condition parameters from arguments | lib/Initialisation.c
-	// Sets Params.{Model, modulation(ISO,remodelling, mutation etc), model group} to defaults
-	// then overwrites with Argin values, if arguments have been passed 
-	set_model_conditions(&Params, Argin);
-
-	// Currently only sets human atrial flag to true if a human atrial model is set 
-	set_model_group_variables(&Params, Argin); // lib/Initialisation.c
-
-	// Check Model is appropriate for this code version =\\|
-	// Add your new model clause here so it doesn't return an error
-	if		(strcmp(Params.Model, "minimal") == 0);
-	else if	(strcmp(Params.Model, "hVM_ORD_s") == 0);
-	else if	(strcmp(Params.Model, "hAM_CAZ_s") == 0);
-	else if	(strcmp(Params.Model, "dAM_VA") == 0);
-	else if	(strcmp(Params.Model, "mCRN") == 0);
-	else
-	{
-		printf("ERROR: \"%s\" is not a valid Model selection for this code version\n", Params.Model);
-		exit(1);
-	}
-	// End appropriate check ============================//|
-
-	// Set parameters (defaults and model specific) =====\\|
-	// Set cellsize and spontaneous release function defaults
-	spatial_cell_settings(&CRU, Argin);                 // lib/CRU.cpp
-	set_SRF_defaults(&SRF, Argin);						// lib/Spontaneous_release_functions.cpp
-
-	// Default modifiers || sets all scale factors to 1 and shifts to 0 so they can be multiplicatively applied by various modifications
-	set_modification_defaults_native(&Params);		// lib/Initialisation.c
-
-	// Set default parameters (constants etc); can be overwritten by model-specific later
-    set_default_parameters(&Params);                // lib/Initialisation.c
-    printf(">Default parameters set\n");
-
-	// Set model specific parameters
-	Params.dt = Sim.dt;     // Set before "set_params" called, which may explicitly set dt, for checking if dt has changed
-	set_parameters_native(&Params, Params.Model);   // lib/Model.c and dependants (may set dt for model-specific)
-
-	// Set model condition params from arguments where passed; only for those which are set in set_parameters_native() to overwrite with argument value
-	if (Argin.Celltype_arg  == true)    Params.Celltype     = Argin.Celltype;
-	if (Argin.ISO_model_arg == true)    Params.ISO_model    = Argin.ISO_model;
-	if (Argin.ACh_model_arg == true)    Params.ACh_model    = Argin.ACh_model;
-	if (Argin.Ihyp_arg      == true)    Params.AIhyp        = Argin.AIhyp;
-
-    assign_concentrations_from_arguments(&Params, Argin);
-
-	// Update Sim.dt if Params.dt has been explicitly set in "set_parameters" (thus Sim.dt != Params.dt), and dt has NOT been passed as a command-line argument.
-	if (Argin.dt_arg    	== false && Params.dt != Sim.dt) 	Sim.dt = Params.dt;
-
-	myofil.LSODA_set(); 		// lib/myofilament.cpp
-	myofil.dt_myof = Sim.dt; 	// dt for LSODA solver same as for whole model
-	printf(">Model and version specific parameters set\n");
-
-	// Now set the default and specific integrated Ca2+ handling parameters - overwrites similar parameters set in native
-    set_parameters_spatial_Ca_defaults(&Params);        // lib/Initialisation.c
-    set_parameters_spatial_Ca(&Params, Params.Model);   // lib/Model.c and dependants
-	update_parameters_spatial_Ca_0D(&Params);			// lib/Initialisation.c
-
-	// Overwrite initial conditions of Cai and CaSR if argument passed
-	if (Argin.Cai_IC_arg	== true)	Params.Cai			= Argin.Cai_IC;
-	if (Argin.CaSR_IC_arg	== true)	Params.CaSR			= Argin.CaSR_IC;
-	printf(">Default parameters set - integrated Ca2+ handling\n");
-	// End set parameters (defaults and model specific) =//|
-
-	// Set modifications ================================\\|
-	// lib/Initialisation.c || sets the mod variables (Gx, x_shift/tau_scale etc) from arguments 
-	assign_modification_from_arguments(&Params, Argin);
-
-	// lib/Model.c -> lib/Model_X.cpp; calls functions which set modification variables for het and modulation
-	// Updates the modifier variables (scales, shifts etc) using the defined settings for any/all het and modulation
-	set_heterogeneity_and_modulation_native(&Params);
-	if (strcmp(Params.Ca_cellular_het, "On") == 0) update_heterogeneity_and_modulation_integrated(&Params); // lib/Model.c 
-
-	// scale channel numbers by expression scale	
-	// (Grel and GCaL refer to expression i.e. NRyR/NLTCC)
-	Params.NRyR_mean 	*= Params.Grel;
-	Params.NLTCC_mean 	*= Params.GCaL;
-
-	printf(">Heterogeneity and modulation parameters set\n");
-	// end set current modification =====================\\|
-
-	// Membrane capacitance as a function of cell size ==\\|
-	Params.Cm           = Params.Cm_CRU * CRU.NTOT_CRUs;
+	// Set parameters, modification, stimulus and SRF ==\\|
+	// Model check, cell size, default and model specific (native and integrated Ca handling) parameters, modification 
+	// from arguments, heterogeneity and modulation, Cm, local dyad/SR/membrane scales, stimulus and SRF parameters
+	single_cell_parameters_0D(&Params, &Variables, &CRU, &Dyad, &SR, &MEM, &SRF, &myofil, &Sim, Argin); // lib/Single_cell.cpp
+	printf(">Model and version specific, integrated Ca2+ handling, heterogeneity and modulation parameters set\n");
 	printf(">Cm total for whole cell = %.2f pF\n", Params.Cm);
-	// End Membrane capacitance / cell size =============//|
-
-	// Local variables from global parameters
-	// Remnant of 3D model; here just assigns Dyad, Mem and SR variables from Params
-	set_sub_cellular_local_scale(Params, &Dyad, &MEM, &SR); // lib/CRU.cpp
-
-	// Initialise stimulus ==============================\\|
-	stimulus_setup(Params, &Variables, Sim.dt, Sim.BCL, Sim.S2_CL, Sim.Paced_time); // lib/Model.c
 	printf(">Stimulus settings set\n");
-	// End initialise stimulus ==========================//|
+	// End set parameters, modification, stimulus and SRF //|
 
 	// Spontaneous release functions ==========\\|
-	SRF_setup(&SRF, Argin); // lib/Spontaneous_release_functions.cpp -> calls appropriate set SRF parameters function 
 	
 	// Output SRF probabiliy distributions as used in code; static or vs CaSR
 	if (strcmp(SRF.Mode, "Direct_Control") == 0) 
@@ -384,28 +298,11 @@ int main(int argc, char *argv[])
 	printf("|============================================================|\n\n");
 	// End Setup complete, simulation running ==//|
 
-	// Setup dyad params to global params as just one CRU (here is where dyad het set in 3D)
-	Dyad.vol_ds		= Params.vds_CRU_mean;
-	Dyad.NRyR		= Params.NRyR_mean;
-	Dyad.NLTCC		= Params.NLTCC_mean;
-	printf("NRyR and LLTCC set\n");
-
-	// Set initial conditions of state variables
-	// Function in lib/Model.c calls specific functions in lib/Model_X.cpp
-    initial_conditions_native(&State, Params, Params.Model);                        // lib/Model.c
-
-    // Integrated calcium handling conditions (0D)
-	initial_conditions_calcium_0D(&Ca, Params);										// lib/CRU.cpp
-	initial_conditions_dyad_det(&Dyad);												// lib/CRU.cpp
- 
+	// Dyad (one CRU), initial conditions and measurement variables || lib/Single_cell.cpp
+	single_cell_initial_conditions_0D(Params, &State, &Variables, &Ca, &Dyad, &MEM);
 	Vm = State.Vm;
 	printf("Initial conditions set\n");
 
-	// Initialise measurement variables and flags
-	initialise_measurement_variables(&Variables);                                   // lib/Initialisation.c
-	MEM.NCX_SRF_mult		= 1.0;
-	Dyad.Krel_SRF_mult		= 1.0;
-
 	// Output final parameters and calculate and output 
 	// voltage-dependant functions, as used in the simulation
 	compute_and_output_current_functions(Params, &Variables, params_dir); // lib/Model.c
@@ -436,75 +333,15 @@ int main(int argc, char *argv[])
 	for (sim_time = 0.0; sim_time <= (float)Sim.Total_time; sim_time += Sim.dt)
 	{
 		// Impose CaSR at specified time if argument passed (allows precise setting of CaSR during simulation)
-		if (Sim.CaSR_set == false && strcmp(Sim.Delayed_CaSR_IC, "On") == 0 && sim_time >= Sim.CaSR_IC_delay) 
+		if (Sim.CaSR_set == false && Sim.Delayed_CaSR_IC_on == true && sim_time >= Sim.CaSR_IC_delay) 
 		{ Ca.NSR = Ca.JSR = Argin.CaSR_IC; Sim.CaSR_set = true; }
 
-		// Assign Ca state variables (seen by ionic model) from integrated whole-cell ave variables
-		State.Cai		= 1e-3*Ca.CYTO;		// Ca dependent currents, Cai (in mM not uM)
-		State.CanSR		= 1e-3*Ca.NSR;		// Ca dependent currents, Cansr (in mM not uM)
-		State.CajSR		= 1e-3*Ca.JSR;		// Ca dependent currents, Cajsr (in mM not uM)
-
-		// Excitation state (necessary for SRF) | lib/Model.c 
-		determine_excitation_state_integrated_0D(&Variables, Vm, sim_time, &Dyad.Ca_JSR_t_ex, Ca.JSR, &Dyad.SRF_prop_active,  SRF.SRF_prop_active, &SRF.waveform_init, &SRF.srf_set, SRF.Mode);
-		Dyad.ex_switch	= Variables.ex_switch;
-
-		// Spontaneous release functions || lib/Spontaneous_release_functions.cpp
-		set_and_run_SRF(&SRF, &Dyad, SRF.Mode, &Rand, Variables.ex_switch, sim_time, Ca.JSR);
-		calc_SRF_mults(&SRF, &MEM, &Dyad);
-
 		// Compute stimulus current || lib/Model.c || sets Istims to 0 or stimmag dependant on time
 		compute_Istim(Params, &Variables, Sim.Paced_time, Sim.S2_time, sim_time, iteration_counter);  	// lib/Model.c
 
-		// Zero reaction terms so they can be sequentially modified
-		Ca.SS_reac = Ca.CYTO_reac = Ca.NSR_reac = Ca.JSR_reac = 0;
-
-		// Inter-compartment transfer || lib/CRU.cpp
-		comp_J_ds_ss(Params, Ca.DS, Ca.SS, Dyad.vol_ds, &Ca.SS_reac);
-		comp_J_ss_cyto(Params, Ca.SS, Ca.CYTO, &Ca.SS_reac, &Ca.CYTO_reac);	
-		comp_J_nsr_jsr(Params, Ca.NSR, Ca.JSR, &Ca.NSR_reac, &Ca.JSR_reac);	
-
-		// Comp dyad || lib/CRU.cpp -> computes and solves JCaL, Jrel and Cads/jsr fluxes
-		comp_dyad_0D(Params, &Dyad, Ca.DS, Ca.JSR, Ca.SS /*to which ds is coupled*/, &Ca.JSR_reac, Vm, Sim.dt, Params.Model);
-
-		// Buffering || lib/CRU.cpp
-		comp_buffering(Params, &Ca.Bcyto, &Ca.Bss, &Ca.Bjsr, Ca.CYTO, Ca.SS, Ca.JSR);
-
-		// Comp SR fluxes || Jup, Jleak (SERCA) || lib/CRU.cpp
-		comp_SR_fluxes(Params, &SR, Ca.CYTO, Ca.NSR, &Ca.CYTO_reac, &Ca.NSR_reac);
-
-		// Comp Membrane fluxes || JNCX, JCaP, JCab || lib/CRU.cpp
-		comp_membrane_fluxes(Params, &MEM, State, Ca.CYTO, Ca.SS, &Ca.CYTO_reac, &Ca.SS_reac, Vm, MEM.NCX_SRF_mult);
-
-		// trpn || lib/myofilament.cpp || this is general needs to be looked at
-		myofil.run_step_myofilament(1e-3*Ca.CYTO, 8, 0.015);
-		Ca.CYTO_reac += -myofil.Jtrpn;
-
-		// Update concentrations
-		Ca.DS   	= (Ca.SS + Params.tau_ds*(Dyad.K_rel*Ca.JSR + Dyad.J_CaL))/(1 + Params.tau_ds*Dyad.K_rel); // quasi-steady-state approx
-		Ca.SS 		= Ca.SS 		+ Ca.Bss		* 	Sim.dt*(Ca.SS_reac);	
-		Ca.CYTO 	= Ca.CYTO 		+ Ca.Bcyto 		*	Sim.dt*(Ca.CYTO_reac);
-		Ca.NSR 		= Ca.NSR 		+ 					Sim.dt*(Ca.NSR_reac);	
-		Ca.JSR 		= Ca.JSR		+ Ca.Bjsr		*	Sim.dt*(Ca.JSR_reac);
-
-		// Whole-cell averages || including computing currents from Ca fluxes
-		calc_whole_cell_values_including_currents_from_flux_0D(Params, Ca, &CRU, Dyad, SR, MEM, CRU.NTOT_CRUs);	// lib/CRU.cpp
-
-		// Assign currents for use in AP model
-		Variables.ICaL 	= CRU.I_CAL;
-		Variables.INCX	= CRU.I_NCX_bulk + CRU.I_NCX_ss;
-		Variables.ICaP	= CRU.I_CaP_bulk + CRU.I_CaP_ss;
-		Variables.ICab	= CRU.I_Cab_bulk + CRU.I_Cab_ss;
-		// End Spatial Ca handling ====================================================//|
-
-		// Solve the AP model || lib/Model.c -> lib/Model_X.cpp
-		// This sets and updates all gates, and calculates Itot
-		compute_model_integrated(Params, &Variables, &State, Vm, Sim.dt);				// lib/Model.c
-
-		// Update Voltage
-		State.Vm	= State.Vm + Sim.dt*(-(Variables.Itot + Variables.Istim + Variables.Istim_S2));
-
-		// measurement properties | lib/Model.c  | "State.Vm" is voltage at t, "Vm" is voltage at t-dt
-		calculate_measurement_properties(&Variables, Vm, State.Vm, sim_time, Sim.dt, -70, State.Cai, State.CanSR);		// -70 is APD V threshold
+		// Integrated Ca handling (with SRF), AP model, voltage and measurements || lib/Single_cell.cpp
+		// "State.Vm" is voltage at t, "Vm" is voltage at t-dt
+		single_cell_step_0D(Params, &Variables, &State, &Ca, &CRU, &Dyad, &SR, &MEM, &Rand, &SRF, &myofil, Vm, sim_time, Sim.dt);
 
         // Assign global voltage to state voltage
         Vm			= State.Vm;
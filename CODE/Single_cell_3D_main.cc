@@ -79,6 +79,8 @@
 #include "lib/Model.h"
 #include "lib/Read_write_state.h"
 #include "lib/Outputs.h"
+#include "lib/Output_writer.h"
+#include "lib/Checkpoint.h"
 #include "lib/Spatial_coupling.h"
 #include "lib/CRU.h"
 #include "lib/MersenneTwister.h"
@@ -213,34 +215,37 @@ int main(int argc, char *argv[])
 	// Now create actual output files
 	printf(">Creating output files...\n");
 
+	// Restart: Results files keep their rows up to the checkpoint and are appended to || lib/Checkpoint.cpp
+	int Restart_outcount = checkpoint_restart_outcount(Sim, directory);
+
 	if (Sim.Mac == true || Sim.Linux == true)   sprintf(mkfile, "%s/%s/Currents.txt", directory, results_dir);
 	else if (Sim.Windows == true)               sprintf(mkfile, "%s\\%s\\Currents.txt", directory, results_dir);
-    ofstream out_cu(mkfile);    // Contains all current related outputs
+    ofstream out_cu(mkfile, checkpoint_resume_output(mkfile, Restart_outcount));    // Contains all current related outputs
 	printf("\t %s\n", mkfile);
 
 	if (Sim.Mac == true || Sim.Linux == true)   sprintf(mkfile, "%s/%s/Properties.txt", directory, results_dir);
     else if (Sim.Windows == true)               sprintf(mkfile, "%s\\%s\\Properties.txt", directory, results_dir);
-    ofstream out_ex(mkfile);     // Contains all AP properties related outputs
+    ofstream out_ex(mkfile, checkpoint_resume_output(mkfile, Restart_outcount));     // Contains all AP properties related outputs
 	printf("\t %s\n", mkfile);
 
 	if (Sim.Mac == true || Sim.Linux == true)   sprintf(mkfile, "%s/%s/CRU.txt", directory, results_dir);
 	else if (Sim.Windows == true)               sprintf(mkfile, "%s\\%s\\CRU.txt", directory, results_dir);
-    ofstream out_cru(mkfile);    // Contains all current related outputs
+    ofstream out_cru(mkfile, checkpoint_resume_output(mkfile, Restart_outcount));    // Contains all current related outputs
 	printf("\t %s\n", mkfile);
 
 	if (Sim.Mac == true || Sim.Linux == true)   sprintf(mkfile, "%s/%s/Ca_linescan_Z.txt", directory, results_dir);
 	else if (Sim.Windows == true)               sprintf(mkfile, "%s\\%s\\Ca_linescan_Z.txt", directory, results_dir);
-    ofstream out_lsZ(mkfile);     // Contains linescan of Ca, longitudinal
+    ofstream out_lsZ(mkfile, checkpoint_resume_output(mkfile, Restart_outcount));     // Contains linescan of Ca, longitudinal
 	printf("\t %s\n", mkfile);
 
 	if (Sim.Mac == true || Sim.Linux == true)   sprintf(mkfile, "%s/%s/Ca_linescan_Y.txt", directory, results_dir);
 	else if (Sim.Windows == true)               sprintf(mkfile, "%s\\%s\\Ca_linescan_Y.txt", directory, results_dir);
-    ofstream out_lsY(mkfile);     // Contains linescan of Ca, transverse
+    ofstream out_lsY(mkfile, checkpoint_resume_output(mkfile, Restart_outcount));     // Contains linescan of Ca, transverse
 	printf("\t %s\n", mkfile);
 
 	if (Sim.Mac == true || Sim.Linux == true)   sprintf(mkfile, "%s/%s/Ca_linescan_X.txt", directory, results_dir);
 	else if (Sim.Windows == true)               sprintf(mkfile, "%s\\%s\\Ca_linescan_X.txt", directory, results_dir);
-    ofstream out_lsX(mkfile);     // Contains linescan of Ca, transverse
+    ofstream out_lsX(mkfile, checkpoint_resume_output(mkfile, Restart_outcount));     // Contains linescan of Ca, transverse
 	printf("\t %s\n", mkfile);
 
 	printf("\n");
@@ -297,7 +302,7 @@ int main(int argc, char *argv[])
 	SC_set_array_sizes(&SC, CRU.NX, CRU.NY, CRU.NZ);	// lib/Spatial_coupling.cpp ; sets SC.N from CRU.N
 	SC_array_allocation_N3(&SC, SC.NX, SC.NY, SC.NZ);   // Allocates arrays of size NX*NY*NZ
 	SC.N	= SC.NX * SC.NY * SC.NZ;					// Idealised cell; no empty space	
-	for (int n = 0; n < SC.N; n++) SC.geo[n] = 1;		// Idealised cell; no empty space
+	for (int n = 0; n < SC.N; n++) SC_set_geo(&SC, n, 1);		// Idealised cell; no empty space
 
 	// Array allocation =============\\|
 	// Allocates arrays for local values of Ca in each compartment
@@ -510,10 +515,35 @@ int main(int argc, char *argv[])
     // End Read state =========================//|
     Vm          = State.Vm;
 
+    // Checkpoint/restart || lib/Checkpoint.cpp || full state (incl. Ca, dyads, RNG, myofilament) for bit-identical continuation
+    Checkpoint Ckpt;
+    checkpoint_init(&Ckpt, Sim, "3D_cell", Params.Model, SC.N, directory);
+    checkpoint_add(&Ckpt, "State", &State, sizeof(State_variables), 1);
+    checkpoint_add(&Ckpt, "Variables", &Variables, sizeof(Model_variables), 1);
+    checkpoint_add(&Ckpt, "Vm", &Vm, sizeof(double), 1);
+    checkpoint_add_Ca_spatial(&Ckpt, &Ca, SC.N);
+    checkpoint_add_dyads(&Ckpt, Dyad, SC.N, true);
+    checkpoint_add(&Ckpt, "SR", SR, sizeof(SR_fluxes), SC.N);
+    checkpoint_add(&Ckpt, "MEM", MEM, sizeof(Membrane_fluxes), SC.N);
+    checkpoint_add_rand(&Ckpt, Rand, SC.N);
+    checkpoint_add_myofilament(&Ckpt, myofil, SC.N);
+    if (strcmp(Sim.Read_checkpoint, "Off") != 0) checkpoint_read(&Ckpt, Sim.Read_checkpoint, &iteration_counter, &outcount, NULL, &Sim.CaSR_set);
+
+    // Spatial output writer || lib/Output_writer.cpp || snapshots copied and written in background if Spatial_output_async is On
+    Output_writer Out_writer;
+    output_writer_init(&Out_writer, SC, directory, sr_dir, Sim, Restart_outcount);
+
     // Time loop ================================================================================\\|
-    printf("Time loop started:\nTime = %.0fms\n",sim_time);
-    for (sim_time = 0.0; sim_time <= (float)Sim.Total_time; sim_time += Sim.dt)
+    printf("Time loop started:\nTime = %.0fms\n", Ckpt.start_time);
+    for (sim_time = Ckpt.start_time; sim_time <= (float)Sim.Total_time; sim_time += Sim.dt)
     {
+        // Periodic checkpoint (start of step) || lib/Checkpoint.cpp
+        if (checkpoint_due(&Ckpt, iteration_counter))
+        {
+            output_writer_flush(&Out_writer);   // queued linescans and container frames on disk before the restart point
+            checkpoint_write(&Ckpt, sim_time, iteration_counter, outcount, 0, Sim.CaSR_set);
+        }
+
         // Assign Ca state variables (seen by ionic model) from integrated whole-cell ave variables
         State.Cai		= 1e-3*Ca.CYTO;		// Ca dependent currents, Cai (in mM not uM)
         State.CanSR		= 1e-3*Ca.NSR;		// Ca dependent currents, Cansr (in mM not uM)
@@ -538,7 +568,7 @@ int main(int argc, char *argv[])
         for (int n = 0; n < SC.N; n++)
         {
             // Impose CaSR at specified time if argument passed (allows precise setting of CaSR during simulation)
-            if (Sim.CaSR_set == false && strcmp(Sim.Delayed_CaSR_IC, "On") == 0 && sim_time >= Sim.CaSR_IC_delay)
+            if (Sim.CaSR_set == false && Sim.Delayed_CaSR_IC_on == true && sim_time >= Sim.CaSR_IC_delay)
             { Ca.nsr[n] = Ca.jsr[n] = Argin.CaSR_IC; Sim.CaSR_set = true; }
 
             // Zero reaction terms so they can be sequentially modified
@@ -550,7 +580,7 @@ int main(int argc, char *argv[])
             comp_J_nsr_jsr(Params, Ca.nsr[n], Ca.jsr[n], &Ca.nsr_reac[n], &Ca.jsr_reac[n]);	
 
             // Comp dyad || lib/CRU.cpp -> computes and solves JCaL, Jrel and Cads/jsr fluxes
-            comp_dyad_3D(Params, &Dyad[n], Ca.ds[n], Ca.jsr[n], Ca.ss[n] /*to which ds is coupled*/, &Ca.jsr_reac[n], Vm, Sim.dt, Params.Model);
+            comp_dyad_3D(Params, &Dyad[n], Ca.ds[n], Ca.jsr[n], Ca.ss[n] /*to which ds is coupled*/, &Ca.jsr_reac[n], Vm, Sim.dt, Params.Model_id);
 
             // Buffering || lib/CRU.cpp
             comp_buffering(Params, &Ca.bcyto[n], &Ca.bss[n], &Ca.bjsr[n], Ca.cyto[n], Ca.ss[n], Ca.jsr[n]);
@@ -625,9 +655,9 @@ int main(int argc, char *argv[])
 
 			// Spatial data out ===============\\|
 			// Linescan || linescan through centre of cell in each direction
-			linescan_out_X(out_lsX, SC, Ca.cyto, int(float(SC.NY/2)), int(float(SC.NZ/2))); 		// lib/Outputs.cpp
-			linescan_out_Y(out_lsY, SC, Ca.cyto, int(float(SC.NX/2)), int(float(SC.NZ/2))); 		// lib/Outputs.cpp
-			linescan_out_Z(out_lsZ, SC, Ca.cyto, int(float(SC.NX/2)), int(float(SC.NY/2))); 		// lib/Outputs.cpp
+			output_writer_linescan_X(&Out_writer, out_lsX, Ca.cyto, int(float(SC.NY/2)), int(float(SC.NZ/2))); 		// lib/Output_writer.cpp
+			output_writer_linescan_Y(&Out_writer, out_lsY, Ca.cyto, int(float(SC.NX/2)), int(float(SC.NZ/2))); 		// lib/Output_writer.cpp
+			output_writer_linescan_Z(&Out_writer, out_lsZ, Ca.cyto, int(float(SC.NX/2)), int(float(SC.NY/2))); 		// lib/Output_writer.cpp
 
             // Full 3D spatial data
             if (sim_time >= Sim.Spatial_output_start_time && sim_time <= Sim.Spatial_output_end_time)
@@ -636,7 +666,7 @@ int main(int argc, char *argv[])
                 {
                     if (outcount %Sim.Spatial_output_interval_vtk == 0)
                     {
-                        vtk_3D_output("Ca", directory, sr_dir, Ca.cyto, SC, outcount);   // every x ms, output vtk file
+                        output_writer_vtk_3D(&Out_writer, "Ca", Ca.cyto, outcount);   // every x ms, output vtk file
                         // Feel free to add any new spatial variables here (J_SERCA, CaJSR etc)
                     }
                 }
@@ -644,12 +674,21 @@ int main(int argc, char *argv[])
                 {
                     if (outcount %Sim.Spatial_output_interval_data == 0)
                     {
-                        array_1D_output("Ca", directory, sr_dir, Ca.cyto, SC, outcount);   // every x ms, output binary data file
-                        array_1D_output("CaSR", directory, sr_dir, Ca.nsr, SC, outcount);  // every x ms, output binary data file
-                        array_1D_output("CaDS", directory, sr_dir, Ca.ds, SC, outcount);   // every x ms, output binary data file
+                        output_writer_array_1D(&Out_writer, "Ca", Ca.cyto, outcount);   // every x ms, output binary data file
+                        output_writer_array_1D(&Out_writer, "CaSR", Ca.nsr, outcount);  // every x ms, output binary data file
+                        output_writer_array_1D(&Out_writer, "CaDS", Ca.ds, outcount);   // every x ms, output binary data file
                         // Feel free to add any new spatial variables here (J_SERCA, CaJSR etc)
                     }
                 }
+                if (Sim.Spatial_output_interval_reduced  > 0) // such that setting to zero means no reduced outputs
+                {
+                    if (outcount %Sim.Spatial_output_interval_reduced == 0)
+                    {
+                        output_writer_reduced(&Out_writer, "Ca", Ca.cyto, outcount);   // every x ms, output quantised down-sampled vti
+                        output_writer_reduced(&Out_writer, "CaSR", Ca.nsr, outcount);  // (only variables listed in Spatial_output_reduced_variables)
+                        output_writer_reduced(&Out_writer, "CaDS", Ca.ds, outcount);
+                    }
+                }
             }
             // End Spatial data out ===========//|
             outcount++; // ms couter	
@@ -663,6 +702,10 @@ int main(int argc, char *argv[])
     // Print final time in simulation land
     printf("Final Time = %.0fms\n\n",sim_time);
 
+    // Flush any queued spatial outputs and stop writer threads || lib/Output_writer.cpp
+    output_writer_finalise(&Out_writer);
+    checkpoint_finalise(&Ckpt);     // lib/Checkpoint.cpp
+
     // Write state 
     if (strcmp(Sim.Write_state, "On") == 0)
     {
@@ -391,7 +391,7 @@ int main(int argc, char *argv[])
 		State.CajSR		= 1e-3*Ca.JSR;		// Ca dependent currents, Cajsr (in mM not uM)
 
 		// Spontaneous release functions
-		set_and_run_SRF(&SRF, &Dyad, SRF.Mode, &Rand, Variables.ex_switch, sim_time, Ca.JSR);					// lib/Spontaneous_release_functions.cpp
+		set_and_run_SRF(&SRF, &Dyad, SRF.Mode_id, &Rand, Variables.ex_switch, sim_time, Ca.JSR);					// lib/Spontaneous_release_functions.cpp
 		calc_SRF_mults(&SRF, &MEM, &Dyad);		// lib/Spontaneous_release_functions.cpp
 
 		// Zero reaction terms
@@ -416,7 +416,7 @@ int main(int argc, char *argv[])
 		comp_J_nsr_jsr(Params, Ca.NSR, Ca.JSR, &Ca.NSR_reac, &Ca.JSR_reac);	
 
 		// Comp dyad || lib/CRU.cpp
-		comp_dyad_0D(Params, &Dyad, Ca.DS, Ca.JSR, Ca.SS /*to which ds is coupled*/, &Ca.JSR_reac, Vm, Sim.dt, Params.Model);
+		comp_dyad_0D(Params, &Dyad, Ca.DS, Ca.JSR, Ca.SS /*to which ds is coupled*/, &Ca.JSR_reac, Vm, Sim.dt, Params.Model_id);
 
 		// Buffering || lib/CRU.cpp
 		comp_buffering(Params, &Ca.Bcyto, &Ca.Bss, &Ca.Bjsr, Ca.CYTO, Ca.SS, Ca.JSR);
@@ -296,7 +296,7 @@ int main(int argc, char *argv[])
     SC_set_array_sizes(&SC, CRU.NX, CRU.NY, CRU.NZ);	// lib/Spatial_coupling.cpp
     SC_array_allocation_N3(&SC, SC.NX, SC.NY, SC.NZ);   // Allocates arrays of size NX*NY*NZ
     SC.N	= SC.NX * SC.NY * SC.NZ;				
-    for (int n = 0; n < SC.N; n++) SC.geo[n] = 1;		// Idealised cell; no empty space
+    for (int n = 0; n < SC.N; n++) SC_set_geo(&SC, n, 1);		// Idealised cell; no empty space
 
     // Array allocation
     Ca_array_allocation(SC.N, &Ca);				// lib/CRU.cpp
@@ -473,7 +473,7 @@ int main(int argc, char *argv[])
             comp_J_nsr_jsr(Params, Ca.nsr[n], Ca.jsr[n], &Ca.nsr_reac[n], &Ca.jsr_reac[n]);	
 
             // Comp dyad || lib/CRU.cpp
-            comp_dyad_3D(Params, &Dyad[n], Ca.ds[n], Ca.jsr[n], Ca.ss[n] /*to which ds is coupled*/, &Ca.jsr_reac[n], Vm, Sim.dt, Params.Model);
+            comp_dyad_3D(Params, &Dyad[n], Ca.ds[n], Ca.jsr[n], Ca.ss[n] /*to which ds is coupled*/, &Ca.jsr_reac[n], Vm, Sim.dt, Params.Model_id);
 
             // Buffering || lib/CRU.cpp
             comp_buffering(Params, &Ca.bcyto[n], &Ca.bss[n], &Ca.bjsr[n], Ca.cyto[n], Ca.ss[n], Ca.jsr[n]);
@@ -0,0 +1,175 @@
+// Source code associated with  ===========================  //
+// "Multi-scale cardiac simulation framework" =============  //
+// For simulation of cardiac cellular and tissue dynamics =  //
+// from the spatial cellular to full organ scales. ========  //
+// With implementation of multiple, published cell models =  //
+// as well as novel models developed in my lab. ===========  //
+// ========================================================  //
+// This file: Main file for ensembles of single cell ====  //
+// simulations (parameter/BCL sweeps) in one process. ===  //
+// ========================================================  //
+// GNU 3 LICENSE TEXT =====================================  //
+// COPYRIGHT (C) 2016-2019 MICHAEL A. COLMAN ==============  //
+// THIS PROGRAM IS FREE SOFTWARE: YOU CAN REDISTRIBUTE IT =  //
+// AND/OR MODIFY IT UNDER THE TERMS OF THE GNU GENERAL ====  //
+// PUBLIC LICENSE AS PUBLISHED BY THE FREE SOFTWARE =======  //
+// FOUNDATION, EITHER VERSION 3 OF THE LICENSE, OR (AT YOUR  //
+// OPTION) ANY LATER VERSION. =============================  //
+// THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE=  //
+// USEFUL, BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE =====  //
+// IMPLIED WARRANTY OF MERCHANTABILITY OR FITNESS FOR A ===  //
+// PARTICULAR PURPOSE.  SEE THE GNU GENERAL PUBLIC LICENSE=  //
+// FOR MORE DETAILS. ======================================  //
+// YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL =====  //
+// PUBLIC LICENSE ALONG WITH THIS PROGRAM.  IF NOT, SEE ===  //
+// <https://www.gnu.org/licenses/>. =======================  //
+// ========================================================  //
+// ADDITIONAL LICENSE TEXT ================================  //
+// THIS SOFTWARE IS PROVIDED OPEN SOURCE AND MAY BE FREELY=  //
+// USED, DISTRIBUTED AND UPDATED, PROVIDED: ===============  //
+//  (i) THE APPROPRIATE WORK(S) IS(ARE) CITED. THIS =======  //
+//      PERTAINS TO THE CITATION OF COLMAN 2019 PLOS COMP =  //
+//      BIOL (FOR THIS IMPLEMTATION) AND ALL WORKS ========  //
+//      ASSOCIATED WITH THE SPECIFIC MODELS AND COMPONENTS=  //
+//      USED IN PARTICULAR SIMULATIONS. IT IS THE USER'S ==  //
+//      RESPONSIBILITY TO ENSURE ALL RELEVANT WORKS ARE ===  //
+//      CITED. PLEASE SEE FULL DOCUMENTATION AND ON-SCREEN=  //
+//      DISCLAIMER OUTPUTS FOR A GUIDE. ===================  //
+//  (ii) ALL OF THIS TEXT IS RETAINED WITHIN OR ASSOCIATED=  //
+//      WITH THE SOURCE CODE AND/OR BINARY FORM OF THE ====  //
+//      SOFTWARE. =========================================  //
+// ========================================================  //
+// ANY INTENDED COMMERCIAL USE OF THIS SOFTWARE MUST BE BY   //
+// EXPRESS PERMISSION OF MICHAEL A COLMAN ONLY. IN NO EVENT  //
+// ARE THE COPYRIGHT HOLDERS LIABLE FOR ANY DIRECT, =======  //
+// INDIRECT INCIDENTAL, SPECIAL, EXEMPLARY OR CONSEQUENTIAL  //
+// DAMAGES ASSOCIATED WITH USE OF THIS SOFTWARE ===========  //
+// ========================================================  //
+// THIS SOFTWARE CONTAINS IMPLEMENTATIONS OF MODELS AND ===  //
+// COMPONENTS WHICH I (MICHAEL COLMAN) DID NOT DEVELOP.====  //
+// ALL OF THESE COMPONENTS HAVE BEEN CODED FROM PROVIDED ==  //
+// SOURCE CODE OR INFORMATION IN THE PUBLICATIONS. ========  //
+// I CLAIM NO RIGHTS OR INTELLECTUAL PROPERTY OWNERSHIP ===  //
+// FOR THESE MODELS AND COMPONENTS, OTHER THAN THEIR ======  //
+// SPECIFIC IMPLEMENTATION IN THIS CODE PACKAGE. FURTHER TO  //
+// THE ABOVE STATEMENT, ANY INDTENDED COMMERCIAL USE OF ===  //
+// THOSE COMPONENTS MUST BE BY EXPRESS PERMISSION OF THE ==  //
+// ORIGINAL COPYRIGHT HOLDERS. ============================  //
+// WHERE IMPLEMENTED FROM PROVIDED CODE, ANY DISCLAIMERS ==  //
+// PRESENT IN THE ORIGINAL CODE HAVE BEEN RETAINED IN THE =  //
+// RELEVANT FILE. =========================================  //
+// ========================================================  //
+// Contact: m.a.colman@leeds.ac.uk ========================  //
+// For updates, corrections etc, please check: ============  //
+// 1. http://physicsoftheheart.com/ =======================  //
+// 2. https://github.com/michaelcolman ====================  //
+// ========================================================  //
+
+#include <fstream>
+#include <sstream>
+#include <stdlib.h>
+#include <stdio.h>
+#include <cstring>
+#include <time.h>
+
+#include "lib/Arguments.h"
+#include "lib/Initialisation.h"
+#include "lib/Structs.h"
+#include "lib/Model.h"
+#include "lib/Outputs.h"
+#include "lib/Ensemble.h"
+
+using namespace std;
+
+// Main *****************************************************************************************\\|
+int main(int argc, char *argv[])
+{
+    // Read in path for geometry and state files ========\\|
+	char PATH[1000];
+	FILE *path_in;
+	path_in = fopen("PATH.txt", "r");
+	if (path_in == NULL) // Check if file can be opened
+	{
+		printf("ERROR: Cannot open \"PATH.txt\"\n");
+		printf("Ensure it is present in the current directory\n");
+		exit(1);
+	}
+	fscanf(path_in, "%[^\n]", PATH); // read up to new line into PATH char
+	printf("\n*PATH location is %s*\n", PATH);
+	fclose(path_in);
+	// End read path ====================================//|
+
+	// Output model version to screen ===================\\|
+	printf("\n");
+	printf("|============================================================|\n");
+	printf("|Multi-scale simulation of cardiac electrophysiology ========|\n");
+	printf("|Model version: Single-cell - ensemble =====================|\n");
+	printf("|============================================================|\n");
+	printf("\n");
+	// End output to screen =============================//|
+
+	// Ensemble file and command line ===================\\|
+	// First argument pair is the ensemble specification; all further arguments apply to every member
+	if (argc < 3 || strcmp(argv[1], "Ensemble_file") != 0)
+	{
+		printf("ERROR: usage: ./model_single_ensemble Ensemble_file <file> [Arg value ...]\n");
+		printf("See Documentation/Quick_text_docs/Basic_use.txt (Single cell ensembles)\n");
+		exit(1);
+	}
+
+	FILE *out;
+	out = fopen("Log.txt", "a");
+	time_t rawtime;
+	time (&rawtime);
+	fprintf(out, "\nSim time: %sModel version ran: Single_cell_ensemble\nSettings:\t", ctime (&rawtime));
+	for (int k = 1; k < argc; k++) fprintf(out, "%s ", argv[k]);
+	fprintf(out, "\n\n");
+	fclose(out);
+
+	Ensemble En;
+	ensemble_read_spec(&En, argv[2], argc - 3, argv + 3);	// lib/Ensemble.cpp
+	// End Ensemble file and command line ===============//|
+
+    // Output directory =================================\\|
+    char * directory 	= (char*)malloc(500);
+    char * mkdirectory	= (char*)malloc(600);
+    if (En.reference[0] != '\0') sprintf(directory, "Outputs_single_ensemble_%s", En.reference);
+    else sprintf(directory, "Outputs_single_ensemble");
+
+    #ifdef _WIN32
+    sprintf(mkdirectory, "mkdir %s", directory);
+    #else
+    sprintf(mkdirectory, "mkdir -p %s", directory);
+    #endif
+    system(mkdirectory);
+    free(mkdirectory);
+    // End Output directory =============================//|
+
+	// Setup (serial) and run (parallel over members) ===\\|
+	ensemble_setup(&En, PATH, directory);		// lib/Ensemble.cpp
+
+	time (&rawtime);
+	printf("|============================================================|\n");
+	printf("|Setup complete:\n");
+	printf("|Code is now running. Started at %s", ctime (&rawtime));
+	printf("|============================================================|\n\n");
+
+	ensemble_run(&En, PATH, directory);			// lib/Ensemble.cpp
+	ensemble_write_summary(&En, directory);		// lib/Ensemble.cpp
+	// End Setup and run ================================//|
+
+	time (&rawtime);
+	printf("|============================================================|\n");
+	printf("|Code has now finished. Finished at %s", ctime (&rawtime));
+	printf("|============================================================|\n");
+
+    // Output disclaimer (models of the first member)
+    printf("/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////\n");
+    output_disclaimer_citations(En.member[0].Params, En.member[0].Sim);   // lib/Outputs.c
+    printf("--\n/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////\n\n");
+
+	// free memory
+	ensemble_free(&En);
+	free(directory);
+} 
+// End Main *************************************************************************************//|
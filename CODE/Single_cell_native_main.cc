@@ -78,6 +78,11 @@
 #include "lib/Model.h"
 #include "lib/Read_write_state.h"
 #include "lib/Outputs.h"
+#include "lib/Steady_state.h"
+#include "lib/Periodic_orbit.h"
+#include "lib/Restitution.h"
+#include "lib/Sensitivity.h"
+#include "lib/Single_cell.h"
 
 using namespace std;
 
@@ -240,82 +245,12 @@ int main(int argc, char *argv[])
     printf(">Variables and structs declared\n");
     // End Initialise simulation structs and variables ==//|
 
-    // Set model condition parameters from arguments | lib/Initialisation.c
-    // Sets Params.{Model, modulation(ISO,remodelling, mutation etc), model group} to defaults
-    // then overwrites with Argin values, if arguments have been passed 
-    set_model_conditions(&Params, Argin);
-
-    // Currently only sets human atrial flag to true if a human atrial model is set 
-    set_model_group_variables(&Params, Argin); // lib/Initialisation.c 
-
-    // Check Model is appropriate for this code version =\\|
-    // Add your new model clause here so it doesn't return an error
-    if      (strcmp(Params.Model, "minimal") == 0);			// hybrid minimal model; Colman 2019
-    else if (strcmp(Params.Model, "hAM_GB") == 0);			// human atrial cell; Grandi et al 2011 Circ Res 2011; 109(9):1055-66
-    else if (strcmp(Params.Model, "hAM_CRN") == 0);			// human atrial cell; Courtemanche et al 1998 Am J Physiol 1998; 275(1 Pt 2):H301-21.
-    else if (strcmp(Params.Model, "hAM_NG") == 0);			// human atrial cell; Nygren et al 1998 Circ Res 1998;82(1):63-81
-    else if (strcmp(Params.Model, "hAM_MT") == 0);			// human atrial cell; Maleckar et al 2009  Am. J. Physiol Heart Circ Physiol 2009;297(4):H1398-410
-    else if (strcmp(Params.Model, "hAM_WL_CRN") == 0);		// human atrial cell; Colman et al 2018 Front Physiol 9:1211; CRN Ca2+ handling
-    else if (strcmp(Params.Model, "hAM_WL_GB") == 0);		// human atrial cell; Colman et al 2018 Front Physiol 9:1211; GB Ca2+ handling
-    else if (strcmp(Params.Model, "hAM_GB_mWL") == 0);		// human atrial cell; Colman et al 2018 Front Physiol 9:1211; GB modified
-    else if (strcmp(Params.Model, "hAM_CRN_mWL") == 0);		// human atrial cell; Colman et al 2018 Front Physiol 9:1211; CRN modified
-    else if (strcmp(Params.Model, "hAM_NG_mWL") == 0);		// human atrial cell; Colman et al 2018 Front Physiol 9:1211; NG modified
-    else if (strcmp(Params.Model, "dAM_VA") == 0);			// dog atrial cell; Varela et al 2016 PLOS Computational Biology 12(12): e1005245
-    else if (strcmp(Params.Model, "hAM_GB_modded") == 0);	// human atrial cell; Grandi et al 2011 Circ Res 2011; 109(9):1055-66 MODDED
-    else if (strcmp(Params.Model, "hVM_TT") == 0);	// human ventricle, TT
-    else
-    {
-        printf("ERROR: \"%s\" is not a valid Model selection for this code version\n", Params.Model);
-        exit(1);
-    }
-    // End appropriate check ============================//|
-
-    // Set parameters (defaults and model specific) =====\\|
-    // Set default parameters (constants etc); can be overwritten by model-specific later
-    set_default_parameters(&Params);				// lib/Initialisation.c
-    printf(">Default parameters set\n");
-
-    // Set model specific full parameters
-    Params.dt = Sim.dt; 	// Set before "set_params" called, which may explicitly set dt, for checking if dt has changed
-    set_parameters_native(&Params, Params.Model);	// lib/Model.c and dependants (may set dt for model-specific)
-
-    // Set model condition params from arguments where passed; only for those which are set in set_parameters_native() to overwrite with argument value
-    if (Argin.Celltype_arg 	== true)	Params.Celltype 	= Argin.Celltype; 
-    if (Argin.ISO_model_arg == true)	Params.ISO_model 	= Argin.ISO_model; 
-    if (Argin.ACh_model_arg == true)    Params.ACh_model    = Argin.ACh_model; 
-    if (Argin.Ihyp_arg      == true)   	Params.AIhyp        = Argin.AIhyp;
-
-    // Set concentrations from arguments if specified
-    assign_concentrations_from_arguments(&Params, Argin);
-    if (Argin.Cai_IC_arg    == true)    Params.Cai          = Argin.Cai_IC;
-    if (Argin.CaSR_IC_arg   == true)    Params.CaSR         = Argin.CaSR_IC;
-
-    // Update Sim.dt if Params.dt has been explicitly set in "set_parameters" (thus Sim.dt != Params.dt), and dt has NOT been passed as a command-line argument.
-    if (Argin.dt_arg    	== false && Params.dt != Sim.dt) 	Sim.dt = Params.dt;
-    printf(">Model and version specific parameters set\n");
-    // End set parameters (defaults and model specific) =//|
-
-    // Set current modification =========================\\|
-    // Default modifiers || sets all scale factors to 1 and shifts to 0 so they can be multiplicatively applied by various modifications
-	set_modification_defaults_native(&Params);		// lib/Initialisation.c
-
-	// lib/Initialisation.c || sets the mod variables (Gx, x_shift/tau_scale etc) from arguments 
-	assign_modification_from_arguments(&Params, Argin);
-	
-	// lib/Model.c  -> lib/Model_X.cp; calls functions which set modification variables for het and modulation
-	// Updates the modifier variables (scales, shifts etc) using the defined settings for any/all het and modulation
-	set_heterogeneity_and_modulation_native(&Params);
-
-	// set expression scale by open rate scale, as both are equivilent in native models
-	Params.GCaL *= Params.GLTCC_kva1_va2;
-	Params.Grel	*= Params.GRyR_kCO;
-	printf(">Heterogeneity and modulation parameters set\n");
-	// end set current modification =====================\\| 
-
-	// Initialise stimulus ==============================\\|
-	stimulus_setup(Params, &Variables, Sim.dt, Sim.BCL, Sim.S2_CL, Sim.Paced_time); // lib/Model.c
-	printf(">Stimulus settings set\n");
-	// End initialise stimulus ==========================//|
+    // Set parameters, modification and stimulus =======\\|
+    // Model check, default and model specific parameters, modification from arguments, heterogeneity and modulation, stimulus
+    single_cell_parameters_native(&Params, &Variables, &Sim, Argin); // lib/Single_cell.cpp
+    printf(">Model and version specific, heterogeneity and modulation parameters set\n");
+    printf(">Stimulus settings set\n");
+    // End set parameters, modification and stimulus ===//|
 
 	// Output settings to screen and file || done here so can output actual settings (rather than inputs) for confidence
     output_settings(Sim, res_dir_full, Argin.DC_current_mod_arg, Params, argc, argv);  // lib/Outputs.c
@@ -360,48 +295,84 @@ int main(int argc, char *argv[])
 	}
 	// End Initial conditions and model function outs ===========================================//|
 
-	// Time loop ================================================================================\\|
-	printf("Time loop started:\nTime = %.0fms\n",sim_time);
-	for (sim_time = 0.0; sim_time <= (float)Sim.Total_time; sim_time += Sim.dt)
-	{
-		// Compute stimulus current || lib/Model.c || sets Istims to 0 or stimmag dependant on time
-		compute_Istim(Params, &Variables, Sim.Paced_time, Sim.S2_time, sim_time, iteration_counter);
+	// Restitution protocol || lib/Restitution.cpp || replaces the time loop; takes over Periodic_orbit, Steady_state and Write_state per BCL
+	Restitution Rest;
+	restitution_init(&Rest, &Sim, directory);
 
-		// Solve the model || lib/Model.c -> lib/Model_X.cpp
-		// This sets and updates all gates, and calculates Itot
-		compute_model_native(Params, &Variables, &State, Vm, Sim.dt);
+	// Periodic orbit || lib/Periodic_orbit.cpp || limit cycle at BCL by Newton-Krylov, used as initial conditions
+	Periodic_orbit Orbit;
+	periodic_orbit_init(&Orbit, Sim, sizeof(State_variables)/sizeof(double), directory);
+	if (Orbit.on == true)
+	{
+		periodic_orbit_solve_native(&Orbit, Params, &Variables, &State, Sim);
+		Vm = State.Vm;
+		if (Orbit.converged == true && strcmp(Sim.Write_state, "On") == 0)
+		{
+			Write_state_single_cell_native(State, Params, Sim.BCL, PATH, Params.Model, Sim.state_reference_write); //lib/Read_write_state.c
+			printf("Limit cycle state written to file\n");
+		}
+	}
 
-		// Update Voltage
-		State.Vm	= State.Vm + Sim.dt*(-(Variables.Itot + Variables.Istim + Variables.Istim_S2));
+	// Steady-state detection || lib/Steady_state.cpp || ends pacing once beat-to-beat changes are within tolerance
+	Steady_state Steady;
+	steady_state_init(&Steady, Sim, 1, directory);
 
-		// Excitation state and measurements | lib/Model.c  | "State.Vm" is voltage at t, "Vm" is voltage at t-dt
-		determine_excitation_state(&Variables, Vm, sim_time);							
-		calculate_measurement_properties(&Variables, Vm, State.Vm, sim_time, Sim.dt, -70, State.Cai, State.CanSR); // -70 is APD V threshold	
+	// Forward sensitivities || lib/Sensitivity.cpp || tangent of the state w.r.t. selected conductances, alongside the time loop
+	Sensitivity Sens;
+	sensitivity_init(&Sens, Sim, Params, directory);
 
-		// Assign global voltage to state voltage (now both = V at t)
+	// Time loop ================================================================================\\|
+	if (Rest.on == true)
+	{
+		sim_time	= restitution_run(&Rest, Params, &Variables, &State, Sim, PATH);
 		Vm			= State.Vm;
-
-		// Output data to files
-		if (iteration_counter % Variables.dtinv == 0) // if sim_time is an integer (i.e. per ms)
+	}
+	else
+	{
+		printf("Time loop started:\nTime = %.0fms\n",sim_time);
+		for (sim_time = 0.0; sim_time <= (float)Sim.Total_time; sim_time += Sim.dt)
 		{
-			output_currents(out_cu, sim_time, Variables, State, Vm);		// lib/Outputs.cpp || V, currents, gating variables, concs etc
-			output_excitation_properties(out_ex, sim_time, Variables, Vm);	// lib/Outputs.cpp || APD, excitation state, dv/dt etc
+			// End pacing at the start of a beat once at steady state || lib/Steady_state.cpp
+			if (steady_state_reached(&Steady, &Variables, &State, iteration_counter, sim_time)) break;
+
+			// Compute stimulus current || lib/Model.c || sets Istims to 0 or stimmag dependant on time
+			compute_Istim(Params, &Variables, Sim.Paced_time, Sim.S2_time, sim_time, iteration_counter);
+			sensitivity_pre_step(&Sens, &Variables, &State);	// lib/Sensitivity.cpp
+
+			// Solve the model, update voltage, excitation state and measurements || lib/Single_cell.cpp
+			// "State.Vm" is voltage at t, "Vm" is voltage at t-dt
+			single_cell_step_native(Params, &Variables, &State, Vm, sim_time, Sim.dt);
+			sensitivity_post_step(&Sens, &Variables, &State, Vm, sim_time);	// lib/Sensitivity.cpp
+
+			// Assign global voltage to state voltage (now both = V at t)
+			Vm			= State.Vm;
+
+			// Output data to files
+			if (iteration_counter % Variables.dtinv == 0) // if sim_time is an integer (i.e. per ms)
+			{
+				output_currents(out_cu, sim_time, Variables, State, Vm);		// lib/Outputs.cpp || V, currents, gating variables, concs etc
+				output_excitation_properties(out_ex, sim_time, Variables, Vm);	// lib/Outputs.cpp || APD, excitation state, dv/dt etc
 			
-            // For csv if wanted
-            //output_currents_csv(out_cu_csv, sim_time, Variables, State, Vm);		// lib/Outputs.cpp || V, currents, gating variables, concs etc
-			//output_excitation_properties_csv(out_ex_csv, sim_time, Variables, Vm);	// lib/Outputs.cpp || APD, excitation state, dv/dt etc
-		}
+	            // For csv if wanted
+	            //output_currents_csv(out_cu_csv, sim_time, Variables, State, Vm);		// lib/Outputs.cpp || V, currents, gating variables, concs etc
+				//output_excitation_properties_csv(out_ex_csv, sim_time, Variables, Vm);	// lib/Outputs.cpp || APD, excitation state, dv/dt etc
+			}
 
-		iteration_counter ++; // number of steps in dt
-		if (iteration_counter%(2000*Variables.dtinv) == 0) printf("Time = %.0fms\n",sim_time); // output every 2000 ms
+			iteration_counter ++; // number of steps in dt
+			if (iteration_counter%(2000*Variables.dtinv) == 0) printf("Time = %.0fms\n",sim_time); // output every 2000 ms
+		}
 	}
 	// End Time loop ============================================================================//|
 
 	// Print final time in simulation land
 	printf("Final Time = %.0fms\n\n",sim_time);
+	steady_state_finalise(&Steady);	// lib/Steady_state.cpp
+	periodic_orbit_free(&Orbit);	// lib/Periodic_orbit.cpp
+	restitution_finalise(&Rest);	// lib/Restitution.cpp
+	sensitivity_finalise(&Sens, Variables, directory);	// lib/Sensitivity.cpp
 
-	// Write state 
-	if (strcmp(Sim.Write_state, "On") == 0)
+	// Write state (already written if from the limit cycle)
+	if (strcmp(Sim.Write_state, "On") == 0 && Orbit.converged == false)
 	{
 		Write_state_single_cell_native(State, Params, Sim.BCL, PATH, Params.Model, Sim.state_reference_write); //lib/Read_write_state.c
 		printf("State written to file\n");
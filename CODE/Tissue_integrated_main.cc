@@ -81,11 +81,19 @@
 #include "lib/Model.h"
 #include "lib/Read_write_state.h"
 #include "lib/Outputs.h"
+#include "lib/Output_writer.h"
+#include "lib/Checkpoint.h"
 #include "lib/Spatial_coupling.h"
 #include "lib/CRU.h"
 #include "lib/MersenneTwister.h"
 #include "lib/Spatial_coupling.h"
 #include "lib/Tissue.h"
+#include "lib/Beat_maps.h"
+#include "lib/Pseudo_ECG.h"
+#include "lib/Phase_singularity.h"
+#include "lib/Probes.h"
+#include "lib/Regional_outputs.h"
+#include "lib/Tissue_cache.h"
 #include "lib/Spontaneous_release_functions.h"
 #include "lib/myofilament.hpp"
 
@@ -203,59 +211,57 @@ int main(int argc, char *argv[])
 	// Now create actual output files
 	printf(">Creating output files...\n");
 
+	// Restart: Results files keep their rows up to the checkpoint and are appended to || lib/Checkpoint.cpp
+	int Restart_outcount = checkpoint_restart_outcount(Sim, directory);
+
     if (Sim.Mac == true || Sim.Linux == true)   sprintf(mkfile, "%s/%s/Currents_cell1.txt", directory, results_dir);
     else if (Sim.Windows == true)               sprintf(mkfile, "%s\\%s\\Currents_cell1.dat", directory, results_dir);
-    ofstream out_cu(mkfile);    // Contains all current related outputs
+    ofstream out_cu(mkfile, checkpoint_resume_output(mkfile, Restart_outcount));    // Contains all current related outputs
     printf("\t %s\n", mkfile);
 
     if (Sim.Mac == true || Sim.Linux == true)   sprintf(mkfile, "%s/%s/Properties_cell1.txt", directory, results_dir);
     else if (Sim.Windows == true)               sprintf(mkfile, "%s\\%s\\Properties_cell1.dat", directory, results_dir);
-    ofstream out_ex(mkfile);     // Contains all AP properties related outputs
+    ofstream out_ex(mkfile, checkpoint_resume_output(mkfile, Restart_outcount));     // Contains all AP properties related outputs
     printf("\t %s\n", mkfile);
 
     if (Sim.Mac == true || Sim.Linux == true)   sprintf(mkfile, "%s/%s/CRU_cell1.txt", directory, results_dir);
     else if (Sim.Windows == true)               sprintf(mkfile, "%s\\%s\\CRU_cell1.dat", directory, results_dir);
-    ofstream out_cru1(mkfile);    // Contains all CRU related outputs
+    ofstream out_cru1(mkfile, checkpoint_resume_output(mkfile, Restart_outcount));    // Contains all CRU related outputs
     printf("\t %s\n", mkfile);
 
     if (Sim.Mac == true || Sim.Linux == true)   sprintf(mkfile, "%s/%s/Currents_cell2.txt", directory, results_dir);
     else if (Sim.Windows == true)               sprintf(mkfile, "%s\\%s\\Currents_cell2.dat", directory, results_dir);
-    ofstream out_cu2(mkfile);    // Contains all current related outputs
+    ofstream out_cu2(mkfile, checkpoint_resume_output(mkfile, Restart_outcount));    // Contains all current related outputs
     printf("\t %s\n", mkfile);
 
     if (Sim.Mac == true || Sim.Linux == true)   sprintf(mkfile, "%s/%s/Properties_cell2.txt", directory, results_dir);
     else if (Sim.Windows == true)               sprintf(mkfile, "%s\\%s\\Properties_cell2.dat", directory, results_dir);
-    ofstream out_ex2(mkfile);     // Contains all AP properties related outputs
+    ofstream out_ex2(mkfile, checkpoint_resume_output(mkfile, Restart_outcount));     // Contains all AP properties related outputs
     printf("\t %s\n", mkfile);
 
     if (Sim.Mac == true || Sim.Linux == true)   sprintf(mkfile, "%s/%s/CRU_cell2.txt", directory, results_dir);
     else if (Sim.Windows == true)               sprintf(mkfile, "%s\\%s\\CRU_cell2.dat", directory, results_dir);
-    ofstream out_cru2(mkfile);    // Contains all CRU related outputs
+    ofstream out_cru2(mkfile, checkpoint_resume_output(mkfile, Restart_outcount));    // Contains all CRU related outputs
     printf("\t %s\n", mkfile);
 
     if (Sim.Mac == true || Sim.Linux == true)   sprintf(mkfile, "%s/%s/Currents_cell3.txt", directory, results_dir);
     else if (Sim.Windows == true)               sprintf(mkfile, "%s\\%s\\Currents_cell3.dat", directory, results_dir);
-    ofstream out_cu3(mkfile);    // Contains all current related outputs
+    ofstream out_cu3(mkfile, checkpoint_resume_output(mkfile, Restart_outcount));    // Contains all current related outputs
     printf("\t %s\n", mkfile);
 
     if (Sim.Mac == true || Sim.Linux == true)   sprintf(mkfile, "%s/%s/Properties_cell3.txt", directory, results_dir);
     else if (Sim.Windows == true)               sprintf(mkfile, "%s\\%s\\Properties_cell3.dat", directory, results_dir);
-    ofstream out_ex3(mkfile);     // Contains all AP properties related outputs
+    ofstream out_ex3(mkfile, checkpoint_resume_output(mkfile, Restart_outcount));     // Contains all AP properties related outputs
     printf("\t %s\n", mkfile);
 
     if (Sim.Mac == true || Sim.Linux == true)   sprintf(mkfile, "%s/%s/CRU_cell3.txt", directory, results_dir);
     else if (Sim.Windows == true)               sprintf(mkfile, "%s\\%s\\CRU_cell3.dat", directory, results_dir);
-    ofstream out_cru3(mkfile);    // Contains all CRU related outputs
+    ofstream out_cru3(mkfile, checkpoint_resume_output(mkfile, Restart_outcount));    // Contains all CRU related outputs
     printf("\t %s\n", mkfile);
 
     if (Sim.Mac == true || Sim.Linux == true)   sprintf(mkfile, "%s/%s/Vm_linescan_x.txt", directory, results_dir);
     else if (Sim.Windows == true)               sprintf(mkfile, "%s\\%s\\Vm_linescan_x.dat", directory, results_dir);
-    ofstream out_ls(mkfile);     // Contains linescan of Vm
-    printf("\t %s\n", mkfile);
-
-    if (Sim.Mac == true || Sim.Linux == true)   sprintf(mkfile, "%s/%s/SRF_properties.txt", directory, results_dir);
-    else if (Sim.Windows == true)               sprintf(mkfile, "%s\\%s\\SRF_properties.txt", directory, results_dir);
-    ofstream out_srf_prop(mkfile);    // Contains a list of ti and NRyR of actually occuring SRF
+    ofstream out_ls(mkfile, checkpoint_resume_output(mkfile, Restart_outcount));     // Contains linescan of Vm
     printf("\t %s\n", mkfile);
 
 
@@ -353,8 +359,13 @@ int main(int argc, char *argv[])
 	SC_array_allocation_N3(&SC, SC.NX, SC.NY, SC.NZ); 			// Allocates arrays of size NX*NY*NZ || geo and 3D->1D geo index
 	printf(">Spatial coupling NX*NY*NZ arrays allocated\n");
 
+	// Tissue setup cache || lib/Tissue_cache.cpp || on a hit, Ncell and all setup arrays are read from the cache
+	Tissue_cache Cache;
+	tissue_cache_init(&Cache, Sim, Tissue, &SC, PATH);
+	bool Diagnostics = (strcmp(Sim.Setup_diagnostics, "On") == 0); // per-celltype geometry, fibre and D vtk outputs
+
 	// Read/Create geometry and calculate Ncell
-	select_tissue_geometry_function(Tissue, &SC, PATH, directory); 	// lib/Tissue.cpp
+	if (Cache.hit == false) select_tissue_geometry_function(Tissue, &SC, PATH, directory, Diagnostics); 	// lib/Tissue.cpp
 	printf("\tGeometry size (X*Y*Z, %d * %d * %d) || Ncells = %d\n\n", SC.NX, SC.NY, SC.NZ, SC.N);
 
 	// Allocate arrays size Ncell
@@ -379,17 +390,25 @@ int main(int argc, char *argv[])
 	for (int n = 0; n < SC.N; n++) myofil[n].LSODA_set(); // lib/myofilament.cpp
 	printf(">Ncell struct arrays allocated\n");
 
-	// Cell index and neighbours (geo_index[3D_ref] returns 1D ref; geo_3D_index[1D_ref] returns 3D_ref; geo_linear[1D_ref] = geo[3D_ref]
-	SC_set_index_and_geo_linear(&SC);				// lib/Spatial_coupling.cpp
-	SC_set_neighbours(&SC);							// lib/Spatial_coupling.cpp
-	printf(">Linear index and neighbours set\n");
+	if (Cache.hit == true)
+	{
+		tissue_cache_load(&Cache, &SC); // lib/Tissue_cache.cpp || index, neighbours, D, orientation and laplacian
+		tissue_geometry_vtk_output(Tissue, &SC, directory, Diagnostics); // lib/Tissue.cpp || Geometry vtk, as written by a cache miss
+	}
+	else
+	{
+		// Cell index and neighbours (SC_geo_index(3D_ref) returns 1D ref; geo_3D_index[1D_ref] returns 3D_ref; geo_linear[1D_ref] = SC_geo(3D_ref)
+		SC_set_index_and_geo_linear(&SC);				// lib/Spatial_coupling.cpp
+		SC_set_neighbours(&SC);							// lib/Spatial_coupling.cpp
+		printf(">Linear index and neighbours set\n");
 
-    // Modify neighbour map to disconnect uncoupled regions (if this is set in the Tissue model; not controllable by arguments)
-    if (Tissue.disconnect_regions_flag == true)
-    {
-        Modify_neighbours_region_disconnect(&SC, &Tissue);
-        printf(">Neighbours modified to disconnect certain regions\n");
-    }
+		// Modify neighbour map to disconnect uncoupled regions (if this is set in the Tissue model; not controllable by arguments)
+		if (Tissue.disconnect_regions_flag == true)
+		{
+			Modify_neighbours_region_disconnect(&SC, &Tissue);
+			printf(">Neighbours modified to disconnect certain regions\n");
+		}
+	}
 
 	// Create stimulus area
 	// Check for multi site/times stimulus setting; otherwise call regular function
@@ -404,24 +423,37 @@ int main(int argc, char *argv[])
 	cell2ref = int(float(SC.N/3)); // in idealised model, not likley to be x-edge (/2, 4 or 5 is)
 	cell3ref = SC.N - 5;
 
-	// setup diffusion coefficient arrays
-	set_D_dx_global(&SC, Tissue.dx, Tissue.dy, Tissue.dz, Tissue.D1, Tissue.D_AR); // sets D and dx from tissue mdoel settings || lib/Spatial_coupling.cpp
+	// setup diffusion coefficient arrays (not needed if read from the tissue cache)
+	if (Cache.hit == false)
+	{
+		set_D_dx_global(&SC, Tissue.dx, Tissue.dy, Tissue.dz, Tissue.D1, Tissue.D_AR); // sets D and dx from tissue mdoel settings || lib/Spatial_coupling.cpp
 
-	// Fibre orientation
-	set_orientation(&SC, Tissue, PATH, Tissue.Tissue_order);    // lib/Tissue.cpp || This sets orientation to 0, then sets/reads in IF set to anisotropic
-	if (strcmp(Tissue.Orientation_type, "anisotropic") == 0) output_fibre_orientation(SC, Tissue, directory); // lib/Tissue.cpp
+		// Fibre orientation
+		set_orientation(&SC, Tissue, PATH, Tissue.Tissue_order);    // lib/Tissue.cpp || This sets orientation to 0, then sets/reads in IF set to anisotropic
 
-	// Baseline, non-uniform Dscale (celltype or map; map for geo only)
-	// This is for regional or continuous/complex gradient in D1 and/or DAR (inherehent to tissue model)
-	if (strcmp(Tissue.D_uniformity, "uniform") != 0) update_D_arrays_Dscale_baseline(&SC, &Tissue,PATH, directory); // lib/Tissue.cpp
+		// Baseline, non-uniform Dscale (celltype or map; map for geo only)
+		// This is for regional or continuous/complex gradient in D1 and/or DAR (inherehent to tissue model)
+		if (strcmp(Tissue.D_uniformity, "uniform") != 0) update_D_arrays_Dscale_baseline(&SC, &Tissue,PATH, directory); // lib/Tissue.cpp
 
-	// Modification Dscale (homogeneous or map; ideal or geo)
-	// This is for scaling D1 and/or DAR locally associated with modulation (e.g. remodelling)
-	update_D_arrays_Dscale_mod(&SC, &Tissue, PATH, directory); // lib/Tissue.cpp
+		// Modification Dscale (homogeneous or map; ideal or geo)
+		// This is for scaling D1 and/or DAR locally associated with modulation (e.g. remodelling)
+		update_D_arrays_Dscale_mod(&SC, &Tissue, PATH, directory); // lib/Tissue.cpp
 
-	// now set the D components spatial array from D1 and D2 arrays and orientation
-	set_D_array_anisotropic(&SC);                       // lib/Spatial_coupling.cpp
-	output_D1_and_D2(SC, directory);                    // lib/Spatial_coupling.cpp  || Outputs vtk for inspection
+		// now set the D components spatial array from D1 and D2 arrays and orientation
+		set_D_array_anisotropic(&SC);                       // lib/Spatial_coupling.cpp
+	}
+
+	// Setup diagnostics (vtk of orientation and D as used in sim) || Setup_diagnostics On
+	if (Diagnostics == true)
+	{
+		if (strcmp(Tissue.Orientation_type, "anisotropic") == 0 || strcmp(Tissue.Orientation_type, "three_eigenvectors") == 0) output_fibre_orientation(SC, Tissue, directory); // lib/Tissue.cpp
+		if (strcmp(Tissue.Orientation_type, "three_eigenvectors") == 0)
+		{
+			output_fibre_orientation_o2(SC, Tissue, directory); // lib/Tissue.cpp
+			output_fibre_orientation_o3(SC, Tissue, directory); // lib/Tissue.cpp
+		}
+		output_D1_and_D2(SC, directory);                    // lib/Spatial_coupling.cpp
+	}
 
 	// Phase re-entry map
 	if (strcmp(Sim.Read_state, "phase") == 0) // needs to create phase map if reading phase ICs
@@ -501,37 +533,46 @@ int main(int argc, char *argv[])
 	// End Global and local settings from maps etc ======//|
 
 	// Loop of tissue for cell-by-cell setup ======================\\|
-	for (int n = 0; n < SC.N; n++)
+	// Cells with the same setup inputs (region, map-scaled ISO/remodelling/ACh/gradient, direct modulation) share one 
+	// configuration || lib/Tissue.cpp. Parameters are set once per configuration (in parallel) and then copied to all cells
+	double Setup_start 		= omp_get_wtime();
+	int *Config 			= new int [SC.N];	// configuration of cell n
+	int *Config_cell 		= new int [SC.N];	// representative cell of configuration c
+	int Nconfig 			= tissue_cell_configurations(Params, Tissue, SC, Config, Config_cell);
+	double Setup_grouped 	= omp_get_wtime();
+
+	// Cellsize and spontaneous release function settings are the same for all cells
+	CRU_variables CRU_global;
+	Spontaneous_release_functions SRF_global;
+	spatial_cell_settings(&CRU_global, Argin);                 // lib/CRU.cpp
+	set_SRF_defaults(&SRF_global, Argin);                      // lib/Spontaneous_release_functions.cpp
+
+	printf(">Setting parameters for %d unique cell configurations (%d cells)...\n", Nconfig, SC.N);
+	if (strcmp(Tissue.Multiple_models, "On") == 0 && strcmp(Tissue.Tissue_type, "homogeneous") == 0)
 	{
-		// Set parameters (defaults and model specific) =====\\|
-		// Set cellsize and spontaneous release function defaults
-		spatial_cell_settings(&CRU[n], Argin);                 // lib/CRU.cpp
-		set_SRF_defaults(&SRF[n], Argin);                      // lib/Spontaneous_release_functions.cpp
-		if (strcmp(Tissue.SRF_map_on, "On") == 0) if (Tissue.SRF_map[n] == 0.0) SRF[n].Mode = "Off"; // set non SRF regions to be Off || others will be global SRF parameters
+		printf("ERROR: Multiple Models cannot be run with homogeneous Tissue_type; heterogeneity must exist to assign regions to two Models!\n");
+		exit(1);
+	}
+	double dt_in = Sim.dt;
+#pragma omp parallel for schedule(dynamic) default(shared)
+	for (int c = 0; c < Nconfig; c++)
+	{
+		int n = Config_cell[c];
 
+		// Set parameters (defaults and model specific) =====\\|
 		// Default modifiers || sets all scale factors to 1 and shifts to 0 so they can be multiplicatively applied by various modifications
 		set_modification_defaults_native(&Params[n]);		// lib/Initialisation.c
 
 		// Set default global parameters (may want to overwrite a modifier here, hence defaulted above)
-		if (n == 0) printf(">Setting default parameters...\n");
 		set_default_parameters(&Params[n]);					// lib/Initialisation.c
-		if (n == SC.N -1) printf(">Default parameters set\n");
 
 		// Set model specific parameters
-		Params[n].dt = Sim.dt; 	// Set before "set_params" called, which may explicitly set dt, for checking if dt has changed
+		Params[n].dt = dt_in; 	// Set before "set_params" called, which may explicitly set dt, for checking if dt has changed
 
 		// Select local baseline model if multiple models is on
-		if (strcmp(Tissue.Multiple_models, "On") == 0) 
-		{
-			if (strcmp(Tissue.Tissue_type, "homogeneous") == 0)
-			{
-				printf("ERROR: Multiple Models cannot be run with homogeneous Tissue_type; heterogeneity must exist to assign regions to two Models!\n");
-				exit(1);
-			}
-			// For regions assigned "Model_2", set local Model to the entry held in "Tissue_model_2" (set in Tissue model settings or by argument)
-			// No need to do anything for regions assigned "Model_1" as this is what Params[n].Model already contains
-			if (strcmp(Tissue.Modeltype_number[SC.geo_linear[n]], "Model_2") == 0)  Params[n].Model = Tissue.Tissue_model_2; 
-		}
+		// For regions assigned "Model_2", set local Model to the entry held in "Tissue_model_2" (set in Tissue model settings or by argument)
+		// No need to do anything for regions assigned "Model_1" as this is what Params[n].Model already contains
+		if (strcmp(Tissue.Multiple_models, "On") == 0 && strcmp(Tissue.Modeltype_number[SC.geo_linear[n]], "Model_2") == 0)  Params[n].Model = Tissue.Tissue_model_2; 
 
 		set_model_group_variables(&Params[n], Argin);  // Model dependent so needs to be called here (as Params[n].Model hmay have changed
 
@@ -547,11 +588,6 @@ int main(int argc, char *argv[])
         // Set concentrations from arguments if specified
         assign_concentrations_from_arguments(&Params[n], Argin); 
 
-		// Update Sim.dt if Params.dt has been explicitly set in "set_parameters" (thus Sim.dt != Params.dt), and dt has NOT been passed as a command-line argument.
-		if (Argin.dt_arg    	== false && Params[n].dt != Sim.dt) 	Sim.dt = Params[n].dt;
-		myofil[n].dt_myof       = Sim.dt; // dt for LSODA solver same as for whole model
-		if (n == SC.N -1) printf(">Model and version specific parameters set\n");
-
 		// Now set the default and specific integrated Ca2+ handling parameters - overwrites similar parameters set in native
 		set_parameters_spatial_Ca_defaults(&Params[n]);    		// lib/Initialisation.c
 		set_parameters_spatial_Ca(&Params[n], Params[n].Model); // lib/Model.c and dependants
@@ -560,7 +596,6 @@ int main(int argc, char *argv[])
 		// Overwrite initial conditions of Cai and CaSR if argument passed
 		if (Argin.Cai_IC_arg    == true)    Params[n].Cai          = Argin.Cai_IC;
 		if (Argin.CaSR_IC_arg   == true)    Params[n].CaSR         = Argin.CaSR_IC;
-		if (n == SC.N -1) printf(">Default parameters set - integrated Ca2+ handling\n");
 		// End set parameters (defaults and model specific) =//|
 
 		// Set current modification ==========================\\|
@@ -577,7 +612,6 @@ int main(int argc, char *argv[])
 		// SC.geo_linear[n] = cellnumber at n; celltype_number[cellnumber] = string of celltype defined in Tissue model settings
 		if (strcmp(Tissue.Tissue_type, "heterogeneous") == 0) Params[n].Celltype = Tissue.celltype_number[SC.geo_linear[n]];
 
-
 		// Now call set heterogneiety and modulation (local celltype and modulation are already set by maps if relevant)
 		// lib/Model.c  -> lib/Model_X.cp; calls functions which set modification variables for het and modulation
 		// Updates the modifier variables (scales, shifts etc) using the defined settings for any/all het and modulation	
@@ -588,18 +622,36 @@ int main(int argc, char *argv[])
 		// (Grel and GCaL refer to expression i.e. NRyR/NLTCC)
 		Params[n].NRyR_mean    *= Params[n].Grel; // "Grel/CaL" refers to scaling expression and thus corresponds to Nx
 		Params[n].NLTCC_mean   *= Params[n].GCaL;
-		if (n == SC.N -1) printf(">Heterogeneity and modulation parameters set\n");
 		// end set current modification ======================//| 
 
 		// Membrane capacitance as a function of cell size ==\\|
-		Params[n].Cm           = Params[n].Cm_CRU * CRU[n].NTOT_CRUs;
-		if (n == SC.N -1) printf(">Cm total for whole cell = %.2f pF\n", Params[n].Cm);
+		Params[n].Cm           = Params[n].Cm_CRU * CRU_global.NTOT_CRUs;
 		// End Membrane capacitance / cell size =============//|
+	}
+
+	// Update Sim.dt if Params.dt has been explicitly set in "set_parameters" (thus Sim.dt != Params.dt), and dt has NOT been passed as a command-line argument.
+	for (int c = 0; c < Nconfig; c++) if (Argin.dt_arg == false && Params[Config_cell[c]].dt != Sim.dt) Sim.dt = Params[Config_cell[c]].dt;
+	printf(">Default parameters set\n>Model and version specific parameters set\n>Default parameters set - integrated Ca2+ handling\n>Heterogeneity and modulation parameters set\n");
+	printf(">Cm total for whole cell = %.2f pF\n", Params[Config_cell[Config[SC.N-1]]].Cm);
+	double Setup_configured = omp_get_wtime();
+
+	// Assign to all cells
+#pragma omp parallel for schedule(static) default(shared)
+	for (int n = 0; n < SC.N; n++)
+	{
+		if (n != Config_cell[Config[n]]) Params[n] = Params[Config_cell[Config[n]]];
+		CRU[n] = CRU_global;
+		SRF[n] = SRF_global;
+		if (strcmp(Tissue.SRF_map_on, "On") == 0) if (Tissue.SRF_map[n] == 0.0) set_SRF_mode(&SRF[n], "Off"); // set non SRF regions to be Off || others will be global SRF parameters
+		myofil[n].dt_myof       = Sim.dt; // dt for LSODA solver same as for whole model
 
 		// Local variables from global parameters
 		// Remnant of 3D model; here just assigns Dyad, Mem and SR variables from Params
 		set_sub_cellular_local_scale(Params[n], &Dyad[n], &MEM[n], &SR[n]); 
 	}
+	delete [] Config;
+	delete [] Config_cell;
+	printf(">Cell setup: grouping %.2f s || %d configurations %.2f s || assignment to %d cells %.2f s\n", Setup_grouped - Setup_start, Nconfig, Setup_configured - Setup_grouped, SC.N, omp_get_wtime() - Setup_configured);
 	// End loop of tissue for cell-by-cell setup ==================//|
 
 	// Initialise stimulus ==============================\\|
@@ -623,7 +675,7 @@ int main(int argc, char *argv[])
             cout << "ERROR!: SRF is set to read, but no filename to read from has been set" << endl;
             exit(1);
         }
-        for (int n = 0; n < SC.N; n++) SRF[n].Mode = "Off"; // default all to Off, so that if no SRF for node n in file, that node won't do anything
+        for (int n = 0; n < SC.N; n++) set_SRF_mode(&SRF[n], "Off"); // default all to Off, so that if no SRF for node n in file, that node won't do anything
         read_SRF_settings_from_file(SRF, Argin.SRF_Read_filename); // lib/Spontaneous_release_functions.cpp -> reads from file into waveform settings directly (Mode set to read in this function)
         printf("Spontaneous release function parameters read.\n");
     }
@@ -724,11 +776,15 @@ int main(int argc, char *argv[])
 	for (int n = 0; n < SC.N; n++) Vm[n] = State[n].Vm;
 
 	// Calculate diffusion tensor differentials and laplacian =====\\|
-	printf("Calculating d differential and laplacian\n");
-	for (int n = 0; n < SC.N; n++)
+	if (Cache.hit == false)
 	{
-		calc_dD_anisotropic_3D(&SC, n); // lib/Spatial_coupling.cpp
-		calc_laplacian_and_BCs(&SC, n); // lib/Spatial_coupling.cpp
+		printf("Calculating d differential and laplacian\n");
+		for (int n = 0; n < SC.N; n++)
+		{
+			calc_dD_anisotropic_3D(&SC, n); // lib/Spatial_coupling.cpp
+			calc_laplacian_and_BCs(&SC, n); // lib/Spatial_coupling.cpp
+		}
+		tissue_cache_store(&Cache, &SC);	// lib/Tissue_cache.cpp || returns if cache Off
 	}
 	// End Calculate diffusion tensor differentials and laplacian =//|
 
@@ -756,21 +812,82 @@ int main(int argc, char *argv[])
 	}
 	// End spontaneous release functions ======//|
 
+	// Checkpoint/restart || lib/Checkpoint.cpp || full state (incl. Ca, dyads, SRF, RNG, myofilament) for bit-identical continuation
+	Checkpoint Ckpt;
+	checkpoint_init(&Ckpt, Sim, "tissue_integrated", Params_global.Model, SC.N, directory);
+	checkpoint_add(&Ckpt, "State", State, sizeof(State_variables), SC.N);
+	checkpoint_add(&Ckpt, "Variables", Variables, sizeof(Model_variables), SC.N);
+	checkpoint_add(&Ckpt, "Vm", Vm, sizeof(double), SC.N);
+	checkpoint_add_Ca(&Ckpt, Ca, SC.N);
+	checkpoint_add_dyads(&Ckpt, Dyad, SC.N, false);
+	checkpoint_add(&Ckpt, "SR", SR, sizeof(SR_fluxes), SC.N);
+	checkpoint_add(&Ckpt, "MEM", MEM, sizeof(Membrane_fluxes), SC.N);
+	checkpoint_add_SRF(&Ckpt, SRF, SC.N);
+	int64_t SRF_rows = 0;   // rows of SRF_properties.txt
+	checkpoint_add(&Ckpt, "SRF_rows", &SRF_rows, sizeof(int64_t), 1);
+	if (SRF_check == true) checkpoint_add_rand(&Ckpt, Rand, SC.N);
+	checkpoint_add_myofilament(&Ckpt, myofil, SC.N);
+	if (strcmp(Sim.Read_checkpoint, "Off") != 0) checkpoint_read(&Ckpt, Sim.Read_checkpoint, &iteration_counter, &outcount, &phase_counter, &Sim.CaSR_set);
+
+	// SRF list || opened once the checkpoint is read: a restart keeps the SRF_rows rows written before it
+	char srf_file[1000];
+	if (Sim.Mac == true || Sim.Linux == true)   sprintf(srf_file, "%s/%s/SRF_properties.txt", directory, results_dir);
+	else if (Sim.Windows == true)               sprintf(srf_file, "%s\\%s\\SRF_properties.txt", directory, results_dir);
+	ofstream out_srf_prop(srf_file, checkpoint_resume_output(srf_file, Restart_outcount >= 0 ? SRF_rows : -1));    // Contains a list of ti and NRyR of actually occuring SRF
+	printf("\t %s\n", srf_file);
+
+	// Spatial output writer || lib/Output_writer.cpp || snapshots copied and written in background if Spatial_output_async is On
+	Output_writer Out_writer;
+	output_writer_init(&Out_writer, SC, directory, sr_dir, Sim, Restart_outcount);
+
+	// Per-beat activation, APD and CV maps || lib/Beat_maps.cpp || event-driven, measured inside the tissue loop
+	Beat_maps Maps;
+	beat_maps_init(&Maps, Sim, SC, directory, sr_dir);
+
+	// Pseudo-ECG and unipolar electrograms || lib/Pseudo_ECG.cpp || lead field weights precomputed here
+	Pseudo_ECG ECG;
+	pseudo_ECG_init(&ECG, Sim, SC, directory, Restart_outcount);
+
+	// Phase singularity / filament tracking || lib/Phase_singularity.cpp || analysed in a background thread
+	Phase_singularity PSG;
+	phase_singularity_init(&PSG, Sim, SC, directory);
+
+	// Configurable cell probes || lib/Probes.cpp || binary, buffered, written in bulk
+	Probes Probe;
+	probes_init(&Probe, Sim, SC, true, directory);
+
+	// Per-region aggregates || lib/Regional_outputs.cpp || reduced inside tissue loop 2
+	Regional_outputs Regions;
+	regional_outputs_init(&Regions, Sim, SC, directory, Restart_outcount >= 0 ? iteration_counter : -1);
+
+	// Release setup-only arrays || lib/Spatial_coupling.cpp, lib/Tissue.cpp || operator assembled, outputs initialised
+	double Released = SC_release_setup_arrays(&SC, "laplacian");
+	Released += tissue_release_setup_arrays(&Tissue, SC.N);
+	SC_memory_report(Released);
+
 	// Time loop ================================================================================\\|
-	printf("Time loop started:\nTime = %.0fms\n",sim_time);
-	for (sim_time = 0.0; sim_time <= (float)Sim.Total_time; sim_time += Sim.dt)
+	printf("Time loop started:\nTime = %.0fms\n", Ckpt.start_time);
+	for (sim_time = Ckpt.start_time; sim_time <= (float)Sim.Total_time; sim_time += Sim.dt)
 	{
+		// Periodic checkpoint (start of step) || lib/Checkpoint.cpp
+		if (checkpoint_due(&Ckpt, iteration_counter))
+		{
+			output_writer_flush(&Out_writer);   // queued linescans and container frames on disk before the restart point
+			fflush(NULL);                       // and the buffered rows of the pseudo-ECG and regional outputs
+			checkpoint_write(&Ckpt, sim_time, iteration_counter, outcount, phase_counter, Sim.CaSR_set);
+		}
+
 		// Compute stimulus current || lib/Model.c || sets Istims to 0 or stimmag dependant on time
 		// Note: outside of tissue loop as indexes do not correspond with cell indexes
 		compute_Istim(Params[0], &Variables[0], Sim.Paced_time, Sim.S2_time, sim_time, iteration_counter);
-		if (strcmp(Tissue.Multi_stim, "On") == 0) for (int m = 1; m < Tissue.Nstims; m++) compute_Istim(Params[m], &Variables[m], Sim.Paced_time, Sim.S2_time, sim_time, iteration_counter - Tissue.stim_delay[m]*(int)(1.0/Sim.dt));
+		if (Tissue.Multi_stim_on == true) for (int m = 1; m < Tissue.Nstims; m++) compute_Istim(Params[m], &Variables[m], Sim.Paced_time, Sim.S2_time, sim_time, iteration_counter - Tissue.stim_delay[m]*(int)(1.0/Sim.dt));
 
 		// Impose CaSR at specified time if argument passed (allows precise setting of CaSR during simulation)
-		if (Sim.CaSR_set == false && strcmp(Sim.Delayed_CaSR_IC, "On") == 0 && sim_time >= Sim.CaSR_IC_delay)
+		if (Sim.CaSR_set == false && Sim.Delayed_CaSR_IC_on == true && sim_time >= Sim.CaSR_IC_delay)
 		{ for (int n = 0; n < SC.N; n++) { Ca[n].NSR = Ca[n].JSR = Argin.CaSR_IC; Ca[n].CYTO = Ca[n].SS = Ca[n].DS = Argin.Cai_IC; } Sim.CaSR_set = true; }
 
 		// Loop over all tissue - 1 ===============================\\|
-#pragma omp parallel for default(none) shared(SC, Vm, Params, Variables, State, Sim, Tissue, sim_time, Dyad, MEM, SR, CRU, Ca, SRF, Rand, Argin, myofil)
+#pragma omp parallel for default(none) shared(SC, Vm, Params, Variables, State, Sim, Tissue, sim_time, Dyad, MEM, SR, CRU, Ca, SRF, Rand, Argin, myofil, Maps)
 		for (int n = 0; n < SC.N; n++)
 		{
 			// Compute spatial differential || lib/Spatial_coupling.cpp
@@ -783,11 +900,11 @@ int main(int argc, char *argv[])
 			State[n].CajSR     = 1e-3*Ca[n].JSR;      // Ca dependent currents, Cajsr (in mM not uM)
 
 			// Excitation state (necessary for SRF) | lib/Model.c 
-			determine_excitation_state_integrated_0D(&Variables[n], Vm[n], sim_time, &Dyad[n].Ca_JSR_t_ex, Ca[n].JSR, &Dyad[n].SRF_prop_active,  SRF[n].SRF_prop_active, &SRF[n].waveform_init, &SRF[n].srf_set, SRF[n].Mode);
+			determine_excitation_state_integrated_0D(&Variables[n], Vm[n], sim_time, &Dyad[n].Ca_JSR_t_ex, Ca[n].JSR, &Dyad[n].SRF_prop_active,  SRF[n].SRF_prop_active, &SRF[n].waveform_init, &SRF[n].srf_set, SRF[n].Mode_id);
 			Dyad[n].ex_switch  = Variables[n].ex_switch;
 
 			// Spontaneous release functions || lib/Spontaneous_release_functions.cpp
-			set_and_run_SRF(&SRF[n], &Dyad[n], SRF[n].Mode, &Rand[n], Variables[n].ex_switch, sim_time, Ca[n].JSR);
+			set_and_run_SRF(&SRF[n], &Dyad[n], SRF[n].Mode_id, &Rand[n], Variables[n].ex_switch, sim_time, Ca[n].JSR);
 			calc_SRF_mults(&SRF[n], &MEM[n], &Dyad[n]);      
 
 			// Spatial Ca handling ========================================================\\|
@@ -800,7 +917,7 @@ int main(int argc, char *argv[])
 			comp_J_nsr_jsr(Params[n], Ca[n].NSR, Ca[n].JSR, &Ca[n].NSR_reac, &Ca[n].JSR_reac);
 
 			// Comp dyad || lib/CRU.cpp -> computes and solves JCaL, Jrel and Cads/jsr fluxes
-			comp_dyad_0D(Params[n], &Dyad[n], Ca[n].DS, Ca[n].JSR, Ca[n].SS /*to which ds is coupled*/, &Ca[n].JSR_reac, Vm[n], Sim.dt, Params[n].Model);
+			comp_dyad_0D(Params[n], &Dyad[n], Ca[n].DS, Ca[n].JSR, Ca[n].SS /*to which ds is coupled*/, &Ca[n].JSR_reac, Vm[n], Sim.dt, Params[n].Model_id);
 
 			// Buffering || lib/CRU.cpp
 			comp_buffering(Params[n], &Ca[n].Bcyto, &Ca[n].Bss, &Ca[n].Bjsr, Ca[n].CYTO, Ca[n].SS, Ca[n].JSR);
@@ -842,18 +959,22 @@ int main(int argc, char *argv[])
 
 			// Add multi_stim if set
 			// If stim map is on, then now Istim[x] corresponds to stim_map = x, so region x will be stimulated when Istim[x] is non-zero
-			if (strcmp(Tissue.Multi_stim, "On") == 0) for (int m = 1; m < Tissue.Nstims; m++) State[n].Vm += -(Sim.dt * Variables[m].Istim * Tissue.multi_stim_area[m][n]); 
+			if (Tissue.Multi_stim_on == true) for (int m = 1; m < Tissue.Nstims; m++) State[n].Vm += -(Sim.dt * Variables[m].Istim * Tissue.multi_stim_area[m][n]); 
 
 			// Update local voltage due to spatial coupling
 			State[n].Vm = State[n].Vm + Sim.dt*SC.diff[n];
 
 			// Excitation state and measurements | lib/Model.c | "State.Vm" is voltage at t, "Vm" is voltage at t-dt
 			calculate_measurement_properties(&Variables[n], Vm[n], State[n].Vm, sim_time, Sim.dt, -70, State[n].Cai, State[n].CanSR);		// -70 is APD V threshold	
+			beat_maps_cell(&Maps, n, Vm[n], State[n].Vm, sim_time, Sim.dt);	// lib/Beat_maps.cpp
 		} 
 		// End tissue loop - 1 ====================================//|
 
+		// Clear regional accumulators if due || lib/Regional_outputs.cpp
+		regional_outputs_begin(&Regions, iteration_counter);
+
 		// Loop over all tissue - 2 ===============================\\|
-#pragma omp parallel for default(none) shared(SC, Vm, State, Cai, CaSR)
+#pragma omp parallel for default(none) shared(SC, Vm, State, Cai, CaSR, Regions)
 		for (int n = 0; n < SC.N; n++)
 		{
 			// Assign global voltage to state voltage
@@ -863,9 +984,21 @@ int main(int argc, char *argv[])
 			// These are for spatial outputs
 			Cai[n]			= 1e3*State[n].Cai; // uM
 			CaSR[n]			= State[n].CanSR;
+
+			// Regional aggregates || lib/Regional_outputs.cpp
+			regional_outputs_cell(&Regions, n, Vm[n], Cai[n], CaSR[n]);
 		}
 		// End tissue loop - 2 ====================================//|
 
+		// Write per-beat maps once complete || lib/Beat_maps.cpp
+		beat_maps_update(&Maps, &Out_writer);
+
+		// Cell probes due at this step || lib/Probes.cpp
+		probes_sample(&Probe, State, Variables, Vm, sim_time, iteration_counter);
+
+		// Regional aggregates row || lib/Regional_outputs.cpp
+		regional_outputs_write(&Regions, sim_time);
+
 		// Output data to files - average and linescan ============\\|
 		if (iteration_counter % Variables[0].dtinv == 0) // if sim_time is an integer (i.e. per ms)
 		{
@@ -880,9 +1013,15 @@ int main(int argc, char *argv[])
 			output_CRU(out_cru2, sim_time, Ca[cell2ref], CRU[cell2ref], Vm[cell2ref]);                  // lib/Outputs.cpp
 			output_CRU(out_cru3, sim_time, Ca[cell3ref], CRU[cell3ref], Vm[cell3ref]);                  // lib/Outputs.cpp
 
+			// Pseudo-ECG / electrograms from the current Vm || lib/Pseudo_ECG.cpp
+			pseudo_ECG_output(&ECG, Vm, sim_time);
+
+			// Phase singularities / filaments, every Phase_singularity_interval ms || lib/Phase_singularity.cpp
+			phase_singularity_step(&PSG, Vm, sim_time);
+
 			// Spatial data out ===============\\|
 			// Linescan (idealised models only)
-			if (strcmp(Tissue.Tissue_order, "geo") != 0) linescan_out_X(out_ls, SC, Vm, int(float(SC.NY/2)), int(float(SC.NZ/2)));// lib/Outputs.cpp
+			if (Tissue.Tissue_order_geo == false) output_writer_linescan_X(&Out_writer, out_ls, Vm, int(float(SC.NY/2)), int(float(SC.NZ/2)));// lib/Output_writer.cpp
 
             // Full 3D spatial data (per unit output time)
             if (sim_time >= Sim.Spatial_output_start_time && sim_time <= Sim.Spatial_output_end_time)
@@ -891,25 +1030,34 @@ int main(int argc, char *argv[])
                 {
                     if (outcount %Sim.Spatial_output_interval_vtk == 0) 
                     {
-                        vtk_3D_output("Vm", directory, sr_dir, Vm, SC, outcount); 		// every x ms, output vtk file
-                        vtk_3D_output("Ca", directory, sr_dir, Cai, SC, outcount); 		// every x ms, output vtk file
-                        vtk_3D_output("CaSR", directory, sr_dir, CaSR, SC, outcount); 	// every x ms, output vtk file
+                        output_writer_vtk_3D(&Out_writer, "Vm", Vm, outcount); 		// every x ms, output vtk file
+                        output_writer_vtk_3D(&Out_writer, "Ca", Cai, outcount); 		// every x ms, output vtk file
+                        output_writer_vtk_3D(&Out_writer, "CaSR", CaSR, outcount); 	// every x ms, output vtk file
                     }
                 }
                 if (Sim.Spatial_output_interval_data  > 0) // such that setting to zero means no spatial outputs
                 {
                     if (outcount %Sim.Spatial_output_interval_data == 0) 
                     {
-                        array_1D_output("Vm", directory, sr_dir, Vm, SC, outcount); 		// every x ms, output bin data array
-                        array_1D_output("Ca", directory, sr_dir, Cai, SC, outcount); 		// every x ms, output bin data array
-                        array_1D_output("CaSR", directory, sr_dir, CaSR, SC, outcount); 	// every x ms, output bin data array
+                        output_writer_array_1D(&Out_writer, "Vm", Vm, outcount); 		// every x ms, output bin data array
+                        output_writer_array_1D(&Out_writer, "Ca", Cai, outcount); 		// every x ms, output bin data array
+                        output_writer_array_1D(&Out_writer, "CaSR", CaSR, outcount); 	// every x ms, output bin data array
+                    }
+                }
+                if (Sim.Spatial_output_interval_reduced  > 0) // such that setting to zero means no reduced outputs
+                {
+                    if (outcount %Sim.Spatial_output_interval_reduced == 0) 
+                    {
+                        output_writer_reduced(&Out_writer, "Vm", Vm, outcount); 		// every x ms, output quantised down-sampled vti 
+                        output_writer_reduced(&Out_writer, "Ca", Cai, outcount); 		// (only variables listed in Spatial_output_reduced_variables)
+                        output_writer_reduced(&Out_writer, "CaSR", CaSR, outcount);
                     }
                 }
             }
             // End Spatial data out ===========//|
 
             // If phase output is set, and times are appropriate, output state to phase files || numbered 0-200
-            if (strcmp(Sim.Write_state, "phase") == 0)	
+            if (Sim.Write_state_phase == true)	
             {
                 if (sim_time > (Sim.NBeats-1)*Sim.BCL && sim_time < (Sim.NBeats -1)*Sim.BCL + 402)
                 {
@@ -929,7 +1077,7 @@ int main(int argc, char *argv[])
 
         // Print SRF ti and NRyRopeak to file for every actually induced SCRE
         if (iteration_counter%(50*(Variables[0].dtinv)) == 0) // as 50 is less than time between successive SRF, we only need to sample at 50 ms intervals
-            for (int n = 0; n < SC.N; n++) print_SRF_properties_to_file(&SRF[n], out_srf_prop, n);
+            for (int n = 0; n < SC.N; n++) SRF_rows += print_SRF_properties_to_file(&SRF[n], out_srf_prop, n);
 
         iteration_counter ++;	// number of steps in dt
         if (iteration_counter%(100*(Variables[0].dtinv)) == 0) printf("Time = %.0fms\n",sim_time); // output every 500 ms
@@ -939,6 +1087,25 @@ int main(int argc, char *argv[])
     // Print final time in simulation land
     printf("Final Time = %.0fms\n\n",sim_time);
 
+    // Remaining per-beat maps (before the writer stops) || lib/Beat_maps.cpp
+    beat_maps_finalise(&Maps, &Out_writer);
+
+    // Close the pseudo-ECG file || lib/Pseudo_ECG.cpp
+    pseudo_ECG_finalise(&ECG);
+
+    // Finish the last analysis and close the tracks || lib/Phase_singularity.cpp
+    phase_singularity_finalise(&PSG);
+
+    // Write the remaining probe records || lib/Probes.cpp
+    probes_finalise(&Probe);
+
+    // Close the regional outputs table || lib/Regional_outputs.cpp
+    regional_outputs_finalise(&Regions);
+
+    // Flush any queued spatial outputs and stop writer threads || lib/Output_writer.cpp
+    output_writer_finalise(&Out_writer);
+    checkpoint_finalise(&Ckpt);     // lib/Checkpoint.cpp
+
     // Write state
     if (strcmp(Sim.Write_state, "On") == 0) // whole tissue dump
     {
@@ -79,8 +79,15 @@
 #include "lib/Model.h"
 #include "lib/Read_write_state.h"
 #include "lib/Outputs.h"
+#include "lib/Output_writer.h"
+#include "lib/Checkpoint.h"
 #include "lib/Spatial_coupling.h"
 #include "lib/Tissue.h"
+#include "lib/Beat_maps.h"
+#include "lib/Pseudo_ECG.h"
+#include "lib/Phase_singularity.h"
+#include "lib/Probes.h"
+#include "lib/Regional_outputs.h"
 
 using namespace std;
 
@@ -196,39 +203,42 @@ int main(int argc, char *argv[])
     // Now create actual output files
     printf(">Creating output files...\n");
 
+    // Restart: Results files keep their rows up to the checkpoint and are appended to || lib/Checkpoint.cpp
+    int Restart_outcount = checkpoint_restart_outcount(Sim, directory);
+
     if (Sim.Mac == true || Sim.Linux == true)   sprintf(mkfile, "%s/%s/Currents_cell1.txt", directory, results_dir);
     else if (Sim.Windows == true)               sprintf(mkfile, "%s\\%s\\Currents_cell1.dat", directory, results_dir);
-    ofstream out_cu(mkfile);    // Contains all current related outputs
+    ofstream out_cu(mkfile, checkpoint_resume_output(mkfile, Restart_outcount));    // Contains all current related outputs
     printf("\t %s\n", mkfile);
 
     if (Sim.Mac == true || Sim.Linux == true)   sprintf(mkfile, "%s/%s/Properties_cell1.txt", directory, results_dir);
     else if (Sim.Windows == true)               sprintf(mkfile, "%s\\%s\\Properties_cell1.dat", directory, results_dir);
-    ofstream out_ex(mkfile);     // Contains all AP properties related outputs
+    ofstream out_ex(mkfile, checkpoint_resume_output(mkfile, Restart_outcount));     // Contains all AP properties related outputs
     printf("\t %s\n", mkfile);
 
     if (Sim.Mac == true || Sim.Linux == true)   sprintf(mkfile, "%s/%s/Currents_cell2.txt", directory, results_dir);
     else if (Sim.Windows == true)               sprintf(mkfile, "%s\\%s\\Currents_cell2.dat", directory, results_dir);
-    ofstream out_cu2(mkfile);    // Contains all current related outputs
+    ofstream out_cu2(mkfile, checkpoint_resume_output(mkfile, Restart_outcount));    // Contains all current related outputs
     printf("\t %s\n", mkfile);
 
     if (Sim.Mac == true || Sim.Linux == true)   sprintf(mkfile, "%s/%s/Properties_cell2.txt", directory, results_dir);
     else if (Sim.Windows == true)               sprintf(mkfile, "%s\\%s\\Properties_cell2.dat", directory, results_dir);
-    ofstream out_ex2(mkfile);     // Contains all AP properties related outputs
+    ofstream out_ex2(mkfile, checkpoint_resume_output(mkfile, Restart_outcount));     // Contains all AP properties related outputs
     printf("\t %s\n", mkfile);
 
     if (Sim.Mac == true || Sim.Linux == true)   sprintf(mkfile, "%s/%s/Currents_cell3.txt", directory, results_dir);
     else if (Sim.Windows == true)               sprintf(mkfile, "%s\\%s\\Currents_cell3.dat", directory, results_dir);
-    ofstream out_cu3(mkfile);    // Contains all current related outputs
+    ofstream out_cu3(mkfile, checkpoint_resume_output(mkfile, Restart_outcount));    // Contains all current related outputs
     printf("\t %s\n", mkfile);
 
     if (Sim.Mac == true || Sim.Linux == true)   sprintf(mkfile, "%s/%s/Properties_cell3.txt", directory, results_dir);
     else if (Sim.Windows == true)               sprintf(mkfile, "%s\\%s\\Properties_cell3.dat", directory, results_dir);
-    ofstream out_ex3(mkfile);     // Contains all AP properties related outputs
+    ofstream out_ex3(mkfile, checkpoint_resume_output(mkfile, Restart_outcount));     // Contains all AP properties related outputs
     printf("\t %s\n", mkfile);
 
     if (Sim.Mac == true || Sim.Linux == true)   sprintf(mkfile, "%s/%s/Vm_linescan_x.txt", directory, results_dir);
     else if (Sim.Windows == true)               sprintf(mkfile, "%s\\%s\\Vm_linescan_x.dat", directory, results_dir);
-    ofstream out_ls(mkfile);     // Contains linescan of Vm
+    ofstream out_ls(mkfile, checkpoint_resume_output(mkfile, Restart_outcount));     // Contains linescan of Vm
     printf("\t %s\n", mkfile);
 
 	printf("\n");
@@ -316,7 +326,7 @@ int main(int argc, char *argv[])
 	printf(">Spatial coupling NX*NY*NZ arrays allocated\n");
 
 	// Read/Create geometry and calculate Ncell
-	select_tissue_geometry_function(Tissue, &SC, PATH, directory); 	// lib/Tissue.cpp 
+	select_tissue_geometry_function(Tissue, &SC, PATH, directory, strcmp(Sim.Setup_diagnostics, "On") == 0); 	// lib/Tissue.cpp 
 	printf("\tGeometry size (X*Y*Z, %d * %d * %d) || Ncells = %d\n\n", SC.NX, SC.NY, SC.NZ, SC.N);
 
 	// Allocate arrays size Ncell
@@ -337,7 +347,7 @@ int main(int argc, char *argv[])
 	Vm			= new double[SC.N];
 	printf(">Ncell struct arrays allocated\n");
 
-	// Cell index and neighbours (geo_index[3D_ref] returns 1D ref; geo_3D_index[1D_ref] returns 3D_ref; geo_linear[1D_ref] = geo[3D_ref]
+	// Cell index and neighbours (SC_geo_index(3D_ref) returns 1D ref; geo_3D_index[1D_ref] returns 3D_ref; geo_linear[1D_ref] = SC_geo(3D_ref)
 	SC_set_index_and_geo_linear(&SC);				// lib/Spatial_coupling.cpp
 	SC_set_neighbours(&SC);							// lib/Spatial_coupling.cpp
 	printf(">Linear index and neighbours set\n");
@@ -363,8 +373,8 @@ int main(int argc, char *argv[])
 
 	// Fibre orientation
 	set_orientation(&SC, Tissue, PATH, Tissue.Tissue_order);    // lib/Tissue.cpp || This sets orientation to 0, then sets/reads in IF set to anisotropic
-	if (strcmp(Tissue.Orientation_type, "anisotropic") == 0) output_fibre_orientation(SC, Tissue, directory); // lib/Tissue.cpp || outputs vtk file of orientation as used in sim
-    else if (strcmp(Tissue.Orientation_type, "three_eigenvectors") == 0) 
+	if (strcmp(Sim.Setup_diagnostics, "On") == 0 && strcmp(Tissue.Orientation_type, "anisotropic") == 0) output_fibre_orientation(SC, Tissue, directory); // lib/Tissue.cpp || outputs vtk file of orientation as used in sim
+    else if (strcmp(Sim.Setup_diagnostics, "On") == 0 && strcmp(Tissue.Orientation_type, "three_eigenvectors") == 0) 
     {
         output_fibre_orientation(SC, Tissue, directory); // lib/Tissue.cpp || outputs vtk file of orientation as used in sim
         output_fibre_orientation_o2(SC, Tissue, directory); // lib/Tissue.cpp || outputs vtk file of orientation as used in sim
@@ -634,14 +644,59 @@ int main(int argc, char *argv[])
     }*/
     // End Calculate diffusion tensor differentials and laplacian =//|
 
+    // Checkpoint/restart || lib/Checkpoint.cpp || full state for bit-identical continuation
+    Checkpoint Ckpt;
+    checkpoint_init(&Ckpt, Sim, "tissue_native_network", Params_global.Model, SC.N, directory);
+    checkpoint_add(&Ckpt, "State", State, sizeof(State_variables), SC.N);
+    checkpoint_add(&Ckpt, "Variables", Variables, sizeof(Model_variables), SC.N);
+    checkpoint_add(&Ckpt, "Vm", Vm, sizeof(double), SC.N);
+    if (strcmp(Sim.Read_checkpoint, "Off") != 0) checkpoint_read(&Ckpt, Sim.Read_checkpoint, &iteration_counter, &outcount, &phase_counter, &Sim.CaSR_set);
+
+    // Spatial output writer || lib/Output_writer.cpp || snapshots copied and written in background if Spatial_output_async is On
+    Output_writer Out_writer;
+    output_writer_init(&Out_writer, SC, directory, sr_dir, Sim, Restart_outcount);
+
+    // Per-beat activation, APD and CV maps || lib/Beat_maps.cpp || event-driven, measured inside the tissue loop
+    Beat_maps Maps;
+    beat_maps_init(&Maps, Sim, SC, directory, sr_dir);
+
+    // Pseudo-ECG and unipolar electrograms || lib/Pseudo_ECG.cpp || lead field weights precomputed here
+    Pseudo_ECG ECG;
+    pseudo_ECG_init(&ECG, Sim, SC, directory, Restart_outcount);
+
+    // Phase singularity / filament tracking || lib/Phase_singularity.cpp || analysed in a background thread
+    Phase_singularity PSG;
+    phase_singularity_init(&PSG, Sim, SC, directory);
+
+    // Configurable cell probes || lib/Probes.cpp || binary, buffered, written in bulk
+    Probes Probe;
+    probes_init(&Probe, Sim, SC, false, directory);
+
+    // Per-region aggregates || lib/Regional_outputs.cpp || reduced inside tissue loop 2
+    Regional_outputs Regions;
+    regional_outputs_init(&Regions, Sim, SC, directory, Restart_outcount >= 0 ? iteration_counter : -1);
+
+    // Release setup-only arrays || lib/Spatial_coupling.cpp, lib/Tissue.cpp || operator assembled, outputs initialised
+    double Released = SC_release_setup_arrays(&SC, "network");
+    Released += tissue_release_setup_arrays(&Tissue, SC.N);
+    SC_memory_report(Released);
+
     // Time loop ================================================================================\\|
-    printf("Time loop started:\nTime = %.0fms\n",sim_time);
-    for (sim_time = 0.0; sim_time <= (float)Sim.Total_time; sim_time += Sim.dt)
+    printf("Time loop started:\nTime = %.0fms\n", Ckpt.start_time);
+    for (sim_time = Ckpt.start_time; sim_time <= (float)Sim.Total_time; sim_time += Sim.dt)
     {
+        // Periodic checkpoint (start of step) || lib/Checkpoint.cpp
+        if (checkpoint_due(&Ckpt, iteration_counter))
+        {
+            output_writer_flush(&Out_writer);   // queued linescans and container frames on disk before the restart point
+            fflush(NULL);                       // and the buffered rows of the pseudo-ECG and regional outputs
+            checkpoint_write(&Ckpt, sim_time, iteration_counter, outcount, phase_counter, Sim.CaSR_set);
+        }
+
         // Compute stimulus current || lib/Model.c || sets Istims to 0 or stimmag dependant on time
         // Note: outside of tissue loop as indexes do not correspond with cell indexes 
         compute_Istim(Params[0], &Variables[0], Sim.Paced_time, Sim.S2_time, sim_time, iteration_counter);  	// lib/Model.c
-        if (strcmp(Tissue.Multi_stim, "On") == 0) for (int m = 1; m < Tissue.Nstims; m++) compute_Istim(Params[m], &Variables[m], Sim.Paced_time, Sim.S2_time, sim_time, iteration_counter - Tissue.stim_delay[m]*(int)(1.0/Sim.dt));
+        if (Tissue.Multi_stim_on == true) for (int m = 1; m < Tissue.Nstims; m++) compute_Istim(Params[m], &Variables[m], Sim.Paced_time, Sim.S2_time, sim_time, iteration_counter - Tissue.stim_delay[m]*(int)(1.0/Sim.dt));
 
         // Loop over all tissue and set SC.diff to 0, so can be added to below (NETWORK)
         #pragma omp parallel for default(none) shared(SC, Vm, State)
@@ -658,7 +713,7 @@ int main(int argc, char *argv[])
         }
 
 		// Loop over all tissue - 1 ===============================\\|
-#pragma omp parallel for default(none) shared(SC, Vm, Params, Variables, State, Sim, Tissue, sim_time)
+#pragma omp parallel for default(none) shared(SC, Vm, Params, Variables, State, Sim, Tissue, sim_time, Maps)
 		for (int n = 0; n < SC.N; n++)
 		{
 			// Solve the model || lib/Model.c -> lib/Model_X.cpp
@@ -671,7 +726,7 @@ int main(int argc, char *argv[])
 
 			// Add multi_stim if set
 			// If stim map is on, then now Istim[x] corresponds to stim_map = x, so region x will be stimulated when Istim[x] is non-zero
-			if (strcmp(Tissue.Multi_stim, "On") == 0) for (int m = 1; m < Tissue.Nstims; m++) State[n].Vm += -(Sim.dt * Variables[m].Istim * Tissue.multi_stim_area[m][n]);
+			if (Tissue.Multi_stim_on == true) for (int m = 1; m < Tissue.Nstims; m++) State[n].Vm += -(Sim.dt * Variables[m].Istim * Tissue.multi_stim_area[m][n]);
 
 			// Update local voltage due to spatial coupling
 			State[n].Vm = State[n].Vm + Sim.dt*SC.diff[n];
@@ -679,19 +734,35 @@ int main(int argc, char *argv[])
 			// Excitation state and measurements | lib/Model.c | "State.Vm" is voltage at t, "Vm" is voltage at t-dt
 			determine_excitation_state(&Variables[n], Vm[n], sim_time);							
 			calculate_measurement_properties(&Variables[n], Vm[n], State[n].Vm, sim_time, Sim.dt, -70, State[n].Cai, State[n].CanSR);		// -70 is APD V threshold	
+			beat_maps_cell(&Maps, n, Vm[n], State[n].Vm, sim_time, Sim.dt);	// lib/Beat_maps.cpp
 		} 
 		// End tissue loop - 1 ====================================//|
 
+		// Clear regional accumulators if due || lib/Regional_outputs.cpp
+		regional_outputs_begin(&Regions, iteration_counter);
+
 		// Loop over all tissue - 2 ===============================\\|
-#pragma omp parallel for default(none) shared(SC, Vm, State)
+#pragma omp parallel for default(none) shared(SC, Vm, State, Regions)
 		for (int n = 0; n < SC.N; n++)
 		{
 			// Assign global voltage to state voltage (now both = V at t)
 			// MUST be outside above loop
 			Vm[n]			= State[n].Vm;
+
+			// Regional aggregates || lib/Regional_outputs.cpp
+			regional_outputs_cell(&Regions, n, Vm[n], 1e3*State[n].Cai, State[n].CanSR);
 		}
 		// End tissue loop - 2 ====================================//|
 
+		// Write per-beat maps once complete || lib/Beat_maps.cpp
+		beat_maps_update(&Maps, &Out_writer);
+
+		// Cell probes due at this step || lib/Probes.cpp
+		probes_sample(&Probe, State, Variables, Vm, sim_time, iteration_counter);
+
+		// Regional aggregates row || lib/Regional_outputs.cpp
+		regional_outputs_write(&Regions, sim_time);
+
 		// Output data to files - average and linescan ============\\|
 		if (iteration_counter % Variables[0].dtinv == 0) // if sim_time is an integer (i.e. per ms)
 		{
@@ -703,26 +774,36 @@ int main(int argc, char *argv[])
 			output_excitation_properties(out_ex2, sim_time, Variables[cell2ref], Vm[cell2ref]);					// lib/Outputs.cpp	
 			output_excitation_properties(out_ex3, sim_time, Variables[cell3ref], Vm[cell3ref]);					// lib/Outputs.cpp	
 
+			// Pseudo-ECG / electrograms from the current Vm || lib/Pseudo_ECG.cpp
+			pseudo_ECG_output(&ECG, Vm, sim_time);
+
+			// Phase singularities / filaments, every Phase_singularity_interval ms || lib/Phase_singularity.cpp
+			phase_singularity_step(&PSG, Vm, sim_time);
+
 			// Spatial data out ===============\\|
 			// Linescan (idealised models only)
-			if (strcmp(Tissue.Tissue_order, "geo") != 0) linescan_out_X(out_ls, SC, Vm, int(float(SC.NY/2)), int(float(SC.NZ/2)));// lib/Outputs.cpp
+			if (Tissue.Tissue_order_geo == false) output_writer_linescan_X(&Out_writer, out_ls, Vm, int(float(SC.NY/2)), int(float(SC.NZ/2)));// lib/Output_writer.cpp
 
             // Full 3D spatial data (per unit output time)
             if (sim_time >= Sim.Spatial_output_start_time && sim_time <= Sim.Spatial_output_end_time)
             {
                 if (Sim.Spatial_output_interval_vtk  > 0) // such that setting to zero means no spatial outputs
                 {
-                    if (outcount %Sim.Spatial_output_interval_vtk == 0) vtk_3D_output("Vm", directory, sr_dir, Vm, SC, outcount); // every x ms, output vtk file
+                    if (outcount %Sim.Spatial_output_interval_vtk == 0) output_writer_vtk_3D(&Out_writer, "Vm", Vm, outcount); // every x ms, output vtk file
                 }
                 if (Sim.Spatial_output_interval_data  > 0) // such that setting to zero means no spatial outputs
                 {
-                    if (outcount %Sim.Spatial_output_interval_data == 0) array_1D_output("Vm", directory, sr_dir, Vm, SC, outcount); // every x ms, output bin data array
+                    if (outcount %Sim.Spatial_output_interval_data == 0) output_writer_array_1D(&Out_writer, "Vm", Vm, outcount); // every x ms, output bin data array
+                }
+                if (Sim.Spatial_output_interval_reduced  > 0) // such that setting to zero means no reduced outputs
+                {
+                    if (outcount %Sim.Spatial_output_interval_reduced == 0) output_writer_reduced(&Out_writer, "Vm", Vm, outcount); // every x ms, output quantised down-sampled vti
                 }
             }
             // End Spatial data out ===========//|
 
             // If phase output is set, and times are appropriate, output state to phase files || numbered 0-200
-            if (strcmp(Sim.Write_state, "phase") == 0)	
+            if (Sim.Write_state_phase == true)	
             {
                 if (sim_time > (Sim.NBeats-1)*Sim.BCL && sim_time < (Sim.NBeats -1)*Sim.BCL + 402)
                 {
@@ -744,6 +825,25 @@ int main(int argc, char *argv[])
     // Print final time in simulation land
     printf("Final Time = %.0fms\n\n",sim_time);
 
+    // Remaining per-beat maps (before the writer stops) || lib/Beat_maps.cpp
+    beat_maps_finalise(&Maps, &Out_writer);
+
+    // Close the pseudo-ECG file || lib/Pseudo_ECG.cpp
+    pseudo_ECG_finalise(&ECG);
+
+    // Finish the last analysis and close the tracks || lib/Phase_singularity.cpp
+    phase_singularity_finalise(&PSG);
+
+    // Write the remaining probe records || lib/Probes.cpp
+    probes_finalise(&Probe);
+
+    // Close the regional outputs table || lib/Regional_outputs.cpp
+    regional_outputs_finalise(&Regions);
+
+    // Flush any queued spatial outputs and stop writer threads || lib/Output_writer.cpp
+    output_writer_finalise(&Out_writer);
+    checkpoint_finalise(&Ckpt);     // lib/Checkpoint.cpp
+
     // Write state 
     if (strcmp(Sim.Write_state, "On") == 0) // whole tissue dump
     {
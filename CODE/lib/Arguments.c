@@ -98,6 +98,69 @@ void set_argument_defaults(Argument_parameters *A)
 	A->SOId_arg			        	= false;
     A->SORs_arg                     = false;
     A->SORe_arg                     = false;
+    A->SOA_arg                      = false;
+    A->SOW_arg                      = false;
+    A->SOB_arg                      = false;
+    A->SOVF_arg                     = false;
+    A->SOP_arg                      = false;
+    A->SOC_arg                      = false;
+    A->SODF_arg                     = false;
+    A->SOIr_arg                     = false;
+    A->SORv_arg                     = false;
+    A->SORst_arg                    = false;
+    A->SORm_arg                     = false;
+    A->SORb_arg                     = false;
+    A->SORR_arg                     = false;
+    A->SORbox_arg                   = false;
+    A->SORmap_arg                   = false;
+    A->CKI_arg                      = false;
+    A->CKK_arg                      = false;
+    A->CKD_arg                      = false;
+    A->CKC_arg                      = false;
+    A->RCK_arg                      = false;
+    A->S2SW_arg                     = false;
+    A->S2SWL_arg                    = false;
+    A->S2SWC_arg                    = false;
+    A->S2SWR_arg                    = false;
+    A->S2SWW_arg                    = false;
+    A->S2SWB_arg                    = false;
+    A->BM_arg                       = false;
+    A->BMA_arg                      = false;
+    A->PECG_arg                     = false;
+    A->PECGE_arg                    = false;
+    A->PECGL_arg                    = false;
+    A->PSG_arg                      = false;
+    A->PSGI_arg                     = false;
+    A->PSGD_arg                     = false;
+    A->PSGR_arg                     = false;
+    A->PRF_arg                      = false;
+    A->RGO_arg                      = false;
+    A->RGOS_arg                     = false;
+    A->RGOI_arg                     = false;
+    A->TCH_arg                      = false;
+    A->SUD_arg                      = false;
+    A->SS_arg                       = false;
+    A->SSB_arg                      = false;
+    A->SSTA_arg                     = false;
+    A->SSTC_arg                     = false;
+    A->SSTN_arg                     = false;
+    A->SSTS_arg                     = false;
+    A->PO_arg                       = false;
+    A->POT_arg                      = false;
+    A->POI_arg                      = false;
+    A->POK_arg                      = false;
+    A->POP_arg                      = false;
+    A->POA_arg                      = false;
+    A->RP_arg                       = false;
+    A->RPB_arg                      = false;
+    A->RPN_arg                      = false;
+    A->RPS_arg                      = false;
+    A->RPW_arg                      = false;
+    A->RPT_arg                      = false;
+    A->RPR_arg                      = false;
+    A->SEN_arg                      = false;
+    A->SENP_arg                     = false;
+    A->SENH_arg                     = false;
 	A->Multi_stim_arg	        	= false;
 	A->settings_file            	= false;
 	// End sim settings =============//|
@@ -552,6 +615,686 @@ void set_arguments(int Narg, char *argin[], Argument_parameters *A, char const *
             A->SORe_arg        = true;
             fprintf(out, "Spatial_output_range_end   %s ", argin[counter+1]);
             counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Spatial_output_async") == 0)
+        {
+            A->SOA             = argin[counter+1];
+            A->SOA_arg         = true;
+            fprintf(out, "Spatial_output_async   %s ", argin[counter+1]);
+            if (strcmp(A->SOA, "On") != 0 && strcmp(A->SOA, "Off") != 0)
+            {
+                printf("ERROR: \"%s\" is not a valid Spatial_output_async argument. Please pass only \"On\" or \"Off\"\n\n", A->SOA);
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Spatial_output_writers") == 0)
+        {
+            A->SOW             = atoi(argin[counter+1]);
+            A->SOW_arg         = true;
+            fprintf(out, "Spatial_output_writers   %s ", argin[counter+1]);
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Spatial_output_buffers") == 0)
+        {
+            A->SOB             = atoi(argin[counter+1]);
+            A->SOB_arg         = true;
+            fprintf(out, "Spatial_output_buffers   %s ", argin[counter+1]);
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Spatial_output_vtk_format") == 0)
+        {
+            A->SOVF            = argin[counter+1];
+            A->SOVF_arg        = true;
+            fprintf(out, "Spatial_output_vtk_format   %s ", argin[counter+1]);
+            if (strcmp(A->SOVF, "legacy") != 0 && strcmp(A->SOVF, "vti") != 0 && strcmp(A->SOVF, "vtu") != 0)
+            {
+                printf("ERROR: \"%s\" is not a valid Spatial_output_vtk_format argument. Please pass only \"legacy\", \"vti\" or \"vtu\"\n\n", A->SOVF);
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Spatial_output_precision") == 0)
+        {
+            A->SOP             = argin[counter+1];
+            A->SOP_arg         = true;
+            fprintf(out, "Spatial_output_precision   %s ", argin[counter+1]);
+            if (strcmp(A->SOP, "float") != 0 && strcmp(A->SOP, "double") != 0)
+            {
+                printf("ERROR: \"%s\" is not a valid Spatial_output_precision argument. Please pass only \"float\" or \"double\"\n\n", A->SOP);
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Spatial_output_compression") == 0)
+        {
+            A->SOC             = argin[counter+1];
+            A->SOC_arg         = true;
+            fprintf(out, "Spatial_output_compression   %s ", argin[counter+1]);
+            if (strcmp(A->SOC, "Off") != 0 && strcmp(A->SOC, "zlib") != 0)
+            {
+                printf("ERROR: \"%s\" is not a valid Spatial_output_compression argument. Please pass only \"Off\" or \"zlib\"\n\n", A->SOC);
+                exit(1);
+            }
+#ifndef MSCSF_ZLIB
+            if (strcmp(A->SOC, "zlib") == 0)
+            {
+                printf("ERROR: Spatial_output_compression zlib requires the code to be compiled with zlib (add -DMSCSF_ZLIB -lz; see Makefile)\n\n");
+                exit(1);
+            }
+#endif
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Spatial_output_data_format") == 0)
+        {
+            A->SODF            = argin[counter+1];
+            A->SODF_arg        = true;
+            fprintf(out, "Spatial_output_data_format   %s ", argin[counter+1]);
+            if (strcmp(A->SODF, "bin") != 0 && strcmp(A->SODF, "container") != 0)
+            {
+                printf("ERROR: \"%s\" is not a valid Spatial_output_data_format argument. Please pass only \"bin\" or \"container\"\n\n", A->SODF);
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Spatial_output_interval_reduced") == 0)
+        {
+            A->SOIr            = atoi(argin[counter+1]);
+            A->SOIr_arg        = true;
+            fprintf(out, "Spatial_output_interval_reduced   %s ", argin[counter+1]);
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Spatial_output_reduced_variables") == 0)
+        {
+            A->SORv            = argin[counter+1];
+            A->SORv_arg        = true;
+            fprintf(out, "Spatial_output_reduced_variables   %s ", argin[counter+1]);
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Spatial_output_reduced_stride") == 0)
+        {
+            A->SORst           = atoi(argin[counter+1]);
+            A->SORst_arg       = true;
+            fprintf(out, "Spatial_output_reduced_stride   %s ", argin[counter+1]);
+            if (A->SORst < 1)
+            {
+                printf("ERROR: Spatial_output_reduced_stride must be at least 1\n\n");
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Spatial_output_reduced_mode") == 0)
+        {
+            A->SORm            = argin[counter+1];
+            A->SORm_arg        = true;
+            fprintf(out, "Spatial_output_reduced_mode   %s ", argin[counter+1]);
+            if (strcmp(A->SORm, "average") != 0 && strcmp(A->SORm, "stride") != 0)
+            {
+                printf("ERROR: \"%s\" is not a valid Spatial_output_reduced_mode argument. Please pass only \"average\" or \"stride\"\n\n", A->SORm);
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Spatial_output_reduced_bits") == 0)
+        {
+            A->SORb            = atoi(argin[counter+1]);
+            A->SORb_arg        = true;
+            fprintf(out, "Spatial_output_reduced_bits   %s ", argin[counter+1]);
+            if (A->SORb != 8 && A->SORb != 16)
+            {
+                printf("ERROR: \"%s\" is not a valid Spatial_output_reduced_bits argument. Please pass only 8 or 16\n\n", argin[counter+1]);
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Spatial_output_reduced_ROI") == 0)
+        {
+            A->SORR            = argin[counter+1];
+            A->SORR_arg        = true;
+            fprintf(out, "Spatial_output_reduced_ROI   %s ", argin[counter+1]);
+            if (strcmp(A->SORR, "full") != 0 && strcmp(A->SORR, "box") != 0 && strcmp(A->SORR, "map") != 0)
+            {
+                printf("ERROR: \"%s\" is not a valid Spatial_output_reduced_ROI argument. Please pass only \"full\", \"box\" or \"map\"\n\n", A->SORR);
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Spatial_output_reduced_box") == 0)
+        {
+            A->SORbox          = argin[counter+1];
+            A->SORbox_arg      = true;
+            fprintf(out, "Spatial_output_reduced_box   %s ", argin[counter+1]);
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Spatial_output_reduced_map_file") == 0)
+        {
+            A->SORmap          = argin[counter+1];
+            A->SORmap_arg      = true;
+            fprintf(out, "Spatial_output_reduced_map_file   %s ", argin[counter+1]);
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Checkpoint_interval") == 0)
+        {
+            A->CKI             = atof(argin[counter+1]);
+            A->CKI_arg         = true;
+            fprintf(out, "Checkpoint_interval   %s ", argin[counter+1]);
+            if (A->CKI < 0)
+            {
+                printf("ERROR: Checkpoint_interval must be positive (or 0 for off)\n\n");
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Checkpoint_keep") == 0)
+        {
+            A->CKK             = atoi(argin[counter+1]);
+            A->CKK_arg         = true;
+            fprintf(out, "Checkpoint_keep   %s ", argin[counter+1]);
+            if (A->CKK < 1)
+            {
+                printf("ERROR: Checkpoint_keep must be at least 1\n\n");
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Checkpoint_deltas") == 0)
+        {
+            A->CKD             = atoi(argin[counter+1]);
+            A->CKD_arg         = true;
+            fprintf(out, "Checkpoint_deltas   %s ", argin[counter+1]);
+            if (A->CKD < 0)
+            {
+                printf("ERROR: Checkpoint_deltas must be positive (or 0 for all checkpoints full)\n\n");
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Checkpoint_compression") == 0)
+        {
+            A->CKC             = argin[counter+1];
+            A->CKC_arg         = true;
+            fprintf(out, "Checkpoint_compression   %s ", argin[counter+1]);
+            if (strcmp(A->CKC, "Off") != 0 && strcmp(A->CKC, "rle") != 0 && strcmp(A->CKC, "zlib") != 0)
+            {
+                printf("ERROR: \"%s\" is not a valid Checkpoint_compression argument. Please pass only \"Off\", \"rle\" or \"zlib\"\n\n", A->CKC);
+                exit(1);
+            }
+#ifndef MSCSF_ZLIB
+            if (strcmp(A->CKC, "zlib") == 0)
+            {
+                printf("ERROR: Checkpoint_compression zlib requires the code to be compiled with zlib (add -DMSCSF_ZLIB -lz; see Makefile)\n\n");
+                exit(1);
+            }
+#endif
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Read_checkpoint") == 0)
+        {
+            A->RCK             = argin[counter+1];
+            A->RCK_arg         = true;
+            fprintf(out, "Read_checkpoint   %s ", argin[counter+1]);
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "S2_sweep") == 0)
+        {
+            A->S2SW            = argin[counter+1];
+            A->S2SW_arg        = true;
+            fprintf(out, "S2_sweep   %s ", argin[counter+1]);
+            if (strcmp(A->S2SW, "Off") != 0 && strcmp(A->S2SW, "scan") != 0 && strcmp(A->S2SW, "bisect") != 0)
+            {
+                printf("ERROR: \"%s\" is not a valid S2_sweep argument. Please pass only \"Off\", \"scan\" or \"bisect\"\n\n", A->S2SW);
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "S2_sweep_locations") == 0)
+        {
+            A->S2SWL           = argin[counter+1];
+            A->S2SWL_arg       = true;
+            fprintf(out, "S2_sweep_locations   %s ", argin[counter+1]);
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "S2_sweep_CL") == 0)
+        {
+            A->S2SWC           = argin[counter+1];
+            A->S2SWC_arg       = true;
+            fprintf(out, "S2_sweep_CL   %s ", argin[counter+1]);
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "S2_sweep_resolution") == 0)
+        {
+            A->S2SWR           = atoi(argin[counter+1]);
+            A->S2SWR_arg       = true;
+            fprintf(out, "S2_sweep_resolution   %s ", argin[counter+1]);
+            if (A->S2SWR < 1)
+            {
+                printf("ERROR: S2_sweep_resolution must be at least 1 ms\n\n");
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "S2_sweep_window") == 0)
+        {
+            A->S2SWW           = atoi(argin[counter+1]);
+            A->S2SWW_arg       = true;
+            fprintf(out, "S2_sweep_window   %s ", argin[counter+1]);
+            if (A->S2SWW < 1)
+            {
+                printf("ERROR: S2_sweep_window must be at least 1 ms\n\n");
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "S2_sweep_branches") == 0)
+        {
+            A->S2SWB           = atoi(argin[counter+1]);
+            A->S2SWB_arg       = true;
+            fprintf(out, "S2_sweep_branches   %s ", argin[counter+1]);
+            if (A->S2SWB < 0)
+            {
+                printf("ERROR: S2_sweep_branches must be positive (or 0 for one per thread)\n\n");
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Beat_maps") == 0)
+        {
+            A->BM              = argin[counter+1];
+            A->BM_arg          = true;
+            fprintf(out, "Beat_maps   %s ", argin[counter+1]);
+            if (strcmp(A->BM, "On") != 0 && strcmp(A->BM, "Off") != 0)
+            {
+                printf("ERROR: \"%s\" is not a valid Beat_maps argument. Please pass only \"On\" or \"Off\"\n\n", A->BM);
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Beat_maps_APD") == 0)
+        {
+            A->BMA             = argin[counter+1];
+            A->BMA_arg         = true;
+            fprintf(out, "Beat_maps_APD   %s ", argin[counter+1]);
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Pseudo_ECG") == 0)
+        {
+            A->PECG            = argin[counter+1];
+            A->PECG_arg        = true;
+            fprintf(out, "Pseudo_ECG   %s ", argin[counter+1]);
+            if (strcmp(A->PECG, "On") != 0 && strcmp(A->PECG, "Off") != 0)
+            {
+                printf("ERROR: \"%s\" is not a valid Pseudo_ECG argument. Please pass only \"On\" or \"Off\"\n\n", A->PECG);
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Pseudo_ECG_electrodes") == 0)
+        {
+            A->PECGE           = argin[counter+1];
+            A->PECGE_arg       = true;
+            fprintf(out, "Pseudo_ECG_electrodes   %s ", argin[counter+1]);
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Pseudo_ECG_leads") == 0)
+        {
+            A->PECGL           = argin[counter+1];
+            A->PECGL_arg       = true;
+            fprintf(out, "Pseudo_ECG_leads   %s ", argin[counter+1]);
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Phase_singularity") == 0)
+        {
+            A->PSG             = argin[counter+1];
+            A->PSG_arg         = true;
+            fprintf(out, "Phase_singularity   %s ", argin[counter+1]);
+            if (strcmp(A->PSG, "On") != 0 && strcmp(A->PSG, "Off") != 0)
+            {
+                printf("ERROR: \"%s\" is not a valid Phase_singularity argument. Please pass only \"On\" or \"Off\"\n\n", A->PSG);
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Phase_singularity_interval") == 0)
+        {
+            A->PSGI            = atoi(argin[counter+1]);
+            A->PSGI_arg        = true;
+            fprintf(out, "Phase_singularity_interval   %s ", argin[counter+1]);
+            if (A->PSGI < 1)
+            {
+                printf("ERROR: Phase_singularity_interval must be at least 1 ms\n\n");
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Phase_singularity_delay") == 0)
+        {
+            A->PSGD            = atoi(argin[counter+1]);
+            A->PSGD_arg        = true;
+            fprintf(out, "Phase_singularity_delay   %s ", argin[counter+1]);
+            if (A->PSGD < 1)
+            {
+                printf("ERROR: Phase_singularity_delay must be at least 1 ms\n\n");
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Phase_singularity_radius") == 0)
+        {
+            A->PSGR            = atof(argin[counter+1]);
+            A->PSGR_arg        = true;
+            fprintf(out, "Phase_singularity_radius   %s ", argin[counter+1]);
+            if (A->PSGR <= 0)
+            {
+                printf("ERROR: Phase_singularity_radius must be positive\n\n");
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Probe_file") == 0)
+        {
+            A->PRF             = argin[counter+1];
+            A->PRF_arg         = true;
+            fprintf(out, "Probe_file   %s ", argin[counter+1]);
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Regional_outputs") == 0)
+        {
+            A->RGO             = argin[counter+1];
+            A->RGO_arg         = true;
+            fprintf(out, "Regional_outputs   %s ", argin[counter+1]);
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Regional_outputs_stats") == 0)
+        {
+            A->RGOS            = argin[counter+1];
+            A->RGOS_arg        = true;
+            fprintf(out, "Regional_outputs_stats   %s ", argin[counter+1]);
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Regional_outputs_interval") == 0)
+        {
+            A->RGOI            = atoi(argin[counter+1]);
+            A->RGOI_arg        = true;
+            fprintf(out, "Regional_outputs_interval   %s ", argin[counter+1]);
+            if (A->RGOI < 1)
+            {
+                printf("ERROR: Regional_outputs_interval must be at least 1 ms\n\n");
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Tissue_cache") == 0)
+        {
+            A->TCH             = argin[counter+1];
+            A->TCH_arg         = true;
+            fprintf(out, "Tissue_cache   %s ", argin[counter+1]);
+            if (strcmp(A->TCH, "Off") != 0 && strcmp(A->TCH, "auto") != 0 && strcmp(A->TCH, "On") != 0)
+            {
+                printf("ERROR: \"%s\" is not a valid Tissue_cache argument. Please pass only \"Off\", \"auto\" or \"On\"\n\n", A->TCH);
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Setup_diagnostics") == 0)
+        {
+            A->SUD             = argin[counter+1];
+            A->SUD_arg         = true;
+            fprintf(out, "Setup_diagnostics   %s ", argin[counter+1]);
+            if (strcmp(A->SUD, "Off") != 0 && strcmp(A->SUD, "On") != 0)
+            {
+                printf("ERROR: \"%s\" is not a valid Setup_diagnostics argument. Please pass only \"Off\" or \"On\"\n\n", A->SUD);
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Steady_state") == 0)
+        {
+            A->SS              = argin[counter+1];
+            A->SS_arg          = true;
+            fprintf(out, "Steady_state   %s ", argin[counter+1]);
+            if (strcmp(A->SS, "Off") != 0 && strcmp(A->SS, "On") != 0)
+            {
+                printf("ERROR: \"%s\" is not a valid Steady_state argument. Please pass only \"Off\" or \"On\"\n\n", A->SS);
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Steady_state_beats") == 0)
+        {
+            A->SSB             = atoi(argin[counter+1]);
+            A->SSB_arg         = true;
+            fprintf(out, "Steady_state_beats   %s ", argin[counter+1]);
+            if (A->SSB < 1)
+            {
+                printf("ERROR: Steady_state_beats must be at least 1\n\n");
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Steady_state_tol_APD90") == 0)
+        {
+            A->SSTA            = atof(argin[counter+1]);
+            A->SSTA_arg        = true;
+            fprintf(out, "Steady_state_tol_APD90   %s ", argin[counter+1]);
+            if (A->SSTA < 0)
+            {
+                printf("ERROR: Steady_state_tol_APD90 must be positive (%%)\n\n");
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Steady_state_tol_CaT") == 0)
+        {
+            A->SSTC            = atof(argin[counter+1]);
+            A->SSTC_arg        = true;
+            fprintf(out, "Steady_state_tol_CaT   %s ", argin[counter+1]);
+            if (A->SSTC < 0)
+            {
+                printf("ERROR: Steady_state_tol_CaT must be positive (%%)\n\n");
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Steady_state_tol_Nai") == 0)
+        {
+            A->SSTN            = atof(argin[counter+1]);
+            A->SSTN_arg        = true;
+            fprintf(out, "Steady_state_tol_Nai   %s ", argin[counter+1]);
+            if (A->SSTN < 0)
+            {
+                printf("ERROR: Steady_state_tol_Nai must be positive (%%)\n\n");
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Steady_state_tol_CaSR") == 0)
+        {
+            A->SSTS            = atof(argin[counter+1]);
+            A->SSTS_arg        = true;
+            fprintf(out, "Steady_state_tol_CaSR   %s ", argin[counter+1]);
+            if (A->SSTS < 0)
+            {
+                printf("ERROR: Steady_state_tol_CaSR must be positive (%%)\n\n");
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Periodic_orbit") == 0)
+        {
+            A->PO              = argin[counter+1];
+            A->PO_arg          = true;
+            fprintf(out, "Periodic_orbit   %s ", argin[counter+1]);
+            if (strcmp(A->PO, "Off") != 0 && strcmp(A->PO, "On") != 0)
+            {
+                printf("ERROR: \"%s\" is not a valid Periodic_orbit argument. Please pass only \"Off\" or \"On\"\n\n", A->PO);
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Periodic_orbit_tol") == 0)
+        {
+            A->POT             = atof(argin[counter+1]);
+            A->POT_arg         = true;
+            fprintf(out, "Periodic_orbit_tol   %s ", argin[counter+1]);
+            if (A->POT <= 0)
+            {
+                printf("ERROR: Periodic_orbit_tol must be positive\n\n");
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Periodic_orbit_iterations") == 0)
+        {
+            A->POI             = atoi(argin[counter+1]);
+            A->POI_arg         = true;
+            fprintf(out, "Periodic_orbit_iterations   %s ", argin[counter+1]);
+            if (A->POI < 0)
+            {
+                printf("ERROR: Periodic_orbit_iterations must be positive (or 0)\n\n");
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Periodic_orbit_krylov") == 0)
+        {
+            A->POK             = atoi(argin[counter+1]);
+            A->POK_arg         = true;
+            fprintf(out, "Periodic_orbit_krylov   %s ", argin[counter+1]);
+            if (A->POK < 1)
+            {
+                printf("ERROR: Periodic_orbit_krylov must be at least 1\n\n");
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Periodic_orbit_prebeats") == 0)
+        {
+            A->POP             = atoi(argin[counter+1]);
+            A->POP_arg         = true;
+            fprintf(out, "Periodic_orbit_prebeats   %s ", argin[counter+1]);
+            if (A->POP < 0)
+            {
+                printf("ERROR: Periodic_orbit_prebeats must be positive (or 0)\n\n");
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Periodic_orbit_aitken") == 0)
+        {
+            A->POA             = atoi(argin[counter+1]);
+            A->POA_arg         = true;
+            fprintf(out, "Periodic_orbit_aitken   %s ", argin[counter+1]);
+            if (A->POA < 0)
+            {
+                printf("ERROR: Periodic_orbit_aitken must be positive (or 0)\n\n");
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Restitution") == 0)
+        {
+            A->RP              = argin[counter+1];
+            A->RP_arg          = true;
+            fprintf(out, "Restitution   %s ", argin[counter+1]);
+            if (strcmp(A->RP, "Off") != 0 && strcmp(A->RP, "Dynamic") != 0 && strcmp(A->RP, "S1S2") != 0 && strcmp(A->RP, "ERP") != 0 && strcmp(A->RP, "All") != 0)
+            {
+                printf("ERROR: \"%s\" is not a valid Restitution argument. Please pass only \"Off\", \"Dynamic\", \"S1S2\", \"ERP\" or \"All\"\n\n", A->RP);
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Restitution_BCL") == 0)
+        {
+            A->RPB             = argin[counter+1];
+            A->RPB_arg         = true;
+            fprintf(out, "Restitution_BCL   %s ", argin[counter+1]);
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Restitution_beats") == 0)
+        {
+            A->RPN             = atoi(argin[counter+1]);
+            A->RPN_arg         = true;
+            fprintf(out, "Restitution_beats   %s ", argin[counter+1]);
+            if (A->RPN < 2)
+            {
+                printf("ERROR: Restitution_beats must be at least 2\n\n");
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Restitution_S2") == 0)
+        {
+            A->RPS             = argin[counter+1];
+            A->RPS_arg         = true;
+            fprintf(out, "Restitution_S2   %s ", argin[counter+1]);
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Restitution_window") == 0)
+        {
+            A->RPW             = atoi(argin[counter+1]);
+            A->RPW_arg         = true;
+            fprintf(out, "Restitution_window   %s ", argin[counter+1]);
+            if (A->RPW < 1)
+            {
+                printf("ERROR: Restitution_window must be at least 1 ms\n\n");
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Restitution_ERP_threshold") == 0)
+        {
+            A->RPT             = atof(argin[counter+1]);
+            A->RPT_arg         = true;
+            fprintf(out, "Restitution_ERP_threshold   %s ", argin[counter+1]);
+            if (A->RPT <= 0 || A->RPT > 1)
+            {
+                printf("ERROR: Restitution_ERP_threshold must be between 0 and 1\n\n");
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Restitution_ERP_resolution") == 0)
+        {
+            A->RPR             = atoi(argin[counter+1]);
+            A->RPR_arg         = true;
+            fprintf(out, "Restitution_ERP_resolution   %s ", argin[counter+1]);
+            if (A->RPR < 1)
+            {
+                printf("ERROR: Restitution_ERP_resolution must be at least 1 ms\n\n");
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Sensitivity") == 0)
+        {
+            A->SEN             = argin[counter+1];
+            A->SEN_arg         = true;
+            fprintf(out, "Sensitivity   %s ", argin[counter+1]);
+            if (strcmp(A->SEN, "On") != 0 && strcmp(A->SEN, "Off") != 0)
+            {
+                printf("ERROR: \"%s\" is not a valid Sensitivity argument. Please pass only \"On\" or \"Off\"\n\n", A->SEN);
+                exit(1);
+            }
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Sensitivity_parameters") == 0)
+        {
+            A->SENP            = argin[counter+1];
+            A->SENP_arg        = true;
+            fprintf(out, "Sensitivity_parameters   %s ", argin[counter+1]);
+            counter++; isFound = true;
+        }
+        if (strcmp(argin[counter], "Sensitivity_step") == 0)
+        {
+            A->SENH            = atof(argin[counter+1]);
+            A->SENH_arg        = true;
+            fprintf(out, "Sensitivity_step   %s ", argin[counter+1]);
+            if (A->SENH <= 0 || A->SENH > 0.1)
+            {
+                printf("ERROR: Sensitivity_step must be between 0 and 0.1\n\n");
+                exit(1);
+            }
+            counter++; isFound = true;
         }
 		if (strcmp(argin[counter], "Multi_stim") == 0)
 		{
@@ -1459,6 +2202,11 @@ void set_arguments(int Narg, char *argin[], Argument_parameters *A, char const *
 			A->SRF_mode        = argin[counter+1];
 			A->SRF_mode_arg    = true;
 			fprintf(out, "SRF_mode %s ", argin[counter+1]);
+			if (strcmp(A->SRF_mode, "Off") != 0 && strcmp(A->SRF_mode, "Direct_Control") != 0 && strcmp(A->SRF_mode, "Dynamic") != 0 && strcmp(A->SRF_mode, "Read") != 0)
+			{
+				printf("ERROR: \"%s\" is not a valid SRF_mode argument. Please pass only \"Off\", \"Direct_Control\", \"Dynamic\" or (tissue only) \"Read\"\n\n", A->SRF_mode);
+				exit(1);
+			}
 			counter++; isFound = true;
 		}
 		if (strcmp(argin[counter], "SRF_model") == 0)
@@ -2266,7 +3014,11 @@ void set_arguments(int Narg, char *argin[], Argument_parameters *A, char const *
 			printf("\tReference [text]\tResults_Reference [text]\tState_Reference_read [text]\tState_Reference_write [text]\tVclamp [On/Off]\t{Read/Write}_state [On/Off/phase/single_cell/ave] (phase for tissue 2D+ only; single_cell/ave for tissue models only)\n\n");
 			printf("[Simulation settings]:\n");
 			printf("\tBCL [x (ms)]\tTotal_time [x (ms)]\tPaced_time [x (ms)]\tNBeats [n]\tdt [x (ms)]\n");
-			printf("\tS2  [x (ms)]\tNS2 [n]\n\n");
+			printf("\tS2  [x (ms)]\tNS2 [n]\n");
+			printf("\tSteady_state [On/Off]\tSteady_state_beats [n]\tSteady_state_tol_{APD90/CaT/Nai/CaSR} [x (%%)] (native models)\n");
+			printf("\tPeriodic_orbit [On/Off]\tPeriodic_orbit_{tol/iterations/krylov/prebeats/aitken} [x] (native single cell)\n");
+			printf("\tRestitution [Off/Dynamic/S1S2/ERP/All]\tRestitution_{BCL/S2} [min,max,step]\tRestitution_{beats/window/ERP_threshold/ERP_resolution} [x] (native single cell)\n");
+			printf("\tSensitivity [On/Off]\tSensitivity_parameters [GX,GY,...]\tSensitivity_step [x] (native single cell)\n\n");
 			printf("[Model and cell conditions]:\n");
 			printf("\tModel [text]\tCelltype [text]\tAgent [text]\tRemodelling [text]\tISO [x (0-1uM)]\tISO_model [text]\n");
 			printf("\tACh [0-1]\tACh_model [text]\n");
@@ -2289,6 +3041,21 @@ void set_arguments(int Narg, char *argin[], Argument_parameters *A, char const *
 			{
 				printf("Additional tissue model options:\n");
 				printf("\tSpatial_output_interval_{vtk/data} [int ms]\t Spatial_output_range_{start/end} [int ms]\n");
+				printf("\tSpatial_output_async [On/Off]\t Spatial_output_writers [n]\t Spatial_output_buffers [n]\n");
+				printf("\tSpatial_output_vtk_format [legacy/vti/vtu]\t Spatial_output_precision [float/double]\t Spatial_output_compression [Off/zlib]\n");
+				printf("\tSpatial_output_data_format [bin/container]\n");
+				printf("\tSpatial_output_interval_reduced [n ms]\t Spatial_output_reduced_variables [name[:min:max[:stride[:mode[:bits]]]],...]\n");
+				printf("\tSpatial_output_reduced_stride [n]\t Spatial_output_reduced_mode [average/stride]\t Spatial_output_reduced_bits [8/16]\n");
+				printf("\tSpatial_output_reduced_ROI [full/box/map]\t Spatial_output_reduced_box [x0,x1,y0,y1,z0,z1]\t Spatial_output_reduced_map_file [filename]\n");
+				printf("\tCheckpoint_interval [x ms]\t Checkpoint_keep [n]\t Read_checkpoint [Off/latest/filename]\n");
+				printf("\tCheckpoint_deltas [n]\t Checkpoint_compression [Off/rle/zlib]\n");
+				printf("\tS2_sweep [Off/scan/bisect]\t S2_sweep_locations [S2/x1,x2,...]\t S2_sweep_CL [min,max,step]\n");
+				printf("\tS2_sweep_resolution [n ms]\t S2_sweep_window [n ms]\t S2_sweep_branches [n]\n");
+				printf("\tBeat_maps [On/Off]\t Beat_maps_APD [x1,x2,... (%%)]\n");
+				printf("\tPseudo_ECG [On/Off]\t Pseudo_ECG_electrodes [auto/x,y,z:x,y,z:... (mm)]\t Pseudo_ECG_leads [none/a-b,c-d,...]\n");
+				printf("\tPhase_singularity [On/Off]\t Phase_singularity_{interval/delay} [n ms]\t Phase_singularity_radius [x mm]\n");
+				printf("\tProbe_file [Off/filename]\t Regional_outputs [Off/geo/filename]\t Regional_outputs_stats [mean,min,max,active]\t Regional_outputs_interval [n ms]\n");
+				printf("\tTissue_cache [Off/auto/On]\t Setup_diagnostics [Off/On]\n");
 				printf("\tTissue_order	[1D/2D/3D/geo]\t Tissue_model [basic, ...]\t Tissue_type [homogeneous/heterogeneous]\n");
 				printf("\tOrientation_type [isotropic/anisotropic]\t D_uniformity [uniform/regional/map]\n");
                 printf("\tSpatial_output_interval_{vtk/data} [int ms]\n");
@@ -2328,6 +3095,14 @@ void set_arguments(int Narg, char *argin[], Argument_parameters *A, char const *
             {
                 printf("Additional spatial cell model model options:\n");
 				printf("\tSpatial_output_interval_{vtk/data} [int ms]\t Spatial_output_range_{start/end} [int ms]\\n");
+				printf("\tSpatial_output_async [On/Off]\t Spatial_output_writers [n]\t Spatial_output_buffers [n]\n");
+				printf("\tSpatial_output_vtk_format [legacy/vti/vtu]\t Spatial_output_precision [float/double]\t Spatial_output_compression [Off/zlib]\n");
+				printf("\tSpatial_output_data_format [bin/container]\n");
+				printf("\tSpatial_output_interval_reduced [n ms]\t Spatial_output_reduced_variables [name[:min:max[:stride[:mode[:bits]]]],...]\n");
+				printf("\tSpatial_output_reduced_stride [n]\t Spatial_output_reduced_mode [average/stride]\t Spatial_output_reduced_bits [8/16]\n");
+				printf("\tSpatial_output_reduced_ROI [full/box/map]\t Spatial_output_reduced_box [x0,x1,y0,y1,z0,z1]\t Spatial_output_reduced_map_file [filename]\n");
+				printf("\tCheckpoint_interval [x ms]\t Checkpoint_keep [n]\t Read_checkpoint [Off/latest/filename]\n");
+				printf("\tCheckpoint_deltas [n]\t Checkpoint_compression [Off/rle/zlib]\n");
 				printf("\tCell_size [string]\tSim_cell_size [string]\tCai [uM]\tCaSR [uM]\n");
 				//printf("\tDetub [On/Off]\tTT_map_file [string]\tLTCC_redist [On/Off]\n");
                 printf("\tSERCA_het [On/Off]\tNCX_het [On/Off]\tRyR_het [Off/random/map]\tLTCC_het [Off/random/map]\tvolds_het [On/Off]\n");
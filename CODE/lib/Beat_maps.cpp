@@ -0,0 +1,387 @@
+// Source code associated with  ===========================  //
+// "Multi-scale cardiac simulation framework" =============  //
+// For simulation of cardiac cellular and tissue dynamics =  //
+// from the spatial cellular to full organ scales. ========  //
+// With implementation of multiple, published cell models =  //
+// as well as novel models developed in my lab. ===========  //
+// ========================================================  //
+// This file: Per-beat activation, APD ====================  //
+// and CV maps ============ ===============================  //
+// ========================================================  //
+// GNU 3 LICENSE TEXT =====================================  //
+// COPYRIGHT (C) 2016-2019 MICHAEL A. COLMAN ==============  //
+// THIS PROGRAM IS FREE SOFTWARE: YOU CAN REDISTRIBUTE IT =  //
+// AND/OR MODIFY IT UNDER THE TERMS OF THE GNU GENERAL ====  //
+// PUBLIC LICENSE AS PUBLISHED BY THE FREE SOFTWARE =======  //
+// FOUNDATION, EITHER VERSION 3 OF THE LICENSE, OR (AT YOUR  //
+// OPTION) ANY LATER VERSION. =============================  //
+// THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE=  //
+// USEFUL, BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE =====  //
+// IMPLIED WARRANTY OF MERCHANTABILITY OR FITNESS FOR A ===  //
+// PARTICULAR PURPOSE.  SEE THE GNU GENERAL PUBLIC LICENSE=  //
+// FOR MORE DETAILS. ======================================  //
+// YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL =====  //
+// PUBLIC LICENSE ALONG WITH THIS PROGRAM.  IF NOT, SEE ===  //
+// <https://www.gnu.org/licenses/>. =======================  //
+// ========================================================  //
+// ADDITIONAL LICENSE TEXT ================================  //
+// THIS SOFTWARE IS PROVIDED OPEN SOURCE AND MAY BE FREELY=  //
+// USED, DISTRIBUTED AND UPDATED, PROVIDED: ===============  //
+//  (i) THE APPROPRIATE WORK(S) IS(ARE) CITED. THIS =======  //
+//      PERTAINS TO THE CITATION OF COLMAN 2019 PLOS COMP =  //
+//      BIOL (FOR THIS IMPLEMTATION) AND ALL WORKS ========  //
+//      ASSOCIATED WITH THE SPECIFIC MODELS AND COMPONENTS=  //
+//      USED IN PARTICULAR SIMULATIONS. IT IS THE USER'S ==  //
+//      RESPONSIBILITY TO ENSURE ALL RELEVANT WORKS ARE ===  //
+//      CITED. PLEASE SEE FULL DOCUMENTATION AND ON-SCREEN=  //
+//      DISCLAIMER OUTPUTS FOR A GUIDE. ===================  //
+//  (ii) ALL OF THIS TEXT IS RETAINED WITHIN OR ASSOCIATED=  //
+//      WITH THE SOURCE CODE AND/OR BINARY FORM OF THE ====  //
+//      SOFTWARE. =========================================  //
+// ========================================================  //
+// ANY INTENDED COMMERCIAL USE OF THIS SOFTWARE MUST BE BY   //
+// EXPRESS PERMISSION OF MICHAEL A COLMAN ONLY. IN NO EVENT  //
+// ARE THE COPYRIGHT HOLDERS LIABLE FOR ANY DIRECT, =======  //
+// INDIRECT INCIDENTAL, SPECIAL, EXEMPLARY OR CONSEQUENTIAL  //
+// DAMAGES ASSOCIATED WITH USE OF THIS SOFTWARE ===========  //
+// ========================================================  //
+// THIS SOFTWARE CONTAINS IMPLEMENTATIONS OF MODELS AND ===  //
+// COMPONENTS WHICH I (MICHAEL COLMAN) DID NOT DEVELOP.====  //
+// ALL OF THESE COMPONENTS HAVE BEEN CODED FROM PROVIDED ==  //
+// SOURCE CODE OR INFORMATION IN THE PUBLICATIONS. ========  //
+// I CLAIM NO RIGHTS OR INTELLECTUAL PROPERTY OWNERSHIP ===  //
+// FOR THESE MODELS AND COMPONENTS, OTHER THAN THEIR ======  //
+// SPECIFIC IMPLEMENTATION IN THIS CODE PACKAGE. FURTHER TO  //
+// THE ABOVE STATEMENT, ANY INDTENDED COMMERCIAL USE OF ===  //
+// THOSE COMPONENTS MUST BE BY EXPRESS PERMISSION OF THE ==  //
+// ORIGINAL COPYRIGHT HOLDERS. ============================  //
+// WHERE IMPLEMENTED FROM PROVIDED CODE, ANY DISCLAIMERS ==  //
+// PRESENT IN THE ORIGINAL CODE HAVE BEEN RETAINED IN THE =  //
+// RELEVANT FILE. =========================================  //
+// ========================================================  //
+// Contact: m.a.colman@leeds.ac.uk ========================  //
+// For updates, corrections etc, please check: ============  //
+// 1. http://physicsoftheheart.com/ =======================  //
+// 2. https://github.com/michaelcolman ====================  //
+// ========================================================  //
+
+#include "Beat_maps.h"
+#include "Output_writer.h"
+#include "Structs.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <omp.h>
+
+// Function list ================================================================================\\|
+//	beat_maps_init()
+//	beat_maps_cell()
+//	beat_maps_update()
+//	beat_maps_finalise()
+//
+//	Internal
+//	    beat_maps_gradient()
+//	    beat_maps_write()
+// End Function list ============================================================================//|
+
+// Notes ========================================================================================\\|
+// Replaces post-processing of full Vm frames for activation, APD and CV maps. beat_maps_cell() is
+// called for every cell inside the tissue loop with V at t-dt and t; it does work only at events:
+//  activation      upward crossing of BM_V_ACT; the time is interpolated within the step
+//  repolarisation  crossing of Vmax - X(Vmax - Vrest) for each Beat_maps_APD threshold X (ascending),
+//                  tracked as the next pending threshold only (as calculate_measurement_properties,
+//                  lib/Model.c); Vrest is the minimum V between the previous excitation and this one
+// Activation is re-armed once V < BM_V_REP. Thresholds still pending at the next activation are
+// recorded as not reached (-1).
+// Beats are held in a ring of BM_RING beats. beat_maps_update() (serial, once per step) writes 
+// beat k once every cell has activated for beat k+1 (so beat k has repolarised everywhere), or
+// earlier if a cell is about to overwrite it (re-entry, block, cells that never activate); the 
+// remaining beats are written by beat_maps_finalise(). Beat k is the k-th activation of each cell,
+// so under re-entry it is not necessarily the same wavefront everywhere.
+// CV is the vector grad(AT)/|grad(AT)|^2 (mm/ms = m/s), from central differences of the activation
+// time (one-sided at edges and next to cells that did not activate in the beat); undefined (-1)
+// where the gradient is zero (e.g. the stimulus site).
+// Outputs:
+//  Spatial_Results/Beat_map_XXXX.bin   int N, int Nthr, double thresholds[Nthr], then float arrays
+//                                      of N: AT, APD for each threshold, CVx, CVy, CVz (-1 = missing;
+//                                      repolarisation time = AT + APD)
+//  Spatial_Results/Beat_{AT/APDX/CV}_output_XXXX.{vtk/vti/vtu}   via the output writer (lib/Output_writer.cpp)
+//  Beat_maps.dat                       one line per beat: range of AT, APD mean/min/max, CV
+// Maps are not part of checkpoints: after Read_checkpoint numbering restarts from the restart time.
+// End Notes ====================================================================================//|
+
+// Internal =====================================================================================\\|
+// Gradient of activation time along one axis at cell n (neighbours p, m; -1 = not activated)
+static double beat_maps_gradient(const double *at, int n, int p, int m, double h)
+{
+	bool hp = (p != n && at[p] >= 0);
+	bool hm = (m != n && at[m] >= 0);
+	if (hp && hm)   return (at[p] - at[m])/(2*h);
+	else if (hp)    return (at[p] - at[n])/h;
+	else if (hm)    return (at[n] - at[m])/h;
+	return 0;
+}
+
+// Write the oldest beat in the ring and free its slot
+static void beat_maps_write(Beat_maps *bm, Output_writer *ow, bool forced)
+{
+	int N       = bm->N;
+	int k       = bm->written;
+	int slot    = k%BM_RING;
+	double *at  = bm->map;          // activation time, -1 if not activated in this beat
+	double *map = &bm->map[N];
+	char str[1100];
+
+	double at_min = 1e30, at_max = -1;
+	int Nact = 0;
+	for (int n = 0; n < N; n++)
+	{
+		at[n] = (bm->count[n] > k) ? bm->at[slot*N + n] : -1;
+		if (at[n] < 0) continue;
+		Nact++;
+		if (at[n] < at_min) at_min = at[n];
+		if (at[n] > at_max) at_max = at[n];
+	}
+	if (Nact == 0) at_min = -1;
+
+	sprintf(str, "%s/%s/Beat_map_%04d.bin", bm->dir, bm->dir2, k);
+	FILE *out = fopen(str, "wb");
+	if (out == NULL)
+	{
+		printf("ERROR: cannot open %s\n", str);
+		exit(1);
+	}
+	fwrite(&N, sizeof(int), 1, out);
+	fwrite(&bm->Nthr, sizeof(int), 1, out);
+	fwrite(bm->perc, sizeof(double), bm->Nthr, out);
+
+	for (int n = 0; n < N; n++) bm->out[n] = (float)at[n];
+	fwrite(bm->out, sizeof(float), N, out);
+	output_writer_vtk_3D(ow, "Beat_AT", at, k);     // lib/Output_writer.cpp
+
+	fprintf(bm->log, "%d %d %.3f %.3f", k, Nact, at_min, at_max);
+	for (int j = 0; j < bm->Nthr; j++)
+	{
+		double *rt = &bm->rt[(slot*bm->Nthr + j)*N];
+		double sum = 0, min = 1e30, max = -1;
+		int Nrep = 0;
+		for (int n = 0; n < N; n++)
+		{
+			map[n] = (at[n] >= 0 && rt[n] >= 0) ? rt[n] - at[n] : -1;
+			bm->out[n] = (float)map[n];
+			if (map[n] < 0) continue;
+			Nrep++;
+			sum += map[n];
+			if (map[n] < min) min = map[n];
+			if (map[n] > max) max = map[n];
+		}
+		fwrite(bm->out, sizeof(float), N, out);
+		sprintf(str, "Beat_APD%g", bm->perc[j]);
+		output_writer_vtk_3D(ow, str, map, k);
+		if (Nrep > 0)   fprintf(bm->log, " %.3f %.3f %.3f", sum/Nrep, min, max);
+		else            fprintf(bm->log, " -1 -1 -1");
+	}
+
+	// CV vectors; map = |CV|, out = components
+	float *cv = (float*)malloc(3*N*sizeof(float));
+	double sum_g = 0;
+	int Ng = 0;
+#pragma omp parallel for reduction(+:sum_g, Ng)
+	for (int n = 0; n < N; n++)
+	{
+		cv[n] = cv[N + n] = cv[2*N + n] = 0;
+		map[n] = -1;
+		if (at[n] < 0) continue;
+		double gx = beat_maps_gradient(at, n, bm->xp[n], bm->xm[n], bm->dx);
+		double gy = beat_maps_gradient(at, n, bm->yp[n], bm->ym[n], bm->dy);
+		double gz = beat_maps_gradient(at, n, bm->zp[n], bm->zm[n], bm->dz);
+		double g2 = gx*gx + gy*gy + gz*gz;
+		if (g2 <= 0) continue;
+		cv[n]       = (float)(gx/g2);
+		cv[N + n]   = (float)(gy/g2);
+		cv[2*N + n] = (float)(gz/g2);
+		map[n]      = 1.0/sqrt(g2);
+		sum_g      += sqrt(g2);
+		Ng++;
+	}
+	fwrite(cv, sizeof(float), 3*N, out);
+	fclose(out);
+	free(cv);
+	output_writer_vtk_3D(ow, "Beat_CV", map, k);
+
+	if (sum_g > 0)  fprintf(bm->log, " %.5f", Ng/sum_g);
+	else            fprintf(bm->log, " -1");
+	fprintf(bm->log, " %s\n", forced ? "forced" : "complete");
+
+	bm->activated[slot] = 0;
+	bm->written++;
+}
+// End Internal =================================================================================//|
+
+// Setup ========================================================================================\\|
+void beat_maps_init(Beat_maps *bm, Simulation_parameters sim, SC_variables sc, const char *directory, const char *dir2)
+{
+	memset(bm, 0, sizeof(Beat_maps));
+	if (strcmp(sim.Beat_maps, "On") != 0) return;
+
+	// Per-cell crossing state and beat counts are not part of the checkpoint
+	if (strcmp(sim.Read_checkpoint, "Off") != 0)
+	{
+		printf("ERROR: Beat_maps On cannot be used with Read_checkpoint (per-cell beat state is not continued from a checkpoint); set Beat_maps Off for the restart\n");
+		exit(1);
+	}
+
+	// Thresholds (% repolarisation), sorted ascending so they are crossed in order
+	char list[1000];
+	strncpy(list, sim.Beat_maps_APD, 999);
+	list[999] = '\0';
+	for (char *tok = strtok(list, ","); tok != NULL; tok = strtok(NULL, ","))
+	{
+		double x = atof(tok);
+		if (x <= 0 || x >= 100 || bm->Nthr == BM_MAX_THRESHOLDS)
+		{
+			printf("ERROR: Beat_maps_APD must be up to %d comma-separated %% repolarisation thresholds between 0 and 100, e.g. 90,50\n", BM_MAX_THRESHOLDS);
+			exit(1);
+		}
+		int j = bm->Nthr++;
+		while (j > 0 && bm->perc[j-1] > x) { bm->perc[j] = bm->perc[j-1]; j--; }
+		bm->perc[j] = x;
+	}
+	if (bm->Nthr == 0)
+	{
+		printf("ERROR: Beat_maps_APD must contain at least one threshold, e.g. 90,50\n");
+		exit(1);
+	}
+
+	bm->on      = true;
+	bm->N       = sc.N;
+	bm->dx      = sc.dx;
+	bm->dy      = sc.dy;
+	bm->dz      = sc.dz;
+	bm->xp      = sc.xp;    bm->xm  = sc.xm;
+	bm->yp      = sc.yp;    bm->ym  = sc.ym;
+	bm->zp      = sc.zp;    bm->zm  = sc.zm;
+
+	int N       = bm->N;
+	bm->count   = (int*)malloc(N*sizeof(int));
+	bm->excited = (int*)malloc(N*sizeof(int));
+	bm->next    = (int*)malloc(N*sizeof(int));
+	bm->Vrest   = (double*)malloc(N*sizeof(double));
+	bm->Vmin    = (double*)malloc(N*sizeof(double));
+	bm->Vmax    = (double*)malloc(N*sizeof(double));
+	bm->at      = (double*)malloc(BM_RING*N*sizeof(double));
+	bm->rt      = (double*)malloc(BM_RING*bm->Nthr*N*sizeof(double));
+	bm->map     = (double*)malloc(2*N*sizeof(double));
+	bm->out     = (float*)malloc(N*sizeof(float));
+	for (int n = 0; n < N; n++)
+	{
+		bm->count[n]    = 0;
+		bm->excited[n]  = 0;
+		bm->next[n]     = bm->Nthr;
+		bm->Vrest[n]    = bm->Vmax[n] = 0;
+		bm->Vmin[n]     = 50;   // ensure above values
+	}
+
+	sprintf(bm->dir, "%s", directory);
+	sprintf(bm->dir2, "%s", dir2);
+	char *filename  = (char*)malloc(1000);
+	if (sim.Windows == true)    sprintf(filename, "%s\\Beat_maps.dat", directory);
+	else                        sprintf(filename, "%s/Beat_maps.dat", directory);
+	bm->log         = fopen(filename, "wt");
+	if (bm->log == NULL)
+	{
+		printf("ERROR: cannot open %s\n", filename);
+		exit(1);
+	}
+	fprintf(bm->log, "# beat cells_activated AT_min(ms) AT_max(ms) |");
+	for (int j = 0; j < bm->Nthr; j++) fprintf(bm->log, " APD%g_mean APD%g_min APD%g_max", bm->perc[j], bm->perc[j], bm->perc[j]);
+	fprintf(bm->log, " | CV(m/s; 1/mean|grad AT|) | complete/forced\n");
+	free(filename);
+
+	printf("Beat maps: activation, APD (%s %%) and CV per beat written to %s/%s/Beat_map_XXXX.bin\n", sim.Beat_maps_APD, directory, dir2);
+}
+// End Setup ====================================================================================//|
+
+// Tissue loop ==================================================================================\\|
+// Called for cell n inside the (parallel) tissue loop, after the voltage update; V1 = V at t-dt, V2 = V at t
+void beat_maps_cell(Beat_maps *bm, int n, double V1, double V2, double time, double dt)
+{
+	if (bm->on == false) return;
+	int N = bm->N;
+
+	if (bm->excited[n] == 0)
+	{
+		if (V1 <= BM_V_ACT && V2 > BM_V_ACT) // activation
+		{
+			int k       = bm->count[n];
+			int slot    = k%BM_RING;
+			bm->at[slot*N + n] = time - dt + dt*(BM_V_ACT - V1)/(V2 - V1);
+			for (int j = 0; j < bm->Nthr; j++) bm->rt[(slot*bm->Nthr + j)*N + n] = -1;
+			bm->Vrest[n]    = bm->Vmin[n];
+			bm->Vmax[n]     = V2;
+			bm->next[n]     = 0;
+			bm->excited[n]  = 1;
+			bm->count[n]++;
+#pragma omp atomic
+			bm->activated[slot]++;
+		}
+		else if (V2 < bm->Vmin[n]) bm->Vmin[n] = V2;
+	}
+	else if (V2 < BM_V_REP) // end of excitation; re-arm activation
+	{
+		bm->excited[n]  = 0;
+		bm->Vmin[n]     = V2;
+	}
+
+	// Next pending repolarisation threshold (may still be pending after the end of excitation)
+	if (bm->next[n] < bm->Nthr)
+	{
+		if (V2 > bm->Vmax[n]) bm->Vmax[n] = V2;
+		int slot = (bm->count[n] - 1)%BM_RING;
+		while (bm->next[n] < bm->Nthr)
+		{
+			int j = bm->next[n];
+			double threshold = bm->Vmax[n] - 0.01*bm->perc[j]*(bm->Vmax[n] - bm->Vrest[n]);
+			if (V2 >= threshold) break;
+			double f = (V1 > threshold) ? (V1 - threshold)/(V1 - V2) : 0;   // V1 may be below if Vmax was set this step
+			bm->rt[(slot*bm->Nthr + j)*N + n] = time - dt + f*dt;
+			bm->next[n]++;
+		}
+	}
+}
+
+// Called once per step after the tissue loop: writes beats that are complete, or that would be 
+// overwritten by the next activation
+void beat_maps_update(Beat_maps *bm, Output_writer *ow)
+{
+	if (bm->on == false) return;
+	while (true)
+	{
+		int k = bm->written;
+		if (bm->activated[(k + 1)%BM_RING] == bm->N)                beat_maps_write(bm, ow, false);
+		else if (bm->activated[(k + BM_RING - 1)%BM_RING] > 0)      beat_maps_write(bm, ow, true);
+		else break;
+	}
+}
+
+// Write the beats still in the ring; call before output_writer_finalise()
+void beat_maps_finalise(Beat_maps *bm, Output_writer *ow)
+{
+	if (bm->on == false) return;
+	while (bm->activated[bm->written%BM_RING] > 0) beat_maps_write(bm, ow, false);
+	fclose(bm->log);
+	printf("Beat maps: %d beats written\n", bm->written);
+
+	free(bm->count);
+	free(bm->excited);
+	free(bm->next);
+	free(bm->Vrest);
+	free(bm->Vmin);
+	free(bm->Vmax);
+	free(bm->at);
+	free(bm->rt);
+	free(bm->map);
+	free(bm->out);
+}
+// End Tissue loop ==============================================================================//|
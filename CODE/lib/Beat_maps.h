@@ -0,0 +1,118 @@
+// Source code associated with  ===========================  //
+// "Multi-scale cardiac simulation framework" =============  //
+// For simulation of cardiac cellular and tissue dynamics =  //
+// from the spatial cellular to full organ scales. ========  //
+// With implementation of multiple, published cell models =  //
+// as well as novel models developed in my lab. ===========  //
+// ========================================================  //
+// This file: Per-beat activation, APD ====================  //
+// and CV maps, header ====================================  //
+// ========================================================  //
+// GNU 3 LICENSE TEXT =====================================  //
+// COPYRIGHT (C) 2016-2019 MICHAEL A. COLMAN ==============  //
+// THIS PROGRAM IS FREE SOFTWARE: YOU CAN REDISTRIBUTE IT =  //
+// AND/OR MODIFY IT UNDER THE TERMS OF THE GNU GENERAL ====  //
+// PUBLIC LICENSE AS PUBLISHED BY THE FREE SOFTWARE =======  //
+// FOUNDATION, EITHER VERSION 3 OF THE LICENSE, OR (AT YOUR  //
+// OPTION) ANY LATER VERSION. =============================  //
+// THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE=  //
+// USEFUL, BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE =====  //
+// IMPLIED WARRANTY OF MERCHANTABILITY OR FITNESS FOR A ===  //
+// PARTICULAR PURPOSE.  SEE THE GNU GENERAL PUBLIC LICENSE=  //
+// FOR MORE DETAILS. ======================================  //
+// YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL =====  //
+// PUBLIC LICENSE ALONG WITH THIS PROGRAM.  IF NOT, SEE ===  //
+// <https://www.gnu.org/licenses/>. =======================  //
+// ========================================================  //
+// ADDITIONAL LICENSE TEXT ================================  //
+// THIS SOFTWARE IS PROVIDED OPEN SOURCE AND MAY BE FREELY=  //
+// USED, DISTRIBUTED AND UPDATED, PROVIDED: ===============  //
+//  (i) THE APPROPRIATE WORK(S) IS(ARE) CITED. THIS =======  //
+//      PERTAINS TO THE CITATION OF COLMAN 2019 PLOS COMP =  //
+//      BIOL (FOR THIS IMPLEMTATION) AND ALL WORKS ========  //
+//      ASSOCIATED WITH THE SPECIFIC MODELS AND COMPONENTS=  //
+//      USED IN PARTICULAR SIMULATIONS. IT IS THE USER'S ==  //
+//      RESPONSIBILITY TO ENSURE ALL RELEVANT WORKS ARE ===  //
+//      CITED. PLEASE SEE FULL DOCUMENTATION AND ON-SCREEN=  //
+//      DISCLAIMER OUTPUTS FOR A GUIDE. ===================  //
+//  (ii) ALL OF THIS TEXT IS RETAINED WITHIN OR ASSOCIATED=  //
+//      WITH THE SOURCE CODE AND/OR BINARY FORM OF THE ====  //
+//      SOFTWARE. =========================================  //
+// ========================================================  //
+// ANY INTENDED COMMERCIAL USE OF THIS SOFTWARE MUST BE BY   //
+// EXPRESS PERMISSION OF MICHAEL A COLMAN ONLY. IN NO EVENT  //
+// ARE THE COPYRIGHT HOLDERS LIABLE FOR ANY DIRECT, =======  //
+// INDIRECT INCIDENTAL, SPECIAL, EXEMPLARY OR CONSEQUENTIAL  //
+// DAMAGES ASSOCIATED WITH USE OF THIS SOFTWARE ===========  //
+// ========================================================  //
+// THIS SOFTWARE CONTAINS IMPLEMENTATIONS OF MODELS AND ===  //
+// COMPONENTS WHICH I (MICHAEL COLMAN) DID NOT DEVELOP.====  //
+// ALL OF THESE COMPONENTS HAVE BEEN CODED FROM PROVIDED ==  //
+// SOURCE CODE OR INFORMATION IN THE PUBLICATIONS. ========  //
+// I CLAIM NO RIGHTS OR INTELLECTUAL PROPERTY OWNERSHIP ===  //
+// FOR THESE MODELS AND COMPONENTS, OTHER THAN THEIR ======  //
+// SPECIFIC IMPLEMENTATION IN THIS CODE PACKAGE. FURTHER TO  //
+// THE ABOVE STATEMENT, ANY INDTENDED COMMERCIAL USE OF ===  //
+// THOSE COMPONENTS MUST BE BY EXPRESS PERMISSION OF THE ==  //
+// ORIGINAL COPYRIGHT HOLDERS. ============================  //
+// WHERE IMPLEMENTED FROM PROVIDED CODE, ANY DISCLAIMERS ==  //
+// PRESENT IN THE ORIGINAL CODE HAVE BEEN RETAINED IN THE =  //
+// RELEVANT FILE. =========================================  //
+// ========================================================  //
+// Contact: m.a.colman@leeds.ac.uk ========================  //
+// For updates, corrections etc, please check: ============  //
+// 1. http://physicsoftheheart.com/ =======================  //
+// 2. https://github.com/michaelcolman ====================  //
+// ========================================================  //
+
+#ifndef BEAT_MAPS_H
+#define BEAT_MAPS_H
+
+#include "Structs.h"
+#include "Output_writer.h"
+#include <stdio.h>
+
+#define BM_MAX_THRESHOLDS   9
+#define BM_RING             4       // beats held in memory before a forced write
+#define BM_V_ACT            -30     // mV, activation (upstroke crossing)
+#define BM_V_REP            -45     // mV, end of excitation (re-arms activation detection)
+
+// Event-driven per-cell measurement of each activation: times are linearly interpolated within the 
+// step at which the threshold is crossed. Beat k of a cell is its k-th activation.
+typedef struct{
+	bool        on;
+	int         N;
+	int         Nthr;
+	double      perc[BM_MAX_THRESHOLDS];    // % repolarisation, ascending
+	double      dx, dy, dz;                 // mm
+	int         *xp, *xm, *yp, *ym, *zp, *zm;   // neighbours (self at edges/empty space) || SC_variables
+
+	// Per-cell tracking
+	int         *count;         // activations so far
+	int         *excited;       // 1 between activation and V < BM_V_REP
+	int         *next;          // next threshold pending for the current beat (Nthr = none)
+	double      *Vrest;         // minimum V before the current activation
+	double      *Vmin;          // minimum V since the end of the last excitation
+	double      *Vmax;          // peak V of the current beat
+
+	// Ring of beats not yet written
+	double      *at;            // BM_RING x N activation times (ms)
+	double      *rt;            // BM_RING x Nthr x N repolarisation times (ms; -1 = not reached)
+	int         activated[BM_RING]; // cells activated for each beat in the ring
+	int         written;        // beats written
+
+	// Output buffers
+	double      *map;
+	float       *out;
+
+	char        dir[1000];
+	char        dir2[1000];
+	FILE        *log;
+}Beat_maps;
+
+void beat_maps_init(Beat_maps *bm, Simulation_parameters sim, SC_variables sc, const char *directory, const char *dir2);
+void beat_maps_cell(Beat_maps *bm, int n, double V1, double V2, double time, double dt);
+void beat_maps_update(Beat_maps *bm, Output_writer *ow);
+void beat_maps_finalise(Beat_maps *bm, Output_writer *ow);
+
+#endif
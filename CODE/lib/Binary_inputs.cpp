@@ -0,0 +1,519 @@
+// Source code associated with  ===========================  //
+// "Multi-scale cardiac simulation framework" =============  //
+// For simulation of cardiac cellular and tissue dynamics =  //
+// from the spatial cellular to full organ scales. ========  //
+// With implementation of multiple, published cell models =  //
+// as well as novel models developed in my lab. ===========  //
+// ========================================================  //
+// This file: Binary geometry, fibre and ==================  //
+// map input files ========================================  //
+// ========================================================  //
+// GNU 3 LICENSE TEXT =====================================  //
+// COPYRIGHT (C) 2016-2019 MICHAEL A. COLMAN ==============  //
+// THIS PROGRAM IS FREE SOFTWARE: YOU CAN REDISTRIBUTE IT =  //
+// AND/OR MODIFY IT UNDER THE TERMS OF THE GNU GENERAL ====  //
+// PUBLIC LICENSE AS PUBLISHED BY THE FREE SOFTWARE =======  //
+// FOUNDATION, EITHER VERSION 3 OF THE LICENSE, OR (AT YOUR  //
+// OPTION) ANY LATER VERSION. =============================  //
+// THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE=  //
+// USEFUL, BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE =====  //
+// IMPLIED WARRANTY OF MERCHANTABILITY OR FITNESS FOR A ===  //
+// PARTICULAR PURPOSE.  SEE THE GNU GENERAL PUBLIC LICENSE=  //
+// FOR MORE DETAILS. ======================================  //
+// YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL =====  //
+// PUBLIC LICENSE ALONG WITH THIS PROGRAM.  IF NOT, SEE ===  //
+// <https://www.gnu.org/licenses/>. =======================  //
+// ========================================================  //
+// ADDITIONAL LICENSE TEXT ================================  //
+// THIS SOFTWARE IS PROVIDED OPEN SOURCE AND MAY BE FREELY=  //
+// USED, DISTRIBUTED AND UPDATED, PROVIDED: ===============  //
+//  (i) THE APPROPRIATE WORK(S) IS(ARE) CITED. THIS =======  //
+//      PERTAINS TO THE CITATION OF COLMAN 2019 PLOS COMP =  //
+//      BIOL (FOR THIS IMPLEMTATION) AND ALL WORKS ========  //
+//      ASSOCIATED WITH THE SPECIFIC MODELS AND COMPONENTS=  //
+//      USED IN PARTICULAR SIMULATIONS. IT IS THE USER'S ==  //
+//      RESPONSIBILITY TO ENSURE ALL RELEVANT WORKS ARE ===  //
+//      CITED. PLEASE SEE FULL DOCUMENTATION AND ON-SCREEN=  //
+//      DISCLAIMER OUTPUTS FOR A GUIDE. ===================  //
+//  (ii) ALL OF THIS TEXT IS RETAINED WITHIN OR ASSOCIATED=  //
+//      WITH THE SOURCE CODE AND/OR BINARY FORM OF THE ====  //
+//      SOFTWARE. =========================================  //
+// ========================================================  //
+// ANY INTENDED COMMERCIAL USE OF THIS SOFTWARE MUST BE BY   //
+// EXPRESS PERMISSION OF MICHAEL A COLMAN ONLY. IN NO EVENT  //
+// ARE THE COPYRIGHT HOLDERS LIABLE FOR ANY DIRECT, =======  //
+// INDIRECT INCIDENTAL, SPECIAL, EXEMPLARY OR CONSEQUENTIAL  //
+// DAMAGES ASSOCIATED WITH USE OF THIS SOFTWARE ===========  //
+// ========================================================  //
+// THIS SOFTWARE CONTAINS IMPLEMENTATIONS OF MODELS AND ===  //
+// COMPONENTS WHICH I (MICHAEL COLMAN) DID NOT DEVELOP.====  //
+// ALL OF THESE COMPONENTS HAVE BEEN CODED FROM PROVIDED ==  //
+// SOURCE CODE OR INFORMATION IN THE PUBLICATIONS. ========  //
+// I CLAIM NO RIGHTS OR INTELLECTUAL PROPERTY OWNERSHIP ===  //
+// FOR THESE MODELS AND COMPONENTS, OTHER THAN THEIR ======  //
+// SPECIFIC IMPLEMENTATION IN THIS CODE PACKAGE. FURTHER TO  //
+// THE ABOVE STATEMENT, ANY INDTENDED COMMERCIAL USE OF ===  //
+// THOSE COMPONENTS MUST BE BY EXPRESS PERMISSION OF THE ==  //
+// ORIGINAL COPYRIGHT HOLDERS. ============================  //
+// WHERE IMPLEMENTED FROM PROVIDED CODE, ANY DISCLAIMERS ==  //
+// PRESENT IN THE ORIGINAL CODE HAVE BEEN RETAINED IN THE =  //
+// RELEVANT FILE. =========================================  //
+// ========================================================  //
+// Contact: m.a.colman@leeds.ac.uk ========================  //
+// For updates, corrections etc, please check: ============  //
+// 1. http://physicsoftheheart.com/ =======================  //
+// 2. https://github.com/michaelcolman ====================  //
+// ========================================================  //
+
+#include "Binary_inputs.h"
+#include "Structs.h"
+#include "Spatial_coupling.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdint.h>
+#include <omp.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Function list ================================================================================\\|
+//	binary_input_check()
+//	binary_input_read_geo()
+//	binary_input_read_cells_int()
+//	binary_input_read_cells_double()
+//	binary_input_parse_text()
+//	binary_input_write()
+//
+//	Internal
+//	    bi_open()
+//	    bi_close()
+//	    bi_checksum()
+//	    bi_value()
+//	    bi_check_size()
+//	    bi_slice_start()
+// End Function list ============================================================================//|
+
+// Notes ========================================================================================\\|
+// The text geometry, fibre and map files are whitespace separated values, one per voxel of the
+// full box, parsed serially with fscanf; for large anatomical meshes this dominates setup.
+// The binary form (see Binary_inputs.h) is written by convert_inputs (Data_convert_inputs_to_binary.cc)
+// and recognised by read_geo_file(), read_map_file(), read_map_file_double() and 
+// read_orientation_anatomical(_transverse)() from its magic; text files are read as before.
+// Binary files are memory mapped (read into memory on Windows), the checksum is verified and
+// the values copied into the Ncell arrays in parallel. Box indexed files are gathered to cells 
+// through the cell index of each voxel (per-slice counts, so also in parallel).
+// Values are stored in the type the text reader would have produced (int for geometry and integer
+// maps, float for fibres, double for maps), so a converted file gives identical setup arrays.
+// End Notes ====================================================================================//|
+
+#define BI_CHUNK    (1 << 20)   // bytes per checksum chunk
+
+typedef struct{
+	BI_header   head;
+	const unsigned char *data;  // first value
+	void        *base;          // mapping (or buffer)
+	size_t      length;
+	bool        mapped;
+	const char  *filename;
+}Binary_input;
+
+// Internal =====================================================================================\\|
+static int bi_type_size(int type)
+{
+	if (type == BI_INT32)   return 4;
+	if (type == BI_FLOAT32) return 4;
+	return 8;
+}
+
+// FNV-1a of each chunk (in parallel), then of the chunk hashes
+static uint64_t bi_checksum(const unsigned char *data, int64_t bytes)
+{
+	int64_t Nchunks = (bytes + BI_CHUNK - 1)/BI_CHUNK;
+	uint64_t *chunk = (uint64_t*)malloc((Nchunks > 0 ? Nchunks : 1)*sizeof(uint64_t));
+	#pragma omp parallel for schedule(static)
+	for (int64_t c = 0; c < Nchunks; c++)
+	{
+		int64_t end = (c+1)*BI_CHUNK < bytes ? (c+1)*BI_CHUNK : bytes;
+		uint64_t h  = 14695981039346656037ull;
+		for (int64_t i = c*BI_CHUNK; i < end; i++) { h ^= data[i]; h *= 1099511628211ull; }
+		chunk[c] = h;
+	}
+	uint64_t h = 14695981039346656037ull;
+	const unsigned char *d = (const unsigned char*)chunk;
+	for (int64_t i = 0; i < Nchunks*(int64_t)sizeof(uint64_t); i++) { h ^= d[i]; h *= 1099511628211ull; }
+	free(chunk);
+	return h;
+}
+
+static void bi_open(Binary_input *bi, const char *filename)
+{
+	bi->filename    = filename;
+	bi->mapped      = false;
+	bi->base        = NULL;
+#ifndef _WIN32
+	int fd = open(filename, O_RDONLY);
+	struct stat st;
+	if (fd >= 0 && fstat(fd, &st) == 0 && st.st_size >= BI_HEADER_SIZE)
+	{
+		bi->length  = st.st_size;
+		bi->base    = mmap(NULL, bi->length, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (bi->base == MAP_FAILED) bi->base = NULL;
+		else bi->mapped = true;
+	}
+	if (fd >= 0) close(fd);
+#endif
+	if (bi->base == NULL) // not mapped: read whole file
+	{
+		FILE *in = fopen(filename, "rb");
+		if (in == NULL)
+		{
+			printf("Cannot load binary input file %s\t :: is the path correct? Does the file exist in that path?\n", filename);
+			exit(1);
+		}
+		fseek(in, 0, SEEK_END);
+		bi->length  = ftell(in);
+		fseek(in, 0, SEEK_SET);
+		bi->base    = malloc(bi->length > 0 ? bi->length : 1);
+		if (fread(bi->base, 1, bi->length, in) != bi->length) bi->length = 0;
+		fclose(in);
+	}
+
+	if (bi->length < BI_HEADER_SIZE)
+	{
+		printf("ERROR: binary input file %s is incomplete\n", filename);
+		exit(1);
+	}
+	memcpy(&bi->head, bi->base, sizeof(BI_header));
+	BI_header *h = &bi->head;
+	if (strcmp(h->magic, "MSCSFBI") != 0 || h->version != BI_VERSION || h->type < BI_INT32 || h->type > BI_FLOAT64 || h->components < 1 || h->count < 0)
+	{
+		printf("ERROR: %s is not a valid binary input file (or is from a different version)\n", filename);
+		exit(1);
+	}
+	int64_t bytes = h->count*h->components*bi_type_size(h->type);
+	if (h->data_offset < BI_HEADER_SIZE || (int64_t)bi->length < h->data_offset + bytes)
+	{
+		printf("ERROR: binary input file %s is incomplete\n", filename);
+		exit(1);
+	}
+	bi->data = (const unsigned char*)bi->base + h->data_offset;
+	if (bi_checksum(bi->data, bytes) != h->checksum)
+	{
+		printf("ERROR: checksum of binary input file %s does not match; file is corrupt\n", filename);
+		exit(1);
+	}
+}
+
+static void bi_close(Binary_input *bi)
+{
+#ifndef _WIN32
+	if (bi->mapped == true) { munmap(bi->base, bi->length); return; }
+#endif
+	free(bi->base);
+}
+
+// i-th value (entry*components + component)
+static inline double bi_value(const Binary_input *bi, int64_t i)
+{
+	if (bi->head.type == BI_INT32)      return ((const int32_t*)bi->data)[i];
+	if (bi->head.type == BI_FLOAT32)    return ((const float*)bi->data)[i];
+	return ((const double*)bi->data)[i];
+}
+
+// Dimensions (and number of cells for cell indexing) must match the tissue
+static void bi_check_size(const Binary_input *bi, SC_variables sc, int components)
+{
+	const BI_header *h = &bi->head;
+	if (h->NX != sc.NX || h->NY != sc.NY || h->NZ != sc.NZ)
+	{
+		printf("ERROR: binary input file %s is %d * %d * %d; tissue is %d * %d * %d\n", bi->filename, h->NX, h->NY, h->NZ, sc.NX, sc.NY, sc.NZ);
+		exit(1);
+	}
+	if (h->indexing == BI_BOX && h->count != (int64_t)sc.NX*sc.NY*sc.NZ)
+	{
+		printf("ERROR: binary input file %s has %lld entries; box indexing requires NX*NY*NZ = %lld\n", bi->filename, (long long)h->count, (long long)sc.NX*sc.NY*sc.NZ);
+		exit(1);
+	}
+	if (h->indexing == BI_CELL && h->count != sc.N)
+	{
+		printf("ERROR: binary input file %s has %lld entries; cell indexing requires Ncells = %d (was it converted with the same geometry?)\n", bi->filename, (long long)h->count, sc.N);
+		exit(1);
+	}
+	if (h->components != components)
+	{
+		printf("ERROR: binary input file %s has %d values per entry; %d required here\n", bi->filename, h->components, components);
+		exit(1);
+	}
+}
+
+// First 1D cell ref of each z-slice (start[NZ] = Ncells) || cells are numbered in box order
+static int * bi_slice_start(SC_variables sc)
+{
+	int *start      = (int*)malloc((sc.NZ+1)*sizeof(int));
+
+	#pragma omp parallel for schedule(static)
+	for (int k = 0; k < sc.NZ; k++)
+	{
+		int n = 0;
+		for (int idx = k*sc.NX*sc.NY; idx < (k+1)*sc.NX*sc.NY; idx++) if (SC_geo(&sc, idx) > 0) n++;
+		start[k+1] = n;
+	}
+	start[0] = 0;
+	for (int k = 0; k < sc.NZ; k++) start[k+1] += start[k];
+	return start;
+}
+// End Internal =================================================================================//|
+
+// Reading ======================================================================================\\|
+// Is this a binary input file? (text files are read by the original readers)
+bool binary_input_check(const char *filename)
+{
+	char magic[8];
+	FILE *in = fopen(filename, "rb");
+	if (in == NULL) return false;
+	bool binary = (fread(magic, 1, 8, in) == 8 && memcmp(magic, "MSCSFBI", 8) == 0);
+	fclose(in);
+	return binary;
+}
+
+// Geometry (box indexed only); returns Ncells
+int binary_input_read_geo(const char *filename, SC_variables *sc)
+{
+	Binary_input bi;
+	bi_open(&bi, filename);
+	if (bi.head.indexing != BI_BOX || bi.head.type != BI_INT32)
+	{
+		printf("ERROR: binary geometry file %s must be integer and box indexed (convert_inputs Type geo)\n", filename);
+		exit(1);
+	}
+	if (bi.head.NX != sc->NX || bi.head.NY != sc->NY || bi.head.NZ != sc->NZ || bi.head.count != (int64_t)sc->NX*sc->NY*sc->NZ || bi.head.components != 1)
+	{
+		printf("ERROR: binary geometry file %s is %d * %d * %d; tissue is %d * %d * %d\n", filename, bi.head.NX, bi.head.NY, bi.head.NZ, sc->NX, sc->NY, sc->NZ);
+		exit(1);
+	}
+
+	// Bricks holding tissue are found in parallel, allocated in brick order, then filled in parallel
+	const int32_t *values = (const int32_t*)bi.data;
+	int Nb = sc->BX*sc->BY*sc->BZ;
+	char *occupied = (char*)calloc(Nb, 1);
+	#pragma omp parallel for schedule(dynamic, 16)
+	for (int b = 0; b < Nb; b++)
+	{
+		int bi0 = SC_BRICK*(b % sc->BX), bj0 = SC_BRICK*((b / sc->BX) % sc->BY), bk0 = SC_BRICK*(b / (sc->BX*sc->BY));
+		for (int k = bk0; k < bk0+SC_BRICK && k < sc->NZ && !occupied[b]; k++)
+			for (int j = bj0; j < bj0+SC_BRICK && j < sc->NY && !occupied[b]; j++)
+				for (int i = bi0; i < bi0+SC_BRICK && i < sc->NX; i++)
+					if (values[i + (int64_t)sc->NX*(j + (int64_t)sc->NY*k)] > 0) { occupied[b] = 1; break; }
+	}
+	int Noccupied = 0;
+	for (int b = 0; b < Nb; b++) Noccupied += occupied[b];
+	SC_brick_reserve(sc, sc->Nbricks + Noccupied);
+	for (int b = 0; b < Nb; b++) if (occupied[b]) SC_brick_allocate(sc, b);
+	free(occupied);
+
+	int cell_count = 0;
+	#pragma omp parallel for reduction(+:cell_count) schedule(static)
+	for (int k = 0; k < sc->NZ; k++)
+	{
+		for (int idx = k*sc->NX*sc->NY; idx < (k+1)*sc->NX*sc->NY; idx++)
+		{
+			if (values[idx] <= 0) continue;
+			int slot, offset = SC_brick_offset(sc, idx, &slot);
+			sc->brick_geo[slot*SC_BRICK_VOLUME + offset] = values[idx];
+			cell_count++;
+		}
+	}
+	bi_close(&bi);
+	return cell_count;
+}
+
+// Integer map into array of size Ncell (box or cell indexed)
+void binary_input_read_cells_int(const char *filename, SC_variables sc, int *map)
+{
+	Binary_input bi;
+	bi_open(&bi, filename);
+	bi_check_size(&bi, sc, 1);
+
+	if (bi.head.indexing == BI_CELL)
+	{
+		#pragma omp parallel for schedule(static)
+		for (int n = 0; n < sc.N; n++) map[n] = (int)bi_value(&bi, n);
+	}
+	else
+	{
+		int *start = bi_slice_start(sc);
+		#pragma omp parallel for schedule(static)
+		for (int k = 0; k < sc.NZ; k++)
+		{
+			int n = start[k];
+			for (int idx = k*sc.NX*sc.NY; idx < (k+1)*sc.NX*sc.NY; idx++) if (SC_geo(&sc, idx) > 0) map[n++] = (int)bi_value(&bi, idx);
+		}
+		free(start);
+	}
+	bi_close(&bi);
+}
+
+// Map (or components of a vector) into arrays of size Ncell (box or cell indexed)
+void binary_input_read_cells_double(const char *filename, SC_variables sc, double **map, int components)
+{
+	Binary_input bi;
+	bi_open(&bi, filename);
+	bi_check_size(&bi, sc, components);
+
+	if (bi.head.indexing == BI_CELL)
+	{
+		#pragma omp parallel for schedule(static)
+		for (int n = 0; n < sc.N; n++)
+			for (int c = 0; c < components; c++) map[c][n] = bi_value(&bi, (int64_t)n*components + c);
+	}
+	else
+	{
+		int *start = bi_slice_start(sc);
+		#pragma omp parallel for schedule(static)
+		for (int k = 0; k < sc.NZ; k++)
+		{
+			int n = start[k];
+			for (int idx = k*sc.NX*sc.NY; idx < (k+1)*sc.NX*sc.NY; idx++)
+			{
+				if (SC_geo(&sc, idx) <= 0) continue;
+				for (int c = 0; c < components; c++) map[c][n] = bi_value(&bi, (int64_t)idx*components + c);
+				n++;
+			}
+		}
+		free(start);
+	}
+	bi_close(&bi);
+}
+// End Reading ==================================================================================//|
+
+// Conversion ===================================================================================\\|
+// Parses all whitespace separated values of a text file in parallel; returns number of values
+int64_t binary_input_parse_text(const char *filename, double **values)
+{
+	FILE *in = fopen(filename, "rb");
+	if (in == NULL)
+	{
+		printf("Cannot load file %s\t :: is the path correct? Does the file exist in that path?\n", filename);
+		exit(1);
+	}
+	fseek(in, 0, SEEK_END);
+	int64_t length = ftell(in);
+	fseek(in, 0, SEEK_SET);
+	char *text = (char*)malloc(length + 1);
+	if (fread(text, 1, length, in) != (size_t)length)
+	{
+		printf("ERROR: cannot read %s\n", filename);
+		exit(1);
+	}
+	text[length] = '\0';
+	fclose(in);
+
+	// Chunks start at the beginning of a value (or in whitespace), so no value is split
+	int Nchunks = omp_get_max_threads();
+	int64_t *start = (int64_t*)malloc((Nchunks+1)*sizeof(int64_t));
+	int64_t *Nvalues = (int64_t*)calloc(Nchunks+1, sizeof(int64_t));
+	for (int t = 0; t <= Nchunks; t++)
+	{
+		int64_t s = length*t/Nchunks;
+		while (s > 0 && s < length && !isspace((unsigned char)text[s-1])) s++;
+		start[t] = s;
+	}
+	start[Nchunks] = length;
+
+	// Count, then parse into place
+	#pragma omp parallel for schedule(static, 1)
+	for (int t = 0; t < Nchunks; t++)
+	{
+		int64_t n = 0;
+		for (int64_t i = start[t]; i < start[t+1]; i++)
+			if (!isspace((unsigned char)text[i]) && (i == 0 || isspace((unsigned char)text[i-1]))) n++;
+		Nvalues[t+1] = n;
+	}
+	for (int t = 0; t < Nchunks; t++) Nvalues[t+1] += Nvalues[t];
+	int64_t count = Nvalues[Nchunks];
+	*values = (double*)malloc((count > 0 ? count : 1)*sizeof(double));
+
+	bool valid = true;
+	#pragma omp parallel for schedule(static, 1)
+	for (int t = 0; t < Nchunks; t++)
+	{
+		char *p     = text + start[t];
+		char *end   = text + start[t+1];
+		int64_t n   = Nvalues[t];
+		while (p < end)
+		{
+			while (p < end && isspace((unsigned char)*p)) p++;
+			if (p >= end) break;
+			// Each counted token must parse as exactly one number (rejects e.g. "1-2" or "0.5.5")
+			char *next;
+			double v = strtod(p, &next);
+			if (next == p || n == Nvalues[t+1] || (next < end && !isspace((unsigned char)*next))) { valid = false; break; }
+			(*values)[n++] = v;
+			p = next;
+		}
+	}
+	free(text);
+	free(start);
+	free(Nvalues);
+	if (valid == false)
+	{
+		printf("ERROR: %s contains a value that is not a number\n", filename);
+		exit(1);
+	}
+	return count;
+}
+
+void binary_input_write(const char *filename, int type, int components, int indexing, int NX, int NY, int NZ, int64_t count, const double *values, const char *source)
+{
+	int size        = bi_type_size(type);
+	int64_t bytes   = count*components*size;
+	unsigned char *data = (unsigned char*)malloc(bytes > 0 ? bytes : 1);
+
+	#pragma omp parallel for schedule(static)
+	for (int64_t i = 0; i < count*components; i++)
+	{
+		if (type == BI_INT32)           ((int32_t*)data)[i] = (int32_t)values[i];
+		else if (type == BI_FLOAT32)    ((float*)data)[i]   = (float)values[i];
+		else                            ((double*)data)[i]  = values[i];
+	}
+
+	BI_header head;
+	memset(&head, 0, sizeof(BI_header));
+	strcpy(head.magic, "MSCSFBI");
+	head.version        = BI_VERSION;
+	head.type           = type;
+	head.components     = components;
+	head.indexing       = indexing;
+	head.NX             = NX;
+	head.NY             = NY;
+	head.NZ             = NZ;
+	head.count          = count;
+	head.data_offset    = BI_HEADER_SIZE;
+	head.checksum       = bi_checksum(data, bytes);
+	const char *name    = strrchr(source, '/');
+	snprintf(head.source, sizeof(head.source), "%s", name == NULL ? source : name + 1);
+
+	FILE *out = fopen(filename, "wb");
+	if (out == NULL)
+	{
+		printf("ERROR: cannot open %s for writing\n", filename);
+		exit(1);
+	}
+	unsigned char pad[BI_HEADER_SIZE];
+	memset(pad, 0, BI_HEADER_SIZE);
+	memcpy(pad, &head, sizeof(BI_header));
+	fwrite(pad, 1, BI_HEADER_SIZE, out);
+	fwrite(data, 1, bytes, out);
+	if (ferror(out) != 0 || fclose(out) != 0)
+	{
+		printf("ERROR: writing %s failed\n", filename);
+		exit(1);
+	}
+	free(data);
+}
+// End Conversion ===============================================================================//|
@@ -0,0 +1,124 @@
+// Source code associated with  ===========================  //
+// "Multi-scale cardiac simulation framework" =============  //
+// For simulation of cardiac cellular and tissue dynamics =  //
+// from the spatial cellular to full organ scales. ========  //
+// With implementation of multiple, published cell models =  //
+// as well as novel models developed in my lab. ===========  //
+// ========================================================  //
+// This file: Binary geometry, fibre and ==================  //
+// map input files, header ================================  //
+// ========================================================  //
+// GNU 3 LICENSE TEXT =====================================  //
+// COPYRIGHT (C) 2016-2019 MICHAEL A. COLMAN ==============  //
+// THIS PROGRAM IS FREE SOFTWARE: YOU CAN REDISTRIBUTE IT =  //
+// AND/OR MODIFY IT UNDER THE TERMS OF THE GNU GENERAL ====  //
+// PUBLIC LICENSE AS PUBLISHED BY THE FREE SOFTWARE =======  //
+// FOUNDATION, EITHER VERSION 3 OF THE LICENSE, OR (AT YOUR  //
+// OPTION) ANY LATER VERSION. =============================  //
+// THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE=  //
+// USEFUL, BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE =====  //
+// IMPLIED WARRANTY OF MERCHANTABILITY OR FITNESS FOR A ===  //
+// PARTICULAR PURPOSE.  SEE THE GNU GENERAL PUBLIC LICENSE=  //
+// FOR MORE DETAILS. ======================================  //
+// YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL =====  //
+// PUBLIC LICENSE ALONG WITH THIS PROGRAM.  IF NOT, SEE ===  //
+// <https://www.gnu.org/licenses/>. =======================  //
+// ========================================================  //
+// ADDITIONAL LICENSE TEXT ================================  //
+// THIS SOFTWARE IS PROVIDED OPEN SOURCE AND MAY BE FREELY=  //
+// USED, DISTRIBUTED AND UPDATED, PROVIDED: ===============  //
+//  (i) THE APPROPRIATE WORK(S) IS(ARE) CITED. THIS =======  //
+//      PERTAINS TO THE CITATION OF COLMAN 2019 PLOS COMP =  //
+//      BIOL (FOR THIS IMPLEMTATION) AND ALL WORKS ========  //
+//      ASSOCIATED WITH THE SPECIFIC MODELS AND COMPONENTS=  //
+//      USED IN PARTICULAR SIMULATIONS. IT IS THE USER'S ==  //
+//      RESPONSIBILITY TO ENSURE ALL RELEVANT WORKS ARE ===  //
+//      CITED. PLEASE SEE FULL DOCUMENTATION AND ON-SCREEN=  //
+//      DISCLAIMER OUTPUTS FOR A GUIDE. ===================  //
+//  (ii) ALL OF THIS TEXT IS RETAINED WITHIN OR ASSOCIATED=  //
+//      WITH THE SOURCE CODE AND/OR BINARY FORM OF THE ====  //
+//      SOFTWARE. =========================================  //
+// ========================================================  //
+// ANY INTENDED COMMERCIAL USE OF THIS SOFTWARE MUST BE BY   //
+// EXPRESS PERMISSION OF MICHAEL A COLMAN ONLY. IN NO EVENT  //
+// ARE THE COPYRIGHT HOLDERS LIABLE FOR ANY DIRECT, =======  //
+// INDIRECT INCIDENTAL, SPECIAL, EXEMPLARY OR CONSEQUENTIAL  //
+// DAMAGES ASSOCIATED WITH USE OF THIS SOFTWARE ===========  //
+// ========================================================  //
+// THIS SOFTWARE CONTAINS IMPLEMENTATIONS OF MODELS AND ===  //
+// COMPONENTS WHICH I (MICHAEL COLMAN) DID NOT DEVELOP.====  //
+// ALL OF THESE COMPONENTS HAVE BEEN CODED FROM PROVIDED ==  //
+// SOURCE CODE OR INFORMATION IN THE PUBLICATIONS. ========  //
+// I CLAIM NO RIGHTS OR INTELLECTUAL PROPERTY OWNERSHIP ===  //
+// FOR THESE MODELS AND COMPONENTS, OTHER THAN THEIR ======  //
+// SPECIFIC IMPLEMENTATION IN THIS CODE PACKAGE. FURTHER TO  //
+// THE ABOVE STATEMENT, ANY INDTENDED COMMERCIAL USE OF ===  //
+// THOSE COMPONENTS MUST BE BY EXPRESS PERMISSION OF THE ==  //
+// ORIGINAL COPYRIGHT HOLDERS. ============================  //
+// WHERE IMPLEMENTED FROM PROVIDED CODE, ANY DISCLAIMERS ==  //
+// PRESENT IN THE ORIGINAL CODE HAVE BEEN RETAINED IN THE =  //
+// RELEVANT FILE. =========================================  //
+// ========================================================  //
+// Contact: m.a.colman@leeds.ac.uk ========================  //
+// For updates, corrections etc, please check: ============  //
+// 1. http://physicsoftheheart.com/ =======================  //
+// 2. https://github.com/michaelcolman ====================  //
+// ========================================================  //
+
+#ifndef BINARY_INPUTS_H
+#define BINARY_INPUTS_H
+
+#include "Structs.h"
+#include <stdio.h>
+#include <stdint.h>
+
+// File layout (native byte order) ==============================================================\\|
+//  Header      (BI_HEADER_SIZE bytes): magic "MSCSFBI", version, value type, components per entry,
+//              indexing, NX, NY, NZ, number of entries, offset of the data, FNV-1a checksum of 
+//              the data, name of the text file it was converted from
+//  Data        count*components values, entry-major (x y z x y z ... for vectors)
+// Indexing:
+//  box         one entry per voxel of the NX*NY*NZ box (x fastest), as the text files
+//  cell        one entry per tissue cell, in 1D cell order (voxels with geo > 0, x fastest);
+//              much smaller for sparse anatomical meshes. Not valid for the geometry itself
+// Files are recognised by the magic, not the extension, so a binary file may replace the text
+// file of the same name or be set as the file name in the tissue model.
+// End File layout ==============================================================================//|
+
+#define BI_VERSION          1
+#define BI_HEADER_SIZE      128
+
+// Value types
+#define BI_INT32            0
+#define BI_FLOAT32          1
+#define BI_FLOAT64          2
+
+// Indexing
+#define BI_BOX              0
+#define BI_CELL             1
+
+typedef struct{
+	char        magic[8];
+	int32_t     version;
+	int32_t     type;
+	int32_t     components;     // values per entry (3 for fibre vectors)
+	int32_t     indexing;
+	int32_t     NX, NY, NZ;
+	int32_t     reserved;
+	int64_t     count;          // entries (NX*NY*NZ or Ncell)
+	int64_t     data_offset;    // bytes from start of file
+	uint64_t    checksum;       // of the data
+	char        source[64];     // text file converted from
+}BI_header;
+
+// Reading (tissue/cell setup)
+bool binary_input_check(const char *filename);
+int  binary_input_read_geo(const char *filename, SC_variables *sc);
+void binary_input_read_cells_int(const char *filename, SC_variables sc, int *map);
+void binary_input_read_cells_double(const char *filename, SC_variables sc, double **map, int components);
+
+// Conversion (Data_convert_inputs_to_binary.cc)
+int64_t binary_input_parse_text(const char *filename, double **values);
+void binary_input_write(const char *filename, int type, int components, int indexing, int NX, int NY, int NZ, int64_t count, const double *values, const char *source);
+
+#endif
@@ -871,7 +871,7 @@ double compute_current_from_flux(Cell_parameters p, double flux, int valence, do
 
 // Dyad fluxes functions ========================================================================\\|
 // comp dyad ======================================================\\|
-void comp_dyad_3D(Cell_parameters p, Dyad_variables *d, double Ca_ds, double Ca_jsr, double Ca_cyto /*to which ds is coupled*/, double *reac_jsr, double Vm, double dt, const char *Model)
+void comp_dyad_3D(Cell_parameters p, Dyad_variables *d, double Ca_ds, double Ca_jsr, double Ca_cyto /*to which ds is coupled*/, double *reac_jsr, double Vm, double dt, int Model_id)
 {
     // RyR model (stochastic) =======\\|
     set_and_update_monomer_state(p, d, 1e-3*Ca_jsr, dt);        	// Ca_jsr in mM || updates and sets monomer rates	
@@ -886,7 +886,7 @@ void comp_dyad_3D(Cell_parameters p, Dyad_variables *d, double Ca_ds, double Ca_
     // End RyR model (stochastic) ===//|
 
     // LTCC model (stochastic) ======\\|
-    set_LTCC_rates(p, d, Ca_ds, Vm, Model);							// Sets transition rates
+    set_LTCC_rates(p, d, Ca_ds, Vm, Model_id);							// Sets transition rates
     comp_LTCC_bar(p, d, Ca_ds, Vm);									// Sets dynamic flux rate
     update_LTCC_stochastic(d, dt);									// Update states, monte-carlo
     d->J_CaL		= d->LTCC_bar * -d->NLTCC_O;					// Flux through LTCC
@@ -894,7 +894,7 @@ void comp_dyad_3D(Cell_parameters p, Dyad_variables *d, double Ca_ds, double Ca_
     // End TCC model (stochastic) ===//|
 }
 
-void comp_dyad_0D(Cell_parameters p, Dyad_variables *d, double Ca_ds, double Ca_jsr, double Ca_cyto /*to which ds is coupled*/, double *reac_jsr, double Vm, double dt, const char *Model)
+void comp_dyad_0D(Cell_parameters p, Dyad_variables *d, double Ca_ds, double Ca_jsr, double Ca_cyto /*to which ds is coupled*/, double *reac_jsr, double Vm, double dt, int Model_id)
 {
     // RyR model (deterministic) ====\\|
     // This definitely needs to be improved in a future model
@@ -931,7 +931,7 @@ void comp_dyad_0D(Cell_parameters p, Dyad_variables *d, double Ca_ds, double Ca_
     // End RyR model ================//|
 
     // LTCC model (det; HH) =========\\|
-    set_LTCC_rates(p, d, Ca_ds, Vm, Model);                         // Sets transition rates
+    set_LTCC_rates(p, d, Ca_ds, Vm, Model_id);                         // Sets transition rates
     comp_LTCC_bar(p, d, Ca_ds, Vm);                                 // Sets dynamic flux rate
     update_gates_LTCC_det(p, d, dt);								// Updates gates
     //printf("%d %f %f %f %f\n", d->NLTCC, d->LTCC_bar, d->ICaL_va_2, d->ICaL_va_1 , d->ICaL_va_0);
@@ -977,7 +977,7 @@ void set_RyR_rates(Cell_parameters p, Dyad_variables *d, double Ca_ds)
 // End RyR functions ==========================//|
 
 // LTCC functions =============================\\|
-void set_LTCC_rates(Cell_parameters p, Dyad_variables *d, double Ca_ds, double Vm, const char * Model)
+void set_LTCC_rates(Cell_parameters p, Dyad_variables *d, double Ca_ds, double Vm, int Model_id)
 {
     // Model similar to the Markovian version of the HH model, presnted by
     // Song et al. Biophys J. 2015 Apr 21;108(8)1908-21.	
@@ -988,10 +988,10 @@ void set_LTCC_rates(Cell_parameters p, Dyad_variables *d, double Ca_ds, double V
     double Vm_inac_tau      = Vm - p.ICaL_vi_tau_shift;   // Voltage modified by shift applied to inactivation time constant
 
     // Voltage activation ===========\\|
-    if (strcmp(Model, "hVM_ORD_s") == 0) 		set_ICaL_hVM_ORD_simple_va_rates(p, &d->ICaL_va_ss, &d->ICaL_va_tau, Vm_ac_ss, Vm_ac_tau, p.ICaL_va_ss_kscale);		
-    else if (strcmp(Model, "hAM_CAZ_s") == 0) 	set_ICaL_hAM_CAZ_simple_va_rates(p, &d->ICaL_va_ss, &d->ICaL_va_tau, Vm_ac_ss, Vm_ac_tau, p.ICaL_va_ss_kscale);
-    else if (strcmp(Model, "dAM_VA") == 0)      set_ICaL_dAM_VA_va_rates(p, &d->ICaL_va_ss, &d->ICaL_va_tau, Vm_ac_ss, Vm_ac_tau, p.ICaL_va_ss_kscale);
-    else if (strcmp(Model, "mCRN") == 0)      set_ICaL_mCRN_va_rates(p, &d->ICaL_va_ss, &d->ICaL_va_tau, Vm_ac_ss, Vm_ac_tau, p.ICaL_va_ss_kscale);
+    if (Model_id == MODEL_HVM_ORD_S) 		set_ICaL_hVM_ORD_simple_va_rates(p, &d->ICaL_va_ss, &d->ICaL_va_tau, Vm_ac_ss, Vm_ac_tau, p.ICaL_va_ss_kscale);		
+    else if (Model_id == MODEL_HAM_CAZ_S) 	set_ICaL_hAM_CAZ_simple_va_rates(p, &d->ICaL_va_ss, &d->ICaL_va_tau, Vm_ac_ss, Vm_ac_tau, p.ICaL_va_ss_kscale);
+    else if (Model_id == MODEL_DAM_VA)      set_ICaL_dAM_VA_va_rates(p, &d->ICaL_va_ss, &d->ICaL_va_tau, Vm_ac_ss, Vm_ac_tau, p.ICaL_va_ss_kscale);
+    else if (Model_id == MODEL_MCRN)      set_ICaL_mCRN_va_rates(p, &d->ICaL_va_ss, &d->ICaL_va_tau, Vm_ac_ss, Vm_ac_tau, p.ICaL_va_ss_kscale);
     else 								 		set_Ip2d_va_rates(p, &d->ICaL_va_ss, &d->ICaL_va_tau, Vm_ac_ss, Vm_ac_tau, p.ICaL_va_ss_kscale);
 
     d->ICaL_va_al_01                = d->ICaL_va_ss/d->ICaL_va_tau;         // Rate from state va0 to va1 (V-dependent)
@@ -1002,9 +1002,9 @@ void set_LTCC_rates(Cell_parameters p, Dyad_variables *d, double Ca_ds, double V
     // End Voltage activation =======//|
 
     // Voltage inactivation =========\\|
-    if (strcmp(Model, "hAM_CAZ_s") == 0) 	set_ICaL_hAM_CAZ_simple_vi_rates(p, &d->ICaL_vi_ss, &d->ICaL_vi_tau, Vm_inac_ss, Vm_inac_tau, p.ICaL_vi_ss_kscale);
-    else if (strcmp(Model, "dAM_VA") == 0)  set_ICaL_dAM_VA_vi_rates(p, &d->ICaL_vi_ss, &d->ICaL_vi_tau, Vm_inac_ss, Vm_inac_tau, p.ICaL_vi_ss_kscale);
-    else if (strcmp(Model, "mCRN") == 0)  set_ICaL_mCRN_vi_rates(p, &d->ICaL_vi_ss, &d->ICaL_vi_tau, Vm_inac_ss, Vm_inac_tau, p.ICaL_vi_ss_kscale);
+    if (Model_id == MODEL_HAM_CAZ_S) 	set_ICaL_hAM_CAZ_simple_vi_rates(p, &d->ICaL_vi_ss, &d->ICaL_vi_tau, Vm_inac_ss, Vm_inac_tau, p.ICaL_vi_ss_kscale);
+    else if (Model_id == MODEL_DAM_VA)  set_ICaL_dAM_VA_vi_rates(p, &d->ICaL_vi_ss, &d->ICaL_vi_tau, Vm_inac_ss, Vm_inac_tau, p.ICaL_vi_ss_kscale);
+    else if (Model_id == MODEL_MCRN)  set_ICaL_mCRN_vi_rates(p, &d->ICaL_vi_ss, &d->ICaL_vi_tau, Vm_inac_ss, Vm_inac_tau, p.ICaL_vi_ss_kscale);
     else                                 	set_Ip2d_vi_rates(p, &d->ICaL_vi_ss, &d->ICaL_vi_tau, Vm_inac_ss, Vm_inac_tau, p.ICaL_vi_ss_kscale);
 
     d->ICaL_vi_al                   = d->ICaL_vi_ss/d->ICaL_vi_tau;
@@ -1014,9 +1014,9 @@ void set_LTCC_rates(Cell_parameters p, Dyad_variables *d, double Ca_ds, double V
     // Ca activation ================\\|
     d->Ca_Ca_bar                    = Ca_ds/p.LTCC_Ca_bar;
     d->ICaL_ci_tau                  = 15; // ms
-    if (strcmp(Model, "hAM_CAZ_s") == 0) 	d->ICaL_ci_tau = 30; // ms
-    if (strcmp(Model, "dAM_VA") == 0)       d->ICaL_ci_tau = 30; // ms
-    //if (strcmp(Model, "mCRN") == 0)       d->ICaL_ci_tau = 30; // ms
+    if (Model_id == MODEL_HAM_CAZ_S) 	d->ICaL_ci_tau = 30; // ms
+    if (Model_id == MODEL_DAM_VA)       d->ICaL_ci_tau = 30; // ms
+    //if (Model_id == MODEL_MCRN)       d->ICaL_ci_tau = 30; // ms
 
     d->ICaL_ci_ss                   = 1/(1 + d->Ca_Ca_bar*d->Ca_Ca_bar);
     d->ICaL_ci_al                   = d->ICaL_ci_ss/d->ICaL_ci_tau;
@@ -1466,7 +1466,7 @@ void run_voltage_clamp_3Dcell(Cell_parameters p, Model_variables *var, State_var
                 comp_J_nsr_jsr(p, Ca->nsr[n], Ca->jsr[n], &Ca->nsr_reac[n], &Ca->jsr_reac[n]);
 
                 // Comp dyad || lib/CRU.cpp -> computes and solves JCaL, Jrel and Cads/jsr fluxes
-                comp_dyad_3D(p, &d[n], Ca->ds[n], Ca->jsr[n], Ca->ss[n] /*to which ds is coupled*/, &Ca->jsr_reac[n], Vm, dt, p.Model);
+                comp_dyad_3D(p, &d[n], Ca->ds[n], Ca->jsr[n], Ca->ss[n] /*to which ds is coupled*/, &Ca->jsr_reac[n], Vm, dt, p.Model_id);
 
                 // Buffering || lib/CRU.cpp
                 comp_buffering(p, &Ca->bcyto[n], &Ca->bss[n], &Ca->bjsr[n], Ca->cyto[n], Ca->ss[n], Ca->jsr[n]);
@@ -1642,7 +1642,7 @@ void run_voltage_clamp_0Dcell(Cell_parameters p, Model_variables *var, State_var
             comp_J_nsr_jsr(p, Ca->NSR, Ca->JSR, &Ca->NSR_reac, &Ca->JSR_reac);
 
             // Comp dyad || lib/CRU.cpp -> computes and solves JCaL, Jrel and Cads/jsr fluxes
-            comp_dyad_0D(p, d, Ca->DS, Ca->JSR, Ca->SS /*to which ds is coupled*/, &Ca->JSR_reac, Vm, dt, p.Model);
+            comp_dyad_0D(p, d, Ca->DS, Ca->JSR, Ca->SS /*to which ds is coupled*/, &Ca->JSR_reac, Vm, dt, p.Model_id);
 
             // Buffering || lib/CRU.cpp
             comp_buffering(p, &Ca->Bcyto, &Ca->Bss, &Ca->Bjsr, Ca->CYTO, Ca->SS, Ca->JSR);
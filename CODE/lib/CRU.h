@@ -125,8 +125,8 @@ double compute_current_from_flux(Cell_parameters p, double flux, int valence, do
 // End whole CRU functions ========================================//|
 
 // Dyad fluxes functions ==========================================\\|
-void comp_dyad_3D(Cell_parameters p, Dyad_variables *d, double Ca_ds, double Ca_jsr, double Ca_cyto /*to which ds is coupled*/, double *reac_jsr, double Vm, double dt, const char *Model);
-void comp_dyad_0D(Cell_parameters p, Dyad_variables *d, double Ca_ds, double Ca_jsr, double Ca_cyto /*to which ds is coupled*/, double *reac_jsr, double Vm, double dt, const char *Model);
+void comp_dyad_3D(Cell_parameters p, Dyad_variables *d, double Ca_ds, double Ca_jsr, double Ca_cyto /*to which ds is coupled*/, double *reac_jsr, double Vm, double dt, int Model_id);
+void comp_dyad_0D(Cell_parameters p, Dyad_variables *d, double Ca_ds, double Ca_jsr, double Ca_cyto /*to which ds is coupled*/, double *reac_jsr, double Vm, double dt, int Model_id);
 
 // RyR
 void set_and_update_monomer_state(Cell_parameters p, Dyad_variables *d, double Ca_jsr, double dt);
@@ -134,7 +134,7 @@ void set_RyR_rates(Cell_parameters p, Dyad_variables *d, double Ca_ds);
 void update_RyR_stochastic(Dyad_variables *d, double dt);
 
 // LTCC
-void set_LTCC_rates(Cell_parameters p, Dyad_variables *d, double Ca_ds, double Vm, const char * Model);
+void set_LTCC_rates(Cell_parameters p, Dyad_variables *d, double Ca_ds, double Vm, int Model_id);
 void comp_LTCC_bar(Cell_parameters p, Dyad_variables *d, double Ca_ds, double Vm);
 void update_gates_LTCC_det(Cell_parameters p, Dyad_variables *d, double dt);
 void update_LTCC_stochastic(Dyad_variables *d, double dt);
@@ -0,0 +1,1162 @@
+// Source code associated with  ===========================  //
+// "Multi-scale cardiac simulation framework" =============  //
+// For simulation of cardiac cellular and tissue dynamics =  //
+// from the spatial cellular to full organ scales. ========  //
+// With implementation of multiple, published cell models =  //
+// as well as novel models developed in my lab. ===========  //
+// ========================================================  //
+// This file: Binary checkpoint/restart of ================  //
+// full simulation state ==================================  //
+// ========================================================  //
+// GNU 3 LICENSE TEXT =====================================  //
+// COPYRIGHT (C) 2016-2019 MICHAEL A. COLMAN ==============  //
+// THIS PROGRAM IS FREE SOFTWARE: YOU CAN REDISTRIBUTE IT =  //
+// AND/OR MODIFY IT UNDER THE TERMS OF THE GNU GENERAL ====  //
+// PUBLIC LICENSE AS PUBLISHED BY THE FREE SOFTWARE =======  //
+// FOUNDATION, EITHER VERSION 3 OF THE LICENSE, OR (AT YOUR  //
+// OPTION) ANY LATER VERSION. =============================  //
+// THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE=  //
+// USEFUL, BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE =====  //
+// IMPLIED WARRANTY OF MERCHANTABILITY OR FITNESS FOR A ===  //
+// PARTICULAR PURPOSE.  SEE THE GNU GENERAL PUBLIC LICENSE=  //
+// FOR MORE DETAILS. ======================================  //
+// YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL =====  //
+// PUBLIC LICENSE ALONG WITH THIS PROGRAM.  IF NOT, SEE ===  //
+// <https://www.gnu.org/licenses/>. =======================  //
+// ========================================================  //
+// ADDITIONAL LICENSE TEXT ================================  //
+// THIS SOFTWARE IS PROVIDED OPEN SOURCE AND MAY BE FREELY=  //
+// USED, DISTRIBUTED AND UPDATED, PROVIDED: ===============  //
+//  (i) THE APPROPRIATE WORK(S) IS(ARE) CITED. THIS =======  //
+//      PERTAINS TO THE CITATION OF COLMAN 2019 PLOS COMP =  //
+//      BIOL (FOR THIS IMPLEMTATION) AND ALL WORKS ========  //
+//      ASSOCIATED WITH THE SPECIFIC MODELS AND COMPONENTS=  //
+//      USED IN PARTICULAR SIMULATIONS. IT IS THE USER'S ==  //
+//      RESPONSIBILITY TO ENSURE ALL RELEVANT WORKS ARE ===  //
+//      CITED. PLEASE SEE FULL DOCUMENTATION AND ON-SCREEN=  //
+//      DISCLAIMER OUTPUTS FOR A GUIDE. ===================  //
+//  (ii) ALL OF THIS TEXT IS RETAINED WITHIN OR ASSOCIATED=  //
+//      WITH THE SOURCE CODE AND/OR BINARY FORM OF THE ====  //
+//      SOFTWARE. =========================================  //
+// ========================================================  //
+// ANY INTENDED COMMERCIAL USE OF THIS SOFTWARE MUST BE BY   //
+// EXPRESS PERMISSION OF MICHAEL A COLMAN ONLY. IN NO EVENT  //
+// ARE THE COPYRIGHT HOLDERS LIABLE FOR ANY DIRECT, =======  //
+// INDIRECT INCIDENTAL, SPECIAL, EXEMPLARY OR CONSEQUENTIAL  //
+// DAMAGES ASSOCIATED WITH USE OF THIS SOFTWARE ===========  //
+// ========================================================  //
+// THIS SOFTWARE CONTAINS IMPLEMENTATIONS OF MODELS AND ===  //
+// COMPONENTS WHICH I (MICHAEL COLMAN) DID NOT DEVELOP.====  //
+// ALL OF THESE COMPONENTS HAVE BEEN CODED FROM PROVIDED ==  //
+// SOURCE CODE OR INFORMATION IN THE PUBLICATIONS. ========  //
+// I CLAIM NO RIGHTS OR INTELLECTUAL PROPERTY OWNERSHIP ===  //
+// FOR THESE MODELS AND COMPONENTS, OTHER THAN THEIR ======  //
+// SPECIFIC IMPLEMENTATION IN THIS CODE PACKAGE. FURTHER TO  //
+// THE ABOVE STATEMENT, ANY INDTENDED COMMERCIAL USE OF ===  //
+// THOSE COMPONENTS MUST BE BY EXPRESS PERMISSION OF THE ==  //
+// ORIGINAL COPYRIGHT HOLDERS. ============================  //
+// WHERE IMPLEMENTED FROM PROVIDED CODE, ANY DISCLAIMERS ==  //
+// PRESENT IN THE ORIGINAL CODE HAVE BEEN RETAINED IN THE =  //
+// RELEVANT FILE. =========================================  //
+// ========================================================  //
+// Contact: m.a.colman@leeds.ac.uk ========================  //
+// For updates, corrections etc, please check: ============  //
+// 1. http://physicsoftheheart.com/ =======================  //
+// 2. https://github.com/michaelcolman ====================  //
+// ========================================================  //
+
+#include "Checkpoint.h"
+#include "Structs.h"
+#include "myofilament.hpp"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <sys/time.h>
+#ifndef _WIN32
+#include <unistd.h>
+#else
+#include <io.h>
+#include <fcntl.h>
+#endif
+#ifdef MSCSF_ZLIB
+#include <zlib.h>
+#endif
+
+// Function list ================================================================================\\|
+//	Setup
+//	    checkpoint_init()
+//	    checkpoint_add()
+//	    checkpoint_add_Ca()
+//	    checkpoint_add_Ca_spatial()
+//	    checkpoint_add_dyads()
+//	    checkpoint_add_SRF()
+//	    checkpoint_add_rand()
+//	    checkpoint_add_myofilament()
+//
+//	Writing and reading
+//	    checkpoint_due()
+//	    checkpoint_write()
+//	    checkpoint_read()
+//	    checkpoint_finalise()
+//
+//	Resuming outputs
+//	    checkpoint_restart_outcount()
+//	    checkpoint_resume_output()
+//
+//	Internal
+//	    ck_wtime()
+//	    ck_checksum()
+//	    ck_chunk_checksums()
+//	    ck_add_section()
+//	    ck_element_bytes()
+//	    ck_pack_element()
+//	    ck_unpack_element()
+//	    ck_pack_section()
+//	    ck_unpack_section()
+//	    ck_rle_encode()
+//	    ck_rle_decode()
+//	    ck_encode_chunk()
+//	    ck_decode_chunk()
+//	    ck_basename()
+//	    ck_resolve_name()
+//	    ck_truncate()
+//	    ck_write_section()
+//	    ck_read_file()
+// End Function list ============================================================================//|
+
+#define CK_VERSION          2
+#define CK_RECORD_SIZE      48  // name(16) kind(4) count(4) bytes(8) chunk bytes(8) Nchunks(4) delta(4)
+#define CK_CHUNK_RECORD     16  // checksum(4) encoding(4) stored bytes(8)
+#define CK_CHUNK_BOUND      (CK_CHUNK_BYTES + CK_CHUNK_BYTES/128 + 64)  // worst case encoded chunk (rle and zlib)
+#define CK_MAX_CHAIN        10000
+
+// Internal =====================================================================================\\|
+static double ck_wtime()
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + 1e-6*tv.tv_usec;
+}
+
+// FNV-1a checksum
+static uint32_t ck_checksum(const unsigned char *data, size_t n)
+{
+	uint32_t h = 2166136261u;
+	for (size_t i = 0; i < n; i++) { h ^= data[i]; h *= 16777619u; }
+	return h;
+}
+
+// One checksum per CK_CHUNK_BYTES, computed in parallel
+static void ck_chunk_checksums(const unsigned char *data, int64_t bytes, uint32_t *sum, int Nchunks)
+{
+#pragma omp parallel for schedule(dynamic) default(none) shared(data, bytes, sum, Nchunks)
+	for (int c = 0; c < Nchunks; c++)
+	{
+		int64_t start = (int64_t)c*CK_CHUNK_BYTES;
+		int64_t n     = bytes - start < CK_CHUNK_BYTES ? bytes - start : CK_CHUNK_BYTES;
+		sum[c] = ck_checksum(data + start, (size_t)n);
+	}
+}
+
+static Checkpoint_section *ck_add_section(Checkpoint *ck, const char *name, int kind, void *data, size_t size, int count)
+{
+	if (ck->Nsections >= CK_MAX_SECTIONS)
+	{
+		printf("ERROR: too many checkpoint sections (max %d)\n", CK_MAX_SECTIONS);
+		exit(1);
+	}
+	if (strlen(name) >= CK_NAME_LENGTH)
+	{
+		printf("ERROR: checkpoint section name \"%s\" is too long (max %d characters)\n", name, CK_NAME_LENGTH - 1);
+		exit(1);
+	}
+	Checkpoint_section *s = &ck->section[ck->Nsections];
+	memset(s, 0, sizeof(Checkpoint_section));
+	strcpy(s->name, name);
+	s->kind     = kind;
+	s->data     = data;
+	s->size     = size;
+	s->count    = count;
+	ck->Nsections++;
+	return s;
+}
+
+// Packed size of element i (kinds other than CK_POD)
+static int64_t ck_element_bytes(Checkpoint_section *s, int i)
+{
+	if (s->kind == CK_DYAD_ARRAYS)
+	{
+		Dyad_variables *d = &((Dyad_variables*)s->data)[i];
+		return sizeof(Dyad_variables) + (int64_t)d->NRyR*(sizeof(double) + sizeof(int)) + (int64_t)d->NLTCC*(sizeof(double) + 3*sizeof(int));
+	}
+	if (s->kind == CK_RAND)     return MTRand::SAVE*sizeof(MTRand::uint32) + sizeof(double);
+	if (s->kind == CK_MYOFIL)   return ((Myofilament*)s->data)[i].checkpoint_bytes();
+	return s->size;
+}
+
+static void ck_pack_element(Checkpoint_section *s, int i, unsigned char *buffer)
+{
+	if (s->kind == CK_DYAD_ARRAYS)
+	{
+		Dyad_variables *d = &((Dyad_variables*)s->data)[i];
+		memcpy(buffer, d, sizeof(Dyad_variables));                  buffer += sizeof(Dyad_variables);
+		memcpy(buffer, d->rand_RyR, d->NRyR*sizeof(double));        buffer += d->NRyR*sizeof(double);
+		memcpy(buffer, d->RyR_state, d->NRyR*sizeof(int));          buffer += d->NRyR*sizeof(int);
+		memcpy(buffer, d->rand_LTCC, d->NLTCC*sizeof(double));      buffer += d->NLTCC*sizeof(double);
+		memcpy(buffer, d->LTCC_va_state, d->NLTCC*sizeof(int));     buffer += d->NLTCC*sizeof(int);
+		memcpy(buffer, d->LTCC_vi_state, d->NLTCC*sizeof(int));     buffer += d->NLTCC*sizeof(int);
+		memcpy(buffer, d->LTCC_ci_state, d->NLTCC*sizeof(int));
+	}
+	else if (s->kind == CK_RAND)
+	{
+		RAND *r = &((RAND*)s->data)[i];
+		MTRand::uint32 state[MTRand::SAVE];
+		r->mtrand1.save(state);
+		memcpy(buffer, state, sizeof(state));
+		memcpy(buffer + sizeof(state), &r->rand, sizeof(double));
+	}
+	else if (s->kind == CK_MYOFIL) ((Myofilament*)s->data)[i].checkpoint_pack(buffer);
+	else memcpy(buffer, (unsigned char*)s->data + (size_t)i*s->size, s->size);
+}
+
+static void ck_unpack_element(Checkpoint_section *s, int i, const unsigned char *buffer)
+{
+	if (s->kind == CK_CA)
+	{
+		// Keep the local arrays of this simulation
+		Ca_variables *c = &((Ca_variables*)s->data)[i];
+		Ca_variables keep = *c;
+		memcpy(c, buffer, sizeof(Ca_variables));
+		c->ds       = keep.ds;          c->ss       = keep.ss;          c->cyto     = keep.cyto;
+		c->jsr      = keep.jsr;         c->nsr      = keep.nsr;
+		c->ss_reac  = keep.ss_reac;     c->cyto_reac = keep.cyto_reac;  c->jsr_reac = keep.jsr_reac;    c->nsr_reac = keep.nsr_reac;
+		c->bcyto    = keep.bcyto;       c->bss      = keep.bss;         c->bjsr     = keep.bjsr;
+	}
+	else if (s->kind == CK_DYAD || s->kind == CK_DYAD_ARRAYS)
+	{
+		Dyad_variables *d = &((Dyad_variables*)s->data)[i];
+		Dyad_variables keep = *d;
+		memcpy(d, buffer, sizeof(Dyad_variables));  buffer += sizeof(Dyad_variables);
+		d->rand_RyR         = keep.rand_RyR;        d->RyR_state        = keep.RyR_state;
+		d->rand_LTCC        = keep.rand_LTCC;       d->LTCC_va_state    = keep.LTCC_va_state;
+		d->LTCC_vi_state    = keep.LTCC_vi_state;   d->LTCC_ci_state    = keep.LTCC_ci_state;
+		if (s->kind == CK_DYAD) return;
+
+		// Channel numbers may differ from this setup (random heterogeneity); re-allocate to the stored sizes
+		if (d->NRyR != keep.NRyR)
+		{
+			delete [] d->rand_RyR;      delete [] d->RyR_state;
+			d->rand_RyR         = new double [d->NRyR];
+			d->RyR_state        = new int [d->NRyR];
+		}
+		if (d->NLTCC != keep.NLTCC)
+		{
+			delete [] d->rand_LTCC;     delete [] d->LTCC_va_state;     delete [] d->LTCC_vi_state;     delete [] d->LTCC_ci_state;
+			d->rand_LTCC        = new double [d->NLTCC];
+			d->LTCC_va_state    = new int [d->NLTCC];
+			d->LTCC_vi_state    = new int [d->NLTCC];
+			d->LTCC_ci_state    = new int [d->NLTCC];
+		}
+		memcpy(d->rand_RyR, buffer, d->NRyR*sizeof(double));        buffer += d->NRyR*sizeof(double);
+		memcpy(d->RyR_state, buffer, d->NRyR*sizeof(int));          buffer += d->NRyR*sizeof(int);
+		memcpy(d->rand_LTCC, buffer, d->NLTCC*sizeof(double));      buffer += d->NLTCC*sizeof(double);
+		memcpy(d->LTCC_va_state, buffer, d->NLTCC*sizeof(int));     buffer += d->NLTCC*sizeof(int);
+		memcpy(d->LTCC_vi_state, buffer, d->NLTCC*sizeof(int));     buffer += d->NLTCC*sizeof(int);
+		memcpy(d->LTCC_ci_state, buffer, d->NLTCC*sizeof(int));
+	}
+	else if (s->kind == CK_SRF)
+	{
+		// Keep the setting strings (and their identifiers) of this simulation
+		Spontaneous_release_functions *srf = &((Spontaneous_release_functions*)s->data)[i];
+		Spontaneous_release_functions keep = *srf;
+		memcpy(srf, buffer, sizeof(Spontaneous_release_functions));
+		srf->Mode = keep.Mode;  srf->Model = keep.Model;    srf->Pset = keep.Pset;
+		srf->Mode_id = keep.Mode_id;    srf->Model_id = keep.Model_id;
+		srf->SRF_het = keep.SRF_het;    srf->write_SRF_settings = keep.write_SRF_settings;
+	}
+	else if (s->kind == CK_RAND)
+	{
+		RAND *r = &((RAND*)s->data)[i];
+		MTRand::uint32 state[MTRand::SAVE];
+		memcpy(state, buffer, sizeof(state));
+		memcpy(&r->rand, buffer + sizeof(state), sizeof(double));
+		r->mtrand1.load(state);
+	}
+	else if (s->kind == CK_MYOFIL) ((Myofilament*)s->data)[i].checkpoint_unpack(buffer);
+}
+
+// Packs a section into its buffer: element offset table followed by the elements (in parallel)
+static void ck_pack_section(Checkpoint_section *s)
+{
+	if (s->kind == CK_POD)
+	{
+		s->bytes = (int64_t)s->size*s->count;   // written directly from memory
+		return;
+	}
+
+	int64_t *offset = new int64_t [s->count + 1];
+	offset[0] = (int64_t)(s->count + 1)*sizeof(int64_t);
+#pragma omp parallel for default(none) shared(s, offset)
+	for (int i = 0; i < s->count; i++) offset[i+1] = ck_element_bytes(s, i);
+	for (int i = 0; i < s->count; i++) offset[i+1] += offset[i];
+
+	s->bytes = offset[s->count];
+	if (s->bytes > s->capacity)
+	{
+		free(s->buffer);
+		s->capacity = s->bytes;
+		s->buffer   = (unsigned char*)malloc(s->capacity);
+		if (s->buffer == NULL)
+		{
+			printf("ERROR: cannot allocate %.1f MB for checkpoint section %s\n", s->capacity/1048576.0, s->name);
+			exit(1);
+		}
+	}
+	memcpy(s->buffer, offset, offset[0]);
+
+	unsigned char *buffer = s->buffer;
+#pragma omp parallel for schedule(dynamic, 64) default(none) shared(s, offset, buffer)
+	for (int i = 0; i < s->count; i++) ck_pack_element(s, i, buffer + offset[i]);
+	delete [] offset;
+}
+
+static void ck_unpack_section(Checkpoint_section *s, const unsigned char *buffer, const char *filename)
+{
+	const int64_t *offset = (const int64_t*)buffer;
+	if (offset[0] != (int64_t)(s->count + 1)*sizeof(int64_t) || offset[s->count] != s->bytes)
+	{
+		printf("ERROR: checkpoint section %s in %s is inconsistent\n", s->name, filename);
+		exit(1);
+	}
+#pragma omp parallel for schedule(dynamic, 64) default(none) shared(s, offset, buffer)
+	for (int i = 0; i < s->count; i++) ck_unpack_element(s, i, buffer + offset[i]);
+}
+
+// Zero-run encoding || token b < 128: b+1 literal bytes follow; b >= 128: b-127 zero bytes
+static int64_t ck_rle_encode(const unsigned char *in, int64_t n, unsigned char *out)
+{
+	int64_t i = 0, o = 0;
+	while (i < n)
+	{
+		int64_t j = i;
+		if (in[i] == 0)
+		{
+			while (j < n && in[j] == 0 && j - i < 128) j++;
+			out[o++] = (unsigned char)(127 + (j - i));
+		}
+		else
+		{
+			// literal run ends at a pair of zeros (a single zero is cheaper kept in the literal)
+			while (j < n && j - i < 128 && !(in[j] == 0 && j + 1 < n && in[j+1] == 0)) j++;
+			out[o++] = (unsigned char)(j - i - 1);
+			memcpy(out + o, in + i, j - i);
+			o += j - i;
+		}
+		i = j;
+	}
+	return o;
+}
+
+static bool ck_rle_decode(const unsigned char *in, int64_t nin, unsigned char *out, int64_t n)
+{
+	int64_t i = 0, o = 0;
+	while (i < nin)
+	{
+		int b = in[i++];
+		if (b < 128)
+		{
+			if (o + b + 1 > n || i + b + 1 > nin) return false;
+			memcpy(out + o, in + i, b + 1);
+			i += b + 1;
+			o += b + 1;
+		}
+		else
+		{
+			if (o + b - 127 > n) return false;
+			memset(out + o, 0, b - 127);
+			o += b - 127;
+		}
+	}
+	return (o == n);
+}
+
+// Encodes n bytes of state (XOR with prev if not NULL) into out; returns stored bytes
+// scratch holds CK_CHUNK_BYTES
+static int64_t ck_encode_chunk(const unsigned char *cur, const unsigned char *prev, int64_t n, int compression, unsigned char *scratch, unsigned char *out, int32_t *encoding)
+{
+	int64_t n8 = n/8, stored = n;
+	if (compression != CK_RAW)
+	{
+		// Byte shuffle (and XOR)
+		for (int64_t w = 0; w < n8; w++)
+			for (int b = 0; b < 8; b++)
+				scratch[b*n8 + w] = (prev == NULL) ? cur[w*8 + b] : (unsigned char)(cur[w*8 + b] ^ prev[w*8 + b]);
+		for (int64_t i = 8*n8; i < n; i++) scratch[i] = (prev == NULL) ? cur[i] : (unsigned char)(cur[i] ^ prev[i]);
+
+		if (compression == CK_RLE) stored = ck_rle_encode(scratch, n, out);
+#ifdef MSCSF_ZLIB
+		else
+		{
+			uLongf clen = CK_CHUNK_BOUND;
+			if (compress2(out, &clen, scratch, n, 1) == Z_OK) stored = clen;
+		}
+#endif
+		if (stored < n)
+		{
+			*encoding = compression;
+			return stored;
+		}
+	}
+	// Stored as is (no compression, or chunk did not shrink)
+	*encoding = CK_RAW;
+	if (prev == NULL)   memcpy(out, cur, n);
+	else                for (int64_t i = 0; i < n; i++) out[i] = cur[i] ^ prev[i];
+	return n;
+}
+
+// Decodes a stored chunk into dst (n bytes of state); delta = XOR into dst
+static bool ck_decode_chunk(const unsigned char *in, int64_t nin, int32_t encoding, unsigned char *dst, int64_t n, bool delta, unsigned char *scratch)
+{
+	if (encoding == CK_RAW)
+	{
+		if (nin != n) return false;
+		if (delta == false) memcpy(dst, in, n);
+		else                for (int64_t i = 0; i < n; i++) dst[i] ^= in[i];
+		return true;
+	}
+	if (encoding == CK_RLE)
+	{
+		if (ck_rle_decode(in, nin, scratch, n) == false) return false;
+	}
+	else if (encoding == CK_ZLIB)
+	{
+#ifdef MSCSF_ZLIB
+		uLongf len = n;
+		if (uncompress(scratch, &len, in, nin) != Z_OK || (int64_t)len != n) return false;
+#else
+		printf("ERROR: checkpoint is zlib compressed but code was compiled without zlib (add -DMSCSF_ZLIB -lz; see Makefile)\n");
+		exit(1);
+#endif
+	}
+	else return false;
+
+	// Unshuffle (and XOR)
+	int64_t n8 = n/8;
+	for (int64_t w = 0; w < n8; w++)
+		for (int b = 0; b < 8; b++)
+		{
+			if (delta == false) dst[w*8 + b]  = scratch[b*n8 + w];
+			else                dst[w*8 + b] ^= scratch[b*n8 + w];
+		}
+	for (int64_t i = 8*n8; i < n; i++)
+	{
+		if (delta == false) dst[i]  = scratch[i];
+		else                dst[i] ^= scratch[i];
+	}
+	return true;
+}
+
+static const char *ck_basename(const char *filename)
+{
+	const char *b = filename;
+	for (const char *c = filename; *c != '\0'; c++) if (*c == '/' || *c == '\\') b = c + 1;
+	return b;
+}
+
+// Writes one section (record, chunk table, stored chunks); returns bytes written
+// Full checkpoints without compression are written directly from memory
+// Read_checkpoint "latest" is the checkpoint named in dir/Checkpoint_latest.txt
+static void ck_resolve_name(const char *dir, bool Windows, const char *filename, char *name)
+{
+	if (strcmp(filename, "latest") == 0)
+	{
+		char latest[1100];
+		if (Windows == true)    sprintf(latest, "%s\\Checkpoint_latest.txt", dir);
+		else                    sprintf(latest, "%s/Checkpoint_latest.txt", dir);
+		FILE *lf = fopen(latest, "r");
+		if (lf == NULL || fscanf(lf, "%999[^\n]", name) != 1)
+		{
+			printf("ERROR: Read_checkpoint is \"latest\" but %s cannot be read\n", latest);
+			exit(1);
+		}
+		fclose(lf);
+	}
+	else strncpy(name, filename, 999);
+	name[999] = '\0';
+}
+
+static bool ck_truncate(const char *filename, int64_t bytes)
+{
+#ifndef _WIN32
+	return (truncate(filename, (off_t)bytes) == 0);
+#else
+	int fd = _open(filename, _O_RDWR | _O_BINARY);
+	if (fd < 0) return false;
+	bool ok = (_chsize_s(fd, bytes) == 0);
+	_close(fd);
+	return ok;
+#endif
+}
+
+static int64_t ck_write_section(Checkpoint *ck, Checkpoint_section *s, bool delta, FILE *out)
+{
+	const unsigned char *data = (s->kind == CK_POD) ? (const unsigned char*)s->data : s->buffer;
+	const unsigned char *prev = (delta == true) ? s->previous : NULL;
+	int compression     = (delta == true && ck->compression == CK_RAW) ? CK_RLE : ck->compression;
+	int64_t bytes       = s->bytes;
+	int64_t chunk_bytes = CK_CHUNK_BYTES;
+	int32_t Nchunks     = (int32_t)((bytes + CK_CHUNK_BYTES - 1)/CK_CHUNK_BYTES);
+	int32_t delta_flag  = (delta == true) ? 1 : 0;
+	uint32_t *sum       = new uint32_t [Nchunks > 0 ? Nchunks : 1];
+	int32_t *encoding   = new int32_t [Nchunks > 0 ? Nchunks : 1];
+	int64_t *stored     = new int64_t [Nchunks > 0 ? Nchunks : 1];
+
+	ck_chunk_checksums(data, bytes, sum, Nchunks);
+	if (prev != NULL || compression != CK_RAW)
+	{
+		if ((int64_t)Nchunks*CK_CHUNK_BOUND > ck->work_capacity)
+		{
+			free(ck->work);
+			ck->work_capacity   = (int64_t)Nchunks*CK_CHUNK_BOUND;
+			ck->work            = (unsigned char*)malloc(ck->work_capacity);
+			if (ck->work == NULL)
+			{
+				printf("ERROR: cannot allocate %.1f MB for checkpoint encoding\n", ck->work_capacity/1048576.0);
+				exit(1);
+			}
+		}
+		unsigned char *work = ck->work;
+#pragma omp parallel default(none) shared(data, prev, compression, bytes, Nchunks, encoding, stored, work)
+		{
+			unsigned char *scratch = (unsigned char*)malloc(CK_CHUNK_BYTES);
+#pragma omp for schedule(dynamic)
+			for (int c = 0; c < Nchunks; c++)
+			{
+				int64_t start   = (int64_t)c*CK_CHUNK_BYTES;
+				int64_t n       = bytes - start < CK_CHUNK_BYTES ? bytes - start : CK_CHUNK_BYTES;
+				stored[c]       = ck_encode_chunk(data + start, prev == NULL ? NULL : prev + start, n, compression, scratch, work + (int64_t)c*CK_CHUNK_BOUND, &encoding[c]);
+			}
+			free(scratch);
+		}
+	}
+	else for (int c = 0; c < Nchunks; c++)
+	{
+		encoding[c]     = CK_RAW;
+		stored[c]       = bytes - (int64_t)c*CK_CHUNK_BYTES < CK_CHUNK_BYTES ? bytes - (int64_t)c*CK_CHUNK_BYTES : CK_CHUNK_BYTES;
+	}
+
+	unsigned char r[CK_RECORD_SIZE];
+	int32_t kind = s->kind, count = s->count;
+	memset(r, 0, CK_RECORD_SIZE);
+	memcpy(r, s->name, CK_NAME_LENGTH);
+	memcpy(r + 16, &kind, 4);
+	memcpy(r + 20, &count, 4);
+	memcpy(r + 24, &bytes, 8);
+	memcpy(r + 32, &chunk_bytes, 8);
+	memcpy(r + 40, &Nchunks, 4);
+	memcpy(r + 44, &delta_flag, 4);
+	fwrite(r, 1, CK_RECORD_SIZE, out);
+
+	int64_t total = CK_RECORD_SIZE + (int64_t)Nchunks*CK_CHUNK_RECORD;
+	for (int c = 0; c < Nchunks; c++)
+	{
+		unsigned char t[CK_CHUNK_RECORD];
+		memcpy(t, &sum[c], 4);
+		memcpy(t + 4, &encoding[c], 4);
+		memcpy(t + 8, &stored[c], 8);
+		fwrite(t, 1, CK_CHUNK_RECORD, out);
+	}
+	if (prev != NULL || compression != CK_RAW)
+		for (int c = 0; c < Nchunks; c++) fwrite(ck->work + (int64_t)c*CK_CHUNK_BOUND, 1, stored[c], out);
+	else fwrite(data, 1, bytes, out);
+	for (int c = 0; c < Nchunks; c++) total += stored[c];
+
+	delete [] sum;
+	delete [] encoding;
+	delete [] stored;
+	return total;
+}
+
+// Reads one checkpoint file into the sections; a delta first reads the checkpoint it was written
+// against. Non-POD sections are left packed in their buffers (unpacked by checkpoint_read).
+static void ck_read_file(Checkpoint *ck, const char *name, int depth, bool *found, double *sim_time, int32_t *counters)
+{
+	FILE *in = fopen(name, "rb");
+	if (in == NULL)
+	{
+		printf("ERROR: cannot open checkpoint file %s\n", name);
+		exit(1);
+	}
+
+	// Header
+	unsigned char h[CK_HEADER_SIZE];
+	if (fread(h, 1, CK_HEADER_SIZE, in) != CK_HEADER_SIZE || memcmp(h, "MSCSFCK", 8) != 0)
+	{
+		printf("ERROR: %s is not a checkpoint file\n", name);
+		exit(1);
+	}
+	uint32_t hsum;
+	memcpy(&hsum, h + CK_HEADER_SIZE - 8, 4);
+	if (hsum != ck_checksum(h, CK_HEADER_SIZE - 8))
+	{
+		printf("ERROR: checkpoint header of %s is corrupted (checksum mismatch)\n", name);
+		exit(1);
+	}
+	int32_t version, N, Nsections, delta;
+	char code_version[33], model[33], previous[113];
+	double dt;
+	memcpy(&version, h + 8, 4);
+	memcpy(code_version, h + 16, 32);   code_version[32] = '\0';
+	memcpy(model, h + 48, 32);          model[32] = '\0';
+	memcpy(&N, h + 80, 4);
+	memcpy(&Nsections, h + 84, 4);
+	memcpy(&dt, h + 88, 8);
+	memcpy(sim_time, h + 96, 8);
+	memcpy(counters, h + 104, 16);
+	memcpy(&delta, h + 120, 4);
+	memcpy(previous, h + 128, 112);     previous[112] = '\0';
+
+	if (version != CK_VERSION)
+	{
+		printf("ERROR: checkpoint %s is version %d; this code reads version %d\n", name, version, CK_VERSION);
+		exit(1);
+	}
+	if (strcmp(code_version, ck->code_version) != 0 || strcmp(model, ck->model) != 0 || N != ck->N)
+	{
+		printf("ERROR: checkpoint %s is from %s, model %s, N = %d; this simulation is %s, model %s, N = %d\n", name, code_version, model, N, ck->code_version, ck->model, ck->N);
+		exit(1);
+	}
+	if (dt != ck->dt)
+	{
+		printf("ERROR: checkpoint %s was written with dt = %g ms; this simulation has dt = %g ms\n", name, dt, ck->dt);
+		exit(1);
+	}
+
+	// Previous checkpoint of an incremental set (same directory)
+	if (delta == 1)
+	{
+		if (depth >= CK_MAX_CHAIN)
+		{
+			printf("ERROR: checkpoint %s: chain of incremental checkpoints is too long (circular?)\n", name);
+			exit(1);
+		}
+		char prevname[1200];
+		int dir_length = (int)(ck_basename(name) - name);
+		sprintf(prevname, "%.*s%s", dir_length, name, previous);
+		double prev_time;
+		int32_t prev_counters[4];
+		ck_read_file(ck, prevname, depth + 1, found, &prev_time, prev_counters);
+	}
+
+	// Sections
+	for (int j = 0; j < Nsections; j++)
+	{
+		unsigned char r[CK_RECORD_SIZE];
+		char sname[CK_NAME_LENGTH + 1];
+		int32_t kind, count, Nchunks, sdelta;
+		int64_t bytes, chunk_bytes;
+		if (fread(r, 1, CK_RECORD_SIZE, in) != CK_RECORD_SIZE)
+		{
+			printf("ERROR: checkpoint %s is truncated\n", name);
+			exit(1);
+		}
+		memcpy(sname, r, CK_NAME_LENGTH);   sname[CK_NAME_LENGTH] = '\0';
+		memcpy(&kind, r + 16, 4);
+		memcpy(&count, r + 20, 4);
+		memcpy(&bytes, r + 24, 8);
+		memcpy(&chunk_bytes, r + 32, 8);
+		memcpy(&Nchunks, r + 40, 4);
+		memcpy(&sdelta, r + 44, 4);
+
+		int k;
+		for (k = 0; k < ck->Nsections; k++) if (strcmp(ck->section[k].name, sname) == 0) break;
+		if (k == ck->Nsections)
+		{
+			printf("ERROR: checkpoint %s contains \"%s\", which this simulation does not have (different settings?)\n", name, sname);
+			exit(1);
+		}
+		Checkpoint_section *s = &ck->section[k];
+		if (kind != s->kind || count != s->count || chunk_bytes != CK_CHUNK_BYTES || (kind == CK_POD && bytes != (int64_t)s->size*s->count)
+			|| Nchunks != (int32_t)((bytes + CK_CHUNK_BYTES - 1)/CK_CHUNK_BYTES))
+		{
+			printf("ERROR: checkpoint section \"%s\" in %s does not match this simulation\n", sname, name);
+			exit(1);
+		}
+		if (sdelta == 1 && (found[k] == false || s->bytes != bytes))
+		{
+			printf("ERROR: checkpoint section \"%s\" in %s is a delta but the previous checkpoint does not match\n", sname, name);
+			exit(1);
+		}
+		found[k] = true;
+
+		unsigned char *data;
+		if (kind == CK_POD) data = (unsigned char*)s->data;     // read directly into place
+		else
+		{
+			if (bytes > s->capacity)
+			{
+				free(s->buffer);
+				s->capacity = bytes;
+				s->buffer   = (unsigned char*)malloc(s->capacity);
+				if (s->buffer == NULL)
+				{
+					printf("ERROR: cannot allocate %.1f MB for checkpoint section %s\n", bytes/1048576.0, sname);
+					exit(1);
+				}
+			}
+			data = s->buffer;
+		}
+		s->bytes = bytes;
+
+		// Chunk table
+		uint32_t *sum       = new uint32_t [Nchunks > 0 ? Nchunks : 1];
+		uint32_t *check     = new uint32_t [Nchunks > 0 ? Nchunks : 1];
+		int32_t *encoding   = new int32_t [Nchunks > 0 ? Nchunks : 1];
+		int64_t *position   = new int64_t [Nchunks + 1];
+		bool encoded        = false;
+		position[0] = 0;
+		for (int c = 0; c < Nchunks; c++)
+		{
+			unsigned char t[CK_CHUNK_RECORD];
+			int64_t stored;
+			if (fread(t, 1, CK_CHUNK_RECORD, in) != CK_CHUNK_RECORD)
+			{
+				printf("ERROR: checkpoint %s is truncated (section %s)\n", name, sname);
+				exit(1);
+			}
+			memcpy(&sum[c], t, 4);
+			memcpy(&encoding[c], t + 4, 4);
+			memcpy(&stored, t + 8, 8);
+			if (stored < 0 || stored > CK_CHUNK_BOUND)
+			{
+				printf("ERROR: checkpoint %s is corrupted (section %s, chunk %d)\n", name, sname, c);
+				exit(1);
+			}
+			position[c+1] = position[c] + stored;
+			if (encoding[c] != CK_RAW) encoded = true;
+		}
+
+		if (sdelta == 0 && encoded == false)
+		{
+			// Stored as is: read directly into place
+			if (fread(data, 1, bytes, in) != (size_t)bytes)
+			{
+				printf("ERROR: checkpoint %s is truncated (section %s)\n", name, sname);
+				exit(1);
+			}
+		}
+		else
+		{
+			if (position[Nchunks] > ck->work_capacity)
+			{
+				free(ck->work);
+				ck->work_capacity   = position[Nchunks];
+				ck->work            = (unsigned char*)malloc(ck->work_capacity);
+				if (ck->work == NULL)
+				{
+					printf("ERROR: cannot allocate %.1f MB for checkpoint decoding\n", ck->work_capacity/1048576.0);
+					exit(1);
+				}
+			}
+			if (fread(ck->work, 1, position[Nchunks], in) != (size_t)position[Nchunks])
+			{
+				printf("ERROR: checkpoint %s is truncated (section %s)\n", name, sname);
+				exit(1);
+			}
+			unsigned char *work = ck->work;
+			bool ok = true;
+#pragma omp parallel default(none) shared(work, position, encoding, data, bytes, Nchunks, sdelta, ok)
+			{
+				unsigned char *scratch = (unsigned char*)malloc(CK_CHUNK_BYTES);
+#pragma omp for schedule(dynamic)
+				for (int c = 0; c < Nchunks; c++)
+				{
+					int64_t start   = (int64_t)c*CK_CHUNK_BYTES;
+					int64_t n       = bytes - start < CK_CHUNK_BYTES ? bytes - start : CK_CHUNK_BYTES;
+					if (ck_decode_chunk(work + position[c], position[c+1] - position[c], encoding[c], data + start, n, sdelta == 1, scratch) == false) ok = false;
+				}
+				free(scratch);
+			}
+			if (ok == false)
+			{
+				printf("ERROR: checkpoint %s is corrupted (section %s: cannot decode)\n", name, sname);
+				exit(1);
+			}
+		}
+
+		ck_chunk_checksums(data, bytes, check, Nchunks);
+		for (int c = 0; c < Nchunks; c++) if (check[c] != sum[c])
+		{
+			printf("ERROR: checkpoint %s is corrupted (section %s, chunk %d: checksum mismatch)\n", name, sname, c);
+			exit(1);
+		}
+		delete [] sum;
+		delete [] check;
+		delete [] encoding;
+		delete [] position;
+	}
+	fclose(in);
+}
+// End Internal =================================================================================//|
+
+// Setup ========================================================================================\\|
+// code_version identifies the main (e.g. "tissue_integrated"); a checkpoint can only be read
+// by the same code version, model and number of cells.
+void checkpoint_init(Checkpoint *ck, Simulation_parameters sim, const char *code_version, const char *model, int N, const char *directory)
+{
+	memset(ck, 0, sizeof(Checkpoint));
+	strncpy(ck->code_version, code_version, 31);
+	strncpy(ck->model, model, 31);
+	ck->N       = N;
+	ck->dt      = sim.dt;
+	ck->Windows = sim.Windows;
+	ck->keep    = sim.Checkpoint_keep;
+	ck->deltas  = sim.Checkpoint_deltas;
+	if (strcmp(sim.Checkpoint_compression, "rle") == 0)         ck->compression = CK_RLE;
+	else if (strcmp(sim.Checkpoint_compression, "zlib") == 0)   ck->compression = CK_ZLIB;
+	else                                                        ck->compression = CK_RAW;
+
+	ck->interval_steps = 0;
+	if (sim.Checkpoint_interval > 0)
+	{
+		ck->interval_steps = (int)(sim.Checkpoint_interval/sim.dt + 0.5);
+		if (ck->interval_steps < 1) ck->interval_steps = 1;
+	}
+
+	char * mkdirectory = (char*)malloc(1100);
+	if (sim.Windows == true)    sprintf(ck->dir, "%s\\Checkpoints", directory);
+	else                        sprintf(ck->dir, "%s/Checkpoints", directory);
+	if (ck->interval_steps > 0)
+	{
+		if (sim.Windows == true)    sprintf(mkdirectory, "mkdir %s", ck->dir);
+		else                        sprintf(mkdirectory, "mkdir -p %s", ck->dir);
+		system(mkdirectory);
+		ck->ring = (char (*)[1000])calloc(ck->keep*(1 + ck->deltas), sizeof(*ck->ring));
+		if (ck->deltas > 0) printf("Checkpoints every %d steps (%.2f ms) to %s: full + %d incremental, keeping the latest %d sets (compression %s)\n", ck->interval_steps, ck->interval_steps*sim.dt, ck->dir, ck->deltas, ck->keep, sim.Checkpoint_compression);
+		else                printf("Checkpoints every %d steps (%.2f ms) to %s, keeping the latest %d (compression %s)\n", ck->interval_steps, ck->interval_steps*sim.dt, ck->dir, ck->keep, sim.Checkpoint_compression);
+	}
+	free(mkdirectory);
+
+	ck->start_time      = 0.0;
+	ck->start_iteration = 0;
+}
+
+// Plain arrays (State_variables, Model_variables, Vm, SR_fluxes, Membrane_fluxes etc)
+void checkpoint_add(Checkpoint *ck, const char *name, void *data, size_t size, int count)
+{
+	ck_add_section(ck, name, CK_POD, data, size, count);
+}
+
+// Ca_variables, 0D (one struct per cell; local arrays not allocated)
+void checkpoint_add_Ca(Checkpoint *ck, Ca_variables *ca, int count)
+{
+	ck_add_section(ck, "Ca", CK_CA, ca, sizeof(Ca_variables), count);
+}
+
+// Ca_variables, spatial cell (one struct; local arrays of N CRUs)
+void checkpoint_add_Ca_spatial(Checkpoint *ck, Ca_variables *ca, int N)
+{
+	ck_add_section(ck, "Ca", CK_CA, ca, sizeof(Ca_variables), 1);
+	ck_add_section(ck, "Ca.ds", CK_POD, ca->ds, sizeof(double), N);
+	ck_add_section(ck, "Ca.ss", CK_POD, ca->ss, sizeof(double), N);
+	ck_add_section(ck, "Ca.cyto", CK_POD, ca->cyto, sizeof(double), N);
+	ck_add_section(ck, "Ca.jsr", CK_POD, ca->jsr, sizeof(double), N);
+	ck_add_section(ck, "Ca.nsr", CK_POD, ca->nsr, sizeof(double), N);
+	ck_add_section(ck, "Ca.ss_reac", CK_POD, ca->ss_reac, sizeof(double), N);
+	ck_add_section(ck, "Ca.cyto_reac", CK_POD, ca->cyto_reac, sizeof(double), N);
+	ck_add_section(ck, "Ca.jsr_reac", CK_POD, ca->jsr_reac, sizeof(double), N);
+	ck_add_section(ck, "Ca.nsr_reac", CK_POD, ca->nsr_reac, sizeof(double), N);
+	ck_add_section(ck, "Ca.bcyto", CK_POD, ca->bcyto, sizeof(double), N);
+	ck_add_section(ck, "Ca.bss", CK_POD, ca->bss, sizeof(double), N);
+	ck_add_section(ck, "Ca.bjsr", CK_POD, ca->bjsr, sizeof(double), N);
+}
+
+// Dyads || arrays = true when RyR/LTCC arrays are allocated (stochastic spatial cell)
+void checkpoint_add_dyads(Checkpoint *ck, Dyad_variables *dyad, int count, bool arrays)
+{
+	ck_add_section(ck, "Dyad", arrays == true ? CK_DYAD_ARRAYS : CK_DYAD, dyad, sizeof(Dyad_variables), count);
+}
+
+void checkpoint_add_SRF(Checkpoint *ck, Spontaneous_release_functions *srf, int count)
+{
+	ck_add_section(ck, "SRF", CK_SRF, srf, sizeof(Spontaneous_release_functions), count);
+}
+
+void checkpoint_add_rand(Checkpoint *ck, RAND *rand, int count)
+{
+	ck_add_section(ck, "Rand", CK_RAND, rand, sizeof(RAND), count);
+}
+
+void checkpoint_add_myofilament(Checkpoint *ck, Myofilament *myofil, int count)
+{
+	ck_add_section(ck, "Myofilament", CK_MYOFIL, myofil, sizeof(Myofilament), count);
+}
+// End Setup ====================================================================================//|
+
+// Writing ======================================================================================\\|
+// Periodic checkpoints are taken at the start of a step, so a restart repeats nothing; no 
+// checkpoint is taken at the step a simulation was restarted from.
+bool checkpoint_due(Checkpoint *ck, int iteration_counter)
+{
+	if (ck->loop_start == 0) ck->loop_start = ck->last_write = ck_wtime();
+	if (ck->interval_steps <= 0 || iteration_counter <= ck->start_iteration) return false;
+	return (iteration_counter % ck->interval_steps == 0);
+}
+
+void checkpoint_write(Checkpoint *ck, double sim_time, int iteration_counter, int outcount, int phase_counter, bool CaSR_set)
+{
+	double t0 = ck_wtime();
+	char filename[1000], tmpname[1100];
+	// Named by step, not rounded time: sub-ms intervals must not overwrite the base of a delta chain
+	if (ck->Windows == true)    sprintf(filename, "%s\\Checkpoint_step%d.msck", ck->dir, iteration_counter);
+	else                        sprintf(filename, "%s/Checkpoint_step%d.msck", ck->dir, iteration_counter);
+	sprintf(tmpname, "%s.tmp", filename);
+
+	FILE *out = fopen(tmpname, "wb");
+	if (out == NULL)
+	{
+		printf("ERROR: cannot open checkpoint file %s for writing\n", tmpname);
+		exit(1);
+	}
+
+	// Full checkpoint at the start of each set; deltas against the previous checkpoint otherwise
+	bool delta = (ck->chain > 0);
+
+	// Header
+	unsigned char h[CK_HEADER_SIZE];
+	int32_t version = CK_VERSION, header_size = CK_HEADER_SIZE, N = ck->N, Nsections = ck->Nsections;
+	int32_t counters[4] = {iteration_counter, outcount, phase_counter, CaSR_set == true ? 1 : 0};
+	int32_t delta_flag = (delta == true) ? 1 : 0, compression = ck->compression;
+	memset(h, 0, CK_HEADER_SIZE);
+	memcpy(h, "MSCSFCK", 8);
+	memcpy(h + 8,   &version, 4);
+	memcpy(h + 12,  &header_size, 4);
+	memcpy(h + 16,  ck->code_version, 32);
+	memcpy(h + 48,  ck->model, 32);
+	memcpy(h + 80,  &N, 4);
+	memcpy(h + 84,  &Nsections, 4);
+	memcpy(h + 88,  &ck->dt, 8);
+	memcpy(h + 96,  &sim_time, 8);
+	memcpy(h + 104, counters, 16);
+	memcpy(h + 120, &delta_flag, 4);
+	memcpy(h + 124, &compression, 4);
+	if (delta == true) strncpy((char*)h + 128, ck->previous_name, 111);
+	uint32_t hsum = ck_checksum(h, CK_HEADER_SIZE - 8);
+	memcpy(h + CK_HEADER_SIZE - 8, &hsum, 4);
+	fwrite(h, 1, CK_HEADER_SIZE, out);
+
+	// Sections || a section is a delta only if its packed size is unchanged
+	int64_t total = CK_HEADER_SIZE, state = 0;
+	for (int k = 0; k < ck->Nsections; k++)
+	{
+		Checkpoint_section *s = &ck->section[k];
+		ck_pack_section(s);
+		total += ck_write_section(ck, s, delta == true && s->previous != NULL && s->previous_bytes == s->bytes, out);
+		state += s->bytes;
+
+		// Keep this checkpoint's data for the next delta (packed buffers are swapped, not copied)
+		if (ck->deltas > 0 && ck->chain < ck->deltas)
+		{
+			if (s->kind == CK_POD)
+			{
+				if (s->bytes > s->previous_capacity)
+				{
+					free(s->previous);
+					s->previous_capacity    = s->bytes;
+					s->previous             = (unsigned char*)malloc(s->previous_capacity);
+					if (s->previous == NULL)
+					{
+						printf("ERROR: cannot allocate %.1f MB for checkpoint section %s\n", s->bytes/1048576.0, s->name);
+						exit(1);
+					}
+				}
+				memcpy(s->previous, s->data, s->bytes);
+			}
+			else
+			{
+				unsigned char *b    = s->previous;      s->previous             = s->buffer;    s->buffer   = b;
+				int64_t c           = s->previous_capacity; s->previous_capacity = s->capacity; s->capacity = c;
+			}
+			s->previous_bytes = s->bytes;
+		}
+	}
+
+	if (ferror(out) != 0 || fclose(out) != 0)
+	{
+		printf("ERROR: failed writing checkpoint file %s (disk full?)\n", tmpname);
+		exit(1);
+	}
+	remove(filename);   // rename does not overwrite on all systems
+	if (rename(tmpname, filename) != 0)
+	{
+		printf("ERROR: cannot rename %s to %s\n", tmpname, filename);
+		exit(1);
+	}
+
+	// Pointer to the most recent complete checkpoint
+	char latest[1100];
+	if (ck->Windows == true)    sprintf(latest, "%s\\Checkpoint_latest.txt", ck->dir);
+	else                        sprintf(latest, "%s/Checkpoint_latest.txt", ck->dir);
+	FILE *lf = fopen(latest, "w");
+	if (lf != NULL) { fprintf(lf, "%s\n", filename); fclose(lf); }
+
+	// Rotation || a new set (full checkpoint) removes the set written keep sets ago
+	if (ck->ring != NULL && ck->keep > 0)
+	{
+		char (*set)[1000] = &ck->ring[(ck->Nsets % ck->keep)*(1 + ck->deltas)];
+		if (ck->chain == 0) for (int i = 0; i <= ck->deltas; i++)
+		{
+			if (set[i][0] != '\0' && strcmp(set[i], filename) != 0) remove(set[i]);
+			set[i][0] = '\0';
+		}
+		strcpy(set[ck->chain], filename);
+	}
+	strcpy(ck->previous_name, ck_basename(filename));
+	if (delta == false) ck->Nfull++;
+	ck->chain++;
+	if (ck->chain > ck->deltas)
+	{
+		ck->chain = 0;
+		ck->Nsets++;
+	}
+	ck->Nwritten++;
+
+	// Cost || as a fraction of the time spent stepping since the last checkpoint
+	double t1   = ck_wtime();
+	double t    = t1 - t0;
+	double step = t0 - ck->last_write;
+	ck->write_time  += t;
+	ck->last_write  = t1;
+	ck->state_bytes += state;
+	ck->file_bytes  += total;
+	printf("Checkpoint written: %s (%s, %.1f MB of %.1f MB in %.2f s; %.2f%% of step time)\n", filename, delta == true ? "delta" : "full", total/1048576.0, state/1048576.0, t, step > 0 ? 100.0*t/step : 0.0);
+}
+// End Writing ==================================================================================//|
+
+// Reading ======================================================================================\\|
+// filename "latest" reads the checkpoint named in Checkpoints/Checkpoint_latest.txt of this
+// simulation's output directory. Counters are restored through the pointers (phase_counter may
+// be NULL); the time loop starts from ck->start_time.
+void checkpoint_read(Checkpoint *ck, const char *filename, int *iteration_counter, int *outcount, int *phase_counter, bool *CaSR_set)
+{
+	double t0 = ck_wtime();
+	char name[1000];
+	ck_resolve_name(ck->dir, ck->Windows, filename, name);
+
+	// Base + deltas into the sections, then unpack
+	bool found[CK_MAX_SECTIONS];
+	double sim_time;
+	int32_t counters[4];
+	for (int k = 0; k < ck->Nsections; k++) found[k] = false;
+	ck_read_file(ck, name, 0, found, &sim_time, counters);
+
+	for (int k = 0; k < ck->Nsections; k++)
+	{
+		if (found[k] == false)
+		{
+			printf("ERROR: checkpoint %s does not contain \"%s\" (different settings?)\n", name, ck->section[k].name);
+			exit(1);
+		}
+		if (ck->section[k].kind != CK_POD) ck_unpack_section(&ck->section[k], ck->section[k].buffer, name);
+	}
+
+	ck->start_time          = sim_time;
+	ck->start_iteration     = counters[0];
+	*iteration_counter      = counters[0];
+	*outcount               = counters[1];
+	if (phase_counter != NULL) *phase_counter = counters[2];
+	*CaSR_set               = (counters[3] == 1);
+	printf("Checkpoint read: %s (time = %.2f ms, iteration %d; %.2f s)\n", name, sim_time, counters[0], ck_wtime() - t0);
+}
+// End Reading ==================================================================================//|
+
+// Prints checkpoint summary and frees packing buffers
+void checkpoint_finalise(Checkpoint *ck)
+{
+	if (ck->Nwritten > 0)
+	{
+		double loop = ck_wtime() - ck->loop_start;
+		printf("Checkpoints: %d written (%d full, %d delta), %.1f MB of %.1f MB state, in %.2f s (%.2f%% of time loop)\n", ck->Nwritten, ck->Nfull, ck->Nwritten - ck->Nfull,
+			ck->file_bytes/1048576.0, ck->state_bytes/1048576.0, ck->write_time, loop > 0 ? 100.0*ck->write_time/loop : 0.0);
+	}
+	for (int k = 0; k < ck->Nsections; k++)
+	{
+		free(ck->section[k].buffer);
+		free(ck->section[k].previous);
+		ck->section[k].buffer               = NULL;
+		ck->section[k].capacity             = 0;
+		ck->section[k].previous             = NULL;
+		ck->section[k].previous_capacity    = 0;
+	}
+	free(ck->work);
+	ck->work            = NULL;
+	ck->work_capacity   = 0;
+	free(ck->ring);
+	ck->ring = NULL;
+}
+
+// Resuming outputs =============================================================================\\|
+// Output count of the checkpoint named by Read_checkpoint (header only, before the simulation
+// is set up); -1 if this is not a restart. The full read and its checks follow in checkpoint_read.
+int checkpoint_restart_outcount(Simulation_parameters sim, const char *directory)
+{
+	if (strcmp(sim.Read_checkpoint, "Off") == 0) return -1;
+
+	char dir[1000], name[1000];
+	if (sim.Windows == true)    sprintf(dir, "%s\\Checkpoints", directory);
+	else                        sprintf(dir, "%s/Checkpoints", directory);
+	ck_resolve_name(dir, sim.Windows, sim.Read_checkpoint, name);
+
+	unsigned char h[CK_HEADER_SIZE];
+	uint32_t hsum;
+	FILE *in = fopen(name, "rb");
+	if (in == NULL || fread(h, 1, CK_HEADER_SIZE, in) != CK_HEADER_SIZE || memcmp(h, "MSCSFCK", 8) != 0)
+	{
+		printf("ERROR: cannot read checkpoint header of %s\n", name);
+		exit(1);
+	}
+	fclose(in);
+	memcpy(&hsum, h + CK_HEADER_SIZE - 8, 4);
+	if (hsum != ck_checksum(h, CK_HEADER_SIZE - 8))
+	{
+		printf("ERROR: checkpoint header of %s is corrupted (checksum mismatch)\n", name);
+		exit(1);
+	}
+	int32_t counters[4];
+	memcpy(counters, h + 104, 16);
+	return counters[1];
+}
+
+// Open mode of a text output with one row per output count: truncate (rows < 0, no restart), or
+// keep the first rows lines of the existing file and append after them
+std::ios_base::openmode checkpoint_resume_output(const char *filename, int64_t rows)
+{
+	if (rows < 0) return std::ios::out;
+
+	FILE *in = fopen(filename, "rb");
+	if (in == NULL) 
+	{
+		if (rows > 0) printf("WARNING: %s not found; restarted rows are written to a new file\n", filename);
+		return std::ios::out | std::ios::app;
+	}
+	int64_t n = 0, bytes = 0;
+	int c;
+	while (n < rows && (c = fgetc(in)) != EOF)
+	{
+		bytes++;
+		if (c == '\n') n++;
+	}
+	bool longer = (fgetc(in) != EOF);
+	fclose(in);
+
+	if (n < rows) printf("WARNING: %s has %lld of the %lld rows before the restart point\n", filename, (long long)n, (long long)rows);
+	else if (longer == true && ck_truncate(filename, bytes) == false)
+	{
+		printf("ERROR: cannot truncate %s to the restart point\n", filename);
+		exit(1);
+	}
+	return std::ios::out | std::ios::app;
+}
+// End Resuming outputs =========================================================================//|
@@ -0,0 +1,197 @@
+// Source code associated with  ===========================  //
+// "Multi-scale cardiac simulation framework" =============  //
+// For simulation of cardiac cellular and tissue dynamics =  //
+// from the spatial cellular to full organ scales. ========  //
+// With implementation of multiple, published cell models =  //
+// as well as novel models developed in my lab. ===========  //
+// ========================================================  //
+// This file: Binary checkpoint/restart of ================  //
+// full simulation state, header ==========================  //
+// ========================================================  //
+// GNU 3 LICENSE TEXT =====================================  //
+// COPYRIGHT (C) 2016-2019 MICHAEL A. COLMAN ==============  //
+// THIS PROGRAM IS FREE SOFTWARE: YOU CAN REDISTRIBUTE IT =  //
+// AND/OR MODIFY IT UNDER THE TERMS OF THE GNU GENERAL ====  //
+// PUBLIC LICENSE AS PUBLISHED BY THE FREE SOFTWARE =======  //
+// FOUNDATION, EITHER VERSION 3 OF THE LICENSE, OR (AT YOUR  //
+// OPTION) ANY LATER VERSION. =============================  //
+// THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE=  //
+// USEFUL, BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE =====  //
+// IMPLIED WARRANTY OF MERCHANTABILITY OR FITNESS FOR A ===  //
+// PARTICULAR PURPOSE.  SEE THE GNU GENERAL PUBLIC LICENSE=  //
+// FOR MORE DETAILS. ======================================  //
+// YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL =====  //
+// PUBLIC LICENSE ALONG WITH THIS PROGRAM.  IF NOT, SEE ===  //
+// <https://www.gnu.org/licenses/>. =======================  //
+// ========================================================  //
+// ADDITIONAL LICENSE TEXT ================================  //
+// THIS SOFTWARE IS PROVIDED OPEN SOURCE AND MAY BE FREELY=  //
+// USED, DISTRIBUTED AND UPDATED, PROVIDED: ===============  //
+//  (i) THE APPROPRIATE WORK(S) IS(ARE) CITED. THIS =======  //
+//      PERTAINS TO THE CITATION OF COLMAN 2019 PLOS COMP =  //
+//      BIOL (FOR THIS IMPLEMTATION) AND ALL WORKS ========  //
+//      ASSOCIATED WITH THE SPECIFIC MODELS AND COMPONENTS=  //
+//      USED IN PARTICULAR SIMULATIONS. IT IS THE USER'S ==  //
+//      RESPONSIBILITY TO ENSURE ALL RELEVANT WORKS ARE ===  //
+//      CITED. PLEASE SEE FULL DOCUMENTATION AND ON-SCREEN=  //
+//      DISCLAIMER OUTPUTS FOR A GUIDE. ===================  //
+//  (ii) ALL OF THIS TEXT IS RETAINED WITHIN OR ASSOCIATED=  //
+//      WITH THE SOURCE CODE AND/OR BINARY FORM OF THE ====  //
+//      SOFTWARE. =========================================  //
+// ========================================================  //
+// ANY INTENDED COMMERCIAL USE OF THIS SOFTWARE MUST BE BY   //
+// EXPRESS PERMISSION OF MICHAEL A COLMAN ONLY. IN NO EVENT  //
+// ARE THE COPYRIGHT HOLDERS LIABLE FOR ANY DIRECT, =======  //
+// INDIRECT INCIDENTAL, SPECIAL, EXEMPLARY OR CONSEQUENTIAL  //
+// DAMAGES ASSOCIATED WITH USE OF THIS SOFTWARE ===========  //
+// ========================================================  //
+// THIS SOFTWARE CONTAINS IMPLEMENTATIONS OF MODELS AND ===  //
+// COMPONENTS WHICH I (MICHAEL COLMAN) DID NOT DEVELOP.====  //
+// ALL OF THESE COMPONENTS HAVE BEEN CODED FROM PROVIDED ==  //
+// SOURCE CODE OR INFORMATION IN THE PUBLICATIONS. ========  //
+// I CLAIM NO RIGHTS OR INTELLECTUAL PROPERTY OWNERSHIP ===  //
+// FOR THESE MODELS AND COMPONENTS, OTHER THAN THEIR ======  //
+// SPECIFIC IMPLEMENTATION IN THIS CODE PACKAGE. FURTHER TO  //
+// THE ABOVE STATEMENT, ANY INDTENDED COMMERCIAL USE OF ===  //
+// THOSE COMPONENTS MUST BE BY EXPRESS PERMISSION OF THE ==  //
+// ORIGINAL COPYRIGHT HOLDERS. ============================  //
+// WHERE IMPLEMENTED FROM PROVIDED CODE, ANY DISCLAIMERS ==  //
+// PRESENT IN THE ORIGINAL CODE HAVE BEEN RETAINED IN THE =  //
+// RELEVANT FILE. =========================================  //
+// ========================================================  //
+// Contact: m.a.colman@leeds.ac.uk ========================  //
+// For updates, corrections etc, please check: ============  //
+// 1. http://physicsoftheheart.com/ =======================  //
+// 2. https://github.com/michaelcolman ====================  //
+// ========================================================  //
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "Structs.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <fstream>
+
+class Myofilament;  // lib/myofilament.hpp (not include-guarded, so not included here)
+
+// File layout (native byte order) ==============================================================\\|
+//  Header      (CK_HEADER_SIZE bytes): magic "MSCSFCK", version, code version, model, N, 
+//              number of sections, dt, sim_time, iteration counter, output counter, phase counter,
+//              CaSR_set flag, delta flag, compression, name of the previous checkpoint (deltas);
+//              FNV-1a checksum of the header in the final 8 bytes
+//  Sections    per section: record (name, kind, count, bytes, chunk size, number of chunks, delta),
+//              chunk table (FNV-1a checksum of the state data, encoding, stored bytes), then the
+//              stored chunks
+// POD arrays (State, Variables, Vm, ...) are written directly from memory. Structs holding 
+// pointers (Ca, Dyad, SRF) are written whole; on read the pointers of the running simulation are
+// kept. Dyad arrays, RNG state and the myofilament/LSODA state are packed per element, prefixed
+// by an element offset table so that packing and unpacking run in parallel. Checksums are per
+// chunk and also computed/verified in parallel.
+// Files are written to a temporary name and renamed once complete, so a run killed during a 
+// write never leaves a truncated checkpoint under a valid name. Checkpoint_latest.txt holds the
+// name of the most recent complete checkpoint (Read_checkpoint latest).
+// Incremental checkpoints (Checkpoint_deltas > 0): between full checkpoints, sections are stored
+// as the XOR with the same section of the previous checkpoint, so unchanged bytes are zero. 
+// Chunks are byte-shuffled (byte k of every 8-byte word grouped together, so the near-constant 
+// sign/exponent bytes form long zero runs) and zero-run (rle) or zlib encoded; chunks that do not
+// shrink are stored as they are. Reading a delta first reads the previous checkpoint (recursively 
+// back to the full one) then applies the XOR. Rotation keeps whole sets of full + deltas.
+// Restart of the text outputs: per-ms Results files hold one row per output count, so on restart
+// they are cut back to the restored output count and appended to (checkpoint_resume_output).
+// The output count is read from the checkpoint header before the files are opened.
+// End File layout ==============================================================================//|
+
+#define CK_HEADER_SIZE      256
+#define CK_NAME_LENGTH      16
+#define CK_MAX_SECTIONS     32
+#define CK_CHUNK_BYTES      (1 << 20)
+
+// Section kinds
+#define CK_POD              0   // plain array of count elements of size bytes
+#define CK_CA               1   // Ca_variables structs (pointers kept)
+#define CK_DYAD             2   // Dyad_variables structs, no local arrays (0D; pointers kept)
+#define CK_DYAD_ARRAYS      3   // Dyad_variables structs + RyR/LTCC state and random arrays (3D)
+#define CK_SRF              4   // Spontaneous_release_functions structs (string pointers kept)
+#define CK_RAND             5   // Mersenne twister state + rand
+#define CK_MYOFIL           6   // Myofilament + LSODA integrator state
+
+// Chunk encodings
+#define CK_RAW              0   // stored as is
+#define CK_RLE              1   // byte shuffle + zero-run encoding
+#define CK_ZLIB             2   // byte shuffle + zlib (level 1)
+
+typedef struct{
+	char        name[CK_NAME_LENGTH];
+	int         kind;
+	void        *data;
+	size_t      size;           // bytes per element
+	int         count;          // number of elements
+
+	unsigned char *buffer;      // packed data (kinds other than CK_POD)
+	int64_t     capacity;
+	int64_t     bytes;
+
+	unsigned char *previous;    // data of the previous checkpoint (incremental checkpoints)
+	int64_t     previous_capacity;
+	int64_t     previous_bytes;
+}Checkpoint_section;
+
+typedef struct{
+	char        code_version[32];   // e.g. "tissue_integrated" || checkpoint must be read by the same code
+	char        model[32];
+	int         N;
+	double      dt;
+	bool        Windows;
+
+	// Periodic checkpoints
+	int         interval_steps;     // 0 = off
+	int         keep;               // rotation: number of checkpoints kept
+	char        dir[500];
+	int         deltas;             // incremental checkpoints between full checkpoints
+	int         compression;        // CK_RAW, CK_RLE or CK_ZLIB
+	char        (*ring)[1000];      // filenames of kept checkpoints, keep sets of (1 + deltas)
+	int         chain;              // position in the current set (0 = next is full)
+	int         Nsets;
+	char        previous_name[1000];
+	unsigned char *work;            // encoded chunks
+	int64_t     work_capacity;
+
+	// Cost
+	int         Nwritten;
+	int         Nfull;
+	double      write_time;         // s, total
+	double      loop_start;         // s, wall clock at first step
+	double      last_write;         // s, wall clock at end of last checkpoint
+	double      state_bytes;        // total, all checkpoints
+	double      file_bytes;
+
+	// Restart position (0 unless read from checkpoint)
+	double      start_time;
+	int         start_iteration;
+
+	int         Nsections;
+	Checkpoint_section section[CK_MAX_SECTIONS];
+}Checkpoint;
+
+// Setup
+void checkpoint_init(Checkpoint *ck, Simulation_parameters sim, const char *code_version, const char *model, int N, const char *directory);
+void checkpoint_add(Checkpoint *ck, const char *name, void *data, size_t size, int count);
+void checkpoint_add_Ca(Checkpoint *ck, Ca_variables *ca, int count);
+void checkpoint_add_Ca_spatial(Checkpoint *ck, Ca_variables *ca, int N);
+void checkpoint_add_dyads(Checkpoint *ck, Dyad_variables *dyad, int count, bool arrays);
+void checkpoint_add_SRF(Checkpoint *ck, Spontaneous_release_functions *srf, int count);
+void checkpoint_add_rand(Checkpoint *ck, RAND *rand, int count);
+void checkpoint_add_myofilament(Checkpoint *ck, Myofilament *myofil, int count);
+
+// Writing and reading
+bool checkpoint_due(Checkpoint *ck, int iteration_counter);
+void checkpoint_write(Checkpoint *ck, double sim_time, int iteration_counter, int outcount, int phase_counter, bool CaSR_set);
+void checkpoint_read(Checkpoint *ck, const char *filename, int *iteration_counter, int *outcount, int *phase_counter, bool *CaSR_set);
+void checkpoint_finalise(Checkpoint *ck);
+
+// Resuming outputs
+int checkpoint_restart_outcount(Simulation_parameters sim, const char *directory);
+std::ios_base::openmode checkpoint_resume_output(const char *filename, int64_t rows);
+
+#endif
@@ -0,0 +1,881 @@
+// Source code associated with  ===========================  //
+// "Multi-scale cardiac simulation framework" =============  //
+// For simulation of cardiac cellular and tissue dynamics =  //
+// from the spatial cellular to full organ scales. ========  //
+// With implementation of multiple, published cell models =  //
+// as well as novel models developed in my lab. ===========  //
+// ========================================================  //
+// This file: In-process ensemble of single ===============  //
+// cell simulations ======== ==============================  //
+// ========================================================  //
+// GNU 3 LICENSE TEXT =====================================  //
+// COPYRIGHT (C) 2016-2019 MICHAEL A. COLMAN ==============  //
+// THIS PROGRAM IS FREE SOFTWARE: YOU CAN REDISTRIBUTE IT =  //
+// AND/OR MODIFY IT UNDER THE TERMS OF THE GNU GENERAL ====  //
+// PUBLIC LICENSE AS PUBLISHED BY THE FREE SOFTWARE =======  //
+// FOUNDATION, EITHER VERSION 3 OF THE LICENSE, OR (AT YOUR  //
+// OPTION) ANY LATER VERSION. =============================  //
+// THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE=  //
+// USEFUL, BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE =====  //
+// IMPLIED WARRANTY OF MERCHANTABILITY OR FITNESS FOR A ===  //
+// PARTICULAR PURPOSE.  SEE THE GNU GENERAL PUBLIC LICENSE=  //
+// FOR MORE DETAILS. ======================================  //
+// YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL =====  //
+// PUBLIC LICENSE ALONG WITH THIS PROGRAM.  IF NOT, SEE ===  //
+// <https://www.gnu.org/licenses/>. =======================  //
+// ========================================================  //
+// ADDITIONAL LICENSE TEXT ================================  //
+// THIS SOFTWARE IS PROVIDED OPEN SOURCE AND MAY BE FREELY=  //
+// USED, DISTRIBUTED AND UPDATED, PROVIDED: ===============  //
+//  (i) THE APPROPRIATE WORK(S) IS(ARE) CITED. THIS =======  //
+//      PERTAINS TO THE CITATION OF COLMAN 2019 PLOS COMP =  //
+//      BIOL (FOR THIS IMPLEMTATION) AND ALL WORKS ========  //
+//      ASSOCIATED WITH THE SPECIFIC MODELS AND COMPONENTS=  //
+//      USED IN PARTICULAR SIMULATIONS. IT IS THE USER'S ==  //
+//      RESPONSIBILITY TO ENSURE ALL RELEVANT WORKS ARE ===  //
+//      CITED. PLEASE SEE FULL DOCUMENTATION AND ON-SCREEN=  //
+//      DISCLAIMER OUTPUTS FOR A GUIDE. ===================  //
+//  (ii) ALL OF THIS TEXT IS RETAINED WITHIN OR ASSOCIATED=  //
+//      WITH THE SOURCE CODE AND/OR BINARY FORM OF THE ====  //
+//      SOFTWARE. =========================================  //
+// ========================================================  //
+// ANY INTENDED COMMERCIAL USE OF THIS SOFTWARE MUST BE BY   //
+// EXPRESS PERMISSION OF MICHAEL A COLMAN ONLY. IN NO EVENT  //
+// ARE THE COPYRIGHT HOLDERS LIABLE FOR ANY DIRECT, =======  //
+// INDIRECT INCIDENTAL, SPECIAL, EXEMPLARY OR CONSEQUENTIAL  //
+// DAMAGES ASSOCIATED WITH USE OF THIS SOFTWARE ===========  //
+// ========================================================  //
+// THIS SOFTWARE CONTAINS IMPLEMENTATIONS OF MODELS AND ===  //
+// COMPONENTS WHICH I (MICHAEL COLMAN) DID NOT DEVELOP.====  //
+// ALL OF THESE COMPONENTS HAVE BEEN CODED FROM PROVIDED ==  //
+// SOURCE CODE OR INFORMATION IN THE PUBLICATIONS. ========  //
+// I CLAIM NO RIGHTS OR INTELLECTUAL PROPERTY OWNERSHIP ===  //
+// FOR THESE MODELS AND COMPONENTS, OTHER THAN THEIR ======  //
+// SPECIFIC IMPLEMENTATION IN THIS CODE PACKAGE. FURTHER TO  //
+// THE ABOVE STATEMENT, ANY INDTENDED COMMERCIAL USE OF ===  //
+// THOSE COMPONENTS MUST BE BY EXPRESS PERMISSION OF THE ==  //
+// ORIGINAL COPYRIGHT HOLDERS. ============================  //
+// WHERE IMPLEMENTED FROM PROVIDED CODE, ANY DISCLAIMERS ==  //
+// PRESENT IN THE ORIGINAL CODE HAVE BEEN RETAINED IN THE =  //
+// RELEVANT FILE. =========================================  //
+// ========================================================  //
+// Contact: m.a.colman@leeds.ac.uk ========================  //
+// For updates, corrections etc, please check: ============  //
+// 1. http://physicsoftheheart.com/ =======================  //
+// 2. https://github.com/michaelcolman ====================  //
+// ========================================================  //
+
+#include "Ensemble.h"
+#include "Structs.h"
+#include "Arguments.h"
+#include "Initialisation.h"
+#include "Model.h"
+#include "Read_write_state.h"
+#include "Outputs.h"
+#include "Steady_state.h"
+#include "Periodic_orbit.h"
+#include "Population.h"
+#include "Single_cell.h"
+#include "CRU.h"
+#include "MersenneTwister.h"
+#include "Spontaneous_release_functions.h"
+#include "myofilament.hpp"
+#include <fstream>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace std;
+
+// Function list ================================================================================\\|
+//	ensemble_read_spec()
+//	ensemble_setup()
+//	ensemble_run()
+//	ensemble_write_summary()
+//	ensemble_free()
+//
+//	Internal
+//	    en_wtime()
+//	    en_strdup()
+//	    en_append()
+//	    en_expand()
+//	    en_read_settings_file()
+//	    en_member_directory()
+//	    en_setup_native()
+//	    en_setup_0D()
+//	    en_run_native()
+//	    en_run_0D()
+// End Function list ============================================================================//|
+
+// Notes ========================================================================================\\|
+// Replaces a shell loop over model_single_native or model_single_0D (e.g. Example_scripts/
+// Basic_single_cell_examples/03_APDr_example_single.sh) with a single process. The specification
+// file lists, one per line ('#' starts a comment):
+//  version     native | 0D
+//  base        Arg value Arg value ...         arguments common to all members (may repeat)
+//  grid        Arg v1 v2 ...                   one grid per argument; members are the outer 
+//                                              product of all grids (last grid varies fastest).
+//                                              A value min:step:max is expanded
+//  member      Arg value Arg value ...         one explicit member per line (after the grid)
+//  settings    file1 file2 ...                 settings file templates (as "Settings_file"); 
+//                                              every member is run with each file
+//  seeds       s1 s2 ... | first:last          Mersenne twister seeds (0D); every member with each
+//  traces      On | Off                        Currents.txt and Properties.txt per member
+//  population  N lhs|sobol [seed]              population of models: N sampled members (after the
+//                                              explicit members), lib/Population.cpp
+//  sample      Arg min max [log]               sampled argument of the population (may repeat)
+//  accept      Biomarker min max               acceptance criterion (may repeat): APD90, APD70, 
+//                                              APD50, APD30, RMP, Vmax, Vamp, dvdt_max, CaT_max, 
+//                                              CaT_min, CaT_amp, CaSR_max, CaSR_min
+//  reject_after n                              early rejection from beat n (default 3; 0 = off)
+//  reject_margin x                             clearly out of range: beyond the range by more
+//                                              than x times its width (default 0.5)
+// Arguments of a member are applied in the order settings file, base, command line, member, so
+// member values overwrite the common values.
+// Setup (argument parsing, parameters, initial conditions, Read_state) is serial, as it writes
+// to the members file and reads state files; members then run concurrently, one per thread
+// (OMP_NUM_THREADS). Each member is the time loop of Single_cell_native_main.cc or 
+// Single_cell_0D_main.cc, including Periodic_orbit and Steady_state for native members, with the
+// per-cell setup and time step shared with those mains (lib/Single_cell.cpp), so a member gives
+// the same result as the equivalent separate run. Members writing state need 
+// distinct state references (or BCL/model), as the file name is shared otherwise.
+// Outputs: Ensemble_members.txt (member, arguments), Ensemble_summary.dat (one line per member:
+// member, the columns of Properties_log.txt, beats paced, wall time) and, where traces or 
+// Periodic_orbit/Steady_state logs are written, Member_XXXX/. Where acceptance criteria are given,
+// every member is evaluated; Population_members.dat lists sampled members (values, status, 
+// biomarkers) and Population_accepted.dat the accepted parameter sets.
+// End Notes ====================================================================================//|
+
+// Integrated Ca handling of a 0D member (cf. Single_cell_0D_main.cc)
+struct Ensemble_0D{
+	Ca_variables                    Ca;
+	CRU_variables                   CRU;
+	Dyad_variables                  Dyad;
+	SR_fluxes                       SR;
+	Membrane_fluxes                 MEM;
+	RAND                            Rand;
+	Spontaneous_release_functions   SRF;
+	Myofilament                     myofil;
+	double                          CaSR_IC;
+};
+
+// Internal =====================================================================================\\|
+static double en_wtime()
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + 1e-6*tv.tv_usec;
+}
+
+static char *en_strdup(const char *s)
+{
+	char *d = (char*)malloc(strlen(s) + 1);
+	strcpy(d, s);
+	return d;
+}
+
+static void en_append(char ***list, int *n, const char *s)
+{
+	*list           = (char**)realloc(*list, (*n + 1)*sizeof(char*));
+	(*list)[*n]     = en_strdup(s);
+	(*n)++;
+}
+
+// Appends a value, expanding min:step:max (or min:max, step 1)
+static void en_expand(char ***list, int *n, const char *s)
+{
+	double a, b, c;
+	char extra;
+	int Nread = sscanf(s, "%lf:%lf:%lf%c", &a, &b, &c, &extra);
+	if (Nread == 2 && strchr(s, ':') != NULL) { c = b; b = 1; Nread = 3; }
+	if (Nread != 3 || strchr(s, ':') == NULL)
+	{
+		en_append(list, n, s);
+		return;
+	}
+	if (b <= 0 || c < a)
+	{
+		printf("ERROR: ensemble range \"%s\" must be min:step:max with step > 0 and max >= min\n", s);
+		exit(1);
+	}
+	char value[64];
+	int Nsteps = (int)((c - a)/b + 1e-9);
+	for (int k = 0; k <= Nsteps; k++)
+	{
+		sprintf(value, "%.10g", a + k*b);
+		en_append(list, n, value);
+	}
+}
+
+// Reads the argument list of a settings file (format as call_argument_functions(), lib/Arguments.c)
+static void en_read_settings_file(const char *filename, char ***list, int *n)
+{
+	FILE *in = fopen(filename, "r");
+	if (in == NULL)
+	{
+		printf("ERROR: Settings file \"%s\" could not be found. Is it in this directory?\n", filename);
+		exit(1);
+	}
+	int Narg;
+	char token[500];
+	if (fscanf(in, "%d", &Narg) != 1)
+	{
+		printf("ERROR: Settings file \"%s\" must start with the number of arguments\n", filename);
+		exit(1);
+	}
+	for (int k = 0; k < 2*Narg; k++)
+	{
+		if (fscanf(in, "%499s", token) != 1)
+		{
+			printf("ERROR: Settings file \"%s\" has fewer than %d arguments\n", filename, Narg);
+			exit(1);
+		}
+		en_append(list, n, token);
+	}
+	fclose(in);
+}
+
+static void en_member_directory(char *dir, const char *directory, Simulation_parameters sim, int m)
+{
+	if (sim.Windows == true)    sprintf(dir, "%s\\Member_%04d", directory, m);
+	else                        sprintf(dir, "%s/Member_%04d", directory, m);
+}
+
+static bool en_member_needs_directory(Ensemble *en, Ensemble_member *mb)
+{
+	return en->traces == true || strcmp(mb->Sim.Steady_state, "On") == 0 || strcmp(mb->Sim.Periodic_orbit, "On") == 0;
+}
+
+// Setup of a native member (as Single_cell_native_main.cc) || lib/Single_cell.cpp
+static void en_setup_native(Ensemble_member *mb, Argument_parameters *A, const char *PATH)
+{
+	Cell_parameters *p = &mb->Params;
+	Simulation_parameters *sim = &mb->Sim;
+
+	single_cell_parameters_native(p, &mb->Variables, sim, *A);
+	initial_conditions_native(&mb->State, *p, p->Model);
+	initialise_measurement_variables(&mb->Variables);
+	if (strcmp(sim->Read_state, "On") == 0)
+		Read_state_single_cell_native(&mb->State, *p, sim->BCL, PATH, p->Model, sim->state_reference_read); //lib/Read_write_state.c
+}
+
+// Setup of a 0D member (as Single_cell_0D_main.cc) || lib/Single_cell.cpp
+static void en_setup_0D(Ensemble_member *mb, Argument_parameters *A, const char *PATH)
+{
+	Cell_parameters *p = &mb->Params;
+	Simulation_parameters *sim = &mb->Sim;
+	Ensemble_0D *c = new Ensemble_0D();   // value-initialised: zero before the Myofilament constructor, as LSODA_set() reads dt_myof
+	mb->cell0D = c;
+
+	single_cell_parameters_0D(p, &mb->Variables, &c->CRU, &c->Dyad, &c->SR, &c->MEM, &c->SRF, &c->myofil, sim, *A);
+	c->CaSR_IC = A->CaSR_IC;
+	if (mb->seeded == true) c->Rand.mtrand1.seed(mb->seed);
+
+	single_cell_initial_conditions_0D(*p, &mb->State, &mb->Variables, &c->Ca, &c->Dyad, &c->MEM);
+	if (strcmp(sim->Read_state, "On") == 0)
+	{
+		Read_state_single_cell_integrated_0D(&mb->State, *p, sim->BCL, PATH, p->Model, sim->state_reference_read); //lib/Read_write_state.c
+		assign_CRU_variables_from_state_read(&c->Dyad, &c->Ca, mb->State); // lib/CRU.cpp
+	}
+}
+
+// Runs a native member (time loop of Single_cell_native_main.cc)
+static void en_run_native(Ensemble *en, Ensemble_member *mb, const char *PATH, const char *directory, int m)
+{
+	Simulation_parameters   sim = mb->Sim;
+	Cell_parameters         Params = mb->Params;
+	State_variables         *s = &mb->State;
+	Model_variables         *var = &mb->Variables;
+	double                  Vm, sim_time;
+	int                     iteration_counter = 0;
+	char                    dir[1000], file[1100];
+
+	en_member_directory(dir, directory, sim, m);
+	ofstream out_cu, out_ex;
+	if (en->traces == true)
+	{
+		sprintf(file, "%s/Currents.txt", dir);      out_cu.open(file);
+		sprintf(file, "%s/Properties.txt", dir);    out_ex.open(file);
+	}
+
+	Periodic_orbit Orbit;
+	periodic_orbit_init(&Orbit, sim, sizeof(State_variables)/sizeof(double), dir);
+	if (Orbit.on == true)
+	{
+		periodic_orbit_solve_native(&Orbit, Params, var, s, sim);
+		if (Orbit.converged == true && strcmp(sim.Write_state, "On") == 0)
+			Write_state_single_cell_native(*s, Params, sim.BCL, PATH, Params.Model, sim.state_reference_write); //lib/Read_write_state.c
+	}
+	Steady_state Steady;
+	steady_state_init(&Steady, sim, 1, dir);
+	Vm = s->Vm;
+
+	for (sim_time = 0.0; sim_time <= (float)sim.Total_time; sim_time += sim.dt)
+	{
+		if (steady_state_reached(&Steady, var, s, iteration_counter, sim_time)) break;
+		if (population_abort(&en->pop, var, Vm, iteration_counter, sim_time, &mb->status, mb->failed, mb->biomarker)) break; // lib/Population.cpp
+		compute_Istim(Params, var, sim.Paced_time, sim.S2_time, sim_time, iteration_counter);
+		single_cell_step_native(Params, var, s, Vm, sim_time, sim.dt); // lib/Single_cell.cpp
+		Vm      = s->Vm;
+
+		if (en->traces == true && iteration_counter % var->dtinv == 0)
+		{
+			output_currents(out_cu, sim_time, *var, *s, Vm);
+			output_excitation_properties(out_ex, sim_time, *var, Vm);
+		}
+		iteration_counter ++;
+	}
+	mb->beats = (Steady.converged_beat > 0) ? Steady.converged_beat : sim.NBeats;
+	if (mb->status == POP_ABORTED)  mb->beats   = iteration_counter/var->BCL_int;
+	else if (en->pop.on == true || en->pop.Ncriteria > 0) mb->status = population_evaluate(&en->pop, *var, mb->failed, mb->biomarker); // lib/Population.cpp
+	steady_state_finalise(&Steady);
+	periodic_orbit_free(&Orbit);
+
+	if (strcmp(sim.Write_state, "On") == 0 && Orbit.converged == false)
+		Write_state_single_cell_native(*s, Params, sim.BCL, PATH, Params.Model, sim.state_reference_write); //lib/Read_write_state.c
+}
+
+// Runs a 0D member (time loop of Single_cell_0D_main.cc)
+static void en_run_0D(Ensemble *en, Ensemble_member *mb, const char *PATH, const char *directory, int m)
+{
+	Simulation_parameters   sim = mb->Sim;
+	Cell_parameters         Params = mb->Params;
+	State_variables         *s = &mb->State;
+	Model_variables         *var = &mb->Variables;
+	Ensemble_0D             *c = mb->cell0D;
+	double                  Vm, sim_time;
+	int                     iteration_counter = 0;
+	char                    dir[1000], file[1100];
+
+	en_member_directory(dir, directory, sim, m);
+	ofstream out_cu, out_ex, out_cru;
+	if (en->traces == true)
+	{
+		sprintf(file, "%s/Currents.txt", dir);      out_cu.open(file);
+		sprintf(file, "%s/Properties.txt", dir);    out_ex.open(file);
+		sprintf(file, "%s/CRU.txt", dir);           out_cru.open(file);
+	}
+	Vm = s->Vm;
+
+	for (sim_time = 0.0; sim_time <= (float)sim.Total_time; sim_time += sim.dt)
+	{
+		if (population_abort(&en->pop, var, Vm, iteration_counter, sim_time, &mb->status, mb->failed, mb->biomarker)) break; // lib/Population.cpp
+		if (sim.CaSR_set == false && sim.Delayed_CaSR_IC_on == true && sim_time >= sim.CaSR_IC_delay) 
+		{ c->Ca.NSR = c->Ca.JSR = c->CaSR_IC; sim.CaSR_set = true; }
+
+		compute_Istim(Params, var, sim.Paced_time, sim.S2_time, sim_time, iteration_counter);
+		single_cell_step_0D(Params, var, s, &c->Ca, &c->CRU, &c->Dyad, &c->SR, &c->MEM, &c->Rand, &c->SRF, &c->myofil, Vm, sim_time, sim.dt); // lib/Single_cell.cpp
+		Vm      = s->Vm;
+
+		if (en->traces == true && iteration_counter % var->dtinv == 0)
+		{
+			output_currents(out_cu, sim_time, *var, *s, Vm);
+			output_excitation_properties(out_ex, sim_time, *var, Vm);
+			output_CRU(out_cru, sim_time, c->Ca, c->CRU, Vm);
+		}
+		iteration_counter ++;
+	}
+	mb->beats = sim.NBeats;
+	if (mb->status == POP_ABORTED)  mb->beats   = iteration_counter/var->BCL_int;
+	else if (en->pop.on == true || en->pop.Ncriteria > 0) mb->status = population_evaluate(&en->pop, *var, mb->failed, mb->biomarker); // lib/Population.cpp
+
+	if (strcmp(sim.Write_state, "On") == 0)
+	{
+		assign_state_variables_from_CRU_write(c->Dyad, c->Ca, s); // lib/CRU.cpp
+		Write_state_single_cell_integrated_0D(*s, Params, sim.BCL, PATH, Params.Model, sim.state_reference_write); //lib/Read_write_state.c
+	}
+}
+// End Internal =================================================================================//|
+
+// Reads the specification file; argv = command-line arguments after the ensemble file ==========\\|
+void ensemble_read_spec(Ensemble *en, const char *filename, int argc, char *argv[])
+{
+	memset(en, 0, sizeof(Ensemble));
+	strcpy(en->version, "native");
+	en->traces = false;
+	population_defaults(&en->pop);  // lib/Population.cpp
+	int Npopulation = 0;
+	char pop_method[16] = "lhs";
+	unsigned int pop_seed = 1;
+
+	FILE *in = fopen(filename, "r");
+	if (in == NULL)
+	{
+		printf("ERROR: Ensemble file \"%s\" could not be found. Is it in this directory?\n", filename);
+		exit(1);
+	}
+
+	char *line = (char*)malloc(EN_MAX_LINE);
+	int Nline = 0;
+	while (fgets(line, EN_MAX_LINE, in) != NULL)
+	{
+		Nline++;
+		char *hash = strchr(line, '#');
+		if (hash != NULL) *hash = '\0';
+
+		char *key = strtok(line, " \t\r\n");
+		if (key == NULL) continue;
+		char *token;
+
+		if (strcmp(key, "version") == 0)
+		{
+			token = strtok(NULL, " \t\r\n");
+			if (token == NULL || (strcmp(token, "native") != 0 && strcmp(token, "0D") != 0))
+			{
+				printf("ERROR: %s line %d: version must be \"native\" or \"0D\"\n", filename, Nline);
+				exit(1);
+			}
+			strcpy(en->version, token);
+		}
+		else if (strcmp(key, "base") == 0)
+		{
+			while ((token = strtok(NULL, " \t\r\n")) != NULL) en_append(&en->base, &en->Nbase, token);
+		}
+		else if (strcmp(key, "grid") == 0)
+		{
+			if (en->Ngrids == EN_MAX_GRIDS)
+			{
+				printf("ERROR: %s line %d: at most %d grids\n", filename, Nline, EN_MAX_GRIDS);
+				exit(1);
+			}
+			int g = en->Ngrids;
+			token = strtok(NULL, " \t\r\n");
+			if (token == NULL)
+			{
+				printf("ERROR: %s line %d: grid needs an argument name and values\n", filename, Nline);
+				exit(1);
+			}
+			en->grid_arg[g] = en_strdup(token);
+			while ((token = strtok(NULL, " \t\r\n")) != NULL) en_expand(&en->grid_values[g], &en->Ngrid_values[g], token);
+			if (en->Ngrid_values[g] == 0)
+			{
+				printf("ERROR: %s line %d: grid %s has no values\n", filename, Nline, en->grid_arg[g]);
+				exit(1);
+			}
+			en->Ngrids++;
+		}
+		else if (strcmp(key, "member") == 0)
+		{
+			int e = en->Nexplicit;
+			en->Nexplicit_args  = (int*)realloc(en->Nexplicit_args, (e + 1)*sizeof(int));
+			en->explicit_args   = (char***)realloc(en->explicit_args, (e + 1)*sizeof(char**));
+			en->Nexplicit_args[e] = 0;
+			en->explicit_args[e]  = NULL;
+			while ((token = strtok(NULL, " \t\r\n")) != NULL) en_append(&en->explicit_args[e], &en->Nexplicit_args[e], token);
+			if (en->Nexplicit_args[e] == 0 || en->Nexplicit_args[e]%2 != 0)
+			{
+				printf("ERROR: %s line %d: member needs argument and value pairs\n", filename, Nline);
+				exit(1);
+			}
+			en->Nexplicit++;
+		}
+		else if (strcmp(key, "settings") == 0)
+		{
+			while ((token = strtok(NULL, " \t\r\n")) != NULL) en_append(&en->settings, &en->Nsettings, token);
+		}
+		else if (strcmp(key, "seeds") == 0)
+		{
+			char **values = NULL;
+			int Nvalues = 0;
+			while ((token = strtok(NULL, " \t\r\n")) != NULL) en_expand(&values, &Nvalues, token);
+			en->seeds = (unsigned int*)realloc(en->seeds, (en->Nseeds + Nvalues)*sizeof(unsigned int));
+			for (int k = 0; k < Nvalues; k++)
+			{
+				en->seeds[en->Nseeds++] = (unsigned int)strtoul(values[k], NULL, 10);
+				free(values[k]);
+			}
+			free(values);
+		}
+		else if (strcmp(key, "traces") == 0)
+		{
+			token = strtok(NULL, " \t\r\n");
+			if (token == NULL || (strcmp(token, "On") != 0 && strcmp(token, "Off") != 0))
+			{
+				printf("ERROR: %s line %d: traces must be \"On\" or \"Off\"\n", filename, Nline);
+				exit(1);
+			}
+			en->traces = (strcmp(token, "On") == 0);
+		}
+		else if (strcmp(key, "population") == 0)
+		{
+			char *N = strtok(NULL, " \t\r\n");
+			char *method = strtok(NULL, " \t\r\n");
+			char *seed = strtok(NULL, " \t\r\n");
+			if (N == NULL || method == NULL || atoi(N) < 1 || strlen(method) >= sizeof(pop_method))
+			{
+				printf("ERROR: %s line %d: population needs the number of samples and lhs or sobol (and optionally a seed)\n", filename, Nline);
+				exit(1);
+			}
+			Npopulation = atoi(N);
+			strcpy(pop_method, method);
+			if (seed != NULL) pop_seed = (unsigned int)strtoul(seed, NULL, 10);
+		}
+		else if (strcmp(key, "sample") == 0)
+		{
+			char *arg = strtok(NULL, " \t\r\n");
+			char *min = strtok(NULL, " \t\r\n");
+			char *max = strtok(NULL, " \t\r\n");
+			char *scale = strtok(NULL, " \t\r\n");
+			if (arg == NULL || min == NULL || max == NULL || (scale != NULL && strcmp(scale, "log") != 0))
+			{
+				printf("ERROR: %s line %d: sample needs an argument name, min and max (and optionally log)\n", filename, Nline);
+				exit(1);
+			}
+			population_add_sampled(&en->pop, arg, atof(min), atof(max), scale != NULL);
+		}
+		else if (strcmp(key, "accept") == 0)
+		{
+			char *biomarker = strtok(NULL, " \t\r\n");
+			char *min = strtok(NULL, " \t\r\n");
+			char *max = strtok(NULL, " \t\r\n");
+			if (biomarker == NULL || min == NULL || max == NULL)
+			{
+				printf("ERROR: %s line %d: accept needs a biomarker, min and max\n", filename, Nline);
+				exit(1);
+			}
+			population_add_criterion(&en->pop, biomarker, atof(min), atof(max));
+		}
+		else if (strcmp(key, "reject_after") == 0 || strcmp(key, "reject_margin") == 0)
+		{
+			token = strtok(NULL, " \t\r\n");
+			if (token == NULL || atof(token) < 0)
+			{
+				printf("ERROR: %s line %d: %s needs a value >= 0\n", filename, Nline, key);
+				exit(1);
+			}
+			if (strcmp(key, "reject_after") == 0)   en->pop.reject_after    = atoi(token);
+			else                                    en->pop.margin          = atof(token);
+		}
+		else
+		{
+			printf("ERROR: %s line %d: \"%s\" is not an ensemble keyword (version, base, grid, member, settings, seeds, traces, population, sample, accept, reject_after, reject_margin)\n", filename, Nline, key);
+			exit(1);
+		}
+	}
+	fclose(in);
+	free(line);
+
+	// Command-line arguments are common to all members, after the spec base
+	for (int k = 0; k < argc; k++) en_append(&en->base, &en->Nbase, argv[k]);
+	if (en->Nbase%2 != 0)
+	{
+		printf("ERROR: ensemble base arguments must be argument and value pairs\n");
+		exit(1);
+	}
+	for (int k = 0; k < en->Nbase; k += 2) if (strcmp(en->base[k], "Reference") == 0) strcpy(en->reference, en->base[k+1]);
+
+	if (Npopulation > 0)                population_generate(&en->pop, Npopulation, pop_method, pop_seed);   // lib/Population.cpp
+	else if (en->pop.Nsampled > 0)
+	{
+		printf("ERROR: sampled arguments need a population line (population N lhs|sobol)\n");
+		exit(1);
+	}
+
+	if (en->Nseeds > 0 && strcmp(en->version, "0D") != 0)
+	{
+		printf("ERROR: seeds apply to the stochastic 0D model only (version 0D)\n");
+		exit(1);
+	}
+
+	// Settings file arguments, read once per file
+	int Nsettings = (en->Nsettings > 0) ? en->Nsettings : 1;
+	int *Nsettings_args         = (int*)calloc(Nsettings, sizeof(int));
+	char ***settings_args       = (char***)calloc(Nsettings, sizeof(char**));
+	for (int f = 0; f < en->Nsettings; f++) en_read_settings_file(en->settings[f], &settings_args[f], &Nsettings_args[f]);
+
+	// Members: settings files x (grid points + explicit members + population samples) x seeds
+	int Ngrid_points = 0;
+	if (en->Ngrids > 0)
+	{
+		Ngrid_points = 1;
+		for (int g = 0; g < en->Ngrids; g++) Ngrid_points *= en->Ngrid_values[g];
+	}
+	int Npop            = (en->pop.on == true) ? en->pop.N : 0;
+	int Ncombinations   = Ngrid_points + en->Nexplicit + Npop;
+	if (Ncombinations == 0) Ncombinations = 1;
+	int Nseeds          = (en->Nseeds > 0) ? en->Nseeds : 1;
+	en->Nmembers        = Nsettings*Ncombinations*Nseeds;
+	en->member          = (Ensemble_member*)calloc(en->Nmembers, sizeof(Ensemble_member));
+
+	int m = 0;
+	for (int f = 0; f < Nsettings; f++)
+	for (int c = 0; c < Ncombinations; c++)
+	for (int z = 0; z < Nseeds; z++)
+	{
+		Ensemble_member *mb = &en->member[m++];
+		char **args = NULL;
+		int Nargs = 0;
+		mb->label[0] = '\0';
+		mb->sample = -1;
+
+		en_append(&args, &Nargs, "ensemble");
+		for (int k = 0; k < Nsettings_args[f]; k++) en_append(&args, &Nargs, settings_args[f][k]);
+		for (int k = 0; k < en->Nbase; k++)         en_append(&args, &Nargs, en->base[k]);
+		if (en->Nsettings > 0) sprintf(mb->label + strlen(mb->label), "Settings_file %s ", en->settings[f]);
+
+		if (c < Ngrid_points)
+		{
+			int index = c;
+			for (int g = en->Ngrids - 1; g >= 0; g--)
+			{
+				const char *value = en->grid_values[g][index%en->Ngrid_values[g]];
+				index /= en->Ngrid_values[g];
+				en_append(&args, &Nargs, en->grid_arg[g]);
+				en_append(&args, &Nargs, value);
+			}
+			// label in grid order
+			for (int g = 0, stride = Ngrid_points; g < en->Ngrids; g++)
+			{
+				stride /= en->Ngrid_values[g];
+				sprintf(mb->label + strlen(mb->label), "%s %s ", en->grid_arg[g], en->grid_values[g][(c/stride)%en->Ngrid_values[g]]);
+			}
+		}
+		else if (c - Ngrid_points < en->Nexplicit)
+		{
+			int e = c - Ngrid_points;
+			for (int k = 0; k < en->Nexplicit_args[e]; k++)
+			{
+				en_append(&args, &Nargs, en->explicit_args[e][k]);
+				if (strlen(mb->label) + strlen(en->explicit_args[e][k]) < sizeof(mb->label) - 32) sprintf(mb->label + strlen(mb->label), "%s ", en->explicit_args[e][k]);
+			}
+		}
+		else if (c - Ngrid_points - en->Nexplicit < Npop)
+		{
+			mb->sample = c - Ngrid_points - en->Nexplicit;
+			char value[64];
+			sprintf(mb->label, "sample %d ", mb->sample);
+			for (int d = 0; d < en->pop.Nsampled; d++)
+			{
+				sprintf(value, "%.10g", en->pop.x[mb->sample*en->pop.Nsampled + d]);
+				en_append(&args, &Nargs, en->pop.arg[d]);
+				en_append(&args, &Nargs, value);
+				if (strlen(mb->label) + strlen(en->pop.arg[d]) + strlen(value) < sizeof(mb->label) - 32) sprintf(mb->label + strlen(mb->label), "%s %s ", en->pop.arg[d], value);
+			}
+		}
+		if (en->Nseeds > 0)
+		{
+			mb->seeded  = true;
+			mb->seed    = en->seeds[z];
+			sprintf(mb->label + strlen(mb->label), "seed %u ", mb->seed);
+		}
+		if (mb->label[0] == '\0') strcpy(mb->label, "base ");
+		mb->label[strlen(mb->label) - 1] = '\0';
+		mb->argc = Nargs;
+		mb->argv = args;
+	}
+
+	for (int f = 0; f < en->Nsettings; f++)
+	{
+		for (int k = 0; k < Nsettings_args[f]; k++) free(settings_args[f][k]);
+		free(settings_args[f]);
+	}
+	free(settings_args);
+	free(Nsettings_args);
+
+	printf("Ensemble %s read in: version %s || %d members (%d settings file(s) x %d argument set(s) x %d seed(s)) || traces %s\n",
+			filename, en->version, en->Nmembers, Nsettings, Ncombinations, Nseeds, en->traces ? "On" : "Off");
+	if (en->pop.on == true) printf("Population: %d %s samples of %d argument(s) || %d acceptance criteria || early rejection %s\n", 
+			en->pop.N, en->pop.method, en->pop.Nsampled, en->pop.Ncriteria, (en->pop.reject_after > 0 && en->pop.Ncriteria > 0) ? "On" : "Off");
+}
+// End read specification =======================================================================//|
+
+// Serial setup of all members ==================================================================\\|
+void ensemble_setup(Ensemble *en, const char *PATH, const char *directory)
+{
+	bool native = (strcmp(en->version, "native") == 0);
+	const char *code_version = native ? "Single_cell_native" : "Single_cell_0D";
+	Argument_parameters *A = (Argument_parameters*)malloc(sizeof(Argument_parameters));
+
+	char file[1000];
+	sprintf(file, "%s/Ensemble_members.txt", directory);
+	FILE *out = fopen(file, "wt");
+	if (out == NULL)
+	{
+		printf("ERROR: cannot open %s\n", file);
+		exit(1);
+	}
+	fprintf(out, "# member | arguments as applied (settings file, base, command line, member)\n");
+
+	for (int m = 0; m < en->Nmembers; m++)
+	{
+		Ensemble_member *mb = &en->member[m];
+
+		set_argument_defaults(A);
+		fprintf(out, "%d\t", m);
+		set_arguments(mb->argc, mb->argv, A, code_version, out);   // lib/Arguments.c
+		fprintf(out, "\n");
+
+		set_simulation_defaults(&mb->Sim, native ? 0.02 : 0.01);
+		set_simulation_settings(&mb->Sim, *A, native ? "native" : "integrated");
+		mb->Sim.Windows = mb->Sim.Mac = mb->Sim.Linux = false;
+		#ifdef _WIN32
+		mb->Sim.Windows = true;
+		#endif
+		#ifdef __APPLE__
+		mb->Sim.Mac     = true;
+		#endif
+		#ifdef __linux__
+		mb->Sim.Linux   = true;
+		#endif
+		mb->Sim.OS_set  = true;
+
+		if (strcmp(mb->Sim.Vclamp, "On") == 0)
+		{
+			printf("ERROR: Vclamp is not available in an ensemble; run model_single_%s for the voltage clamp\n", en->version);
+			exit(1);
+		}
+		if (native == false && (strcmp(mb->Sim.Steady_state, "On") == 0 || strcmp(mb->Sim.Periodic_orbit, "On") == 0))
+		{
+			printf("ERROR: Steady_state and Periodic_orbit are only available for native members\n");
+			exit(1);
+		}
+
+		if (native == true) en_setup_native(mb, A, PATH);
+		else                en_setup_0D(mb, A, PATH);
+
+		if (en_member_needs_directory(en, mb))
+		{
+			char mkdirectory[1100], dir[1000];
+			en_member_directory(dir, directory, mb->Sim, m);
+			if (mb->Sim.Windows == true)    sprintf(mkdirectory, "mkdir %s", dir);
+			else                            sprintf(mkdirectory, "mkdir -p %s", dir);
+			system(mkdirectory);
+		}
+	}
+	fclose(out);
+	free(A);
+	printf("Ensemble setup complete: %d members; arguments written to %s\n", en->Nmembers, file);
+}
+// End setup ====================================================================================//|
+
+// Runs all members concurrently ================================================================\\|
+void ensemble_run(Ensemble *en, const char *PATH, const char *directory)
+{
+	bool native = (strcmp(en->version, "native") == 0);
+	int Nthreads = 1;
+#ifdef _OPENMP
+	Nthreads = omp_get_max_threads();
+#endif
+	printf("Running %d members on %d thread(s)\n", en->Nmembers, Nthreads);
+	double start = en_wtime();
+	int Ndone = 0;
+
+	#pragma omp parallel for schedule(dynamic,1)
+	for (int m = 0; m < en->Nmembers; m++)
+	{
+		Ensemble_member *mb = &en->member[m];
+		double t0 = en_wtime();
+		if (native == true) en_run_native(en, mb, PATH, directory, m);
+		else                en_run_0D(en, mb, PATH, directory, m);
+		mb->wall = en_wtime() - t0;
+
+		#pragma omp critical
+		{
+			Ndone++;
+			if (mb->status == POP_ABORTED)  printf("Member %d (%d/%d) rejected at beat %d (%s) after %.2f s: %s\n", m, Ndone, en->Nmembers, mb->beats, mb->failed, mb->wall, mb->label);
+			else                            printf("Member %d (%d/%d) finished in %.2f s: %s || APD90 = %.2f ms%s\n", m, Ndone, en->Nmembers, mb->wall, mb->label, mb->Variables.APD_p[8],
+													(mb->status == POP_ACCEPTED) ? " || accepted" : (mb->status == POP_REJECTED) ? " || rejected" : "");
+		}
+	}
+	printf("Ensemble finished in %.2f s\n", en_wtime() - start);
+}
+// End run ======================================================================================//|
+
+// Summary table, one line per member ===========================================================\\|
+void ensemble_write_summary(Ensemble *en, const char *directory)
+{
+	char file[1000];
+	sprintf(file, "%s/Ensemble_summary.dat", directory);
+	FILE *out = fopen(file, "wt");
+	if (out == NULL)
+	{
+		printf("ERROR: cannot open %s\n", file);
+		exit(1);
+	}
+	fprintf(out, "# 1: member | 2-29: as Properties_log.txt (BCL S2 APD_t APD_t_prev APD30 APD30_prev APD50 APD50_prev APD70 APD70_prev APD90 APD90_prev ");
+	fprintf(out, "dvdt_max dvdt_max_prev Vmin Vmin_prev Vmax Vmax_prev Vamp Vamp_prev CaT_min CaT_min_prev CaT_max CaT_max_prev CaSR_min CaSR_min_prev CaSR_max CaSR_max_prev) ");
+	fprintf(out, "| 30: beats paced | 31: wall time (s) | member arguments\n");
+
+	for (int m = 0; m < en->Nmembers; m++)
+	{
+		Ensemble_member *mb     = &en->member[m];
+		fprintf(out, "%d ", m);
+		output_properties_line(out, mb->Variables, mb->Sim.BCL, mb->Sim.S2_CL);   // lib/Outputs.cpp
+		fprintf(out, " %d %.3f | %s\n", mb->beats, mb->wall, mb->label);
+	}
+	fclose(out);
+	printf("Ensemble summary written to %s\n", file);
+
+	if (en->pop.Ncriteria == 0 && en->pop.on == false) return;
+
+	// Acceptance, and the population: all sampled members, then the accepted parameter sets
+	int Nstatus[4] = {0, 0, 0, 0};
+	int beats = 0, beats_full = 0;
+	for (int m = 0; m < en->Nmembers; m++)
+	{
+		Nstatus[en->member[m].status]++;
+		beats       += en->member[m].beats;
+		beats_full  += en->member[m].Sim.NBeats;
+	}
+	printf("Acceptance: %d accepted, %d rejected, %d rejected early (%d of %d beats paced)\n", Nstatus[POP_ACCEPTED], Nstatus[POP_REJECTED], Nstatus[POP_ABORTED], beats, beats_full);
+	if (en->pop.on == false) return;
+
+	FILE *acc;
+	sprintf(file, "%s/Population_members.dat", directory);
+	out = fopen(file, "wt");
+	sprintf(file, "%s/Population_accepted.dat", directory);
+	acc = fopen(file, "wt");
+	if (out == NULL || acc == NULL)
+	{
+		printf("ERROR: cannot open %s\n", file);
+		exit(1);
+	}
+	population_write_header(&en->pop, out);     // lib/Population.cpp
+	population_write_header(&en->pop, acc);
+	for (int m = 0; m < en->Nmembers; m++)
+	{
+		Ensemble_member *mb = &en->member[m];
+		if (mb->sample < 0) continue;
+		population_write_line(&en->pop, out, m, mb->sample, mb->status, mb->beats, mb->biomarker, mb->failed);
+		if (mb->status == POP_ACCEPTED) population_write_line(&en->pop, acc, m, mb->sample, mb->status, mb->beats, mb->biomarker, mb->failed);
+	}
+	fclose(out);
+	fclose(acc);
+	printf("Population written to %s/Population_members.dat and Population_accepted.dat\n", directory);
+}
+// End summary ==================================================================================//|
+
+void ensemble_free(Ensemble *en)
+{
+	for (int m = 0; m < en->Nmembers; m++)
+	{
+		for (int k = 0; k < en->member[m].argc; k++) free(en->member[m].argv[k]);
+		free(en->member[m].argv);
+		if (en->member[m].cell0D != NULL) delete en->member[m].cell0D;
+	}
+	free(en->member);
+	for (int k = 0; k < en->Nbase; k++) free(en->base[k]);
+	free(en->base);
+	for (int g = 0; g < en->Ngrids; g++)
+	{
+		free(en->grid_arg[g]);
+		for (int k = 0; k < en->Ngrid_values[g]; k++) free(en->grid_values[g][k]);
+		free(en->grid_values[g]);
+	}
+	for (int e = 0; e < en->Nexplicit; e++)
+	{
+		for (int k = 0; k < en->Nexplicit_args[e]; k++) free(en->explicit_args[e][k]);
+		free(en->explicit_args[e]);
+	}
+	free(en->explicit_args);
+	free(en->Nexplicit_args);
+	for (int f = 0; f < en->Nsettings; f++) free(en->settings[f]);
+	free(en->settings);
+	free(en->seeds);
+	population_free(&en->pop);     // lib/Population.cpp
+}
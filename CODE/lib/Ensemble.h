@@ -0,0 +1,134 @@
+// Source code associated with  ===========================  //
+// "Multi-scale cardiac simulation framework" =============  //
+// For simulation of cardiac cellular and tissue dynamics =  //
+// from the spatial cellular to full organ scales. ========  //
+// With implementation of multiple, published cell models =  //
+// as well as novel models developed in my lab. ===========  //
+// ========================================================  //
+// This file: In-process ensemble of single ===============  //
+// cell simulations, header ===============================  //
+// ========================================================  //
+// GNU 3 LICENSE TEXT =====================================  //
+// COPYRIGHT (C) 2016-2019 MICHAEL A. COLMAN ==============  //
+// THIS PROGRAM IS FREE SOFTWARE: YOU CAN REDISTRIBUTE IT =  //
+// AND/OR MODIFY IT UNDER THE TERMS OF THE GNU GENERAL ====  //
+// PUBLIC LICENSE AS PUBLISHED BY THE FREE SOFTWARE =======  //
+// FOUNDATION, EITHER VERSION 3 OF THE LICENSE, OR (AT YOUR  //
+// OPTION) ANY LATER VERSION. =============================  //
+// THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE=  //
+// USEFUL, BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE =====  //
+// IMPLIED WARRANTY OF MERCHANTABILITY OR FITNESS FOR A ===  //
+// PARTICULAR PURPOSE.  SEE THE GNU GENERAL PUBLIC LICENSE=  //
+// FOR MORE DETAILS. ======================================  //
+// YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL =====  //
+// PUBLIC LICENSE ALONG WITH THIS PROGRAM.  IF NOT, SEE ===  //
+// <https://www.gnu.org/licenses/>. =======================  //
+// ========================================================  //
+// ADDITIONAL LICENSE TEXT ================================  //
+// THIS SOFTWARE IS PROVIDED OPEN SOURCE AND MAY BE FREELY=  //
+// USED, DISTRIBUTED AND UPDATED, PROVIDED: ===============  //
+//  (i) THE APPROPRIATE WORK(S) IS(ARE) CITED. THIS =======  //
+//      PERTAINS TO THE CITATION OF COLMAN 2019 PLOS COMP =  //
+//      BIOL (FOR THIS IMPLEMTATION) AND ALL WORKS ========  //
+//      ASSOCIATED WITH THE SPECIFIC MODELS AND COMPONENTS=  //
+//      USED IN PARTICULAR SIMULATIONS. IT IS THE USER'S ==  //
+//      RESPONSIBILITY TO ENSURE ALL RELEVANT WORKS ARE ===  //
+//      CITED. PLEASE SEE FULL DOCUMENTATION AND ON-SCREEN=  //
+//      DISCLAIMER OUTPUTS FOR A GUIDE. ===================  //
+//  (ii) ALL OF THIS TEXT IS RETAINED WITHIN OR ASSOCIATED=  //
+//      WITH THE SOURCE CODE AND/OR BINARY FORM OF THE ====  //
+//      SOFTWARE. =========================================  //
+// ========================================================  //
+// ANY INTENDED COMMERCIAL USE OF THIS SOFTWARE MUST BE BY   //
+// EXPRESS PERMISSION OF MICHAEL A COLMAN ONLY. IN NO EVENT  //
+// ARE THE COPYRIGHT HOLDERS LIABLE FOR ANY DIRECT, =======  //
+// INDIRECT INCIDENTAL, SPECIAL, EXEMPLARY OR CONSEQUENTIAL  //
+// DAMAGES ASSOCIATED WITH USE OF THIS SOFTWARE ===========  //
+// ========================================================  //
+// THIS SOFTWARE CONTAINS IMPLEMENTATIONS OF MODELS AND ===  //
+// COMPONENTS WHICH I (MICHAEL COLMAN) DID NOT DEVELOP.====  //
+// ALL OF THESE COMPONENTS HAVE BEEN CODED FROM PROVIDED ==  //
+// SOURCE CODE OR INFORMATION IN THE PUBLICATIONS. ========  //
+// I CLAIM NO RIGHTS OR INTELLECTUAL PROPERTY OWNERSHIP ===  //
+// FOR THESE MODELS AND COMPONENTS, OTHER THAN THEIR ======  //
+// SPECIFIC IMPLEMENTATION IN THIS CODE PACKAGE. FURTHER TO  //
+// THE ABOVE STATEMENT, ANY INDTENDED COMMERCIAL USE OF ===  //
+// THOSE COMPONENTS MUST BE BY EXPRESS PERMISSION OF THE ==  //
+// ORIGINAL COPYRIGHT HOLDERS. ============================  //
+// WHERE IMPLEMENTED FROM PROVIDED CODE, ANY DISCLAIMERS ==  //
+// PRESENT IN THE ORIGINAL CODE HAVE BEEN RETAINED IN THE =  //
+// RELEVANT FILE. =========================================  //
+// ========================================================  //
+// Contact: m.a.colman@leeds.ac.uk ========================  //
+// For updates, corrections etc, please check: ============  //
+// 1. http://physicsoftheheart.com/ =======================  //
+// 2. https://github.com/michaelcolman ====================  //
+// ========================================================  //
+
+#ifndef ENSEMBLE_H
+#define ENSEMBLE_H
+
+#include "Structs.h"
+#include "Population.h"
+#include <stdio.h>
+
+struct Ensemble_0D; // lib/Ensemble.cpp || integrated Ca handling structs of one 0D member
+
+#define EN_MAX_LINE     10000   // characters per line of the specification file
+#define EN_MAX_GRIDS    32
+
+// One member: one complete single cell simulation
+typedef struct{
+	int         argc;
+	char        **argv;             // argv[0] = "ensemble", then settings file, base and member arguments
+	char        label[1000];        // member-specific arguments (grid values, member line, settings file, seed)
+	bool        seeded;
+	unsigned int seed;              // Mersenne twister seed (0D)
+
+	Simulation_parameters   Sim;
+	Cell_parameters         Params;
+	State_variables         State;
+	Model_variables         Variables;
+	struct Ensemble_0D      *cell0D;
+
+	// Outcome
+	int         beats;              // beats paced (fewer than Sim.NBeats if ended at steady state or rejected early)
+	double      wall;               // s
+	int         sample;             // population sample (-1 = not a population member)
+	int         status;             // POP_ACCEPTED, POP_REJECTED, POP_ABORTED (lib/Population.h)
+	char        failed[16];         // biomarker out of range
+	double      biomarker[POP_NBIOMARKERS];
+}Ensemble_member;
+
+typedef struct{
+	char        version[16];        // "native" or "0D"
+	bool        traces;             // full Currents/Properties traces per member
+	char        reference[500];
+
+	// Specification
+	int         Nbase;
+	char        **base;             // spec "base" arguments followed by command-line arguments
+	int         Ngrids;
+	char        *grid_arg[EN_MAX_GRIDS];
+	int         Ngrid_values[EN_MAX_GRIDS];
+	char        **grid_values[EN_MAX_GRIDS];
+	int         Nexplicit;
+	int         *Nexplicit_args;
+	char        ***explicit_args;   // "member" lines
+	int         Nsettings;
+	char        **settings;         // settings file templates
+	int         Nseeds;
+	unsigned int *seeds;
+	Population  pop;                // population of models (sampled members, acceptance criteria)
+
+	int         Nmembers;
+	Ensemble_member *member;
+}Ensemble;
+
+void ensemble_read_spec(Ensemble *en, const char *filename, int argc, char *argv[]);
+void ensemble_setup(Ensemble *en, const char *PATH, const char *directory);
+void ensemble_run(Ensemble *en, const char *PATH, const char *directory);
+void ensemble_write_summary(Ensemble *en, const char *directory);
+void ensemble_free(Ensemble *en);
+
+#endif
@@ -67,6 +67,7 @@
 #include "Initialisation.h"
 #include "Structs.h"
 #include "Arguments.h"
+#include "Model.h"
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -112,6 +113,78 @@ void set_simulation_defaults(Simulation_parameters *sim, double dt)
 	sim->Spatial_output_interval_data   = 1;	// 1 ms is default
     sim->Spatial_output_start_time      = 0;    
     sim->Spatial_output_end_time        = sim->Total_time;
+    sim->Spatial_output_async           = "On";   // copy to snapshot buffer and write in background
+    sim->Spatial_output_writers         = 1;
+    sim->Spatial_output_buffers         = 4;
+    sim->Spatial_output_vtk_format      = "legacy"; // ASCII .vtk; "vti"/"vtu" for binary
+    sim->Spatial_output_precision       = "float";  // legacy ASCII was also float (%f) precision
+    sim->Spatial_output_compression     = "Off";
+    sim->Spatial_output_data_format     = "bin";    // one .bin file per variable per frame
+    sim->Spatial_output_interval_reduced    = 0;        // off
+    sim->Spatial_output_reduced_variables   = "Vm,Ca";  // default ranges for Vm and Ca; others need name:min:max
+    sim->Spatial_output_reduced_stride      = 2;
+    sim->Spatial_output_reduced_mode        = "average";
+    sim->Spatial_output_reduced_bits        = 8;
+    sim->Spatial_output_reduced_ROI         = "full";
+    sim->Spatial_output_reduced_box         = "none";
+    sim->Spatial_output_reduced_map_file    = "none";
+
+    sim->Checkpoint_interval    = 0;        // off
+    sim->Checkpoint_keep        = 2;
+    sim->Checkpoint_deltas      = 0;        // every checkpoint full
+    sim->Checkpoint_compression = "Off";
+    sim->Read_checkpoint        = "Off";
+
+    sim->S2_sweep               = "Off";
+    sim->S2_sweep_locations     = "S2";     // S2_x_loc
+    sim->S2_sweep_CL            = "none";
+    sim->S2_sweep_resolution    = 1;        // ms
+    sim->S2_sweep_window        = 500;      // ms
+    sim->S2_sweep_branches      = 0;        // one per thread
+
+    sim->Beat_maps              = "Off";
+    sim->Beat_maps_APD          = "90,50";  // % repolarisation
+
+    sim->Pseudo_ECG             = "Off";
+    sim->Pseudo_ECG_electrodes  = "auto";   // either side of the tissue along x
+    sim->Pseudo_ECG_leads       = "none";
+
+    sim->Phase_singularity          = "Off";
+    sim->Phase_singularity_interval = 5;    // ms
+    sim->Phase_singularity_delay    = 10;   // ms
+    sim->Phase_singularity_radius   = 2.0;  // mm
+    sim->Probe_file                 = "Off";
+    sim->Regional_outputs           = "Off";
+    sim->Regional_outputs_stats     = "mean,min,max,active";
+    sim->Regional_outputs_interval  = 1;    // ms
+    sim->Tissue_cache               = "auto";
+    sim->Setup_diagnostics          = "Off";
+
+    sim->Steady_state           = "Off";
+    sim->Steady_state_beats     = 10;
+    sim->Steady_state_tol_APD90 = 0.05;     // % per beat
+    sim->Steady_state_tol_CaT   = 0.1;
+    sim->Steady_state_tol_Nai   = 0.01;
+    sim->Steady_state_tol_CaSR  = 0.05;
+
+    sim->Periodic_orbit             = "Off";
+    sim->Periodic_orbit_tol         = 1e-6;
+    sim->Periodic_orbit_iterations  = 20;
+    sim->Periodic_orbit_krylov      = 30;
+    sim->Periodic_orbit_prebeats    = 5;
+    sim->Periodic_orbit_aitken      = 3;
+
+    sim->Restitution                = "Off";
+    sim->Restitution_BCL            = "300,1000,100";
+    sim->Restitution_beats          = 50;
+    sim->Restitution_S2             = "100,1000,10";
+    sim->Restitution_window         = 1000;
+    sim->Restitution_ERP_threshold  = 0.8;
+    sim->Restitution_ERP_resolution = 1;
+
+    sim->Sensitivity                = "Off";
+    sim->Sensitivity_parameters     = "GNa,Gto,GCaL,GKur,GKr,GKs,GK1,GNCX,GNaK";
+    sim->Sensitivity_step           = 1e-6;
 
 	sim->Delayed_CaSR_IC    = "Off";
 	sim->CaSR_IC_delay      = 1000; // ms
@@ -191,10 +264,95 @@ void set_simulation_settings(Simulation_parameters *sim, Argument_parameters A,
 	if (A.SOId_arg 	== true) 	sim->Spatial_output_interval_data 	= A.SOId;
     if (A.SORs_arg  == true)    sim->Spatial_output_start_time      = A.SORs;
     if (A.SORe_arg  == true)    sim->Spatial_output_end_time        = A.SORe;
+    if (A.SOA_arg   == true)    sim->Spatial_output_async           = A.SOA;
+    if (A.SOW_arg   == true)    sim->Spatial_output_writers         = A.SOW;
+    if (A.SOB_arg   == true)    sim->Spatial_output_buffers         = A.SOB;
+    if (A.SOVF_arg  == true)    sim->Spatial_output_vtk_format      = A.SOVF;
+    if (A.SOP_arg   == true)    sim->Spatial_output_precision       = A.SOP;
+    if (A.SOC_arg   == true)    sim->Spatial_output_compression     = A.SOC;
+    if (A.SODF_arg  == true)    sim->Spatial_output_data_format     = A.SODF;
+    if (A.SOIr_arg  == true)    sim->Spatial_output_interval_reduced    = A.SOIr;
+    if (A.SORv_arg  == true)    sim->Spatial_output_reduced_variables   = A.SORv;
+    if (A.SORst_arg == true)    sim->Spatial_output_reduced_stride      = A.SORst;
+    if (A.SORm_arg  == true)    sim->Spatial_output_reduced_mode        = A.SORm;
+    if (A.SORb_arg  == true)    sim->Spatial_output_reduced_bits        = A.SORb;
+    if (A.SORR_arg  == true)    sim->Spatial_output_reduced_ROI         = A.SORR;
+    if (A.SORbox_arg == true)   sim->Spatial_output_reduced_box         = A.SORbox;
+    if (A.SORmap_arg == true)   sim->Spatial_output_reduced_map_file    = A.SORmap;
+
+    // Checkpoint/restart
+    if (A.CKI_arg   == true)    sim->Checkpoint_interval    = A.CKI;
+    if (A.CKK_arg   == true)    sim->Checkpoint_keep        = A.CKK;
+    if (A.CKD_arg   == true)    sim->Checkpoint_deltas      = A.CKD;
+    if (A.CKC_arg   == true)    sim->Checkpoint_compression = A.CKC;
+    if (A.RCK_arg   == true)    sim->Read_checkpoint        = A.RCK;
+
+    // S1-S2 vulnerability window sweep
+    if (A.S2SW_arg  == true)    sim->S2_sweep               = A.S2SW;
+    if (A.S2SWL_arg == true)    sim->S2_sweep_locations     = A.S2SWL;
+    if (A.S2SWC_arg == true)    sim->S2_sweep_CL            = A.S2SWC;
+    if (A.S2SWR_arg == true)    sim->S2_sweep_resolution    = A.S2SWR;
+    if (A.S2SWW_arg == true)    sim->S2_sweep_window        = A.S2SWW;
+    if (A.S2SWB_arg == true)    sim->S2_sweep_branches      = A.S2SWB;
+
+    // Per-beat maps
+    if (A.BM_arg    == true)    sim->Beat_maps              = A.BM;
+    if (A.BMA_arg   == true)    sim->Beat_maps_APD          = A.BMA;
+
+    // Pseudo-ECG
+    if (A.PECG_arg  == true)    sim->Pseudo_ECG             = A.PECG;
+    if (A.PECGE_arg == true)    sim->Pseudo_ECG_electrodes  = A.PECGE;
+    if (A.PECGL_arg == true)    sim->Pseudo_ECG_leads       = A.PECGL;
+
+    // Phase singularity tracking
+    if (A.PSG_arg   == true)    sim->Phase_singularity          = A.PSG;
+    if (A.PSGI_arg  == true)    sim->Phase_singularity_interval = A.PSGI;
+    if (A.PSGD_arg  == true)    sim->Phase_singularity_delay    = A.PSGD;
+    if (A.PSGR_arg  == true)    sim->Phase_singularity_radius   = A.PSGR;
+    if (A.PRF_arg   == true)    sim->Probe_file                 = A.PRF;
+    if (A.RGO_arg   == true)    sim->Regional_outputs           = A.RGO;
+    if (A.RGOS_arg  == true)    sim->Regional_outputs_stats     = A.RGOS;
+    if (A.RGOI_arg  == true)    sim->Regional_outputs_interval  = A.RGOI;
+    if (A.TCH_arg   == true)    sim->Tissue_cache               = A.TCH;
+    if (A.SUD_arg   == true)    sim->Setup_diagnostics          = A.SUD;
+
+    // Steady-state detection
+    if (A.SS_arg    == true)    sim->Steady_state           = A.SS;
+    if (A.SSB_arg   == true)    sim->Steady_state_beats     = A.SSB;
+    if (A.SSTA_arg  == true)    sim->Steady_state_tol_APD90 = A.SSTA;
+    if (A.SSTC_arg  == true)    sim->Steady_state_tol_CaT   = A.SSTC;
+    if (A.SSTN_arg  == true)    sim->Steady_state_tol_Nai   = A.SSTN;
+    if (A.SSTS_arg  == true)    sim->Steady_state_tol_CaSR  = A.SSTS;
+
+    // Periodic orbit solver
+    if (A.PO_arg    == true)    sim->Periodic_orbit             = A.PO;
+    if (A.POT_arg   == true)    sim->Periodic_orbit_tol         = A.POT;
+    if (A.POI_arg   == true)    sim->Periodic_orbit_iterations  = A.POI;
+    if (A.POK_arg   == true)    sim->Periodic_orbit_krylov      = A.POK;
+    if (A.POP_arg   == true)    sim->Periodic_orbit_prebeats    = A.POP;
+    if (A.POA_arg   == true)    sim->Periodic_orbit_aitken      = A.POA;
+
+    // Restitution and ERP protocol
+    if (A.RP_arg    == true)    sim->Restitution                = A.RP;
+    if (A.RPB_arg   == true)    sim->Restitution_BCL            = A.RPB;
+    if (A.RPN_arg   == true)    sim->Restitution_beats          = A.RPN;
+    if (A.RPS_arg   == true)    sim->Restitution_S2             = A.RPS;
+    if (A.RPW_arg   == true)    sim->Restitution_window         = A.RPW;
+    if (A.RPT_arg   == true)    sim->Restitution_ERP_threshold  = A.RPT;
+    if (A.RPR_arg   == true)    sim->Restitution_ERP_resolution = A.RPR;
+
+    // Forward sensitivities
+    if (A.SEN_arg   == true)    sim->Sensitivity                = A.SEN;
+    if (A.SENP_arg  == true)    sim->Sensitivity_parameters     = A.SENP;
+    if (A.SENH_arg  == true)    sim->Sensitivity_step           = A.SENH;
 
 	// Delayed CaSR IC functionality
 	if (A.Delayed_CaSR_IC_arg == true) 	sim->Delayed_CaSR_IC 	= A.Delayed_CaSR_IC;
 	if (A.CaSR_IC_delay_arg == true)	sim->CaSR_IC_delay		= A.CaSR_IC_delay;
+
+	// Flags consulted in the time loop
+	sim->Write_state_phase	= (strcmp(sim->Write_state, "phase") == 0);
+	sim->Delayed_CaSR_IC_on	= (strcmp(sim->Delayed_CaSR_IC, "On") == 0);
 }
 // End simulation settings ======================================================================//|
 
@@ -240,6 +398,10 @@ void set_model_conditions(Cell_parameters *p, Argument_parameters A)
 
     // Calcium model heterogeneity
     if(A.Ca_cellular_het_arg == true)       p->Ca_cellular_het = A.Ca_cellular_het;
+
+	// Identifiers for the per-step functions || updated in set_model_group_variables() if Model is changed
+	p->Model_id			= model_id(p->Model);	// lib/Model.c
+	p->isolated			= (strcmp(p->environment, "isolated") == 0);
 }
 
 void set_model_group_variables(Cell_parameters *p, Argument_parameters A)
@@ -255,12 +417,16 @@ void set_model_group_variables(Cell_parameters *p, Argument_parameters A)
 	{
 		if (A.environment_arg 	== true) 	p->environment  = A.environment;
 	}
+
+	p->Model_id			= model_id(p->Model);	// lib/Model.c
+	p->isolated			= (strcmp(p->environment, "isolated") == 0);
 }
 
 void set_local_model_conditions(Cell_parameters p_in, Cell_parameters *p)
 {
 	// p_in is Global_params; p is local (array) of params
 	p->Model			= p_in.Model;
+	p->Model_id			= p_in.Model_id;
 	p->Agent			= p_in.Agent;
 	p->Remodelling		= p_in.Remodelling;
 	p->Agent_prop		= p_in.Agent_prop;
@@ -270,6 +436,7 @@ void set_local_model_conditions(Cell_parameters p_in, Cell_parameters *p)
 	p->Mutation			= p_in.Mutation;
 	p->hAM				= p_in.hAM;
 	p->environment		= p_in.environment;
+	p->isolated			= p_in.isolated;
 	p->ACh				= p_in.ACh;
 	p->ACh_model		= p_in.ACh_model;
 }
@@ -484,6 +651,7 @@ void initialise_measurement_variables(Model_variables *var)
 {
 	for (int i = 0; i < 9; i++) 
 		var->APD_p_switch[i]= -1;       
+	var->APD_p_next         = 9;               // No % repolarisation threshold pending until excited
 	var->ex_switch          = 0;             
 	var->APD_t_switch       = -1;           
 	var->t_ex               = -100;            // Time at which cell was excited   (ms)
@@ -75,6 +75,7 @@
 
 // Function list ================================================================================\\|
 //	Model specific function call functions:
+//	    model_id()
 //	    set_parameters_native()
 //	    set_parameters_spatial_Ca()
 //	    initial_conditions_native()
@@ -117,6 +118,28 @@
 // End Function list ============================================================================//|
 
 // Functions to select appropriate specific functions ===========================================\\|
+// Model string to MODEL_X identifier (lib/Structs.h) for the per-step functions; -1 if not a model
+int model_id(char const *Model)
+{
+	if (strcmp(Model, "minimal") == 0)				return MODEL_MINIMAL;
+	else if (strcmp(Model, "hAM_CRN") == 0)			return MODEL_HAM_CRN;
+	else if (strcmp(Model, "hAM_GB") == 0)			return MODEL_HAM_GB;
+	else if (strcmp(Model, "hAM_NG") == 0)			return MODEL_HAM_NG;
+	else if (strcmp(Model, "hAM_MT") == 0)			return MODEL_HAM_MT;
+	else if (strcmp(Model, "hAM_WL_CRN") == 0)		return MODEL_HAM_WL_CRN;
+	else if (strcmp(Model, "hAM_CRN_mWL") == 0)		return MODEL_HAM_CRN_MWL;
+	else if (strcmp(Model, "hAM_WL_GB") == 0)		return MODEL_HAM_WL_GB;
+	else if (strcmp(Model, "hAM_GB_mWL") == 0)		return MODEL_HAM_GB_MWL;
+	else if (strcmp(Model, "hAM_NG_mWL") == 0)		return MODEL_HAM_NG_MWL;
+	else if (strcmp(Model, "hVM_ORD_s") == 0)		return MODEL_HVM_ORD_S;
+	else if (strcmp(Model, "hAM_CAZ_s") == 0)		return MODEL_HAM_CAZ_S;
+	else if (strcmp(Model, "dAM_VA") == 0)			return MODEL_DAM_VA;
+	else if (strcmp(Model, "mCRN") == 0)			return MODEL_MCRN;
+	else if (strcmp(Model, "hVM_TT") == 0)			return MODEL_HVM_TT;
+	//else if (strcmp(Model, "speciesCELL_MODEL") == 0)	return MODEL_SPECIESCELL_MODEL; // NEW MODEL
+	return -1;
+}
+
 void set_parameters_native(Cell_parameters *p, char const *Model)
 {
 	// 1 - models with own specific parameters
@@ -207,39 +230,41 @@ void initial_conditions_native(State_variables *s, Cell_parameters p, char const
 
 void compute_model_native(Cell_parameters p, Model_variables *var, State_variables *s, double Vm, double dt)
 {
-	if (strcmp(p.Model, "minimal") == 0)      					compute_model_minimal_native(p, var, s, Vm, dt); 		// lib/Model_minimal.cpp
-	else if (strcmp(p.Model, "hAM_CRN") == 0)   				compute_model_hAM_CRN_native(p, var, s, Vm, dt); 		// lib/Model_hAM_CRN.cpp
-	else if (strcmp(p.Model, "hAM_GB") == 0)    				compute_model_hAM_GB_native(p, var, s, Vm, dt); 		// lib/Model_hAM_GB.cpp
-	else if (strcmp(p.Model, "hAM_NG") == 0)   					compute_model_hAM_NG_native(p, var, s, Vm, dt); 		// lib/Model_hAM_NG.cpp
-	else if (strcmp(p.Model, "hAM_MT") == 0)   					compute_model_hAM_MT_native(p, var, s, Vm, dt); 		// lib/Model_hAM_MT.cpp
-	else if (strcmp(p.Model, "hAM_WL_CRN") == 0)   				compute_model_hAM_WL_native(p, var, s, Vm, dt); 		// lib/Model_hAM_WL.cpp
-	else if (strcmp(p.Model, "hAM_CRN_mWL") == 0)   			compute_model_hAM_WL_native(p, var, s, Vm, dt); 		// lib/Model_hAM_WL.cpp
-	else if (strcmp(p.Model, "hAM_WL_GB") == 0)    				compute_model_hAM_WL_native(p, var, s, Vm, dt); 		// lib/Model_hAM_WL.cpp
-	else if (strcmp(p.Model, "hAM_GB_mWL") == 0)    			compute_model_hAM_WL_native(p, var, s, Vm, dt); 		// lib/Model_hAM_WL.cpp
-	else if (strcmp(p.Model, "hAM_NG_mWL") == 0) 				compute_model_hAM_WL_native(p, var, s, Vm, dt); 		// lib/Model_hAM_WL.cpp
-	else if (strcmp(p.Model, "dAM_VA") == 0)   					compute_model_dAM_VA_native(p, var, s, Vm, dt);	// lib/Model_dAM_VA.cpp // NEW MODEL
-	else if (strcmp(p.Model, "mCRN") == 0)   					compute_model_mCRN_native(p, var, s, Vm, dt);	// lib/Model_mCRN.cpp // NEW MODEL
-	else if (strcmp(p.Model, "hVM_TT") == 0)   	compute_model_hVM_TT_native(p, var, s, Vm, dt);	// lib/Model_hVM_TT.cpp // NEW MODEL
-	//else if (strcmp(p.Model, "speciesCELL_MODEL") == 0)   	compute_model_speciesCELL_MODEL_native(p, var, s, Vm, dt);	// lib/Model_speciesCELL_MODEL.cpp // NEW MODEL
-	else
+	switch (p.Model_id)
 	{
-		printf("ERROR: \"%s\" is not a valid model type, model cannot be computed. See \"compute_model_native()\" in \"lib/Model.c\" for options\n\n", p.Model);
-		exit(1);
+		case MODEL_MINIMAL:			compute_model_minimal_native(p, var, s, Vm, dt); 	break;	// lib/Model_minimal.cpp
+		case MODEL_HAM_CRN:			compute_model_hAM_CRN_native(p, var, s, Vm, dt); 	break;	// lib/Model_hAM_CRN.cpp
+		case MODEL_HAM_GB:			compute_model_hAM_GB_native(p, var, s, Vm, dt); 	break;	// lib/Model_hAM_GB.cpp
+		case MODEL_HAM_NG:			compute_model_hAM_NG_native(p, var, s, Vm, dt); 	break;	// lib/Model_hAM_NG.cpp
+		case MODEL_HAM_MT:			compute_model_hAM_MT_native(p, var, s, Vm, dt); 	break;	// lib/Model_hAM_MT.cpp
+		case MODEL_HAM_WL_CRN:
+		case MODEL_HAM_CRN_MWL:
+		case MODEL_HAM_WL_GB:
+		case MODEL_HAM_GB_MWL:
+		case MODEL_HAM_NG_MWL:		compute_model_hAM_WL_native(p, var, s, Vm, dt); 	break;	// lib/Model_hAM_WL.cpp
+		case MODEL_DAM_VA:			compute_model_dAM_VA_native(p, var, s, Vm, dt);		break;	// lib/Model_dAM_VA.cpp // NEW MODEL
+		case MODEL_MCRN:			compute_model_mCRN_native(p, var, s, Vm, dt);		break;	// lib/Model_mCRN.cpp // NEW MODEL
+		case MODEL_HVM_TT:			compute_model_hVM_TT_native(p, var, s, Vm, dt);		break;	// lib/Model_hVM_TT.cpp // NEW MODEL
+		//case MODEL_SPECIESCELL_MODEL:	compute_model_speciesCELL_MODEL_native(p, var, s, Vm, dt);	break;	// lib/Model_speciesCELL_MODEL.cpp // NEW MODEL
+		default:
+			printf("ERROR: \"%s\" is not a valid model type, model cannot be computed. See \"compute_model_native()\" in \"lib/Model.c\" for options\n\n", p.Model);
+			exit(1);
 	}
 }
 
 void compute_model_integrated(Cell_parameters p, Model_variables *var, State_variables *s, double Vm, double dt)
 {
-	if (strcmp(p.Model, "minimal") == 0)                        compute_model_minimal_integrated(p, var, s, Vm, dt);        // lib/Model_minimal.cpp
-	else if (strcmp(p.Model, "hVM_ORD_s") == 0)                 compute_model_hVM_ORD_simple_integrated(p, var, s, Vm, dt); // lib/Model_hVM_ORD_simple.cpp
-	else if (strcmp(p.Model, "hAM_CAZ_s") == 0)                 compute_model_hAM_CAZ_simple_integrated(p, var, s, Vm, dt); // lib/Model_hAM_CAZ_simple.cpp
-	else if (strcmp(p.Model, "dAM_VA") == 0)                    compute_model_dAM_VA_integrated(p, var, s, Vm, dt);         // lib/Model_dAM_VA.cpp
-	else if (strcmp(p.Model, "mCRN") == 0)                    compute_model_mCRN_integrated(p, var, s, Vm, dt);         // lib/Model_mCRN.cpp
-    //else if (strcmp(p.Model, "speciesCELL_MODEL") == 0)         compute_model_speciesCELL_MODEL_integrated(p, var, s, Vm, dt); // lib/Model_speciesCELL_MODEL.cpp // NEW MODEL
-	else
+	switch (p.Model_id)
 	{
-		printf("ERROR: \"%s\" is not a valid model type, model cannot be computed. See \"compute_model_integrated()\" in \"lib/Model.c\" for options\n\n", p.Model);
-		exit(1);
+		case MODEL_MINIMAL:			compute_model_minimal_integrated(p, var, s, Vm, dt);        break;	// lib/Model_minimal.cpp
+		case MODEL_HVM_ORD_S:		compute_model_hVM_ORD_simple_integrated(p, var, s, Vm, dt); break;	// lib/Model_hVM_ORD_simple.cpp
+		case MODEL_HAM_CAZ_S:		compute_model_hAM_CAZ_simple_integrated(p, var, s, Vm, dt); break;	// lib/Model_hAM_CAZ_simple.cpp
+		case MODEL_DAM_VA:			compute_model_dAM_VA_integrated(p, var, s, Vm, dt);         break;	// lib/Model_dAM_VA.cpp
+		case MODEL_MCRN:			compute_model_mCRN_integrated(p, var, s, Vm, dt);           break;	// lib/Model_mCRN.cpp
+		//case MODEL_SPECIESCELL_MODEL:	compute_model_speciesCELL_MODEL_integrated(p, var, s, Vm, dt); break; // lib/Model_speciesCELL_MODEL.cpp // NEW MODEL
+		default:
+			printf("ERROR: \"%s\" is not a valid model type, model cannot be computed. See \"compute_model_integrated()\" in \"lib/Model.c\" for options\n\n", p.Model);
+			exit(1);
 	}
 }
 
@@ -1091,6 +1116,7 @@ void determine_excitation_state(Model_variables *var, double Vm, double time)
 			var->Vamp_prev		= var->Vamp;
 
 			for (int i = 0; i < 9; i++) var->APD_p_switch[i] = 0;
+			var->APD_p_next = 0;
 
 			var->CaT_min_prev	= var->CaT_min;
 			var->CaT_min		= 1;	// Ensure above values
@@ -1118,7 +1144,7 @@ void determine_excitation_state(Model_variables *var, double Vm, double time)
 	}
 }
 
-void determine_excitation_state_integrated_0D(Model_variables *var, double Vm, double time, double *Ca_JSR_t_ex, double Ca_JSR, double *dyad_SRF_prop_active, double srf_SRF_prop_active, int *srf_init, int *srf_set, const char *SRF_Mode)
+void determine_excitation_state_integrated_0D(Model_variables *var, double Vm, double time, double *Ca_JSR_t_ex, double Ca_JSR, double *dyad_SRF_prop_active, double srf_SRF_prop_active, int *srf_init, int *srf_set, int SRF_mode)
 {   
 	if (var->ex_switch == 0)    // If currently not excited
 	{
@@ -1139,6 +1165,7 @@ void determine_excitation_state_integrated_0D(Model_variables *var, double Vm, d
 			var->Vamp_prev      = var->Vamp;
 
 			for (int i = 0; i < 9; i++) var->APD_p_switch[i] = 0;
+			var->APD_p_next = 0;
 
 			var->CaT_min_prev   = var->CaT_min;
 			var->CaT_min        = 1;    // Ensure above values
@@ -1158,12 +1185,12 @@ void determine_excitation_state_integrated_0D(Model_variables *var, double Vm, d
 
 			// SRF stuff
 			*dyad_SRF_prop_active	= srf_SRF_prop_active;	
-			if (strcmp(SRF_Mode, "Direct_Control") == 0)
+			if (SRF_mode == SRF_DIRECT_CONTROL)
 			{
 				*srf_init      = 0; // comment out if want just one static beat
 				*srf_set       = 0;
 			}
-			else if (strcmp(SRF_Mode, "Dynamic") == 0)
+			else if (SRF_mode == SRF_DYNAMIC)
 			{
 				*srf_set    = -1;
 			}	
@@ -1216,24 +1243,22 @@ void calculate_measurement_properties(Model_variables *var, double Vm1, double V
 	}
 
 	// APD to different percentages
+	// Thresholds are crossed in order (10% first, 90% last), so only the next one pending is 
+	// tested each step; the loop continues only when several are crossed in the same step
 	double perc, threshold;
-	for (int i = 0; i < 9; i++)
+	while (var->APD_p_next < 9)
 	{
-		if (var->APD_p_switch[i] == 0)	// if in state where APD needs to be calculated (i.e. has been excited but not calculated)
-		{
-			perc = (i+1)*10; 	// converts 0 to 10%, 8 to 90%
-			perc *= 0.01;		// convers % to proportion
-			threshold = var->Vmax - perc*(var->Vmax - var->Vmin_prev); // Vmin_prev is V just before excitation; current Vmax
-			if (Vm2 < threshold) // if the voltage is now below the threshold
-			{
-				var->APD_p[i]			= time - var->t_ex;
-				var->APD_p_switch[i]	= 1;	// Been calculated
-			}
-		}
+		int i = var->APD_p_next;
+		perc = (i+1)*10; 	// converts 0 to 10%, 8 to 90%
+		perc *= 0.01;		// convers % to proportion
+		threshold = var->Vmax - perc*(var->Vmax - var->Vmin_prev); // Vmin_prev is V just before excitation; current Vmax
+		if (Vm2 >= threshold) break; // not yet crossed
+		var->APD_p[i]			= time - var->t_ex;
+		var->APD_p_switch[i]	= 1;	// Been calculated
+		var->APD_p_next++;
 	}
 }
 
-
 // End Excitation properties / measurements =====================================================//|
 
 // Voltage clamp ================================================================================\\|
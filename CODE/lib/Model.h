@@ -81,6 +81,9 @@
 #include <math.h>
 
 // Common functions  ========================================================\\|
+// Model string to identifier (MODEL_X, lib/Structs.h)
+int model_id(char const *Model);
+
 // Set parameters functions - choses which set parameters function to call
 void set_parameters_native(Cell_parameters *p, char const *Model); 
 void set_parameters_spatial_Ca(Cell_parameters *p, char const *Model);
@@ -119,7 +122,7 @@ void compute_reversal_potentials(Cell_parameters p, Model_variables *var, State_
 
 // Excitation properties / measurements
 void determine_excitation_state(Model_variables *var, double Vm, double time);
-void determine_excitation_state_integrated_0D(Model_variables *var, double Vm, double time, double *Ca_JSR_t_ex, double Ca_JSR, double *dyad_SRF_prop_active, double srf_SRF_prop_active, int *srf_init, int *srf_set, const char *SRF_Mode);
+void determine_excitation_state_integrated_0D(Model_variables *var, double Vm, double time, double *Ca_JSR_t_ex, double Ca_JSR, double *dyad_SRF_prop_active, double srf_SRF_prop_active, int *srf_init, int *srf_set, int SRF_mode);
 void calculate_measurement_properties(Model_variables *var, double Vm1, double Vm2, double time, double dt, double APD_threshold, double CaT, double CaSR);
 void calculate_flux_integrals(Cell_parameters p, Model_variables *var, double J_SERCA, double J_NCX, double J_rel, double J_LTCC);
 
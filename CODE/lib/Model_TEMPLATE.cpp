@@ -452,6 +452,7 @@ void initial_conditions_native_speciesCELL_MODEL(State_variables *s, Cell_parame
 // Your model may have more or fewer currents than this template - just follow the procedure and add/delete as appropriate
 
 // !! MUST BE CALLED in lib/Model.c -> compute_model_native()
+// (which switches on p.Model_id: add MODEL_SPECIESCELL_MODEL to lib/Structs.h and to model_id() in lib/Model.c)
 void compute_model_speciesCELL_MODEL_native(Cell_parameters p, Model_variables *var, State_variables *s, double Vm, double dt)
 {
 	compute_reversal_potentials(p, var, s);     // lib/Model.c || replace with model-specific function if different/more complex
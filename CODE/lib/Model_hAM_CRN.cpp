@@ -459,14 +459,14 @@ void compute_Itot_hAM_CRN_native(Cell_parameters p, Model_variables *var, State_
 	compute_ICab_hAM_CRN(p, var, s, Vm);
 
 	// Overwrites for isolated
-	if (strcmp(p.environment, "isolated") == 0)
+	if (p.isolated == true)
 	{   
 		compute_IK1_hAM_WL_isolated(p, var, s, Vm);
 		var->IKr = var->IKs = 0;
 	}
 
 	var->Itot   = var->INa + var->Ito + var->IK1 + var->ICaL + var->IKur + var->INCX + var->INaK + var->ICaP + var->INab + var->ICab + var->IKr + var->IKs;
-	if (strcmp(p.environment, "isolated") == 0)	var->Itot +=  p.AIhyp;
+	if (p.isolated == true)	var->Itot +=  p.AIhyp;
 }
 // End Compute model functions ==================================================================//|
 
@@ -546,14 +546,14 @@ void compute_Itot_hAM_GB_native(Cell_parameters p, Model_variables *var, State_v
 	compute_IKur_hAM_MT(p, var, s, Vm);
 	compute_ICaL_hAM_GB(p, var, s, Vm);
 
-	if (strcmp(p.environment, "isolated") == 0)
+	if (p.isolated == true)
 	{
 		compute_IK1_hAM_WL_isolated(p, var, s, Vm); // overwrites previous calculation
 		var->IKr = var->IKs = 0;
 	}
 
 	var->Itot   = var->INa + var->IK1 + var->INab + var->IKb + var->ICab + var->ICaP + var->INCX + var->INaL + var->Ito + var->ICaL + var->IKur + var->INaK + var->IClCa + var->IClb + var->IKr + var->IKs;
-	if (strcmp(p.environment, "isolated") == 0) var->Itot +=  p.AIhyp;
+	if (p.isolated == true) var->Itot +=  p.AIhyp;
 }
 // End Compute model functions ==================================================================//|
 
@@ -436,14 +436,14 @@ void compute_Itot_hAM_NG_native(Cell_parameters p, Model_variables *var, State_v
 	compute_INab_hAM_NG(p, var, s, Vm);
 	compute_ICab_hAM_NG(p, var, s, Vm);
 
-	if (strcmp(p.environment, "isolated") == 0)
+	if (p.isolated == true)
 	{   
 		compute_IK1_hAM_WL_isolated(p, var, s, Vm);
 		var->IKr = var->IKs = 0;
 	}
 
 	var->Itot   = var->INa + var->Ito + var->IK1 + var->ICaL + var->IKur + var->INCX + var->INaK + var->ICaP + var->INab + var->ICab + var->IKr + var->IKs;
-	if (strcmp(p.environment, "isolated") == 0) var->Itot +=  p.AIhyp; // Ihyp
+	if (p.isolated == true) var->Itot +=  p.AIhyp; // Ihyp
 }
 // End Compute model functions ==================================================================//|
 
@@ -100,14 +100,17 @@ void update_parameters_native_hAM_WL(Cell_parameters *p)
 	if (strcmp(p->Model, "hAM_WL_CRN") == 0	|| strcmp(p->Model, "hAM_CRN_mWL") == 0) // if CRN Ca handling
 	{
 		p->Ca_handling	= "CRN";
+		p->Ca_handling_id = CA_HANDLING_CRN;
 	}
 	else if (strcmp(p->Model, "hAM_WL_GB") == 0 || strcmp(p->Model, "hAM_GB_mWL") == 0) // if GB Ca handling
 	{
 		p->Ca_handling   = "GB";
+		p->Ca_handling_id = CA_HANDLING_GB;
 	}
 	else if (strcmp(p->Model, "hAM_NG_mWL") == 0)	// if NG Ca handling
 	{	
 		p->Ca_handling   = "NG";
+		p->Ca_handling_id = CA_HANDLING_NG;
 	}
 	else
 	{
@@ -542,15 +545,15 @@ void initial_conditions_native_hAM_WL(State_variables *s, Cell_parameters p)
 // Compute model functions ======================================================================\\|
 void compute_model_hAM_WL_native(Cell_parameters p, Model_variables *var, State_variables *s, double Vm, double dt)
 {
-	if (strcmp(p.Ca_handling, "CRN") == 0) s->Cai_sl   =   s->Cai; // so functions can read Cai_sl for CRN or GB
+	if (p.Ca_handling_id == CA_HANDLING_CRN) s->Cai_sl   =   s->Cai; // so functions can read Cai_sl for CRN or GB
 	compute_reversal_potentials(p, var, s);
 	set_gate_rates_hAM_WL_native(p, var, Vm, s->Cai);
 	update_gating_variables_hAM_WL_native(p, var, s, Vm, dt);
 	compute_Itot_hAM_WL_native(p, var, s, Vm);
 
-	if (strcmp(p.Ca_handling, "CRN") == 0) 				comp_homeostasis_hAM_CRN(p, var, s, Vm, dt); 
-	else if (strcmp(p.Ca_handling, "GB") == 0)			comp_homeostasis_hAM_GB(p, var, s, Vm, dt);
-	else if (strcmp(p.Ca_handling, "NG") == 0)			comp_homeostasis_hAM_NG(p, var, s, Vm, dt);
+	if (p.Ca_handling_id == CA_HANDLING_CRN) 				comp_homeostasis_hAM_CRN(p, var, s, Vm, dt); 
+	else if (p.Ca_handling_id == CA_HANDLING_GB)			comp_homeostasis_hAM_GB(p, var, s, Vm, dt);
+	else if (p.Ca_handling_id == CA_HANDLING_NG)			comp_homeostasis_hAM_NG(p, var, s, Vm, dt);
 }
 
 void set_gate_rates_hAM_WL_native(Cell_parameters p, Model_variables *var, double Vm, double Cai)
@@ -561,25 +564,25 @@ void set_gate_rates_hAM_WL_native(Cell_parameters p, Model_variables *var, doubl
 	set_IKur_hAM_WL_rates(p, var, Vm);
 
 	// WL ICaL
-	if (strcmp(p.Model, "hAM_WL_CRN") == 0 || strcmp(p.Model, "hAM_WL_GB") == 0)  set_ICaL_hAM_WL_rates(p, var, Vm, Cai);
+	if (p.Model_id == MODEL_HAM_WL_CRN || p.Model_id == MODEL_HAM_WL_GB)  set_ICaL_hAM_WL_rates(p, var, Vm, Cai);
 	// mWL ICaL
-	else if (strcmp(p.Model, "hAM_CRN_mWL") == 0)   set_ICaL_hAM_CRN_mWL_rates(p, var, Vm, Cai);
-	else if (strcmp(p.Model, "hAM_GB_mWL") == 0)	set_ICaL_hAM_GB_mWL_rates(p, var, Vm, Cai);
-	else if (strcmp(p.Model, "hAM_NG_mWL") == 0)    set_ICaL_hAM_NG_mWL_rates(p, var, Vm, Cai);
+	else if (p.Model_id == MODEL_HAM_CRN_MWL)   set_ICaL_hAM_CRN_mWL_rates(p, var, Vm, Cai);
+	else if (p.Model_id == MODEL_HAM_GB_MWL)	set_ICaL_hAM_GB_mWL_rates(p, var, Vm, Cai);
+	else if (p.Model_id == MODEL_HAM_NG_MWL)    set_ICaL_hAM_NG_mWL_rates(p, var, Vm, Cai);
 
 	// Ca handling model dependent currents (i.e., inherited from native models - not necessarily currents which are involved in Ca handling)
-	if (strcmp(p.Ca_handling, "CRN") == 0)
+	if (p.Ca_handling_id == CA_HANDLING_CRN)
 	{
 		set_IKs_hAM_CRN_rates(p, var, Vm);
 		set_IKr_hAM_CRN_rates(p, var, Vm);	
 	}
-	else if (strcmp(p.Ca_handling, "GB") == 0)
+	else if (p.Ca_handling_id == CA_HANDLING_GB)
 	{
 		set_INaL_hAM_GB_rates(p, var, Vm);
 		set_IKr_hAM_GB_rates(p, var, Vm);
 		set_IKs_hAM_GB_rates(p, var, Vm);
 	}	
-	else if (strcmp(p.Ca_handling, "NG") == 0)
+	else if (p.Ca_handling_id == CA_HANDLING_NG)
 	{
 		set_IKs_hAM_NG_rates(p, var, Vm);
 		set_IKr_hAM_NG_rates(p, var, Vm);
@@ -594,22 +597,22 @@ void update_gating_variables_hAM_WL_native(Cell_parameters p, Model_variables *v
 	update_gates_IKur_hAM_WL(p, var, s, Vm, dt);	
 
 	update_gates_ICaL_hAM_WL(p, var, s, Vm, dt);    // Updates v gates | Ci gates below	
-	if (strcmp(p.Ca_handling, "CRN") == 0) 		update_gates_ICaL_hAM_WL_CRN_ci(p, var, s, Vm, dt);
-	else if (strcmp(p.Ca_handling, "GB") == 0) 	update_gates_ICaL_hAM_WL_GB_ci(p, var, s, Vm, dt);
-	else if (strcmp(p.Ca_handling, "NG") == 0) 	update_gates_ICaL_hAM_WL_NG_ci(p, var, s, Vm, dt);
+	if (p.Ca_handling_id == CA_HANDLING_CRN) 		update_gates_ICaL_hAM_WL_CRN_ci(p, var, s, Vm, dt);
+	else if (p.Ca_handling_id == CA_HANDLING_GB) 	update_gates_ICaL_hAM_WL_GB_ci(p, var, s, Vm, dt);
+	else if (p.Ca_handling_id == CA_HANDLING_NG) 	update_gates_ICaL_hAM_WL_NG_ci(p, var, s, Vm, dt);
 
-	if (strcmp(p.Ca_handling, "CRN") == 0)
+	if (p.Ca_handling_id == CA_HANDLING_CRN)
 	{	
 		update_gates_IKs_hAM_CRN(p, var, s, Vm, dt);
 		update_gates_IKr_hAM_CRN(p, var, s, Vm, dt);
 	}
-	else if (strcmp(p.Ca_handling, "GB") == 0)
+	else if (p.Ca_handling_id == CA_HANDLING_GB)
 	{	
 		update_gates_INaL_hAM_GB(p, var, s, Vm, dt);
 		update_gates_IKr_hAM_GB(p, var, s, Vm, dt);
 		update_gates_IKs_hAM_GB(p, var, s, Vm, dt);		
 	}
-	else if (strcmp(p.Ca_handling, "NG") == 0)
+	else if (p.Ca_handling_id == CA_HANDLING_NG)
 	{
 		update_gates_IKs_hAM_NG(p, var, s, Vm, dt);
 		update_gates_IKr_hAM_NG(p, var, s, Vm, dt);
@@ -625,10 +628,10 @@ void compute_Itot_hAM_WL_native(Cell_parameters p, Model_variables *var, State_v
 	compute_IKur_hAM_WL(p, var, s, Vm);
 
 	// Intact vs isolated IK1
-	if (strcmp(p.environment, "isolated") == 0) compute_IK1_hAM_WL_isolated(p, var, s, Vm);
+	if (p.isolated == true) compute_IK1_hAM_WL_isolated(p, var, s, Vm);
 	else compute_IK1_hAM_WL_intact(p, var, s, Vm);
 
-	if (strcmp(p.Ca_handling, "CRN") == 0)
+	if (p.Ca_handling_id == CA_HANDLING_CRN)
 	{
 		compute_INa_LR(p, var, s, Vm);                  // lib/Model.c
 
@@ -641,13 +644,13 @@ void compute_Itot_hAM_WL_native(Cell_parameters p, Model_variables *var, State_v
 		compute_IKr_hAM_CRN(p, var, s, Vm);
 		compute_IKs_hAM_CRN(p, var, s, Vm);
 
-		if (strcmp(p.Model, "hAM_WL_CRN") == 0)			compute_ICaL_hAM_WL_CRN_bar(p, var, s, Vm, s->Cai);
-		else if (strcmp(p.Model, "hAM_CRN_mWL") == 0)	compute_ICaL_hAM_CRN_mWL(p, var, s, Vm);
+		if (p.Model_id == MODEL_HAM_WL_CRN)			compute_ICaL_hAM_WL_CRN_bar(p, var, s, Vm, s->Cai);
+		else if (p.Model_id == MODEL_HAM_CRN_MWL)	compute_ICaL_hAM_CRN_mWL(p, var, s, Vm);
 
 		// GB currents not in CRN thus need to be zeroed
 		var->IClCa = var->IClb = var->INaL = var->IKb = 0;
 	}
-	else if (strcmp(p.Ca_handling, "GB") == 0)
+	else if (p.Ca_handling_id == CA_HANDLING_GB)
 	{
 		compute_INa_hAM_GB(p, var, s, Vm);
 		compute_INab_hAM_GB(p, var, s, Vm);
@@ -665,14 +668,14 @@ void compute_Itot_hAM_WL_native(Cell_parameters p, Model_variables *var, State_v
 
 		compute_ICaL_hAM_WL_GB_bar(p, var, s, Vm); // common to both ICaL types
 
-		if (strcmp(p.environment, "isolated") == 0)
+		if (p.isolated == true)
 		{
 			var->IClCa 	*= 0.5;
 			var->IClb 	*= 0.5;
 			var->IKb	*= 0.2;
 		}
 	}
-	else if (strcmp(p.Ca_handling, "NG") == 0)
+	else if (p.Ca_handling_id == CA_HANDLING_NG)
 	{
 		compute_INa_LR(p, var, s, Vm);                  // lib/Model.c
 		compute_IKr_hAM_NG(p, var, s, Vm);
@@ -689,11 +692,11 @@ void compute_Itot_hAM_WL_native(Cell_parameters p, Model_variables *var, State_v
 		var->IClCa = var->IClb = var->INaL = var->IKb = 0;
 	}
 
-	if (strcmp(p.environment, "isolated") == 0) var->IKs = var->IKr = 0;
+	if (p.isolated == true) var->IKs = var->IKr = 0;
 
 	var->Itot   = var->INa + var->IK1 + var->INab + var->ICab + var->ICaP + var->INCX + var->Ito + var->ICaL + var->IKur + var->INaK + var->IKr + var->IKs + var->IClCa + var->IClb + var->INaL + var->IKb;
 
-	if (strcmp(p.environment, "isolated") == 0) var->Itot 	+=  p.AIhyp; 	// add hyperpolarizing current if isolated conditions
+	if (p.isolated == true) var->Itot 	+=  p.AIhyp; 	// add hyperpolarizing current if isolated conditions
 }
 // End Compute model functions ==================================================================//|
 
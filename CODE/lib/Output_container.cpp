@@ -0,0 +1,527 @@
+// Source code associated with  ===========================  //
+// "Multi-scale cardiac simulation framework" =============  //
+// For simulation of cardiac cellular and tissue dynamics =  //
+// from the spatial cellular to full organ scales. ========  //
+// With implementation of multiple, published cell models =  //
+// as well as novel models developed in my lab. ===========  //
+// ========================================================  //
+// This file: Single-file chunked container ===============  //
+// for spatial time-series outputs ========================  //
+// ========================================================  //
+// GNU 3 LICENSE TEXT =====================================  //
+// COPYRIGHT (C) 2016-2019 MICHAEL A. COLMAN ==============  //
+// THIS PROGRAM IS FREE SOFTWARE: YOU CAN REDISTRIBUTE IT =  //
+// AND/OR MODIFY IT UNDER THE TERMS OF THE GNU GENERAL ====  //
+// PUBLIC LICENSE AS PUBLISHED BY THE FREE SOFTWARE =======  //
+// FOUNDATION, EITHER VERSION 3 OF THE LICENSE, OR (AT YOUR  //
+// OPTION) ANY LATER VERSION. =============================  //
+// THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE=  //
+// USEFUL, BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE =====  //
+// IMPLIED WARRANTY OF MERCHANTABILITY OR FITNESS FOR A ===  //
+// PARTICULAR PURPOSE.  SEE THE GNU GENERAL PUBLIC LICENSE=  //
+// FOR MORE DETAILS. ======================================  //
+// YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL =====  //
+// PUBLIC LICENSE ALONG WITH THIS PROGRAM.  IF NOT, SEE ===  //
+// <https://www.gnu.org/licenses/>. =======================  //
+// ========================================================  //
+// ADDITIONAL LICENSE TEXT ================================  //
+// THIS SOFTWARE IS PROVIDED OPEN SOURCE AND MAY BE FREELY=  //
+// USED, DISTRIBUTED AND UPDATED, PROVIDED: ===============  //
+//  (i) THE APPROPRIATE WORK(S) IS(ARE) CITED. THIS =======  //
+//      PERTAINS TO THE CITATION OF COLMAN 2019 PLOS COMP =  //
+//      BIOL (FOR THIS IMPLEMTATION) AND ALL WORKS ========  //
+//      ASSOCIATED WITH THE SPECIFIC MODELS AND COMPONENTS=  //
+//      USED IN PARTICULAR SIMULATIONS. IT IS THE USER'S ==  //
+//      RESPONSIBILITY TO ENSURE ALL RELEVANT WORKS ARE ===  //
+//      CITED. PLEASE SEE FULL DOCUMENTATION AND ON-SCREEN=  //
+//      DISCLAIMER OUTPUTS FOR A GUIDE. ===================  //
+//  (ii) ALL OF THIS TEXT IS RETAINED WITHIN OR ASSOCIATED=  //
+//      WITH THE SOURCE CODE AND/OR BINARY FORM OF THE ====  //
+//      SOFTWARE. =========================================  //
+// ========================================================  //
+// ANY INTENDED COMMERCIAL USE OF THIS SOFTWARE MUST BE BY   //
+// EXPRESS PERMISSION OF MICHAEL A COLMAN ONLY. IN NO EVENT  //
+// ARE THE COPYRIGHT HOLDERS LIABLE FOR ANY DIRECT, =======  //
+// INDIRECT INCIDENTAL, SPECIAL, EXEMPLARY OR CONSEQUENTIAL  //
+// DAMAGES ASSOCIATED WITH USE OF THIS SOFTWARE ===========  //
+// ========================================================  //
+// THIS SOFTWARE CONTAINS IMPLEMENTATIONS OF MODELS AND ===  //
+// COMPONENTS WHICH I (MICHAEL COLMAN) DID NOT DEVELOP.====  //
+// ALL OF THESE COMPONENTS HAVE BEEN CODED FROM PROVIDED ==  //
+// SOURCE CODE OR INFORMATION IN THE PUBLICATIONS. ========  //
+// I CLAIM NO RIGHTS OR INTELLECTUAL PROPERTY OWNERSHIP ===  //
+// FOR THESE MODELS AND COMPONENTS, OTHER THAN THEIR ======  //
+// SPECIFIC IMPLEMENTATION IN THIS CODE PACKAGE. FURTHER TO  //
+// THE ABOVE STATEMENT, ANY INDTENDED COMMERCIAL USE OF ===  //
+// THOSE COMPONENTS MUST BE BY EXPRESS PERMISSION OF THE ==  //
+// ORIGINAL COPYRIGHT HOLDERS. ============================  //
+// WHERE IMPLEMENTED FROM PROVIDED CODE, ANY DISCLAIMERS ==  //
+// PRESENT IN THE ORIGINAL CODE HAVE BEEN RETAINED IN THE =  //
+// RELEVANT FILE. =========================================  //
+// ========================================================  //
+// Contact: m.a.colman@leeds.ac.uk ========================  //
+// For updates, corrections etc, please check: ============  //
+// 1. http://physicsoftheheart.com/ =======================  //
+// 2. https://github.com/michaelcolman ====================  //
+// ========================================================  //
+
+#include "Output_container.h"
+#include "Structs.h"
+#include "Spatial_coupling.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#ifndef _WIN32
+#include <unistd.h>
+#else
+#include <io.h>
+#endif
+#ifdef MSCSF_ZLIB
+#include <zlib.h>
+#endif
+
+// Function list ================================================================================\\|
+//	Writing
+//	    output_container_create()
+//	    output_container_resume()
+//	    output_container_append()
+//	    output_container_finalise()
+//	    output_container_geometry()
+//
+//	Reading
+//	    output_container_open()
+//	    output_container_find()
+//	    output_container_read_frame()
+//	    output_container_close()
+//
+//	Internal
+//	    oc_write_header()
+//	    oc_read_header()
+//	    oc_checksum()
+//	    oc_scan_frames()
+//	    oc_load_index()
+//	    oc_index_add()
+//	    oc_index_compare()
+// End Function list ============================================================================//|
+
+#define OC_VERSION          1
+#define OC_FRAME_HEADER     52  // "FRM1"(4) var(16) count(4) compression(4) raw(8) stored(8) checksum(4) pad(4)
+
+// Internal =====================================================================================\\|
+// FNV-1a checksum of stored frame data (detects frames truncated or corrupted by a killed run)
+static uint32_t oc_checksum(const unsigned char *data, size_t n)
+{
+	uint32_t h = 2166136261u;
+	for (size_t i = 0; i < n; i++) { h ^= data[i]; h *= 16777619u; }
+	return h;
+}
+
+static void oc_write_header(Output_container *oc)
+{
+	unsigned char h[OC_HEADER_SIZE];
+	int32_t header_size = OC_HEADER_SIZE;
+	memset(h, 0, OC_HEADER_SIZE);
+	memcpy(h, "MSCSFTS", 8);
+	memcpy(h + 8,  &oc->version, 4);
+	memcpy(h + 12, &header_size, 4);
+	memcpy(h + 16, &oc->NX, 4);
+	memcpy(h + 20, &oc->NY, 4);
+	memcpy(h + 24, &oc->NZ, 4);
+	memcpy(h + 28, &oc->N, 4);
+	memcpy(h + 32, &oc->compression, 4);
+	memcpy(h + 36, &oc->finalised, 4);
+	memcpy(h + 40, &oc->index_offset, 8);
+	memcpy(h + 48, &oc->Nframes, 8);
+	fseek(oc->file, 0, SEEK_SET);
+	fwrite(h, 1, OC_HEADER_SIZE, oc->file);
+}
+
+static void oc_read_header(Output_container *oc)
+{
+	unsigned char h[OC_HEADER_SIZE];
+	if (fread(h, 1, OC_HEADER_SIZE, oc->file) != OC_HEADER_SIZE || memcmp(h, "MSCSFTS", 8) != 0)
+	{
+		printf("ERROR: %s is not a spatial output container file\n", oc->filename);
+		exit(1);
+	}
+	memcpy(&oc->version, h + 8, 4);
+	memcpy(&oc->NX, h + 16, 4);
+	memcpy(&oc->NY, h + 20, 4);
+	memcpy(&oc->NZ, h + 24, 4);
+	memcpy(&oc->N, h + 28, 4);
+	memcpy(&oc->compression, h + 32, 4);
+	memcpy(&oc->finalised, h + 36, 4);
+	memcpy(&oc->index_offset, h + 40, 8);
+	memcpy(&oc->Nframes, h + 48, 8);
+	if (oc->version > OC_VERSION)
+	{
+		printf("ERROR: container %s has version %d; this code reads up to version %d\n", oc->filename, oc->version, OC_VERSION);
+		exit(1);
+	}
+}
+
+static void oc_index_add(Output_container *oc, const char *string, int count, int64_t offset)
+{
+	if (oc->Nframes == oc->Nframes_alloc)
+	{
+		oc->Nframes_alloc = (oc->Nframes_alloc == 0) ? 1024 : 2*oc->Nframes_alloc;
+		oc->index = (Output_container_entry*)realloc(oc->index, oc->Nframes_alloc*sizeof(Output_container_entry));
+	}
+	Output_container_entry *e = &oc->index[oc->Nframes];
+	memset(e->variable, 0, OC_VAR_LENGTH);
+	strncpy(e->variable, string, OC_VAR_LENGTH-1);
+	e->count	= count;
+	e->offset	= offset;
+	oc->Nframes++;
+}
+
+static int oc_index_compare(const void *a, const void *b)
+{
+	const Output_container_entry *ea = (const Output_container_entry*)a;
+	const Output_container_entry *eb = (const Output_container_entry*)b;
+	int c = strncmp(ea->variable, eb->variable, OC_VAR_LENGTH);
+	if (c != 0) return c;
+	return (ea->count > eb->count) - (ea->count < eb->count);
+}
+
+// Rebuild index of an unfinalised container from frame records; stops at first incomplete frame.
+// Returns the end of the last complete frame.
+static int64_t oc_scan_frames(Output_container *oc, int64_t data_start)
+{
+	unsigned char fh[OC_FRAME_HEADER];
+	unsigned char *buffer = NULL;
+	size_t buffer_size = 0;
+	int64_t offset = data_start;
+
+	oc->Nframes = 0;
+	fseek(oc->file, offset, SEEK_SET);
+	while (fread(fh, 1, OC_FRAME_HEADER, oc->file) == OC_FRAME_HEADER && memcmp(fh, "FRM1", 4) == 0)
+	{
+		char variable[OC_VAR_LENGTH];
+		int32_t count;
+		int64_t stored;
+		uint32_t checksum;
+		memcpy(variable, fh + 4, OC_VAR_LENGTH);
+		memcpy(&count, fh + 20, 4);
+		memcpy(&stored, fh + 36, 8);
+		memcpy(&checksum, fh + 44, 4);
+		if (stored < 0) break;
+		if ((size_t)stored > buffer_size) { buffer_size = stored; buffer = (unsigned char*)realloc(buffer, buffer_size); }
+		if (fread(buffer, 1, stored, oc->file) != (size_t)stored) break;
+		if (oc_checksum(buffer, stored) != checksum) break;
+		variable[OC_VAR_LENGTH-1] = '\0';
+		oc_index_add(oc, variable, count, offset);
+		offset += OC_FRAME_HEADER + stored;
+	}
+	free(buffer);
+	printf("WARNING: container %s was not finalised (run did not complete); recovered %lld complete frames\n", oc->filename, (long long)oc->Nframes);
+	return offset;
+}
+
+// Frame index in file (write) order, from the index of a finalised container or by scanning the
+// frame records; returns the end of the frame data
+static int64_t oc_load_index(Output_container *oc)
+{
+	int64_t data_start = OC_HEADER_SIZE + 2*(int64_t)oc->N*sizeof(int32_t);
+	if (oc->finalised != 1) return oc_scan_frames(oc, data_start);
+
+	char magic[4];
+	int64_t Nframes;
+	fseek(oc->file, oc->index_offset, SEEK_SET);
+	if (fread(magic, 1, 4, oc->file) != 4 || memcmp(magic, "IDX1", 4) != 0 || fread(&Nframes, sizeof(int64_t), 1, oc->file) != 1)
+	{
+		printf("ERROR: container %s index is corrupt\n", oc->filename);
+		exit(1);
+	}
+	oc->Nframes = 0;
+	for (int64_t i = 0; i < Nframes; i++)
+	{
+		char variable[OC_VAR_LENGTH];
+		int32_t count;
+		int64_t offset;
+		fread(variable, 1, OC_VAR_LENGTH, oc->file);
+		fread(&count, sizeof(int32_t), 1, oc->file);
+		fread(&offset, sizeof(int64_t), 1, oc->file);
+		variable[OC_VAR_LENGTH-1] = '\0';
+		oc_index_add(oc, variable, count, offset);
+	}
+	return oc->index_offset;
+}
+// End Internal =================================================================================//|
+
+// Writing ======================================================================================\\|
+// Create container dir/dir2/name, with geometry and cell order
+void output_container_create(Output_container *oc, const char *dir, const char *dir2, const char *name, SC_variables sc, const char *compression)
+{
+	sprintf(oc->filename, "%s/%s/%s", dir, dir2, name);
+	oc->file = fopen(oc->filename, "w+b");
+	if (oc->file == NULL)
+	{
+		printf("ERROR: Cannot create spatial output container %s\n", oc->filename);
+		exit(1);
+	}
+	oc->write			= true;
+	oc->version			= OC_VERSION;
+	oc->NX				= sc.NX;
+	oc->NY				= sc.NY;
+	oc->NZ				= sc.NZ;
+	oc->N				= sc.N;
+	oc->compression		= (strcmp(compression, "zlib") == 0) ? 1 : 0;
+	oc->finalised		= 0;
+	oc->index_offset	= 0;
+	oc->index			= NULL;
+	oc->Nframes			= 0;
+	oc->Nframes_alloc	= 0;
+	oc->cell_box_index	= NULL;
+	oc->celltype		= NULL;
+	oc_write_header(oc);
+
+	// Geometry: box index and celltype of each cell, in cell (1D array) order
+	int32_t *box_index	= new int32_t [sc.N];
+	int32_t *celltype	= new int32_t [sc.N];
+	int cell_count = 0;
+	for (int idx = 0; idx < sc.NX*sc.NY*sc.NZ; idx++)
+	{
+		if (SC_geo(&sc, idx) > 0)
+		{
+			box_index[cell_count]	= idx;
+			celltype[cell_count]	= SC_geo(&sc, idx);
+			cell_count++;
+		}
+	}
+	fwrite(box_index, sizeof(int32_t), sc.N, oc->file);
+	fwrite(celltype, sizeof(int32_t), sc.N, oc->file);
+	delete [] box_index;
+	delete [] celltype;
+	fflush(oc->file);
+	oc->end_offset = OC_HEADER_SIZE + 2*(int64_t)sc.N*sizeof(int32_t);
+}
+
+// Reopen container dir/dir2/name of an interrupted or completed run to continue it from a
+// checkpoint: frames from output count outcount on are dropped (and cut from the file), and 
+// new frames are appended after the last kept frame. Created as new if it does not exist.
+void output_container_resume(Output_container *oc, const char *dir, const char *dir2, const char *name, SC_variables sc, const char *compression, int outcount)
+{
+	sprintf(oc->filename, "%s/%s/%s", dir, dir2, name);
+	oc->file = fopen(oc->filename, "r+b");
+	if (oc->file == NULL)
+	{
+		printf("WARNING: container %s not found; restarted frames are written to a new container\n", oc->filename);
+		output_container_create(oc, dir, dir2, name, sc, compression);
+		return;
+	}
+	oc->write			= true;
+	oc->index			= NULL;
+	oc->Nframes			= 0;
+	oc->Nframes_alloc	= 0;
+	oc->cell_box_index	= NULL;
+	oc->celltype		= NULL;
+	oc_read_header(oc);
+	if (oc->NX != sc.NX || oc->NY != sc.NY || oc->NZ != sc.NZ || oc->N != sc.N)
+	{
+		printf("ERROR: container %s (%d x %d x %d, N = %d) is not from this geometry (%d x %d x %d, N = %d)\n", oc->filename, oc->NX, oc->NY, oc->NZ, oc->N, sc.NX, sc.NY, sc.NZ, sc.N);
+		exit(1);
+	}
+
+	// Frames are in output order: keep those before the restart point
+	int64_t end = oc_load_index(oc);
+	int64_t kept = 0;
+	while (kept < oc->Nframes && oc->index[kept].count < outcount) kept++;
+	if (kept < oc->Nframes) end = oc->index[kept].offset;
+	printf("Container %s resumed at output %d: %lld frames kept, %lld dropped\n", oc->filename, outcount, (long long)kept, (long long)(oc->Nframes - kept));
+	oc->Nframes			= kept;
+	oc->end_offset		= end;
+	oc->finalised		= 0;
+	oc->index_offset	= 0;
+	oc_write_header(oc);
+	fflush(oc->file);
+#ifndef _WIN32
+	int cut = ftruncate(fileno(oc->file), (off_t)end);
+#else
+	int cut = _chsize_s(_fileno(oc->file), end);
+#endif
+	if (cut != 0)
+	{
+		printf("ERROR: cannot truncate container %s to the restart point\n", oc->filename);
+		exit(1);
+	}
+}
+
+// Append one frame (one variable at one output count) as a single record
+void output_container_append(Output_container *oc, const char *string, double *variable, int count)
+{
+	int64_t raw		= (int64_t)oc->N*sizeof(double);
+	int64_t stored	= raw;
+	unsigned char *data = (unsigned char*)variable;
+	unsigned char *cdata = NULL;
+	int32_t comp	= 0;
+
+#ifdef MSCSF_ZLIB
+	if (oc->compression == 1)
+	{
+		uLongf clen = compressBound(raw);
+		cdata = (unsigned char*)malloc(clen);
+		if (compress2(cdata, &clen, (const Bytef*)variable, raw, 1) != Z_OK)
+		{
+			printf("ERROR: zlib compression of container frame failed\n");
+			exit(1);
+		}
+		if ((int64_t)clen < raw) { data = cdata; stored = clen; comp = 1; }   // only store compressed if smaller
+	}
+#endif
+
+	unsigned char fh[OC_FRAME_HEADER];
+	uint32_t checksum = oc_checksum(data, stored);
+	memset(fh, 0, OC_FRAME_HEADER);
+	memcpy(fh, "FRM1", 4);
+	strncpy((char*)fh + 4, string, OC_VAR_LENGTH-1);
+	memcpy(fh + 20, &count, 4);
+	memcpy(fh + 24, &comp, 4);
+	memcpy(fh + 28, &raw, 8);
+	memcpy(fh + 36, &stored, 8);
+	memcpy(fh + 44, &checksum, 4);
+
+	fseek(oc->file, oc->end_offset, SEEK_SET);
+	fwrite(fh, 1, OC_FRAME_HEADER, oc->file);
+	fwrite(data, 1, stored, oc->file);
+	fflush(oc->file);   // complete frame handed to the OS before the next one starts
+	free(cdata);
+
+	oc_index_add(oc, string, count, oc->end_offset);
+	oc->end_offset += OC_FRAME_HEADER + stored;
+}
+
+// Write index, mark header as finalised and close
+void output_container_finalise(Output_container *oc)
+{
+	int64_t Nframes = oc->Nframes;
+	fseek(oc->file, oc->end_offset, SEEK_SET);
+	fwrite("IDX1", 1, 4, oc->file);
+	fwrite(&Nframes, sizeof(int64_t), 1, oc->file);
+	for (int64_t i = 0; i < oc->Nframes; i++)
+	{
+		fwrite(oc->index[i].variable, 1, OC_VAR_LENGTH, oc->file);
+		fwrite(&oc->index[i].count, sizeof(int32_t), 1, oc->file);
+		fwrite(&oc->index[i].offset, sizeof(int64_t), 1, oc->file);
+	}
+	fflush(oc->file);
+
+	oc->index_offset	= oc->end_offset;
+	oc->finalised		= 1;
+	oc_write_header(oc);
+	fclose(oc->file);
+	free(oc->index);
+	oc->index = NULL;
+}
+
+// Geometry sidecar: container with no frames, read by the standalone converter
+void output_container_geometry(const char *dir, const char *dir2, SC_variables sc)
+{
+	Output_container oc;
+	output_container_create(&oc, dir, dir2, "Geometry_index.msc", sc, "Off");
+	output_container_finalise(&oc);
+}
+// End Writing ==================================================================================//|
+
+// Reading ======================================================================================\\|
+// Open container dir/dir2/name and load (or, if not finalised, rebuild) the frame index
+void output_container_open(Output_container *oc, const char *dir, const char *dir2, const char *name)
+{
+	sprintf(oc->filename, "%s/%s/%s", dir, dir2, name);
+	oc->file = fopen(oc->filename, "rb");
+	if (oc->file == NULL)
+	{
+		printf("Cannot load container file %s; are the directories correct? Does the file exist?\n", oc->filename);
+		exit(1);
+	}
+	oc->write			= false;
+	oc->index			= NULL;
+	oc->Nframes_alloc	= 0;
+	oc_read_header(oc);
+
+	oc->cell_box_index	= new int32_t [oc->N];
+	oc->celltype		= new int32_t [oc->N];
+	fseek(oc->file, OC_HEADER_SIZE, SEEK_SET);
+	if (fread(oc->cell_box_index, sizeof(int32_t), oc->N, oc->file) != (size_t)oc->N || fread(oc->celltype, sizeof(int32_t), oc->N, oc->file) != (size_t)oc->N)
+	{
+		printf("ERROR: container %s is truncated (geometry incomplete)\n", oc->filename);
+		exit(1);
+	}
+
+	oc_load_index(oc);
+
+	// Sorted by variable then count for random access
+	qsort(oc->index, oc->Nframes, sizeof(Output_container_entry), oc_index_compare);
+}
+
+// Index entry of variable at count, or -1 if not present
+int output_container_find(Output_container *oc, const char *string, int count)
+{
+	Output_container_entry key;
+	memset(key.variable, 0, OC_VAR_LENGTH);
+	strncpy(key.variable, string, OC_VAR_LENGTH-1);
+	key.count = count;
+	Output_container_entry *e = (Output_container_entry*)bsearch(&key, oc->index, oc->Nframes, sizeof(Output_container_entry), oc_index_compare);
+	if (e == NULL) return -1;
+	return (int)(e - oc->index);
+}
+
+// Random access read of one frame into variable (length N)
+void output_container_read_frame(Output_container *oc, const char *string, int count, double *variable)
+{
+	int i = output_container_find(oc, string, count);
+	if (i < 0)
+	{
+		printf("Frame %s %04d is not in container %s\n", string, count, oc->filename);
+		exit(1);
+	}
+
+	unsigned char fh[OC_FRAME_HEADER];
+	int32_t comp;
+	int64_t raw, stored;
+	uint32_t checksum;
+	fseek(oc->file, oc->index[i].offset, SEEK_SET);
+	fread(fh, 1, OC_FRAME_HEADER, oc->file);
+	memcpy(&comp, fh + 24, 4);
+	memcpy(&raw, fh + 28, 8);
+	memcpy(&stored, fh + 36, 8);
+	memcpy(&checksum, fh + 44, 4);
+	if (raw != (int64_t)oc->N*(int64_t)sizeof(double))
+	{
+		printf("ERROR: frame %s %04d in %s has unexpected size\n", string, count, oc->filename);
+		exit(1);
+	}
+
+	unsigned char *data = (unsigned char*)malloc(stored);
+	if (fread(data, 1, stored, oc->file) != (size_t)stored || oc_checksum(data, stored) != checksum)
+	{
+		printf("ERROR: frame %s %04d in %s is corrupt\n", string, count, oc->filename);
+		exit(1);
+	}
+	if (comp == 0) memcpy(variable, data, raw);
+	else
+	{
+#ifdef MSCSF_ZLIB
+		uLongf len = raw;
+		if (uncompress((Bytef*)variable, &len, data, stored) != Z_OK || (int64_t)len != raw)
+		{
+			printf("ERROR: cannot decompress frame %s %04d in %s\n", string, count, oc->filename);
+			exit(1);
+		}
+#else
+		printf("ERROR: container %s holds zlib compressed frames but code was compiled without zlib (see Makefile)\n", oc->filename);
+		exit(1);
+#endif
+	}
+	free(data);
+}
+
+void output_container_close(Output_container *oc)
+{
+	fclose(oc->file);
+	free(oc->index);
+	delete [] oc->cell_box_index;
+	delete [] oc->celltype;
+}
+// End Reading ==================================================================================//|
@@ -0,0 +1,132 @@
+// Source code associated with  ===========================  //
+// "Multi-scale cardiac simulation framework" =============  //
+// For simulation of cardiac cellular and tissue dynamics =  //
+// from the spatial cellular to full organ scales. ========  //
+// With implementation of multiple, published cell models =  //
+// as well as novel models developed in my lab. ===========  //
+// ========================================================  //
+// This file: Single-file chunked container ===============  //
+// for spatial time-series outputs, header ================  //
+// ========================================================  //
+// GNU 3 LICENSE TEXT =====================================  //
+// COPYRIGHT (C) 2016-2019 MICHAEL A. COLMAN ==============  //
+// THIS PROGRAM IS FREE SOFTWARE: YOU CAN REDISTRIBUTE IT =  //
+// AND/OR MODIFY IT UNDER THE TERMS OF THE GNU GENERAL ====  //
+// PUBLIC LICENSE AS PUBLISHED BY THE FREE SOFTWARE =======  //
+// FOUNDATION, EITHER VERSION 3 OF THE LICENSE, OR (AT YOUR  //
+// OPTION) ANY LATER VERSION. =============================  //
+// THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE=  //
+// USEFUL, BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE =====  //
+// IMPLIED WARRANTY OF MERCHANTABILITY OR FITNESS FOR A ===  //
+// PARTICULAR PURPOSE.  SEE THE GNU GENERAL PUBLIC LICENSE=  //
+// FOR MORE DETAILS. ======================================  //
+// YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL =====  //
+// PUBLIC LICENSE ALONG WITH THIS PROGRAM.  IF NOT, SEE ===  //
+// <https://www.gnu.org/licenses/>. =======================  //
+// ========================================================  //
+// ADDITIONAL LICENSE TEXT ================================  //
+// THIS SOFTWARE IS PROVIDED OPEN SOURCE AND MAY BE FREELY=  //
+// USED, DISTRIBUTED AND UPDATED, PROVIDED: ===============  //
+//  (i) THE APPROPRIATE WORK(S) IS(ARE) CITED. THIS =======  //
+//      PERTAINS TO THE CITATION OF COLMAN 2019 PLOS COMP =  //
+//      BIOL (FOR THIS IMPLEMTATION) AND ALL WORKS ========  //
+//      ASSOCIATED WITH THE SPECIFIC MODELS AND COMPONENTS=  //
+//      USED IN PARTICULAR SIMULATIONS. IT IS THE USER'S ==  //
+//      RESPONSIBILITY TO ENSURE ALL RELEVANT WORKS ARE ===  //
+//      CITED. PLEASE SEE FULL DOCUMENTATION AND ON-SCREEN=  //
+//      DISCLAIMER OUTPUTS FOR A GUIDE. ===================  //
+//  (ii) ALL OF THIS TEXT IS RETAINED WITHIN OR ASSOCIATED=  //
+//      WITH THE SOURCE CODE AND/OR BINARY FORM OF THE ====  //
+//      SOFTWARE. =========================================  //
+// ========================================================  //
+// ANY INTENDED COMMERCIAL USE OF THIS SOFTWARE MUST BE BY   //
+// EXPRESS PERMISSION OF MICHAEL A COLMAN ONLY. IN NO EVENT  //
+// ARE THE COPYRIGHT HOLDERS LIABLE FOR ANY DIRECT, =======  //
+// INDIRECT INCIDENTAL, SPECIAL, EXEMPLARY OR CONSEQUENTIAL  //
+// DAMAGES ASSOCIATED WITH USE OF THIS SOFTWARE ===========  //
+// ========================================================  //
+// THIS SOFTWARE CONTAINS IMPLEMENTATIONS OF MODELS AND ===  //
+// COMPONENTS WHICH I (MICHAEL COLMAN) DID NOT DEVELOP.====  //
+// ALL OF THESE COMPONENTS HAVE BEEN CODED FROM PROVIDED ==  //
+// SOURCE CODE OR INFORMATION IN THE PUBLICATIONS. ========  //
+// I CLAIM NO RIGHTS OR INTELLECTUAL PROPERTY OWNERSHIP ===  //
+// FOR THESE MODELS AND COMPONENTS, OTHER THAN THEIR ======  //
+// SPECIFIC IMPLEMENTATION IN THIS CODE PACKAGE. FURTHER TO  //
+// THE ABOVE STATEMENT, ANY INDTENDED COMMERCIAL USE OF ===  //
+// THOSE COMPONENTS MUST BE BY EXPRESS PERMISSION OF THE ==  //
+// ORIGINAL COPYRIGHT HOLDERS. ============================  //
+// WHERE IMPLEMENTED FROM PROVIDED CODE, ANY DISCLAIMERS ==  //
+// PRESENT IN THE ORIGINAL CODE HAVE BEEN RETAINED IN THE =  //
+// RELEVANT FILE. =========================================  //
+// ========================================================  //
+// Contact: m.a.colman@leeds.ac.uk ========================  //
+// For updates, corrections etc, please check: ============  //
+// 1. http://physicsoftheheart.com/ =======================  //
+// 2. https://github.com/michaelcolman ====================  //
+// ========================================================  //
+
+#ifndef OUTPUT_CONTAINER_H
+#define OUTPUT_CONTAINER_H
+
+#include "Structs.h"
+#include <stdio.h>
+#include <stdint.h>
+
+// File layout (native byte order, all offsets in bytes from start of file) =====================\\|
+//  Header      (OC_HEADER_SIZE bytes): magic "MSCSFTS", version, NX, NY, NZ, N, compression, 
+//                                      finalised flag, index offset, number of frames
+//  Geometry    int32 box index of each cell [N], int32 celltype of each cell [N] (cell order)
+//  Frames      per frame: record header (magic "FRM1", variable, count, compression, raw and 
+//              stored bytes, checksum) followed by the stored (raw or zlib) data
+//  Index       magic "IDX1", Nframes, then {variable, count, offset} per frame
+// The header is rewritten with the index offset on finalisation. If a run is killed before that, 
+// the reader rebuilds the index by scanning frame records and discards any incomplete final frame.
+// A container with no frames (Geometry_index.msc) is written alongside .bin outputs as a geometry 
+// sidecar, so outputs can be converted without re-running the tissue/cell setup.
+// A run restarted from a checkpoint reopens the container, drops the frames from the restored 
+// output count on, and appends.
+// End File layout ==============================================================================//|
+
+#define OC_HEADER_SIZE      128
+#define OC_VAR_LENGTH       16
+
+// Frame index entry
+typedef struct{
+	char        variable[OC_VAR_LENGTH];
+	int32_t     count;
+	int64_t     offset;     // offset of frame record
+}Output_container_entry;
+
+// Container (writing or reading)
+typedef struct{
+	FILE        *file;
+	char        filename[1000];
+	bool        write;          // opened for writing
+	int32_t     version;
+	int32_t     NX, NY, NZ, N;
+	int32_t     compression;    // 0 = none, 1 = zlib (per frame)
+	int32_t     finalised;
+	int64_t     index_offset;
+	int32_t     *cell_box_index;    // box index of each cell (read only)
+	int32_t     *celltype;          // celltype of each cell (read only)
+
+	Output_container_entry *index;
+	int64_t     Nframes;
+	int64_t     Nframes_alloc;
+	int64_t     end_offset;     // append position (write)
+}Output_container;
+
+// Writing
+void output_container_create(Output_container *oc, const char *dir, const char *dir2, const char *name, SC_variables sc, const char *compression);
+void output_container_resume(Output_container *oc, const char *dir, const char *dir2, const char *name, SC_variables sc, const char *compression, int outcount);
+void output_container_append(Output_container *oc, const char *string, double *variable, int count);
+void output_container_finalise(Output_container *oc);
+void output_container_geometry(const char *dir, const char *dir2, SC_variables sc);
+
+// Reading
+void output_container_open(Output_container *oc, const char *dir, const char *dir2, const char *name);
+int  output_container_find(Output_container *oc, const char *string, int count);
+void output_container_read_frame(Output_container *oc, const char *string, int count, double *variable);
+void output_container_close(Output_container *oc);
+
+#endif
@@ -0,0 +1,358 @@
+// Source code associated with  ===========================  //
+// "Multi-scale cardiac simulation framework" =============  //
+// For simulation of cardiac cellular and tissue dynamics =  //
+// from the spatial cellular to full organ scales. ========  //
+// With implementation of multiple, published cell models =  //
+// as well as novel models developed in my lab. ===========  //
+// ========================================================  //
+// This file: Quantised, down-sampled region ==============  //
+// of interest spatial outputs ============================  //
+// ========================================================  //
+// GNU 3 LICENSE TEXT =====================================  //
+// COPYRIGHT (C) 2016-2019 MICHAEL A. COLMAN ==============  //
+// THIS PROGRAM IS FREE SOFTWARE: YOU CAN REDISTRIBUTE IT =  //
+// AND/OR MODIFY IT UNDER THE TERMS OF THE GNU GENERAL ====  //
+// PUBLIC LICENSE AS PUBLISHED BY THE FREE SOFTWARE =======  //
+// FOUNDATION, EITHER VERSION 3 OF THE LICENSE, OR (AT YOUR  //
+// OPTION) ANY LATER VERSION. =============================  //
+// THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE=  //
+// USEFUL, BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE =====  //
+// IMPLIED WARRANTY OF MERCHANTABILITY OR FITNESS FOR A ===  //
+// PARTICULAR PURPOSE.  SEE THE GNU GENERAL PUBLIC LICENSE=  //
+// FOR MORE DETAILS. ======================================  //
+// YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL =====  //
+// PUBLIC LICENSE ALONG WITH THIS PROGRAM.  IF NOT, SEE ===  //
+// <https://www.gnu.org/licenses/>. =======================  //
+// ========================================================  //
+// ADDITIONAL LICENSE TEXT ================================  //
+// THIS SOFTWARE IS PROVIDED OPEN SOURCE AND MAY BE FREELY=  //
+// USED, DISTRIBUTED AND UPDATED, PROVIDED: ===============  //
+//  (i) THE APPROPRIATE WORK(S) IS(ARE) CITED. THIS =======  //
+//      PERTAINS TO THE CITATION OF COLMAN 2019 PLOS COMP =  //
+//      BIOL (FOR THIS IMPLEMTATION) AND ALL WORKS ========  //
+//      ASSOCIATED WITH THE SPECIFIC MODELS AND COMPONENTS=  //
+//      USED IN PARTICULAR SIMULATIONS. IT IS THE USER'S ==  //
+//      RESPONSIBILITY TO ENSURE ALL RELEVANT WORKS ARE ===  //
+//      CITED. PLEASE SEE FULL DOCUMENTATION AND ON-SCREEN=  //
+//      DISCLAIMER OUTPUTS FOR A GUIDE. ===================  //
+//  (ii) ALL OF THIS TEXT IS RETAINED WITHIN OR ASSOCIATED=  //
+//      WITH THE SOURCE CODE AND/OR BINARY FORM OF THE ====  //
+//      SOFTWARE. =========================================  //
+// ========================================================  //
+// ANY INTENDED COMMERCIAL USE OF THIS SOFTWARE MUST BE BY   //
+// EXPRESS PERMISSION OF MICHAEL A COLMAN ONLY. IN NO EVENT  //
+// ARE THE COPYRIGHT HOLDERS LIABLE FOR ANY DIRECT, =======  //
+// INDIRECT INCIDENTAL, SPECIAL, EXEMPLARY OR CONSEQUENTIAL  //
+// DAMAGES ASSOCIATED WITH USE OF THIS SOFTWARE ===========  //
+// ========================================================  //
+// THIS SOFTWARE CONTAINS IMPLEMENTATIONS OF MODELS AND ===  //
+// COMPONENTS WHICH I (MICHAEL COLMAN) DID NOT DEVELOP.====  //
+// ALL OF THESE COMPONENTS HAVE BEEN CODED FROM PROVIDED ==  //
+// SOURCE CODE OR INFORMATION IN THE PUBLICATIONS. ========  //
+// I CLAIM NO RIGHTS OR INTELLECTUAL PROPERTY OWNERSHIP ===  //
+// FOR THESE MODELS AND COMPONENTS, OTHER THAN THEIR ======  //
+// SPECIFIC IMPLEMENTATION IN THIS CODE PACKAGE. FURTHER TO  //
+// THE ABOVE STATEMENT, ANY INDTENDED COMMERCIAL USE OF ===  //
+// THOSE COMPONENTS MUST BE BY EXPRESS PERMISSION OF THE ==  //
+// ORIGINAL COPYRIGHT HOLDERS. ============================  //
+// WHERE IMPLEMENTED FROM PROVIDED CODE, ANY DISCLAIMERS ==  //
+// PRESENT IN THE ORIGINAL CODE HAVE BEEN RETAINED IN THE =  //
+// RELEVANT FILE. =========================================  //
+// ========================================================  //
+// Contact: m.a.colman@leeds.ac.uk ========================  //
+// For updates, corrections etc, please check: ============  //
+// 1. http://physicsoftheheart.com/ =======================  //
+// 2. https://github.com/michaelcolman ====================  //
+// ========================================================  //
+
+#include "Output_reduced.h"
+#include "Outputs.h"
+#include "Structs.h"
+#include "Spatial_coupling.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <stdint.h>
+
+// Function list ================================================================================\\|
+//	output_reduced_init()
+//	output_reduced_find()
+//	output_reduced_write()
+//	output_reduced_free()
+//
+//	Internal
+//	    output_reduced_default_range()
+//	    output_reduced_parse_variable()
+//	    output_reduced_map()
+// End Function list ============================================================================//|
+
+// Notes ========================================================================================\\|
+// Reduced outputs are written as <variable>_reduced_<count>.vti: UInt8 or UInt16 on a grid of 
+// (region size / stride), origin at the region corner and spacing = stride, so they overlay the 
+// full resolution outputs. Code 0 = no cells in voxel; codes 1..(2^bits - 1) map linearly onto 
+// [min, max]: value = min + (code - 1)*(max - min)/(2^bits - 2). The range, the decode scale and offset
+// (value = offset + scale*code) and the empty code are stored in the file as field data.
+// The variable list (Spatial_output_reduced_variables) is comma separated, with each entry
+//      name[:min:max[:stride[:mode[:bits]]]]
+// where omitted fields take the global settings; min/max may only be omitted for Vm and Ca.
+// End Notes ====================================================================================//|
+
+// Internal =====================================================================================\\|
+// Default ranges for variables whose units are the same in every model
+static bool output_reduced_default_range(const char *name, double *min, double *max)
+{
+	if (strcmp(name, "Vm") == 0)    { *min = -100.0; *max = 50.0; return true; }
+	if (strcmp(name, "Ca") == 0)    { *min = 0.0;    *max = 2.0;  return true; }  // uM
+	return false;
+}
+
+static void output_reduced_parse_variable(Output_reduced_variable *v, char *entry, Simulation_parameters sim)
+{
+	char *field[6];
+	int Nfields = 0;
+	char *save;
+	for (char *tok = strtok_r(entry, ":", &save); tok != NULL && Nfields < 6; tok = strtok_r(NULL, ":", &save)) field[Nfields++] = tok;
+	if (Nfields == 0) return;
+
+	snprintf(v->variable, sizeof(v->variable), "%s", field[0]);
+	v->stride   = sim.Spatial_output_reduced_stride;
+	v->average  = (strcmp(sim.Spatial_output_reduced_mode, "average") == 0);
+	v->bits     = sim.Spatial_output_reduced_bits;
+
+	if (Nfields == 2)
+	{
+		printf("ERROR: reduced output \"%s\": give both min and max (name:min:max)\n", field[0]);
+		exit(1);
+	}
+	if (Nfields >= 3) { v->min = atof(field[1]); v->max = atof(field[2]); }
+	else if (output_reduced_default_range(v->variable, &v->min, &v->max) == false)
+	{
+		printf("ERROR: reduced output of \"%s\" needs a range; pass %s:min:max in Spatial_output_reduced_variables\n", v->variable, v->variable);
+		exit(1);
+	}
+	if (Nfields >= 4) v->stride = atoi(field[3]);
+	if (Nfields >= 5)
+	{
+		if (strcmp(field[4], "average") != 0 && strcmp(field[4], "stride") != 0)
+		{
+			printf("ERROR: reduced output of \"%s\": mode \"%s\" must be average or stride\n", v->variable, field[4]);
+			exit(1);
+		}
+		v->average = (strcmp(field[4], "average") == 0);
+	}
+	if (Nfields >= 6) v->bits = atoi(field[5]);
+
+	if (v->max <= v->min || v->stride < 1 || (v->bits != 8 && v->bits != 16))
+	{
+		printf("ERROR: reduced output of \"%s\": need max > min (%f, %f), stride >= 1 (%d) and bits 8 or 16 (%d)\n", v->variable, v->min, v->max, v->stride, v->bits);
+		exit(1);
+	}
+}
+
+// Reduced grid and voxel -> cell map of one variable, for cells in the region of interest
+static void output_reduced_map(Output_reduced *r, Output_reduced_variable *v, SC_variables sc, bool *in_roi)
+{
+	int s = v->stride;
+	v->RNX = (r->X1 - r->X0)/s + 1;
+	v->RNY = (r->Y1 - r->Y0)/s + 1;
+	v->RNZ = (r->Z1 - r->Z0)/s + 1;
+	int Nvox = v->RNX*v->RNY*v->RNZ;
+	int *voxel = new int [sc.N];    // voxel of each cell, -1 if not included
+
+	v->start = new int [Nvox + 1];
+	for (int i = 0; i <= Nvox; i++) v->start[i] = 0;
+
+	int cell_count = 0;
+	for (int z = 0; z < sc.NZ; z++) {
+		for (int y = 0; y < sc.NY; y++) {
+			for (int x = 0; x < sc.NX; x++) {
+				if (SC_geo(&sc, x + (sc.NX*y) + (sc.NX*sc.NY*z)) > 0)
+				{
+					voxel[cell_count] = -1;
+					if (in_roi[cell_count])
+					{
+						int dx = x - r->X0, dy = y - r->Y0, dz = z - r->Z0;
+						if (v->average || (dx % s == 0 && dy % s == 0 && dz % s == 0))
+						{
+							voxel[cell_count] = dx/s + v->RNX*(dy/s) + v->RNX*v->RNY*(dz/s);
+							v->start[voxel[cell_count] + 1]++;
+						}
+					}
+					cell_count++;
+				}
+			}
+		}
+	}
+	for (int i = 0; i < Nvox; i++) v->start[i+1] += v->start[i];
+
+	v->cells = new int [v->start[Nvox] > 0 ? v->start[Nvox] : 1];
+	int *fill = new int [Nvox];
+	for (int i = 0; i < Nvox; i++) fill[i] = v->start[i];
+	for (int n = 0; n < sc.N; n++) if (voxel[n] >= 0) v->cells[fill[voxel[n]]++] = n;
+
+	delete [] fill;
+	delete [] voxel;
+}
+// End Internal =================================================================================//|
+
+// Setup ========================================================================================\\|
+void output_reduced_init(Output_reduced *r, SC_variables sc, Simulation_parameters sim)
+{
+	r->Nvariables   = 0;
+	r->compression  = sim.Spatial_output_compression;
+
+	// Region of interest
+	bool *in_roi = new bool [sc.N];
+	r->X0 = 0; r->X1 = sc.NX - 1;
+	r->Y0 = 0; r->Y1 = sc.NY - 1;
+	r->Z0 = 0; r->Z1 = sc.NZ - 1;
+	for (int n = 0; n < sc.N; n++) in_roi[n] = true;
+
+	if (strcmp(sim.Spatial_output_reduced_ROI, "box") == 0)
+	{
+		if (sscanf(sim.Spatial_output_reduced_box, "%d,%d,%d,%d,%d,%d", &r->X0, &r->X1, &r->Y0, &r->Y1, &r->Z0, &r->Z1) != 6)
+		{
+			printf("ERROR: Spatial_output_reduced_box \"%s\" must be x0,x1,y0,y1,z0,z1\n", sim.Spatial_output_reduced_box);
+			exit(1);
+		}
+		if (r->X0 < 0) r->X0 = 0; 
+		if (r->Y0 < 0) r->Y0 = 0; 
+		if (r->Z0 < 0) r->Z0 = 0;
+		if (r->X1 >= sc.NX) r->X1 = sc.NX - 1; 
+		if (r->Y1 >= sc.NY) r->Y1 = sc.NY - 1; 
+		if (r->Z1 >= sc.NZ) r->Z1 = sc.NZ - 1;
+		if (r->X0 > r->X1 || r->Y0 > r->Y1 || r->Z0 > r->Z1)
+		{
+			printf("ERROR: Spatial_output_reduced_box \"%s\" does not overlap the geometry (%d * %d * %d)\n", sim.Spatial_output_reduced_box, sc.NX, sc.NY, sc.NZ);
+			exit(1);
+		}
+		int cell_count = 0;
+		for (int z = 0; z < sc.NZ; z++) 
+			for (int y = 0; y < sc.NY; y++) 
+				for (int x = 0; x < sc.NX; x++) 
+					if (SC_geo(&sc, x + (sc.NX*y) + (sc.NX*sc.NY*z)) > 0)
+						in_roi[cell_count++] = (x >= r->X0 && x <= r->X1 && y >= r->Y0 && y <= r->Y1 && z >= r->Z0 && z <= r->Z1);
+	}
+	else if (strcmp(sim.Spatial_output_reduced_ROI, "map") == 0)
+	{
+		// Map file in the standard full-box format (as geometry and stimulus maps); region = value > 0
+		FILE *in = fopen(sim.Spatial_output_reduced_map_file, "r");
+		if (in == NULL)
+		{
+			printf("Cannot load reduced output map file %s\t :: is the path correct? Does the file exist in that path?\n", sim.Spatial_output_reduced_map_file);
+			exit(1);
+		}
+		r->X0 = sc.NX; r->X1 = -1;
+		r->Y0 = sc.NY; r->Y1 = -1;
+		r->Z0 = sc.NZ; r->Z1 = -1;
+		int temp, cell_count = 0;
+		for (int z = 0; z < sc.NZ; z++) {
+			for (int y = 0; y < sc.NY; y++) {
+				for (int x = 0; x < sc.NX; x++) {
+					if (fscanf(in, "%d ", &temp) != 1)
+					{
+						printf("ERROR: reduced output map file %s is shorter than the geometry (%d * %d * %d)\n", sim.Spatial_output_reduced_map_file, sc.NX, sc.NY, sc.NZ);
+						exit(1);
+					}
+					if (SC_geo(&sc, x + (sc.NX*y) + (sc.NX*sc.NY*z)) > 0)
+					{
+						in_roi[cell_count] = (temp > 0);
+						if (temp > 0)
+						{
+							if (x < r->X0) r->X0 = x; 
+							if (x > r->X1) r->X1 = x;
+							if (y < r->Y0) r->Y0 = y; 
+							if (y > r->Y1) r->Y1 = y;
+							if (z < r->Z0) r->Z0 = z; 
+							if (z > r->Z1) r->Z1 = z;
+						}
+						cell_count++;
+					}
+				}
+			}
+		}
+		fclose(in);
+		if (r->X1 < 0)
+		{
+			printf("ERROR: reduced output map file %s contains no cells\n", sim.Spatial_output_reduced_map_file);
+			exit(1);
+		}
+	}
+
+	// Variables
+	char list[1000];
+	char *save;
+	snprintf(list, sizeof(list), "%s", sim.Spatial_output_reduced_variables);
+	for (char *entry = strtok_r(list, ",", &save); entry != NULL; entry = strtok_r(NULL, ",", &save))
+	{
+		if (r->Nvariables == OR_MAX_VARIABLES)
+		{
+			printf("ERROR: at most %d reduced output variables\n", OR_MAX_VARIABLES);
+			exit(1);
+		}
+		Output_reduced_variable *v = &r->var[r->Nvariables];
+		output_reduced_parse_variable(v, entry, sim);
+		output_reduced_map(r, v, sc, in_roi);
+		r->Nvariables++;
+		printf("Reduced spatial output %s: region %d-%d %d-%d %d-%d, %s %d, grid %d * %d * %d, %d-bit over [%g, %g]\n", v->variable, 
+				r->X0, r->X1, r->Y0, r->Y1, r->Z0, r->Z1, v->average ? "block average" : "stride", v->stride, v->RNX, v->RNY, v->RNZ, v->bits, v->min, v->max);
+	}
+	delete [] in_roi;
+}
+
+void output_reduced_free(Output_reduced *r)
+{
+	for (int i = 0; i < r->Nvariables; i++)
+	{
+		delete [] r->var[i].start;
+		delete [] r->var[i].cells;
+	}
+	r->Nvariables = 0;
+}
+// End Setup ====================================================================================//|
+
+// Output =======================================================================================\\|
+// Index of variable in the reduced output list, or -1 if it is not reduced
+int output_reduced_find(Output_reduced *r, const char *string)
+{
+	for (int i = 0; i < r->Nvariables; i++) if (strcmp(r->var[i].variable, string) == 0) return i;
+	return -1;
+}
+
+// Reduce, quantise and write one field (thread safe: config is read only)
+void output_reduced_write(Output_reduced *r, const char *string, double *variable, int count, const char *dir, const char *dir2)
+{
+	int i = output_reduced_find(r, string);
+	if (i < 0) return;
+	Output_reduced_variable *v = &r->var[i];
+
+	int Nvox        = v->RNX*v->RNY*v->RNZ;
+	int code_max    = (1 << v->bits) - 1;
+	double scale    = (code_max - 1)/(v->max - v->min);
+	void *data      = malloc(Nvox*(v->bits/8));
+
+	for (int k = 0; k < Nvox; k++)
+	{
+		int code = 0;   // empty
+		int n = v->start[k+1] - v->start[k];
+		if (n > 0)
+		{
+			double sum = 0;
+			for (int c = v->start[k]; c < v->start[k+1]; c++) sum += variable[v->cells[c]];
+			long q = 1 + lround((sum/n - v->min)*scale);
+			code = (q < 1) ? 1 : (q > code_max) ? code_max : (int)q;
+		}
+		if (v->bits == 8) ((uint8_t*)data)[k] = code;
+		else ((uint16_t*)data)[k] = code;
+	}
+
+	// Block average voxels are centred on their block (along axes the region spans)
+	double offset = v->average ? 0.5*(v->stride - 1) : 0.0;
+	double ox = r->X0 + (r->X1 > r->X0 ? offset : 0.0);
+	double oy = r->Y0 + (r->Y1 > r->Y0 ? offset : 0.0);
+	double oz = r->Z0 + (r->Z1 > r->Z0 ? offset : 0.0);
+	vtk_xml_quantised_output(string, dir, dir2, data, v->bits, v->RNX, v->RNY, v->RNZ, ox, oy, oz, v->stride, v->min, v->max, count, r->compression); // lib/Outputs.cpp
+	free(data);
+}
+// End Output ===================================================================================//|
@@ -0,0 +1,394 @@
+// Source code associated with  ===========================  //
+// "Multi-scale cardiac simulation framework" =============  //
+// For simulation of cardiac cellular and tissue dynamics =  //
+// from the spatial cellular to full organ scales. ========  //
+// With implementation of multiple, published cell models =  //
+// as well as novel models developed in my lab. ===========  //
+// ========================================================  //
+// This file: Asynchronous spatial output =================  //
+// writer (snapshot ring and writer threads) ==============  //
+// ========================================================  //
+// GNU 3 LICENSE TEXT =====================================  //
+// COPYRIGHT (C) 2016-2019 MICHAEL A. COLMAN ==============  //
+// THIS PROGRAM IS FREE SOFTWARE: YOU CAN REDISTRIBUTE IT =  //
+// AND/OR MODIFY IT UNDER THE TERMS OF THE GNU GENERAL ====  //
+// PUBLIC LICENSE AS PUBLISHED BY THE FREE SOFTWARE =======  //
+// FOUNDATION, EITHER VERSION 3 OF THE LICENSE, OR (AT YOUR  //
+// OPTION) ANY LATER VERSION. =============================  //
+// THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE=  //
+// USEFUL, BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE =====  //
+// IMPLIED WARRANTY OF MERCHANTABILITY OR FITNESS FOR A ===  //
+// PARTICULAR PURPOSE.  SEE THE GNU GENERAL PUBLIC LICENSE=  //
+// FOR MORE DETAILS. ======================================  //
+// YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL =====  //
+// PUBLIC LICENSE ALONG WITH THIS PROGRAM.  IF NOT, SEE ===  //
+// <https://www.gnu.org/licenses/>. =======================  //
+// ========================================================  //
+// ADDITIONAL LICENSE TEXT ================================  //
+// THIS SOFTWARE IS PROVIDED OPEN SOURCE AND MAY BE FREELY=  //
+// USED, DISTRIBUTED AND UPDATED, PROVIDED: ===============  //
+//  (i) THE APPROPRIATE WORK(S) IS(ARE) CITED. THIS =======  //
+//      PERTAINS TO THE CITATION OF COLMAN 2019 PLOS COMP =  //
+//      BIOL (FOR THIS IMPLEMTATION) AND ALL WORKS ========  //
+//      ASSOCIATED WITH THE SPECIFIC MODELS AND COMPONENTS=  //
+//      USED IN PARTICULAR SIMULATIONS. IT IS THE USER'S ==  //
+//      RESPONSIBILITY TO ENSURE ALL RELEVANT WORKS ARE ===  //
+//      CITED. PLEASE SEE FULL DOCUMENTATION AND ON-SCREEN=  //
+//      DISCLAIMER OUTPUTS FOR A GUIDE. ===================  //
+//  (ii) ALL OF THIS TEXT IS RETAINED WITHIN OR ASSOCIATED=  //
+//      WITH THE SOURCE CODE AND/OR BINARY FORM OF THE ====  //
+//      SOFTWARE. =========================================  //
+// ========================================================  //
+// ANY INTENDED COMMERCIAL USE OF THIS SOFTWARE MUST BE BY   //
+// EXPRESS PERMISSION OF MICHAEL A COLMAN ONLY. IN NO EVENT  //
+// ARE THE COPYRIGHT HOLDERS LIABLE FOR ANY DIRECT, =======  //
+// INDIRECT INCIDENTAL, SPECIAL, EXEMPLARY OR CONSEQUENTIAL  //
+// DAMAGES ASSOCIATED WITH USE OF THIS SOFTWARE ===========  //
+// ========================================================  //
+// THIS SOFTWARE CONTAINS IMPLEMENTATIONS OF MODELS AND ===  //
+// COMPONENTS WHICH I (MICHAEL COLMAN) DID NOT DEVELOP.====  //
+// ALL OF THESE COMPONENTS HAVE BEEN CODED FROM PROVIDED ==  //
+// SOURCE CODE OR INFORMATION IN THE PUBLICATIONS. ========  //
+// I CLAIM NO RIGHTS OR INTELLECTUAL PROPERTY OWNERSHIP ===  //
+// FOR THESE MODELS AND COMPONENTS, OTHER THAN THEIR ======  //
+// SPECIFIC IMPLEMENTATION IN THIS CODE PACKAGE. FURTHER TO  //
+// THE ABOVE STATEMENT, ANY INDTENDED COMMERCIAL USE OF ===  //
+// THOSE COMPONENTS MUST BE BY EXPRESS PERMISSION OF THE ==  //
+// ORIGINAL COPYRIGHT HOLDERS. ============================  //
+// WHERE IMPLEMENTED FROM PROVIDED CODE, ANY DISCLAIMERS ==  //
+// PRESENT IN THE ORIGINAL CODE HAVE BEEN RETAINED IN THE =  //
+// RELEVANT FILE. =========================================  //
+// ========================================================  //
+// Contact: m.a.colman@leeds.ac.uk ========================  //
+// For updates, corrections etc, please check: ============  //
+// 1. http://physicsoftheheart.com/ =======================  //
+// 2. https://github.com/michaelcolman ====================  //
+// ========================================================  //
+
+#include "Output_writer.h"
+#include "Outputs.h"
+#include "Output_container.h"
+#include "Output_reduced.h"
+#include "Structs.h"
+#include <fstream>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+// Function list ================================================================================\\|
+//	output_writer_init()
+//	output_writer_flush()
+//	output_writer_finalise()
+//
+//	output_writer_vtk_3D()
+//	output_writer_array_1D()
+//	output_writer_reduced()
+//	output_writer_linescan_X()
+//	output_writer_linescan_Y()
+//	output_writer_linescan_Z()
+//
+//	Internal
+//	    output_writer_submit()
+//	    output_writer_write_slot()
+//	    output_writer_thread()
+//	    output_writer_geometry()
+// End Function list ============================================================================//|
+
+// Notes ========================================================================================\\|
+// Spatial outputs (vtk, binary arrays, linescans) are copied into one of a fixed ring of snapshot 
+// buffers and handed to background writer threads. The simulation thread only blocks if all
+// Nslots buffers are still waiting to be written (bounded queue depth = bounded memory).
+// Full-field files (vtk, bin) are independent and may be written in any order by any writer; 
+// linescans (and container frames) append to a shared stream and so are written strictly in submission order.
+// The writer threads are additional to the OpenMP threads; for best performance leave a core free
+// for them (e.g. OMP_NUM_THREADS = cores - Spatial_output_writers).
+// End Notes ====================================================================================//|
+
+static double ow_wtime()
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + 1e-6*tv.tv_usec;
+}
+
+// Write one slot to file using the standard (synchronous) output functions || lib/Outputs.cpp
+static void output_writer_write_slot(Output_writer *ow, Output_writer_slot *s)
+{
+	if      (s->type == OW_VTK_3D)      vtk_3D_output_format(s->variable, ow->dir, ow->dir2, s->data, ow->sc, s->count, ow->vtk_format, ow->vtk_precision, ow->vtk_compression);
+	else if (s->type == OW_ARRAY_1D)    
+	{
+		if (ow->use_container) output_container_append(&ow->container, s->variable, s->data, s->count);
+		else array_1D_output(s->variable, ow->dir, ow->dir2, s->data, ow->sc, s->count);
+	}
+	else if (s->type == OW_REDUCED)     output_reduced_write(&ow->reduced, s->variable, s->data, s->count, ow->dir, ow->dir2);
+	else if (s->type == OW_LINESCAN_X)  linescan_out_X(*s->stream, ow->sc, s->data, s->a, s->b);
+	else if (s->type == OW_LINESCAN_Y)  linescan_out_Y(*s->stream, ow->sc, s->data, s->a, s->b);
+	else if (s->type == OW_LINESCAN_Z)  linescan_out_Z(*s->stream, ow->sc, s->data, s->a, s->b);
+}
+
+// Background writer thread
+static void * output_writer_thread(void *arg)
+{
+	Output_writer *ow = (Output_writer*)arg;
+
+	pthread_mutex_lock(&ow->lock);
+	while (true)
+	{
+		while (ow->Nqueued == 0 && !ow->shutdown) pthread_cond_wait(&ow->job_ready, &ow->lock);
+		if (ow->Nqueued == 0 && ow->shutdown) break;
+
+		// Pop oldest job
+		int k = ow->queue[ow->q_head];
+		ow->q_head = (ow->q_head + 1) % ow->Nslots;
+		ow->Nqueued--;
+		ow->Nbusy++;
+		Output_writer_slot *s = &ow->slot[k];
+
+		// Ordered jobs wait for their turn; earlier ordered jobs have already been popped, so this cannot deadlock
+		if (s->ordered) while (s->seq != ow->seq_next) pthread_cond_wait(&ow->seq_turn, &ow->lock);
+		pthread_mutex_unlock(&ow->lock);
+
+		output_writer_write_slot(ow, s);
+
+		pthread_mutex_lock(&ow->lock);
+		if (s->ordered) 
+		{
+			ow->seq_next++;
+			pthread_cond_broadcast(&ow->seq_turn);
+		}
+		ow->free_slots[ow->Nfree++] = k;
+		ow->Nbusy--;
+		pthread_cond_signal(&ow->slot_free);
+		if (ow->Nqueued == 0 && ow->Nbusy == 0) pthread_cond_broadcast(&ow->idle);
+	}
+	pthread_mutex_unlock(&ow->lock);
+	return NULL;
+}
+
+// Setup ========================================================================================\\|
+// The writers only need the array sizes and the brick geometry (SC_geo); every other array pointer is left NULL,
+// as SC_release_setup_arrays frees setup arrays after the writer is initialised
+static SC_variables output_writer_geometry(SC_variables sc)
+{
+	SC_variables g;
+	memset(&g, 0, sizeof(SC_variables));
+	g.NX = sc.NX; g.NY = sc.NY; g.NZ = sc.NZ;
+	g.N  = sc.N;
+	g.dx = sc.dx; g.dy = sc.dy; g.dz = sc.dz;
+	g.BX = sc.BX; g.BY = sc.BY; g.BZ = sc.BZ;
+	g.Nbricks           = sc.Nbricks;
+	g.brick_capacity    = sc.brick_capacity;
+	g.brick             = sc.brick;
+	g.brick_geo         = sc.brick_geo;
+	return g;
+}
+
+// restart_outcount: output count restored from a checkpoint (-1 if not a restart); the container is continued from it
+void output_writer_init(Output_writer *ow, SC_variables sc, const char *dir, const char *dir2, Simulation_parameters sim, int restart_outcount)
+{
+	ow->async       = (strcmp(sim.Spatial_output_async, "On") == 0);
+	ow->sc          = output_writer_geometry(sc);
+	ow->Nwriters    = sim.Spatial_output_writers;
+	ow->Nslots      = sim.Spatial_output_buffers;
+	ow->Njobs       = 0;
+	ow->stall_time  = 0.0;
+	ow->vtk_format      = sim.Spatial_output_vtk_format;
+	ow->vtk_precision   = sim.Spatial_output_precision;
+	ow->vtk_compression = sim.Spatial_output_compression;
+	sprintf(ow->dir,  "%s", dir);
+	sprintf(ow->dir2, "%s", dir2);
+
+	// Unstructured vtk outputs: cell coordinates and celltypes written once || lib/Outputs.cpp
+	if (sim.Spatial_output_interval_vtk > 0 && strcmp(ow->vtk_format, "vtu") == 0) vtk_xml_geometry_output(dir, dir2, sc, ow->vtk_compression);
+
+	// Binary arrays to single container file rather than one file per frame || lib/Output_container.cpp
+	ow->use_container = (sim.Spatial_output_interval_data > 0 && strcmp(sim.Spatial_output_data_format, "container") == 0);
+	if (ow->use_container) 
+	{
+		if (restart_outcount >= 0)  output_container_resume(&ow->container, dir, dir2, "Spatial_data.msc", sc, sim.Spatial_output_compression, restart_outcount);
+		else                        output_container_create(&ow->container, dir, dir2, "Spatial_data.msc", sc, sim.Spatial_output_compression);
+		printf("Spatial data being written to container %s\n", ow->container.filename);
+	}
+	else if (sim.Spatial_output_interval_data > 0) output_container_geometry(dir, dir2, sc);	// geometry sidecar for convert_spatial
+
+	// Quantised, down-sampled region of interest outputs || lib/Output_reduced.cpp
+	ow->reduced.Nvariables = 0;
+	if (sim.Spatial_output_interval_reduced > 0) output_reduced_init(&ow->reduced, sc, sim);
+
+	if (ow->async == false) return;
+
+	if (ow->Nwriters < 1 || ow->Nslots < 1)
+	{
+		printf("ERROR: Spatial_output_writers (%d) and Spatial_output_buffers (%d) must both be at least 1\n", ow->Nwriters, ow->Nslots);
+		exit(1);
+	}
+
+	// Snapshot buffers hold one full field (one value per cell)
+	int length = sc.N;
+
+	ow->slot        = new Output_writer_slot [ow->Nslots];
+	ow->free_slots  = new int [ow->Nslots];
+	ow->queue       = new int [ow->Nslots];
+	for (int k = 0; k < ow->Nslots; k++)
+	{
+		ow->slot[k].data    = new double [length];
+		ow->free_slots[k]   = k;
+	}
+	ow->Nfree       = ow->Nslots;
+	ow->q_head      = ow->q_tail = ow->Nqueued = ow->Nbusy = 0;
+	ow->seq_issued  = ow->seq_next = 0;
+	ow->shutdown    = false;
+
+	pthread_mutex_init(&ow->lock, NULL);
+	pthread_cond_init(&ow->job_ready, NULL);
+	pthread_cond_init(&ow->slot_free, NULL);
+	pthread_cond_init(&ow->seq_turn, NULL);
+	pthread_cond_init(&ow->idle, NULL);
+
+	ow->writers = new pthread_t [ow->Nwriters];
+	for (int i = 0; i < ow->Nwriters; i++)
+	{
+		if (pthread_create(&ow->writers[i], NULL, output_writer_thread, ow) != 0)
+		{
+			printf("ERROR: Cannot create spatial output writer thread %d\n", i);
+			exit(1);
+		}
+	}
+	printf("Asynchronous spatial output: %d writer thread(s), %d snapshot buffers of %d values\n", ow->Nwriters, ow->Nslots, length);
+}
+
+// Block until everything submitted so far is on disk
+void output_writer_flush(Output_writer *ow)
+{
+	if (ow->async == false) return;
+	pthread_mutex_lock(&ow->lock);
+	while (ow->Nqueued > 0 || ow->Nbusy > 0) pthread_cond_wait(&ow->idle, &ow->lock);
+	pthread_mutex_unlock(&ow->lock);
+}
+
+// Flush, stop writer threads and free buffers
+void output_writer_finalise(Output_writer *ow)
+{
+	if (ow->async == false) 
+	{
+		if (ow->use_container) 
+		{
+			output_container_finalise(&ow->container);
+			printf("Spatial output container %s finalised with %lld frames\n", ow->container.filename, (long long)ow->container.Nframes);
+		}
+		ow->use_container = false;
+		output_reduced_free(&ow->reduced);
+		return;
+	}
+
+	output_writer_flush(ow);
+
+	pthread_mutex_lock(&ow->lock);
+	ow->shutdown = true;
+	pthread_cond_broadcast(&ow->job_ready);
+	pthread_mutex_unlock(&ow->lock);
+	for (int i = 0; i < ow->Nwriters; i++) pthread_join(ow->writers[i], NULL);
+
+	printf("Asynchronous spatial output: %ld snapshots written; simulation waited %.2f s for free buffers\n", ow->Njobs, ow->stall_time);
+
+	for (int k = 0; k < ow->Nslots; k++) delete [] ow->slot[k].data;
+	delete [] ow->slot;
+	delete [] ow->free_slots;
+	delete [] ow->queue;
+	delete [] ow->writers;
+	pthread_mutex_destroy(&ow->lock);
+	pthread_cond_destroy(&ow->job_ready);
+	pthread_cond_destroy(&ow->slot_free);
+	pthread_cond_destroy(&ow->seq_turn);
+	pthread_cond_destroy(&ow->idle);
+	ow->async = false;
+
+	if (ow->use_container) 
+	{
+		output_container_finalise(&ow->container);
+		printf("Spatial output container %s finalised with %lld frames\n", ow->container.filename, (long long)ow->container.Nframes);
+	}
+	ow->use_container = false;
+	output_reduced_free(&ow->reduced);
+}
+// End Setup ====================================================================================//|
+
+// Submission ===================================================================================\\|
+// Copy "length" values of variable into a free slot and queue it; blocks only if the ring is full
+static void output_writer_submit(Output_writer *ow, int type, const char *string, double *variable, int length, int count, std::ostream *stream, bool ordered, int a, int b)
+{
+	pthread_mutex_lock(&ow->lock);
+	if (ow->Nfree == 0)
+	{
+		double t0 = ow_wtime();
+		while (ow->Nfree == 0) pthread_cond_wait(&ow->slot_free, &ow->lock);
+		ow->stall_time += ow_wtime() - t0;
+	}
+	int k = ow->free_slots[--ow->Nfree];
+	pthread_mutex_unlock(&ow->lock);
+
+	// Fill the snapshot outside the lock
+	Output_writer_slot *s = &ow->slot[k];
+	s->type     = type;
+	s->count    = count;
+	s->stream   = stream;
+	s->ordered  = ordered;
+	s->a        = a;
+	s->b        = b;
+	snprintf(s->variable, sizeof(s->variable), "%s", string);
+	memcpy(s->data, variable, length*sizeof(double));
+
+	pthread_mutex_lock(&ow->lock);
+	if (ordered) s->seq = ow->seq_issued++;
+	ow->queue[ow->q_tail] = k;
+	ow->q_tail = (ow->q_tail + 1) % ow->Nslots;
+	ow->Nqueued++;
+	ow->Njobs++;
+	pthread_cond_signal(&ow->job_ready);
+	pthread_mutex_unlock(&ow->lock);
+}
+
+void output_writer_vtk_3D(Output_writer *ow, const char *string, double *variable, int count)
+{
+	if (ow->async == false) vtk_3D_output_format(string, ow->dir, ow->dir2, variable, ow->sc, count, ow->vtk_format, ow->vtk_precision, ow->vtk_compression);	// lib/Outputs.cpp
+	else output_writer_submit(ow, OW_VTK_3D, string, variable, ow->sc.N, count, NULL, false, 0, 0);
+}
+
+void output_writer_array_1D(Output_writer *ow, const char *string, double *variable, int count)
+{
+	if (ow->async == false)
+	{
+		if (ow->use_container) output_container_append(&ow->container, string, variable, count);	// lib/Output_container.cpp
+		else array_1D_output(string, ow->dir, ow->dir2, variable, ow->sc, count);					// lib/Outputs.cpp
+	}
+	else output_writer_submit(ow, OW_ARRAY_1D, string, variable, ow->sc.N, count, NULL, ow->use_container, 0, 0);
+}
+
+// Variables not in the reduced output list are ignored (before any copy)
+void output_writer_reduced(Output_writer *ow, const char *string, double *variable, int count)
+{
+	if (output_reduced_find(&ow->reduced, string) < 0) return;
+	if (ow->async == false) output_reduced_write(&ow->reduced, string, variable, count, ow->dir, ow->dir2);	// lib/Output_reduced.cpp
+	else output_writer_submit(ow, OW_REDUCED, string, variable, ow->sc.N, count, NULL, false, 0, 0);
+}
+
+// Linescans index the variable by box coordinate, so are only valid (and only queued) when there is no empty space
+void output_writer_linescan_X(Output_writer *ow, std::ostream& out, double *variable, int y, int z)
+{
+	if (ow->async == false || ow->sc.N != ow->sc.NX*ow->sc.NY*ow->sc.NZ) linescan_out_X(out, ow->sc, variable, y, z);	// lib/Outputs.cpp
+	else output_writer_submit(ow, OW_LINESCAN_X, "linescan", variable, ow->sc.N, 0, &out, true, y, z);
+}
+
+void output_writer_linescan_Y(Output_writer *ow, std::ostream& out, double *variable, int x, int z)
+{
+	if (ow->async == false || ow->sc.N != ow->sc.NX*ow->sc.NY*ow->sc.NZ) linescan_out_Y(out, ow->sc, variable, x, z);	// lib/Outputs.cpp
+	else output_writer_submit(ow, OW_LINESCAN_Y, "linescan", variable, ow->sc.N, 0, &out, true, x, z);
+}
+
+void output_writer_linescan_Z(Output_writer *ow, std::ostream& out, double *variable, int x, int y)
+{
+	if (ow->async == false || ow->sc.N != ow->sc.NX*ow->sc.NY*ow->sc.NZ) linescan_out_Z(out, ow->sc, variable, x, y);	// lib/Outputs.cpp
+	else output_writer_submit(ow, OW_LINESCAN_Z, "linescan", variable, ow->sc.N, 0, &out, true, x, y);
+}
+// End Submission ===============================================================================//|
@@ -0,0 +1,148 @@
+// Source code associated with  ===========================  //
+// "Multi-scale cardiac simulation framework" =============  //
+// For simulation of cardiac cellular and tissue dynamics =  //
+// from the spatial cellular to full organ scales. ========  //
+// With implementation of multiple, published cell models =  //
+// as well as novel models developed in my lab. ===========  //
+// ========================================================  //
+// This file: Asynchronous spatial output =================  //
+// writer (snapshot ring and writer threads), header ======  //
+// ========================================================  //
+// GNU 3 LICENSE TEXT =====================================  //
+// COPYRIGHT (C) 2016-2019 MICHAEL A. COLMAN ==============  //
+// THIS PROGRAM IS FREE SOFTWARE: YOU CAN REDISTRIBUTE IT =  //
+// AND/OR MODIFY IT UNDER THE TERMS OF THE GNU GENERAL ====  //
+// PUBLIC LICENSE AS PUBLISHED BY THE FREE SOFTWARE =======  //
+// FOUNDATION, EITHER VERSION 3 OF THE LICENSE, OR (AT YOUR  //
+// OPTION) ANY LATER VERSION. =============================  //
+// THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE=  //
+// USEFUL, BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE =====  //
+// IMPLIED WARRANTY OF MERCHANTABILITY OR FITNESS FOR A ===  //
+// PARTICULAR PURPOSE.  SEE THE GNU GENERAL PUBLIC LICENSE=  //
+// FOR MORE DETAILS. ======================================  //
+// YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL =====  //
+// PUBLIC LICENSE ALONG WITH THIS PROGRAM.  IF NOT, SEE ===  //
+// <https://www.gnu.org/licenses/>. =======================  //
+// ========================================================  //
+// ADDITIONAL LICENSE TEXT ================================  //
+// THIS SOFTWARE IS PROVIDED OPEN SOURCE AND MAY BE FREELY=  //
+// USED, DISTRIBUTED AND UPDATED, PROVIDED: ===============  //
+//  (i) THE APPROPRIATE WORK(S) IS(ARE) CITED. THIS =======  //
+//      PERTAINS TO THE CITATION OF COLMAN 2019 PLOS COMP =  //
+//      BIOL (FOR THIS IMPLEMTATION) AND ALL WORKS ========  //
+//      ASSOCIATED WITH THE SPECIFIC MODELS AND COMPONENTS=  //
+//      USED IN PARTICULAR SIMULATIONS. IT IS THE USER'S ==  //
+//      RESPONSIBILITY TO ENSURE ALL RELEVANT WORKS ARE ===  //
+//      CITED. PLEASE SEE FULL DOCUMENTATION AND ON-SCREEN=  //
+//      DISCLAIMER OUTPUTS FOR A GUIDE. ===================  //
+//  (ii) ALL OF THIS TEXT IS RETAINED WITHIN OR ASSOCIATED=  //
+//      WITH THE SOURCE CODE AND/OR BINARY FORM OF THE ====  //
+//      SOFTWARE. =========================================  //
+// ========================================================  //
+// ANY INTENDED COMMERCIAL USE OF THIS SOFTWARE MUST BE BY   //
+// EXPRESS PERMISSION OF MICHAEL A COLMAN ONLY. IN NO EVENT  //
+// ARE THE COPYRIGHT HOLDERS LIABLE FOR ANY DIRECT, =======  //
+// INDIRECT INCIDENTAL, SPECIAL, EXEMPLARY OR CONSEQUENTIAL  //
+// DAMAGES ASSOCIATED WITH USE OF THIS SOFTWARE ===========  //
+// ========================================================  //
+// THIS SOFTWARE CONTAINS IMPLEMENTATIONS OF MODELS AND ===  //
+// COMPONENTS WHICH I (MICHAEL COLMAN) DID NOT DEVELOP.====  //
+// ALL OF THESE COMPONENTS HAVE BEEN CODED FROM PROVIDED ==  //
+// SOURCE CODE OR INFORMATION IN THE PUBLICATIONS. ========  //
+// I CLAIM NO RIGHTS OR INTELLECTUAL PROPERTY OWNERSHIP ===  //
+// FOR THESE MODELS AND COMPONENTS, OTHER THAN THEIR ======  //
+// SPECIFIC IMPLEMENTATION IN THIS CODE PACKAGE. FURTHER TO  //
+// THE ABOVE STATEMENT, ANY INDTENDED COMMERCIAL USE OF ===  //
+// THOSE COMPONENTS MUST BE BY EXPRESS PERMISSION OF THE ==  //
+// ORIGINAL COPYRIGHT HOLDERS. ============================  //
+// WHERE IMPLEMENTED FROM PROVIDED CODE, ANY DISCLAIMERS ==  //
+// PRESENT IN THE ORIGINAL CODE HAVE BEEN RETAINED IN THE =  //
+// RELEVANT FILE. =========================================  //
+// ========================================================  //
+// Contact: m.a.colman@leeds.ac.uk ========================  //
+// For updates, corrections etc, please check: ============  //
+// 1. http://physicsoftheheart.com/ =======================  //
+// 2. https://github.com/michaelcolman ====================  //
+// ========================================================  //
+
+#ifndef OUTPUT_WRITER_H
+#define OUTPUT_WRITER_H
+
+#include "Structs.h"
+#include "Output_container.h"
+#include "Output_reduced.h"
+#include <pthread.h>
+#include <fstream>
+
+// Snapshot job types
+#define OW_VTK_3D       0
+#define OW_ARRAY_1D     1
+#define OW_LINESCAN_X   2
+#define OW_LINESCAN_Y   3
+#define OW_LINESCAN_Z   4
+#define OW_REDUCED      5
+
+// A single snapshot slot in the ring: a copy of one spatial field at one output time
+typedef struct{
+	int             type;           // OW_* job type
+	char            variable[100];  // Variable reference ("Vm", "Ca" etc), used in file name
+	int             count;          // Output count, used in file name
+	int             a, b;           // Linescan coordinates
+	std::ostream    *stream;        // Linescan stream
+	bool            ordered;        // Job writes to a shared stream/file, so is written in submission order
+	long            seq;            // Order of ordered jobs
+	double          *data;          // Snapshot buffer, length sc.N
+}Output_writer_slot;
+
+// Output writer: ring of snapshot slots, bounded FIFO queue and background writer threads
+typedef struct{
+	bool            async;          // false = write synchronously on the calling thread (original behaviour)
+	int             Nwriters;       // Number of background writer threads
+	int             Nslots;         // Number of snapshot buffers in the ring (= max queue depth)
+	SC_variables    sc;             // Sizes and brick geometry for the writers (other arrays NULL; brick arrays must outlive the writer)
+	char            dir[1000];      // Output directory
+	char            dir2[1000];     // Spatial results sub-directory
+	const char      *vtk_format;    // "legacy", "vti" or "vtu" || lib/Outputs.cpp
+	const char      *vtk_precision; // "float" or "double"
+	const char      *vtk_compression; // "Off" or "zlib"
+	bool            use_container;  // Binary arrays appended to a single container file || lib/Output_container.cpp
+	Output_container container;
+	Output_reduced  reduced;        // Quantised, down-sampled outputs || lib/Output_reduced.cpp
+
+	Output_writer_slot *slot;       // Ring of snapshot slots
+	int             *free_slots;    // Stack of slots not currently in use
+	int             Nfree;
+	int             *queue;         // FIFO of filled slots waiting to be written
+	int             q_head, q_tail, Nqueued;
+	int             Nbusy;          // Jobs currently being written
+
+	long            seq_issued;     // Next sequence number for ordered jobs
+	long            seq_next;       // Next ordered job allowed to write
+
+	bool            shutdown;
+	pthread_t       *writers;
+	pthread_mutex_t lock;
+	pthread_cond_t  job_ready;      // Queue has work (or shutdown)
+	pthread_cond_t  slot_free;      // A slot has been returned to the ring
+	pthread_cond_t  seq_turn;       // An ordered job has completed
+	pthread_cond_t  idle;           // Queue drained and no writer busy
+
+	// Diagnostics
+	long            Njobs;          // Snapshots submitted
+	double          stall_time;     // Seconds the simulation thread waited for a free slot
+}Output_writer;
+
+// Setup and shutdown
+void output_writer_init(Output_writer *ow, SC_variables sc, const char *dir, const char *dir2, Simulation_parameters sim, int restart_outcount);
+void output_writer_flush(Output_writer *ow);
+void output_writer_finalise(Output_writer *ow);
+
+// Snapshot submission (copy field, then return immediately)
+void output_writer_vtk_3D(Output_writer *ow, const char *string, double *variable, int count);
+void output_writer_array_1D(Output_writer *ow, const char *string, double *variable, int count);
+void output_writer_reduced(Output_writer *ow, const char *string, double *variable, int count);
+void output_writer_linescan_X(Output_writer *ow, std::ostream& out, double *variable, int y, int z);
+void output_writer_linescan_Y(Output_writer *ow, std::ostream& out, double *variable, int x, int z);
+void output_writer_linescan_Z(Output_writer *ow, std::ostream& out, double *variable, int x, int y);
+
+#endif
@@ -67,13 +67,19 @@
 
 #include "CRU.h"
 #include "Structs.h"
+#include "Spatial_coupling.h"
 #include <fstream>
 #include <sstream>
 #include <stdlib.h>
 #include <stdio.h>
 #include <cstring>
+#include <pthread.h>
+#ifdef MSCSF_ZLIB
+#include <zlib.h>
+#endif
 
 // Function list ================================================================================\\|
+//	output_properties_line()        || one line of Properties_log.txt
 //	output_properties_to_screen()   || Properties_log.txt
 //	output_currents()				|| Currents.txt
 //	output_excitation_properties()	|| Properties.txt
@@ -95,6 +101,11 @@
 //	
 //	    Output_activation()
 //	
+//	    vtk_xml_3D_output()			|| binary .vti/.vtu
+//	    vtk_xml_geometry_output()
+//	    vtk_xml_quantised_output()		|| reduced 8/16-bit .vti
+//	    vtk_3D_output_format()
+//	
 //	output_settings()
 //	output_settings_tissue()
 //	output_settings_3D_cell()
@@ -103,6 +114,14 @@
 // End Function list ============================================================================//|
 
 // Common - screen and file data outputs ========================================================\\|
+// Final two beat properties as one line of Properties_log (no new line, so callers can append columns)
+void output_properties_line(FILE *out, Model_variables var, int BCL, int S2_CL)
+{
+	fprintf(out, "%d %d %f %f %f %f %f %f %f %f %f %f ", BCL, S2_CL, var.APD_t, var.APD_t_prev, var.APD_p[2], var.APD_p_prev[2], var.APD_p[4], var.APD_p_prev[4], var.APD_p[6], var.APD_p_prev[6], var.APD_p[8], var.APD_p_prev[8]);
+	fprintf(out, "%f %f %f %f %f %f %f %f ", var.dvdt_max, var.dvdt_max_prev, var.Vmin_prev, var.Vmin_prev_prev, var.Vmax, var.Vmax_prev, var.Vamp, var.Vamp_prev);
+	fprintf(out, "%f %f %f %f %f %f %f %f", 1e3*var.CaT_min, 1e3*var.CaT_min_prev, 1e3*var.CaT_max, 1e3*var.CaT_max_prev, var.CaSR_min, var.CaSR_min_prev, var.CaSR_max, var.CaSR_max_prev);
+}
+
 // Final properties to file and screen
 void output_properties_to_screen(const char * log_reference, Model_variables var, Simulation_parameters Sim)
 {
@@ -120,15 +139,14 @@ void output_properties_to_screen(const char * log_reference, Model_variables var
 	// Output to file
 	FILE *out;
 	out = fopen(log_reference, "a");    // Note: Appended, not overwritten
-	fprintf(out, "%d %d %f %f %f %f %f %f %f %f %f %f ", Sim.BCL, Sim.S2_CL, var.APD_t, var.APD_t_prev, var.APD_p[2], var.APD_p_prev[2], var.APD_p[4], var.APD_p_prev[4], var.APD_p[6], var.APD_p_prev[6], var.APD_p[8], var.APD_p_prev[8]);
-	fprintf(out, "%f %f %f %f %f %f %f %f ", var.dvdt_max, var.dvdt_max_prev, var.Vmin_prev, var.Vmin_prev_prev, var.Vmax, var.Vmax_prev, var.Vamp, var.Vamp_prev);
-	fprintf(out, "%f %f %f %f %f %f %f %f\n", 1e3*var.CaT_min, 1e3*var.CaT_min_prev, 1e3*var.CaT_max, 1e3*var.CaT_max_prev, var.CaSR_min, var.CaSR_min_prev, var.CaSR_max, var.CaSR_max_prev);
+	output_properties_line(out, var, Sim.BCL, Sim.S2_CL);
+	fprintf(out, "\n");
 	fclose(out);
 
 }
 
 // Output currents and gates to file
-void output_currents(std::ostream& out, double sim_time, Model_variables var, State_variables s, double Vm)
+void output_currents(std::ostream& out, double sim_time, const Model_variables &var, const State_variables &s, double Vm)
 {
 	//1-3
 	out<<sim_time<<" "<<Vm<<" "<<var.Istim  \
@@ -175,7 +193,7 @@ void output_currents(std::ostream& out, double sim_time, Model_variables var, St
 }
 
 // Output currents and gates to file
-void output_currents_csv(std::ostream& out, double sim_time, Model_variables var, State_variables s, double Vm)
+void output_currents_csv(std::ostream& out, double sim_time, const Model_variables &var, const State_variables &s, double Vm)
 {
     //1-3
     out<<sim_time<<", "<<Vm<<", "<<var.Istim  \
@@ -222,7 +240,7 @@ void output_currents_csv(std::ostream& out, double sim_time, Model_variables var
 }
 
 // Excitation properties to file
-void output_excitation_properties(std::ostream& out, double sim_time, Model_variables var, double Vm)
+void output_excitation_properties(std::ostream& out, double sim_time, const Model_variables &var, double Vm)
 {
 	//1-3
 	out<<sim_time<<" "<<Vm<<" "<<var.ex_switch      \
@@ -248,7 +266,7 @@ void output_excitation_properties(std::ostream& out, double sim_time, Model_vari
 		<<std::endl;
 }
 
-void output_excitation_properties_csv(std::ostream& out, double sim_time, Model_variables var, double Vm)
+void output_excitation_properties_csv(std::ostream& out, double sim_time, const Model_variables &var, double Vm)
 {
 	//1-3
 	out<<sim_time<<", "<<Vm<<", "<<var.ex_switch      \
@@ -276,7 +294,7 @@ void output_excitation_properties_csv(std::ostream& out, double sim_time, Model_
 // End Common - screen file outputs =============================================================//|
 
 // Integrated Ca handling models only ===========================================================\\|
-void output_CRU(std::ostream& out, double sim_time, Ca_variables Ca, CRU_variables cru, double Vm)
+void output_CRU(std::ostream& out, double sim_time, const Ca_variables &Ca, const CRU_variables &cru, double Vm)
 {
 	//1-2
 	out<<sim_time<<" "<<Vm                 \
@@ -299,7 +317,7 @@ void output_CRU(std::ostream& out, double sim_time, Ca_variables Ca, CRU_variabl
 		<<std::endl;
 }
 
-void output_CRU_csv(std::ostream& out, double sim_time, Ca_variables Ca, CRU_variables cru, double Vm)
+void output_CRU_csv(std::ostream& out, double sim_time, const Ca_variables &Ca, const CRU_variables &cru, double Vm)
 {
 	//1-2
 	out<<sim_time<<", "<<Vm                 \
@@ -374,7 +392,7 @@ void data_2D_XYslice_output(const char *string,  const char * dir, const char *
 		for (int y = 0; y < sc.NY; y++) {
 			for (int x = 0; x < sc.NX; x++){
 				idx = x + (sc.NX*y) + (sc.NX*sc.NY*z);
-				if (sc.geo[idx] > 0)
+				if (SC_geo(&sc, idx) > 0)
 				{
 					if (z == Z) fprintf(out, "%f ", variable[cell_count]);
 					cell_count++;
@@ -404,7 +422,7 @@ void data_2D_XZslice_output(const char *string,  const char * dir, const char *
 		for (int y = 0; y < sc.NY; y++) {
 			for (int x = 0; x < sc.NX; x++){
 				idx = x + (sc.NX*y) + (sc.NX*sc.NY*z);
-				if (sc.geo[idx] > 0)
+				if (SC_geo(&sc, idx) > 0)
 				{
 					if (y == Y) fprintf(out, "%f ", variable[cell_count]);
 					cell_count++;
@@ -434,7 +452,7 @@ void data_2D_YZslice_output(const char *string,  const char * dir, const char *
 		for (int y = 0; y < sc.NY; y++) {
 			for (int x = 0; x < sc.NX; x++){
 				idx = x + (sc.NX*y) + (sc.NX*sc.NY*z);
-				if (sc.geo[idx] > 0)
+				if (SC_geo(&sc, idx) > 0)
 				{
 					if (x == X) fprintf(out, "%f ", variable[cell_count]);
 					cell_count++;
@@ -478,7 +496,7 @@ void vtk_3D_output(const char *string,  const char * dir, const char * dir2, dou
 		for (int y = 0; y < sc.NY; y++) {
 			for (int x = 0; x < sc.NX; x++){
 				idx = x + (sc.NX*y) + (sc.NX*sc.NY*z);
-				if (sc.geo[idx] > 0)
+				if (SC_geo(&sc, idx) > 0)
 				{
 					fprintf(out, "%f ", variable[cell_count]);
 					cell_count++;
@@ -520,9 +538,9 @@ void vtk_3D_output_region_specific(const char *string,  const char * dir, const
         for (int y = 0; y < sc.NY; y++) {
             for (int x = 0; x < sc.NX; x++){
                 idx = x + (sc.NX*y) + (sc.NX*sc.NY*z);
-                if (sc.geo[idx] > 0)
+                if (SC_geo(&sc, idx) > 0)
                 {
-                    if (sc.geo[idx] == region) fprintf(out, "%f ", variable[cell_count]);
+                    if (SC_geo(&sc, idx) == region) fprintf(out, "%f ", variable[cell_count]);
                     else fprintf(out, "-100 ");
                     cell_count++;
                 }
@@ -552,7 +570,7 @@ void data_3D_output(const char *string,  const char * dir, const char * dir2, do
 		for (int y = 0; y < sc.NY; y++) {
 			for (int x = 0; x < sc.NX; x++){
 				idx = x + (sc.NX*y) + (sc.NX*sc.NY*z);
-				if (sc.geo[idx] > 0)
+				if (SC_geo(&sc, idx) > 0)
 				{
 					fprintf(out, "%f ", variable[cell_count]);
 					cell_count++;
@@ -630,7 +648,7 @@ void Output_activation(const char * dir, const char * dir2, Model_variables *v,
 		for (int y = 0; y < sc.NY; y++) {
 			for (int x = 0; x < sc.NX; x++){
 				idx = x + (sc.NX*y) + (sc.NX*sc.NY*z);
-				if (sc.geo[idx] > 0)
+				if (SC_geo(&sc, idx) > 0)
 				{
 					fprintf(out, "%f ", v[cell_count].t_ex);
 					fprintf(out2, "%f ", v[cell_count].t_ex);
@@ -649,6 +667,392 @@ void Output_activation(const char * dir, const char * dir2, Model_variables *v,
 	fclose(out);
 	fclose(out2);
 }
+// VTK XML (binary) ============================================================\\|
+// .vti (ImageData, full box, -100 in empty space) or .vtu (UnstructuredGrid, real cells only)
+// Data is raw appended binary (header_type UInt64), optionally zlib compressed in the block
+// format of vtkZLibDataCompressor. Values may be written as float32 or float64.
+
+// Encoded appended-data block
+typedef struct{
+	unsigned char	*data;
+	size_t			size;
+}VTK_xml_block;
+
+static const size_t VTK_XML_BLOCK_SIZE = 1<<20; // uncompressed bytes per compression block
+
+// Encode nbytes of raw data into a block (header + data), compressed or not
+static void vtk_xml_encode_block(VTK_xml_block *b, const void *raw, size_t nbytes, bool compress)
+{
+	if (compress == false)
+	{
+		unsigned long long n = nbytes;
+		b->size = sizeof(n) + nbytes;
+		b->data = (unsigned char*)malloc(b->size);
+		memcpy(b->data, &n, sizeof(n));
+		memcpy(b->data + sizeof(n), raw, nbytes);
+		return;
+	}
+#ifdef MSCSF_ZLIB
+	size_t nblocks		= (nbytes + VTK_XML_BLOCK_SIZE - 1)/VTK_XML_BLOCK_SIZE;
+	if (nblocks == 0) nblocks = 1;
+	size_t header_n		= 3 + nblocks;
+	size_t bound		= compressBound(VTK_XML_BLOCK_SIZE);
+	unsigned long long *header = (unsigned long long*)malloc(header_n*sizeof(unsigned long long));
+	unsigned char *cdata = (unsigned char*)malloc(nblocks*bound);
+	size_t csize_total	= 0;
+
+	header[0] = nblocks;
+	header[1] = VTK_XML_BLOCK_SIZE;
+	header[2] = nbytes % VTK_XML_BLOCK_SIZE;    // size of final partial block, 0 if full
+	for (size_t i = 0; i < nblocks; i++)
+	{
+		size_t len		= (i == nblocks - 1 && header[2] != 0) ? header[2] : VTK_XML_BLOCK_SIZE;
+		if (nbytes == 0) len = 0;
+		uLongf clen		= bound;
+		if (compress2(cdata + csize_total, &clen, (const Bytef*)raw + i*VTK_XML_BLOCK_SIZE, len, 1) != Z_OK)
+		{
+			printf("ERROR: zlib compression of VTK output failed\n");
+			exit(1);
+		}
+		header[3+i]		= clen;
+		csize_total		+= clen;
+	}
+	b->size = header_n*sizeof(unsigned long long) + csize_total;
+	b->data = (unsigned char*)malloc(b->size);
+	memcpy(b->data, header, header_n*sizeof(unsigned long long));
+	memcpy(b->data + header_n*sizeof(unsigned long long), cdata, csize_total);
+	free(header);
+	free(cdata);
+#else
+	printf("ERROR: compressed VTK output requested but code was compiled without zlib (add -DMSCSF_ZLIB -lz; see Makefile)\n");
+	exit(1);
+#endif
+}
+
+// Encode a scalar field (double) as float32 or float64
+static void vtk_xml_encode_scalars(VTK_xml_block *b, double *values, int n, bool single, bool compress)
+{
+	if (single == false) { vtk_xml_encode_block(b, values, n*sizeof(double), compress); return; }
+	float *f = (float*)malloc(n*sizeof(float));
+	for (int i = 0; i < n; i++) f[i] = (float)values[i];
+	vtk_xml_encode_block(b, f, n*sizeof(float), compress);
+	free(f);
+}
+
+static const char * vtk_xml_byte_order()
+{
+	unsigned short one = 1;
+	return (*(unsigned char*)&one == 1) ? "LittleEndian" : "BigEndian";
+}
+
+// Common file header
+static void vtk_xml_file_header(FILE *out, const char *type, bool compress)
+{
+	fprintf(out, "<?xml version=\"1.0\"?>\n");
+	fprintf(out, "<VTKFile type=\"%s\" version=\"1.0\" byte_order=\"%s\" header_type=\"UInt64\"", type, vtk_xml_byte_order());
+	if (compress == true) fprintf(out, " compressor=\"vtkZLibDataCompressor\"");
+	fprintf(out, ">\n");
+}
+
+// Appended data section and file close; blocks are freed, cells (shared geometry, 4 blocks; may be NULL) are not
+static void vtk_xml_file_appended(FILE *out, VTK_xml_block *blocks, int nblocks, const VTK_xml_block *cells)
+{
+	fprintf(out, "  <AppendedData encoding=\"raw\">\n   _");
+	for (int i = 0; i < nblocks; i++) 
+	{
+		fwrite(blocks[i].data, 1, blocks[i].size, out);
+		free(blocks[i].data);
+	}
+	if (cells != NULL) for (int i = 0; i < 4; i++) fwrite(cells[i].data, 1, cells[i].size, out);
+	fprintf(out, "\n  </AppendedData>\n</VTKFile>\n");
+}
+
+// Points (float32 box coordinates) and vertex cells of all real cells, in cell (1D array) order
+static void vtk_xml_encode_cells(VTK_xml_block *blocks, SC_variables sc, bool compress)
+{
+	float *points		= (float*)malloc(3*sc.N*sizeof(float));
+	int *connectivity	= (int*)malloc(sc.N*sizeof(int));
+	int *offsets		= (int*)malloc(sc.N*sizeof(int));
+	unsigned char *types	= (unsigned char*)malloc(sc.N);
+
+	int cell_count = 0;
+	for (int z = 0; z < sc.NZ; z++) {
+		for (int y = 0; y < sc.NY; y++) {
+			for (int x = 0; x < sc.NX; x++) {
+				if (SC_geo(&sc, x + (sc.NX*y) + (sc.NX*sc.NY*z)) > 0)
+				{
+					points[3*cell_count]	= x;
+					points[3*cell_count+1]	= y;
+					points[3*cell_count+2]	= z;
+					connectivity[cell_count]	= cell_count;
+					offsets[cell_count]		= cell_count + 1;
+					types[cell_count]		= 1;	// VTK_VERTEX
+					cell_count++;
+				}
+			}
+		}
+	}
+	vtk_xml_encode_block(&blocks[0], points, 3*sc.N*sizeof(float), compress);
+	vtk_xml_encode_block(&blocks[1], connectivity, sc.N*sizeof(int), compress);
+	vtk_xml_encode_block(&blocks[2], offsets, sc.N*sizeof(int), compress);
+	vtk_xml_encode_block(&blocks[3], types, sc.N, compress);
+	free(points);
+	free(connectivity);
+	free(offsets);
+	free(types);
+}
+
+// Encoded geometry blocks, built once and shared by Geometry_cells.vtu and every vtu frame (writer
+// threads included); rebuilt only if the geometry or compression changes
+static struct{
+	bool			set;
+	int				N, NX, NY, NZ;
+	bool			compress;
+	VTK_xml_block	blocks[4];
+}vtk_xml_cells_cache = {false};
+static pthread_mutex_t vtk_xml_cells_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static const VTK_xml_block * vtk_xml_cells(SC_variables sc, bool compress)
+{
+	pthread_mutex_lock(&vtk_xml_cells_lock);
+	VTK_xml_block *blocks = vtk_xml_cells_cache.blocks;
+	if (vtk_xml_cells_cache.set == false || vtk_xml_cells_cache.N != sc.N || vtk_xml_cells_cache.NX != sc.NX || vtk_xml_cells_cache.NY != sc.NY 
+			|| vtk_xml_cells_cache.NZ != sc.NZ || vtk_xml_cells_cache.compress != compress)
+	{
+		if (vtk_xml_cells_cache.set == true) for (int i = 0; i < 4; i++) free(blocks[i].data);
+		vtk_xml_encode_cells(blocks, sc, compress);
+		vtk_xml_cells_cache.set		= true;
+		vtk_xml_cells_cache.N		= sc.N;
+		vtk_xml_cells_cache.NX		= sc.NX;
+		vtk_xml_cells_cache.NY		= sc.NY;
+		vtk_xml_cells_cache.NZ		= sc.NZ;
+		vtk_xml_cells_cache.compress	= compress;
+	}
+	pthread_mutex_unlock(&vtk_xml_cells_lock);
+	return blocks;
+}
+
+// Full box (-100 in empty space, as legacy vtk) streamed to the appended section of out in
+// VTK_XML_BLOCK_SIZE chunks, filled from the cell counter; memory does not scale with the box.
+// The file itself is box sized, as vti (ImageData) has no empty space.
+static void vtk_xml_write_box(FILE *out, double *variable, SC_variables sc, bool single, bool compress)
+{
+	size_t value_size	= single ? sizeof(float) : sizeof(double);
+	size_t NXY			= (size_t)sc.NX*sc.NY;
+	size_t nbytes		= NXY*sc.NZ*value_size;
+	size_t nblocks		= (nbytes + VTK_XML_BLOCK_SIZE - 1)/VTK_XML_BLOCK_SIZE;
+	unsigned char *chunk	= (unsigned char*)malloc(VTK_XML_BLOCK_SIZE);
+	unsigned char *cdata	= NULL;
+	unsigned long long *header = NULL;
+	fpos_t header_pos;
+
+	fprintf(out, "  <AppendedData encoding=\"raw\">\n   _");
+	if (compress == false)
+	{
+		unsigned long long n = nbytes;
+		fwrite(&n, sizeof(n), 1, out);
+	}
+	else
+	{
+#ifdef MSCSF_ZLIB
+		// Block sizes are known once compressed; write the header now and fill it in at the end
+		cdata	= (unsigned char*)malloc(compressBound(VTK_XML_BLOCK_SIZE));
+		header	= (unsigned long long*)calloc(3 + nblocks, sizeof(unsigned long long));
+		header[0] = nblocks;
+		header[1] = VTK_XML_BLOCK_SIZE;
+		header[2] = nbytes % VTK_XML_BLOCK_SIZE;
+		fgetpos(out, &header_pos);
+		fwrite(header, sizeof(unsigned long long), 3 + nblocks, out);
+#else
+		printf("ERROR: compressed VTK output requested but code was compiled without zlib (add -DMSCSF_ZLIB -lz; see Makefile)\n");
+		exit(1);
+#endif
+	}
+
+	size_t fill		= 0;
+	size_t iblock	= 0;
+	int cell_count	= 0;
+	for (int z = 0; z < sc.NZ; z++)
+	{
+		for (size_t i = 0; i < NXY; i++)
+		{
+			double v = (SC_geo(&sc, (int)(z*NXY + i)) > 0) ? variable[cell_count++] : -100;
+			if (single == true) { float f = (float)v; memcpy(chunk + fill, &f, sizeof(float)); }
+			else memcpy(chunk + fill, &v, sizeof(double));
+			fill += value_size;
+			if (fill < VTK_XML_BLOCK_SIZE && !(z == sc.NZ - 1 && i == NXY - 1)) continue;
+
+			// Chunk full (or end of box)
+			if (compress == false) fwrite(chunk, 1, fill, out);
+#ifdef MSCSF_ZLIB
+			else
+			{
+				uLongf clen = compressBound(VTK_XML_BLOCK_SIZE);
+				if (compress2(cdata, &clen, chunk, fill, 1) != Z_OK)
+				{
+					printf("ERROR: zlib compression of VTK output failed\n");
+					exit(1);
+				}
+				fwrite(cdata, 1, clen, out);
+				header[3 + iblock] = clen;
+			}
+#endif
+			iblock++;
+			fill = 0;
+		}
+	}
+
+	if (compress == true)
+	{
+		fpos_t end_pos;
+		fgetpos(out, &end_pos);
+		fsetpos(out, &header_pos);
+		fwrite(header, sizeof(unsigned long long), 3 + nblocks, out);
+		fsetpos(out, &end_pos);
+	}
+	fprintf(out, "\n  </AppendedData>\n</VTKFile>\n");
+	free(chunk);
+	free(cdata);
+	free(header);
+}
+
+// Points and Cells sections of a vtu, using blocks[0-3] from vtk_xml_encode_cells, appended from offset
+static void vtk_xml_write_cells(FILE *out, const VTK_xml_block *blocks, size_t offset)
+{
+	fprintf(out, "      <Points>\n");
+	fprintf(out, "        <DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"appended\" offset=\"%zu\"/>\n", offset);
+	offset += blocks[0].size;
+	fprintf(out, "      </Points>\n");
+	fprintf(out, "      <Cells>\n");
+	fprintf(out, "        <DataArray type=\"Int32\" Name=\"connectivity\" format=\"appended\" offset=\"%zu\"/>\n", offset);
+	offset += blocks[1].size;
+	fprintf(out, "        <DataArray type=\"Int32\" Name=\"offsets\" format=\"appended\" offset=\"%zu\"/>\n", offset);
+	offset += blocks[2].size;
+	fprintf(out, "        <DataArray type=\"UInt8\" Name=\"types\" format=\"appended\" offset=\"%zu\"/>\n", offset);
+	fprintf(out, "      </Cells>\n");
+}
+
+void vtk_xml_3D_output(const char *string,  const char * dir, const char * dir2, double *variable, SC_variables sc, int count, const char *format, const char *precision, const char *compression)
+{
+	FILE * out;
+	char str[1000];
+	bool single		= (strcmp(precision, "float") == 0);
+	bool compress	= (strcmp(compression, "Off") != 0);
+	const char *type_name = single ? "Float32" : "Float64";
+
+	if (strcmp(format, "vti") == 0)
+	{
+		// Full box, -100 for empty space (as legacy vtk), streamed slice by slice
+		sprintf(str, "%s/%s/%s_output_%04d.vti", dir, dir2, string, count);
+		out = fopen(str, "wb");
+		vtk_xml_file_header(out, "ImageData", compress);
+		fprintf(out, "  <ImageData WholeExtent=\"0 %d 0 %d 0 %d\" Origin=\"0 0 0\" Spacing=\"1 1 1\">\n", sc.NX-1, sc.NY-1, sc.NZ-1);
+		fprintf(out, "    <Piece Extent=\"0 %d 0 %d 0 %d\">\n", sc.NX-1, sc.NY-1, sc.NZ-1);
+		fprintf(out, "      <PointData Scalars=\"%s\">\n", string);
+		fprintf(out, "        <DataArray type=\"%s\" Name=\"%s\" format=\"appended\" offset=\"0\"/>\n", type_name, string);
+		fprintf(out, "      </PointData>\n");
+		fprintf(out, "    </Piece>\n");
+		fprintf(out, "  </ImageData>\n");
+		vtk_xml_write_box(out, variable, sc, single, compress);
+		fclose(out);
+	}
+	else if (strcmp(format, "vtu") == 0)
+	{
+		// Real cells only; scalars, then the shared (encoded once) geometry blocks
+		VTK_xml_block block;
+		vtk_xml_encode_scalars(&block, variable, sc.N, single, compress);
+		const VTK_xml_block *cells = vtk_xml_cells(sc, compress);
+
+		sprintf(str, "%s/%s/%s_output_%04d.vtu", dir, dir2, string, count);
+		out = fopen(str, "wb");
+		vtk_xml_file_header(out, "UnstructuredGrid", compress);
+		fprintf(out, "  <UnstructuredGrid>\n");
+		fprintf(out, "    <Piece NumberOfPoints=\"%d\" NumberOfCells=\"%d\">\n", sc.N, sc.N);
+		fprintf(out, "      <PointData Scalars=\"%s\">\n", string);
+		fprintf(out, "        <DataArray type=\"%s\" Name=\"%s\" format=\"appended\" offset=\"0\"/>\n", type_name, string);
+		fprintf(out, "      </PointData>\n");
+		vtk_xml_write_cells(out, cells, block.size);
+		fprintf(out, "    </Piece>\n");
+		fprintf(out, "  </UnstructuredGrid>\n");
+		vtk_xml_file_appended(out, &block, 1, cells);
+		fclose(out);
+	}
+	else
+	{
+		printf("ERROR: \"%s\" is not a valid VTK XML format; use vti or vtu\n", format);
+		exit(1);
+	}
+}
+
+// Shared geometry for vtu outputs: real cells in 1D array order with their celltype label
+void vtk_xml_geometry_output(const char * dir, const char * dir2, SC_variables sc, const char *compression)
+{
+	FILE * out;
+	char str[1000];
+	bool compress	= (strcmp(compression, "Off") != 0);
+
+	int *celltype = (int*)malloc(sc.N*sizeof(int));
+	int cell_count = 0;
+	for (int idx = 0; idx < sc.NX*sc.NY*sc.NZ; idx++) if (SC_geo(&sc, idx) > 0) celltype[cell_count++] = SC_geo(&sc, idx);
+
+	VTK_xml_block block;
+	vtk_xml_encode_block(&block, celltype, sc.N*sizeof(int), compress);
+	const VTK_xml_block *cells = vtk_xml_cells(sc, compress);
+	free(celltype);
+
+	sprintf(str, "%s/%s/Geometry_cells.vtu", dir, dir2);
+	out = fopen(str, "wb");
+	vtk_xml_file_header(out, "UnstructuredGrid", compress);
+	fprintf(out, "  <UnstructuredGrid>\n");
+	fprintf(out, "    <Piece NumberOfPoints=\"%d\" NumberOfCells=\"%d\">\n", sc.N, sc.N);
+	fprintf(out, "      <PointData Scalars=\"celltype\">\n");
+	fprintf(out, "        <DataArray type=\"Int32\" Name=\"celltype\" format=\"appended\" offset=\"0\"/>\n");
+	fprintf(out, "      </PointData>\n");
+	vtk_xml_write_cells(out, cells, block.size);
+	fprintf(out, "    </Piece>\n");
+	fprintf(out, "  </UnstructuredGrid>\n");
+	vtk_xml_file_appended(out, &block, 1, cells);
+	fclose(out);
+}
+
+// Quantised (UInt8/UInt16) ImageData of a reduced grid || lib/Output_reduced.cpp
+// Field data: range (min max), decode (scale offset: value = offset + scale*code for code > 0) and empty_code (0, no cells)
+void vtk_xml_quantised_output(const char *string,  const char * dir, const char * dir2, void *data, int bits, int NX, int NY, int NZ, double ox, double oy, double oz, int spacing, double min, double max, int count, const char *compression)
+{
+	FILE * out;
+	char str[1000];
+	bool compress	= (strcmp(compression, "Off") != 0);
+	double scale	= (max - min)/((1 << bits) - 2);    // codes 1..2^bits-1 span [min, max]
+
+	VTK_xml_block block;
+	vtk_xml_encode_block(&block, data, (size_t)NX*NY*NZ*(bits/8), compress);
+
+	sprintf(str, "%s/%s/%s_reduced_%04d.vti", dir, dir2, string, count);
+	out = fopen(str, "wb");
+	vtk_xml_file_header(out, "ImageData", compress);
+	fprintf(out, "  <ImageData WholeExtent=\"0 %d 0 %d 0 %d\" Origin=\"%g %g %g\" Spacing=\"%d %d %d\">\n", NX-1, NY-1, NZ-1, ox, oy, oz, spacing, spacing, spacing);
+	fprintf(out, "    <FieldData>\n");
+	fprintf(out, "      <DataArray type=\"Float64\" Name=\"%s_range\" NumberOfTuples=\"2\" format=\"ascii\">%.17g %.17g</DataArray>\n", string, min, max);
+	fprintf(out, "      <DataArray type=\"Float64\" Name=\"%s_decode\" NumberOfTuples=\"2\" format=\"ascii\">%.17g %.17g</DataArray>\n", string, scale, min - scale);
+	fprintf(out, "      <DataArray type=\"Int32\" Name=\"%s_empty_code\" NumberOfTuples=\"1\" format=\"ascii\">0</DataArray>\n", string);
+	fprintf(out, "    </FieldData>\n");
+	fprintf(out, "    <Piece Extent=\"0 %d 0 %d 0 %d\">\n", NX-1, NY-1, NZ-1);
+	fprintf(out, "      <PointData Scalars=\"%s\">\n", string);
+	fprintf(out, "        <DataArray type=\"%s\" Name=\"%s\" format=\"appended\" offset=\"0\"/>\n", bits == 8 ? "UInt8" : "UInt16", string);
+	fprintf(out, "      </PointData>\n");
+	fprintf(out, "    </Piece>\n");
+	fprintf(out, "  </ImageData>\n");
+	vtk_xml_file_appended(out, &block, 1, NULL);
+	fclose(out);
+}
+
+// Select legacy ASCII vtk or VTK XML output from format string
+void vtk_3D_output_format(const char *string,  const char * dir, const char * dir2, double *variable, SC_variables sc, int count, const char *format, const char *precision, const char *compression)
+{
+	if (strcmp(format, "legacy") == 0) vtk_3D_output(string, dir, dir2, variable, sc, count);
+	else vtk_xml_3D_output(string, dir, dir2, variable, sc, count, format, precision, compression);
+}
+// End VTK XML (binary) ========================================================//|
 // End Spatial outputs  =========================================================================//|
 
 // Settings and initialisation ===========================================================================\\|
@@ -671,6 +1075,10 @@ void output_settings(Simulation_parameters sim, char const * directory, bool DC_
 	printf("\tVoltage clamp is %s || Write state is \"%s\" with reference \"%s\" || Read state is \"%s\" with reference \"%s\"\n", sim.Vclamp, sim.Write_state, sim.state_reference_write, sim.Read_state, sim.state_reference_read);
 	printf("\tBCL = %d ms || NBeats = %d || Total_time = %d ms || Paced_time = %d ms || dt = %f ms\n", sim.BCL, sim.NBeats, sim.Total_time, sim.Paced_time, sim.dt);
 	if (sim.S2_CL > 0) printf("\tS2  = %d ms || NS2   = %d || S2_time = %d\n", sim.S2_CL, sim.NS2, sim.S2_time);
+	if (strcmp(sim.Steady_state, "On") == 0) printf("\tSteady state detection: %d beats within APD90 %g %% || CaT amplitude %g %% || Nai %g %% || CaSR %g %%\n", sim.Steady_state_beats, sim.Steady_state_tol_APD90, sim.Steady_state_tol_CaT, sim.Steady_state_tol_Nai, sim.Steady_state_tol_CaSR);
+	if (strcmp(sim.Periodic_orbit, "On") == 0) printf("\tPeriodic orbit solver: tolerance %g || %d Newton iterations || %d Krylov vectors || %d pre-beats || %d Aitken rounds\n", sim.Periodic_orbit_tol, sim.Periodic_orbit_iterations, sim.Periodic_orbit_krylov, sim.Periodic_orbit_prebeats, sim.Periodic_orbit_aitken);
+	if (strcmp(sim.Restitution, "Off") != 0) printf("\tRestitution protocol: %s || BCL %s (max %d beats each) || S2 %s || window %d ms || ERP threshold %g, resolution %d ms\n", sim.Restitution, sim.Restitution_BCL, sim.Restitution_beats, sim.Restitution_S2, sim.Restitution_window, sim.Restitution_ERP_threshold, sim.Restitution_ERP_resolution);
+	if (strcmp(sim.Sensitivity, "On") == 0) printf("\tForward sensitivities of biomarkers to %s (tangent step %g)\n", sim.Sensitivity_parameters, sim.Sensitivity_step);
 	printf("\nModel settings:\n");
 	printf("\tModel = %s || Celltype = %s || Remodelling = %s*%.2f (max) || Agent = %s*%.2f(max) || Mutation = %s\n\tISO = %f uM/0-sat || ACh = %f uM/0-sat || spatial gradient = %s value %.2f", p.Model, p.Celltype, p.Remodelling, p.Remodelling_prop, p.Agent, p.Agent_prop, p.Mutation, p.ISO, p.ACh, p.spatial_gradient, p.spatial_gradient_prop);
 	if (p.ISO > 0) printf(" || ISO_model = %s\n", p.ISO_model);
@@ -705,6 +1113,10 @@ void output_settings(Simulation_parameters sim, char const * directory, bool DC_
 	fprintf(so, "\tVoltage clamp is %s || Write state is \"%s\" with reference \"%s\" || Read state is \"%s\" with reference \"%s\"\n", sim.Vclamp, sim.Write_state, sim.state_reference_write, sim.Read_state, sim.state_reference_read);
 	fprintf(so,"\tBCL = %d ms || NBeats = %d || Total_time = %d ms || Paced_time = %d ms || dt = %f ms\n", sim.BCL, sim.NBeats, sim.Total_time, sim.Paced_time, sim.dt);
 	if (sim.S2_CL > 0) fprintf(so, "\tS2  = %d ms || NS2   = %d || S2_time = %d\n", sim.S2_CL, sim.NS2, sim.S2_time);
+	if (strcmp(sim.Steady_state, "On") == 0) fprintf(so, "\tSteady state detection: %d beats within APD90 %g %% || CaT amplitude %g %% || Nai %g %% || CaSR %g %%\n", sim.Steady_state_beats, sim.Steady_state_tol_APD90, sim.Steady_state_tol_CaT, sim.Steady_state_tol_Nai, sim.Steady_state_tol_CaSR);
+	if (strcmp(sim.Periodic_orbit, "On") == 0) fprintf(so, "\tPeriodic orbit solver: tolerance %g || %d Newton iterations || %d Krylov vectors || %d pre-beats || %d Aitken rounds\n", sim.Periodic_orbit_tol, sim.Periodic_orbit_iterations, sim.Periodic_orbit_krylov, sim.Periodic_orbit_prebeats, sim.Periodic_orbit_aitken);
+	if (strcmp(sim.Restitution, "Off") != 0) fprintf(so, "\tRestitution protocol: %s || BCL %s (max %d beats each) || S2 %s || window %d ms || ERP threshold %g, resolution %d ms\n", sim.Restitution, sim.Restitution_BCL, sim.Restitution_beats, sim.Restitution_S2, sim.Restitution_window, sim.Restitution_ERP_threshold, sim.Restitution_ERP_resolution);
+	if (strcmp(sim.Sensitivity, "On") == 0) fprintf(so, "\tForward sensitivities of biomarkers to %s (tangent step %g)\n", sim.Sensitivity_parameters, sim.Sensitivity_step);
 	fprintf(so,"Model settings:\n");
 	fprintf(so, "\tModel = %s || Celltype = %s || Remodelling = %s*%.2f (max) || Agent = %s*%.2f(max) || Mutation = %s\n\tISO = %f uM/0-sat || ACh = %f uM/0-sat || spatial gradient = %s value %.2f", p.Model, p.Celltype, p.Remodelling, p.Remodelling_prop, p.Agent, p.Agent_prop, p.Mutation, p.ISO, p.ACh, p.spatial_gradient, p.spatial_gradient_prop);
 	if (p.ISO > 0) fprintf(so, " || ISO_model = %s\n", p.ISO_model);
@@ -783,6 +1195,19 @@ void output_settings_tissue(Simulation_parameters sim, Tissue_parameters t, char
 	if (strcmp(t.Global_orientation_direction, "Off") != 0) printf("\t\tGlobal orientation was set by direction %s\n", t.Global_orientation_direction);
     printf("\tTime range over which spatial data will be output (if intervals != 0) = %d to %d\n", sim.Spatial_output_start_time, sim.Spatial_output_end_time);
 	printf("\tSpatial output interval (vtk) = %d ms Spatial output interval (data) = %d ms\n", sim.Spatial_output_interval_vtk, sim.Spatial_output_interval_data);
+	printf("\tAsynchronous spatial output is %s (writers = %d, snapshot buffers = %d)\n", sim.Spatial_output_async, sim.Spatial_output_writers, sim.Spatial_output_buffers);
+	printf("\tSpatial vtk format = %s (precision = %s, compression = %s)\n", sim.Spatial_output_vtk_format, sim.Spatial_output_precision, sim.Spatial_output_compression);
+	printf("\tSpatial data format = %s\n", sim.Spatial_output_data_format);
+	if (sim.Checkpoint_interval > 0) printf("\tCheckpoint interval = %.2f ms (keeping %d; %d deltas between full checkpoints; compression = %s)\n", sim.Checkpoint_interval, sim.Checkpoint_keep, sim.Checkpoint_deltas, sim.Checkpoint_compression);
+	if (strcmp(sim.S2_sweep, "Off") != 0) printf("\tS2 sweep = %s (sites %s; S2 = %s ms; resolution %d ms; window %d ms)\n", sim.S2_sweep, sim.S2_sweep_locations, sim.S2_sweep_CL, sim.S2_sweep_resolution, sim.S2_sweep_window);
+	if (strcmp(sim.Beat_maps, "On") == 0) printf("\tPer-beat activation, APD (%s %%) and CV maps\n", sim.Beat_maps_APD);
+	if (strcmp(sim.Pseudo_ECG, "On") == 0) printf("\tPseudo-ECG: electrodes %s || bipolar leads %s\n", sim.Pseudo_ECG_electrodes, sim.Pseudo_ECG_leads);
+	if (strcmp(sim.Phase_singularity, "On") == 0) printf("\tPhase singularity tracking: every %d ms || delay %d ms || radius %g mm\n", sim.Phase_singularity_interval, sim.Phase_singularity_delay, sim.Phase_singularity_radius);
+	if (strcmp(sim.Probe_file, "Off") != 0) printf("\tCell probes: %s\n", sim.Probe_file);
+	if (strcmp(sim.Regional_outputs, "Off") != 0) printf("\tRegional outputs: %s || %s || every %d ms\n", sim.Regional_outputs, sim.Regional_outputs_stats, sim.Regional_outputs_interval);
+	printf("\tTissue setup cache: %s || setup diagnostics: %s\n", sim.Tissue_cache, sim.Setup_diagnostics);
+	if (strcmp(sim.Read_checkpoint, "Off") != 0) printf("\tRestarting from checkpoint %s\n", sim.Read_checkpoint);
+	if (sim.Spatial_output_interval_reduced > 0) printf("\tReduced spatial output interval = %d ms (%s; stride %d, %s, %d-bit, ROI %s)\n", sim.Spatial_output_interval_reduced, sim.Spatial_output_reduced_variables, sim.Spatial_output_reduced_stride, sim.Spatial_output_reduced_mode, sim.Spatial_output_reduced_bits, sim.Spatial_output_reduced_ROI);
 	printf("*************************************************************************************************************\n\n");
 
 	// File
@@ -810,6 +1235,19 @@ void output_settings_tissue(Simulation_parameters sim, Tissue_parameters t, char
 	if (strcmp(t.Global_orientation_direction, "Off") != 0) fprintf(so, "\t\tGlobal orientation was set by direction %s\n", t.Global_orientation_direction);
     fprintf(so, "\tTime range over which spatial data will be output (if intervals != 0) = %d to %d\n", sim.Spatial_output_start_time, sim.Spatial_output_end_time);
 	fprintf(so, "\tSpatial output interval (vtk) = %d ms Spatial output interval (data) = %d ms\n", sim.Spatial_output_interval_vtk, sim.Spatial_output_interval_data);
+	fprintf(so, "\tAsynchronous spatial output is %s (writers = %d, snapshot buffers = %d)\n", sim.Spatial_output_async, sim.Spatial_output_writers, sim.Spatial_output_buffers);
+	fprintf(so, "\tSpatial vtk format = %s (precision = %s, compression = %s)\n", sim.Spatial_output_vtk_format, sim.Spatial_output_precision, sim.Spatial_output_compression);
+	fprintf(so, "\tSpatial data format = %s\n", sim.Spatial_output_data_format);
+	if (sim.Checkpoint_interval > 0) fprintf(so, "\tCheckpoint interval = %.2f ms (keeping %d; %d deltas between full checkpoints; compression = %s)\n", sim.Checkpoint_interval, sim.Checkpoint_keep, sim.Checkpoint_deltas, sim.Checkpoint_compression);
+	if (strcmp(sim.S2_sweep, "Off") != 0) fprintf(so, "\tS2 sweep = %s (sites %s; S2 = %s ms; resolution %d ms; window %d ms)\n", sim.S2_sweep, sim.S2_sweep_locations, sim.S2_sweep_CL, sim.S2_sweep_resolution, sim.S2_sweep_window);
+	if (strcmp(sim.Beat_maps, "On") == 0) fprintf(so, "\tPer-beat activation, APD (%s %%) and CV maps\n", sim.Beat_maps_APD);
+	if (strcmp(sim.Pseudo_ECG, "On") == 0) fprintf(so, "\tPseudo-ECG: electrodes %s || bipolar leads %s\n", sim.Pseudo_ECG_electrodes, sim.Pseudo_ECG_leads);
+	if (strcmp(sim.Phase_singularity, "On") == 0) fprintf(so, "\tPhase singularity tracking: every %d ms || delay %d ms || radius %g mm\n", sim.Phase_singularity_interval, sim.Phase_singularity_delay, sim.Phase_singularity_radius);
+	if (strcmp(sim.Probe_file, "Off") != 0) fprintf(so, "\tCell probes: %s\n", sim.Probe_file);
+	if (strcmp(sim.Regional_outputs, "Off") != 0) fprintf(so, "\tRegional outputs: %s || %s || every %d ms\n", sim.Regional_outputs, sim.Regional_outputs_stats, sim.Regional_outputs_interval);
+	fprintf(so, "\tTissue setup cache: %s || setup diagnostics: %s\n", sim.Tissue_cache, sim.Setup_diagnostics);
+	if (strcmp(sim.Read_checkpoint, "Off") != 0) fprintf(so, "\tRestarting from checkpoint %s\n", sim.Read_checkpoint);
+	if (sim.Spatial_output_interval_reduced > 0) fprintf(so, "\tReduced spatial output interval = %d ms (%s; stride %d, %s, %d-bit, ROI %s)\n", sim.Spatial_output_interval_reduced, sim.Spatial_output_reduced_variables, sim.Spatial_output_reduced_stride, sim.Spatial_output_reduced_mode, sim.Spatial_output_reduced_bits, sim.Spatial_output_reduced_ROI);
 
 	fclose(so);
 }
@@ -832,6 +1270,12 @@ void output_settings_3D_cell(Cell_parameters p, Simulation_parameters sim, CRU_v
 	printf("\tsub-space coupling time constants are set to \"%s\", corresponding to transverse = %.2f ms and longitudinal = %.2f ms\n", p.tau_ss_type, p.tau_ss_trans, p.tau_ss_long);
     printf("\tTime range over which spatial data will be output (if intervals != 0) = %d to %d\n", sim.Spatial_output_start_time, sim.Spatial_output_end_time);
 	printf("\tSpatial output interval (vtk) = %d ms Spatial output interval (data) = %d ms\n", sim.Spatial_output_interval_vtk, sim.Spatial_output_interval_data);
+	printf("\tAsynchronous spatial output is %s (writers = %d, snapshot buffers = %d)\n", sim.Spatial_output_async, sim.Spatial_output_writers, sim.Spatial_output_buffers);
+	printf("\tSpatial vtk format = %s (precision = %s, compression = %s)\n", sim.Spatial_output_vtk_format, sim.Spatial_output_precision, sim.Spatial_output_compression);
+	printf("\tSpatial data format = %s\n", sim.Spatial_output_data_format);
+	if (sim.Checkpoint_interval > 0) printf("\tCheckpoint interval = %.2f ms (keeping %d; %d deltas between full checkpoints; compression = %s)\n", sim.Checkpoint_interval, sim.Checkpoint_keep, sim.Checkpoint_deltas, sim.Checkpoint_compression);
+	if (strcmp(sim.Read_checkpoint, "Off") != 0) printf("\tRestarting from checkpoint %s\n", sim.Read_checkpoint);
+	if (sim.Spatial_output_interval_reduced > 0) printf("\tReduced spatial output interval = %d ms (%s; stride %d, %s, %d-bit, ROI %s)\n", sim.Spatial_output_interval_reduced, sim.Spatial_output_reduced_variables, sim.Spatial_output_reduced_stride, sim.Spatial_output_reduced_mode, sim.Spatial_output_reduced_bits, sim.Spatial_output_reduced_ROI);
 	if (strcmp(sim.Delayed_CaSR_IC, "On") == 0) printf("\tCaSR IC will be imposed at a initiation AND a delayed time of %f ms\n", sim.CaSR_IC_delay);
 
     if (strcmp(cru.Detub, "On") == 0 || strcmp(cru.SERCA_het, "On") == 0 || strcmp(cru.RyR_het, "Off") != 0 || strcmp(cru.LTCC_het, "Off") != 0 || strcmp(cru.volds_het, "Off") != 0) printf("\tSub-cellular heterogeneity/variability is On:\n");
@@ -858,6 +1302,12 @@ void output_settings_3D_cell(Cell_parameters p, Simulation_parameters sim, CRU_v
 	fprintf(so, "\tsub-space coupling time constants are set to \"%s\", corresponding to transverse = %.2f ms and longitudinal = %.2f ms\n", p.tau_ss_type, p.tau_ss_trans, p.tau_ss_long);
     fprintf(so, "\tTime range over which spatial data will be output (if intervals != 0) = %d to %d\n", sim.Spatial_output_start_time, sim.Spatial_output_end_time);
 	fprintf(so, "\tSpatial output interval (vtk) = %d ms Spatial output interval (data) = %d ms\n", sim.Spatial_output_interval_vtk, sim.Spatial_output_interval_data);
+	fprintf(so, "\tAsynchronous spatial output is %s (writers = %d, snapshot buffers = %d)\n", sim.Spatial_output_async, sim.Spatial_output_writers, sim.Spatial_output_buffers);
+	fprintf(so, "\tSpatial vtk format = %s (precision = %s, compression = %s)\n", sim.Spatial_output_vtk_format, sim.Spatial_output_precision, sim.Spatial_output_compression);
+	fprintf(so, "\tSpatial data format = %s\n", sim.Spatial_output_data_format);
+	if (sim.Checkpoint_interval > 0) fprintf(so, "\tCheckpoint interval = %.2f ms (keeping %d; %d deltas between full checkpoints; compression = %s)\n", sim.Checkpoint_interval, sim.Checkpoint_keep, sim.Checkpoint_deltas, sim.Checkpoint_compression);
+	if (strcmp(sim.Read_checkpoint, "Off") != 0) fprintf(so, "\tRestarting from checkpoint %s\n", sim.Read_checkpoint);
+	if (sim.Spatial_output_interval_reduced > 0) fprintf(so, "\tReduced spatial output interval = %d ms (%s; stride %d, %s, %d-bit, ROI %s)\n", sim.Spatial_output_interval_reduced, sim.Spatial_output_reduced_variables, sim.Spatial_output_reduced_stride, sim.Spatial_output_reduced_mode, sim.Spatial_output_reduced_bits, sim.Spatial_output_reduced_ROI);
 	if (strcmp(sim.Delayed_CaSR_IC, "On") == 0) fprintf(so, "\tCaSR IC will be imposed at a initiation AND a delayed time of %f ms\n", sim.CaSR_IC_delay);
 
     if (strcmp(cru.Detub, "On") == 0 || strcmp(cru.SERCA_het, "On") == 0 || strcmp(cru.RyR_het, "Off") != 0 || strcmp(cru.LTCC_het, "Off") != 0 || strcmp(cru.volds_het, "Off") != 0) fprintf(so, "\tSub-cellular heterogeneity/variability is On:\n");
@@ -78,15 +78,16 @@
 
 // Global output functions
 void output_properties_to_screen(const char * log_reference, Model_variables var, Simulation_parameters Sim);
-void output_currents(std::ostream& out, double sim_time, Model_variables var, State_variables s, double Vm);
-void output_excitation_properties(std::ostream& out, double sim_time, Model_variables var, double Vm);
+void output_properties_line(FILE *out, Model_variables var, int BCL, int S2_CL);
+void output_currents(std::ostream& out, double sim_time, const Model_variables &var, const State_variables &s, double Vm);
+void output_excitation_properties(std::ostream& out, double sim_time, const Model_variables &var, double Vm);
 
-void output_currents_csv(std::ostream& out, double sim_time, Model_variables var, State_variables s, double Vm);
-void output_excitation_properties_csv(std::ostream& out, double sim_time, Model_variables var, double Vm);
+void output_currents_csv(std::ostream& out, double sim_time, const Model_variables &var, const State_variables &s, double Vm);
+void output_excitation_properties_csv(std::ostream& out, double sim_time, const Model_variables &var, double Vm);
 
 // Integrated Ca handling models only
-void output_CRU(std::ostream& out, double sim_time, Ca_variables Ca, CRU_variables cru, double Vm);
-void output_CRU_csv(std::ostream& out, double sim_time, Ca_variables Ca, CRU_variables cru, double Vm);
+void output_CRU(std::ostream& out, double sim_time, const Ca_variables &Ca, const CRU_variables &cru, double Vm);
+void output_CRU_csv(std::ostream& out, double sim_time, const Ca_variables &Ca, const CRU_variables &cru, double Vm);
 
 // Spatial outputs (3D cell and tissue models)
 void linescan_out_X(std::ostream& out, SC_variables sc, double * variable, int y, int z);
@@ -102,6 +103,12 @@ void Output_activation(const char * dir, const char * dir2, Model_variables *v,
 void data_3D_output(const char *string,  const char * dir, const char * dir2, double *variable, SC_variables sc, int count);
 void array_1D_binary_read(const char *string,  const char * dir, const char * dir2, double *variable, SC_variables sc, int count);
 
+// Binary VTK XML spatial outputs (.vti full box / .vtu real cells only)
+void vtk_xml_3D_output(const char *string,  const char * dir, const char * dir2, double *variable, SC_variables sc, int count, const char *format, const char *precision, const char *compression);
+void vtk_xml_geometry_output(const char * dir, const char * dir2, SC_variables sc, const char *compression);
+void vtk_xml_quantised_output(const char *string,  const char * dir, const char * dir2, void *data, int bits, int NX, int NY, int NZ, double ox, double oy, double oz, int spacing, double min, double max, int count, const char *compression);
+void vtk_3D_output_format(const char *string,  const char * dir, const char * dir2, double *variable, SC_variables sc, int count, const char *format, const char *precision, const char *compression);
+
 // Settings
 void output_settings(Simulation_parameters sim, char const * directory, bool DC_current_mod_arg, Cell_parameters p, int argc, char *argin[]);
 void output_settings_tissue(Simulation_parameters sim, Tissue_parameters t, char const * directory);
@@ -0,0 +1,484 @@
+// Source code associated with  ===========================  //
+// "Multi-scale cardiac simulation framework" =============  //
+// For simulation of cardiac cellular and tissue dynamics =  //
+// from the spatial cellular to full organ scales. ========  //
+// With implementation of multiple, published cell models =  //
+// as well as novel models developed in my lab. ===========  //
+// ========================================================  //
+// This file: Periodic orbit (limit cycle) ================  //
+// solver for paced initial conditions ====================  //
+// ========================================================  //
+// GNU 3 LICENSE TEXT =====================================  //
+// COPYRIGHT (C) 2016-2019 MICHAEL A. COLMAN ==============  //
+// THIS PROGRAM IS FREE SOFTWARE: YOU CAN REDISTRIBUTE IT =  //
+// AND/OR MODIFY IT UNDER THE TERMS OF THE GNU GENERAL ====  //
+// PUBLIC LICENSE AS PUBLISHED BY THE FREE SOFTWARE =======  //
+// FOUNDATION, EITHER VERSION 3 OF THE LICENSE, OR (AT YOUR  //
+// OPTION) ANY LATER VERSION. =============================  //
+// THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE=  //
+// USEFUL, BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE =====  //
+// IMPLIED WARRANTY OF MERCHANTABILITY OR FITNESS FOR A ===  //
+// PARTICULAR PURPOSE.  SEE THE GNU GENERAL PUBLIC LICENSE=  //
+// FOR MORE DETAILS. ======================================  //
+// YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL =====  //
+// PUBLIC LICENSE ALONG WITH THIS PROGRAM.  IF NOT, SEE ===  //
+// <https://www.gnu.org/licenses/>. =======================  //
+// ========================================================  //
+// ADDITIONAL LICENSE TEXT ================================  //
+// THIS SOFTWARE IS PROVIDED OPEN SOURCE AND MAY BE FREELY=  //
+// USED, DISTRIBUTED AND UPDATED, PROVIDED: ===============  //
+//  (i) THE APPROPRIATE WORK(S) IS(ARE) CITED. THIS =======  //
+//      PERTAINS TO THE CITATION OF COLMAN 2019 PLOS COMP =  //
+//      BIOL (FOR THIS IMPLEMTATION) AND ALL WORKS ========  //
+//      ASSOCIATED WITH THE SPECIFIC MODELS AND COMPONENTS=  //
+//      USED IN PARTICULAR SIMULATIONS. IT IS THE USER'S ==  //
+//      RESPONSIBILITY TO ENSURE ALL RELEVANT WORKS ARE ===  //
+//      CITED. PLEASE SEE FULL DOCUMENTATION AND ON-SCREEN=  //
+//      DISCLAIMER OUTPUTS FOR A GUIDE. ===================  //
+//  (ii) ALL OF THIS TEXT IS RETAINED WITHIN OR ASSOCIATED=  //
+//      WITH THE SOURCE CODE AND/OR BINARY FORM OF THE ====  //
+//      SOFTWARE. =========================================  //
+// ========================================================  //
+// ANY INTENDED COMMERCIAL USE OF THIS SOFTWARE MUST BE BY   //
+// EXPRESS PERMISSION OF MICHAEL A COLMAN ONLY. IN NO EVENT  //
+// ARE THE COPYRIGHT HOLDERS LIABLE FOR ANY DIRECT, =======  //
+// INDIRECT INCIDENTAL, SPECIAL, EXEMPLARY OR CONSEQUENTIAL  //
+// DAMAGES ASSOCIATED WITH USE OF THIS SOFTWARE ===========  //
+// ========================================================  //
+// THIS SOFTWARE CONTAINS IMPLEMENTATIONS OF MODELS AND ===  //
+// COMPONENTS WHICH I (MICHAEL COLMAN) DID NOT DEVELOP.====  //
+// ALL OF THESE COMPONENTS HAVE BEEN CODED FROM PROVIDED ==  //
+// SOURCE CODE OR INFORMATION IN THE PUBLICATIONS. ========  //
+// I CLAIM NO RIGHTS OR INTELLECTUAL PROPERTY OWNERSHIP ===  //
+// FOR THESE MODELS AND COMPONENTS, OTHER THAN THEIR ======  //
+// SPECIFIC IMPLEMENTATION IN THIS CODE PACKAGE. FURTHER TO  //
+// THE ABOVE STATEMENT, ANY INDTENDED COMMERCIAL USE OF ===  //
+// THOSE COMPONENTS MUST BE BY EXPRESS PERMISSION OF THE ==  //
+// ORIGINAL COPYRIGHT HOLDERS. ============================  //
+// WHERE IMPLEMENTED FROM PROVIDED CODE, ANY DISCLAIMERS ==  //
+// PRESENT IN THE ORIGINAL CODE HAVE BEEN RETAINED IN THE =  //
+// RELEVANT FILE. =========================================  //
+// ========================================================  //
+// Contact: m.a.colman@leeds.ac.uk ========================  //
+// For updates, corrections etc, please check: ============  //
+// 1. http://physicsoftheheart.com/ =======================  //
+// 2. https://github.com/michaelcolman ====================  //
+// ========================================================  //
+
+#include "Periodic_orbit.h"
+#include "Structs.h"
+#include "Model.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <sys/time.h>
+
+// Function list ================================================================================\\|
+//	periodic_orbit_init()
+//	periodic_orbit_solve()
+//	periodic_orbit_solve_native()
+//	periodic_orbit_free()
+//
+//	Internal
+//	    po_wtime()
+//	    po_residual()
+//	    po_jv()
+//	    po_gmres()
+//	    po_aitken()
+//	    po_beat_native()
+// End Function list ============================================================================//|
+
+// Notes ========================================================================================\\|
+// Slow variables ([Na]i, [K]i, SR load) can take hundreds or thousands of beats to settle when 
+// pacing. Here one BCL (stimulus at the start) is treated as a map P from the state at the start of
+// a beat to the state at the start of the next, and its fixed point P(x) = x (the limit cycle at 
+// that BCL) is found directly:
+//  1. Pre-pacing: Periodic_orbit_prebeats plain beats, so that fast variables are on the cycle; 
+//     components that do not change over a beat (parameters held in the state struct, variables 
+//     of other models) are left out of the solve
+//  2. Aitken: Periodic_orbit_aitken rounds of two beats; components that converge geometrically 
+//     and slowly (ratio of successive changes 0.5-1) are extrapolated by Aitken's delta-squared
+//     (step limited to 20% of the value; a round that increases the residual is discarded)
+//  3. Newton-Krylov: (J - I) d = -(P(x) - x), J the Jacobian of P, solved by GMRES with 
+//     finite-difference Jacobian-vector products (one beat per product), in variables scaled by
+//     their magnitude. Fast variables give eigenvalues of J near 0 and only the slow modes need 
+//     Krylov vectors, so GMRES usually converges in a few iterations. Step halved until the 
+//     residual decreases; if it never does the full step is taken
+//  4. Check: a few plain beats from the solution; the max relative change per beat is reported 
+//     (an unstable cycle, e.g. with alternans, is found by Newton but drifts away when paced)
+// Residual and convergence history are written to Periodic_orbit_log.dat.
+// End Notes ====================================================================================//|
+
+#define PO_CHECK_BEATS  5
+
+// Internal =====================================================================================\\|
+static double po_wtime()
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + 1e-6*tv.tv_usec;
+}
+
+// Max relative residual over active components; -1 if not finite
+static double po_residual(Periodic_orbit *po, double *x, double *Px)
+{
+	double r = 0;
+	for (int a = 0; a < po->Nactive; a++)
+	{
+		int i       = po->active[a];
+		double g    = fabs(Px[i] - x[i])/po->scale[i];
+		if (!isfinite(g)) return -1;
+		if (g > r) r = g;
+	}
+	return r;
+}
+
+// out = (J - I) v, scaled: one beat from x + eps*S*v
+static void po_jv(Periodic_orbit *po, double *x, double *Px, double *v, double *out, double *work, Periodic_orbit_map map, void *context)
+{
+	double vnorm = 0;
+	for (int a = 0; a < po->Nactive; a++) vnorm += v[a]*v[a];
+	vnorm = sqrt(vnorm);
+	if (vnorm == 0)
+	{
+		for (int a = 0; a < po->Nactive; a++) out[a] = 0;
+		return;
+	}
+	double eps = 1e-7*(1 + sqrt((double)po->Nactive))/vnorm;
+
+	memcpy(work, x, po->n*sizeof(double));
+	for (int a = 0; a < po->Nactive; a++) work[po->active[a]] += eps*po->scale[po->active[a]]*v[a];
+	map(work, context);
+	po->Nbeats++;
+	for (int a = 0; a < po->Nactive; a++)
+	{
+		int i   = po->active[a];
+		out[a]  = (work[i] - Px[i])/(eps*po->scale[i]) - v[a];
+	}
+}
+
+// GMRES (no restart) for (J - I) d = b from d = 0; stops at relative residual eta or po->krylov 
+// vectors; returns the number of Krylov vectors used
+static int po_gmres(Periodic_orbit *po, double *x, double *Px, double *b, double *d, double eta, double *work, Periodic_orbit_map map, void *context)
+{
+	int nA  = po->Nactive;
+	int m   = po->krylov;
+	double *V   = (double*)calloc((size_t)(m+1)*nA, sizeof(double));
+	double *H   = (double*)calloc((size_t)(m+1)*m, sizeof(double));
+	double *cs  = (double*)calloc(m, sizeof(double));
+	double *sn  = (double*)calloc(m, sizeof(double));
+	double *g   = (double*)calloc(m+1, sizeof(double));
+	double *y   = (double*)calloc(m, sizeof(double));
+
+	double beta = 0;
+	for (int a = 0; a < nA; a++) beta += b[a]*b[a];
+	beta = sqrt(beta);
+	for (int a = 0; a < nA; a++) d[a] = 0;
+	if (beta == 0) { free(V); free(H); free(cs); free(sn); free(g); free(y); return 0; }
+
+	for (int a = 0; a < nA; a++) V[a] = b[a]/beta;
+	g[0]    = beta;
+	int k   = 0;
+	for (k = 0; k < m; k++)
+	{
+		double *w = &V[(size_t)(k+1)*nA];
+		po_jv(po, x, Px, &V[(size_t)k*nA], w, work, map, context);
+
+		// Modified Gram-Schmidt
+		for (int j = 0; j <= k; j++)
+		{
+			double h = 0;
+			for (int a = 0; a < nA; a++) h += w[a]*V[(size_t)j*nA + a];
+			H[j*m + k] = h;
+			for (int a = 0; a < nA; a++) w[a] -= h*V[(size_t)j*nA + a];
+		}
+		double hn = 0;
+		for (int a = 0; a < nA; a++) hn += w[a]*w[a];
+		hn = sqrt(hn);
+		H[(k+1)*m + k] = hn;
+		if (hn > 0) for (int a = 0; a < nA; a++) w[a] /= hn;
+
+		// Givens rotations
+		for (int j = 0; j < k; j++)
+		{
+			double t        = cs[j]*H[j*m + k] + sn[j]*H[(j+1)*m + k];
+			H[(j+1)*m + k]  = -sn[j]*H[j*m + k] + cs[j]*H[(j+1)*m + k];
+			H[j*m + k]      = t;
+		}
+		double r    = sqrt(H[k*m + k]*H[k*m + k] + hn*hn);
+		cs[k]       = (r > 0) ? H[k*m + k]/r : 1;
+		sn[k]       = (r > 0) ? hn/r : 0;
+		H[k*m + k]  = r;
+		H[(k+1)*m + k] = 0;
+		g[k+1]      = -sn[k]*g[k];
+		g[k]        = cs[k]*g[k];
+
+		if (fabs(g[k+1]) <= eta*beta || hn == 0) { k++; break; }
+	}
+
+	// Back substitution and update
+	for (int j = k-1; j >= 0; j--)
+	{
+		double t = g[j];
+		for (int l = j+1; l < k; l++) t -= H[j*m + l]*y[l];
+		y[j] = (H[j*m + j] != 0) ? t/H[j*m + j] : 0;
+	}
+	for (int j = 0; j < k; j++) for (int a = 0; a < nA; a++) d[a] += y[j]*V[(size_t)j*nA + a];
+
+	free(V); free(H); free(cs); free(sn); free(g); free(y);
+	return k;
+}
+
+// Aitken delta-squared on slowly, geometrically converging components; returns number extrapolated
+static int po_aitken(Periodic_orbit *po, double *x, double *work, double *work2, Periodic_orbit_map map, void *context)
+{
+	memcpy(work, x, po->n*sizeof(double));
+	map(work, context);
+	memcpy(work2, work, po->n*sizeof(double));
+	map(work2, context);
+	po->Nbeats += 2;
+
+	int Nextrapolated = 0;
+	for (int a = 0; a < po->Nactive; a++)
+	{
+		int i       = po->active[a];
+		double d1   = work[i] - x[i];
+		double d2   = work2[i] - work[i];
+		x[i]        = work2[i];
+		if (d1 == 0) continue;
+		double r    = d2/d1;
+		if (r <= 0.5 || r >= 1) continue;   // fast or not geometric
+
+		double step = d2*r/(1 - r);
+		double max  = 0.2*fabs(work2[i]);
+		if (max > 0 && fabs(step) > max) step = (step > 0) ? max : -max;
+		x[i]        += step;
+		Nextrapolated++;
+	}
+	return Nextrapolated;
+}
+
+// Native single cell models: one BCL from x (state at the stimulus), as the time loop of 
+// Single_cell_native_main.cc
+typedef struct{
+	Cell_parameters     p;
+	Model_variables     var;        // at the start of the solve; reset for every beat
+	double              dt;
+	int                 BCL_int;
+	double              BCL;
+}Po_native;
+
+static void po_beat_native(double *x, void *context)
+{
+	Po_native *c    = (Po_native*)context;
+	Model_variables var = c->var;
+	State_variables s;
+	memcpy(&s, x, sizeof(State_variables));
+	double Vm       = s.Vm;
+
+	for (int i = 0; i < c->BCL_int; i++)
+	{
+		compute_Istim(c->p, &var, c->BCL, 0, i*c->dt, i);     // lib/Model.c || stimulus at i = 0 only
+		compute_model_native(c->p, &var, &s, Vm, c->dt);    // lib/Model.c
+		s.Vm    = s.Vm + c->dt*(-(var.Itot + var.Istim + var.Istim_S2));
+		Vm      = s.Vm;
+	}
+	memcpy(x, &s, sizeof(State_variables));
+}
+// End Internal =================================================================================//|
+
+// Setup ========================================================================================\\|
+void periodic_orbit_init(Periodic_orbit *po, Simulation_parameters sim, int n, const char *directory)
+{
+	memset(po, 0, sizeof(Periodic_orbit));
+	if (strcmp(sim.Periodic_orbit, "On") != 0) return;
+
+	po->on          = true;
+	po->tol         = sim.Periodic_orbit_tol;
+	po->max_newton  = sim.Periodic_orbit_iterations;
+	po->krylov      = sim.Periodic_orbit_krylov;
+	po->prebeats    = sim.Periodic_orbit_prebeats;
+	po->aitken      = sim.Periodic_orbit_aitken;
+	po->n           = n;
+	po->active      = (int*)malloc(n*sizeof(int));
+	po->scale       = (double*)malloc(n*sizeof(double));
+
+	po->log         = NULL;     // no log if directory is NULL (e.g. once per BCL in lib/Restitution.cpp)
+	if (directory != NULL)
+	{
+		char *filename  = (char*)malloc(1000);
+		if (sim.Windows == true)    sprintf(filename, "%s\\Periodic_orbit_log.dat", directory);
+		else                        sprintf(filename, "%s/Periodic_orbit_log.dat", directory);
+		po->log         = fopen(filename, "wt");
+		if (po->log == NULL)
+		{
+			printf("ERROR: cannot open %s\n", filename);
+			exit(1);
+		}
+		fprintf(po->log, "# stage iteration beats_total residual(max relative |P(x)-x|/|x|) krylov_vectors step_length\n");
+		free(filename);
+	}
+}
+// End Setup ====================================================================================//|
+
+// Solve ========================================================================================\\|
+// x: state at the start of a beat; on return the fixed point (or best estimate) 
+bool periodic_orbit_solve(Periodic_orbit *po, double *x, Periodic_orbit_map map, void *context)
+{
+	int n           = po->n;
+	double *x0      = (double*)malloc(n*sizeof(double));
+	double *Px      = (double*)malloc(n*sizeof(double));
+	double *xt      = (double*)malloc(n*sizeof(double));
+	double *Pt      = (double*)malloc(n*sizeof(double));
+	double *work    = (double*)malloc(n*sizeof(double));
+	double *x1      = (double*)malloc(n*sizeof(double));
+	double *P1      = (double*)malloc(n*sizeof(double));
+	double t0       = po_wtime();
+
+	printf("Periodic orbit: %d pre-beats, %d Aitken rounds, Newton-Krylov to relative residual %g\n", po->prebeats, po->aitken, po->tol);
+
+	// Pre-pacing; components that change over a beat form the solve
+	memcpy(x0, x, n*sizeof(double));
+	for (int b = 0; b < po->prebeats; b++) { map(x, context); po->Nbeats++; }
+	memcpy(Px, x, n*sizeof(double));
+	map(Px, context);
+	po->Nbeats++;
+	po->Nactive = 0;
+	for (int i = 0; i < n; i++)
+	{
+		if (x[i] != x0[i] || Px[i] != x[i]) po->active[po->Nactive++] = i;
+		po->scale[i] = (fabs(x[i]) > 1e-10) ? fabs(x[i]) : 1;
+	}
+	memcpy(x, Px, n*sizeof(double));
+	map(Px, context);
+	po->Nbeats++;
+	po->residual = po_residual(po, x, Px);
+	if (po->log != NULL) fprintf(po->log, "prebeats %d %d %e 0 0\n", po->prebeats, po->Nbeats, po->residual);
+	printf("\t%d of %d state components vary over a beat; residual after pre-pacing %.3e\n", po->Nactive, n, po->residual);
+
+	// Aitken on slow variables
+	for (int r = 0; r < po->aitken && po->residual > po->tol; r++)
+	{
+		double before = po->residual;
+		int Nex = po_aitken(po, x, xt, Pt, map, context);
+		memcpy(Px, x, n*sizeof(double));
+		map(Px, context);
+		po->Nbeats++;
+		po->residual = po_residual(po, x, Px);
+		if (Nex > 0 && (po->residual < 0 || po->residual > before))   // extrapolation made it worse: keep the plain beats
+		{
+			memcpy(x, Pt, n*sizeof(double));
+			memcpy(Px, x, n*sizeof(double));
+			map(Px, context);
+			po->Nbeats++;
+			po->residual = po_residual(po, x, Px);
+			Nex = 0;
+		}
+		if (po->log != NULL) fprintf(po->log, "aitken %d %d %e 0 0\n", r+1, po->Nbeats, po->residual);
+		printf("\tAitken %d: %d slow components extrapolated; residual %.3e\n", r+1, Nex, po->residual);
+	}
+
+	// Newton-Krylov
+	int nA          = po->Nactive;
+	double *b       = (double*)malloc(nA*sizeof(double));
+	double *d       = (double*)malloc(nA*sizeof(double));
+	for (po->Nnewton = 0; po->Nnewton < po->max_newton && po->residual > po->tol; po->Nnewton++)
+	{
+		if (po->residual < 0) break;
+		for (int a = 0; a < nA; a++) b[a] = -(Px[po->active[a]] - x[po->active[a]])/po->scale[po->active[a]];
+		int k = po_gmres(po, x, Px, b, d, 1e-2, work, map, context);
+
+		double lambda   = 1;
+		double r1       = -1;
+		bool accepted   = false;
+		for (int ls = 0; ls < 6; ls++)
+		{
+			memcpy(xt, x, n*sizeof(double));
+			for (int a = 0; a < nA; a++) xt[po->active[a]] += lambda*po->scale[po->active[a]]*d[a];
+			memcpy(Pt, xt, n*sizeof(double));
+			map(Pt, context);
+			po->Nbeats++;
+			double rt = po_residual(po, xt, Pt);
+			if (rt >= 0 && rt < po->residual) { accepted = true; po->residual = rt; break; }
+			if (ls == 0) { memcpy(x1, xt, n*sizeof(double)); memcpy(P1, Pt, n*sizeof(double)); r1 = rt; }
+			lambda *= 0.5;
+		}
+		if (accepted == true)
+		{
+			memcpy(x, xt, n*sizeof(double));
+			memcpy(Px, Pt, n*sizeof(double));
+		}
+		else if (r1 >= 0)   // no decrease along the step: take the full Newton step (non-monotone)
+		{
+			memcpy(x, x1, n*sizeof(double));
+			memcpy(Px, P1, n*sizeof(double));
+			po->residual = r1;
+			lambda = 1;
+		}
+		else    // full step not finite: plain beat
+		{
+			memcpy(x, Px, n*sizeof(double));
+			map(Px, context);
+			po->Nbeats++;
+			po->residual = po_residual(po, x, Px);
+			lambda = 0;
+		}
+		if (po->log != NULL) fprintf(po->log, "newton %d %d %e %d %g\n", po->Nnewton+1, po->Nbeats, po->residual, k, lambda);
+		printf("\tNewton %d: %d Krylov vectors, step %g, residual %.3e (%d beats)\n", po->Nnewton+1, k, lambda, po->residual, po->Nbeats);
+	}
+	po->converged = (po->residual >= 0 && po->residual <= po->tol);
+
+	// Check: plain beats from the solution
+	po->drift = 0;
+	if (po->residual >= 0)
+	{
+		memcpy(xt, x, n*sizeof(double));
+		for (int c = 0; c < PO_CHECK_BEATS; c++)
+		{
+			memcpy(Pt, xt, n*sizeof(double));
+			map(Pt, context);
+			double r = po_residual(po, xt, Pt);
+			if (r < 0 || r > po->drift) po->drift = (r < 0) ? INFINITY : r;
+			memcpy(xt, Pt, n*sizeof(double));
+		}
+	}
+	else memcpy(x, x0, n*sizeof(double));   // diverged; back to the initial state
+
+	if (po->log != NULL) fprintf(po->log, "check %d %d %e 0 0\n", PO_CHECK_BEATS, po->Nbeats, po->drift);
+	if (po->log != NULL) fprintf(po->log, "# %s: residual %e after %d Newton iterations and %d beats (%.2f s); max relative change per beat over %d check beats %e\n", 
+		po->converged ? "converged" : "NOT converged", po->residual, po->Nnewton, po->Nbeats, po_wtime() - t0, PO_CHECK_BEATS, po->drift);
+	printf("Periodic orbit %s: residual %.3e after %d Newton iterations, %d beats (%.2f s)\n", po->converged ? "converged" : "NOT converged", po->residual, po->Nnewton, po->Nbeats, po_wtime() - t0);
+	printf("\tmax relative change per beat over %d further beats: %.3e%s\n", PO_CHECK_BEATS, po->drift, (po->drift > 100*po->tol) ? " (cycle is not stable at this BCL, e.g. alternans)" : "");
+
+	free(x0); free(Px); free(xt); free(Pt); free(work); free(x1); free(P1); free(b); free(d);
+	return po->converged;
+}
+
+// Native single cell: solves for State at the start of a beat; var is used as the model variables
+// at the start of every beat (S2 off)
+bool periodic_orbit_solve_native(Periodic_orbit *po, Cell_parameters p, Model_variables *var, State_variables *s, Simulation_parameters sim)
+{
+	Po_native c;
+	c.p         = p;
+	c.var       = *var;
+	c.var.S2_int    = 0;
+	c.var.stimflag  = false;
+	c.var.stimcount = 0;
+	c.dt        = sim.dt;
+	c.BCL       = sim.BCL;
+	c.BCL_int   = (int)(sim.BCL/sim.dt + 0.5);
+	return periodic_orbit_solve(po, (double*)s, po_beat_native, &c);
+}
+// End Solve ====================================================================================//|
+
+// Free =========================================================================================\\|
+void periodic_orbit_free(Periodic_orbit *po)
+{
+	if (po->on == false) return;
+	if (po->log != NULL) fclose(po->log);
+	free(po->active);
+	free(po->scale);
+	po->on = false;
+}
+// End Free =====================================================================================//|
@@ -0,0 +1,496 @@
+// Source code associated with  ===========================  //
+// "Multi-scale cardiac simulation framework" =============  //
+// For simulation of cardiac cellular and tissue dynamics =  //
+// from the spatial cellular to full organ scales. ========  //
+// With implementation of multiple, published cell models =  //
+// as well as novel models developed in my lab. ===========  //
+// ========================================================  //
+// This file: Phase singularity and =======================  //
+// filament tracking ====== ===============================  //
+// ========================================================  //
+// GNU 3 LICENSE TEXT =====================================  //
+// COPYRIGHT (C) 2016-2019 MICHAEL A. COLMAN ==============  //
+// THIS PROGRAM IS FREE SOFTWARE: YOU CAN REDISTRIBUTE IT =  //
+// AND/OR MODIFY IT UNDER THE TERMS OF THE GNU GENERAL ====  //
+// PUBLIC LICENSE AS PUBLISHED BY THE FREE SOFTWARE =======  //
+// FOUNDATION, EITHER VERSION 3 OF THE LICENSE, OR (AT YOUR  //
+// OPTION) ANY LATER VERSION. =============================  //
+// THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE=  //
+// USEFUL, BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE =====  //
+// IMPLIED WARRANTY OF MERCHANTABILITY OR FITNESS FOR A ===  //
+// PARTICULAR PURPOSE.  SEE THE GNU GENERAL PUBLIC LICENSE=  //
+// FOR MORE DETAILS. ======================================  //
+// YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL =====  //
+// PUBLIC LICENSE ALONG WITH THIS PROGRAM.  IF NOT, SEE ===  //
+// <https://www.gnu.org/licenses/>. =======================  //
+// ========================================================  //
+// ADDITIONAL LICENSE TEXT ================================  //
+// THIS SOFTWARE IS PROVIDED OPEN SOURCE AND MAY BE FREELY=  //
+// USED, DISTRIBUTED AND UPDATED, PROVIDED: ===============  //
+//  (i) THE APPROPRIATE WORK(S) IS(ARE) CITED. THIS =======  //
+//      PERTAINS TO THE CITATION OF COLMAN 2019 PLOS COMP =  //
+//      BIOL (FOR THIS IMPLEMTATION) AND ALL WORKS ========  //
+//      ASSOCIATED WITH THE SPECIFIC MODELS AND COMPONENTS=  //
+//      USED IN PARTICULAR SIMULATIONS. IT IS THE USER'S ==  //
+//      RESPONSIBILITY TO ENSURE ALL RELEVANT WORKS ARE ===  //
+//      CITED. PLEASE SEE FULL DOCUMENTATION AND ON-SCREEN=  //
+//      DISCLAIMER OUTPUTS FOR A GUIDE. ===================  //
+//  (ii) ALL OF THIS TEXT IS RETAINED WITHIN OR ASSOCIATED=  //
+//      WITH THE SOURCE CODE AND/OR BINARY FORM OF THE ====  //
+//      SOFTWARE. =========================================  //
+// ========================================================  //
+// ANY INTENDED COMMERCIAL USE OF THIS SOFTWARE MUST BE BY   //
+// EXPRESS PERMISSION OF MICHAEL A COLMAN ONLY. IN NO EVENT  //
+// ARE THE COPYRIGHT HOLDERS LIABLE FOR ANY DIRECT, =======  //
+// INDIRECT INCIDENTAL, SPECIAL, EXEMPLARY OR CONSEQUENTIAL  //
+// DAMAGES ASSOCIATED WITH USE OF THIS SOFTWARE ===========  //
+// ========================================================  //
+// THIS SOFTWARE CONTAINS IMPLEMENTATIONS OF MODELS AND ===  //
+// COMPONENTS WHICH I (MICHAEL COLMAN) DID NOT DEVELOP.====  //
+// ALL OF THESE COMPONENTS HAVE BEEN CODED FROM PROVIDED ==  //
+// SOURCE CODE OR INFORMATION IN THE PUBLICATIONS. ========  //
+// I CLAIM NO RIGHTS OR INTELLECTUAL PROPERTY OWNERSHIP ===  //
+// FOR THESE MODELS AND COMPONENTS, OTHER THAN THEIR ======  //
+// SPECIFIC IMPLEMENTATION IN THIS CODE PACKAGE. FURTHER TO  //
+// THE ABOVE STATEMENT, ANY INDTENDED COMMERCIAL USE OF ===  //
+// THOSE COMPONENTS MUST BE BY EXPRESS PERMISSION OF THE ==  //
+// ORIGINAL COPYRIGHT HOLDERS. ============================  //
+// WHERE IMPLEMENTED FROM PROVIDED CODE, ANY DISCLAIMERS ==  //
+// PRESENT IN THE ORIGINAL CODE HAVE BEEN RETAINED IN THE =  //
+// RELEVANT FILE. =========================================  //
+// ========================================================  //
+// Contact: m.a.colman@leeds.ac.uk ========================  //
+// For updates, corrections etc, please check: ============  //
+// 1. http://physicsoftheheart.com/ =======================  //
+// 2. https://github.com/michaelcolman ====================  //
+// ========================================================  //
+
+#include "Phase_singularity.h"
+#include "Structs.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <omp.h>
+#include <pthread.h>
+
+// Function list ================================================================================\\|
+//	phase_singularity_init()
+//	phase_singularity_step()
+//	phase_singularity_finalise()
+//
+//	Internal
+//	    psg_wrap()
+//	    psg_plaquette()
+//	    psg_find()
+//	    psg_compare_z/y()
+//	    psg_detect()
+//	    psg_cluster()
+//	    psg_end_track()
+//	    psg_track()
+//	    psg_thread()
+// End Function list ============================================================================//|
+
+// Notes ========================================================================================\\|
+// Locates rotor cores without spatial Vm outputs. Phase is from time-delay embedding (Gray et al.
+// 1998 Nature): theta = atan2(Vm(t - delay) - V*, Vm(t) - V*), V* = PSG_V_STAR. Every 
+// Phase_singularity_interval ms the current Vm and the Vm of delay ms before (held as float 
+// snapshots, only for the analysis times) are copied to a background thread, which:
+//  detect      sums the wrapped phase differences around each 2x2 loop of cells (plaquette); a
+//              net +-2pi is a phase singularity. 2D: xy plaquettes; 3D: xy, xz and yz plaquettes,
+//              which together trace the filaments. Plaquettes on edges/empty space are skipped.
+//  cluster     charged plaquettes within 1.5 space steps are grouped: one singularity in 2D (net
+//              charge), one filament in 3D (size = number of plaquettes ~ length/dx)
+//  track       clusters are matched to the tracks found at the previous analysis, nearest first,
+//              within Phase_singularity_radius (and with equal charge in 2D); unmatched clusters
+//              start new tracks, unmatched tracks end
+// The simulation only waits if the previous analysis has not finished (stall time reported).
+// Outputs (Outputs_X/):
+//  Phase_singularity_trajectory.dat    time id x y z (mm) charge size, per cluster per analysis
+//  Phase_singularity_lifetime.dat      id birth death lifetime (ms) charge mean x y z, per ended track
+//  Phase_singularity_count.dat         time clusters plaquettes
+// Positions are in mm from cell (0,0,0) of the geometry box.
+// End Notes ====================================================================================//|
+
+// Internal =====================================================================================\\|
+static double psg_wrap(double d)
+{
+	while (d > M_PI)    d -= 2*M_PI;
+	while (d <= -M_PI)  d += 2*M_PI;
+	return d;
+}
+
+// Charge of the plaquette with lower corner n in the plane of neighbour arrays A, B (0 if incomplete)
+static int psg_plaquette(const float *theta, int n, const int *A, const int *B, int *corner)
+{
+	int n1 = A[n];
+	int n3 = B[n];
+	if (n1 == n || n3 == n) return 0;
+	int n2 = B[n1];
+	if (n2 == n1 || A[n3] != n2) return 0;
+	double sum = psg_wrap(theta[n1] - theta[n]) + psg_wrap(theta[n2] - theta[n1]) + psg_wrap(theta[n3] - theta[n2]) + psg_wrap(theta[n] - theta[n3]);
+	corner[0] = n; corner[1] = n1; corner[2] = n2; corner[3] = n3;
+	return (int)lround(sum/(2*M_PI));
+}
+
+static int psg_find(int *parent, int i)
+{
+	while (parent[i] != i) i = parent[i] = parent[parent[i]];
+	return i;
+}
+
+// Phase and charged plaquettes
+static void psg_detect(Phase_singularity *ps)
+{
+	for (int n = 0; n < ps->N; n++) ps->phase[n] = (float)atan2(ps->V_del[n] - PSG_V_STAR, ps->V_now[n] - PSG_V_STAR);
+
+	int *plane[3][2] = {{ps->xp, ps->yp}, {ps->xp, ps->zp}, {ps->yp, ps->zp}};
+	int Nplanes = ps->filaments ? 3 : 1;
+	int corner[4];
+	ps->Npoints = 0;
+	for (int n = 0; n < ps->N; n++)
+	{
+		for (int p = 0; p < Nplanes; p++)
+		{
+			int q = psg_plaquette(ps->phase, n, plane[p][0], plane[p][1], corner);
+			if (q == 0) continue;
+			if (ps->Npoints == ps->capacity)
+			{
+				ps->capacity *= 2;
+				ps->point   = (PSG_point*)realloc(ps->point, ps->capacity*sizeof(PSG_point));
+				ps->cluster = (PSG_point*)realloc(ps->cluster, ps->capacity*sizeof(PSG_point));
+				ps->parent  = (int*)realloc(ps->parent, ps->capacity*sizeof(int));
+				ps->match   = (int*)realloc(ps->match, ps->capacity*sizeof(int));
+			}
+			PSG_point *pt = &ps->point[ps->Npoints++];
+			pt->x = pt->y = pt->z = 0;
+			for (int c = 0; c < 4; c++)
+			{
+				pt->x += 0.25*ps->x_index[corner[c]]*ps->dx;
+				pt->y += 0.25*ps->y_index[corner[c]]*ps->dy;
+				pt->z += 0.25*ps->z_index[corner[c]]*ps->dz;
+			}
+			pt->charge  = q;
+			pt->size    = 1;
+		}
+	}
+}
+
+// Sort key of the clustering sweep: z for filaments, y in 2D
+static int psg_compare_z(const void *a, const void *b)
+{
+	double d = ((const PSG_point*)a)->z - ((const PSG_point*)b)->z;
+	return (d > 0) - (d < 0);
+}
+
+static int psg_compare_y(const void *a, const void *b)
+{
+	double d = ((const PSG_point*)a)->y - ((const PSG_point*)b)->y;
+	return (d > 0) - (d < 0);
+}
+
+// Group charged plaquettes within 1.5 space steps; sorted along one axis so the sweep stops early
+static void psg_cluster(Phase_singularity *ps)
+{
+	double h = ps->dx;
+	if (ps->dy > h) h = ps->dy;
+	if (ps->dz > h) h = ps->dz;
+	double d2max = 2.25*h*h;
+
+	qsort(ps->point, ps->Npoints, sizeof(PSG_point), ps->filaments ? psg_compare_z : psg_compare_y);
+	for (int i = 0; i < ps->Npoints; i++) ps->parent[i] = i;
+	for (int i = 0; i < ps->Npoints; i++)
+	{
+		for (int j = i + 1; j < ps->Npoints; j++)
+		{
+			double dx = ps->point[j].x - ps->point[i].x;
+			double dy = ps->point[j].y - ps->point[i].y;
+			double dz = ps->point[j].z - ps->point[i].z;
+			if ((ps->filaments ? dz : dy) > 1.5*h) break;
+			if (dx*dx + dy*dy + dz*dz > d2max) continue;
+			int a = psg_find(ps->parent, i);
+			int b = psg_find(ps->parent, j);
+			if (a != b) ps->parent[b] = a;
+		}
+	}
+
+	ps->Nclusters = 0;
+	for (int i = 0; i < ps->Npoints; i++) ps->match[i] = -1;    // used here as root -> cluster
+	for (int i = 0; i < ps->Npoints; i++)
+	{
+		int r = psg_find(ps->parent, i);
+		if (ps->match[r] < 0)
+		{
+			ps->match[r] = ps->Nclusters;
+			PSG_point *c = &ps->cluster[ps->Nclusters++];
+			c->x = c->y = c->z = 0;
+			c->charge = c->size = 0;
+		}
+		PSG_point *c = &ps->cluster[ps->match[r]];
+		c->x += ps->point[i].x;
+		c->y += ps->point[i].y;
+		c->z += ps->point[i].z;
+		c->charge += ps->point[i].charge;
+		c->size++;
+	}
+	for (int k = 0; k < ps->Nclusters; k++)
+	{
+		ps->cluster[k].x /= ps->cluster[k].size;
+		ps->cluster[k].y /= ps->cluster[k].size;
+		ps->cluster[k].z /= ps->cluster[k].size;
+	}
+}
+
+static void psg_end_track(Phase_singularity *ps, PSG_track *t)
+{
+	fprintf(ps->lifetime, "%d %g %g %g %d %.3f %.3f %.3f\n", t->id, t->birth, t->last, t->last - t->birth, t->charge, t->sx/t->Nobs, t->sy/t->Nobs, t->sz/t->Nobs);
+}
+
+// Match clusters to the tracks of the previous analysis, nearest pairs first
+static void psg_track(Phase_singularity *ps, double time)
+{
+	double r2max = ps->radius*ps->radius;
+	int Nt = ps->Ntracks;
+	bool *taken = (bool*)calloc(Nt + 1, sizeof(bool));
+	for (int k = 0; k < ps->Nclusters; k++) ps->match[k] = -1;
+
+	while (true)
+	{
+		double best = r2max;
+		int bk = -1, bt = -1;
+		for (int k = 0; k < ps->Nclusters; k++)
+		{
+			if (ps->match[k] >= 0) continue;
+			for (int t = 0; t < Nt; t++)
+			{
+				if (taken[t]) continue;
+				if (!ps->filaments && ps->track[t].charge != ps->cluster[k].charge) continue;
+				double dx = ps->cluster[k].x - ps->track[t].x;
+				double dy = ps->cluster[k].y - ps->track[t].y;
+				double dz = ps->cluster[k].z - ps->track[t].z;
+				double d2 = dx*dx + dy*dy + dz*dz;
+				if (d2 <= best) { best = d2; bk = k; bt = t; }
+			}
+		}
+		if (bk < 0) break;
+		ps->match[bk]   = bt;
+		taken[bt]       = true;
+	}
+
+	// End unmatched tracks (compact the list, keeping matched indexes valid via a remap)
+	int *remap = (int*)malloc((Nt + 1)*sizeof(int));
+	int kept = 0;
+	for (int t = 0; t < Nt; t++)
+	{
+		if (taken[t]) { ps->track[kept] = ps->track[t]; remap[t] = kept++; }
+		else psg_end_track(ps, &ps->track[t]);
+	}
+	ps->Ntracks = kept;
+
+	for (int k = 0; k < ps->Nclusters; k++)
+	{
+		PSG_point *c = &ps->cluster[k];
+		PSG_track *t;
+		if (ps->match[k] >= 0) t = &ps->track[remap[ps->match[k]]];
+		else
+		{
+			if (ps->Ntracks == ps->track_capacity)
+			{
+				ps->track_capacity *= 2;
+				ps->track = (PSG_track*)realloc(ps->track, ps->track_capacity*sizeof(PSG_track));
+			}
+			t           = &ps->track[ps->Ntracks++];
+			t->id       = ps->next_id++;
+			t->birth    = time;
+			t->sx = t->sy = t->sz = 0;
+			t->Nobs     = 0;
+			t->charge   = c->charge;
+		}
+		t->last = time;
+		t->x = c->x;    t->y = c->y;    t->z = c->z;
+		t->sx += c->x;  t->sy += c->y;  t->sz += c->z;
+		t->Nobs++;
+		fprintf(ps->trajectory, "%g %d %.3f %.3f %.3f %d %d\n", time, t->id, c->x, c->y, c->z, c->charge, c->size);
+	}
+	fprintf(ps->count, "%g %d %d\n", time, ps->Nclusters, ps->Npoints);
+	free(remap);
+	free(taken);
+}
+
+// Background analysis thread
+static void * psg_thread(void *arg)
+{
+	Phase_singularity *ps = (Phase_singularity*)arg;
+
+	pthread_mutex_lock(&ps->lock);
+	while (true)
+	{
+		while (!ps->pending && !ps->shutdown) pthread_cond_wait(&ps->job_ready, &ps->lock);
+		if (!ps->pending && ps->shutdown) break;
+		ps->pending = false;
+		ps->busy    = true;
+		pthread_mutex_unlock(&ps->lock);
+
+		psg_detect(ps);
+		psg_cluster(ps);
+		psg_track(ps, ps->job_time);
+
+		pthread_mutex_lock(&ps->lock);
+		ps->busy = false;
+		ps->Nanalyses++;
+		pthread_cond_broadcast(&ps->idle);
+	}
+	pthread_mutex_unlock(&ps->lock);
+	return NULL;
+}
+// End Internal =================================================================================//|
+
+// Setup ========================================================================================\\|
+void phase_singularity_init(Phase_singularity *ps, Simulation_parameters sim, SC_variables sc, const char *directory)
+{
+	memset(ps, 0, sizeof(Phase_singularity));
+	if (strcmp(sim.Phase_singularity, "On") != 0) return;
+
+	// Delay buffer and open tracks are not part of the checkpoint
+	if (strcmp(sim.Read_checkpoint, "Off") != 0)
+	{
+		printf("ERROR: Phase_singularity On cannot be used with Read_checkpoint (delay buffer and tracks are not continued from a checkpoint); set Phase_singularity Off for the restart\n");
+		exit(1);
+	}
+
+	if (sc.NY == 1 && sc.NZ == 1)
+	{
+		printf("ERROR: Phase_singularity requires a 2D or 3D tissue\n");
+		exit(1);
+	}
+
+	ps->on          = true;
+	ps->N           = sc.N;
+	ps->filaments   = (sc.NZ > 1 && sc.NY > 1);
+	ps->dx          = sc.dx;
+	ps->dy          = sc.dy;
+	ps->dz          = sc.dz;
+	ps->xp          = sc.xp;
+	ps->yp          = sc.yp;
+	ps->zp          = sc.zp;
+	ps->x_index     = sc.x_index;
+	ps->y_index     = sc.y_index;
+	ps->z_index     = sc.z_index;
+	ps->interval    = sim.Phase_singularity_interval;
+	ps->delay       = sim.Phase_singularity_delay;
+	ps->radius      = sim.Phase_singularity_radius;
+
+	// 2D slab in xz or yz: treat the non-trivial pair of axes as the plane
+	if (sc.NZ > 1 && sc.NY == 1) ps->yp = sc.zp;
+	if (sc.NZ > 1 && sc.NX == 1) { ps->xp = sc.yp; ps->yp = sc.zp; }
+
+	// Snapshots at t - delay for the analyses still to come
+	ps->Nring       = ps->delay/ps->interval + 2;
+	ps->ring        = (float*)malloc((size_t)ps->Nring*ps->N*sizeof(float));
+	ps->V_now       = (float*)malloc(ps->N*sizeof(float));
+	ps->V_del       = (float*)malloc(ps->N*sizeof(float));
+	ps->phase       = (float*)malloc(ps->N*sizeof(float));
+
+	ps->capacity        = 1024;
+	ps->point           = (PSG_point*)malloc(ps->capacity*sizeof(PSG_point));
+	ps->cluster         = (PSG_point*)malloc(ps->capacity*sizeof(PSG_point));
+	ps->parent          = (int*)malloc(ps->capacity*sizeof(int));
+	ps->match           = (int*)malloc(ps->capacity*sizeof(int));
+	ps->track_capacity  = 64;
+	ps->track           = (PSG_track*)malloc(ps->track_capacity*sizeof(PSG_track));
+
+	const char *name[3] = {"trajectory", "lifetime", "count"};
+	FILE **file[3]      = {&ps->trajectory, &ps->lifetime, &ps->count};
+	char *filename      = (char*)malloc(1000);
+	for (int f = 0; f < 3; f++)
+	{
+		if (sim.Windows == true)    sprintf(filename, "%s\\Phase_singularity_%s.dat", directory, name[f]);
+		else                        sprintf(filename, "%s/Phase_singularity_%s.dat", directory, name[f]);
+		*file[f] = fopen(filename, "wt");
+		if (*file[f] == NULL)
+		{
+			printf("ERROR: cannot open %s\n", filename);
+			exit(1);
+		}
+	}
+	free(filename);
+	fprintf(ps->trajectory, "# time(ms) id x y z (mm) charge size(plaquettes)\n");
+	fprintf(ps->lifetime, "# id birth(ms) death(ms) lifetime(ms) charge mean_x mean_y mean_z (mm)\n");
+	fprintf(ps->count, "# time(ms) %s charged_plaquettes\n", ps->filaments ? "filaments" : "singularities");
+
+	pthread_mutex_init(&ps->lock, NULL);
+	pthread_cond_init(&ps->job_ready, NULL);
+	pthread_cond_init(&ps->idle, NULL);
+	if (pthread_create(&ps->worker, NULL, psg_thread, ps) != 0)
+	{
+		printf("ERROR: Cannot create phase singularity analysis thread\n");
+		exit(1);
+	}
+
+	printf("Phase singularity tracking (%s): every %d ms, phase from Vm and Vm %d ms before, in a background thread\n", ps->filaments ? "3D filaments" : "2D", ps->interval, ps->delay);
+}
+// End Setup ====================================================================================//|
+
+// Step =========================================================================================\\|
+// Called once per ms (output step) with the current Vm
+void phase_singularity_step(Phase_singularity *ps, double *Vm, double sim_time)
+{
+	if (ps->on == false) return;
+	long c = ps->calls++;
+
+	// Analysis at t (once t - delay has been stored)
+	if (c%ps->interval == 0 && c >= ps->delay)
+	{
+		double start = omp_get_wtime();
+		pthread_mutex_lock(&ps->lock);
+		while (ps->pending || ps->busy) pthread_cond_wait(&ps->idle, &ps->lock);
+		ps->stall_time += omp_get_wtime() - start;
+
+		float *del = &ps->ring[(size_t)((c/ps->interval)%ps->Nring)*ps->N];
+		memcpy(ps->V_del, del, ps->N*sizeof(float));
+		for (int n = 0; n < ps->N; n++) ps->V_now[n] = (float)Vm[n];
+		ps->job_time    = sim_time;
+		ps->pending     = true;
+		pthread_cond_signal(&ps->job_ready);
+		pthread_mutex_unlock(&ps->lock);
+	}
+
+	// Snapshot for the analysis at t + delay
+	if ((c + ps->delay)%ps->interval == 0)
+	{
+		float *del = &ps->ring[(size_t)(((c + ps->delay)/ps->interval)%ps->Nring)*ps->N];
+		for (int n = 0; n < ps->N; n++) del[n] = (float)Vm[n];
+	}
+}
+
+void phase_singularity_finalise(Phase_singularity *ps)
+{
+	if (ps->on == false) return;
+
+	pthread_mutex_lock(&ps->lock);
+	while (ps->pending || ps->busy) pthread_cond_wait(&ps->idle, &ps->lock);
+	ps->shutdown = true;
+	pthread_cond_signal(&ps->job_ready);
+	pthread_mutex_unlock(&ps->lock);
+	pthread_join(ps->worker, NULL);
+
+	for (int t = 0; t < ps->Ntracks; t++) psg_end_track(ps, &ps->track[t]);
+	fclose(ps->trajectory);
+	fclose(ps->lifetime);
+	fclose(ps->count);
+	printf("Phase singularity tracking: %d analyses, %d tracks, simulation waited %.2f s for the analysis thread\n", ps->Nanalyses, ps->next_id, ps->stall_time);
+
+	pthread_mutex_destroy(&ps->lock);
+	pthread_cond_destroy(&ps->job_ready);
+	pthread_cond_destroy(&ps->idle);
+	free(ps->ring);
+	free(ps->V_now);
+	free(ps->V_del);
+	free(ps->phase);
+	free(ps->point);
+	free(ps->cluster);
+	free(ps->parent);
+	free(ps->match);
+	free(ps->track);
+}
+// End Step =====================================================================================//|
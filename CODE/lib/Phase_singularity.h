@@ -0,0 +1,136 @@
+// Source code associated with  ===========================  //
+// "Multi-scale cardiac simulation framework" =============  //
+// For simulation of cardiac cellular and tissue dynamics =  //
+// from the spatial cellular to full organ scales. ========  //
+// With implementation of multiple, published cell models =  //
+// as well as novel models developed in my lab. ===========  //
+// ========================================================  //
+// This file: Phase singularity and =======================  //
+// filament tracking, header ==============================  //
+// ========================================================  //
+// GNU 3 LICENSE TEXT =====================================  //
+// COPYRIGHT (C) 2016-2019 MICHAEL A. COLMAN ==============  //
+// THIS PROGRAM IS FREE SOFTWARE: YOU CAN REDISTRIBUTE IT =  //
+// AND/OR MODIFY IT UNDER THE TERMS OF THE GNU GENERAL ====  //
+// PUBLIC LICENSE AS PUBLISHED BY THE FREE SOFTWARE =======  //
+// FOUNDATION, EITHER VERSION 3 OF THE LICENSE, OR (AT YOUR  //
+// OPTION) ANY LATER VERSION. =============================  //
+// THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE=  //
+// USEFUL, BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE =====  //
+// IMPLIED WARRANTY OF MERCHANTABILITY OR FITNESS FOR A ===  //
+// PARTICULAR PURPOSE.  SEE THE GNU GENERAL PUBLIC LICENSE=  //
+// FOR MORE DETAILS. ======================================  //
+// YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL =====  //
+// PUBLIC LICENSE ALONG WITH THIS PROGRAM.  IF NOT, SEE ===  //
+// <https://www.gnu.org/licenses/>. =======================  //
+// ========================================================  //
+// ADDITIONAL LICENSE TEXT ================================  //
+// THIS SOFTWARE IS PROVIDED OPEN SOURCE AND MAY BE FREELY=  //
+// USED, DISTRIBUTED AND UPDATED, PROVIDED: ===============  //
+//  (i) THE APPROPRIATE WORK(S) IS(ARE) CITED. THIS =======  //
+//      PERTAINS TO THE CITATION OF COLMAN 2019 PLOS COMP =  //
+//      BIOL (FOR THIS IMPLEMTATION) AND ALL WORKS ========  //
+//      ASSOCIATED WITH THE SPECIFIC MODELS AND COMPONENTS=  //
+//      USED IN PARTICULAR SIMULATIONS. IT IS THE USER'S ==  //
+//      RESPONSIBILITY TO ENSURE ALL RELEVANT WORKS ARE ===  //
+//      CITED. PLEASE SEE FULL DOCUMENTATION AND ON-SCREEN=  //
+//      DISCLAIMER OUTPUTS FOR A GUIDE. ===================  //
+//  (ii) ALL OF THIS TEXT IS RETAINED WITHIN OR ASSOCIATED=  //
+//      WITH THE SOURCE CODE AND/OR BINARY FORM OF THE ====  //
+//      SOFTWARE. =========================================  //
+// ========================================================  //
+// ANY INTENDED COMMERCIAL USE OF THIS SOFTWARE MUST BE BY   //
+// EXPRESS PERMISSION OF MICHAEL A COLMAN ONLY. IN NO EVENT  //
+// ARE THE COPYRIGHT HOLDERS LIABLE FOR ANY DIRECT, =======  //
+// INDIRECT INCIDENTAL, SPECIAL, EXEMPLARY OR CONSEQUENTIAL  //
+// DAMAGES ASSOCIATED WITH USE OF THIS SOFTWARE ===========  //
+// ========================================================  //
+// THIS SOFTWARE CONTAINS IMPLEMENTATIONS OF MODELS AND ===  //
+// COMPONENTS WHICH I (MICHAEL COLMAN) DID NOT DEVELOP.====  //
+// ALL OF THESE COMPONENTS HAVE BEEN CODED FROM PROVIDED ==  //
+// SOURCE CODE OR INFORMATION IN THE PUBLICATIONS. ========  //
+// I CLAIM NO RIGHTS OR INTELLECTUAL PROPERTY OWNERSHIP ===  //
+// FOR THESE MODELS AND COMPONENTS, OTHER THAN THEIR ======  //
+// SPECIFIC IMPLEMENTATION IN THIS CODE PACKAGE. FURTHER TO  //
+// THE ABOVE STATEMENT, ANY INDTENDED COMMERCIAL USE OF ===  //
+// THOSE COMPONENTS MUST BE BY EXPRESS PERMISSION OF THE ==  //
+// ORIGINAL COPYRIGHT HOLDERS. ============================  //
+// WHERE IMPLEMENTED FROM PROVIDED CODE, ANY DISCLAIMERS ==  //
+// PRESENT IN THE ORIGINAL CODE HAVE BEEN RETAINED IN THE =  //
+// RELEVANT FILE. =========================================  //
+// ========================================================  //
+// Contact: m.a.colman@leeds.ac.uk ========================  //
+// For updates, corrections etc, please check: ============  //
+// 1. http://physicsoftheheart.com/ =======================  //
+// 2. https://github.com/michaelcolman ====================  //
+// ========================================================  //
+
+#ifndef PHASE_SINGULARITY_H
+#define PHASE_SINGULARITY_H
+
+#include "Structs.h"
+#include <stdio.h>
+#include <pthread.h>
+
+#define PSG_V_STAR      -40     // mV, centre of the (Vm(t), Vm(t - delay)) phase plane
+
+// Charged plaquette (2x2 loop of cells) or cluster of them (singularity in 2D, filament in 3D)
+typedef struct{
+	double      x, y, z;        // mm
+	int         charge;         // topological charge (sum over the cluster)
+	int         size;           // number of charged plaquettes
+}PSG_point;
+
+typedef struct{
+	int         id;
+	double      birth, last;    // ms, first and last analysis at which it was found
+	double      x, y, z;        // last position (mm)
+	double      sx, sy, sz;     // sums of positions, for the mean
+	int         Nobs;
+	int         charge;
+}PSG_track;
+
+typedef struct{
+	bool        on;
+	int         N;
+	bool        filaments;      // 3D: plaquettes in all three planes are grouped into filaments
+	double      dx, dy, dz;
+	int         *xp, *yp, *zp;
+	int         *x_index, *y_index, *z_index;
+	int         interval;       // ms
+	int         delay;          // ms
+	double      radius;         // mm
+
+	// Delayed snapshots (simulation thread)
+	float       *ring;          // Nring x N
+	int         Nring;
+	long        calls;          // per ms
+
+	// Analysis (worker thread)
+	float       *V_now, *V_del, *phase;
+	double      job_time;
+	PSG_point   *point, *cluster;
+	int         *parent;
+	int         Npoints, Nclusters, capacity;
+	PSG_track   *track;
+	int         Ntracks, track_capacity, next_id;
+	int         *match;         // track matched to each cluster (-1 = new)
+	FILE        *trajectory, *lifetime, *count;
+
+	// Worker
+	bool        pending, busy, shutdown;
+	pthread_t   worker;
+	pthread_mutex_t lock;
+	pthread_cond_t  job_ready;
+	pthread_cond_t  idle;
+
+	// Diagnostics
+	int         Nanalyses;
+	double      stall_time;     // s the simulation waited for the worker
+}Phase_singularity;
+
+void phase_singularity_init(Phase_singularity *ps, Simulation_parameters sim, SC_variables sc, const char *directory);
+void phase_singularity_step(Phase_singularity *ps, double *Vm, double sim_time);
+void phase_singularity_finalise(Phase_singularity *ps);
+
+#endif
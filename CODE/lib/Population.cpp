@@ -0,0 +1,373 @@
+// Source code associated with  ===========================  //
+// "Multi-scale cardiac simulation framework" =============  //
+// For simulation of cardiac cellular and tissue dynamics =  //
+// from the spatial cellular to full organ scales. ========  //
+// With implementation of multiple, published cell models =  //
+// as well as novel models developed in my lab. ===========  //
+// ========================================================  //
+// This file: Population of models: sampling ==============  //
+// and biomarker acceptance ======= =======================  //
+// ========================================================  //
+// GNU 3 LICENSE TEXT =====================================  //
+// COPYRIGHT (C) 2016-2019 MICHAEL A. COLMAN ==============  //
+// THIS PROGRAM IS FREE SOFTWARE: YOU CAN REDISTRIBUTE IT =  //
+// AND/OR MODIFY IT UNDER THE TERMS OF THE GNU GENERAL ====  //
+// PUBLIC LICENSE AS PUBLISHED BY THE FREE SOFTWARE =======  //
+// FOUNDATION, EITHER VERSION 3 OF THE LICENSE, OR (AT YOUR  //
+// OPTION) ANY LATER VERSION. =============================  //
+// THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE=  //
+// USEFUL, BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE =====  //
+// IMPLIED WARRANTY OF MERCHANTABILITY OR FITNESS FOR A ===  //
+// PARTICULAR PURPOSE.  SEE THE GNU GENERAL PUBLIC LICENSE=  //
+// FOR MORE DETAILS. ======================================  //
+// YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL =====  //
+// PUBLIC LICENSE ALONG WITH THIS PROGRAM.  IF NOT, SEE ===  //
+// <https://www.gnu.org/licenses/>. =======================  //
+// ========================================================  //
+// ADDITIONAL LICENSE TEXT ================================  //
+// THIS SOFTWARE IS PROVIDED OPEN SOURCE AND MAY BE FREELY=  //
+// USED, DISTRIBUTED AND UPDATED, PROVIDED: ===============  //
+//  (i) THE APPROPRIATE WORK(S) IS(ARE) CITED. THIS =======  //
+//      PERTAINS TO THE CITATION OF COLMAN 2019 PLOS COMP =  //
+//      BIOL (FOR THIS IMPLEMTATION) AND ALL WORKS ========  //
+//      ASSOCIATED WITH THE SPECIFIC MODELS AND COMPONENTS=  //
+//      USED IN PARTICULAR SIMULATIONS. IT IS THE USER'S ==  //
+//      RESPONSIBILITY TO ENSURE ALL RELEVANT WORKS ARE ===  //
+//      CITED. PLEASE SEE FULL DOCUMENTATION AND ON-SCREEN=  //
+//      DISCLAIMER OUTPUTS FOR A GUIDE. ===================  //
+//  (ii) ALL OF THIS TEXT IS RETAINED WITHIN OR ASSOCIATED=  //
+//      WITH THE SOURCE CODE AND/OR BINARY FORM OF THE ====  //
+//      SOFTWARE. =========================================  //
+// ========================================================  //
+// ANY INTENDED COMMERCIAL USE OF THIS SOFTWARE MUST BE BY   //
+// EXPRESS PERMISSION OF MICHAEL A COLMAN ONLY. IN NO EVENT  //
+// ARE THE COPYRIGHT HOLDERS LIABLE FOR ANY DIRECT, =======  //
+// INDIRECT INCIDENTAL, SPECIAL, EXEMPLARY OR CONSEQUENTIAL  //
+// DAMAGES ASSOCIATED WITH USE OF THIS SOFTWARE ===========  //
+// ========================================================  //
+// THIS SOFTWARE CONTAINS IMPLEMENTATIONS OF MODELS AND ===  //
+// COMPONENTS WHICH I (MICHAEL COLMAN) DID NOT DEVELOP.====  //
+// ALL OF THESE COMPONENTS HAVE BEEN CODED FROM PROVIDED ==  //
+// SOURCE CODE OR INFORMATION IN THE PUBLICATIONS. ========  //
+// I CLAIM NO RIGHTS OR INTELLECTUAL PROPERTY OWNERSHIP ===  //
+// FOR THESE MODELS AND COMPONENTS, OTHER THAN THEIR ======  //
+// SPECIFIC IMPLEMENTATION IN THIS CODE PACKAGE. FURTHER TO  //
+// THE ABOVE STATEMENT, ANY INDTENDED COMMERCIAL USE OF ===  //
+// THOSE COMPONENTS MUST BE BY EXPRESS PERMISSION OF THE ==  //
+// ORIGINAL COPYRIGHT HOLDERS. ============================  //
+// WHERE IMPLEMENTED FROM PROVIDED CODE, ANY DISCLAIMERS ==  //
+// PRESENT IN THE ORIGINAL CODE HAVE BEEN RETAINED IN THE =  //
+// RELEVANT FILE. =========================================  //
+// ========================================================  //
+// Contact: m.a.colman@leeds.ac.uk ========================  //
+// For updates, corrections etc, please check: ============  //
+// 1. http://physicsoftheheart.com/ =======================  //
+// 2. https://github.com/michaelcolman ====================  //
+// ========================================================  //
+
+#include "Population.h"
+#include "Structs.h"
+#include "MersenneTwister.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// Function list ================================================================================\\|
+//	population_defaults()
+//	population_add_sampled()
+//	population_add_criterion()
+//	population_generate()
+//	population_free()
+//	population_measure()
+//	population_abort()
+//	population_evaluate()
+//	population_write_header()
+//	population_write_line()
+//
+//	Internal
+//	    pop_lhs()
+//	    pop_sobol()
+//	    pop_biomarker_index()
+// End Function list ============================================================================//|
+
+// Notes ========================================================================================\\|
+// Populations of models (e.g. hAM_CRN/hAM_GB with conductances scaled through INa_scale, IKr_scale
+// etc; lib/Initialisation.c assign_modification_from_arguments()) run as ensemble members 
+// (lib/Ensemble.cpp; keywords population, sample, accept, reject_after, reject_margin).
+// Sampling: Latin hypercube (one value in each of N equal strata per argument, strata randomly 
+// paired between arguments; Mersenne twister, seeded) or Sobol (Joe and Kuo direction numbers,
+// up to POP_SOBOL_MAX_DIMS arguments; deterministic, the point at 0 is skipped). 
+// Biomarkers are those of calculate_measurement_properties() (lib/Model.c). Acceptance is 
+// evaluated on the final beat as reported in Properties_log (RMP = Vmin just before the final 
+// stimulus; CaT in uM, CaSR in mM). 
+// Early rejection: from beat reject_after, at the start of each paced beat the beat just completed
+// is checked, and the member stops if a biomarker is clearly out of range (beyond the range by more
+// than reject_margin x its width), the beat did not excite, or the state is not a number. An AP 
+// that has not yet repolarised counts as APD = time since excitation (only the upper limit is 
+// checked). The margin allows for the drift towards steady state over the remaining beats.
+// End Notes ====================================================================================//|
+
+const char *population_biomarker_names[POP_NBIOMARKERS] = 
+	{"APD90", "APD70", "APD50", "APD30", "RMP", "Vmax", "Vamp", "dvdt_max", "CaT_max", "CaT_min", "CaT_amp", "CaSR_max", "CaSR_min"};
+
+// Sobol direction numbers (Joe and Kuo 2008, new-joe-kuo-6.21201): degree s, coefficients a, m_1..m_s
+static const int pop_sobol_s[POP_SOBOL_MAX_DIMS]    = {0, 1, 2, 3, 3, 4, 4, 5, 5, 5, 5, 5, 5, 6, 6, 6, 6, 6, 6, 7, 7};
+static const int pop_sobol_a[POP_SOBOL_MAX_DIMS]    = {0, 0, 1, 1, 2, 1, 4, 2, 4, 7, 11, 13, 14, 1, 13, 16, 19, 22, 25, 1, 4};
+static const int pop_sobol_m[POP_SOBOL_MAX_DIMS][7] = {
+	{0},                    {1},                    {1, 3},                 {1, 3, 1},              {1, 1, 1},
+	{1, 1, 3, 3},           {1, 3, 5, 13},          {1, 1, 5, 5, 17},       {1, 1, 5, 5, 5},        {1, 1, 7, 11, 19},
+	{1, 1, 5, 1, 1},        {1, 1, 1, 3, 11},       {1, 3, 5, 5, 31},       {1, 3, 3, 9, 7, 49},    {1, 1, 1, 15, 21, 21},
+	{1, 3, 1, 13, 27, 49},  {1, 1, 1, 15, 7, 5},    {1, 3, 1, 15, 13, 25},  {1, 1, 5, 5, 19, 61},   {1, 3, 7, 11, 23, 15, 103},
+	{1, 3, 7, 13, 13, 15, 69}};
+
+// Internal =====================================================================================\\|
+// Latin hypercube: u[k*D + d] in [0,1)
+static void pop_lhs(double *u, int N, int D, unsigned int seed)
+{
+	MTRand rng(seed);
+	int *perm = (int*)malloc(N*sizeof(int));
+	for (int d = 0; d < D; d++)
+	{
+		for (int k = 0; k < N; k++) perm[k] = k;
+		for (int k = N-1; k > 0; k--)
+		{
+			int j       = rng.randInt(k);
+			int t       = perm[k];
+			perm[k]     = perm[j];
+			perm[j]     = t;
+		}
+		for (int k = 0; k < N; k++) u[k*D + d] = (perm[k] + rng.randExc())/N;
+	}
+	free(perm);
+}
+
+// Sobol points 1..N (Gray code order)
+static void pop_sobol(double *u, int N, int D)
+{
+	unsigned int V[POP_SOBOL_MAX_DIMS][33];
+	for (int d = 0; d < D; d++)
+	{
+		int s = pop_sobol_s[d];
+		for (int k = 1; k <= 32; k++)
+		{
+			if (d == 0)         V[d][k] = 1u << (32 - k);
+			else if (k <= s)    V[d][k] = (unsigned int)pop_sobol_m[d][k-1] << (32 - k);
+			else
+			{
+				V[d][k] = V[d][k-s] ^ (V[d][k-s] >> s);
+				for (int i = 1; i < s; i++) if ((pop_sobol_a[d] >> (s - 1 - i)) & 1) V[d][k] ^= V[d][k-i];
+			}
+		}
+	}
+	unsigned int X[POP_SOBOL_MAX_DIMS] = {0};
+	for (int n = 0; n <= N; n++)
+	{
+		// rightmost zero bit of n
+		int c = 1;
+		for (unsigned int v = n; v & 1; v >>= 1) c++;
+		if (n > 0) for (int d = 0; d < D; d++) u[(n-1)*D + d] = X[d]/4294967296.0;
+		for (int d = 0; d < D; d++) X[d] ^= V[d][c];
+	}
+}
+
+static int pop_biomarker_index(const char *name)
+{
+	for (int i = 0; i < POP_NBIOMARKERS; i++) if (strcmp(name, population_biomarker_names[i]) == 0) return i;
+	return -1;
+}
+// End Internal =================================================================================//|
+
+// Setup ========================================================================================\\|
+void population_defaults(Population *pop)
+{
+	memset(pop, 0, sizeof(Population));
+	strcpy(pop->method, "lhs");
+	pop->seed           = 1;
+	pop->reject_after   = 3;
+	pop->margin         = 0.5;
+}
+
+void population_add_sampled(Population *pop, const char *arg, double min, double max, bool log)
+{
+	if (pop->Nsampled == POP_MAX_SAMPLED)
+	{
+		printf("ERROR: at most %d sampled arguments in a population\n", POP_MAX_SAMPLED);
+		exit(1);
+	}
+	if (max < min || (log == true && min <= 0))
+	{
+		printf("ERROR: sampled argument %s: range %g to %g must have max >= min (and min > 0 if log)\n", arg, min, max);
+		exit(1);
+	}
+	int i           = pop->Nsampled++;
+	pop->arg[i]     = (char*)malloc(strlen(arg) + 1);
+	strcpy(pop->arg[i], arg);
+	pop->min[i]     = min;
+	pop->max[i]     = max;
+	pop->log[i]     = log;
+}
+
+void population_add_criterion(Population *pop, const char *biomarker, double lo, double hi)
+{
+	int b = pop_biomarker_index(biomarker);
+	if (b < 0)
+	{
+		printf("ERROR: \"%s\" is not a population biomarker; options are:", biomarker);
+		for (int i = 0; i < POP_NBIOMARKERS; i++) printf(" %s", population_biomarker_names[i]);
+		printf("\n");
+		exit(1);
+	}
+	if (pop->Ncriteria == POP_MAX_CRITERIA || hi < lo)
+	{
+		printf("ERROR: acceptance criterion %s %g %g: max must be >= min (at most %d criteria)\n", biomarker, lo, hi, POP_MAX_CRITERIA);
+		exit(1);
+	}
+	int i               = pop->Ncriteria++;
+	pop->biomarker[i]   = b;
+	pop->lo[i]          = lo;
+	pop->hi[i]          = hi;
+}
+
+void population_generate(Population *pop, int N, const char *method, unsigned int seed)
+{
+	if (pop->Nsampled == 0 || N < 1)
+	{
+		printf("ERROR: a population needs at least one sample (N >= 1) and one sampled argument\n");
+		exit(1);
+	}
+	if (strcmp(method, "lhs") != 0 && strcmp(method, "sobol") != 0)
+	{
+		printf("ERROR: population sampling \"%s\" must be \"lhs\" or \"sobol\"\n", method);
+		exit(1);
+	}
+	if (strcmp(method, "sobol") == 0 && pop->Nsampled > POP_SOBOL_MAX_DIMS)
+	{
+		printf("ERROR: sobol sampling supports at most %d sampled arguments; use lhs\n", POP_SOBOL_MAX_DIMS);
+		exit(1);
+	}
+	pop->on     = true;
+	pop->N      = N;
+	pop->seed   = seed;
+	strcpy(pop->method, method);
+
+	int D       = pop->Nsampled;
+	pop->x      = (double*)malloc(N*D*sizeof(double));
+	if (strcmp(method, "lhs") == 0)     pop_lhs(pop->x, N, D, seed);
+	else                                pop_sobol(pop->x, N, D);
+
+	for (int k = 0; k < N; k++)
+	for (int d = 0; d < D; d++)
+	{
+		double u = pop->x[k*D + d];
+		if (pop->log[d] == true)    pop->x[k*D + d] = pop->min[d]*pow(pop->max[d]/pop->min[d], u);
+		else                        pop->x[k*D + d] = pop->min[d] + u*(pop->max[d] - pop->min[d]);
+	}
+}
+
+void population_free(Population *pop)
+{
+	for (int i = 0; i < pop->Nsampled; i++) free(pop->arg[i]);
+	free(pop->x);
+	pop->Nsampled   = 0;
+	pop->x          = NULL;
+	pop->on         = false;
+}
+// End Setup ====================================================================================//|
+
+// Evaluation ===================================================================================\\|
+// Biomarkers of the final beat (final = true, as Properties_log) or of the beat just completed, at
+// the start of the next (final = false)
+void population_measure(Model_variables var, double *b, bool final)
+{
+	b[0]    = var.APD_p[8];
+	b[1]    = var.APD_p[6];
+	b[2]    = var.APD_p[4];
+	b[3]    = var.APD_p[2];
+	b[4]    = (final == true) ? var.Vmin_prev : var.Vmin;
+	b[5]    = var.Vmax;
+	b[6]    = var.Vamp;
+	b[7]    = var.dvdt_max;
+	b[8]    = 1e3*var.CaT_max;
+	b[9]    = 1e3*var.CaT_min;
+	b[10]   = b[8] - b[9];
+	b[11]   = var.CaSR_max;
+	b[12]   = var.CaSR_min;
+}
+
+// Early rejection; true if the member should stop now
+bool population_abort(Population *pop, Model_variables *var, double Vm, int iteration_counter, double sim_time, int *status, char *failed, double *b)
+{
+	if (pop->reject_after <= 0 || pop->Ncriteria == 0) return false;
+	if (iteration_counter == 0 || iteration_counter % var->BCL_int != 0 || iteration_counter > var->Paced_time_int) return false;
+	if (iteration_counter/var->BCL_int < pop->reject_after) return false;
+
+	population_measure(*var, b, false);
+	double BCL = var->BCL_int/var->dtinv_double;
+	const char *reason = NULL;
+	if (Vm != Vm)                           reason = "NaN";
+	else if (var->t_ex < sim_time - BCL)    reason = "no_AP";
+	else
+	{
+		for (int i = 0; i < pop->Ncriteria && reason == NULL; i++)
+		{
+			int k           = pop->biomarker[i];
+			bool open_APD   = (k <= 3 && var->APD_p_switch[8 - 2*k] == 0);   // not yet repolarised: lower bound only
+			if (open_APD) b[k] = sim_time - var->t_ex;
+			double w        = pop->margin*(pop->hi[i] - pop->lo[i]);
+			if (b[k] > pop->hi[i] + w || (open_APD == false && b[k] < pop->lo[i] - w)) reason = population_biomarker_names[k];
+		}
+	}
+	if (reason == NULL) return false;
+	strcpy(failed, reason);
+	*status = POP_ABORTED;
+	return true;
+}
+
+// Acceptance on the final beat; returns POP_ACCEPTED or POP_REJECTED
+int population_evaluate(Population *pop, Model_variables var, char *failed, double *b)
+{
+	population_measure(var, b, true);
+	strcpy(failed, "-");
+	for (int i = 0; i < POP_NBIOMARKERS; i++) if (b[i] != b[i])
+	{
+		strcpy(failed, "NaN");
+		return POP_REJECTED;
+	}
+	for (int i = 0; i < pop->Ncriteria; i++)
+	{
+		int k = pop->biomarker[i];
+		if (b[k] < pop->lo[i] || b[k] > pop->hi[i])
+		{
+			strcpy(failed, population_biomarker_names[k]);
+			return POP_REJECTED;
+		}
+	}
+	return POP_ACCEPTED;
+}
+// End Evaluation ===============================================================================//|
+
+// Outputs ======================================================================================\\|
+void population_write_header(Population *pop, FILE *out)
+{
+	int col = 5;
+	fprintf(out, "# %s sampling, %d samples", pop->method, pop->N);
+	if (strcmp(pop->method, "lhs") == 0) fprintf(out, " (seed %u)", pop->seed);
+	fprintf(out, " || criteria:");
+	for (int i = 0; i < pop->Ncriteria; i++) fprintf(out, " %s [%g, %g]", population_biomarker_names[pop->biomarker[i]], pop->lo[i], pop->hi[i]);
+	if (pop->reject_after > 0) fprintf(out, " || early rejection from beat %d, margin %g", pop->reject_after, pop->margin);
+	fprintf(out, "\n# 1: member | 2: sample | 3: status (1 accepted, 2 rejected, 3 rejected early) | 4: beats paced |");
+	for (int d = 0; d < pop->Nsampled; d++) fprintf(out, " %d: %s", col++, pop->arg[d]);
+	fprintf(out, " |");
+	for (int i = 0; i < POP_NBIOMARKERS; i++) fprintf(out, " %d: %s", col++, population_biomarker_names[i]);
+	fprintf(out, " | %d: biomarker out of range\n", col);
+}
+
+void population_write_line(Population *pop, FILE *out, int member, int sample, int status, int beats, const double *b, const char *failed)
+{
+	fprintf(out, "%d %d %d %d", member, sample, status, beats);
+	for (int d = 0; d < pop->Nsampled; d++) fprintf(out, " %.10g", pop->x[sample*pop->Nsampled + d]);
+	for (int i = 0; i < POP_NBIOMARKERS; i++) fprintf(out, " %f", b[i]);
+	fprintf(out, " %s\n", failed);
+}
+// End Outputs ==================================================================================//|
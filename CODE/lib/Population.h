@@ -0,0 +1,128 @@
+// Source code associated with  ===========================  //
+// "Multi-scale cardiac simulation framework" =============  //
+// For simulation of cardiac cellular and tissue dynamics =  //
+// from the spatial cellular to full organ scales. ========  //
+// With implementation of multiple, published cell models =  //
+// as well as novel models developed in my lab. ===========  //
+// ========================================================  //
+// This file: Population of models: sampling ==============  //
+// and biomarker acceptance, header =======================  //
+// ========================================================  //
+// GNU 3 LICENSE TEXT =====================================  //
+// COPYRIGHT (C) 2016-2019 MICHAEL A. COLMAN ==============  //
+// THIS PROGRAM IS FREE SOFTWARE: YOU CAN REDISTRIBUTE IT =  //
+// AND/OR MODIFY IT UNDER THE TERMS OF THE GNU GENERAL ====  //
+// PUBLIC LICENSE AS PUBLISHED BY THE FREE SOFTWARE =======  //
+// FOUNDATION, EITHER VERSION 3 OF THE LICENSE, OR (AT YOUR  //
+// OPTION) ANY LATER VERSION. =============================  //
+// THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE=  //
+// USEFUL, BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE =====  //
+// IMPLIED WARRANTY OF MERCHANTABILITY OR FITNESS FOR A ===  //
+// PARTICULAR PURPOSE.  SEE THE GNU GENERAL PUBLIC LICENSE=  //
+// FOR MORE DETAILS. ======================================  //
+// YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL =====  //
+// PUBLIC LICENSE ALONG WITH THIS PROGRAM.  IF NOT, SEE ===  //
+// <https://www.gnu.org/licenses/>. =======================  //
+// ========================================================  //
+// ADDITIONAL LICENSE TEXT ================================  //
+// THIS SOFTWARE IS PROVIDED OPEN SOURCE AND MAY BE FREELY=  //
+// USED, DISTRIBUTED AND UPDATED, PROVIDED: ===============  //
+//  (i) THE APPROPRIATE WORK(S) IS(ARE) CITED. THIS =======  //
+//      PERTAINS TO THE CITATION OF COLMAN 2019 PLOS COMP =  //
+//      BIOL (FOR THIS IMPLEMTATION) AND ALL WORKS ========  //
+//      ASSOCIATED WITH THE SPECIFIC MODELS AND COMPONENTS=  //
+//      USED IN PARTICULAR SIMULATIONS. IT IS THE USER'S ==  //
+//      RESPONSIBILITY TO ENSURE ALL RELEVANT WORKS ARE ===  //
+//      CITED. PLEASE SEE FULL DOCUMENTATION AND ON-SCREEN=  //
+//      DISCLAIMER OUTPUTS FOR A GUIDE. ===================  //
+//  (ii) ALL OF THIS TEXT IS RETAINED WITHIN OR ASSOCIATED=  //
+//      WITH THE SOURCE CODE AND/OR BINARY FORM OF THE ====  //
+//      SOFTWARE. =========================================  //
+// ========================================================  //
+// ANY INTENDED COMMERCIAL USE OF THIS SOFTWARE MUST BE BY   //
+// EXPRESS PERMISSION OF MICHAEL A COLMAN ONLY. IN NO EVENT  //
+// ARE THE COPYRIGHT HOLDERS LIABLE FOR ANY DIRECT, =======  //
+// INDIRECT INCIDENTAL, SPECIAL, EXEMPLARY OR CONSEQUENTIAL  //
+// DAMAGES ASSOCIATED WITH USE OF THIS SOFTWARE ===========  //
+// ========================================================  //
+// THIS SOFTWARE CONTAINS IMPLEMENTATIONS OF MODELS AND ===  //
+// COMPONENTS WHICH I (MICHAEL COLMAN) DID NOT DEVELOP.====  //
+// ALL OF THESE COMPONENTS HAVE BEEN CODED FROM PROVIDED ==  //
+// SOURCE CODE OR INFORMATION IN THE PUBLICATIONS. ========  //
+// I CLAIM NO RIGHTS OR INTELLECTUAL PROPERTY OWNERSHIP ===  //
+// FOR THESE MODELS AND COMPONENTS, OTHER THAN THEIR ======  //
+// SPECIFIC IMPLEMENTATION IN THIS CODE PACKAGE. FURTHER TO  //
+// THE ABOVE STATEMENT, ANY INDTENDED COMMERCIAL USE OF ===  //
+// THOSE COMPONENTS MUST BE BY EXPRESS PERMISSION OF THE ==  //
+// ORIGINAL COPYRIGHT HOLDERS. ============================  //
+// WHERE IMPLEMENTED FROM PROVIDED CODE, ANY DISCLAIMERS ==  //
+// PRESENT IN THE ORIGINAL CODE HAVE BEEN RETAINED IN THE =  //
+// RELEVANT FILE. =========================================  //
+// ========================================================  //
+// Contact: m.a.colman@leeds.ac.uk ========================  //
+// For updates, corrections etc, please check: ============  //
+// 1. http://physicsoftheheart.com/ =======================  //
+// 2. https://github.com/michaelcolman ====================  //
+// ========================================================  //
+
+#ifndef POPULATION_H
+#define POPULATION_H
+
+#include "Structs.h"
+#include <stdio.h>
+
+#define POP_MAX_SAMPLED     32      // sampled arguments
+#define POP_MAX_CRITERIA    16      // acceptance criteria
+#define POP_NBIOMARKERS     13
+#define POP_SOBOL_MAX_DIMS  21
+
+// Member outcome
+#define POP_NONE            0       // not a population member / no criteria
+#define POP_ACCEPTED        1
+#define POP_REJECTED        2       // out of range at the end of the run
+#define POP_ABORTED         3       // clearly out of range during pacing; run stopped
+
+extern const char *population_biomarker_names[POP_NBIOMARKERS];
+
+typedef struct{
+	bool        on;
+	char        method[8];          // "lhs" or "sobol"
+	int         N;                  // samples
+	unsigned int seed;              // lhs
+
+	// Sampled arguments: value = min + u(max - min), or min(max/min)^u if log
+	int         Nsampled;
+	char        *arg[POP_MAX_SAMPLED];
+	double      min[POP_MAX_SAMPLED];
+	double      max[POP_MAX_SAMPLED];
+	bool        log[POP_MAX_SAMPLED];
+	double      *x;                 // N x Nsampled argument values
+
+	// Acceptance criteria on the final beat
+	int         Ncriteria;
+	int         biomarker[POP_MAX_CRITERIA];
+	double      lo[POP_MAX_CRITERIA];
+	double      hi[POP_MAX_CRITERIA];
+
+	// Early rejection during pacing
+	int         reject_after;       // first beat checked (0 = no early rejection)
+	double      margin;             // clearly out = beyond range +- margin x range width
+}Population;
+
+// Setup
+void population_defaults(Population *pop);
+void population_add_sampled(Population *pop, const char *arg, double min, double max, bool log);
+void population_add_criterion(Population *pop, const char *biomarker, double lo, double hi);
+void population_generate(Population *pop, int N, const char *method, unsigned int seed);
+void population_free(Population *pop);
+
+// Evaluation (read only, called concurrently by members)
+void population_measure(Model_variables var, double *b, bool final);
+bool population_abort(Population *pop, Model_variables *var, double Vm, int iteration_counter, double sim_time, int *status, char *failed, double *b);
+int  population_evaluate(Population *pop, Model_variables var, char *failed, double *b);
+
+// Outputs
+void population_write_header(Population *pop, FILE *out);
+void population_write_line(Population *pop, FILE *out, int member, int sample, int status, int beats, const double *b, const char *failed);
+
+#endif
@@ -0,0 +1,491 @@
+// Source code associated with  ===========================  //
+// "Multi-scale cardiac simulation framework" =============  //
+// For simulation of cardiac cellular and tissue dynamics =  //
+// from the spatial cellular to full organ scales. ========  //
+// With implementation of multiple, published cell models =  //
+// as well as novel models developed in my lab. ===========  //
+// ========================================================  //
+// This file: Configurable cell probes: ===================  //
+// binary per-cell time series ============================  //
+// ========================================================  //
+// GNU 3 LICENSE TEXT =====================================  //
+// COPYRIGHT (C) 2016-2019 MICHAEL A. COLMAN ==============  //
+// THIS PROGRAM IS FREE SOFTWARE: YOU CAN REDISTRIBUTE IT =  //
+// AND/OR MODIFY IT UNDER THE TERMS OF THE GNU GENERAL ====  //
+// PUBLIC LICENSE AS PUBLISHED BY THE FREE SOFTWARE =======  //
+// FOUNDATION, EITHER VERSION 3 OF THE LICENSE, OR (AT YOUR  //
+// OPTION) ANY LATER VERSION. =============================  //
+// THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE=  //
+// USEFUL, BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE =====  //
+// IMPLIED WARRANTY OF MERCHANTABILITY OR FITNESS FOR A ===  //
+// PARTICULAR PURPOSE.  SEE THE GNU GENERAL PUBLIC LICENSE=  //
+// FOR MORE DETAILS. ======================================  //
+// YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL =====  //
+// PUBLIC LICENSE ALONG WITH THIS PROGRAM.  IF NOT, SEE ===  //
+// <https://www.gnu.org/licenses/>. =======================  //
+// ========================================================  //
+// ADDITIONAL LICENSE TEXT ================================  //
+// THIS SOFTWARE IS PROVIDED OPEN SOURCE AND MAY BE FREELY=  //
+// USED, DISTRIBUTED AND UPDATED, PROVIDED: ===============  //
+//  (i) THE APPROPRIATE WORK(S) IS(ARE) CITED. THIS =======  //
+//      PERTAINS TO THE CITATION OF COLMAN 2019 PLOS COMP =  //
+//      BIOL (FOR THIS IMPLEMTATION) AND ALL WORKS ========  //
+//      ASSOCIATED WITH THE SPECIFIC MODELS AND COMPONENTS=  //
+//      USED IN PARTICULAR SIMULATIONS. IT IS THE USER'S ==  //
+//      RESPONSIBILITY TO ENSURE ALL RELEVANT WORKS ARE ===  //
+//      CITED. PLEASE SEE FULL DOCUMENTATION AND ON-SCREEN=  //
+//      DISCLAIMER OUTPUTS FOR A GUIDE. ===================  //
+//  (ii) ALL OF THIS TEXT IS RETAINED WITHIN OR ASSOCIATED=  //
+//      WITH THE SOURCE CODE AND/OR BINARY FORM OF THE ====  //
+//      SOFTWARE. =========================================  //
+// ========================================================  //
+// ANY INTENDED COMMERCIAL USE OF THIS SOFTWARE MUST BE BY   //
+// EXPRESS PERMISSION OF MICHAEL A COLMAN ONLY. IN NO EVENT  //
+// ARE THE COPYRIGHT HOLDERS LIABLE FOR ANY DIRECT, =======  //
+// INDIRECT INCIDENTAL, SPECIAL, EXEMPLARY OR CONSEQUENTIAL  //
+// DAMAGES ASSOCIATED WITH USE OF THIS SOFTWARE ===========  //
+// ========================================================  //
+// THIS SOFTWARE CONTAINS IMPLEMENTATIONS OF MODELS AND ===  //
+// COMPONENTS WHICH I (MICHAEL COLMAN) DID NOT DEVELOP.====  //
+// ALL OF THESE COMPONENTS HAVE BEEN CODED FROM PROVIDED ==  //
+// SOURCE CODE OR INFORMATION IN THE PUBLICATIONS. ========  //
+// I CLAIM NO RIGHTS OR INTELLECTUAL PROPERTY OWNERSHIP ===  //
+// FOR THESE MODELS AND COMPONENTS, OTHER THAN THEIR ======  //
+// SPECIFIC IMPLEMENTATION IN THIS CODE PACKAGE. FURTHER TO  //
+// THE ABOVE STATEMENT, ANY INDTENDED COMMERCIAL USE OF ===  //
+// THOSE COMPONENTS MUST BE BY EXPRESS PERMISSION OF THE ==  //
+// ORIGINAL COPYRIGHT HOLDERS. ============================  //
+// WHERE IMPLEMENTED FROM PROVIDED CODE, ANY DISCLAIMERS ==  //
+// PRESENT IN THE ORIGINAL CODE HAVE BEEN RETAINED IN THE =  //
+// RELEVANT FILE. =========================================  //
+// ========================================================  //
+// Contact: m.a.colman@leeds.ac.uk ========================  //
+// For updates, corrections etc, please check: ============  //
+// 1. http://physicsoftheheart.com/ =======================  //
+// 2. https://github.com/michaelcolman ====================  //
+// ========================================================  //
+
+#include "Probes.h"
+#include "Structs.h"
+#include "Spatial_coupling.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <math.h>
+#include <omp.h>
+
+// Function list ================================================================================\\|
+//	probes_init()
+//	probes_sample()
+//	probes_finalise()
+//
+//	Internal
+//	    probe_find_variable()
+//	    probe_integrated_excluded_variable()
+//	    probe_find_group()
+//	    probe_add_cell()
+//	    probe_open()
+//	    probe_flush()
+// End Function list ============================================================================//|
+
+// Notes ========================================================================================\\|
+// Records selected variables of selected cells, each group at its own interval, without text
+// formatting in the time loop. Probe_file is a text file, one group per line ('#' = comment):
+//      name  interval(ms)  var1,var2,...  cell x,y,z [x,y,z ...]
+//      name  interval(ms)  var1,var2,...  region value [stride]
+//      name  interval(ms)  var1,var2,...  all [stride]
+// cell:    cell indices in the geometry box (as Tissue_geometries; missing y,z = 0)
+// region:  every stride-th cell with geometry/celltype value "value" (sc.geo_linear)
+// all:     every stride-th cell of the tissue
+// Lines with the same name add cells to that group (interval and variables must match), so large
+// sets of single cells can be listed one per line. Variables are Vm and the double members of 
+// State_variables/Model_variables listed in probe_variable[] below (names as in lib/Structs.h);
+// the integrated models (model_tissue_0D*) refuse those in probe_integrated_excluded[].
+// Sampling (after the tissue loops, every interval) copies the values straight into the group's
+// record buffer, in parallel over cells for large groups; each thread writes its own part of the
+// record, so no locks or per-thread buffers are needed. The buffer (~PROBE_FLUSH_BYTES) is written
+// with a single fwrite when full and at the end.
+// Output: Outputs_X/Probe_<name>.bin, native byte order:
+//      header  char[8] "MSCSFPR", int32 version, int32 Ncells, int32 Nvars, double interval (ms),
+//              Nvars x char[16] variable names, Ncells x int32 (cell index, x, y, z)
+//      records double time (ms), Ncells x Nvars float (all variables of cell 0, then cell 1, ...)
+// e.g. numpy: np.dtype([('t','<f8'), ('v','<f4',(Ncells,Nvars))]) from the end of the header.
+// End Notes ====================================================================================//|
+
+// Variables that may be probed =================================================================\\|
+typedef struct{
+	const char  *name;
+	int         source;
+	size_t      offset;
+}Probe_variable;
+
+#define PROBE_S(f)  { #f, PROBE_STATE, offsetof(State_variables, f) }
+#define PROBE_V(f)  { #f, PROBE_VARIABLES, offsetof(Model_variables, f) }
+
+static const Probe_variable probe_variable[] = {
+	{ "Vm", PROBE_VM, 0 },
+	// Currents (pA/pF)
+	PROBE_V(Istim), PROBE_V(Itot), PROBE_V(INa), PROBE_V(INaL), PROBE_V(Ito), PROBE_V(ICaL), PROBE_V(IKur),
+	PROBE_V(IKr), PROBE_V(IKs), PROBE_V(IK1), PROBE_V(INCX), PROBE_V(INaK), PROBE_V(ICaP), PROBE_V(INab),
+	PROBE_V(ICab), PROBE_V(IKb), PROBE_V(IClCa), PROBE_V(IClb), PROBE_V(IKACh), PROBE_V(If),
+	PROBE_V(INa_sl), PROBE_V(INaL_sl), PROBE_V(INab_sl), PROBE_V(ICab_sl), PROBE_V(ICaP_sl), PROBE_V(INCX_sl),
+	PROBE_V(ICaL_sl), PROBE_V(INaK_sl), PROBE_V(IClCa_sl), PROBE_V(IKs_sl), PROBE_V(INa_j), PROBE_V(INaL_j),
+	PROBE_V(INab_j), PROBE_V(ICab_j), PROBE_V(ICaP_j), PROBE_V(INCX_j), PROBE_V(ICaL_j), PROBE_V(INaK_j),
+	PROBE_V(IClCa_j), PROBE_V(IKs_j),
+	PROBE_V(Ip0d), PROBE_V(Ip1r), PROBE_V(Ip2d), PROBE_V(Ip2r), PROBE_V(Ip3r), PROBE_V(Ip4r),
+	// Reversal potentials (mV)
+	PROBE_V(ENa), PROBE_V(EK), PROBE_V(EKs), PROBE_V(ECa), PROBE_V(ECl),
+	// Ca2+ fluxes
+	PROBE_V(J_rel), PROBE_V(J_SERCA), PROBE_V(J_leak), PROBE_V(J_jsr_nsr),
+	// Measurement variables
+	PROBE_V(dvdt), PROBE_V(dvdt_max), PROBE_V(t_ex), PROBE_V(Vmax), PROBE_V(Vmin), PROBE_V(APD_t),
+	PROBE_V(CaT_max), PROBE_V(CaT_min), PROBE_V(CaSR_max), PROBE_V(CaSR_min),
+	// Gating variables
+	PROBE_S(INa_va), PROBE_S(INa_vi_1), PROBE_S(INa_vi_2), PROBE_S(INaL_va), PROBE_S(INaL_vi),
+	PROBE_S(Ito_va), PROBE_S(Ito_vi), PROBE_S(Ito_vi_s), PROBE_S(Ito_vi_3), PROBE_S(ICaL_va), PROBE_S(ICaL_vi),
+	PROBE_S(ICaL_vi_s), PROBE_S(ICaL_ci), PROBE_S(ICaL_ci_j), PROBE_S(IKur_va), PROBE_S(IKur_vi),
+	PROBE_S(IKr_va), PROBE_S(IKr_vi), PROBE_S(IKs_va), PROBE_S(IKs_va_2), PROBE_S(IK1_va), PROBE_S(IKACh_va),
+	PROBE_S(IKACh_vi), PROBE_S(If_va), PROBE_S(Ip0d_va), PROBE_S(Ip0d_vi_1), PROBE_S(Ip0d_vi_2),
+	PROBE_S(Ip1r_va), PROBE_S(Ip1r_vi), PROBE_S(Ip2d_va), PROBE_S(Ip2d_vi), PROBE_S(Ip2r_va), PROBE_S(Ip2r_vi),
+	PROBE_S(Ip3r_va), PROBE_S(ICaL_5sm_C1), PROBE_S(ICaL_5sm_C2), PROBE_S(ICaL_5sm_I1), PROBE_S(ICaL_5sm_I2),
+	PROBE_S(ICaL_5sm_O),
+	// Concentrations (mM) and Ca2+ handling
+	PROBE_S(Nai), PROBE_S(Ki), PROBE_S(Cai), PROBE_S(Nai_j), PROBE_S(Nai_sl), PROBE_S(Cai_j), PROBE_S(Cai_sl),
+	PROBE_S(cmdn), PROBE_S(trpn), PROBE_S(csqn), PROBE_S(CajSR), PROBE_S(CanSR), PROBE_S(RyRo), PROBE_S(RyRr),
+	PROBE_S(RyRi), PROBE_S(Tn_CHm), PROBE_S(Tn_CHc), PROBE_S(Myo_m), PROBE_S(Myo_c), PROBE_S(Tn_CL),
+	PROBE_S(CaCalse), PROBE_S(CaCal), PROBE_S(Catrop), PROBE_S(Camg), PROBE_S(Mgmg)
+};
+static const int Nprobe_variables = sizeof(probe_variable)/sizeof(probe_variable[0]);
+
+// Held by the Ca system (Ca/Dyad/SR, lib/CRU.cpp) in the integrated models; the State/Variables
+// copies are only set at state-write time, so these are refused there rather than recorded constant
+static const char *probe_integrated_excluded[] = {
+	"Cai_sl", "Cai_j", "Myo_m", "Myo_c", "ICaL_va", "ICaL_vi", "ICaL_vi_s", "ICaL_ci",
+	"J_rel", "J_SERCA", "J_leak", "J_jsr_nsr"
+};
+static const int Nprobe_integrated_excluded = sizeof(probe_integrated_excluded)/sizeof(probe_integrated_excluded[0]);
+// End Variables that may be probed =============================================================//|
+
+// Internal =====================================================================================\\|
+static int probe_find_variable(const char *name)
+{
+	for (int k = 0; k < Nprobe_variables; k++) if (strcmp(probe_variable[k].name, name) == 0) return k;
+	return -1;
+}
+
+static bool probe_integrated_excluded_variable(const char *name)
+{
+	for (int k = 0; k < Nprobe_integrated_excluded; k++) if (strcmp(probe_integrated_excluded[k], name) == 0) return true;
+	return false;
+}
+
+static int probe_find_group(Probes *pr, const char *name)
+{
+	for (int g = 0; g < pr->Ngroups; g++) if (strcmp(pr->group[g].name, name) == 0) return g;
+	return -1;
+}
+
+static void probe_add_cell(Probe_group *g, int n, int *capacity)
+{
+	if (g->Ncells == *capacity)
+	{
+		*capacity   = (*capacity == 0) ? 16 : 2*(*capacity);
+		g->cell     = (int*)realloc(g->cell, (*capacity)*sizeof(int));
+	}
+	g->cell[g->Ncells++] = n;
+}
+
+// Write header and allocate the record buffer (once all cells are known)
+static void probe_open(Probe_group *g, SC_variables sc, double dt, bool Windows, const char *directory)
+{
+	char filename[1000];
+	if (Windows == true) sprintf(filename, "%s\\Probe_%s.bin", directory, g->name);
+	else sprintf(filename, "%s/Probe_%s.bin", directory, g->name);
+	g->out = fopen(filename, "wb");
+	if (g->out == NULL)
+	{
+		printf("ERROR: cannot open %s\n", filename);
+		exit(1);
+	}
+
+	char magic[8]       = "MSCSFPR";
+	int32_t head[3]     = {1, g->Ncells, g->Nvars};
+	double interval     = g->interval*dt;
+	fwrite(magic, 1, 8, g->out);
+	fwrite(head, sizeof(int32_t), 3, g->out);
+	fwrite(&interval, sizeof(double), 1, g->out);
+	fwrite(g->var_name, PROBE_NAME_LENGTH, g->Nvars, g->out);
+	for (int i = 0; i < g->Ncells; i++)
+	{
+		int n           = g->cell[i];
+		int32_t c[4]    = {n, sc.x_index[n], sc.y_index[n], sc.z_index[n]};
+		fwrite(c, sizeof(int32_t), 4, g->out);
+	}
+
+	g->record_bytes = sizeof(double) + (size_t)g->Ncells*g->Nvars*sizeof(float);
+	g->capacity     = PROBE_FLUSH_BYTES/g->record_bytes;
+	if (g->capacity < 1) g->capacity = 1;
+	g->buffer       = (unsigned char*)malloc(g->capacity*g->record_bytes);
+	g->Nrecords     = 0;
+	g->Nsamples     = 0;
+}
+
+static void probe_flush(Probes *pr, Probe_group *g)
+{
+	if (g->Nrecords == 0) return;
+	double t0 = omp_get_wtime();
+	fwrite(g->buffer, g->record_bytes, g->Nrecords, g->out);
+	pr->flush_time += omp_get_wtime() - t0;
+	g->Nsamples += g->Nrecords;
+	g->Nrecords = 0;
+}
+// End Internal =================================================================================//|
+
+// Read the probe file and open the outputs =====================================================\\|
+void probes_init(Probes *pr, Simulation_parameters sim, SC_variables sc, bool integrated, const char *directory)
+{
+	pr->on              = false;
+	pr->Ngroups         = 0;
+	pr->group           = NULL;
+	pr->Ncells_total    = 0;
+	pr->flush_time      = 0;
+	if (strcmp(sim.Probe_file, "Off") == 0) return;
+
+	// Record counters and the open record file are not part of the checkpoint
+	if (strcmp(sim.Read_checkpoint, "Off") != 0)
+	{
+		printf("ERROR: Probe_file cannot be used with Read_checkpoint (probe records are not continued from a checkpoint); set Probe_file Off for the restart\n");
+		exit(1);
+	}
+
+	FILE *in = fopen(sim.Probe_file, "r");
+	if (in == NULL)
+	{
+		printf("Cannot load probe file %s\t :: is the path correct? Does the file exist in that path?\n", sim.Probe_file);
+		exit(1);
+	}
+
+	int group_capacity  = 0;
+	int *cell_capacity  = NULL;
+	char line[10000];
+	int line_number     = 0;
+	while (fgets(line, sizeof(line), in) != NULL)
+	{
+		line_number++;
+		char *hash = strchr(line, '#');
+		if (hash != NULL) *hash = '\0';
+
+		char *name      = strtok(line, " \t\r\n");
+		if (name == NULL) continue; // blank or comment line
+		char *interval  = strtok(NULL, " \t\r\n");
+		char *vars      = strtok(NULL, " \t\r\n");
+		char *type      = strtok(NULL, " \t\r\n");
+		if (type == NULL)
+		{
+			printf("ERROR: probe file %s line %d: expected \"name interval var1,var2,... cell/region/all ...\"\n", sim.Probe_file, line_number);
+			exit(1);
+		}
+		if (strlen(name) >= sizeof(pr->group[0].name))
+		{
+			printf("ERROR: probe file %s line %d: probe name \"%s\" is too long\n", sim.Probe_file, line_number, name);
+			exit(1);
+		}
+
+		double interval_ms  = atof(interval);
+		int steps           = (int)lround(interval_ms/sim.dt);
+		if (interval_ms <= 0 || steps < 1)
+		{
+			printf("ERROR: probe file %s line %d: interval must be at least dt (%g ms)\n", sim.Probe_file, line_number, sim.dt);
+			exit(1);
+		}
+
+		// New group, or more cells for an existing one
+		int gi = probe_find_group(pr, name);
+		if (gi < 0)
+		{
+			if (pr->Ngroups == group_capacity)
+			{
+				group_capacity  = (group_capacity == 0) ? 8 : 2*group_capacity;
+				pr->group       = (Probe_group*)realloc(pr->group, group_capacity*sizeof(Probe_group));
+				cell_capacity   = (int*)realloc(cell_capacity, group_capacity*sizeof(int));
+			}
+			gi = pr->Ngroups++;
+			Probe_group *g = &pr->group[gi];
+			memset(g, 0, sizeof(Probe_group));
+			cell_capacity[gi] = 0;
+			strcpy(g->name, name);
+			g->interval = steps;
+
+			// Variables
+			int Nvars = 1;
+			for (char *c = vars; *c; c++) if (*c == ',') Nvars++;
+			g->source   = (int*)malloc(Nvars*sizeof(int));
+			g->offset   = (size_t*)malloc(Nvars*sizeof(size_t));
+			g->var_name = (char(*)[PROBE_NAME_LENGTH])calloc(Nvars, PROBE_NAME_LENGTH);
+			char *start = vars;
+			for (int v = 0; v < Nvars; v++)
+			{
+				char *comma = strchr(start, ',');
+				if (comma != NULL) *comma = '\0';
+				int k = probe_find_variable(start);
+				if (k < 0)
+				{
+					printf("ERROR: probe file %s line %d: \"%s\" is not a variable that can be probed (see lib/Probes.cpp)\n", sim.Probe_file, line_number, start);
+					exit(1);
+				}
+				if (integrated == true && probe_integrated_excluded_variable(start) == true)
+				{
+					printf("ERROR: probe file %s line %d: \"%s\" is held by the integrated Ca system in this model and is not updated in State/Variables; it cannot be probed here\n", sim.Probe_file, line_number, start);
+					exit(1);
+				}
+				g->source[v] = probe_variable[k].source;
+				g->offset[v] = probe_variable[k].offset;
+				strncpy(g->var_name[v], probe_variable[k].name, PROBE_NAME_LENGTH - 1);
+				if (comma != NULL) start = comma + 1;
+			}
+			g->Nvars = Nvars;
+		}
+		else if (pr->group[gi].interval != steps)
+		{
+			printf("ERROR: probe file %s line %d: probe \"%s\" is already defined with a different interval\n", sim.Probe_file, line_number, name);
+			exit(1);
+		}
+		Probe_group *g = &pr->group[gi];
+
+		// Cells
+		int Nbefore = g->Ncells;
+		if (strcmp(type, "cell") == 0)
+		{
+			char *coord;
+			while ((coord = strtok(NULL, " \t\r\n")) != NULL)
+			{
+				int x = 0, y = 0, z = 0;
+				if (sscanf(coord, "%d,%d,%d", &x, &y, &z) < 1 || x < 0 || x >= sc.NX || y < 0 || y >= sc.NY || z < 0 || z >= sc.NZ)
+				{
+					printf("ERROR: probe file %s line %d: \"%s\" is not a cell in the %d x %d x %d geometry\n", sim.Probe_file, line_number, coord, sc.NX, sc.NY, sc.NZ);
+					exit(1);
+				}
+				int idx = x + sc.NX*y + sc.NX*sc.NY*z;
+				if (SC_geo(&sc, idx) <= 0)
+				{
+					printf("ERROR: probe file %s line %d: cell %d,%d,%d is empty space\n", sim.Probe_file, line_number, x, y, z);
+					exit(1);
+				}
+				probe_add_cell(g, SC_geo_index(&sc, idx), &cell_capacity[gi]);
+			}
+		}
+		else if (strcmp(type, "region") == 0 || strcmp(type, "all") == 0)
+		{
+			bool all        = (strcmp(type, "all") == 0);
+			int value       = 0;
+			if (all == false)
+			{
+				char *v = strtok(NULL, " \t\r\n");
+				if (v == NULL)
+				{
+					printf("ERROR: probe file %s line %d: region requires a geometry/celltype value\n", sim.Probe_file, line_number);
+					exit(1);
+				}
+				value = atoi(v);
+			}
+			char *s         = strtok(NULL, " \t\r\n");
+			int stride      = (s == NULL) ? 1 : atoi(s);
+			if (stride < 1) stride = 1;
+			int count       = 0;
+			for (int n = 0; n < sc.N; n++)
+			{
+				if (all == false && sc.geo_linear[n] != value) continue;
+				if (count++ % stride == 0) probe_add_cell(g, n, &cell_capacity[gi]);
+			}
+		}
+		else
+		{
+			printf("ERROR: probe file %s line %d: \"%s\" is not a valid cell selection. Please use \"cell\", \"region\" or \"all\"\n", sim.Probe_file, line_number, type);
+			exit(1);
+		}
+		if (g->Ncells == Nbefore)
+		{
+			printf("ERROR: probe file %s line %d: no cells selected\n", sim.Probe_file, line_number);
+			exit(1);
+		}
+	}
+	fclose(in);
+	free(cell_capacity);
+
+	if (pr->Ngroups == 0)
+	{
+		printf("ERROR: probe file %s contains no probes\n", sim.Probe_file);
+		exit(1);
+	}
+
+	for (int gi = 0; gi < pr->Ngroups; gi++)
+	{
+		probe_open(&pr->group[gi], sc, sim.dt, sim.Windows, directory);
+		pr->Ncells_total += pr->group[gi].Ncells;
+	}
+	pr->on = true;
+	printf("\tProbes: %d groups, %d cells (%s)\n", pr->Ngroups, pr->Ncells_total, sim.Probe_file);
+}
+// End Read the probe file and open the outputs =================================================//|
+
+// Sample all groups due at this step ===========================================================\\|
+void probes_sample(Probes *pr, const State_variables *State, const Model_variables *Variables, const double *Vm, double sim_time, int iteration_counter)
+{
+	if (pr->on == false) return;
+
+	for (int gi = 0; gi < pr->Ngroups; gi++)
+	{
+		Probe_group *g = &pr->group[gi];
+		if (iteration_counter % g->interval != 0) continue;
+
+		unsigned char *record = g->buffer + (size_t)g->Nrecords*g->record_bytes;
+		memcpy(record, &sim_time, sizeof(double));
+		float *value        = (float*)(record + sizeof(double));
+		const int Nvars     = g->Nvars;
+		const int *source   = g->source;
+		const size_t *offset = g->offset;
+		const int *cell     = g->cell;
+
+#pragma omp parallel for if (g->Ncells*Nvars > 1024)
+		for (int i = 0; i < g->Ncells; i++)
+		{
+			int n       = cell[i];
+			float *v    = value + (size_t)i*Nvars;
+			for (int k = 0; k < Nvars; k++)
+			{
+				if (source[k] == PROBE_VM)          v[k] = (float)Vm[n];
+				else if (source[k] == PROBE_STATE)  v[k] = (float)*(const double*)((const char*)&State[n] + offset[k]);
+				else                                v[k] = (float)*(const double*)((const char*)&Variables[n] + offset[k]);
+			}
+		}
+
+		g->Nrecords++;
+		if (g->Nrecords == g->capacity) probe_flush(pr, g);
+	}
+}
+// End Sample all groups due at this step =======================================================//|
+
+// Write remaining records and close ============================================================\\|
+void probes_finalise(Probes *pr)
+{
+	if (pr->on == false) return;
+
+	double bytes = 0;
+	for (int gi = 0; gi < pr->Ngroups; gi++)
+	{
+		Probe_group *g = &pr->group[gi];
+		probe_flush(pr, g);
+		fclose(g->out);
+		bytes += (double)g->Nsamples*g->record_bytes;
+		free(g->cell);
+		free(g->source);
+		free(g->offset);
+		free(g->var_name);
+		free(g->buffer);
+	}
+	printf("Probes: %d groups, %d cells || %.2f MB written in %.3f s\n", pr->Ngroups, pr->Ncells_total, bytes/1048576.0, pr->flush_time);
+	free(pr->group);
+	pr->on = false;
+}
+// End Write remaining records and close ========================================================//|
@@ -0,0 +1,271 @@
+// Source code associated with  ===========================  //
+// "Multi-scale cardiac simulation framework" =============  //
+// For simulation of cardiac cellular and tissue dynamics =  //
+// from the spatial cellular to full organ scales. ========  //
+// With implementation of multiple, published cell models =  //
+// as well as novel models developed in my lab. ===========  //
+// ========================================================  //
+// This file: In-loop pseudo-ECG and ======================  //
+// unipolar electrograms ==================================  //
+// ========================================================  //
+// GNU 3 LICENSE TEXT =====================================  //
+// COPYRIGHT (C) 2016-2019 MICHAEL A. COLMAN ==============  //
+// THIS PROGRAM IS FREE SOFTWARE: YOU CAN REDISTRIBUTE IT =  //
+// AND/OR MODIFY IT UNDER THE TERMS OF THE GNU GENERAL ====  //
+// PUBLIC LICENSE AS PUBLISHED BY THE FREE SOFTWARE =======  //
+// FOUNDATION, EITHER VERSION 3 OF THE LICENSE, OR (AT YOUR  //
+// OPTION) ANY LATER VERSION. =============================  //
+// THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE=  //
+// USEFUL, BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE =====  //
+// IMPLIED WARRANTY OF MERCHANTABILITY OR FITNESS FOR A ===  //
+// PARTICULAR PURPOSE.  SEE THE GNU GENERAL PUBLIC LICENSE=  //
+// FOR MORE DETAILS. ======================================  //
+// YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL =====  //
+// PUBLIC LICENSE ALONG WITH THIS PROGRAM.  IF NOT, SEE ===  //
+// <https://www.gnu.org/licenses/>. =======================  //
+// ========================================================  //
+// ADDITIONAL LICENSE TEXT ================================  //
+// THIS SOFTWARE IS PROVIDED OPEN SOURCE AND MAY BE FREELY=  //
+// USED, DISTRIBUTED AND UPDATED, PROVIDED: ===============  //
+//  (i) THE APPROPRIATE WORK(S) IS(ARE) CITED. THIS =======  //
+//      PERTAINS TO THE CITATION OF COLMAN 2019 PLOS COMP =  //
+//      BIOL (FOR THIS IMPLEMTATION) AND ALL WORKS ========  //
+//      ASSOCIATED WITH THE SPECIFIC MODELS AND COMPONENTS=  //
+//      USED IN PARTICULAR SIMULATIONS. IT IS THE USER'S ==  //
+//      RESPONSIBILITY TO ENSURE ALL RELEVANT WORKS ARE ===  //
+//      CITED. PLEASE SEE FULL DOCUMENTATION AND ON-SCREEN=  //
+//      DISCLAIMER OUTPUTS FOR A GUIDE. ===================  //
+//  (ii) ALL OF THIS TEXT IS RETAINED WITHIN OR ASSOCIATED=  //
+//      WITH THE SOURCE CODE AND/OR BINARY FORM OF THE ====  //
+//      SOFTWARE. =========================================  //
+// ========================================================  //
+// ANY INTENDED COMMERCIAL USE OF THIS SOFTWARE MUST BE BY   //
+// EXPRESS PERMISSION OF MICHAEL A COLMAN ONLY. IN NO EVENT  //
+// ARE THE COPYRIGHT HOLDERS LIABLE FOR ANY DIRECT, =======  //
+// INDIRECT INCIDENTAL, SPECIAL, EXEMPLARY OR CONSEQUENTIAL  //
+// DAMAGES ASSOCIATED WITH USE OF THIS SOFTWARE ===========  //
+// ========================================================  //
+// THIS SOFTWARE CONTAINS IMPLEMENTATIONS OF MODELS AND ===  //
+// COMPONENTS WHICH I (MICHAEL COLMAN) DID NOT DEVELOP.====  //
+// ALL OF THESE COMPONENTS HAVE BEEN CODED FROM PROVIDED ==  //
+// SOURCE CODE OR INFORMATION IN THE PUBLICATIONS. ========  //
+// I CLAIM NO RIGHTS OR INTELLECTUAL PROPERTY OWNERSHIP ===  //
+// FOR THESE MODELS AND COMPONENTS, OTHER THAN THEIR ======  //
+// SPECIFIC IMPLEMENTATION IN THIS CODE PACKAGE. FURTHER TO  //
+// THE ABOVE STATEMENT, ANY INDTENDED COMMERCIAL USE OF ===  //
+// THOSE COMPONENTS MUST BE BY EXPRESS PERMISSION OF THE ==  //
+// ORIGINAL COPYRIGHT HOLDERS. ============================  //
+// WHERE IMPLEMENTED FROM PROVIDED CODE, ANY DISCLAIMERS ==  //
+// PRESENT IN THE ORIGINAL CODE HAVE BEEN RETAINED IN THE =  //
+// RELEVANT FILE. =========================================  //
+// ========================================================  //
+// Contact: m.a.colman@leeds.ac.uk ========================  //
+// For updates, corrections etc, please check: ============  //
+// 1. http://physicsoftheheart.com/ =======================  //
+// 2. https://github.com/michaelcolman ====================  //
+// ========================================================  //
+
+#include "Pseudo_ECG.h"
+#include "Checkpoint.h"
+#include "Structs.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <omp.h>
+
+// Function list ================================================================================\\|
+//	pseudo_ECG_init()
+//	pseudo_ECG_output()
+//	pseudo_ECG_finalise()
+//
+//	Internal
+//	    pseudo_ECG_lead_field()
+// End Function list ============================================================================//|
+
+// Notes ========================================================================================\\|
+// Extracellular potential at an electrode at x' in an unbounded homogeneous volume conductor
+// (e.g. Gima & Rudy 2002 Circ Res):
+//      phi(x') = K * sum_n  -grad(Vm)_n . grad(1/r)_n dV,     r = |x_n - x'|
+// with K = a^2 sigma_i / (4 sigma_e) set to 1 (output is in mV; scale as required). grad(Vm) is 
+// the same finite difference as used for the coupling: central, one-sided at edges and next to
+// empty space (neighbour arrays return the cell itself, lib/Spatial_coupling.cpp). Since phi is 
+// linear in Vm, the difference operator is transposed once at setup to give one lead-field weight
+// per cell and electrode; each output is then a single parallel dot product per electrode.
+// r is softened by half a space step (r^2 + dx^2/4) so electrodes may be placed on the tissue.
+// Electrode positions are in mm from cell (0,0,0) of the geometry box (cell centre x*dx etc);
+// "auto" places two electrodes 5 mm beyond either end of the tissue along x, at the centre of 
+// the box in y and z. Bipolar leads are differences of electrodes.
+// Written per ms (as the other time-series outputs) to Outputs_X/Pseudo_ECG.dat: 
+//      time, phi of each electrode (unipolar electrograms), each bipolar lead
+// End Notes ====================================================================================//|
+
+// Internal =====================================================================================\\|
+// Lead field weights of one electrode
+static void pseudo_ECG_lead_field(double *w, const double *x0, SC_variables sc)
+{
+	double h[3]     = {sc.dx, sc.dy, sc.dz};
+	double dV       = sc.dx*sc.dy*sc.dz;
+	double soft     = 0.25*sc.dx*sc.dx;
+	int *plus[3]    = {sc.xp, sc.yp, sc.zp};
+	int *minus[3]   = {sc.xm, sc.ym, sc.zm};
+
+	for (int n = 0; n < sc.N; n++) w[n] = 0;
+	for (int n = 0; n < sc.N; n++)
+	{
+		double d[3] = {sc.x_index[n]*sc.dx - x0[0], sc.y_index[n]*sc.dy - x0[1], sc.z_index[n]*sc.dz - x0[2]};
+		double r2   = d[0]*d[0] + d[1]*d[1] + d[2]*d[2] + soft;
+		double r3   = r2*sqrt(r2);
+		for (int k = 0; k < 3; k++)
+		{
+			int p = plus[k][n];
+			int m = minus[k][n];
+			if (p == n && m == n) continue;     // no gradient along this axis
+			double step = (p != n && m != n) ? 2*h[k] : h[k];
+			// -grad(Vm).grad(1/r) = grad(Vm).(x - x')/r^3, grad(Vm)_k = (Vm[p] - Vm[m])/step
+			double a = dV*d[k]/(r3*step);
+			w[p] += a;
+			w[m] -= a;
+		}
+	}
+}
+// End Internal =================================================================================//|
+
+// Setup ========================================================================================\\|
+// restart_outcount: output count restored from a checkpoint (-1 if not a restart)
+void pseudo_ECG_init(Pseudo_ECG *pe, Simulation_parameters sim, SC_variables sc, const char *directory, int restart_outcount)
+{
+	memset(pe, 0, sizeof(Pseudo_ECG));
+	if (strcmp(sim.Pseudo_ECG, "On") != 0) return;
+
+	pe->on  = true;
+	pe->N   = sc.N;
+
+	// Electrodes
+	if (strcmp(sim.Pseudo_ECG_electrodes, "auto") == 0)
+	{
+		double xmin = 1e30, xmax = -1e30;
+		for (int n = 0; n < sc.N; n++)
+		{
+			if (sc.x_index[n]*sc.dx < xmin) xmin = sc.x_index[n]*sc.dx;
+			if (sc.x_index[n]*sc.dx > xmax) xmax = sc.x_index[n]*sc.dx;
+		}
+		pe->Nelectrodes = 2;
+		pe->electrode[0][0] = xmin - 5;
+		pe->electrode[1][0] = xmax + 5;
+		for (int e = 0; e < 2; e++)
+		{
+			pe->electrode[e][1] = 0.5*(sc.NY - 1)*sc.dy;
+			pe->electrode[e][2] = 0.5*(sc.NZ - 1)*sc.dz;
+		}
+	}
+	else
+	{
+		char list[1000];
+		strncpy(list, sim.Pseudo_ECG_electrodes, 999);
+		list[999] = '\0';
+		for (char *tok = strtok(list, ":"); tok != NULL; tok = strtok(NULL, ":"))
+		{
+			if (pe->Nelectrodes == PECG_MAX_ELECTRODES)
+			{
+				printf("ERROR: Pseudo_ECG_electrodes: at most %d electrodes\n", PECG_MAX_ELECTRODES);
+				exit(1);
+			}
+			double *x = pe->electrode[pe->Nelectrodes];
+			if (sscanf(tok, "%lf,%lf,%lf", &x[0], &x[1], &x[2]) != 3)
+			{
+				printf("ERROR: Pseudo_ECG_electrodes must be \"auto\" or x,y,z positions (mm) separated by \":\", e.g. -5,10,0:25,10,0\n");
+				exit(1);
+			}
+			pe->Nelectrodes++;
+		}
+		if (pe->Nelectrodes == 0)
+		{
+			printf("ERROR: Pseudo_ECG_electrodes must contain at least one electrode\n");
+			exit(1);
+		}
+	}
+
+	// Bipolar leads
+	if (strcmp(sim.Pseudo_ECG_leads, "none") != 0)
+	{
+		char list[1000];
+		strncpy(list, sim.Pseudo_ECG_leads, 999);
+		list[999] = '\0';
+		for (char *tok = strtok(list, ","); tok != NULL; tok = strtok(NULL, ","))
+		{
+			int a, b;
+			if (sscanf(tok, "%d-%d", &a, &b) != 2 || a < 1 || b < 1 || a > pe->Nelectrodes || b > pe->Nelectrodes || pe->Nleads == PECG_MAX_LEADS)
+			{
+				printf("ERROR: Pseudo_ECG_leads must be \"none\" or up to %d pairs a-b of electrode numbers (1 to %d), e.g. 2-1\n", PECG_MAX_LEADS, pe->Nelectrodes);
+				exit(1);
+			}
+			pe->lead[pe->Nleads][0] = a - 1;
+			pe->lead[pe->Nleads][1] = b - 1;
+			pe->Nleads++;
+		}
+	}
+
+	// Lead fields, one electrode per thread
+	pe->weight = (double*)malloc((size_t)pe->Nelectrodes*pe->N*sizeof(double));
+#pragma omp parallel for schedule(dynamic)
+	for (int e = 0; e < pe->Nelectrodes; e++) pseudo_ECG_lead_field(&pe->weight[(size_t)e*pe->N], pe->electrode[e], sc);
+
+	char *filename  = (char*)malloc(1000);
+	if (sim.Windows == true)    sprintf(filename, "%s\\Pseudo_ECG.dat", directory);
+	else                        sprintf(filename, "%s/Pseudo_ECG.dat", directory);
+	// Restart: header + one row per output count before the checkpoint are kept || lib/Checkpoint.cpp
+	if (restart_outcount >= 0)
+	{
+		checkpoint_resume_output(filename, 1 + (int64_t)restart_outcount);
+		pe->out     = fopen(filename, "at");
+	}
+	else pe->out    = fopen(filename, "wt");
+	if (pe->out == NULL)
+	{
+		printf("ERROR: cannot open %s\n", filename);
+		exit(1);
+	}
+	fseek(pe->out, 0, SEEK_END);
+	if (ftell(pe->out) == 0)
+	{
+		fprintf(pe->out, "# time(ms)");
+		for (int e = 0; e < pe->Nelectrodes; e++) fprintf(pe->out, " E%d(%g,%g,%g)", e+1, pe->electrode[e][0], pe->electrode[e][1], pe->electrode[e][2]);
+		for (int l = 0; l < pe->Nleads; l++) fprintf(pe->out, " E%d-E%d", pe->lead[l][0]+1, pe->lead[l][1]+1);
+		fprintf(pe->out, "\n");
+	}
+	free(filename);
+
+	printf("Pseudo-ECG: %d electrodes, %d bipolar leads, written to %s/Pseudo_ECG.dat\n", pe->Nelectrodes, pe->Nleads, directory);
+}
+// End Setup ====================================================================================//|
+
+// Output =======================================================================================\\|
+// Called at each output time with the current Vm
+void pseudo_ECG_output(Pseudo_ECG *pe, double *Vm, double sim_time)
+{
+	if (pe->on == false) return;
+	int N = pe->N;
+
+	for (int e = 0; e < pe->Nelectrodes; e++)
+	{
+		const double *w = &pe->weight[(size_t)e*N];
+		double phi = 0;
+#pragma omp parallel for reduction(+:phi)
+		for (int n = 0; n < N; n++) phi += w[n]*Vm[n];
+		pe->phi[e] = phi;
+	}
+
+	fprintf(pe->out, "%g", sim_time);
+	for (int e = 0; e < pe->Nelectrodes; e++) fprintf(pe->out, " %.6e", pe->phi[e]);
+	for (int l = 0; l < pe->Nleads; l++) fprintf(pe->out, " %.6e", pe->phi[pe->lead[l][0]] - pe->phi[pe->lead[l][1]]);
+	fprintf(pe->out, "\n");
+}
+
+void pseudo_ECG_finalise(Pseudo_ECG *pe)
+{
+	if (pe->on == false) return;
+	fclose(pe->out);
+	free(pe->weight);
+}
+// End Output ===================================================================================//|
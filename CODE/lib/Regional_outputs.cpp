@@ -0,0 +1,305 @@
+// Source code associated with  ===========================  //
+// "Multi-scale cardiac simulation framework" =============  //
+// For simulation of cardiac cellular and tissue dynamics =  //
+// from the spatial cellular to full organ scales. ========  //
+// With implementation of multiple, published cell models =  //
+// as well as novel models developed in my lab. ===========  //
+// ========================================================  //
+// This file: Per-region aggregate time series ============  //
+// reduced inside the tissue loop =========================  //
+// ========================================================  //
+// GNU 3 LICENSE TEXT =====================================  //
+// COPYRIGHT (C) 2016-2019 MICHAEL A. COLMAN ==============  //
+// THIS PROGRAM IS FREE SOFTWARE: YOU CAN REDISTRIBUTE IT =  //
+// AND/OR MODIFY IT UNDER THE TERMS OF THE GNU GENERAL ====  //
+// PUBLIC LICENSE AS PUBLISHED BY THE FREE SOFTWARE =======  //
+// FOUNDATION, EITHER VERSION 3 OF THE LICENSE, OR (AT YOUR  //
+// OPTION) ANY LATER VERSION. =============================  //
+// THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE=  //
+// USEFUL, BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE =====  //
+// IMPLIED WARRANTY OF MERCHANTABILITY OR FITNESS FOR A ===  //
+// PARTICULAR PURPOSE.  SEE THE GNU GENERAL PUBLIC LICENSE=  //
+// FOR MORE DETAILS. ======================================  //
+// YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL =====  //
+// PUBLIC LICENSE ALONG WITH THIS PROGRAM.  IF NOT, SEE ===  //
+// <https://www.gnu.org/licenses/>. =======================  //
+// ========================================================  //
+// ADDITIONAL LICENSE TEXT ================================  //
+// THIS SOFTWARE IS PROVIDED OPEN SOURCE AND MAY BE FREELY=  //
+// USED, DISTRIBUTED AND UPDATED, PROVIDED: ===============  //
+//  (i) THE APPROPRIATE WORK(S) IS(ARE) CITED. THIS =======  //
+//      PERTAINS TO THE CITATION OF COLMAN 2019 PLOS COMP =  //
+//      BIOL (FOR THIS IMPLEMTATION) AND ALL WORKS ========  //
+//      ASSOCIATED WITH THE SPECIFIC MODELS AND COMPONENTS=  //
+//      USED IN PARTICULAR SIMULATIONS. IT IS THE USER'S ==  //
+//      RESPONSIBILITY TO ENSURE ALL RELEVANT WORKS ARE ===  //
+//      CITED. PLEASE SEE FULL DOCUMENTATION AND ON-SCREEN=  //
+//      DISCLAIMER OUTPUTS FOR A GUIDE. ===================  //
+//  (ii) ALL OF THIS TEXT IS RETAINED WITHIN OR ASSOCIATED=  //
+//      WITH THE SOURCE CODE AND/OR BINARY FORM OF THE ====  //
+//      SOFTWARE. =========================================  //
+// ========================================================  //
+// ANY INTENDED COMMERCIAL USE OF THIS SOFTWARE MUST BE BY   //
+// EXPRESS PERMISSION OF MICHAEL A COLMAN ONLY. IN NO EVENT  //
+// ARE THE COPYRIGHT HOLDERS LIABLE FOR ANY DIRECT, =======  //
+// INDIRECT INCIDENTAL, SPECIAL, EXEMPLARY OR CONSEQUENTIAL  //
+// DAMAGES ASSOCIATED WITH USE OF THIS SOFTWARE ===========  //
+// ========================================================  //
+// THIS SOFTWARE CONTAINS IMPLEMENTATIONS OF MODELS AND ===  //
+// COMPONENTS WHICH I (MICHAEL COLMAN) DID NOT DEVELOP.====  //
+// ALL OF THESE COMPONENTS HAVE BEEN CODED FROM PROVIDED ==  //
+// SOURCE CODE OR INFORMATION IN THE PUBLICATIONS. ========  //
+// I CLAIM NO RIGHTS OR INTELLECTUAL PROPERTY OWNERSHIP ===  //
+// FOR THESE MODELS AND COMPONENTS, OTHER THAN THEIR ======  //
+// SPECIFIC IMPLEMENTATION IN THIS CODE PACKAGE. FURTHER TO  //
+// THE ABOVE STATEMENT, ANY INDTENDED COMMERCIAL USE OF ===  //
+// THOSE COMPONENTS MUST BE BY EXPRESS PERMISSION OF THE ==  //
+// ORIGINAL COPYRIGHT HOLDERS. ============================  //
+// WHERE IMPLEMENTED FROM PROVIDED CODE, ANY DISCLAIMERS ==  //
+// PRESENT IN THE ORIGINAL CODE HAVE BEEN RETAINED IN THE =  //
+// RELEVANT FILE. =========================================  //
+// ========================================================  //
+// Contact: m.a.colman@leeds.ac.uk ========================  //
+// For updates, corrections etc, please check: ============  //
+// 1. http://physicsoftheheart.com/ =======================  //
+// 2. https://github.com/michaelcolman ====================  //
+// ========================================================  //
+
+#include "Regional_outputs.h"
+#include "Checkpoint.h"
+#include "Structs.h"
+#include "Spatial_coupling.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <float.h>
+#include <omp.h>
+
+// Function list ================================================================================\\|
+//	regional_outputs_init()
+//	regional_outputs_begin()
+//	regional_outputs_cell()
+//	regional_outputs_write()
+//	regional_outputs_finalise()
+// End Function list ============================================================================//|
+
+// Notes ========================================================================================\\|
+// Mean, min, max of Vm (mV), Cai (uM) and CaSR (mM) and the activated fraction (Vm > RG_ACTIVE_V)
+// of each region, without full spatial outputs. Regions are either the geometry/celltype labels
+// (Regional_outputs geo; sc.geo_linear) or the integer labels > 0 of a full-box map file (as 
+// geometry and stimulus maps; cells labelled <= 0 are in no region).
+// Every Regional_outputs_interval ms, regional_outputs_begin() clears the accumulators, the second
+// tissue loop adds each cell to the accumulator of its region on its own thread, and
+// regional_outputs_write() combines the threads and writes one row. Steps that are not sampled cost
+// one test per cell.
+// Output: Outputs_X/Regional_outputs.dat, header line then one row per interval:
+//      time, per region: [Vm_mean Vm_min Vm_max] [Cai_...] [CaSR_...] [active]
+// with only the statistics listed in Regional_outputs_stats.
+// End Notes ====================================================================================//|
+
+static const char *rg_var_name[RG_NVARS] = {"Vm", "Cai", "CaSR"};
+
+// Set up regions, accumulators and output file =================================================\\|
+// restart_iteration: iteration restored from a checkpoint (-1 if not a restart)
+void regional_outputs_init(Regional_outputs *rg, Simulation_parameters sim, SC_variables sc, const char *directory, int restart_iteration)
+{
+	rg->on  = false;
+	rg->due = false;
+	if (strcmp(sim.Regional_outputs, "Off") == 0) return;
+
+	// Statistics
+	rg->mean = rg->min = rg->max = rg->active = false;
+	char list[1000];
+	char *save;
+	snprintf(list, sizeof(list), "%s", sim.Regional_outputs_stats);
+	for (char *entry = strtok_r(list, ",", &save); entry != NULL; entry = strtok_r(NULL, ",", &save))
+	{
+		if (strcmp(entry, "mean") == 0)         rg->mean    = true;
+		else if (strcmp(entry, "min") == 0)     rg->min     = true;
+		else if (strcmp(entry, "max") == 0)     rg->max     = true;
+		else if (strcmp(entry, "active") == 0)  rg->active  = true;
+		else
+		{
+			printf("ERROR: \"%s\" is not a valid Regional_outputs_stats entry. Please use mean, min, max and/or active\n", entry);
+			exit(1);
+		}
+	}
+
+	// Region label of each cell
+	int *cell_label = (int*)malloc(sc.N*sizeof(int));
+	if (strcmp(sim.Regional_outputs, "geo") == 0)
+	{
+		for (int n = 0; n < sc.N; n++) cell_label[n] = sc.geo_linear[n];
+	}
+	else
+	{
+		FILE *in = fopen(sim.Regional_outputs, "r");
+		if (in == NULL)
+		{
+			printf("Cannot load regional output map file %s\t :: is the path correct? Does the file exist in that path?\n", sim.Regional_outputs);
+			exit(1);
+		}
+		int temp, cell_count = 0;
+		for (int z = 0; z < sc.NZ; z++) {
+			for (int y = 0; y < sc.NY; y++) {
+				for (int x = 0; x < sc.NX; x++) {
+					if (fscanf(in, "%d ", &temp) != 1)
+					{
+						printf("ERROR: regional output map file %s is shorter than the geometry (%d * %d * %d)\n", sim.Regional_outputs, sc.NX, sc.NY, sc.NZ);
+						exit(1);
+					}
+					if (SC_geo(&sc, x + (sc.NX*y) + (sc.NX*sc.NY*z)) > 0) cell_label[cell_count++] = temp;
+				}
+			}
+		}
+		fclose(in);
+	}
+
+	// Labels present, in increasing order, and region of each cell
+	int max_label = 0;
+	for (int n = 0; n < sc.N; n++) if (cell_label[n] > max_label) max_label = cell_label[n];
+	int *label_region = (int*)malloc((max_label + 1)*sizeof(int));
+	for (int l = 0; l <= max_label; l++) label_region[l] = -1;
+	for (int n = 0; n < sc.N; n++) if (cell_label[n] > 0) label_region[cell_label[n]] = 0;
+	rg->Nregions = 0;
+	for (int l = 1; l <= max_label; l++) if (label_region[l] == 0) label_region[l] = rg->Nregions++;
+	if (rg->Nregions == 0)
+	{
+		printf("ERROR: Regional_outputs %s contains no regions (labels > 0)\n", sim.Regional_outputs);
+		exit(1);
+	}
+	rg->label   = (int*)malloc(rg->Nregions*sizeof(int));
+	rg->region  = (int*)malloc(sc.N*sizeof(int));
+	for (int l = 1; l <= max_label; l++) if (label_region[l] >= 0) rg->label[label_region[l]] = l;
+	for (int n = 0; n < sc.N; n++) rg->region[n] = (cell_label[n] > 0) ? label_region[cell_label[n]] : -1;
+	free(label_region);
+	free(cell_label);
+
+	rg->Nthreads    = omp_get_max_threads();
+	rg->acc         = (Regional_accumulator*)malloc(rg->Nthreads*rg->Nregions*sizeof(Regional_accumulator));
+	rg->interval    = (int)(sim.Regional_outputs_interval/sim.dt + 0.5);
+	if (rg->interval < 1) rg->interval = 1;
+
+	// Output file and header
+	char filename[1000];
+	if (sim.Windows == true) sprintf(filename, "%s\\Regional_outputs.dat", directory);
+	else sprintf(filename, "%s/Regional_outputs.dat", directory);
+	// Restart: header + the rows of the steps before the checkpoint are kept || lib/Checkpoint.cpp
+	if (restart_iteration >= 0)
+	{
+		checkpoint_resume_output(filename, 1 + ((int64_t)restart_iteration + rg->interval - 1)/rg->interval);
+		rg->out = fopen(filename, "a");
+	}
+	else rg->out = fopen(filename, "w");
+	if (rg->out == NULL)
+	{
+		printf("ERROR: cannot open %s\n", filename);
+		exit(1);
+	}
+	fseek(rg->out, 0, SEEK_END);
+	if (ftell(rg->out) == 0)
+	{
+		fprintf(rg->out, "time");
+		for (int r = 0; r < rg->Nregions; r++)
+		{
+			for (int v = 0; v < RG_NVARS; v++)
+			{
+				if (rg->mean)   fprintf(rg->out, " R%d_%s_mean", rg->label[r], rg_var_name[v]);
+				if (rg->min)    fprintf(rg->out, " R%d_%s_min", rg->label[r], rg_var_name[v]);
+				if (rg->max)    fprintf(rg->out, " R%d_%s_max", rg->label[r], rg_var_name[v]);
+			}
+			if (rg->active) fprintf(rg->out, " R%d_active", rg->label[r]);
+		}
+		fprintf(rg->out, "\n");
+	}
+
+	rg->on = true;
+	printf("\tRegional outputs: %d regions (%s)\n", rg->Nregions, sim.Regional_outputs);
+}
+// End Set up regions, accumulators and output file =============================================//|
+
+// Clear the accumulators if this step is sampled (before the tissue loop) ======================\\|
+void regional_outputs_begin(Regional_outputs *rg, int iteration_counter)
+{
+	if (rg->on == false) return;
+	rg->due = (iteration_counter % rg->interval == 0);
+	if (rg->due == false) return;
+
+	for (int i = 0; i < rg->Nthreads*rg->Nregions; i++)
+	{
+		Regional_accumulator *a = &rg->acc[i];
+		for (int v = 0; v < RG_NVARS; v++)
+		{
+			a->sum[v] = 0;
+			a->min[v] = DBL_MAX;
+			a->max[v] = -DBL_MAX;
+		}
+		a->count    = 0;
+		a->active   = 0;
+	}
+}
+// End Clear the accumulators ===================================================================//|
+
+// Add one cell (inside the parallel tissue loop) ===============================================\\|
+void regional_outputs_cell(Regional_outputs *rg, int n, double Vm, double Cai, double CaSR)
+{
+	if (rg->due == false) return;
+	int r = rg->region[n];
+	if (r < 0) return;
+
+	Regional_accumulator *a = &rg->acc[omp_get_thread_num()*rg->Nregions + r];
+	double value[RG_NVARS]  = {Vm, Cai, CaSR};
+	for (int v = 0; v < RG_NVARS; v++)
+	{
+		a->sum[v] += value[v];
+		if (value[v] < a->min[v]) a->min[v] = value[v];
+		if (value[v] > a->max[v]) a->max[v] = value[v];
+	}
+	a->count++;
+	if (Vm > RG_ACTIVE_V) a->active++;
+}
+// End Add one cell =============================================================================//|
+
+// Combine threads and write the row (after the tissue loop) ====================================\\|
+void regional_outputs_write(Regional_outputs *rg, double sim_time)
+{
+	if (rg->due == false) return;
+	rg->due = false;
+
+	fprintf(rg->out, "%g", sim_time);
+	for (int r = 0; r < rg->Nregions; r++)
+	{
+		Regional_accumulator total = rg->acc[r];
+		for (int t = 1; t < rg->Nthreads; t++)
+		{
+			Regional_accumulator *a = &rg->acc[t*rg->Nregions + r];
+			for (int v = 0; v < RG_NVARS; v++)
+			{
+				total.sum[v] += a->sum[v];
+				if (a->min[v] < total.min[v]) total.min[v] = a->min[v];
+				if (a->max[v] > total.max[v]) total.max[v] = a->max[v];
+			}
+			total.count     += a->count;
+			total.active    += a->active;
+		}
+		for (int v = 0; v < RG_NVARS; v++)
+		{
+			if (rg->mean)   fprintf(rg->out, " %g", total.sum[v]/total.count);
+			if (rg->min)    fprintf(rg->out, " %g", total.min[v]);
+			if (rg->max)    fprintf(rg->out, " %g", total.max[v]);
+		}
+		if (rg->active) fprintf(rg->out, " %g", (double)total.active/total.count);
+	}
+	fprintf(rg->out, "\n");
+}
+// End Combine threads and write the row ========================================================//|
+
+void regional_outputs_finalise(Regional_outputs *rg)
+{
+	if (rg->on == false) return;
+	fclose(rg->out);
+	free(rg->label);
+	free(rg->region);
+	free(rg->acc);
+	rg->on = false;
+}
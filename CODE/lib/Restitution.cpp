@@ -0,0 +1,365 @@
+// Source code associated with  ===========================  //
+// "Multi-scale cardiac simulation framework" =============  //
+// For simulation of cardiac cellular and tissue dynamics =  //
+// from the spatial cellular to full organ scales. ========  //
+// With implementation of multiple, published cell models =  //
+// as well as novel models developed in my lab. ===========  //
+// ========================================================  //
+// This file: Restitution and ERP protocol ================  //
+// engine (native single cell) ===== ======================  //
+// ========================================================  //
+// GNU 3 LICENSE TEXT =====================================  //
+// COPYRIGHT (C) 2016-2019 MICHAEL A. COLMAN ==============  //
+// THIS PROGRAM IS FREE SOFTWARE: YOU CAN REDISTRIBUTE IT =  //
+// AND/OR MODIFY IT UNDER THE TERMS OF THE GNU GENERAL ====  //
+// PUBLIC LICENSE AS PUBLISHED BY THE FREE SOFTWARE =======  //
+// FOUNDATION, EITHER VERSION 3 OF THE LICENSE, OR (AT YOUR  //
+// OPTION) ANY LATER VERSION. =============================  //
+// THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE=  //
+// USEFUL, BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE =====  //
+// IMPLIED WARRANTY OF MERCHANTABILITY OR FITNESS FOR A ===  //
+// PARTICULAR PURPOSE.  SEE THE GNU GENERAL PUBLIC LICENSE=  //
+// FOR MORE DETAILS. ======================================  //
+// YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL =====  //
+// PUBLIC LICENSE ALONG WITH THIS PROGRAM.  IF NOT, SEE ===  //
+// <https://www.gnu.org/licenses/>. =======================  //
+// ========================================================  //
+// ADDITIONAL LICENSE TEXT ================================  //
+// THIS SOFTWARE IS PROVIDED OPEN SOURCE AND MAY BE FREELY=  //
+// USED, DISTRIBUTED AND UPDATED, PROVIDED: ===============  //
+//  (i) THE APPROPRIATE WORK(S) IS(ARE) CITED. THIS =======  //
+//      PERTAINS TO THE CITATION OF COLMAN 2019 PLOS COMP =  //
+//      BIOL (FOR THIS IMPLEMTATION) AND ALL WORKS ========  //
+//      ASSOCIATED WITH THE SPECIFIC MODELS AND COMPONENTS=  //
+//      USED IN PARTICULAR SIMULATIONS. IT IS THE USER'S ==  //
+//      RESPONSIBILITY TO ENSURE ALL RELEVANT WORKS ARE ===  //
+//      CITED. PLEASE SEE FULL DOCUMENTATION AND ON-SCREEN=  //
+//      DISCLAIMER OUTPUTS FOR A GUIDE. ===================  //
+//  (ii) ALL OF THIS TEXT IS RETAINED WITHIN OR ASSOCIATED=  //
+//      WITH THE SOURCE CODE AND/OR BINARY FORM OF THE ====  //
+//      SOFTWARE. =========================================  //
+// ========================================================  //
+// ANY INTENDED COMMERCIAL USE OF THIS SOFTWARE MUST BE BY   //
+// EXPRESS PERMISSION OF MICHAEL A COLMAN ONLY. IN NO EVENT  //
+// ARE THE COPYRIGHT HOLDERS LIABLE FOR ANY DIRECT, =======  //
+// INDIRECT INCIDENTAL, SPECIAL, EXEMPLARY OR CONSEQUENTIAL  //
+// DAMAGES ASSOCIATED WITH USE OF THIS SOFTWARE ===========  //
+// ========================================================  //
+// THIS SOFTWARE CONTAINS IMPLEMENTATIONS OF MODELS AND ===  //
+// COMPONENTS WHICH I (MICHAEL COLMAN) DID NOT DEVELOP.====  //
+// ALL OF THESE COMPONENTS HAVE BEEN CODED FROM PROVIDED ==  //
+// SOURCE CODE OR INFORMATION IN THE PUBLICATIONS. ========  //
+// I CLAIM NO RIGHTS OR INTELLECTUAL PROPERTY OWNERSHIP ===  //
+// FOR THESE MODELS AND COMPONENTS, OTHER THAN THEIR ======  //
+// SPECIFIC IMPLEMENTATION IN THIS CODE PACKAGE. FURTHER TO  //
+// THE ABOVE STATEMENT, ANY INDTENDED COMMERCIAL USE OF ===  //
+// THOSE COMPONENTS MUST BE BY EXPRESS PERMISSION OF THE ==  //
+// ORIGINAL COPYRIGHT HOLDERS. ============================  //
+// WHERE IMPLEMENTED FROM PROVIDED CODE, ANY DISCLAIMERS ==  //
+// PRESENT IN THE ORIGINAL CODE HAVE BEEN RETAINED IN THE =  //
+// RELEVANT FILE. =========================================  //
+// ========================================================  //
+// Contact: m.a.colman@leeds.ac.uk ========================  //
+// For updates, corrections etc, please check: ============  //
+// 1. http://physicsoftheheart.com/ =======================  //
+// 2. https://github.com/michaelcolman ====================  //
+// ========================================================  //
+
+#include "Restitution.h"
+#include "Structs.h"
+#include "Model.h"
+#include "Outputs.h"
+#include "Read_write_state.h"
+#include "Steady_state.h"
+#include "Periodic_orbit.h"
+#include "Single_cell.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+// Function list ================================================================================\\|
+//	restitution_init()
+//	restitution_run()
+//	restitution_finalise()
+//
+//	Internal
+//	    rp_wtime()
+//	    rp_step()
+//	    rp_pace()
+//	    rp_branch()
+// End Function list ============================================================================//|
+
+// Notes ========================================================================================\\|
+// Replaces one run per BCL and S2 interval (see Example_scripts/Basic_single_cell_examples/03_ and 
+// 06_) with a single run:
+//  Dynamic:    BCLs are paced from Restitution_BCL max down to min, each continuing from the state
+//              at the end of the previous BCL, for Restitution_beats beats (ended early at steady 
+//              state if Steady_state is On; after solving for the limit cycle if Periodic_orbit is 
+//              On, then 3 beats to measure). One line of Properties_log per BCL.
+//  S1S2:       at each BCL, the state at the end of pacing is held in memory and each S2 interval
+//              (Restitution_S2 min:step:max, up to the BCL) branches from it: one S1 then the S2, 
+//              exactly as a run with Read_state On, Beats 1, S2 X from a state written at that BCL,
+//              followed by Restitution_window ms. 
+//  ERP:        the shortest S2 interval that captures (S2 amplitude >= Restitution_ERP_threshold x 
+//              S1 amplitude, amplitude = peak Vm - Vm at the stimulus), bisected to 
+//              Restitution_ERP_resolution ms between the longest failing and shortest capturing 
+//              interval of the S1S2 scan (or Restitution_S2 min and max if not scanned).
+// Write_state On writes the state at the end of pacing at each BCL (state file per BCL).
+// S1-S2 branches of a BCL run concurrently if compiled with OpenMP.
+// End Notes ====================================================================================//|
+
+// Internal =====================================================================================\\|
+static double rp_wtime()
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + 1e-6*tv.tv_usec;
+}
+
+// One time step (as the time loop of Single_cell_native_main.cc)
+static void rp_step(Cell_parameters p, Model_variables *var, State_variables *s, double *Vm, double Paced_time, double S2_time, double sim_time, int iteration_counter, double dt)
+{
+	compute_Istim(p, var, Paced_time, S2_time, sim_time, iteration_counter);
+	single_cell_step_native(p, var, s, *Vm, sim_time, dt);     // lib/Single_cell.cpp
+	*Vm     = s->Vm;
+}
+
+// Paces at BCL from the current state; returns the number of beats paced
+static int rp_pace(Restitution *rp, Cell_parameters p, Model_variables *var, State_variables *s, Simulation_parameters sim, int BCL)
+{
+	sim.BCL         = BCL;
+	sim.NBeats      = rp->beats;
+	sim.S2_CL       = 0;
+	sim.S2_time     = 0;
+
+	// Limit cycle first, then three beats to measure (final two of Properties_log)
+	if (rp->periodic_orbit == true)
+	{
+		Periodic_orbit Orbit;
+		sim.Periodic_orbit = "On";
+		periodic_orbit_init(&Orbit, sim, sizeof(State_variables)/sizeof(double), NULL);
+		stimulus_setup(p, var, sim.dt, BCL, 0, (sim.NBeats-1)*BCL + 5);
+		periodic_orbit_solve_native(&Orbit, p, var, s, sim);
+		periodic_orbit_free(&Orbit);
+		rp->Nbeats     += Orbit.Nbeats;
+		sim.NBeats      = 3;
+	}
+	sim.Paced_time  = (sim.NBeats-1)*BCL + 5;
+	sim.Total_time  = sim.NBeats*BCL;
+	stimulus_setup(p, var, sim.dt, BCL, 0, sim.Paced_time);
+
+	Steady_state Steady;
+	if (rp->steady_state == true && rp->periodic_orbit == false) sim.Steady_state = "On";
+	steady_state_init(&Steady, sim, 1, NULL);
+
+	double Vm = s->Vm;
+	double sim_time;
+	int iteration_counter = 0;
+	for (sim_time = 0.0; sim_time <= (float)sim.Total_time; sim_time += sim.dt)
+	{
+		if (steady_state_reached(&Steady, var, s, iteration_counter, sim_time)) break;
+		rp_step(p, var, s, &Vm, sim.Paced_time, sim.S2_time, sim_time, iteration_counter, sim.dt);
+		iteration_counter ++;
+	}
+	int beats = (Steady.converged_beat > 0) ? Steady.converged_beat : sim.NBeats;
+	steady_state_finalise(&Steady);
+	rp->Nbeats += beats;
+	return beats;
+}
+
+// One S1 then the S2 from the snapshot (as Beats 1, S2 X: set_simulation_settings(), stimulus_setup())
+static void rp_branch(Restitution *rp, Restitution_branch *br, Cell_parameters p, Model_variables var, State_variables s, Simulation_parameters sim, int BCL)
+{
+	double Paced_time   = 5;
+	double S2_time      = br->S2 + Paced_time;
+	double Total_time   = S2_time + rp->window;
+	stimulus_setup(p, &var, sim.dt, BCL, br->S2, Paced_time);
+	int S2_start        = var.Paced_time_int - 5 + var.S2_int;   // first S2 step, compute_Istim()
+
+	double Vm = s.Vm;
+	double V0_S1 = Vm, V0_S2 = Vm, Vmax_S1 = Vm, Vmax_S2 = -1e9;
+	double sim_time;
+	int iteration_counter = 0;
+	for (sim_time = 0.0; sim_time <= (float)Total_time; sim_time += sim.dt)
+	{
+		if (iteration_counter == S2_start) V0_S2 = Vm;
+		rp_step(p, &var, &s, &Vm, Paced_time, S2_time, sim_time, iteration_counter, sim.dt);
+		if (iteration_counter < S2_start)   { if (Vm > Vmax_S1) Vmax_S1 = Vm; }
+		else                                { if (Vm > Vmax_S2) Vmax_S2 = Vm; }
+		iteration_counter ++;
+	}
+	br->amp_S1      = Vmax_S1 - V0_S1;
+	br->amp_S2      = Vmax_S2 - V0_S2;
+	br->captured    = (br->amp_S2 >= rp->threshold*br->amp_S1);
+	br->var         = var;
+}
+// End Internal =================================================================================//|
+
+// Setup ========================================================================================\\|
+void restitution_init(Restitution *rp, Simulation_parameters *sim, const char *directory)
+{
+	memset(rp, 0, sizeof(Restitution));
+	if (strcmp(sim->Restitution, "Off") == 0) return;
+
+	if (sscanf(sim->Restitution_BCL, "%d,%d,%d", &rp->BCL_min, &rp->BCL_max, &rp->BCL_step) != 3 || rp->BCL_min < 1 || rp->BCL_max < rp->BCL_min || rp->BCL_step < 1)
+	{
+		printf("ERROR: Restitution_BCL \"%s\" must be min,max,step (ms)\n", sim->Restitution_BCL);
+		exit(1);
+	}
+	if (sscanf(sim->Restitution_S2, "%d,%d,%d", &rp->S2_min, &rp->S2_max, &rp->S2_step) != 3 || rp->S2_min < 1 || rp->S2_max < rp->S2_min || rp->S2_step < 1)
+	{
+		printf("ERROR: Restitution_S2 \"%s\" must be min,max,step (ms)\n", sim->Restitution_S2);
+		exit(1);
+	}
+	if (sim->S2_CL > 0 || strcmp(sim->Read_state, "phase") == 0 || strcmp(sim->Write_state, "phase") == 0)
+	{
+		printf("ERROR: Restitution sets the pacing and S2 itself; do not pass S2 or phase state files\n");
+		exit(1);
+	}
+
+	rp->on          = true;
+	rp->S1S2        = (strcmp(sim->Restitution, "S1S2") == 0 || strcmp(sim->Restitution, "All") == 0);
+	rp->ERP         = (strcmp(sim->Restitution, "ERP") == 0 || strcmp(sim->Restitution, "All") == 0);
+	rp->beats       = sim->Restitution_beats;
+	rp->window      = sim->Restitution_window;
+	rp->threshold   = sim->Restitution_ERP_threshold;
+	rp->resolution  = sim->Restitution_ERP_resolution;
+
+	// Applied per BCL by the protocol rather than once around the time loop
+	rp->periodic_orbit  = (strcmp(sim->Periodic_orbit, "On") == 0);
+	rp->steady_state    = (strcmp(sim->Steady_state, "On") == 0);
+	rp->write_state     = (strcmp(sim->Write_state, "On") == 0);
+	sim->Periodic_orbit = "Off";
+	sim->Steady_state   = "Off";
+	sim->Write_state    = "Off";
+	sim->Write_state_phase = false;
+
+	char *filename  = (char*)malloc(1000);
+	const char *sep = (sim->Windows == true) ? "\\" : "/";
+	sprintf(filename, "%s%sRestitution_dynamic.dat", directory, sep);
+	rp->dynamic     = fopen(filename, "wt");
+	if (rp->dynamic == NULL)
+	{
+		printf("ERROR: cannot open %s\n", filename);
+		exit(1);
+	}
+	fprintf(rp->dynamic, "# 1-28: as Properties_log.dat (final two beats at each BCL) | 29: beats paced\n");
+	if (rp->S1S2 == true)
+	{
+		sprintf(filename, "%s%sRestitution_S1S2.dat", directory, sep);
+		rp->s1s2    = fopen(filename, "wt");
+		fprintf(rp->s1s2, "# 1-28: as Properties_log.dat (penultimate beat = S1, final beat = S2) | 29: S1 amplitude (mV) | 30: S2 amplitude (mV) | 31: captured; one block per BCL\n");
+	}
+	if (rp->ERP == true)
+	{
+		sprintf(filename, "%s%sRestitution_ERP.dat", directory, sep);
+		rp->erp     = fopen(filename, "wt");
+		fprintf(rp->erp, "# BCL(ms) ERP(ms) longest_failing_S2(ms) APD90_S1(ms) branches | ERP = shortest S2 with amplitude >= %g x S1 amplitude; ERP <= 0: S2_min captures; ERP < 0: S2 max does not capture\n", rp->threshold);
+	}
+	free(filename);
+
+	printf("Restitution protocol %s: BCL %d to %d ms (step %d), up to %d beats each", sim->Restitution, rp->BCL_max, rp->BCL_min, rp->BCL_step, rp->beats);
+	if (rp->S1S2 == true || rp->ERP == true) printf(" || S2 %d to %d ms (step %d)", rp->S2_min, rp->S2_max, rp->S2_step);
+	printf("\n");
+}
+// End Setup ====================================================================================//|
+
+// Run ==========================================================================================\\|
+// From the state in s/var; leaves the state at the end of pacing at the shortest BCL. Returns ms paced.
+double restitution_run(Restitution *rp, Cell_parameters p, Model_variables *var, State_variables *s, Simulation_parameters sim, const char *PATH)
+{
+	double t0 = rp_wtime();
+	double paced_time = 0;
+
+	int NS2_max = (rp->S2_max - rp->S2_min)/rp->S2_step + 1;
+	Restitution_branch *br = (Restitution_branch*)malloc(NS2_max*sizeof(Restitution_branch));
+
+	for (int BCL = rp->BCL_max; BCL >= rp->BCL_min; BCL -= rp->BCL_step)
+	{
+		// Dynamic restitution
+		int beats   = rp_pace(rp, p, var, s, sim, BCL);
+		paced_time += beats*BCL;
+		output_properties_line(rp->dynamic, *var, BCL, 0);     // lib/Outputs.cpp
+		fprintf(rp->dynamic, " %d\n", beats);
+		fflush(rp->dynamic);
+		printf("BCL %d ms: %d beats || APD90 = %.2f ms (previous beat %.2f ms)\n", BCL, beats, var->APD_p[8], var->APD_p_prev[8]);
+
+		if (rp->write_state == true)
+			Write_state_single_cell_native(*s, p, BCL, PATH, p.Model, sim.state_reference_write); //lib/Read_write_state.c
+
+		if (rp->S1S2 == false && rp->ERP == false) continue;
+
+		// S1-S2 scan from the snapshot (s, var are not modified)
+		int NS2 = 0;
+		if (rp->S1S2 == true) for (int S2 = rp->S2_min; S2 <= rp->S2_max && S2 <= BCL; S2 += rp->S2_step) br[NS2++].S2 = S2;
+		#pragma omp parallel for schedule(dynamic,1)
+		for (int k = 0; k < NS2; k++) rp_branch(rp, &br[k], p, *var, *s, sim, BCL);
+		rp->Nbranches += NS2;
+
+		for (int k = 0; k < NS2; k++)
+		{
+			output_properties_line(rp->s1s2, br[k].var, BCL, br[k].S2);   // lib/Outputs.cpp
+			fprintf(rp->s1s2, " %f %f %d\n", br[k].amp_S1, br[k].amp_S2, br[k].captured ? 1 : 0);
+		}
+		if (NS2 > 0) { fprintf(rp->s1s2, "\n\n"); fflush(rp->s1s2); }
+
+		if (rp->ERP == false) continue;
+
+		// ERP: bracket from the scan (or the ends of the S2 range), then bisection
+		int Nbranches = NS2;
+		int hi = -1, lo = -1;
+		if (NS2 > 0)
+		{
+			for (int k = NS2-1; k >= 0 && br[k].captured == true; k--) hi = br[k].S2;
+			for (int k = 0; k < NS2; k++) if (br[k].S2 < hi && br[k].captured == false) lo = br[k].S2;
+		}
+		else
+		{
+			Restitution_branch b;
+			int S2_max = (rp->S2_max < BCL) ? rp->S2_max : BCL;
+			b.S2 = S2_max;      rp_branch(rp, &b, p, *var, *s, sim, BCL);    if (b.captured == true)  hi = S2_max;
+			b.S2 = rp->S2_min;  rp_branch(rp, &b, p, *var, *s, sim, BCL);    if (b.captured == false) lo = rp->S2_min;
+			Nbranches += 2;
+			if (hi > 0 && lo < 0) hi = rp->S2_min;
+		}
+		double APD90_S1 = (NS2 > 0) ? br[0].var.APD_p_prev[8] : var->APD_p[8];
+		if (hi < 0)                 // no capture up to S2 max
+			fprintf(rp->erp, "%d %d %d %f %d\n", BCL, -1, -1, APD90_S1, Nbranches);
+		else if (lo < 0)            // captures at S2 min
+			fprintf(rp->erp, "%d %d %d %f %d\n", BCL, 0, -1, APD90_S1, Nbranches);
+		else
+		{
+			while (hi - lo > rp->resolution)
+			{
+				Restitution_branch b;
+				b.S2 = (lo + hi)/2;
+				rp_branch(rp, &b, p, *var, *s, sim, BCL);
+				Nbranches++;
+				if (b.captured == true) hi = b.S2;
+				else                    lo = b.S2;
+			}
+			fprintf(rp->erp, "%d %d %d %f %d\n", BCL, hi, lo, APD90_S1, Nbranches);
+			printf("BCL %d ms: ERP = %d ms (%d branches)\n", BCL, hi, Nbranches);
+		}
+		fflush(rp->erp);
+		rp->Nbranches += Nbranches - NS2;
+	}
+	free(br);
+
+	rp->wall = rp_wtime() - t0;
+	printf("Restitution protocol finished: %d beats paced, %d S1-S2 branches (%.2f s)\n", rp->Nbeats, rp->Nbranches, rp->wall);
+	return paced_time;
+}
+// End Run ======================================================================================//|
+
+// Finalise =====================================================================================\\|
+void restitution_finalise(Restitution *rp)
+{
+	if (rp->on == false) return;
+	fclose(rp->dynamic);
+	if (rp->s1s2 != NULL)   fclose(rp->s1s2);
+	if (rp->erp != NULL)    fclose(rp->erp);
+	rp->on = false;
+}
+// End Finalise =================================================================================//|
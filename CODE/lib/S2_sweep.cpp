@@ -0,0 +1,394 @@
+// Source code associated with  ===========================  //
+// "Multi-scale cardiac simulation framework" =============  //
+// For simulation of cardiac cellular and tissue dynamics =  //
+// from the spatial cellular to full organ scales. ========  //
+// With implementation of multiple, published cell models =  //
+// as well as novel models developed in my lab. ===========  //
+// ========================================================  //
+// This file: S1-S2 vulnerability window ==================  //
+// sweeps from in-memory snapshots ========================  //
+// ========================================================  //
+// GNU 3 LICENSE TEXT =====================================  //
+// COPYRIGHT (C) 2016-2019 MICHAEL A. COLMAN ==============  //
+// THIS PROGRAM IS FREE SOFTWARE: YOU CAN REDISTRIBUTE IT =  //
+// AND/OR MODIFY IT UNDER THE TERMS OF THE GNU GENERAL ====  //
+// PUBLIC LICENSE AS PUBLISHED BY THE FREE SOFTWARE =======  //
+// FOUNDATION, EITHER VERSION 3 OF THE LICENSE, OR (AT YOUR  //
+// OPTION) ANY LATER VERSION. =============================  //
+// THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE=  //
+// USEFUL, BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE =====  //
+// IMPLIED WARRANTY OF MERCHANTABILITY OR FITNESS FOR A ===  //
+// PARTICULAR PURPOSE.  SEE THE GNU GENERAL PUBLIC LICENSE=  //
+// FOR MORE DETAILS. ======================================  //
+// YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL =====  //
+// PUBLIC LICENSE ALONG WITH THIS PROGRAM.  IF NOT, SEE ===  //
+// <https://www.gnu.org/licenses/>. =======================  //
+// ========================================================  //
+// ADDITIONAL LICENSE TEXT ================================  //
+// THIS SOFTWARE IS PROVIDED OPEN SOURCE AND MAY BE FREELY=  //
+// USED, DISTRIBUTED AND UPDATED, PROVIDED: ===============  //
+//  (i) THE APPROPRIATE WORK(S) IS(ARE) CITED. THIS =======  //
+//      PERTAINS TO THE CITATION OF COLMAN 2019 PLOS COMP =  //
+//      BIOL (FOR THIS IMPLEMTATION) AND ALL WORKS ========  //
+//      ASSOCIATED WITH THE SPECIFIC MODELS AND COMPONENTS=  //
+//      USED IN PARTICULAR SIMULATIONS. IT IS THE USER'S ==  //
+//      RESPONSIBILITY TO ENSURE ALL RELEVANT WORKS ARE ===  //
+//      CITED. PLEASE SEE FULL DOCUMENTATION AND ON-SCREEN=  //
+//      DISCLAIMER OUTPUTS FOR A GUIDE. ===================  //
+//  (ii) ALL OF THIS TEXT IS RETAINED WITHIN OR ASSOCIATED=  //
+//      WITH THE SOURCE CODE AND/OR BINARY FORM OF THE ====  //
+//      SOFTWARE. =========================================  //
+// ========================================================  //
+// ANY INTENDED COMMERCIAL USE OF THIS SOFTWARE MUST BE BY   //
+// EXPRESS PERMISSION OF MICHAEL A COLMAN ONLY. IN NO EVENT  //
+// ARE THE COPYRIGHT HOLDERS LIABLE FOR ANY DIRECT, =======  //
+// INDIRECT INCIDENTAL, SPECIAL, EXEMPLARY OR CONSEQUENTIAL  //
+// DAMAGES ASSOCIATED WITH USE OF THIS SOFTWARE ===========  //
+// ========================================================  //
+// THIS SOFTWARE CONTAINS IMPLEMENTATIONS OF MODELS AND ===  //
+// COMPONENTS WHICH I (MICHAEL COLMAN) DID NOT DEVELOP.====  //
+// ALL OF THESE COMPONENTS HAVE BEEN CODED FROM PROVIDED ==  //
+// SOURCE CODE OR INFORMATION IN THE PUBLICATIONS. ========  //
+// I CLAIM NO RIGHTS OR INTELLECTUAL PROPERTY OWNERSHIP ===  //
+// FOR THESE MODELS AND COMPONENTS, OTHER THAN THEIR ======  //
+// SPECIFIC IMPLEMENTATION IN THIS CODE PACKAGE. FURTHER TO  //
+// THE ABOVE STATEMENT, ANY INDTENDED COMMERCIAL USE OF ===  //
+// THOSE COMPONENTS MUST BE BY EXPRESS PERMISSION OF THE ==  //
+// ORIGINAL COPYRIGHT HOLDERS. ============================  //
+// WHERE IMPLEMENTED FROM PROVIDED CODE, ANY DISCLAIMERS ==  //
+// PRESENT IN THE ORIGINAL CODE HAVE BEEN RETAINED IN THE =  //
+// RELEVANT FILE. =========================================  //
+// ========================================================  //
+// Contact: m.a.colman@leeds.ac.uk ========================  //
+// For updates, corrections etc, please check: ============  //
+// 1. http://physicsoftheheart.com/ =======================  //
+// 2. https://github.com/michaelcolman ====================  //
+// ========================================================  //
+
+#include "S2_sweep.h"
+#include "Structs.h"
+#include "Model.h"
+#include "Spatial_coupling.h"
+#include "Tissue.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Function list ================================================================================\\|
+//	S2_sweep_init()
+//	S2_sweep_due()
+//	S2_sweep_run()
+//	S2_sweep_free()
+//
+//	Internal
+//	    S2_sweep_wtime()
+//	    S2_sweep_thread()
+//	    S2_sweep_branch()
+//	    S2_sweep_evaluate()
+//	    S2_sweep_add()
+//	    S2_sweep_compare()
+// End Function list ============================================================================//|
+
+// Notes ========================================================================================\\|
+// Replaces one run per S2 coupling interval and location (see Example_scripts/Basic_tissue_
+// examples/12_...) with a single run: the S1 beats (the "trunk") are simulated once, up to the
+// step before the earliest S2, and the tissue state is held in memory. Each branch copies that 
+// snapshot and continues with its own S2 interval and site for S2_sweep_window ms after the S2,
+// using the same stimulus, model and coupling functions as the time loop of Tissue_native_main, 
+// so a branch gives the same result as the equivalent separate run.
+// Branches run concurrently: S2_sweep_branches at once (default: one per thread) with the 
+// remaining threads split between them.
+// scan:   every site at S2_sweep_CL min:step:max
+// bisect: scan, then each change of conduction type between neighbouring intervals is bisected
+//         to S2_sweep_resolution ms (all bisection points of a round run concurrently)
+// Outcome per branch as compute_conduction_success() (lib/Tissue.cpp); the vulnerability window 
+// of a site is the range of intervals with uni-directional block.
+// End Notes ====================================================================================//|
+
+// Internal =====================================================================================\\|
+static double S2_sweep_wtime()
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + 1e-6*tv.tv_usec;
+}
+
+static int S2_sweep_thread()
+{
+#ifdef _OPENMP
+	return omp_get_thread_num();
+#else
+	return 0;
+#endif
+}
+
+// Runs one branch from the snapshot (mirrors the time loop of Tissue_native_main.cc)
+static void S2_sweep_branch(S2_sweep *sw, S2_branch *br, S2_slot *slot, Simulation_parameters sim, Tissue_parameters tissue, Cell_parameters *Params, double sim_time, int N)
+{
+	State_variables *State      = slot->State;
+	Model_variables *Variables  = slot->Variables;
+	double *Vm                  = slot->Vm;
+	SC_variables *SC            = &slot->SC;
+	int *S2_area                = sw->S2_area[br->site];
+	int nthreads                = sw->Nthreads;
+	int iteration_counter       = sw->snapshot_iteration;
+
+	memcpy(State, sw->State, N*sizeof(State_variables));
+	memcpy(Variables, sw->Variables, N*sizeof(Model_variables));
+	memcpy(Vm, sw->Vm, N*sizeof(double));
+
+	// S2 timing as set_simulation_settings() and stimulus_setup()
+	double S2_time          = sim.NS2*br->CL + sim.Paced_time;
+	int Total_time          = (int)S2_time + sw->window;
+	Variables[0].S2_int     = br->CL * Variables[0].dtinv;
+
+	for (; sim_time <= (float)Total_time; sim_time += sim.dt)
+	{
+		compute_Istim(Params[0], &Variables[0], sim.Paced_time, S2_time, sim_time, iteration_counter);  	// lib/Model.c
+
+#pragma omp parallel for num_threads(nthreads) default(none) shared(SC, Vm, Params, Variables, State, sim, tissue, sim_time, S2_area, N)
+		for (int n = 0; n < N; n++)
+		{
+			calc_diff_FDM_anisotropic(SC, Vm, n);
+			compute_model_native(Params[n], &Variables[n], &State[n], Vm[n], sim.dt);
+			State[n].Vm	= State[n].Vm + sim.dt*(-(Variables[n].Itot + Variables[0].Istim*tissue.stim_area[n] + Variables[0].Istim_S2*S2_area[n])); 
+			State[n].Vm = State[n].Vm + sim.dt*SC->diff[n];
+			determine_excitation_state(&Variables[n], Vm[n], sim_time);							
+			calculate_measurement_properties(&Variables[n], Vm[n], State[n].Vm, sim_time, sim.dt, -70, State[n].Cai, State[n].CanSR);
+		}
+#pragma omp parallel for num_threads(nthreads) default(none) shared(Vm, State, N)
+		for (int n = 0; n < N; n++) Vm[n] = State[n].Vm;
+
+		iteration_counter++;
+	}
+	br->type = conduction_success_type(Variables, N, S2_time, &br->left, &br->right);   // lib/Tissue.cpp
+}
+
+// Runs branches [first, sw->Nbranches) concurrently
+static void S2_sweep_evaluate(S2_sweep *sw, int first, Simulation_parameters sim, Tissue_parameters tissue, Cell_parameters *Params, double sim_time, int N)
+{
+	int last = sw->Nbranches;
+#pragma omp parallel for num_threads(sw->Nconcurrent) schedule(dynamic, 1) default(none) shared(sw, first, last, sim, tissue, Params, sim_time, N)
+	for (int b = first; b < last; b++)
+		S2_sweep_branch(sw, &sw->branch[b], &sw->slot[S2_sweep_thread()], sim, tissue, Params, sim_time, N);
+}
+
+static void S2_sweep_add(S2_sweep *sw, int site, int CL)
+{
+	if (sw->Nbranches == sw->capacity)
+	{
+		sw->capacity    = (sw->capacity == 0) ? 64 : 2*sw->capacity;
+		sw->branch      = (S2_branch*)realloc(sw->branch, sw->capacity*sizeof(S2_branch));
+	}
+	sw->branch[sw->Nbranches].site  = site;
+	sw->branch[sw->Nbranches].CL    = CL;
+	sw->branch[sw->Nbranches].type  = -1;
+	sw->Nbranches++;
+}
+
+// Sort by site then coupling interval
+static int S2_sweep_compare(const void *a, const void *b)
+{
+	const S2_branch *x = (const S2_branch*)a, *y = (const S2_branch*)b;
+	if (x->site != y->site) return x->site - y->site;
+	return x->CL - y->CL;
+}
+// End Internal =================================================================================//|
+
+// Setup ========================================================================================\\|
+// Called once Sim.dt is final; extends Total_time so the trunk reaches the snapshot
+void S2_sweep_init(S2_sweep *sw, Simulation_parameters *sim, Tissue_parameters tissue, SC_variables sc, const char *directory)
+{
+	memset(sw, 0, sizeof(S2_sweep));
+	if (strcmp(sim->S2_sweep, "Off") == 0) return;
+	sw->on      = true;
+	sw->bisect  = (strcmp(sim->S2_sweep, "bisect") == 0);
+
+	if (strcmp(tissue.Tissue_order, "1D") != 0)
+	{
+		printf("ERROR: S2_sweep requires Tissue_order 1D (conduction success is measured at either end of the strand)\n");
+		exit(1);
+	}
+	if (sim->S2_CL != 0)
+	{
+		printf("ERROR: S2_sweep sets the S2 intervals from S2_sweep_CL; do not also pass S2\n");
+		exit(1);
+	}
+	if (strcmp(tissue.Multi_stim, "On") == 0)
+	{
+		printf("ERROR: S2_sweep cannot be used with Multi_stim\n");
+		exit(1);
+	}
+
+	// Coupling intervals
+	if (sscanf(sim->S2_sweep_CL, "%d,%d,%d", &sw->CL_min, &sw->CL_max, &sw->CL_step) != 3 || sw->CL_min < 1 || sw->CL_max < sw->CL_min || sw->CL_step < 1)
+	{
+		printf("ERROR: S2_sweep_CL \"%s\" is not valid; pass min,max,step in ms (e.g. 150,200,5)\n", sim->S2_sweep_CL);
+		exit(1);
+	}
+	sw->resolution  = sim->S2_sweep_resolution;
+	sw->window      = sim->S2_sweep_window;
+
+	// Sites || "S2" = the S2 location of the tissue model or S2_x_loc
+	if (strcmp(sim->S2_sweep_locations, "S2") == 0) sw->site[sw->Nsites++] = tissue.S2_x_loc;
+	else
+	{
+		char *list = (char*)malloc(strlen(sim->S2_sweep_locations) + 1);
+		strcpy(list, sim->S2_sweep_locations);
+		for (char *tok = strtok(list, ","); tok != NULL; tok = strtok(NULL, ","))
+		{
+			if (sw->Nsites == S2S_MAX_SITES)
+			{
+				printf("ERROR: too many S2_sweep_locations (max %d)\n", S2S_MAX_SITES);
+				exit(1);
+			}
+			sw->site[sw->Nsites++] = atoi(tok);
+		}
+		free(list);
+	}
+	char ref[100];
+	for (int s = 0; s < sw->Nsites; s++)
+	{
+		if (sw->site[s] < 0 || sw->site[s] >= sc.NX)
+		{
+			printf("ERROR: S2_sweep location %d is outside the tissue (NX = %d)\n", sw->site[s], sc.NX);
+			exit(1);
+		}
+		int Nstim;
+		sw->S2_area[s] = new int [sc.N];
+		sprintf(ref, "S2_site_%d", sw->site[s]);
+		create_stimulus_area(sc, tissue.Tissue_order, sw->S2_area[s], sw->site[s], tissue.S2_x_size, 0, 0, 0, 0, &Nstim, directory, ref); // lib/Tissue.cpp
+	}
+
+	// Snapshot || step before the earliest S2 (compute_Istim, lib/Model.c)
+	int dtinv               = (int)(1.0/sim->dt);
+	sw->snapshot_iteration  = sim->Paced_time*dtinv - 5 + sw->CL_min*dtinv;
+	sw->snapshot_time       = sw->snapshot_iteration*sim->dt;
+	if (sim->Total_time < sw->snapshot_time) sim->Total_time = (int)sw->snapshot_time + 1;
+
+	// Concurrency
+	int threads     = 1;
+#ifdef _OPENMP
+	threads         = omp_get_max_threads();
+#endif
+	sw->Nconcurrent = (sim->S2_sweep_branches > 0) ? sim->S2_sweep_branches : threads;
+	sw->Nthreads    = threads/sw->Nconcurrent > 1 ? threads/sw->Nconcurrent : 1;
+#ifdef _OPENMP
+	if (sw->Nthreads > 1) omp_set_max_active_levels(2);
+#endif
+
+	printf("S2 sweep (%s): %d site(s), S2 = %d to %d ms every %d ms", sim->S2_sweep, sw->Nsites, sw->CL_min, sw->CL_max, sw->CL_step);
+	if (sw->bisect == true) printf(", edges bisected to %d ms", sw->resolution);
+	printf("\n\tSnapshot at %.2f ms; %d branches at once, %d thread(s) each\n", sw->snapshot_time, sw->Nconcurrent, sw->Nthreads);
+}
+
+bool S2_sweep_due(S2_sweep *sw, int iteration_counter)
+{
+	return (sw->on == true && iteration_counter >= sw->snapshot_iteration);
+}
+// End Setup ====================================================================================//|
+
+// Run ==========================================================================================\\|
+// Called in place of the remaining time loop, with the state at the start of the snapshot step
+void S2_sweep_run(S2_sweep *sw, Simulation_parameters sim, Tissue_parameters tissue, SC_variables sc, Cell_parameters *Params, State_variables *State, Model_variables *Variables, double *Vm, double sim_time, const char *directory)
+{
+	int N = sc.N;
+	double t0 = S2_sweep_wtime();
+
+	// Snapshot and per-thread branch state
+	sw->State       = new State_variables [N];
+	sw->Variables   = new Model_variables [N];
+	sw->Vm          = new double [N];
+	memcpy(sw->State, State, N*sizeof(State_variables));
+	memcpy(sw->Variables, Variables, N*sizeof(Model_variables));
+	memcpy(sw->Vm, Vm, N*sizeof(double));
+	sw->slot = new S2_slot [sw->Nconcurrent];
+	for (int i = 0; i < sw->Nconcurrent; i++)
+	{
+		sw->slot[i].State       = new State_variables [N];
+		sw->slot[i].Variables   = new Model_variables [N];
+		sw->slot[i].Vm          = new double [N];
+		sw->slot[i].SC          = sc;
+		sw->slot[i].SC.diff     = new double [N];
+	}
+
+	// Scan
+	for (int s = 0; s < sw->Nsites; s++)
+		for (int CL = sw->CL_min; CL <= sw->CL_max; CL += sw->CL_step) S2_sweep_add(sw, s, CL);
+	printf("S2 sweep: running %d branches from snapshot at %.2f ms\n", sw->Nbranches, sim_time);
+	S2_sweep_evaluate(sw, 0, sim, tissue, Params, sim_time, N);
+
+	// Bisection of each change in conduction type between neighbouring evaluated intervals
+	while (sw->bisect == true)
+	{
+		qsort(sw->branch, sw->Nbranches, sizeof(S2_branch), S2_sweep_compare);
+		int first = sw->Nbranches;
+		for (int b = 0; b < first - 1; b++)
+		{
+			S2_branch lo = sw->branch[b], hi = sw->branch[b+1];
+			if (lo.site == hi.site && lo.type != hi.type && hi.CL - lo.CL > sw->resolution) S2_sweep_add(sw, lo.site, (lo.CL + hi.CL)/2);
+		}
+		if (sw->Nbranches == first) break;
+		printf("S2 sweep: bisecting, %d branches\n", sw->Nbranches - first);
+		S2_sweep_evaluate(sw, first, sim, tissue, Params, sim_time, N);
+	}
+	qsort(sw->branch, sw->Nbranches, sizeof(S2_branch), S2_sweep_compare);
+
+	// Outputs || per branch as compute_conduction_success(), then the window per site
+	char *filename = (char*)malloc(1000);
+	sprintf(filename, "%s/1D_conduction_success_log.dat", directory);
+	FILE *out = fopen(filename, "a");
+	for (int b = 0; b < sw->Nbranches; b++)
+		fprintf(out, "%d %f %d %d %d\n", sw->site[sw->branch[b].site], (double)sw->branch[b].CL, sw->branch[b].left, sw->branch[b].right, sw->branch[b].type);
+	fclose(out);
+
+	sprintf(filename, "%s/S2_vulnerability_window.dat", directory);
+	out = fopen(filename, "w");
+	fprintf(out, "# S2_x_loc lower upper width (ms; S2 intervals giving uni-directional block, edges to within %d ms) Nbranches\n", sw->bisect == true ? sw->resolution : sw->CL_step);
+	printf("S2 sweep: vulnerability window per site (uni-directional block)\n");
+	for (int s = 0; s < sw->Nsites; s++)
+	{
+		int lower = -1, upper = -1, count = 0;
+		for (int b = 0; b < sw->Nbranches; b++)
+		{
+			if (sw->branch[b].site != s) continue;
+			count++;
+			if (sw->branch[b].type != 1) continue;
+			if (lower < 0) lower = sw->branch[b].CL;
+			upper = sw->branch[b].CL;
+		}
+		int width = (lower < 0) ? 0 : upper - lower + (sw->bisect == true ? sw->resolution : sw->CL_step);
+		fprintf(out, "%d %d %d %d %d\n", sw->site[s], lower, upper, width, count);
+		if (lower < 0)  printf("\tS2 loc = %d\tno uni-directional block (%d branches)\n", sw->site[s], count);
+		else            printf("\tS2 loc = %d\tS2 = %d to %d ms (width %d ms; %d branches)\n", sw->site[s], lower, upper, width, count);
+	}
+	fclose(out);
+	free(filename);
+	printf("S2 sweep: %d branches in %.2f s\n", sw->Nbranches, S2_sweep_wtime() - t0);
+}
+// End Run ======================================================================================//|
+
+void S2_sweep_free(S2_sweep *sw)
+{
+	for (int s = 0; s < sw->Nsites; s++) delete [] sw->S2_area[s];
+	if (sw->slot != NULL)
+	{
+		for (int i = 0; i < sw->Nconcurrent; i++)
+		{
+			delete [] sw->slot[i].State;
+			delete [] sw->slot[i].Variables;
+			delete [] sw->slot[i].Vm;
+			delete [] sw->slot[i].SC.diff;
+		}
+		delete [] sw->slot;
+	}
+	delete [] sw->State;
+	delete [] sw->Variables;
+	delete [] sw->Vm;
+	free(sw->branch);
+	memset(sw, 0, sizeof(S2_sweep));
+}
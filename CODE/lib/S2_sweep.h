@@ -0,0 +1,121 @@
+// Source code associated with  ===========================  //
+// "Multi-scale cardiac simulation framework" =============  //
+// For simulation of cardiac cellular and tissue dynamics =  //
+// from the spatial cellular to full organ scales. ========  //
+// With implementation of multiple, published cell models =  //
+// as well as novel models developed in my lab. ===========  //
+// ========================================================  //
+// This file: S1-S2 vulnerability window ==================  //
+// sweeps from in-memory snapshots, header ================  //
+// ========================================================  //
+// GNU 3 LICENSE TEXT =====================================  //
+// COPYRIGHT (C) 2016-2019 MICHAEL A. COLMAN ==============  //
+// THIS PROGRAM IS FREE SOFTWARE: YOU CAN REDISTRIBUTE IT =  //
+// AND/OR MODIFY IT UNDER THE TERMS OF THE GNU GENERAL ====  //
+// PUBLIC LICENSE AS PUBLISHED BY THE FREE SOFTWARE =======  //
+// FOUNDATION, EITHER VERSION 3 OF THE LICENSE, OR (AT YOUR  //
+// OPTION) ANY LATER VERSION. =============================  //
+// THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE=  //
+// USEFUL, BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE =====  //
+// IMPLIED WARRANTY OF MERCHANTABILITY OR FITNESS FOR A ===  //
+// PARTICULAR PURPOSE.  SEE THE GNU GENERAL PUBLIC LICENSE=  //
+// FOR MORE DETAILS. ======================================  //
+// YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL =====  //
+// PUBLIC LICENSE ALONG WITH THIS PROGRAM.  IF NOT, SEE ===  //
+// <https://www.gnu.org/licenses/>. =======================  //
+// ========================================================  //
+// ADDITIONAL LICENSE TEXT ================================  //
+// THIS SOFTWARE IS PROVIDED OPEN SOURCE AND MAY BE FREELY=  //
+// USED, DISTRIBUTED AND UPDATED, PROVIDED: ===============  //
+//  (i) THE APPROPRIATE WORK(S) IS(ARE) CITED. THIS =======  //
+//      PERTAINS TO THE CITATION OF COLMAN 2019 PLOS COMP =  //
+//      BIOL (FOR THIS IMPLEMTATION) AND ALL WORKS ========  //
+//      ASSOCIATED WITH THE SPECIFIC MODELS AND COMPONENTS=  //
+//      USED IN PARTICULAR SIMULATIONS. IT IS THE USER'S ==  //
+//      RESPONSIBILITY TO ENSURE ALL RELEVANT WORKS ARE ===  //
+//      CITED. PLEASE SEE FULL DOCUMENTATION AND ON-SCREEN=  //
+//      DISCLAIMER OUTPUTS FOR A GUIDE. ===================  //
+//  (ii) ALL OF THIS TEXT IS RETAINED WITHIN OR ASSOCIATED=  //
+//      WITH THE SOURCE CODE AND/OR BINARY FORM OF THE ====  //
+//      SOFTWARE. =========================================  //
+// ========================================================  //
+// ANY INTENDED COMMERCIAL USE OF THIS SOFTWARE MUST BE BY   //
+// EXPRESS PERMISSION OF MICHAEL A COLMAN ONLY. IN NO EVENT  //
+// ARE THE COPYRIGHT HOLDERS LIABLE FOR ANY DIRECT, =======  //
+// INDIRECT INCIDENTAL, SPECIAL, EXEMPLARY OR CONSEQUENTIAL  //
+// DAMAGES ASSOCIATED WITH USE OF THIS SOFTWARE ===========  //
+// ========================================================  //
+// THIS SOFTWARE CONTAINS IMPLEMENTATIONS OF MODELS AND ===  //
+// COMPONENTS WHICH I (MICHAEL COLMAN) DID NOT DEVELOP.====  //
+// ALL OF THESE COMPONENTS HAVE BEEN CODED FROM PROVIDED ==  //
+// SOURCE CODE OR INFORMATION IN THE PUBLICATIONS. ========  //
+// I CLAIM NO RIGHTS OR INTELLECTUAL PROPERTY OWNERSHIP ===  //
+// FOR THESE MODELS AND COMPONENTS, OTHER THAN THEIR ======  //
+// SPECIFIC IMPLEMENTATION IN THIS CODE PACKAGE. FURTHER TO  //
+// THE ABOVE STATEMENT, ANY INDTENDED COMMERCIAL USE OF ===  //
+// THOSE COMPONENTS MUST BE BY EXPRESS PERMISSION OF THE ==  //
+// ORIGINAL COPYRIGHT HOLDERS. ============================  //
+// WHERE IMPLEMENTED FROM PROVIDED CODE, ANY DISCLAIMERS ==  //
+// PRESENT IN THE ORIGINAL CODE HAVE BEEN RETAINED IN THE =  //
+// RELEVANT FILE. =========================================  //
+// ========================================================  //
+// Contact: m.a.colman@leeds.ac.uk ========================  //
+// For updates, corrections etc, please check: ============  //
+// 1. http://physicsoftheheart.com/ =======================  //
+// 2. https://github.com/michaelcolman ====================  //
+// ========================================================  //
+
+#ifndef S2_SWEEP_H
+#define S2_SWEEP_H
+
+#include "Structs.h"
+
+#define S2S_MAX_SITES   100
+
+// One S2 branch: site, coupling interval and outcome (conduction success type, lib/Tissue.cpp)
+typedef struct{
+	int         site;           // index into S2_sweep.site
+	int         CL;             // ms
+	int         type;           // 0 = no conduction, 1 = unidirectional block, 2 = full conduction
+	int         left, right;    // excitation at either end of the strand
+}S2_branch;
+
+// Per-thread branch state (copies of the tissue state, own spatial coupling differential)
+typedef struct{
+	State_variables     *State;
+	Model_variables     *Variables;
+	double              *Vm;
+	SC_variables        SC;         // shallow copy; diff is this slot's own
+}S2_slot;
+
+typedef struct{
+	bool        on;
+	bool        bisect;             // false = scan only
+	int         Nsites;
+	int         site[S2S_MAX_SITES];        // x locations
+	int         *S2_area[S2S_MAX_SITES];    // stimulus area of each site
+	int         CL_min, CL_max, CL_step, resolution;
+	int         window;             // ms simulated after the S2
+	int         Nconcurrent;        // branches run at once
+	int         Nthreads;           // threads per branch
+
+	// Snapshot (state just before the earliest S2)
+	int         snapshot_iteration;
+	double      snapshot_time;
+	State_variables     *State;
+	Model_variables     *Variables;
+	double              *Vm;
+
+	S2_slot     *slot;
+
+	// Evaluated branches
+	S2_branch   *branch;
+	int         Nbranches, capacity;
+}S2_sweep;
+
+void S2_sweep_init(S2_sweep *sw, Simulation_parameters *sim, Tissue_parameters tissue, SC_variables sc, const char *directory);
+bool S2_sweep_due(S2_sweep *sw, int iteration_counter);
+void S2_sweep_run(S2_sweep *sw, Simulation_parameters sim, Tissue_parameters tissue, SC_variables sc, Cell_parameters *Params, State_variables *State, Model_variables *Variables, double *Vm, double sim_time, const char *directory);
+void S2_sweep_free(S2_sweep *sw);
+
+#endif
@@ -0,0 +1,314 @@
+// Source code associated with  ===========================  //
+// "Multi-scale cardiac simulation framework" =============  //
+// For simulation of cardiac cellular and tissue dynamics =  //
+// from the spatial cellular to full organ scales. ========  //
+// With implementation of multiple, published cell models =  //
+// as well as novel models developed in my lab. ===========  //
+// ========================================================  //
+// This file: Forward sensitivities of ====================  //
+// biomarkers (native) ============ =======================  //
+// ========================================================  //
+// GNU 3 LICENSE TEXT =====================================  //
+// COPYRIGHT (C) 2016-2019 MICHAEL A. COLMAN ==============  //
+// THIS PROGRAM IS FREE SOFTWARE: YOU CAN REDISTRIBUTE IT =  //
+// AND/OR MODIFY IT UNDER THE TERMS OF THE GNU GENERAL ====  //
+// PUBLIC LICENSE AS PUBLISHED BY THE FREE SOFTWARE =======  //
+// FOUNDATION, EITHER VERSION 3 OF THE LICENSE, OR (AT YOUR  //
+// OPTION) ANY LATER VERSION. =============================  //
+// THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE=  //
+// USEFUL, BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE =====  //
+// IMPLIED WARRANTY OF MERCHANTABILITY OR FITNESS FOR A ===  //
+// PARTICULAR PURPOSE.  SEE THE GNU GENERAL PUBLIC LICENSE=  //
+// FOR MORE DETAILS. ======================================  //
+// YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL =====  //
+// PUBLIC LICENSE ALONG WITH THIS PROGRAM.  IF NOT, SEE ===  //
+// <https://www.gnu.org/licenses/>. =======================  //
+// ========================================================  //
+// ADDITIONAL LICENSE TEXT ================================  //
+// THIS SOFTWARE IS PROVIDED OPEN SOURCE AND MAY BE FREELY=  //
+// USED, DISTRIBUTED AND UPDATED, PROVIDED: ===============  //
+//  (i) THE APPROPRIATE WORK(S) IS(ARE) CITED. THIS =======  //
+//      PERTAINS TO THE CITATION OF COLMAN 2019 PLOS COMP =  //
+//      BIOL (FOR THIS IMPLEMTATION) AND ALL WORKS ========  //
+//      ASSOCIATED WITH THE SPECIFIC MODELS AND COMPONENTS=  //
+//      USED IN PARTICULAR SIMULATIONS. IT IS THE USER'S ==  //
+//      RESPONSIBILITY TO ENSURE ALL RELEVANT WORKS ARE ===  //
+//      CITED. PLEASE SEE FULL DOCUMENTATION AND ON-SCREEN=  //
+//      DISCLAIMER OUTPUTS FOR A GUIDE. ===================  //
+//  (ii) ALL OF THIS TEXT IS RETAINED WITHIN OR ASSOCIATED=  //
+//      WITH THE SOURCE CODE AND/OR BINARY FORM OF THE ====  //
+//      SOFTWARE. =========================================  //
+// ========================================================  //
+// ANY INTENDED COMMERCIAL USE OF THIS SOFTWARE MUST BE BY   //
+// EXPRESS PERMISSION OF MICHAEL A COLMAN ONLY. IN NO EVENT  //
+// ARE THE COPYRIGHT HOLDERS LIABLE FOR ANY DIRECT, =======  //
+// INDIRECT INCIDENTAL, SPECIAL, EXEMPLARY OR CONSEQUENTIAL  //
+// DAMAGES ASSOCIATED WITH USE OF THIS SOFTWARE ===========  //
+// ========================================================  //
+// THIS SOFTWARE CONTAINS IMPLEMENTATIONS OF MODELS AND ===  //
+// COMPONENTS WHICH I (MICHAEL COLMAN) DID NOT DEVELOP.====  //
+// ALL OF THESE COMPONENTS HAVE BEEN CODED FROM PROVIDED ==  //
+// SOURCE CODE OR INFORMATION IN THE PUBLICATIONS. ========  //
+// I CLAIM NO RIGHTS OR INTELLECTUAL PROPERTY OWNERSHIP ===  //
+// FOR THESE MODELS AND COMPONENTS, OTHER THAN THEIR ======  //
+// SPECIFIC IMPLEMENTATION IN THIS CODE PACKAGE. FURTHER TO  //
+// THE ABOVE STATEMENT, ANY INDTENDED COMMERCIAL USE OF ===  //
+// THOSE COMPONENTS MUST BE BY EXPRESS PERMISSION OF THE ==  //
+// ORIGINAL COPYRIGHT HOLDERS. ============================  //
+// WHERE IMPLEMENTED FROM PROVIDED CODE, ANY DISCLAIMERS ==  //
+// PRESENT IN THE ORIGINAL CODE HAVE BEEN RETAINED IN THE =  //
+// RELEVANT FILE. =========================================  //
+// ========================================================  //
+// Contact: m.a.colman@leeds.ac.uk ========================  //
+// For updates, corrections etc, please check: ============  //
+// 1. http://physicsoftheheart.com/ =======================  //
+// 2. https://github.com/michaelcolman ====================  //
+// ========================================================  //
+
+#include "Sensitivity.h"
+#include "Structs.h"
+#include "Model.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <math.h>
+
+// Function list ================================================================================\\|
+//	sensitivity_init()
+//	sensitivity_pre_step()
+//	sensitivity_post_step()
+//	sensitivity_finalise()
+// End Function list ============================================================================//|
+
+// Notes ========================================================================================\\|
+// Forward (tangent) sensitivities of the native single cell model with respect to conductance
+// scale factors of Cell_parameters, computed alongside the normal time loop, so that one run gives
+// d(biomarker)/d(ln G) for all chosen G instead of two perturbed runs per conductance.
+// The tangent S_k = d(state)/d(ln G_k) is propagated through each time step x' = F(x, p) as the
+// directional derivative 
+//      S_k' = [F(x + h S_k, p with G_k(1 + h)) - F(x, p)] / h
+// i.e. linearised about the unperturbed trajectory at every step (as forward-mode differentiation
+// would), so the perturbed trajectories never drift apart. F is the model step of the time loop 
+// (compute_model_native() + voltage update), which keeps every model supported without changes.
+// Biomarker sensitivities follow from the tangent at the measurement events of 
+// calculate_measurement_properties() (lib/Model.c): Vmax, Vmin and CaT extrema take the tangent of
+// the state at the step they are set; threshold crossings (excitation at -30 mV, APD at X %) use
+// the implicit function theorem, dt*/dG = (d threshold/dG - S_V)/(dV/dt), so APD sensitivities are
+// not limited by the time step as finite differences of separate runs are.
+// Sensitivities are of the final beat after the simulated beats from the initial state (like 
+// separate runs with perturbed conductances); for steady-state sensitivities start from steady 
+// state (Read_state/Periodic_orbit) and pace enough beats for the slow variables (Nai) to settle.
+// Outputs: Sensitivity.dat (final beat, per parameter) and Sensitivity_beats.dat (APD90 and 
+// CaT_max sensitivities per beat, to check convergence).
+// End Notes ====================================================================================//|
+
+typedef struct{
+	const char  *name;
+	size_t      offset;
+}Sen_parameter;
+
+static const Sen_parameter sen_parameters[] = {
+	{"GNa", offsetof(Cell_parameters, GNa)},        {"GNaL", offsetof(Cell_parameters, GNaL)},
+	{"Gto", offsetof(Cell_parameters, Gto)},        {"GCaL", offsetof(Cell_parameters, GCaL)},
+	{"GKur", offsetof(Cell_parameters, GKur)},      {"GKr", offsetof(Cell_parameters, GKr)},
+	{"GKs", offsetof(Cell_parameters, GKs)},        {"GK1", offsetof(Cell_parameters, GK1)},
+	{"GNCX", offsetof(Cell_parameters, GNCX)},      {"GCaP", offsetof(Cell_parameters, GCaP)},
+	{"GNab", offsetof(Cell_parameters, GNab)},      {"GCab", offsetof(Cell_parameters, GCab)},
+	{"GKb", offsetof(Cell_parameters, GKb)},        {"GNaK", offsetof(Cell_parameters, GNaK)},
+	{"GClCa", offsetof(Cell_parameters, GClCa)},    {"GClb", offsetof(Cell_parameters, GClb)},
+	{"GKACh", offsetof(Cell_parameters, GKACh)},    {"Gup", offsetof(Cell_parameters, Gup)},
+	{"Gleak", offsetof(Cell_parameters, Gleak)},    {"Grel", offsetof(Cell_parameters, Grel)}};
+static const int sen_Nparameters = sizeof(sen_parameters)/sizeof(Sen_parameter);
+static const int sen_APD_index[3] = {8, 4, 2};  // APD_p[] of SEN_APD90, SEN_APD50, SEN_APD30
+
+// Setup ========================================================================================\\|
+// After all parameters are set, immediately before the time loop
+void sensitivity_init(Sensitivity *sen, Simulation_parameters sim, Cell_parameters p, const char *directory)
+{
+	memset(sen, 0, sizeof(Sensitivity));
+	if (strcmp(sim.Sensitivity, "On") != 0) return;
+	if (strcmp(sim.Restitution, "Off") != 0)
+	{
+		printf("ERROR: Sensitivity and Restitution cannot be combined\n");
+		exit(1);
+	}
+
+	// Parameter list
+	char *list  = (char*)malloc(strlen(sim.Sensitivity_parameters) + 1);
+	strcpy(list, sim.Sensitivity_parameters);
+	for (char *token = strtok(list, ","); token != NULL; token = strtok(NULL, ","))
+	{
+		int i;
+		for (i = 0; i < sen_Nparameters; i++) if (strcmp(token, sen_parameters[i].name) == 0) break;
+		if (i == sen_Nparameters)
+		{
+			printf("ERROR: \"%s\" is not a Sensitivity parameter; options are:", token);
+			for (i = 0; i < sen_Nparameters; i++) printf(" %s", sen_parameters[i].name);
+			printf("\n");
+			exit(1);
+		}
+		if (sen->K == SEN_MAX_PARAMETERS)
+		{
+			printf("ERROR: at most %d Sensitivity parameters\n", SEN_MAX_PARAMETERS);
+			exit(1);
+		}
+		strcpy(sen->name[sen->K], token);
+		sen->offset[sen->K] = sen_parameters[i].offset;
+		sen->G[sen->K]      = *(double*)((char*)&p + sen_parameters[i].offset);
+		sen->K++;
+	}
+	free(list);
+	if (sen->K == 0)
+	{
+		printf("ERROR: no Sensitivity parameters given\n");
+		exit(1);
+	}
+
+	sen->on     = true;
+	sen->h      = sim.Sensitivity_step;
+	sen->dt     = sim.dt;
+	sen->n      = sizeof(State_variables)/sizeof(double);
+	sen->iVm    = offsetof(State_variables, Vm)/sizeof(double);
+	sen->iCai   = offsetof(State_variables, Cai)/sizeof(double);
+	sen->p      = (Cell_parameters*)malloc(sen->K*sizeof(Cell_parameters));
+	sen->S      = (double*)calloc(sen->K*sen->n, sizeof(double));
+	sen->x      = (double*)calloc(sen->K*sen->n, sizeof(double));
+	sen->d      = (double*)calloc(sen->K*SEN_NMEASURES, sizeof(double));
+	for (int k = 0; k < sen->K; k++)
+	{
+		sen->p[k] = p;
+		*(double*)((char*)&sen->p[k] + sen->offset[k]) *= (1 + sen->h);
+		if (sen->G[k] == 0) printf("WARNING: %s is 0 in this model; its sensitivities are 0\n", sen->name[k]);
+	}
+
+	char *filename = (char*)malloc(1000);
+	if (sim.Windows == true)    sprintf(filename, "%s\\Sensitivity_beats.dat", directory);
+	else                        sprintf(filename, "%s/Sensitivity_beats.dat", directory);
+	sen->log = fopen(filename, "wt");
+	free(filename);
+	fprintf(sen->log, "# beat | time of excitation (ms) | APD90 (ms) | dAPD90/dln(G) for");
+	for (int k = 0; k < sen->K; k++) fprintf(sen->log, " %s", sen->name[k]);
+	fprintf(sen->log, " | CaT_max (uM) | dCaT_max/dln(G) for the same\n");
+
+	printf("Forward sensitivities: %d parameters (", sen->K);
+	for (int k = 0; k < sen->K; k++) printf("%s%s", sen->name[k], (k < sen->K - 1) ? " " : ")\n");
+}
+// End Setup ====================================================================================//|
+
+// Time step ====================================================================================\\|
+// After compute_Istim(), before the model step: perturbed steps from x + h S_k
+void sensitivity_pre_step(Sensitivity *sen, Model_variables *var, State_variables *s)
+{
+	if (sen->on == false) return;
+	sen->s_pre      = *s;
+	sen->var_pre    = *var;
+
+	State_variables st;
+	Model_variables vt;
+	double *x0      = (double*)&sen->s_pre;
+	double *xt      = (double*)&st;
+	for (int k = 0; k < sen->K; k++)
+	{
+		double *S   = &sen->S[k*sen->n];
+		for (int i = 0; i < sen->n; i++) xt[i] = x0[i] + sen->h*S[i];
+		vt          = sen->var_pre;
+		compute_model_native(sen->p[k], &vt, &st, st.Vm, sen->dt);    // lib/Model.c
+		st.Vm       = st.Vm + sen->dt*(-(vt.Itot + vt.Istim + vt.Istim_S2));
+		memcpy(&sen->x[k*sen->n], xt, sen->n*sizeof(double));
+	}
+}
+
+// After the measurements (calculate_measurement_properties()), while Vm_prev is still V at t-dt
+void sensitivity_post_step(Sensitivity *sen, Model_variables *var, State_variables *s, double Vm_prev, double sim_time)
+{
+	if (sen->on == false) return;
+	double *x1      = (double*)s;
+	double dVdt     = (s->Vm - Vm_prev)/sen->dt;
+	bool excited    = (var->t_ex != sen->var_pre.t_ex);
+
+	// Completed beat to the log
+	if (excited == true && sen->beat > 0)
+	{
+		fprintf(sen->log, "%d %.2f %f", sen->beat, sen->var_pre.t_ex, var->APD_p_prev[8]);
+		for (int k = 0; k < sen->K; k++) fprintf(sen->log, " %f", sen->d[k*SEN_NMEASURES + SEN_APD90]);
+		fprintf(sen->log, " %f", 1e3*var->CaT_max_prev);
+		for (int k = 0; k < sen->K; k++) fprintf(sen->log, " %f", 1e3*sen->d[k*SEN_NMEASURES + SEN_CAT_MAX]);
+		fprintf(sen->log, "\n");
+	}
+	if (excited == true) sen->beat++;
+
+	for (int k = 0; k < sen->K; k++)
+	{
+		double *S       = &sen->S[k*sen->n];
+		double *x       = &sen->x[k*sen->n];
+		double *d       = &sen->d[k*SEN_NMEASURES];
+		double SV_prev  = S[sen->iVm];                  // tangent of V at t-dt
+		for (int i = 0; i < sen->n; i++) S[i] = (x[i] - x1[i])/sen->h;
+		double SV       = S[sen->iVm];
+
+		// Excitation: determine_excitation_state() tests V at t-dt against -30 mV
+		if (excited == true)
+		{
+			d[SEN_VMIN_PREV]    = d[SEN_VMIN];
+			d[SEN_TEX]          = (dVdt != 0) ? -SV_prev/dVdt : 0;
+		}
+		if (var->Vmax != sen->var_pre.Vmax && var->Vmax == s->Vm)      d[SEN_VMAX]     = SV;
+		if (var->Vmin != sen->var_pre.Vmin && var->Vmin == s->Vm)      d[SEN_VMIN]     = SV;
+		if (var->CaT_max != sen->var_pre.CaT_max && var->CaT_max == s->Cai) d[SEN_CAT_MAX] = S[sen->iCai];
+		if (var->CaT_min != sen->var_pre.CaT_min && var->CaT_min == s->Cai) d[SEN_CAT_MIN] = S[sen->iCai];
+
+		// APD at X %: V(t*) = Vmax - X(Vmax - Vmin_prev)
+		for (int j = 0; j < 3; j++)
+		{
+			int i = sen_APD_index[j];
+			if (sen->var_pre.APD_p_switch[i] == 0 && var->APD_p_switch[i] == 1 && dVdt != 0)
+			{
+				double perc     = 0.1*(i+1);
+				double dth      = (1 - perc)*d[SEN_VMAX] + perc*d[SEN_VMIN_PREV];
+				d[SEN_APD90 + j]= (dth - SV)/dVdt - d[SEN_TEX];
+			}
+		}
+	}
+}
+// End Time step ================================================================================//|
+
+// Outputs ======================================================================================\\|
+void sensitivity_finalise(Sensitivity *sen, Model_variables var, const char *directory)
+{
+	if (sen->on == false) return;
+	fclose(sen->log);
+
+	// Final beat, as Properties_log
+	const int Nb = 8;
+	const char *names[Nb]   = {"APD90", "APD50", "APD30", "RMP", "Vmax", "CaT_max", "CaT_min", "CaT_amp"};
+	double B[Nb]            = {var.APD_p[8], var.APD_p[4], var.APD_p[2], var.Vmin_prev, var.Vmax, 1e3*var.CaT_max, 1e3*var.CaT_min, 1e3*(var.CaT_max - var.CaT_min)};
+
+	char *filename = (char*)malloc(1000);
+	sprintf(filename, "%s/Sensitivity.dat", directory);
+	FILE *out = fopen(filename, "wt");
+	free(filename);
+	fprintf(out, "# Final beat sensitivities || 1: parameter | 2: value | then per biomarker: value, d(biomarker)/d(ln G) (per unit relative change of G), normalised (d ln biomarker/d ln G)\n#");
+	for (int b = 0; b < Nb; b++) fprintf(out, " %s(%d-%d)", names[b], 3 + 3*b, 5 + 3*b);
+	fprintf(out, "\n");
+
+	printf("Final beat sensitivities, d(biomarker)/d(ln G) ****\n\t%-8s %12s %12s %12s %12s\n", "", "APD90 (ms)", "RMP (mV)", "CaT_max (uM)", "CaT_amp (uM)");
+	for (int k = 0; k < sen->K; k++)
+	{
+		double *d       = &sen->d[k*SEN_NMEASURES];
+		double dB[Nb]   = {d[SEN_APD90], d[SEN_APD50], d[SEN_APD30], d[SEN_VMIN_PREV], d[SEN_VMAX], 1e3*d[SEN_CAT_MAX], 1e3*d[SEN_CAT_MIN], 1e3*(d[SEN_CAT_MAX] - d[SEN_CAT_MIN])};
+		fprintf(out, "%s %g", sen->name[k], sen->G[k]);
+		for (int b = 0; b < Nb; b++) fprintf(out, " %f %f %f", B[b], dB[b], (B[b] != 0) ? dB[b]/B[b] : 0.0);
+		fprintf(out, "\n");
+		printf("\t%-8s %12.4f %12.4f %12.4f %12.4f\n", sen->name[k], dB[0], dB[3], dB[5], dB[7]);
+	}
+	printf("\n");
+	fclose(out);
+
+	free(sen->p);
+	free(sen->S);
+	free(sen->x);
+	free(sen->d);
+	sen->on = false;
+}
+// End Outputs ==================================================================================//|
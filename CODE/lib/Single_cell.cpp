@@ -0,0 +1,358 @@
+// Source code associated with  ===========================  //
+// "Multi-scale cardiac simulation framework" =============  //
+// For simulation of cardiac cellular and tissue dynamics =  //
+// from the spatial cellular to full organ scales. ========  //
+// With implementation of multiple, published cell models =  //
+// as well as novel models developed in my lab. ===========  //
+// ========================================================  //
+// This file: Per-cell setup and time step ================  //
+// of the single cell models ==============================  //
+// ========================================================  //
+// GNU 3 LICENSE TEXT =====================================  //
+// COPYRIGHT (C) 2016-2019 MICHAEL A. COLMAN ==============  //
+// THIS PROGRAM IS FREE SOFTWARE: YOU CAN REDISTRIBUTE IT =  //
+// AND/OR MODIFY IT UNDER THE TERMS OF THE GNU GENERAL ====  //
+// PUBLIC LICENSE AS PUBLISHED BY THE FREE SOFTWARE =======  //
+// FOUNDATION, EITHER VERSION 3 OF THE LICENSE, OR (AT YOUR  //
+// OPTION) ANY LATER VERSION. =============================  //
+// THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE=  //
+// USEFUL, BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE =====  //
+// IMPLIED WARRANTY OF MERCHANTABILITY OR FITNESS FOR A ===  //
+// PARTICULAR PURPOSE.  SEE THE GNU GENERAL PUBLIC LICENSE=  //
+// FOR MORE DETAILS. ======================================  //
+// YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL =====  //
+// PUBLIC LICENSE ALONG WITH THIS PROGRAM.  IF NOT, SEE ===  //
+// <https://www.gnu.org/licenses/>. =======================  //
+// ========================================================  //
+// ADDITIONAL LICENSE TEXT ================================  //
+// THIS SOFTWARE IS PROVIDED OPEN SOURCE AND MAY BE FREELY=  //
+// USED, DISTRIBUTED AND UPDATED, PROVIDED: ===============  //
+//  (i) THE APPROPRIATE WORK(S) IS(ARE) CITED. THIS =======  //
+//      PERTAINS TO THE CITATION OF COLMAN 2019 PLOS COMP =  //
+//      BIOL (FOR THIS IMPLEMTATION) AND ALL WORKS ========  //
+//      ASSOCIATED WITH THE SPECIFIC MODELS AND COMPONENTS=  //
+//      USED IN PARTICULAR SIMULATIONS. IT IS THE USER'S ==  //
+//      RESPONSIBILITY TO ENSURE ALL RELEVANT WORKS ARE ===  //
+//      CITED. PLEASE SEE FULL DOCUMENTATION AND ON-SCREEN=  //
+//      DISCLAIMER OUTPUTS FOR A GUIDE. ===================  //
+//  (ii) ALL OF THIS TEXT IS RETAINED WITHIN OR ASSOCIATED=  //
+//      WITH THE SOURCE CODE AND/OR BINARY FORM OF THE ====  //
+//      SOFTWARE. =========================================  //
+// ========================================================  //
+// ANY INTENDED COMMERCIAL USE OF THIS SOFTWARE MUST BE BY   //
+// EXPRESS PERMISSION OF MICHAEL A COLMAN ONLY. IN NO EVENT  //
+// ARE THE COPYRIGHT HOLDERS LIABLE FOR ANY DIRECT, =======  //
+// INDIRECT INCIDENTAL, SPECIAL, EXEMPLARY OR CONSEQUENTIAL  //
+// DAMAGES ASSOCIATED WITH USE OF THIS SOFTWARE ===========  //
+// ========================================================  //
+// THIS SOFTWARE CONTAINS IMPLEMENTATIONS OF MODELS AND ===  //
+// COMPONENTS WHICH I (MICHAEL COLMAN) DID NOT DEVELOP.====  //
+// ALL OF THESE COMPONENTS HAVE BEEN CODED FROM PROVIDED ==  //
+// SOURCE CODE OR INFORMATION IN THE PUBLICATIONS. ========  //
+// I CLAIM NO RIGHTS OR INTELLECTUAL PROPERTY OWNERSHIP ===  //
+// FOR THESE MODELS AND COMPONENTS, OTHER THAN THEIR ======  //
+// SPECIFIC IMPLEMENTATION IN THIS CODE PACKAGE. FURTHER TO  //
+// THE ABOVE STATEMENT, ANY INDTENDED COMMERCIAL USE OF ===  //
+// THOSE COMPONENTS MUST BE BY EXPRESS PERMISSION OF THE ==  //
+// ORIGINAL COPYRIGHT HOLDERS. ============================  //
+// WHERE IMPLEMENTED FROM PROVIDED CODE, ANY DISCLAIMERS ==  //
+// PRESENT IN THE ORIGINAL CODE HAVE BEEN RETAINED IN THE =  //
+// RELEVANT FILE. =========================================  //
+// ========================================================  //
+// Contact: m.a.colman@leeds.ac.uk ========================  //
+// For updates, corrections etc, please check: ============  //
+// 1. http://physicsoftheheart.com/ =======================  //
+// 2. https://github.com/michaelcolman ====================  //
+// ========================================================  //
+
+#include "Single_cell.h"
+#include "Structs.h"
+#include "Initialisation.h"
+#include "Model.h"
+#include "CRU.h"
+#include "MersenneTwister.h"
+#include "Spontaneous_release_functions.h"
+#include "myofilament.hpp"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+// Function list ================================================================================\\|
+//	single_cell_parameters_native()
+//	single_cell_parameters_0D()
+//	single_cell_initial_conditions_0D()
+//	single_cell_step_native()
+//	single_cell_step_0D()
+// End Function list ============================================================================//|
+
+// Notes ========================================================================================\\|
+// Shared by Single_cell_native_main.cc, Single_cell_0D_main.cc and the ensemble runner (lib/Ensemble.cpp),
+// so an ensemble member is set up and stepped exactly as the equivalent separate run. The time loops
+// (outputs, steady state, early rejection) stay with the callers; each step is
+//      compute_Istim(); single_cell_step_X(); Vm = State.Vm;
+// End Notes ====================================================================================//|
+
+// Setup ========================================================================================\\|
+// Native Ca handling: model check, parameters, modification and stimulus
+void single_cell_parameters_native(Cell_parameters *p, Model_variables *var, Simulation_parameters *sim, Argument_parameters A)
+{
+	// Set model condition parameters from arguments | lib/Initialisation.c
+	// Sets Params.{Model, modulation(ISO,remodelling, mutation etc), model group} to defaults
+	// then overwrites with Argin values, if arguments have been passed 
+	set_model_conditions(p, A);
+
+	// Currently only sets human atrial flag to true if a human atrial model is set 
+	set_model_group_variables(p, A); // lib/Initialisation.c 
+
+	// Check Model is appropriate for this code version =\\|
+	// Add your new model clause here so it doesn't return an error
+	if      (strcmp(p->Model, "minimal") == 0);			// hybrid minimal model; Colman 2019
+	else if (strcmp(p->Model, "hAM_GB") == 0);			// human atrial cell; Grandi et al 2011 Circ Res 2011; 109(9):1055-66
+	else if (strcmp(p->Model, "hAM_CRN") == 0);			// human atrial cell; Courtemanche et al 1998 Am J Physiol 1998; 275(1 Pt 2):H301-21.
+	else if (strcmp(p->Model, "hAM_NG") == 0);			// human atrial cell; Nygren et al 1998 Circ Res 1998;82(1):63-81
+	else if (strcmp(p->Model, "hAM_MT") == 0);			// human atrial cell; Maleckar et al 2009  Am. J. Physiol Heart Circ Physiol 2009;297(4):H1398-410
+	else if (strcmp(p->Model, "hAM_WL_CRN") == 0);		// human atrial cell; Colman et al 2018 Front Physiol 9:1211; CRN Ca2+ handling
+	else if (strcmp(p->Model, "hAM_WL_GB") == 0);		// human atrial cell; Colman et al 2018 Front Physiol 9:1211; GB Ca2+ handling
+	else if (strcmp(p->Model, "hAM_GB_mWL") == 0);		// human atrial cell; Colman et al 2018 Front Physiol 9:1211; GB modified
+	else if (strcmp(p->Model, "hAM_CRN_mWL") == 0);		// human atrial cell; Colman et al 2018 Front Physiol 9:1211; CRN modified
+	else if (strcmp(p->Model, "hAM_NG_mWL") == 0);		// human atrial cell; Colman et al 2018 Front Physiol 9:1211; NG modified
+	else if (strcmp(p->Model, "dAM_VA") == 0);			// dog atrial cell; Varela et al 2016 PLOS Computational Biology 12(12): e1005245
+	else if (strcmp(p->Model, "hAM_GB_modded") == 0);	// human atrial cell; Grandi et al 2011 Circ Res 2011; 109(9):1055-66 MODDED
+	else if (strcmp(p->Model, "hVM_TT") == 0);	// human ventricle, TT
+	else
+	{
+		printf("ERROR: \"%s\" is not a valid Model selection for this code version\n", p->Model);
+		exit(1);
+	}
+	// End appropriate check ============================//|
+
+	// Set default parameters (constants etc); can be overwritten by model-specific later
+	set_default_parameters(p);				// lib/Initialisation.c
+
+	// Set model specific full parameters
+	p->dt = sim->dt; 	// Set before "set_params" called, which may explicitly set dt, for checking if dt has changed
+	set_parameters_native(p, p->Model);	// lib/Model.c and dependants (may set dt for model-specific)
+
+	// Set model condition params from arguments where passed; only for those which are set in set_parameters_native() to overwrite with argument value
+	if (A.Celltype_arg 	== true)	p->Celltype 	= A.Celltype; 
+	if (A.ISO_model_arg == true)	p->ISO_model 	= A.ISO_model; 
+	if (A.ACh_model_arg == true)    p->ACh_model    = A.ACh_model; 
+	if (A.Ihyp_arg      == true)   	p->AIhyp        = A.AIhyp;
+
+	// Set concentrations from arguments if specified
+	assign_concentrations_from_arguments(p, A);
+	if (A.Cai_IC_arg    == true)    p->Cai          = A.Cai_IC;
+	if (A.CaSR_IC_arg   == true)    p->CaSR         = A.CaSR_IC;
+
+	// Update Sim.dt if Params.dt has been explicitly set in "set_parameters" (thus Sim.dt != Params.dt), and dt has NOT been passed as a command-line argument.
+	if (A.dt_arg    	== false && p->dt != sim->dt) 	sim->dt = p->dt;
+
+	// Default modifiers || sets all scale factors to 1 and shifts to 0 so they can be multiplicatively applied by various modifications
+	set_modification_defaults_native(p);		// lib/Initialisation.c
+
+	// lib/Initialisation.c || sets the mod variables (Gx, x_shift/tau_scale etc) from arguments 
+	assign_modification_from_arguments(p, A);
+	
+	// lib/Model.c  -> lib/Model_X.cp; calls functions which set modification variables for het and modulation
+	// Updates the modifier variables (scales, shifts etc) using the defined settings for any/all het and modulation
+	set_heterogeneity_and_modulation_native(p);
+
+	// set expression scale by open rate scale, as both are equivilent in native models
+	p->GCaL *= p->GLTCC_kva1_va2;
+	p->Grel	*= p->GRyR_kCO;
+
+	// Initialise stimulus
+	stimulus_setup(*p, var, sim->dt, sim->BCL, sim->S2_CL, sim->Paced_time); // lib/Model.c
+}
+
+// Integrated (0D) Ca handling: model check, parameters, modification, cell size, stimulus and SRF
+void single_cell_parameters_0D(Cell_parameters *p, Model_variables *var, CRU_variables *CRU, Dyad_variables *Dyad, SR_fluxes *SR, Membrane_fluxes *MEM, 
+		Spontaneous_release_functions *SRF, Myofilament *myofil, Simulation_parameters *sim, Argument_parameters A)
+{
+	// Set model condition parameters from arguments | lib/Initialisation.c
+	set_model_conditions(p, A);
+	set_model_group_variables(p, A); // lib/Initialisation.c
+
+	// Check Model is appropriate for this code version =\\|
+	// Add your new model clause here so it doesn't return an error
+	if		(strcmp(p->Model, "minimal") == 0);
+	else if	(strcmp(p->Model, "hVM_ORD_s") == 0);
+	else if	(strcmp(p->Model, "hAM_CAZ_s") == 0);
+	else if	(strcmp(p->Model, "dAM_VA") == 0);
+	else if	(strcmp(p->Model, "mCRN") == 0);
+	else
+	{
+		printf("ERROR: \"%s\" is not a valid Model selection for this code version\n", p->Model);
+		exit(1);
+	}
+	// End appropriate check ============================//|
+
+	// Set cellsize and spontaneous release function defaults
+	spatial_cell_settings(CRU, A);                 // lib/CRU.cpp
+	set_SRF_defaults(SRF, A);						// lib/Spontaneous_release_functions.cpp
+
+	// Default modifiers || sets all scale factors to 1 and shifts to 0 so they can be multiplicatively applied by various modifications
+	set_modification_defaults_native(p);		// lib/Initialisation.c
+
+	// Set default parameters (constants etc); can be overwritten by model-specific later
+	set_default_parameters(p);                // lib/Initialisation.c
+
+	// Set model specific parameters
+	p->dt = sim->dt;     // Set before "set_params" called, which may explicitly set dt, for checking if dt has changed
+	set_parameters_native(p, p->Model);   // lib/Model.c and dependants (may set dt for model-specific)
+
+	// Set model condition params from arguments where passed; only for those which are set in set_parameters_native() to overwrite with argument value
+	if (A.Celltype_arg  == true)    p->Celltype     = A.Celltype;
+	if (A.ISO_model_arg == true)    p->ISO_model    = A.ISO_model;
+	if (A.ACh_model_arg == true)    p->ACh_model    = A.ACh_model;
+	if (A.Ihyp_arg      == true)    p->AIhyp        = A.AIhyp;
+
+	assign_concentrations_from_arguments(p, A);
+
+	// Update Sim.dt if Params.dt has been explicitly set in "set_parameters" (thus Sim.dt != Params.dt), and dt has NOT been passed as a command-line argument.
+	if (A.dt_arg    	== false && p->dt != sim->dt) 	sim->dt = p->dt;
+
+	myofil->LSODA_set(); 		// lib/myofilament.cpp
+	myofil->dt_myof = sim->dt; 	// dt for LSODA solver same as for whole model
+
+	// Now set the default and specific integrated Ca2+ handling parameters - overwrites similar parameters set in native
+	set_parameters_spatial_Ca_defaults(p);        // lib/Initialisation.c
+	set_parameters_spatial_Ca(p, p->Model);   // lib/Model.c and dependants
+	update_parameters_spatial_Ca_0D(p);			// lib/Initialisation.c
+
+	// Overwrite initial conditions of Cai and CaSR if argument passed
+	if (A.Cai_IC_arg	== true)	p->Cai			= A.Cai_IC;
+	if (A.CaSR_IC_arg	== true)	p->CaSR			= A.CaSR_IC;
+
+	// lib/Initialisation.c || sets the mod variables (Gx, x_shift/tau_scale etc) from arguments 
+	assign_modification_from_arguments(p, A);
+
+	// lib/Model.c -> lib/Model_X.cpp; calls functions which set modification variables for het and modulation
+	set_heterogeneity_and_modulation_native(p);
+	if (strcmp(p->Ca_cellular_het, "On") == 0) update_heterogeneity_and_modulation_integrated(p); // lib/Model.c 
+
+	// scale channel numbers by expression scale	
+	// (Grel and GCaL refer to expression i.e. NRyR/NLTCC)
+	p->NRyR_mean 	*= p->Grel;
+	p->NLTCC_mean 	*= p->GCaL;
+
+	// Membrane capacitance as a function of cell size
+	p->Cm           = p->Cm_CRU * CRU->NTOT_CRUs;
+
+	// Local variables from global parameters
+	// Remnant of 3D model; here just assigns Dyad, Mem and SR variables from Params
+	set_sub_cellular_local_scale(*p, Dyad, MEM, SR); // lib/CRU.cpp
+
+	// Initialise stimulus
+	stimulus_setup(*p, var, sim->dt, sim->BCL, sim->S2_CL, sim->Paced_time); // lib/Model.c
+
+	// Spontaneous release functions
+	SRF_setup(SRF, A); // lib/Spontaneous_release_functions.cpp -> calls appropriate set SRF parameters function 
+}
+
+// Integrated (0D) Ca handling: dyad (one CRU), initial conditions and measurement variables
+void single_cell_initial_conditions_0D(Cell_parameters p, State_variables *s, Model_variables *var, Ca_variables *Ca, Dyad_variables *Dyad, Membrane_fluxes *MEM)
+{
+	// Setup dyad params to global params as just one CRU (here is where dyad het set in 3D)
+	Dyad->vol_ds	= p.vds_CRU_mean;
+	Dyad->NRyR		= p.NRyR_mean;
+	Dyad->NLTCC		= p.NLTCC_mean;
+
+	// Set initial conditions of state variables || lib/Model.c -> lib/Model_X.cpp
+	initial_conditions_native(s, p, p.Model);
+
+	// Integrated calcium handling conditions (0D)
+	initial_conditions_calcium_0D(Ca, p);		// lib/CRU.cpp
+	initial_conditions_dyad_det(Dyad);			// lib/CRU.cpp
+
+	// Initialise measurement variables and flags
+	initialise_measurement_variables(var);		// lib/Initialisation.c
+	MEM->NCX_SRF_mult		= 1.0;
+	Dyad->Krel_SRF_mult		= 1.0;
+}
+// End Setup ====================================================================================//|
+
+// Time step ====================================================================================\\|
+// Native Ca handling
+void single_cell_step_native(Cell_parameters p, Model_variables *var, State_variables *s, double Vm, double sim_time, double dt)
+{
+	// Solve the model || lib/Model.c -> lib/Model_X.cpp
+	// This sets and updates all gates, and calculates Itot
+	compute_model_native(p, var, s, Vm, dt);
+
+	// Update Voltage
+	s->Vm	= s->Vm + dt*(-(var->Itot + var->Istim + var->Istim_S2));
+
+	// Excitation state and measurements | lib/Model.c  | "s->Vm" is voltage at t, "Vm" is voltage at t-dt
+	determine_excitation_state(var, Vm, sim_time);
+	calculate_measurement_properties(var, Vm, s->Vm, sim_time, dt, -70, s->Cai, s->CanSR); // -70 is APD V threshold
+}
+
+// Integrated (0D) Ca handling
+void single_cell_step_0D(Cell_parameters p, Model_variables *var, State_variables *s, Ca_variables *Ca, CRU_variables *CRU, Dyad_variables *Dyad, SR_fluxes *SR, 
+		Membrane_fluxes *MEM, RAND *Rand, Spontaneous_release_functions *SRF, Myofilament *myofil, double Vm, double sim_time, double dt)
+{
+	// Assign Ca state variables (seen by ionic model) from integrated whole-cell ave variables
+	s->Cai		= 1e-3*Ca->CYTO;		// Ca dependent currents, Cai (in mM not uM)
+	s->CanSR	= 1e-3*Ca->NSR;		// Ca dependent currents, Cansr (in mM not uM)
+	s->CajSR	= 1e-3*Ca->JSR;		// Ca dependent currents, Cajsr (in mM not uM)
+
+	// Excitation state (necessary for SRF) | lib/Model.c 
+	determine_excitation_state_integrated_0D(var, Vm, sim_time, &Dyad->Ca_JSR_t_ex, Ca->JSR, &Dyad->SRF_prop_active,  SRF->SRF_prop_active, &SRF->waveform_init, &SRF->srf_set, SRF->Mode_id);
+	Dyad->ex_switch	= var->ex_switch;
+
+	// Spontaneous release functions || lib/Spontaneous_release_functions.cpp
+	set_and_run_SRF(SRF, Dyad, SRF->Mode_id, Rand, var->ex_switch, sim_time, Ca->JSR);
+	calc_SRF_mults(SRF, MEM, Dyad);
+
+	// Zero reaction terms so they can be sequentially modified
+	Ca->SS_reac = Ca->CYTO_reac = Ca->NSR_reac = Ca->JSR_reac = 0;
+
+	// Inter-compartment transfer || lib/CRU.cpp
+	comp_J_ds_ss(p, Ca->DS, Ca->SS, Dyad->vol_ds, &Ca->SS_reac);
+	comp_J_ss_cyto(p, Ca->SS, Ca->CYTO, &Ca->SS_reac, &Ca->CYTO_reac);	
+	comp_J_nsr_jsr(p, Ca->NSR, Ca->JSR, &Ca->NSR_reac, &Ca->JSR_reac);	
+
+	// Comp dyad || lib/CRU.cpp -> computes and solves JCaL, Jrel and Cads/jsr fluxes
+	comp_dyad_0D(p, Dyad, Ca->DS, Ca->JSR, Ca->SS /*to which ds is coupled*/, &Ca->JSR_reac, Vm, dt, p.Model_id);
+
+	// Buffering || lib/CRU.cpp
+	comp_buffering(p, &Ca->Bcyto, &Ca->Bss, &Ca->Bjsr, Ca->CYTO, Ca->SS, Ca->JSR);
+
+	// Comp SR fluxes || Jup, Jleak (SERCA) || lib/CRU.cpp
+	comp_SR_fluxes(p, SR, Ca->CYTO, Ca->NSR, &Ca->CYTO_reac, &Ca->NSR_reac);
+
+	// Comp Membrane fluxes || JNCX, JCaP, JCab || lib/CRU.cpp
+	comp_membrane_fluxes(p, MEM, *s, Ca->CYTO, Ca->SS, &Ca->CYTO_reac, &Ca->SS_reac, Vm, MEM->NCX_SRF_mult);
+
+	// trpn || lib/myofilament.cpp || this is general needs to be looked at
+	myofil->run_step_myofilament(1e-3*Ca->CYTO, 8, 0.015);
+	Ca->CYTO_reac += -myofil->Jtrpn;
+
+	// Update concentrations
+	Ca->DS   	= (Ca->SS + p.tau_ds*(Dyad->K_rel*Ca->JSR + Dyad->J_CaL))/(1 + p.tau_ds*Dyad->K_rel); // quasi-steady-state approx
+	Ca->SS 		= Ca->SS 		+ Ca->Bss		* 	dt*(Ca->SS_reac);	
+	Ca->CYTO 	= Ca->CYTO 		+ Ca->Bcyto 	*	dt*(Ca->CYTO_reac);
+	Ca->NSR 	= Ca->NSR 		+ 					dt*(Ca->NSR_reac);	
+	Ca->JSR 	= Ca->JSR		+ Ca->Bjsr		*	dt*(Ca->JSR_reac);
+
+	// Whole-cell averages || including computing currents from Ca fluxes
+	calc_whole_cell_values_including_currents_from_flux_0D(p, *Ca, CRU, *Dyad, *SR, *MEM, CRU->NTOT_CRUs);	// lib/CRU.cpp
+
+	// Assign currents for use in AP model
+	var->ICaL 	= CRU->I_CAL;
+	var->INCX	= CRU->I_NCX_bulk + CRU->I_NCX_ss;
+	var->ICaP	= CRU->I_CaP_bulk + CRU->I_CaP_ss;
+	var->ICab	= CRU->I_Cab_bulk + CRU->I_Cab_ss;
+
+	// Solve the AP model || lib/Model.c -> lib/Model_X.cpp
+	// This sets and updates all gates, and calculates Itot
+	compute_model_integrated(p, var, s, Vm, dt);
+
+	// Update Voltage
+	s->Vm	= s->Vm + dt*(-(var->Itot + var->Istim + var->Istim_S2));
+
+	// measurement properties | lib/Model.c  | "s->Vm" is voltage at t, "Vm" is voltage at t-dt
+	calculate_measurement_properties(var, Vm, s->Vm, sim_time, dt, -70, s->Cai, s->CanSR);		// -70 is APD V threshold
+}
+// End Time step ================================================================================//|
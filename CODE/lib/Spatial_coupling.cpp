@@ -71,19 +71,31 @@
 
 #include "Spatial_coupling.h"
 #include "Structs.h"
+#include "Binary_inputs.h"
 #include <fstream>
 #include <stdlib.h>
 #include <string.h>
+#include <stdio.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
 
 // Function list ================================================================================\\|
 //	Array allocation
 //	    SC_set_array_sizes()
 //	    SC_array_allocation_N3()
+//	    SC_brick_reserve()
+//	    SC_brick_allocate()
+//	    SC_set_geo()
+//	    SC_set_geo_index()
 //	    SC_array_allocation_Ncell()
 //	    SC_array_deallocation()
+//	    SC_release_setup_arrays()
+//	    SC_memory_report()
 //	
 //	Read geometry/maps
 //	    read_geo_file()
+//	    geometry_vtk_output()
 //	    read_map_file()
 //	    read_map_file_double()
 //	
@@ -116,16 +128,72 @@ void SC_set_array_sizes(SC_variables *sc, int NX, int NY, int NZ)
 }
 // End set array sizes ============================================//|
 
-// Arrays of size NX*NY*NZ ========================================\\|
+// Geometry of size NX*NY*NZ (bricked) ============================\\|
+// Only the brick table is the size of the box (/512); bricks are allocated when tissue is set in them
 void SC_array_allocation_N3(SC_variables *sc, int NX, int NY, int NZ)
 {
-	int N = NX * NY * NZ;
+	sc->BX              = (NX + SC_BRICK - 1)/SC_BRICK;
+	sc->BY              = (NY + SC_BRICK - 1)/SC_BRICK;
+	sc->BZ              = (NZ + SC_BRICK - 1)/SC_BRICK;
+	sc->brick           = new int[sc->BX*sc->BY*sc->BZ];
+	for (int b = 0; b < sc->BX*sc->BY*sc->BZ; b++) sc->brick[b] = -1;
+
+	sc->Nbricks         = 0;
+	sc->brick_capacity  = 0;
+	sc->brick_geo       = NULL;
+	sc->brick_index     = NULL;
+}
+
+// Storage for at least Nbricks bricks
+void SC_brick_reserve(SC_variables *sc, int Nbricks)
+{
+	if (Nbricks <= sc->brick_capacity) return;
+	sc->brick_geo       = (int*)realloc(sc->brick_geo, (size_t)Nbricks*SC_BRICK_VOLUME*sizeof(int));
+	sc->brick_index     = (int*)realloc(sc->brick_index, (size_t)Nbricks*SC_BRICK_VOLUME*sizeof(int));
+	if (sc->brick_geo == NULL || sc->brick_index == NULL)
+	{
+		printf("ERROR: cannot allocate geometry storage for %d bricks\n", Nbricks);
+		exit(1);
+	}
+	sc->brick_capacity  = Nbricks;
+}
 
-	// Geometry arrays
-	sc->geo			= new int[N];
-	sc->geo_index	= new int[N];
+// Storage slot of brick b (allocated, empty, if not yet present) || not thread safe
+int SC_brick_allocate(SC_variables *sc, int b)
+{
+	if (sc->brick[b] >= 0) return sc->brick[b];
+	if (sc->Nbricks == sc->brick_capacity) SC_brick_reserve(sc, sc->brick_capacity < 64 ? 64 : 2*sc->brick_capacity);
+	int slot = sc->Nbricks++;
+	for (int v = 0; v < SC_BRICK_VOLUME; v++)
+	{
+		sc->brick_geo[slot*SC_BRICK_VOLUME + v]     = 0;
+		sc->brick_index[slot*SC_BRICK_VOLUME + v]   = -1;
+	}
+	sc->brick[b] = slot;
+	return slot;
+}
+
+// Set celltype at 3D index idx (empty space in an unallocated brick needs no storage) || replaces geo[idx] = 
+void SC_set_geo(SC_variables *sc, int idx, int celltype)
+{
+	int slot, offset = SC_brick_offset(sc, idx, &slot);
+	if (slot < 0)
+	{
+		if (celltype <= 0) return;
+		int i = idx % sc->NX;
+		int j = (idx / sc->NX) % sc->NY;
+		int k = idx / (sc->NX*sc->NY);
+		slot = SC_brick_allocate(sc, (i/SC_BRICK) + sc->BX*((j/SC_BRICK) + sc->BY*(k/SC_BRICK)));
+	}
+	sc->brick_geo[slot*SC_BRICK_VOLUME + offset] = celltype;
 }
-// End arrays of size NX*NY*NZ ====================================//|
+
+void SC_set_geo_index(SC_variables *sc, int idx, int n)
+{
+	int slot, offset = SC_brick_offset(sc, idx, &slot);
+	if (slot >= 0) sc->brick_index[slot*SC_BRICK_VOLUME + offset] = n;
+}
+// End geometry of size NX*NY*NZ ==================================//|
 
 // Arrays of size Ncell ===========================================\\|
 void SC_array_allocation_Ncell(SC_variables *sc, int N)
@@ -263,9 +331,10 @@ void SC_array_allocation_Ncell(SC_variables *sc, int N)
 // Deallocate all arrays ==========================================\\|
 void SC_array_deallocation(SC_variables *sc)
 {
-    // Geometry arrays, NX*NY*NZ
-    delete []	sc->geo;
-    delete []	sc->geo_index;
+    // Geometry, bricked
+    delete []	sc->brick;
+    free(sc->brick_geo);
+    free(sc->brick_index);
 
     // Geometry, Ncell
     delete [] 	sc->geo_linear;
@@ -394,6 +463,115 @@ void SC_array_deallocation(SC_variables *sc)
 }
 // End deallocate all arrays ======================================//|
 
+// Release setup-only arrays ======================================\\|
+// Once the spatial operator is assembled (and cached) and all outputs are initialised, only the
+// arrays used by the run operator remain in use:
+//  "FDM"       (calc_diff_FDM_anisotropic)     D tensor and its derivatives
+//  "laplacian" (calc_diff_from_lap)            laplacian weights
+//  "network"   (calc_IGap)                     junction arrays
+// Face and edge neighbours (Beat_maps, FDM/laplacian), the linear geometry and the bricked celltypes
+// (vtk outputs) are kept. Released pointers are set to NULL, so SC_array_deallocation is unchanged.
+// Returns bytes released
+static void sc_release_double(double **a, int N, double *bytes)
+{
+	if (*a == NULL) return;
+	delete [] *a;
+	*a      = NULL;
+	*bytes  += (double)N*sizeof(double);
+}
+
+static void sc_release_int(int **a, int N, double *bytes)
+{
+	if (*a == NULL) return;
+	delete [] *a;
+	*a      = NULL;
+	*bytes  += (double)N*sizeof(int);
+}
+
+double SC_release_setup_arrays(SC_variables *sc, const char *run_operator)
+{
+	double bytes 	= 0;
+	int N 			= sc->N;
+	bool FDM 		= (strcmp(run_operator, "FDM") == 0);
+	bool laplacian 	= (strcmp(run_operator, "laplacian") == 0);
+	bool network 	= (strcmp(run_operator, "network") == 0);
+
+	// Scalar D and orientation (assembled into the D tensor)
+	sc_release_double(&sc->D, N, &bytes);
+	sc_release_double(&sc->D1, N, &bytes);
+	sc_release_double(&sc->D2, N, &bytes);
+	double **orientation[] = {&sc->ox, &sc->oy, &sc->oz, &sc->ox2, &sc->oy2, &sc->oz2, &sc->ox3, &sc->oy3, &sc->oz3};
+	for (int i = 0; i < 9; i++) sc_release_double(orientation[i], N, &bytes);
+
+	// Corner neighbours (not part of any run operator) and the 3D -> 1D index
+	int **corner[] = {&sc->xm_ym_zm, &sc->xm_ym_zp, &sc->xm_yp_zm, &sc->xm_yp_zp, &sc->xp_ym_zm, &sc->xp_ym_zp, &sc->xp_yp_zm, &sc->xp_yp_zp};
+	for (int i = 0; i < 8; i++) sc_release_int(corner[i], N, &bytes);
+	if (sc->brick_index != NULL)
+	{
+		bytes += (double)sc->brick_capacity*SC_BRICK_VOLUME*sizeof(int);
+		free(sc->brick_index);
+		sc->brick_index = NULL;
+	}
+
+	// Network node conductances and connection types (assembled into the junction arrays)
+	double **G[] = {&sc->Gl, &sc->Gt, &sc->Gt2, &sc->gGap_node_xx, &sc->gGap_node_yy, &sc->gGap_node_zz, &sc->gGap_node_xypp, &sc->gGap_node_xypm, 
+		&sc->gGap_node_xzpp, &sc->gGap_node_xzpm, &sc->gGap_node_yzpp, &sc->gGap_node_yzpm, &sc->gGap_node_xyzppp, &sc->gGap_node_xyzppm, &sc->gGap_node_xyzpmp, &sc->gGap_node_xyzmpp};
+	for (int i = 0; i < 16; i++) sc_release_double(G[i], N, &bytes);
+	int **connection[] = {&sc->connection_type_node_xx, &sc->connection_type_node_yy, &sc->connection_type_node_zz, &sc->connection_type_node_xypp, &sc->connection_type_node_xypm,
+		&sc->connection_type_node_xzpp, &sc->connection_type_node_xzpm, &sc->connection_type_node_yzpp, &sc->connection_type_node_yzpm, 
+		&sc->connection_type_node_xyzppp, &sc->connection_type_node_xyzppm, &sc->connection_type_node_xyzpmp, &sc->connection_type_node_xyzmpp};
+	for (int i = 0; i < 13; i++) sc_release_int(connection[i], N, &bytes);
+
+	// D tensor and its derivatives (FDM operator only)
+	if (FDM == false)
+	{
+		double **D[] = {&sc->Dxx, &sc->Dyy, &sc->Dzz, &sc->Dxy, &sc->Dxz, &sc->Dyz, &sc->dDxx_dx, &sc->dDxy_dx, &sc->dDxz_dx, 
+			&sc->dDyy_dy, &sc->dDxy_dy, &sc->dDyz_dy, &sc->dDzz_dz, &sc->dDxz_dz, &sc->dDyz_dz};
+		for (int i = 0; i < 15; i++) sc_release_double(D[i], N, &bytes);
+	}
+
+	// Laplacian weights (laplacian operator only)
+	if (laplacian == false)
+	{
+		double **lap[] = {&sc->lap_self, &sc->lap_xm, &sc->lap_xp, &sc->lap_ym, &sc->lap_yp, &sc->lap_zm, &sc->lap_zp, &sc->lap_xm_ym, &sc->lap_xm_yp, &sc->lap_xp_ym,
+			&sc->lap_xp_yp, &sc->lap_xm_zm, &sc->lap_xm_zp, &sc->lap_xp_zm, &sc->lap_xp_zp, &sc->lap_ym_zm, &sc->lap_ym_zp, &sc->lap_yp_zm, &sc->lap_yp_zp};
+		for (int i = 0; i < 19; i++) sc_release_double(lap[i], N, &bytes);
+	}
+
+	// Edge neighbours and junction scaling maps (network: the junction maps hold the connectivity)
+	if (network == true)
+	{
+		int **edge[] = {&sc->xp_yp, &sc->xp_ym, &sc->xp_zp, &sc->xp_zm, &sc->xm_yp, &sc->xm_ym, &sc->xm_zp, &sc->xm_zm, &sc->yp_zp, &sc->yp_zm, &sc->ym_zp, &sc->ym_zm};
+		for (int i = 0; i < 12; i++) sc_release_int(edge[i], N, &bytes);
+		sc_release_double(&sc->gGgap_mod_map, sc->Njunc, &bytes);
+		sc_release_double(&sc->gGgap_base_map, sc->Njunc, &bytes);
+	}
+	return bytes;
+}
+
+// Process memory at peak (setup) and now (run) || Linux only (/proc); released array memory always
+void SC_memory_report(double released_bytes)
+{
+	printf(">Setup-only arrays released: %.1f MB\n", released_bytes/1048576.0);
+#ifdef __GLIBC__
+	malloc_trim(0);     // return the released pages to the system
+#endif
+#ifdef __linux__
+	FILE *in = fopen("/proc/self/status", "r");
+	if (in == NULL) return;
+	char line[256];
+	long peak_kB = -1, now_kB = -1;
+	while (fgets(line, sizeof(line), in) != NULL)
+	{
+		if (strncmp(line, "VmHWM:", 6) == 0) sscanf(line + 6, "%ld", &peak_kB);
+		if (strncmp(line, "VmRSS:", 6) == 0) sscanf(line + 6, "%ld", &now_kB);
+	}
+	fclose(in);
+	if (peak_kB >= 0 && now_kB >= 0) printf(">Memory: peak (setup) %.1f MB || steady state (run) %.1f MB\n", peak_kB/1024.0, now_kB/1024.0);
+#endif
+}
+// End release setup-only arrays ==================================//|
+
 // NETWORK
 void SC_array_allocation_Njunc(SC_variables *sc, int N)
 {
@@ -419,7 +597,7 @@ void SC_array_deallocation_Njunc(SC_variables *sc)
 // End Allocate and deallocate spatial arrays ===================================================//|
 
 // Read geometry/maps from file into arrays =====================================================\\|
-int read_geo_file(SC_variables *sc, int *geo, const char *filein, const char * fileroot, const char *PATH, const char* Output_dir, const char * ref, int Ncelltypes)
+int read_geo_file(SC_variables *sc, const char *filein, const char * fileroot, const char *PATH, const char* Output_dir, const char * ref, int Ncelltypes, bool diagnostics)
 {
     FILE *in;
     char *string = (char*)malloc(500);
@@ -427,40 +605,58 @@ int read_geo_file(SC_variables *sc, int *geo, const char *filein, const char * f
     // Assign filename to string
     sprintf(string, "%s/%s/%s", PATH, fileroot, filein);
 
-    // Read in file
-    in = fopen(string, "r");
-
-    if (in == NULL)
+    int idx, cell_count;
+    if (binary_input_check(string) == true) // binary geometry (convert_inputs) || lib/Binary_inputs.cpp
     {
-        printf("Cannot load geometry file %s\t :: is the path correct? Does the file exist in that path?\n", string);
-        exit(1);
+        cell_count = binary_input_read_geo(string, sc);
+        printf("Binary geometry file %s read || Ncells = %d\n", filein, cell_count);
     }
-    else printf("File loaded %s\n", string);
+    else
+    {
+        // Read in file
+        in = fopen(string, "r");
 
-    int temp; // temporary int for reading from file
-    int idx, cell_count;
-    cell_count = 0;
+        if (in == NULL)
+        {
+            printf("Cannot load geometry file %s\t :: is the path correct? Does the file exist in that path?\n", string);
+            exit(1);
+        }
+        else printf("File loaded %s\n", string);
 
-    for (int k = 0; k < sc->NZ; k++)
-    {
-        for (int j = 0; j < sc->NY; j++)
+        int temp; // temporary int for reading from file
+        cell_count = 0;
+
+        for (int k = 0; k < sc->NZ; k++)
         {
-            for (int i = 0; i < sc->NX; i++)
-            {	
-                idx = i + (sc->NX*j) + (sc->NX * sc->NY * k);
-                geo[idx] = 0;
-                fscanf(in, "%d ", &temp);
-                geo[idx] = temp;
-                if (geo[idx] > 0) cell_count++; // how many real cells
+            for (int j = 0; j < sc->NY; j++)
+            {
+                for (int i = 0; i < sc->NX; i++)
+                {	
+                    idx = i + (sc->NX*j) + (sc->NX * sc->NY * k);
+                    fscanf(in, "%d ", &temp);
+                    SC_set_geo(sc, idx, temp);
+                    if (temp > 0) cell_count++; // how many real cells
+                }
             }
         }
-    }
 
-    printf("Geometry file %s read || Ncells = %d\n", filein, cell_count);
+        printf("Geometry file %s read || Ncells = %d\n", filein, cell_count);
 
-    fclose(in);
+        fclose(in);
+    }
 
     // Write vtk of geoemtry to Outputs directory
+    geometry_vtk_output(sc, Output_dir, ref, Ncelltypes, diagnostics);
+
+	return cell_count;
+}
+
+// Writes Geometry_<ref>.vtk (and Geometry_<ref>_celltype_XX.vtk with Setup_diagnostics On) from the geometry in sc
+// (read from file, or loaded from the tissue cache)
+void geometry_vtk_output(SC_variables *sc, const char* Output_dir, const char * ref, int Ncelltypes, bool diagnostics)
+{
+    char *string = (char*)malloc(500);
+    int idx;
     sprintf(string, "%s/Geometry_%s.vtk", Output_dir, ref);
 
     FILE *out;
@@ -484,7 +680,7 @@ int read_geo_file(SC_variables *sc, int *geo, const char *filein, const char * f
             for (int i = 0; i < sc->NX; i++)
             {
 				idx = i + (sc->NX*j) + (sc->NX*sc->NY*k);
-				fprintf(out, "%d ", geo[idx]); 
+				fprintf(out, "%d ", SC_geo(sc, idx)); 
 			}
 			fprintf(out, "\n");
 		}
@@ -492,9 +688,9 @@ int read_geo_file(SC_variables *sc, int *geo, const char *filein, const char * f
 	}
 	fclose(out);
 
-    // Now, write geo file for each celltype individually
+    // Now, write geo file for each celltype individually (Setup_diagnostics On only)
     // Write vtk of geoemtry to Outputs directory
-    for (int ncell = 1; ncell < Ncelltypes+1; ncell++) // from 1 to N, not 0 to N-1
+    if (diagnostics == true) for (int ncell = 1; ncell < Ncelltypes+1; ncell++) // from 1 to N, not 0 to N-1
     {
         sprintf(string, "%s/Geometry_%s_celltype_%02d.vtk", Output_dir, ref, ncell);
 
@@ -519,7 +715,7 @@ int read_geo_file(SC_variables *sc, int *geo, const char *filein, const char * f
                 for (int i = 0; i < sc->NX; i++)
                 {
                     idx = i + (sc->NX*j) + (sc->NX*sc->NY*k);
-                    if (geo[idx] == ncell) fprintf(out, "%d ", geo[idx]);
+                    if (SC_geo(sc, idx) == ncell) fprintf(out, "%d ", ncell);
                     else fprintf(out, "0 ");
                 }
                 fprintf(out, "\n");
@@ -529,7 +725,7 @@ int read_geo_file(SC_variables *sc, int *geo, const char *filein, const char * f
         fclose(out);
     }
 
-	return cell_count;
+    free(string);
 }
 
 // The difference here is that the array being read into is already size N  (not X*Y*Z - which the file input is)
@@ -542,42 +738,52 @@ int read_map_file(SC_variables sc, int *map, const char *filein, const char * fi
 	// Assign filename to string
 	sprintf(string, "%s/%s/%s", PATH, fileroot, filein);
 
-	in = fopen(string, "r");
-
-	if (in == NULL)
+	int idx, cell_count, map_count;
+	map_count = 0;
+	if (binary_input_check(string) == true) // binary map (convert_inputs; box or cell indexed) || lib/Binary_inputs.cpp
 	{
-		printf("Cannot load geometry map file %s\t :: is the path correct? Does the file exist in that path?\n", string);
-		exit(1);
+		binary_input_read_cells_int(string, sc, map);
+		cell_count = sc.N;
+		for (int n = 0; n < sc.N; n++) if (map[n] > 0) map_count++;
+		printf("Binary map file %s read || Nmap = %d\n", filein, map_count);
 	}
-	else printf("File loaded %s\n", string);
+	else
+	{
+		in = fopen(string, "r");
 
-	int temp; // temporary int for reading from file
-	int idx, cell_count, map_count;
-	cell_count = 0;
-	map_count = 0;
+		if (in == NULL)
+		{
+			printf("Cannot load geometry map file %s\t :: is the path correct? Does the file exist in that path?\n", string);
+			exit(1);
+		}
+		else printf("File loaded %s\n", string);
 
-	for (int k = 0; k < sc.NZ; k++)
-	{
-		for (int j = 0; j < sc.NY; j++)
+		int temp; // temporary int for reading from file
+		cell_count = 0;
+
+		for (int k = 0; k < sc.NZ; k++)
 		{
-			for (int i = 0; i < sc.NX; i++)
+			for (int j = 0; j < sc.NY; j++)
 			{
-				idx = i + (sc.NX*j) + (sc.NX * sc.NY * k);
-				fscanf(in, "%d ", &temp);			
-
-				if (sc.geo[idx] > 0)
+				for (int i = 0; i < sc.NX; i++)
 				{
-					map[cell_count] = temp; 	// reading into 1D array of size N
-					if (map[cell_count] > 0) map_count++;
-					cell_count++;
+					idx = i + (sc.NX*j) + (sc.NX * sc.NY * k);
+					fscanf(in, "%d ", &temp);			
+
+					if (SC_geo(&sc, idx) > 0)
+					{
+						map[cell_count] = temp; 	// reading into 1D array of size N
+						if (map[cell_count] > 0) map_count++;
+						cell_count++;
+					}
 				}
 			}
 		}
-	}
 
-	printf("Map file %s read || Nmap = %d, recheck of Ncells = %d\n", filein, map_count, cell_count);
+		printf("Map file %s read || Nmap = %d, recheck of Ncells = %d\n", filein, map_count, cell_count);
 
-	fclose(in);
+		fclose(in);
+	}
 
 	// Write map vtk to Outputs, with map type in filename (this is "ref" here)
 	sprintf(string,"%s/Map_%s.vtk", Output_dir, ref);
@@ -607,7 +813,7 @@ int read_map_file(SC_variables sc, int *map, const char *filein, const char * fi
 			for (int i = 0; i < sc.NX; i++)
 			{
 				idx = i + (sc.NX*j) + (sc.NX*sc.NY*k);
-				if (sc.geo[idx] > 0)
+				if (SC_geo(&sc, idx) > 0)
 				{
 					fprintf(out, "%d ", map[cell_count]);
 					cell_count++;
@@ -632,42 +838,52 @@ int read_map_file_double(SC_variables sc, double *map, const char *filein, const
 	// Assign filename to string
 	sprintf(string, "%s/%s/%s", PATH, fileroot, filein);
 
-	in = fopen(string, "r");
-
-	if (in == NULL)
+	int idx, cell_count, map_count;
+	map_count = 0;
+	if (binary_input_check(string) == true) // binary map (convert_inputs; box or cell indexed) || lib/Binary_inputs.cpp
 	{
-		printf("Cannot load geometry map file %s\t :: is the path correct? Does the file exist in that path?\n", string);
-		exit(1);
+		binary_input_read_cells_double(string, sc, &map, 1);
+		cell_count = sc.N;
+		for (int n = 0; n < sc.N; n++) if (map[n] >= 0.0) map_count++;
+		printf("Binary map file %s read || Nmap = %d\n", filein, map_count);
 	}
-	else printf("File loaded %s\n", string);
+	else
+	{
+		in = fopen(string, "r");
 
-	double temp; // temporary int for reading from file
-	int idx, cell_count, map_count;
-	cell_count = 0;
-	map_count = 0;
+		if (in == NULL)
+		{
+			printf("Cannot load geometry map file %s\t :: is the path correct? Does the file exist in that path?\n", string);
+			exit(1);
+		}
+		else printf("File loaded %s\n", string);
 
-	for (int k = 0; k < sc.NZ; k++)
-	{
-		for (int j = 0; j < sc.NY; j++)
+		double temp; // temporary int for reading from file
+		cell_count = 0;
+
+		for (int k = 0; k < sc.NZ; k++)
 		{
-			for (int i = 0; i < sc.NX; i++)
+			for (int j = 0; j < sc.NY; j++)
 			{
-				idx = i + (sc.NX*j) + (sc.NX * sc.NY * k);
-				fscanf(in, "%lf ", &temp);
-
-				if (sc.geo[idx] > 0)
+				for (int i = 0; i < sc.NX; i++)
 				{
-					map[cell_count] = temp;		// reading into 1D array of size N
-					if (map[cell_count] >= 0.0) map_count++;
-					cell_count++;
+					idx = i + (sc.NX*j) + (sc.NX * sc.NY * k);
+					fscanf(in, "%lf ", &temp);
+
+					if (SC_geo(&sc, idx) > 0)
+					{
+						map[cell_count] = temp;		// reading into 1D array of size N
+						if (map[cell_count] >= 0.0) map_count++;
+						cell_count++;
+					}
 				}
 			}
 		}
-	}
 
-	printf("Map file %s read || Nmap = %d, recheck of Ncells = %d\n", filein, map_count, cell_count);
+		printf("Map file %s read || Nmap = %d, recheck of Ncells = %d\n", filein, map_count, cell_count);
 
-	fclose(in);
+		fclose(in);
+	}
 
 	// Write map vtk to Outputs, with map type in filename (this is "ref" here)
 	sprintf(string,"%s/Map_%s.vtk", Output_dir, ref);
@@ -697,7 +913,7 @@ int read_map_file_double(SC_variables sc, double *map, const char *filein, const
 			for (int i = 0; i < sc.NX; i++)
 			{
 				idx = i + (sc.NX*j) + (sc.NX*sc.NY*k);
-				if (sc.geo[idx] > 0)
+				if (SC_geo(&sc, idx) > 0)
 				{
 					fprintf(out, "%f ", map[cell_count]);
 					cell_count++;
@@ -825,7 +1041,7 @@ void output_D1_and_D2(SC_variables sc, const char* Output_dir)
 			for (int i = 0; i < sc.NX; i++)
 			{
 				idx = i + (sc.NX*j) + (sc.NX*sc.NY*k);
-				if (sc.geo[idx] > 0)
+				if (SC_geo(&sc, idx) > 0)
 				{
 					fprintf(out, "%f ", sc.D1[cell_count]);
 					cell_count++;
@@ -860,7 +1076,7 @@ void output_D1_and_D2(SC_variables sc, const char* Output_dir)
 			for (int i = 0; i < sc.NX; i++)
 			{
 				idx = i + (sc.NX*j) + (sc.NX*sc.NY*k);
-				if (sc.geo[idx] > 0)
+				if (SC_geo(&sc, idx) > 0)
 				{
 					fprintf(out, "%f ", sc.D2[cell_count]);
 					cell_count++;
@@ -888,14 +1104,14 @@ void SC_set_index_and_geo_linear(SC_variables *sc)
 			for (int i = 0; i < sc->NX; i++)
 			{
 				idx = i + (sc->NX*j) + (sc->NX * sc->NY * k);	// 3D identifier for each cell
-				if (sc->geo[idx] > 0) // if it is an actual cell/node
+				if (SC_geo(sc, idx) > 0) // if it is an actual cell/node
 				{
-					sc->geo_index[idx] 		= count;		// gives the 1D>Ncell cell count at 3D idx
+					SC_set_geo_index(sc, idx, count);		// gives the 1D>Ncell cell count at 3D idx
 					sc->geo_3D_index[count] = idx;			// gives 3D index for 2D index(count)
 					sc->x_index[count]		= i;
 					sc->y_index[count]		= j;
 					sc->z_index[count]		= k;
-					sc->geo_linear[count] 	= sc->geo[idx]; 	// Set linear cell to 3D cell
+					sc->geo_linear[count] 	= SC_geo(sc, idx); 	// Set linear cell to 3D cell
 					count++;
 				}
 			}
@@ -973,43 +1189,43 @@ void SC_set_neighbours(SC_variables *sc)
 				idx_xp_yp_zm = (i+1) + (sc->NX * (j+1)) + (sc->NX * sc->NY * (k-1));
 				idx_xp_yp_zp = (i+1) + (sc->NX * (j+1)) + (sc->NX * sc->NY * (k+1));
 
-				if (sc->geo[idx] > 0) // if it is an actual cell/node
+				if (SC_geo(sc, idx) > 0) // if it is an actual cell/node
 				{
 					// Principal directions =======================\\|
 					// x direction ======================\\|
 					// x-1 (xm) 
 					if (i == 0)						sc->xm[count] = count;					// if small x edge, xminus returns itself
-					else if (sc->geo[idx_xm] < 1)	sc->xm[count] = count;					// if xminus neighbour is empty space, also return itself
-					else							sc->xm[count] = sc->geo_index[idx_xm];	// xminus is a cell; return linear index of cell at idx x-1 
+					else if (SC_geo(sc, idx_xm) < 1)	sc->xm[count] = count;					// if xminus neighbour is empty space, also return itself
+					else							sc->xm[count] = SC_geo_index(sc, idx_xm);	// xminus is a cell; return linear index of cell at idx x-1 
 
 					// x+1 (xp) 
 					if (i == sc->NX-1)              sc->xp[count] = count;                  // if large x edge, xplus returns itself
-					else if (sc->geo[idx_xp] < 1)   sc->xp[count] = count;                  // if xplus neighbour is empty space, also return itself
-					else                            sc->xp[count] = sc->geo_index[idx_xp];  // xplus is a cell; return linear index of cell at idx x+1
+					else if (SC_geo(sc, idx_xp) < 1)   sc->xp[count] = count;                  // if xplus neighbour is empty space, also return itself
+					else                            sc->xp[count] = SC_geo_index(sc, idx_xp);  // xplus is a cell; return linear index of cell at idx x+1
 					// End x direction ==================//|
 
 					// y direction ======================\\|
 					// y-1 (ym) 
 					if (j == 0)                     sc->ym[count] = count;                  // if small y edge, yminus returns itself
-					else if (sc->geo[idx_ym] < 1)   sc->ym[count] = count;                  // if yminus neighbour is empty space, also return itself
-					else                            sc->ym[count] = sc->geo_index[idx_ym];  // yminus is a cell; return linear index of cell at idx y-1 
+					else if (SC_geo(sc, idx_ym) < 1)   sc->ym[count] = count;                  // if yminus neighbour is empty space, also return itself
+					else                            sc->ym[count] = SC_geo_index(sc, idx_ym);  // yminus is a cell; return linear index of cell at idx y-1 
 
 					// y+1 (yp) 
 					if (j == sc->NY-1)              sc->yp[count] = count;                  // if large y edge, yplus returns itself
-					else if (sc->geo[idx_yp] < 1)   sc->yp[count] = count;                  // if yplus neighbour is empty space, also return itself
-					else                            sc->yp[count] = sc->geo_index[idx_yp];  // yplus is a cell; return linear index of cell at idx y+1
+					else if (SC_geo(sc, idx_yp) < 1)   sc->yp[count] = count;                  // if yplus neighbour is empty space, also return itself
+					else                            sc->yp[count] = SC_geo_index(sc, idx_yp);  // yplus is a cell; return linear index of cell at idx y+1
 					// End y direction ==================//|
 
 					// z direction ======================\\|
 					// z-1 (zm) 
 					if (k == 0)                     sc->zm[count] = count;                  // if small z edge, zminus returns itself
-					else if (sc->geo[idx_zm] < 1)   sc->zm[count] = count;                  // if zminus neighbour is empty space, also return itself
-					else                            sc->zm[count] = sc->geo_index[idx_zm];  // zminus is a cell; return linear index of cell at idx z-1 
+					else if (SC_geo(sc, idx_zm) < 1)   sc->zm[count] = count;                  // if zminus neighbour is empty space, also return itself
+					else                            sc->zm[count] = SC_geo_index(sc, idx_zm);  // zminus is a cell; return linear index of cell at idx z-1 
 
 					// z+1 (zp) 
 					if (k == sc->NZ-1)              sc->zp[count] = count;                  // if large z edge, zplus returns itself
-					else if (sc->geo[idx_zp] < 1)   sc->zp[count] = count;                  // if zplus neighbour is empty space, also return itself
-					else                            sc->zp[count] = sc->geo_index[idx_zp];  // zplus is a cell; return linear index of cell at idx z+1
+					else if (SC_geo(sc, idx_zp) < 1)   sc->zp[count] = count;                  // if zplus neighbour is empty space, also return itself
+					else                            sc->zp[count] = SC_geo_index(sc, idx_zp);  // zplus is a cell; return linear index of cell at idx z+1
 					// End z direction ==================//|
 					// end Principal directions ===================//|
 
@@ -1017,69 +1233,69 @@ void SC_set_neighbours(SC_variables *sc)
 					// xm directions ====================\\|
 					// x-1, y-1
 					if (i == 0 || j == 0)            	sc->xm_ym[count] = count;           // if either x or y is lowest bound, x-1 y-1 cannot exist
-					else if (sc->geo[idx_xm_ym] < 1)   	sc->xm_ym[count] = count;                  
-					else                            	sc->xm_ym[count] = sc->geo_index[idx_xm_ym];  
+					else if (SC_geo(sc, idx_xm_ym) < 1)   	sc->xm_ym[count] = count;                  
+					else                            	sc->xm_ym[count] = SC_geo_index(sc, idx_xm_ym);  
 
 					// x-1, y+1
 					if (i == 0 || j == sc->NY-1)       	sc->xm_yp[count] = count;           // if either x is lowest or y is highest, cannot exist  
-					else if (sc->geo[idx_xm_yp] < 1)   	sc->xm_yp[count] = count;                  
-					else                            	sc->xm_yp[count] = sc->geo_index[idx_xm_yp]; 
+					else if (SC_geo(sc, idx_xm_yp) < 1)   	sc->xm_yp[count] = count;                  
+					else                            	sc->xm_yp[count] = SC_geo_index(sc, idx_xm_yp); 
 
 					// x-1, z-1
 					if (i == 0 || k == 0)               sc->xm_zm[count] = count;           // if either x or z is lowest bound, x-1 z-1 cannot exist
-					else if (sc->geo[idx_xm_zm] < 1)    sc->xm_zm[count] = count;
-					else                                sc->xm_zm[count] = sc->geo_index[idx_xm_zm];
+					else if (SC_geo(sc, idx_xm_zm) < 1)    sc->xm_zm[count] = count;
+					else                                sc->xm_zm[count] = SC_geo_index(sc, idx_xm_zm);
 
 					// x-1, z+1
 					if (i == 0 || k == sc->NZ-1)        sc->xm_zp[count] = count;           // if either x is lowest or z is highest, cannot exist  
-					else if (sc->geo[idx_xm_zp] < 1)    sc->xm_zp[count] = count;
-					else                                sc->xm_zp[count] = sc->geo_index[idx_xm_zp]; 
+					else if (SC_geo(sc, idx_xm_zp) < 1)    sc->xm_zp[count] = count;
+					else                                sc->xm_zp[count] = SC_geo_index(sc, idx_xm_zp); 
 					// End xm directions ================//|
 
 					// xp directions ====================\\|
 					// x+1, y-1
 					if (i == sc->NX-1 || j == 0)       	sc->xp_ym[count] = count;           
-					else if (sc->geo[idx_xp_ym] < 1)   	sc->xp_ym[count] = count;                  
-					else                            	sc->xp_ym[count] = sc->geo_index[idx_xp_ym];  
+					else if (SC_geo(sc, idx_xp_ym) < 1)   	sc->xp_ym[count] = count;                  
+					else                            	sc->xp_ym[count] = SC_geo_index(sc, idx_xp_ym);  
 
 					// x+1, y+1
 					if (i == sc->NX-1 || j == sc->NY-1)	sc->xp_yp[count] = count;            
-					else if (sc->geo[idx_xp_yp] < 1)   	sc->xp_yp[count] = count;                  
-					else                            	sc->xp_yp[count] = sc->geo_index[idx_xp_yp]; 
+					else if (SC_geo(sc, idx_xp_yp) < 1)   	sc->xp_yp[count] = count;                  
+					else                            	sc->xp_yp[count] = SC_geo_index(sc, idx_xp_yp); 
 
 					// x+1, z-1
 					if (i == sc->NX-1 || k == 0)        sc->xp_zm[count] = count;           
-					else if (sc->geo[idx_xp_zm] < 1)    sc->xp_zm[count] = count;
-					else                                sc->xp_zm[count] = sc->geo_index[idx_xp_zm];
+					else if (SC_geo(sc, idx_xp_zm) < 1)    sc->xp_zm[count] = count;
+					else                                sc->xp_zm[count] = SC_geo_index(sc, idx_xp_zm);
 
 					// x+1, z+1
 					if (i == sc->NX-1 || k == sc->NZ-1) sc->xp_zp[count] = count;          
-					else if (sc->geo[idx_xp_zp] < 1)    sc->xp_zp[count] = count;
-					else                                sc->xp_zp[count] = sc->geo_index[idx_xp_zp]; 
+					else if (SC_geo(sc, idx_xp_zp) < 1)    sc->xp_zp[count] = count;
+					else                                sc->xp_zp[count] = SC_geo_index(sc, idx_xp_zp); 
 					// End xp directions ================//|
 
 					// ym, z directions =================\\|
 					// y-1, z-1
 					if (j == 0 || k == 0)               sc->ym_zm[count] = count;           
-					else if (sc->geo[idx_ym_zm] < 1)    sc->ym_zm[count] = count;
-					else                                sc->ym_zm[count] = sc->geo_index[idx_ym_zm];
+					else if (SC_geo(sc, idx_ym_zm) < 1)    sc->ym_zm[count] = count;
+					else                                sc->ym_zm[count] = SC_geo_index(sc, idx_ym_zm);
 
 					// y-1, z+1
 					if (j == 0 || k == sc->NZ-1)        sc->ym_zp[count] = count;          
-					else if (sc->geo[idx_ym_zp] < 1)    sc->ym_zp[count] = count;
-					else                                sc->ym_zp[count] = sc->geo_index[idx_ym_zp];
+					else if (SC_geo(sc, idx_ym_zp) < 1)    sc->ym_zp[count] = count;
+					else                                sc->ym_zp[count] = SC_geo_index(sc, idx_ym_zp);
 					// End ym, z directions =============//|
 
 					// yp, z directions =================\\|
 					// y+1, z-1
 					if (j == sc->NY-1 || k == 0)        sc->yp_zm[count] = count;           
-					else if (sc->geo[idx_yp_zm] < 1)    sc->yp_zm[count] = count;
-					else                                sc->yp_zm[count] = sc->geo_index[idx_yp_zm];
+					else if (SC_geo(sc, idx_yp_zm) < 1)    sc->yp_zm[count] = count;
+					else                                sc->yp_zm[count] = SC_geo_index(sc, idx_yp_zm);
 
 					// y+1, z+1
 					if (j == sc->NY-1 || k == sc->NZ-1) sc->yp_zp[count] = count;           
-					else if (sc->geo[idx_yp_zp] < 1)    sc->yp_zp[count] = count;
-					else                                sc->yp_zp[count] = sc->geo_index[idx_yp_zp];
+					else if (SC_geo(sc, idx_yp_zp) < 1)    sc->yp_zp[count] = count;
+					else                                sc->yp_zp[count] = SC_geo_index(sc, idx_yp_zp);
 					// End ym, z directions =============//|
 					// End Diagonals ==============================//|
 
@@ -1088,50 +1304,50 @@ void SC_set_neighbours(SC_variables *sc)
 					// xm ym ==================\\|
 					// x-1, y-1, z-1
 					if (i == 0 || j == 0 || k == 0)     				sc->xm_ym_zm[count] = count;      
-					else if (sc->geo[idx_xm_ym_zm] < 1) 				sc->xm_ym_zm[count] = count;
-					else                                				sc->xm_ym_zm[count] = sc->geo_index[idx_xm_ym_zm];
+					else if (SC_geo(sc, idx_xm_ym_zm) < 1) 				sc->xm_ym_zm[count] = count;
+					else                                				sc->xm_ym_zm[count] = SC_geo_index(sc, idx_xm_ym_zm);
 
 					// x-1, y-1, z+1
 					if (i == 0 || j == 0 || k == sc->NZ-1) 				sc->xm_ym_zp[count] = count;      
-					else if (sc->geo[idx_xm_ym_zp] < 1) 				sc->xm_ym_zp[count] = count;
-					else                                				sc->xm_ym_zp[count] = sc->geo_index[idx_xm_ym_zp];
+					else if (SC_geo(sc, idx_xm_ym_zp) < 1) 				sc->xm_ym_zp[count] = count;
+					else                                				sc->xm_ym_zp[count] = SC_geo_index(sc, idx_xm_ym_zp);
 					// end xm ym ==============//|
 
 					// xm yp ==================\\|
 					// x-1, y+1, z-1
 					if (i == 0 || j == sc->NY-1 || k == 0)  			sc->xm_yp_zm[count] = count;      
-					else if (sc->geo[idx_xm_yp_zm] < 1) 				sc->xm_yp_zm[count] = count;
-					else                                				sc->xm_yp_zm[count] = sc->geo_index[idx_xm_yp_zm];
+					else if (SC_geo(sc, idx_xm_yp_zm) < 1) 				sc->xm_yp_zm[count] = count;
+					else                                				sc->xm_yp_zm[count] = SC_geo_index(sc, idx_xm_yp_zm);
 
 					// x-1, y+1, z+1
 					if (i == 0 || j == sc->NY-1 || k == sc->NZ-1) 		sc->xm_yp_zp[count] = count;      
-					else if (sc->geo[idx_xm_yp_zp] < 1) 				sc->xm_yp_zp[count] = count;
-					else                                				sc->xm_yp_zp[count] = sc->geo_index[idx_xm_yp_zp];
+					else if (SC_geo(sc, idx_xm_yp_zp) < 1) 				sc->xm_yp_zp[count] = count;
+					else                                				sc->xm_yp_zp[count] = SC_geo_index(sc, idx_xm_yp_zp);
 					// end xm yp ==============//|
 
 					// xp directions ====================\\|
 					// xp ym ==================\\|
 					// x+1, y-1, z-1
 					if (i == sc->NX-1 || j == 0 || k == 0)  			sc->xp_ym_zm[count] = count;      
-					else if (sc->geo[idx_xp_ym_zm] < 1) 				sc->xp_ym_zm[count] = count;
-					else                                				sc->xp_ym_zm[count] = sc->geo_index[idx_xp_ym_zm];
+					else if (SC_geo(sc, idx_xp_ym_zm) < 1) 				sc->xp_ym_zm[count] = count;
+					else                                				sc->xp_ym_zm[count] = SC_geo_index(sc, idx_xp_ym_zm);
 
 					// x+1, y-1, z+1
 					if (i == sc->NX-1 || j == 0 || k == sc->NZ-1) 		sc->xp_ym_zp[count] = count;      
-					else if (sc->geo[idx_xp_ym_zp] < 1) 				sc->xp_ym_zp[count] = count;
-					else                                				sc->xp_ym_zp[count] = sc->geo_index[idx_xp_ym_zp];
+					else if (SC_geo(sc, idx_xp_ym_zp) < 1) 				sc->xp_ym_zp[count] = count;
+					else                                				sc->xp_ym_zp[count] = SC_geo_index(sc, idx_xp_ym_zp);
 					// end xp ym ==============//|
 
 					// xp yp ==================\\|
 					// x+1, y+1, z-1
 					if (i == sc->NX-1 || j == sc->NY-1 || k == 0)  		sc->xp_yp_zm[count] = count;      
-					else if (sc->geo[idx_xp_yp_zm] < 1) 				sc->xp_yp_zm[count] = count;
-					else                                				sc->xp_yp_zm[count] = sc->geo_index[idx_xp_yp_zm];
+					else if (SC_geo(sc, idx_xp_yp_zm) < 1) 				sc->xp_yp_zm[count] = count;
+					else                                				sc->xp_yp_zm[count] = SC_geo_index(sc, idx_xp_yp_zm);
 
 					// x+1, y+1, z+1
 					if (i == sc->NX-1 || j == sc->NY-1 || k == sc->NZ-1)sc->xp_yp_zp[count] = count;      
-					else if (sc->geo[idx_xp_yp_zp] < 1) 				sc->xp_yp_zp[count] = count;
-					else                                				sc->xp_yp_zp[count] = sc->geo_index[idx_xp_yp_zp];
+					else if (SC_geo(sc, idx_xp_yp_zp) < 1) 				sc->xp_yp_zp[count] = count;
+					else                                				sc->xp_yp_zp[count] = SC_geo_index(sc, idx_xp_yp_zp);
 					// end xp yp ==============//|
 					// End Corners ================================//|
 
@@ -2025,21 +2241,21 @@ void calc_N_junctions(SC_variables *sc)
                 idx_xp_ym_zp = (i+1) + (sc->NX * (j-1)) + (sc->NX * sc->NY * (k+1));
                 idx_xp_yp_zp = (i+1) + (sc->NX * (j+1)) + (sc->NX * sc->NY * (k+1));
 
-                if (sc->geo[idx] > 0) // if it is an actual cell/node
+                if (SC_geo(sc, idx) > 0) // if it is an actual cell/node
                 {
-                    if (i < sc->NX-1 &&                                 sc->geo[idx_xp] > 0)        sc->Njunc++;
-                    if (j < sc->NY-1 &&                                 sc->geo[idx_yp] > 0)        sc->Njunc++;
-                    if (k < sc->NZ-1 &&                                 sc->geo[idx_zp] > 0)        sc->Njunc++;
-                    if (i < sc->NX-1 && j < sc->NY-1 &&                 sc->geo[idx_xp_yp] > 0)     sc->Njunc++;
-                    if (i > 0        && j < sc->NY-1 &&                 sc->geo[idx_xm_yp] > 0)     sc->Njunc++;
-                    if (i < sc->NX-1 && k < sc->NZ-1 &&                 sc->geo[idx_xp_zp] > 0)     sc->Njunc++;
-                    if (i > 0        && k < sc->NZ-1 &&                 sc->geo[idx_xm_zp] > 0)     sc->Njunc++;
-                    if (j < sc->NY-1 && k < sc->NZ-1 &&                 sc->geo[idx_yp_zp] > 0)     sc->Njunc++;
-                    if (j > 0        && k < sc->NZ-1 &&                 sc->geo[idx_ym_zp] > 0)     sc->Njunc++;
-                    if (i < sc->NX-1 && j < sc->NY-1 && k < sc->NZ-1 && sc->geo[idx_xp_yp_zp] > 0)  sc->Njunc++;
-                    if (i > 0        && j < sc->NY-1 && k < sc->NZ-1 && sc->geo[idx_xm_yp_zp] > 0)  sc->Njunc++;
-                    if (i < sc->NX-1 && j > 0        && k < sc->NZ-1 && sc->geo[idx_xp_ym_zp] > 0)  sc->Njunc++;
-                    if (i > 0        && j > 0        && k < sc->NZ-1 && sc->geo[idx_xm_ym_zp] > 0)  sc->Njunc++;
+                    if (i < sc->NX-1 &&                                 SC_geo(sc, idx_xp) > 0)        sc->Njunc++;
+                    if (j < sc->NY-1 &&                                 SC_geo(sc, idx_yp) > 0)        sc->Njunc++;
+                    if (k < sc->NZ-1 &&                                 SC_geo(sc, idx_zp) > 0)        sc->Njunc++;
+                    if (i < sc->NX-1 && j < sc->NY-1 &&                 SC_geo(sc, idx_xp_yp) > 0)     sc->Njunc++;
+                    if (i > 0        && j < sc->NY-1 &&                 SC_geo(sc, idx_xm_yp) > 0)     sc->Njunc++;
+                    if (i < sc->NX-1 && k < sc->NZ-1 &&                 SC_geo(sc, idx_xp_zp) > 0)     sc->Njunc++;
+                    if (i > 0        && k < sc->NZ-1 &&                 SC_geo(sc, idx_xm_zp) > 0)     sc->Njunc++;
+                    if (j < sc->NY-1 && k < sc->NZ-1 &&                 SC_geo(sc, idx_yp_zp) > 0)     sc->Njunc++;
+                    if (j > 0        && k < sc->NZ-1 &&                 SC_geo(sc, idx_ym_zp) > 0)     sc->Njunc++;
+                    if (i < sc->NX-1 && j < sc->NY-1 && k < sc->NZ-1 && SC_geo(sc, idx_xp_yp_zp) > 0)  sc->Njunc++;
+                    if (i > 0        && j < sc->NY-1 && k < sc->NZ-1 && SC_geo(sc, idx_xm_yp_zp) > 0)  sc->Njunc++;
+                    if (i < sc->NX-1 && j > 0        && k < sc->NZ-1 && SC_geo(sc, idx_xp_ym_zp) > 0)  sc->Njunc++;
+                    if (i > 0        && j > 0        && k < sc->NZ-1 && SC_geo(sc, idx_xm_ym_zp) > 0)  sc->Njunc++;
                 } // end if
             } // end x for
         } // end y for
@@ -2107,7 +2323,7 @@ void set_gjunc_and_junc_maps(SC_variables *sc, const char* Output_dir, Tissue_pa
                 idx_xp_ym_zp = (i+1) + (sc->NX * (j-1)) + (sc->NX * sc->NY * (k+1));
                 idx_xp_yp_zp = (i+1) + (sc->NX * (j+1)) + (sc->NX * sc->NY * (k+1));
 
-                if (sc->geo[idx] > 0) // if it is an actual cell/node
+                if (SC_geo(sc, idx) > 0) // if it is an actual cell/node
                 {
                     xx      = false;
                     yy      = false;
@@ -2124,20 +2340,20 @@ void set_gjunc_and_junc_maps(SC_variables *sc, const char* Output_dir, Tissue_pa
                     xyzmpp  = false;
 
                     // if this positive neighbour exists, set junction to true
-                    if (i < sc->NX-1 &&                     sc->geo[idx_xp] > 0)    xx      = true;
-                    if (j < sc->NY-1 &&                     sc->geo[idx_yp] > 0)    yy      = true;
-                    if (k < sc->NZ-1 &&                     sc->geo[idx_zp] > 0)    zz      = true;
-                    if (i < sc->NX-1 && j < sc->NY-1 &&     sc->geo[idx_xp_yp] > 0) xypp    = true;
-                    if (i > 0        && j < sc->NY-1 &&     sc->geo[idx_xm_yp] > 0) xypm    = true;
-                    if (i < sc->NX-1 && k < sc->NZ-1 &&     sc->geo[idx_xp_zp] > 0) xzpp    = true;
-                    if (i > 0        && k < sc->NZ-1 &&     sc->geo[idx_xm_zp] > 0) xzpm    = true;
-                    if (j < sc->NY-1 && k < sc->NZ-1 &&     sc->geo[idx_yp_zp] > 0) yzpp    = true;
-                    if (j > 0        && k < sc->NZ-1 &&     sc->geo[idx_ym_zp] > 0) yzpm    = true;
-
-                    if (i < sc->NX-1 && j < sc->NY-1 && k < sc->NZ-1 && sc->geo[idx_xp_yp_zp] > 0)  xyzppp = true;
-                    if (i > 0        && j < sc->NY-1 && k < sc->NZ-1 && sc->geo[idx_xm_yp_zp] > 0)  xyzmpp = true;
-                    if (i < sc->NX-1 && j > 0        && k < sc->NZ-1 && sc->geo[idx_xp_ym_zp] > 0)  xyzpmp = true;
-                    if (i > 0        && j > 0        && k < sc->NZ-1 && sc->geo[idx_xm_ym_zp] > 0)  xyzppm = true;
+                    if (i < sc->NX-1 &&                     SC_geo(sc, idx_xp) > 0)    xx      = true;
+                    if (j < sc->NY-1 &&                     SC_geo(sc, idx_yp) > 0)    yy      = true;
+                    if (k < sc->NZ-1 &&                     SC_geo(sc, idx_zp) > 0)    zz      = true;
+                    if (i < sc->NX-1 && j < sc->NY-1 &&     SC_geo(sc, idx_xp_yp) > 0) xypp    = true;
+                    if (i > 0        && j < sc->NY-1 &&     SC_geo(sc, idx_xm_yp) > 0) xypm    = true;
+                    if (i < sc->NX-1 && k < sc->NZ-1 &&     SC_geo(sc, idx_xp_zp) > 0) xzpp    = true;
+                    if (i > 0        && k < sc->NZ-1 &&     SC_geo(sc, idx_xm_zp) > 0) xzpm    = true;
+                    if (j < sc->NY-1 && k < sc->NZ-1 &&     SC_geo(sc, idx_yp_zp) > 0) yzpp    = true;
+                    if (j > 0        && k < sc->NZ-1 &&     SC_geo(sc, idx_ym_zp) > 0) yzpm    = true;
+
+                    if (i < sc->NX-1 && j < sc->NY-1 && k < sc->NZ-1 && SC_geo(sc, idx_xp_yp_zp) > 0)  xyzppp = true;
+                    if (i > 0        && j < sc->NY-1 && k < sc->NZ-1 && SC_geo(sc, idx_xm_yp_zp) > 0)  xyzmpp = true;
+                    if (i < sc->NX-1 && j > 0        && k < sc->NZ-1 && SC_geo(sc, idx_xp_ym_zp) > 0)  xyzpmp = true;
+                    if (i > 0        && j > 0        && k < sc->NZ-1 && SC_geo(sc, idx_xm_ym_zp) > 0)  xyzppm = true;
 
                     // Unset junctions if regions should not be electrically coupled
                     if (t->disconnect_regions_flag == true)
@@ -2146,31 +2362,31 @@ void set_gjunc_and_junc_maps(SC_variables *sc, const char* Output_dir, Tissue_pa
                         {
                             // if current cell is region 1 and neighbour region 2, or current cell is reg 2 and nei reg 1, uncouple by setting that junction flag back to false
                             if (i < sc->NX-1)
-                                if( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xp] == t->disconnect_regions[DN][0]) ) xx = false;
+                                if( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xp) == t->disconnect_regions[DN][0]) ) xx = false;
                             if (j < sc->NY-1)
-                                if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_yp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_yp] == t->disconnect_regions[DN][0]) ) yy = false;
+                                if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_yp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_yp) == t->disconnect_regions[DN][0]) ) yy = false;
                             if (k < sc->NZ-1)
-                                if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_zp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_zp] == t->disconnect_regions[DN][0]) ) zz = false;
+                                if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_zp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_zp) == t->disconnect_regions[DN][0]) ) zz = false;
                             if (i < sc->NX-1 && j < sc->NY-1)
-                                if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xp_yp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xp_yp] == t->disconnect_regions[DN][0]) ) xypp = false;
+                                if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xp_yp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xp_yp) == t->disconnect_regions[DN][0]) ) xypp = false;
                             if (i > 0 && j < sc->NY-1)
-                                if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xm_yp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xm_yp] == t->disconnect_regions[DN][0]) ) xypm = false;
+                                if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xm_yp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xm_yp) == t->disconnect_regions[DN][0]) ) xypm = false;
                             if (i < sc->NX-1 && k < sc->NZ-1)
-                                if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xp_zp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xp_zp] == t->disconnect_regions[DN][0]) ) xzpp = false;
+                                if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xp_zp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xp_zp) == t->disconnect_regions[DN][0]) ) xzpp = false;
                             if (i > 0 && k < sc->NZ-1)
-                                if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xm_zp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xm_zp] == t->disconnect_regions[DN][0]) ) xzpm = false;
+                                if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xm_zp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xm_zp) == t->disconnect_regions[DN][0]) ) xzpm = false;
                             if (j < sc->NY-1 && k < sc->NZ-1)
-                                if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_yp_zp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_yp_zp] == t->disconnect_regions[DN][0]) ) yzpp = false;
+                                if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_yp_zp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_yp_zp) == t->disconnect_regions[DN][0]) ) yzpp = false;
                             if (j > 0 && k < sc->NZ-1)
-                                if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_ym_zp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_ym_zp] == t->disconnect_regions[DN][0]) ) yzpm = false;
+                                if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_ym_zp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_ym_zp) == t->disconnect_regions[DN][0]) ) yzpm = false;
                             if (i < sc->NX-1 && j < sc->NY-1 && k < sc->NZ-1)
-                                if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xp_yp_zp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xp_yp_zp] == t->disconnect_regions[DN][0]) ) xyzppp = false;
+                                if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xp_yp_zp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xp_yp_zp) == t->disconnect_regions[DN][0]) ) xyzppp = false;
                             if (i > 0 && j < sc->NY-1 && k < sc->NZ-1)
-                                if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xm_yp_zp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xm_yp_zp] == t->disconnect_regions[DN][0]) ) xyzmpp = false;
+                                if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xm_yp_zp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xm_yp_zp) == t->disconnect_regions[DN][0]) ) xyzmpp = false;
                             if (i < sc->NX-1 && j > 0 && k < sc->NZ-1)
-                                if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xp_ym_zp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xp_ym_zp] == t->disconnect_regions[DN][0]) ) xyzpmp = false;
+                                if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xp_ym_zp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xp_ym_zp) == t->disconnect_regions[DN][0]) ) xyzpmp = false;
                             if (i > 0 && j > 0 && k < sc->NZ-1)
-                                if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xm_ym_zp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xm_ym_zp] == t->disconnect_regions[DN][0]) ) xyzppm = false;
+                                if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xm_ym_zp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xm_ym_zp) == t->disconnect_regions[DN][0]) ) xyzppm = false;
                         } // end DN for
                     } // end disconnect uncoupled regions
 
@@ -2181,14 +2397,14 @@ void set_gjunc_and_junc_maps(SC_variables *sc, const char* Output_dir, Tissue_pa
                         // find 1D,Ncell index of plus and minus neighbours
                         // we want jn_map, which is of Njunc and incremented with each junc, to return the 1DNcell index (which the voltage array is of)
                         // : minus is itself (as the junction is between itself and plus neighour) and plus is plus neighbour
-                        sc->jn_map_minus[count_junc]    = count; // or = sc->geo_index[idx], same thing
-                        sc->jn_map_plus[count_junc]     = sc->geo_index[idx_xp]; // sets the 1D index of xplus to the i+1 node
-                        sc->gGap_jn[count_junc]        = (sc->gGap_node_xx[count] + sc->gGap_node_xx[sc->geo_index[idx_xp]])/2; // junction g is average of the two coupled cells
+                        sc->jn_map_minus[count_junc]    = count; // or = SC_geo_index(sc, idx), same thing
+                        sc->jn_map_plus[count_junc]     = SC_geo_index(sc, idx_xp); // sets the 1D index of xplus to the i+1 node
+                        sc->gGap_jn[count_junc]        = (sc->gGap_node_xx[count] + sc->gGap_node_xx[SC_geo_index(sc, idx_xp)])/2; // junction g is average of the two coupled cells
 
                         sc->connection_type_jn[count_junc] = 0;
-                        if (sc->connection_type_node_xx[count] == 1 && sc->connection_type_node_xx[sc->geo_index[idx_xp]] == 1)     sc->connection_type_jn[count_junc] = 1;  // connection is transverse
-                        if (sc->connection_type_node_xx[count] == 2 && sc->connection_type_node_xx[sc->geo_index[idx_xp]] == 2)     sc->connection_type_jn[count_junc] = 2;  // connection is axial
-                        if (sc->connection_type_node_xx[count]*sc->connection_type_node_xx[sc->geo_index[idx_xp]] == 2)             sc->connection_type_jn[count_junc] = 3;  // connection is mixed (1*2 or 2*1)
+                        if (sc->connection_type_node_xx[count] == 1 && sc->connection_type_node_xx[SC_geo_index(sc, idx_xp)] == 1)     sc->connection_type_jn[count_junc] = 1;  // connection is transverse
+                        if (sc->connection_type_node_xx[count] == 2 && sc->connection_type_node_xx[SC_geo_index(sc, idx_xp)] == 2)     sc->connection_type_jn[count_junc] = 2;  // connection is axial
+                        if (sc->connection_type_node_xx[count]*sc->connection_type_node_xx[SC_geo_index(sc, idx_xp)] == 2)             sc->connection_type_jn[count_junc] = 3;  // connection is mixed (1*2 or 2*1)
 
                         count_junc++;
                     }
@@ -2196,26 +2412,26 @@ void set_gjunc_and_junc_maps(SC_variables *sc, const char* Output_dir, Tissue_pa
                     if (yy == true)
                     {
                         sc->jn_map_minus[count_junc]    = count;
-                        sc->jn_map_plus[count_junc]     = sc->geo_index[idx_yp]; // sets the 1D index of xplus to the i+1 node
-                        sc->gGap_jn[count_junc]        = (sc->gGap_node_yy[count] + sc->gGap_node_yy[sc->geo_index[idx_yp]])/2; // junction g is average of the two coupled cells
+                        sc->jn_map_plus[count_junc]     = SC_geo_index(sc, idx_yp); // sets the 1D index of xplus to the i+1 node
+                        sc->gGap_jn[count_junc]        = (sc->gGap_node_yy[count] + sc->gGap_node_yy[SC_geo_index(sc, idx_yp)])/2; // junction g is average of the two coupled cells
 
                         sc->connection_type_jn[count_junc] = 0;
-                        if (sc->connection_type_node_yy[count] == 1 && sc->connection_type_node_yy[sc->geo_index[idx_xp]] == 1)     sc->connection_type_jn[count_junc] = 1;  // connection is transverse
-                        if (sc->connection_type_node_yy[count] == 2 && sc->connection_type_node_yy[sc->geo_index[idx_xp]] == 2)     sc->connection_type_jn[count_junc] = 2;  // connection is axial
-                        if (sc->connection_type_node_yy[count]*sc->connection_type_node_yy[sc->geo_index[idx_xp]] == 2)             sc->connection_type_jn[count_junc] = 3;  // connection is mixed (1*2 or 2*1)
+                        if (sc->connection_type_node_yy[count] == 1 && sc->connection_type_node_yy[SC_geo_index(sc, idx_xp)] == 1)     sc->connection_type_jn[count_junc] = 1;  // connection is transverse
+                        if (sc->connection_type_node_yy[count] == 2 && sc->connection_type_node_yy[SC_geo_index(sc, idx_xp)] == 2)     sc->connection_type_jn[count_junc] = 2;  // connection is axial
+                        if (sc->connection_type_node_yy[count]*sc->connection_type_node_yy[SC_geo_index(sc, idx_xp)] == 2)             sc->connection_type_jn[count_junc] = 3;  // connection is mixed (1*2 or 2*1)
 
                         count_junc++;
                     }
                     if (zz == true)
                     {
                         sc->jn_map_minus[count_junc]    = count;
-                        sc->jn_map_plus[count_junc]     = sc->geo_index[idx_zp];
-                        sc->gGap_jn[count_junc]        = (sc->gGap_node_zz[count] + sc->gGap_node_zz[sc->geo_index[idx_zp]])/2; // junction g is average of the two coupled cells
+                        sc->jn_map_plus[count_junc]     = SC_geo_index(sc, idx_zp);
+                        sc->gGap_jn[count_junc]        = (sc->gGap_node_zz[count] + sc->gGap_node_zz[SC_geo_index(sc, idx_zp)])/2; // junction g is average of the two coupled cells
 
                         sc->connection_type_jn[count_junc] = 0;
-                        if (sc->connection_type_node_zz[count] == 1 && sc->connection_type_node_zz[sc->geo_index[idx_xp]] == 1)     sc->connection_type_jn[count_junc] = 1;  // connection is transverse
-                        if (sc->connection_type_node_zz[count] == 2 && sc->connection_type_node_zz[sc->geo_index[idx_xp]] == 2)     sc->connection_type_jn[count_junc] = 2;  // connection is axial
-                        if (sc->connection_type_node_zz[count]*sc->connection_type_node_zz[sc->geo_index[idx_xp]] == 2)             sc->connection_type_jn[count_junc] = 3;  // connection is mixed (1*2 or 2*1)
+                        if (sc->connection_type_node_zz[count] == 1 && sc->connection_type_node_zz[SC_geo_index(sc, idx_xp)] == 1)     sc->connection_type_jn[count_junc] = 1;  // connection is transverse
+                        if (sc->connection_type_node_zz[count] == 2 && sc->connection_type_node_zz[SC_geo_index(sc, idx_xp)] == 2)     sc->connection_type_jn[count_junc] = 2;  // connection is axial
+                        if (sc->connection_type_node_zz[count]*sc->connection_type_node_zz[SC_geo_index(sc, idx_xp)] == 2)             sc->connection_type_jn[count_junc] = 3;  // connection is mixed (1*2 or 2*1)
 
                         count_junc++;
                     }
@@ -2224,13 +2440,13 @@ void set_gjunc_and_junc_maps(SC_variables *sc, const char* Output_dir, Tissue_pa
                     if (xypp == true)
                     {
                         sc->jn_map_minus[count_junc]    = count;
-                        sc->jn_map_plus[count_junc]     = sc->geo_index[idx_xp_yp];
-                        sc->gGap_jn[count_junc]        = (sc->gGap_node_xypp[count] + sc->gGap_node_xypp[sc->geo_index[idx_xp_yp]])/2; // junction g is average of the two coupled cells
+                        sc->jn_map_plus[count_junc]     = SC_geo_index(sc, idx_xp_yp);
+                        sc->gGap_jn[count_junc]        = (sc->gGap_node_xypp[count] + sc->gGap_node_xypp[SC_geo_index(sc, idx_xp_yp)])/2; // junction g is average of the two coupled cells
 
                         sc->connection_type_jn[count_junc] = 0;
-                        if (sc->connection_type_node_xypp[count] == 1 && sc->connection_type_node_xypp[sc->geo_index[idx_xp]] == 1)     sc->connection_type_jn[count_junc] = 1;  // connection is transverse
-                        if (sc->connection_type_node_xypp[count] == 2 && sc->connection_type_node_xypp[sc->geo_index[idx_xp]] == 2)     sc->connection_type_jn[count_junc] = 2;  // connection is axial
-                        if (sc->connection_type_node_xypp[count]*sc->connection_type_node_xypp[sc->geo_index[idx_xp]] == 2)             sc->connection_type_jn[count_junc] = 3;  // connection is mixed (1*2 or 2*1)
+                        if (sc->connection_type_node_xypp[count] == 1 && sc->connection_type_node_xypp[SC_geo_index(sc, idx_xp)] == 1)     sc->connection_type_jn[count_junc] = 1;  // connection is transverse
+                        if (sc->connection_type_node_xypp[count] == 2 && sc->connection_type_node_xypp[SC_geo_index(sc, idx_xp)] == 2)     sc->connection_type_jn[count_junc] = 2;  // connection is axial
+                        if (sc->connection_type_node_xypp[count]*sc->connection_type_node_xypp[SC_geo_index(sc, idx_xp)] == 2)             sc->connection_type_jn[count_junc] = 3;  // connection is mixed (1*2 or 2*1)
 
                         count_junc++;
                     }
@@ -2238,39 +2454,39 @@ void set_gjunc_and_junc_maps(SC_variables *sc, const char* Output_dir, Tissue_pa
                     if (xypm == true)
                     {
                         sc->jn_map_minus[count_junc]    = count;
-                        sc->jn_map_plus[count_junc]     = sc->geo_index[idx_xm_yp];
-                        sc->gGap_jn[count_junc]        = (sc->gGap_node_xypm[count] + sc->gGap_node_xypm[sc->geo_index[idx_xm_yp]])/2; // junction g is average of the two coupled cells
+                        sc->jn_map_plus[count_junc]     = SC_geo_index(sc, idx_xm_yp);
+                        sc->gGap_jn[count_junc]        = (sc->gGap_node_xypm[count] + sc->gGap_node_xypm[SC_geo_index(sc, idx_xm_yp)])/2; // junction g is average of the two coupled cells
 
                         sc->connection_type_jn[count_junc] = 0;
-                        if (sc->connection_type_node_xypm[count] == 1 && sc->connection_type_node_xypm[sc->geo_index[idx_xp]] == 1)     sc->connection_type_jn[count_junc] = 1;  // connection is transverse
-                        if (sc->connection_type_node_xypm[count] == 2 && sc->connection_type_node_xypm[sc->geo_index[idx_xp]] == 2)     sc->connection_type_jn[count_junc] = 2;  // connection is axial
-                        if (sc->connection_type_node_xypm[count]*sc->connection_type_node_xypm[sc->geo_index[idx_xp]] == 2)             sc->connection_type_jn[count_junc] = 3;  // connection is mixed (1*2 or 2*1)
+                        if (sc->connection_type_node_xypm[count] == 1 && sc->connection_type_node_xypm[SC_geo_index(sc, idx_xp)] == 1)     sc->connection_type_jn[count_junc] = 1;  // connection is transverse
+                        if (sc->connection_type_node_xypm[count] == 2 && sc->connection_type_node_xypm[SC_geo_index(sc, idx_xp)] == 2)     sc->connection_type_jn[count_junc] = 2;  // connection is axial
+                        if (sc->connection_type_node_xypm[count]*sc->connection_type_node_xypm[SC_geo_index(sc, idx_xp)] == 2)             sc->connection_type_jn[count_junc] = 3;  // connection is mixed (1*2 or 2*1)
 
                         count_junc++;
                     }
                     if (xzpp == true)
                     {
                         sc->jn_map_minus[count_junc]    = count;
-                        sc->jn_map_plus[count_junc]     = sc->geo_index[idx_xp_zp];
-                        sc->gGap_jn[count_junc]        = (sc->gGap_node_xzpp[count] + sc->gGap_node_xzpp[sc->geo_index[idx_xp_zp]])/2; // junction g is average of the two coupled cells
+                        sc->jn_map_plus[count_junc]     = SC_geo_index(sc, idx_xp_zp);
+                        sc->gGap_jn[count_junc]        = (sc->gGap_node_xzpp[count] + sc->gGap_node_xzpp[SC_geo_index(sc, idx_xp_zp)])/2; // junction g is average of the two coupled cells
 
                         sc->connection_type_jn[count_junc] = 0;
-                        if (sc->connection_type_node_xzpp[count] == 1 && sc->connection_type_node_xzpp[sc->geo_index[idx_xp]] == 1)     sc->connection_type_jn[count_junc] = 1;  // connection is transverse
-                        if (sc->connection_type_node_xzpp[count] == 2 && sc->connection_type_node_xzpp[sc->geo_index[idx_xp]] == 2)     sc->connection_type_jn[count_junc] = 2;  // connection is axial
-                        if (sc->connection_type_node_xzpp[count]*sc->connection_type_node_xzpp[sc->geo_index[idx_xp]] == 2)             sc->connection_type_jn[count_junc] = 3;  // connection is mixed (1*2 or 2*1)
+                        if (sc->connection_type_node_xzpp[count] == 1 && sc->connection_type_node_xzpp[SC_geo_index(sc, idx_xp)] == 1)     sc->connection_type_jn[count_junc] = 1;  // connection is transverse
+                        if (sc->connection_type_node_xzpp[count] == 2 && sc->connection_type_node_xzpp[SC_geo_index(sc, idx_xp)] == 2)     sc->connection_type_jn[count_junc] = 2;  // connection is axial
+                        if (sc->connection_type_node_xzpp[count]*sc->connection_type_node_xzpp[SC_geo_index(sc, idx_xp)] == 2)             sc->connection_type_jn[count_junc] = 3;  // connection is mixed (1*2 or 2*1)
 
                         count_junc++;
                     }
                     if (xzpm == true)
                     {
                         sc->jn_map_minus[count_junc]    = count;
-                        sc->jn_map_plus[count_junc]     = sc->geo_index[idx_xm_zp];
-                        sc->gGap_jn[count_junc]        = (sc->gGap_node_xzpm[count] + sc->gGap_node_xzpm[sc->geo_index[idx_xm_zp]])/2; // junction g is average of the two coupled cells
+                        sc->jn_map_plus[count_junc]     = SC_geo_index(sc, idx_xm_zp);
+                        sc->gGap_jn[count_junc]        = (sc->gGap_node_xzpm[count] + sc->gGap_node_xzpm[SC_geo_index(sc, idx_xm_zp)])/2; // junction g is average of the two coupled cells
 
                         sc->connection_type_jn[count_junc] = 0;
-                        if (sc->connection_type_node_xzpm[count] == 1 && sc->connection_type_node_xzpm[sc->geo_index[idx_xp]] == 1)     sc->connection_type_jn[count_junc] = 1;  // connection is transverse
-                        if (sc->connection_type_node_xzpm[count] == 2 && sc->connection_type_node_xzpm[sc->geo_index[idx_xp]] == 2)     sc->connection_type_jn[count_junc] = 2;  // connection is axial
-                        if (sc->connection_type_node_xzpm[count]*sc->connection_type_node_xzpm[sc->geo_index[idx_xp]] == 2)             sc->connection_type_jn[count_junc] = 3;  // connection is mixed (1*2 or 2*1)
+                        if (sc->connection_type_node_xzpm[count] == 1 && sc->connection_type_node_xzpm[SC_geo_index(sc, idx_xp)] == 1)     sc->connection_type_jn[count_junc] = 1;  // connection is transverse
+                        if (sc->connection_type_node_xzpm[count] == 2 && sc->connection_type_node_xzpm[SC_geo_index(sc, idx_xp)] == 2)     sc->connection_type_jn[count_junc] = 2;  // connection is axial
+                        if (sc->connection_type_node_xzpm[count]*sc->connection_type_node_xzpm[SC_geo_index(sc, idx_xp)] == 2)             sc->connection_type_jn[count_junc] = 3;  // connection is mixed (1*2 or 2*1)
 
                         count_junc++;
                     }
@@ -2278,26 +2494,26 @@ void set_gjunc_and_junc_maps(SC_variables *sc, const char* Output_dir, Tissue_pa
                     if (yzpp == true)
                     {
                         sc->jn_map_minus[count_junc]    = count;
-                        sc->jn_map_plus[count_junc]     = sc->geo_index[idx_yp_zp];
-                        sc->gGap_jn[count_junc]        = (sc->gGap_node_yzpp[count] + sc->gGap_node_yzpp[sc->geo_index[idx_yp_zp]])/2; // junction g is average of the two coupled cells
+                        sc->jn_map_plus[count_junc]     = SC_geo_index(sc, idx_yp_zp);
+                        sc->gGap_jn[count_junc]        = (sc->gGap_node_yzpp[count] + sc->gGap_node_yzpp[SC_geo_index(sc, idx_yp_zp)])/2; // junction g is average of the two coupled cells
 
                         sc->connection_type_jn[count_junc] = 0;
-                        if (sc->connection_type_node_yzpp[count] == 1 && sc->connection_type_node_yzpp[sc->geo_index[idx_xp]] == 1)     sc->connection_type_jn[count_junc] = 1;  // connection is transverse
-                        if (sc->connection_type_node_yzpp[count] == 2 && sc->connection_type_node_yzpp[sc->geo_index[idx_xp]] == 2)     sc->connection_type_jn[count_junc] = 2;  // connection is axial
-                        if (sc->connection_type_node_yzpp[count]*sc->connection_type_node_yzpp[sc->geo_index[idx_xp]] == 2)             sc->connection_type_jn[count_junc] = 3;  // connection is mixed (1*2 or 2*1)
+                        if (sc->connection_type_node_yzpp[count] == 1 && sc->connection_type_node_yzpp[SC_geo_index(sc, idx_xp)] == 1)     sc->connection_type_jn[count_junc] = 1;  // connection is transverse
+                        if (sc->connection_type_node_yzpp[count] == 2 && sc->connection_type_node_yzpp[SC_geo_index(sc, idx_xp)] == 2)     sc->connection_type_jn[count_junc] = 2;  // connection is axial
+                        if (sc->connection_type_node_yzpp[count]*sc->connection_type_node_yzpp[SC_geo_index(sc, idx_xp)] == 2)             sc->connection_type_jn[count_junc] = 3;  // connection is mixed (1*2 or 2*1)
 
                         count_junc++;
                     }
                     if (yzpm == true)
                     {
                         sc->jn_map_minus[count_junc]    = count;
-                        sc->jn_map_plus[count_junc]     = sc->geo_index[idx_ym_zp];
-                        sc->gGap_jn[count_junc]        = (sc->gGap_node_yzpm[count] + sc->gGap_node_yzpm[sc->geo_index[idx_ym_zp]])/2; // junction g is average of the two coupled cells
+                        sc->jn_map_plus[count_junc]     = SC_geo_index(sc, idx_ym_zp);
+                        sc->gGap_jn[count_junc]        = (sc->gGap_node_yzpm[count] + sc->gGap_node_yzpm[SC_geo_index(sc, idx_ym_zp)])/2; // junction g is average of the two coupled cells
 
                         sc->connection_type_jn[count_junc] = 0;
-                        if (sc->connection_type_node_yzpm[count] == 1 && sc->connection_type_node_yzpm[sc->geo_index[idx_xp]] == 1)     sc->connection_type_jn[count_junc] = 1;  // connection is transverse
-                        if (sc->connection_type_node_yzpm[count] == 2 && sc->connection_type_node_yzpm[sc->geo_index[idx_xp]] == 2)     sc->connection_type_jn[count_junc] = 2;  // connection is axial
-                        if (sc->connection_type_node_yzpm[count]*sc->connection_type_node_yzpm[sc->geo_index[idx_xp]] == 2)             sc->connection_type_jn[count_junc] = 3;  // connection is mixed (1*2 or 2*1)
+                        if (sc->connection_type_node_yzpm[count] == 1 && sc->connection_type_node_yzpm[SC_geo_index(sc, idx_xp)] == 1)     sc->connection_type_jn[count_junc] = 1;  // connection is transverse
+                        if (sc->connection_type_node_yzpm[count] == 2 && sc->connection_type_node_yzpm[SC_geo_index(sc, idx_xp)] == 2)     sc->connection_type_jn[count_junc] = 2;  // connection is axial
+                        if (sc->connection_type_node_yzpm[count]*sc->connection_type_node_yzpm[SC_geo_index(sc, idx_xp)] == 2)             sc->connection_type_jn[count_junc] = 3;  // connection is mixed (1*2 or 2*1)
 
                         count_junc++;
                     }
@@ -2306,13 +2522,13 @@ void set_gjunc_and_junc_maps(SC_variables *sc, const char* Output_dir, Tissue_pa
                     if (xyzppp == true)
                     {
                         sc->jn_map_minus[count_junc]    = count;
-                        sc->jn_map_plus[count_junc]     = sc->geo_index[idx_xp_yp_zp];
-                        sc->gGap_jn[count_junc]        = (sc->gGap_node_xyzppp[count] + sc->gGap_node_xyzppp[sc->geo_index[idx_xp_yp_zp]])/2; // junction g is average of the two coupled cells
+                        sc->jn_map_plus[count_junc]     = SC_geo_index(sc, idx_xp_yp_zp);
+                        sc->gGap_jn[count_junc]        = (sc->gGap_node_xyzppp[count] + sc->gGap_node_xyzppp[SC_geo_index(sc, idx_xp_yp_zp)])/2; // junction g is average of the two coupled cells
 
                         sc->connection_type_jn[count_junc] = 0;
-                        if (sc->connection_type_node_xyzppp[count] == 1 && sc->connection_type_node_xyzppp[sc->geo_index[idx_xp]] == 1)     sc->connection_type_jn[count_junc] = 1;  // connection is transverse
-                        if (sc->connection_type_node_xyzppp[count] == 2 && sc->connection_type_node_xyzppp[sc->geo_index[idx_xp]] == 2)     sc->connection_type_jn[count_junc] = 2;  // connection is axial
-                        if (sc->connection_type_node_xyzppp[count]*sc->connection_type_node_xyzppp[sc->geo_index[idx_xp]] == 2)             sc->connection_type_jn[count_junc] = 3;  // connection is mixed (1*2 or 2*1)
+                        if (sc->connection_type_node_xyzppp[count] == 1 && sc->connection_type_node_xyzppp[SC_geo_index(sc, idx_xp)] == 1)     sc->connection_type_jn[count_junc] = 1;  // connection is transverse
+                        if (sc->connection_type_node_xyzppp[count] == 2 && sc->connection_type_node_xyzppp[SC_geo_index(sc, idx_xp)] == 2)     sc->connection_type_jn[count_junc] = 2;  // connection is axial
+                        if (sc->connection_type_node_xyzppp[count]*sc->connection_type_node_xyzppp[SC_geo_index(sc, idx_xp)] == 2)             sc->connection_type_jn[count_junc] = 3;  // connection is mixed (1*2 or 2*1)
 
                         count_junc++;
                     }
@@ -2320,13 +2536,13 @@ void set_gjunc_and_junc_maps(SC_variables *sc, const char* Output_dir, Tissue_pa
                     if (xyzppm == true) // ppm = mmp
                     {
                         sc->jn_map_minus[count_junc]    = count;
-                        sc->jn_map_plus[count_junc]     = sc->geo_index[idx_xm_ym_zp];
-                        sc->gGap_jn[count_junc]        = (sc->gGap_node_xyzppm[count] + sc->gGap_node_xyzppm[sc->geo_index[idx_xm_ym_zp]])/2; // junction g is average of the two coupled cells
+                        sc->jn_map_plus[count_junc]     = SC_geo_index(sc, idx_xm_ym_zp);
+                        sc->gGap_jn[count_junc]        = (sc->gGap_node_xyzppm[count] + sc->gGap_node_xyzppm[SC_geo_index(sc, idx_xm_ym_zp)])/2; // junction g is average of the two coupled cells
 
                         sc->connection_type_jn[count_junc] = 0;
-                        if (sc->connection_type_node_xyzppm[count] == 1 && sc->connection_type_node_xyzppm[sc->geo_index[idx_xp]] == 1)     sc->connection_type_jn[count_junc] = 1;  // connection is transverse
-                        if (sc->connection_type_node_xyzppm[count] == 2 && sc->connection_type_node_xyzppm[sc->geo_index[idx_xp]] == 2)     sc->connection_type_jn[count_junc] = 2;  // connection is axial
-                        if (sc->connection_type_node_xyzppm[count]*sc->connection_type_node_xyzppm[sc->geo_index[idx_xp]] == 2)             sc->connection_type_jn[count_junc] = 3;  // connection is mixed (1*2 or 2*1)
+                        if (sc->connection_type_node_xyzppm[count] == 1 && sc->connection_type_node_xyzppm[SC_geo_index(sc, idx_xp)] == 1)     sc->connection_type_jn[count_junc] = 1;  // connection is transverse
+                        if (sc->connection_type_node_xyzppm[count] == 2 && sc->connection_type_node_xyzppm[SC_geo_index(sc, idx_xp)] == 2)     sc->connection_type_jn[count_junc] = 2;  // connection is axial
+                        if (sc->connection_type_node_xyzppm[count]*sc->connection_type_node_xyzppm[SC_geo_index(sc, idx_xp)] == 2)             sc->connection_type_jn[count_junc] = 3;  // connection is mixed (1*2 or 2*1)
 
 
                         count_junc++;
@@ -2334,26 +2550,26 @@ void set_gjunc_and_junc_maps(SC_variables *sc, const char* Output_dir, Tissue_pa
                     if (xyzpmp == true)
                     {
                         sc->jn_map_minus[count_junc]    = count;
-                        sc->jn_map_plus[count_junc]     = sc->geo_index[idx_xp_ym_zp];
-                        sc->gGap_jn[count_junc]        = (sc->gGap_node_xyzpmp[count] + sc->gGap_node_xyzpmp[sc->geo_index[idx_xp_ym_zp]])/2; // junction g is average of the two coupled cells
+                        sc->jn_map_plus[count_junc]     = SC_geo_index(sc, idx_xp_ym_zp);
+                        sc->gGap_jn[count_junc]        = (sc->gGap_node_xyzpmp[count] + sc->gGap_node_xyzpmp[SC_geo_index(sc, idx_xp_ym_zp)])/2; // junction g is average of the two coupled cells
 
                         sc->connection_type_jn[count_junc] = 0;
-                        if (sc->connection_type_node_xyzpmp[count] == 1 && sc->connection_type_node_xyzpmp[sc->geo_index[idx_xp]] == 1)     sc->connection_type_jn[count_junc] = 1;  // connection is transverse
-                        if (sc->connection_type_node_xyzpmp[count] == 2 && sc->connection_type_node_xyzpmp[sc->geo_index[idx_xp]] == 2)     sc->connection_type_jn[count_junc] = 2;  // connection is axial
-                        if (sc->connection_type_node_xyzpmp[count]*sc->connection_type_node_xyzpmp[sc->geo_index[idx_xp]] == 2)             sc->connection_type_jn[count_junc] = 3;  // connection is mixed (1*2 or 2*1)
+                        if (sc->connection_type_node_xyzpmp[count] == 1 && sc->connection_type_node_xyzpmp[SC_geo_index(sc, idx_xp)] == 1)     sc->connection_type_jn[count_junc] = 1;  // connection is transverse
+                        if (sc->connection_type_node_xyzpmp[count] == 2 && sc->connection_type_node_xyzpmp[SC_geo_index(sc, idx_xp)] == 2)     sc->connection_type_jn[count_junc] = 2;  // connection is axial
+                        if (sc->connection_type_node_xyzpmp[count]*sc->connection_type_node_xyzpmp[SC_geo_index(sc, idx_xp)] == 2)             sc->connection_type_jn[count_junc] = 3;  // connection is mixed (1*2 or 2*1)
 
                         count_junc++;
                     }
                     if (xyzmpp == true)
                     {
                         sc->jn_map_minus[count_junc]    = count;
-                        sc->jn_map_plus[count_junc]     = sc->geo_index[idx_xm_yp_zp];
-                        sc->gGap_jn[count_junc]        = (sc->gGap_node_xyzmpp[count] + sc->gGap_node_xyzmpp[sc->geo_index[idx_xm_yp_zp]])/2; // junction g is average of the two coupled cells
+                        sc->jn_map_plus[count_junc]     = SC_geo_index(sc, idx_xm_yp_zp);
+                        sc->gGap_jn[count_junc]        = (sc->gGap_node_xyzmpp[count] + sc->gGap_node_xyzmpp[SC_geo_index(sc, idx_xm_yp_zp)])/2; // junction g is average of the two coupled cells
 
                         sc->connection_type_jn[count_junc] = 0;
-                        if (sc->connection_type_node_xyzmpp[count] == 1 && sc->connection_type_node_xyzmpp[sc->geo_index[idx_xp]] == 1)     sc->connection_type_jn[count_junc] = 1;  // connection is transverse
-                        if (sc->connection_type_node_xyzmpp[count] == 2 && sc->connection_type_node_xyzmpp[sc->geo_index[idx_xp]] == 2)     sc->connection_type_jn[count_junc] = 2;  // connection is axial
-                        if (sc->connection_type_node_xyzmpp[count]*sc->connection_type_node_xyzmpp[sc->geo_index[idx_xp]] == 2)             sc->connection_type_jn[count_junc] = 3;  // connection is mixed (1*2 or 2*1)
+                        if (sc->connection_type_node_xyzmpp[count] == 1 && sc->connection_type_node_xyzmpp[SC_geo_index(sc, idx_xp)] == 1)     sc->connection_type_jn[count_junc] = 1;  // connection is transverse
+                        if (sc->connection_type_node_xyzmpp[count] == 2 && sc->connection_type_node_xyzmpp[SC_geo_index(sc, idx_xp)] == 2)     sc->connection_type_jn[count_junc] = 2;  // connection is axial
+                        if (sc->connection_type_node_xyzmpp[count]*sc->connection_type_node_xyzmpp[SC_geo_index(sc, idx_xp)] == 2)             sc->connection_type_jn[count_junc] = 3;  // connection is mixed (1*2 or 2*1)
 
                         count_junc++;
                     }
@@ -2664,7 +2880,7 @@ void output_junc_maps(SC_variables *sc, const char* Output_dir, Tissue_parameter
                 idx_xp_ym_zp = (i+1) + (sc->NX * (j-1)) + (sc->NX * sc->NY * (k+1));
                 idx_xp_yp_zp = (i+1) + (sc->NX * (j+1)) + (sc->NX * sc->NY * (k+1));
 
-                if (sc->geo[idx] > 0) // if it is an actual cell/node
+                if (SC_geo(sc, idx) > 0) // if it is an actual cell/node
                 {
                     xx      = false;
                     yy      = false;
@@ -2681,20 +2897,20 @@ void output_junc_maps(SC_variables *sc, const char* Output_dir, Tissue_parameter
                     xyzmpp  = false;
 
                     // if this positive neighbour exists, set junction to true
-                    if (i < sc->NX-1 &&                     sc->geo[idx_xp] > 0)    xx      = true;
-                    if (j < sc->NY-1 &&                     sc->geo[idx_yp] > 0)    yy      = true;
-                    if (k < sc->NZ-1 &&                     sc->geo[idx_zp] > 0)    zz      = true;
-                    if (i < sc->NX-1 && j < sc->NY-1 &&     sc->geo[idx_xp_yp] > 0) xypp    = true;
-                    if (i > 0        && j < sc->NY-1 &&     sc->geo[idx_xm_yp] > 0) xypm    = true;
-                    if (i < sc->NX-1 && k < sc->NZ-1 &&     sc->geo[idx_xp_zp] > 0) xzpp    = true;
-                    if (i > 0        && k < sc->NZ-1 &&     sc->geo[idx_xm_zp] > 0) xzpm    = true;
-                    if (j < sc->NY-1 && k < sc->NZ-1 &&     sc->geo[idx_yp_zp] > 0) yzpp    = true;
-                    if (j > 0        && k < sc->NZ-1 &&     sc->geo[idx_ym_zp] > 0) yzpm    = true;
-
-                    if (i < sc->NX-1 && j < sc->NY-1 && k < sc->NZ-1 && sc->geo[idx_xp_yp_zp] > 0)  xyzppp = true;
-                    if (i > 0        && j < sc->NY-1 && k < sc->NZ-1 && sc->geo[idx_xm_yp_zp] > 0)  xyzmpp = true;
-                    if (i < sc->NX-1 && j > 0        && k < sc->NZ-1 && sc->geo[idx_xp_ym_zp] > 0)  xyzpmp = true;
-                    if (i > 0        && j > 0        && k < sc->NZ-1 && sc->geo[idx_xm_ym_zp] > 0)  xyzppm = true;
+                    if (i < sc->NX-1 &&                     SC_geo(sc, idx_xp) > 0)    xx      = true;
+                    if (j < sc->NY-1 &&                     SC_geo(sc, idx_yp) > 0)    yy      = true;
+                    if (k < sc->NZ-1 &&                     SC_geo(sc, idx_zp) > 0)    zz      = true;
+                    if (i < sc->NX-1 && j < sc->NY-1 &&     SC_geo(sc, idx_xp_yp) > 0) xypp    = true;
+                    if (i > 0        && j < sc->NY-1 &&     SC_geo(sc, idx_xm_yp) > 0) xypm    = true;
+                    if (i < sc->NX-1 && k < sc->NZ-1 &&     SC_geo(sc, idx_xp_zp) > 0) xzpp    = true;
+                    if (i > 0        && k < sc->NZ-1 &&     SC_geo(sc, idx_xm_zp) > 0) xzpm    = true;
+                    if (j < sc->NY-1 && k < sc->NZ-1 &&     SC_geo(sc, idx_yp_zp) > 0) yzpp    = true;
+                    if (j > 0        && k < sc->NZ-1 &&     SC_geo(sc, idx_ym_zp) > 0) yzpm    = true;
+
+                    if (i < sc->NX-1 && j < sc->NY-1 && k < sc->NZ-1 && SC_geo(sc, idx_xp_yp_zp) > 0)  xyzppp = true;
+                    if (i > 0        && j < sc->NY-1 && k < sc->NZ-1 && SC_geo(sc, idx_xm_yp_zp) > 0)  xyzmpp = true;
+                    if (i < sc->NX-1 && j > 0        && k < sc->NZ-1 && SC_geo(sc, idx_xp_ym_zp) > 0)  xyzpmp = true;
+                    if (i > 0        && j > 0        && k < sc->NZ-1 && SC_geo(sc, idx_xm_ym_zp) > 0)  xyzppm = true;
 
                     // Unset junctions if regions should not be electrically coupled
                     if (t->disconnect_regions_flag == true)
@@ -2703,31 +2919,31 @@ void output_junc_maps(SC_variables *sc, const char* Output_dir, Tissue_parameter
                         {
                             // if current cell is region 1 and neighbour region 2, or current cell is reg 2 and nei reg 1, uncouple by setting that junction flag back to false
                             if (i < sc->NX-1)
-                                if( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xp] == t->disconnect_regions[DN][0]) ) xx = false;
+                                if( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xp) == t->disconnect_regions[DN][0]) ) xx = false;
                             if (j < sc->NY-1)
-                                if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_yp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_yp] == t->disconnect_regions[DN][0]) ) yy = false;
+                                if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_yp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_yp) == t->disconnect_regions[DN][0]) ) yy = false;
                             if (k < sc->NZ-1)
-                                if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_zp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_zp] == t->disconnect_regions[DN][0]) ) zz = false;
+                                if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_zp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_zp) == t->disconnect_regions[DN][0]) ) zz = false;
                             if (i < sc->NX-1 && j < sc->NY-1)
-                                if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xp_yp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xp_yp] == t->disconnect_regions[DN][0]) ) xypp = false;
+                                if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xp_yp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xp_yp) == t->disconnect_regions[DN][0]) ) xypp = false;
                             if (i > 0 && j < sc->NY-1)
-                                if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xm_yp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xm_yp] == t->disconnect_regions[DN][0]) ) xypm = false;
+                                if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xm_yp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xm_yp) == t->disconnect_regions[DN][0]) ) xypm = false;
                             if (i < sc->NX-1 && k < sc->NZ-1)
-                                if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xp_zp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xp_zp] == t->disconnect_regions[DN][0]) ) xzpp = false;
+                                if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xp_zp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xp_zp) == t->disconnect_regions[DN][0]) ) xzpp = false;
                             if (i > 0 && k < sc->NZ-1)
-                                if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xm_zp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xm_zp] == t->disconnect_regions[DN][0]) ) xzpm = false;
+                                if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xm_zp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xm_zp) == t->disconnect_regions[DN][0]) ) xzpm = false;
                             if (j < sc->NY-1 && k < sc->NZ-1)
-                                if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_yp_zp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_yp_zp] == t->disconnect_regions[DN][0]) ) yzpp = false;
+                                if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_yp_zp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_yp_zp) == t->disconnect_regions[DN][0]) ) yzpp = false;
                             if (j > 0 && k < sc->NZ-1)
-                                if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_ym_zp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_ym_zp] == t->disconnect_regions[DN][0]) ) yzpm = false;
+                                if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_ym_zp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_ym_zp) == t->disconnect_regions[DN][0]) ) yzpm = false;
                             if (i < sc->NX-1 && j < sc->NY-1 && k < sc->NZ-1)
-                                if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xp_yp_zp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xp_yp_zp] == t->disconnect_regions[DN][0]) ) xyzppp = false;
+                                if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xp_yp_zp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xp_yp_zp) == t->disconnect_regions[DN][0]) ) xyzppp = false;
                             if (i > 0 && j < sc->NY-1 && k < sc->NZ-1)
-                                if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xm_yp_zp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xm_yp_zp] == t->disconnect_regions[DN][0]) ) xyzmpp = false;
+                                if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xm_yp_zp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xm_yp_zp) == t->disconnect_regions[DN][0]) ) xyzmpp = false;
                             if (i < sc->NX-1 && j > 0 && k < sc->NZ-1)
-                                if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xp_ym_zp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xp_ym_zp] == t->disconnect_regions[DN][0]) ) xyzpmp = false;
+                                if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xp_ym_zp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xp_ym_zp) == t->disconnect_regions[DN][0]) ) xyzpmp = false;
                             if (i > 0 && j > 0 && k < sc->NZ-1)
-                                if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xm_ym_zp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xm_ym_zp] == t->disconnect_regions[DN][0]) ) xyzppm = false;
+                                if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xm_ym_zp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xm_ym_zp) == t->disconnect_regions[DN][0]) ) xyzppm = false;
                         } // end DN for
                     } // end disconnect uncoupled regions
 
@@ -76,14 +76,51 @@
 #include <math.h>
 
 
+// Bricked geometry (see SC_variables) ==========================================================\\|
+#define SC_BRICK            8       // voxels per brick edge
+#define SC_BRICK_VOLUME     512
+
+// Storage slot (-1 = no tissue) and offset within the brick of 3D index idx
+static inline int SC_brick_offset(const SC_variables *sc, int idx, int *slot)
+{
+	int i = idx % sc->NX;
+	int j = (idx / sc->NX) % sc->NY;
+	int k = idx / (sc->NX*sc->NY);
+	*slot = sc->brick[(i/SC_BRICK) + sc->BX*((j/SC_BRICK) + sc->BY*(k/SC_BRICK))];
+	return (i%SC_BRICK) + SC_BRICK*((j%SC_BRICK) + SC_BRICK*(k%SC_BRICK));
+}
+
+// Celltype at 3D index idx (0 = empty space) || replaces geo[idx]
+static inline int SC_geo(const SC_variables *sc, int idx)
+{
+	int slot, offset = SC_brick_offset(sc, idx, &slot);
+	return (slot < 0) ? 0 : sc->brick_geo[slot*SC_BRICK_VOLUME + offset];
+}
+
+// 1D cell index at 3D index idx (-1 = empty space) || replaces geo_index[idx]
+static inline int SC_geo_index(const SC_variables *sc, int idx)
+{
+	int slot, offset = SC_brick_offset(sc, idx, &slot);
+	return (slot < 0) ? -1 : sc->brick_index[slot*SC_BRICK_VOLUME + offset];
+}
+
+void SC_set_geo(SC_variables *sc, int idx, int celltype);   // allocates the brick on its first tissue voxel
+void SC_set_geo_index(SC_variables *sc, int idx, int n);
+int  SC_brick_allocate(SC_variables *sc, int b);            // returns storage slot of brick b
+void SC_brick_reserve(SC_variables *sc, int Nbricks);
+// End Bricked geometry =========================================================================//|
+
 // Array sizes and allocation/deallocation
 void SC_set_array_sizes(SC_variables *sc, int NX, int NY, int NZ);
 void SC_array_allocation_N3(SC_variables *sc, int NX, int NY, int NZ);
 void SC_array_allocation_Ncell(SC_variables *sc, int Ncell);
 void SC_array_deallocation(SC_variables *sc);
+double SC_release_setup_arrays(SC_variables *sc, const char *run_operator); // "FDM", "laplacian" or "network"; returns bytes released
+void SC_memory_report(double released_bytes);
 
 // Read files | returns Ncells or NMap
-int read_geo_file(SC_variables *sc, int *geo, const char * filein, const char * fileroot, const char *PATH, const char* Output_dir, const char * ref, int Ncelltypes);
+int read_geo_file(SC_variables *sc, const char * filein, const char * fileroot, const char *PATH, const char* Output_dir, const char * ref, int Ncelltypes, bool diagnostics);
+void geometry_vtk_output(SC_variables *sc, const char* Output_dir, const char * ref, int Ncelltypes, bool diagnostics); // Geometry_<ref>.vtk
 int read_map_file(SC_variables sc, int *map, const char *filein, const char * fileroot, const char *PATH, const char* Output_dir, const char * ref);
 int read_map_file_double(SC_variables sc, double *map, const char *filein, const char * fileroot, const char *PATH, const char* Output_dir, const char * ref);
 
@@ -76,6 +76,7 @@
 // Function list ================================================================================\\|
 //	Defaults and setup
 //	    set_SRF_defaults()
+//	    set_SRF_mode()
 //	    SRF_setup()
 //	    SRF_tissue_heterogeneity()
 //	
@@ -182,6 +183,23 @@ void set_SRF_defaults(Spontaneous_release_functions *srf, Argument_parameters A)
 	if (strcmp(srf->Mode, "Dynamic") == 0 && strcmp(srf->Model, "General") == 0 && A.SRF_het_arg == true) srf->SRF_het = A.SRF_het;
 
     if (A.write_SRF_arg == true) srf->write_SRF_settings = A.write_SRF_settings;
+
+	// Identifiers for the per-step functions
+	set_SRF_mode(srf, srf->Mode);
+	if (strcmp(srf->Model, "3D_cell") == 0)			srf->Model_id = SRF_MODEL_3D_CELL;
+	else if (strcmp(srf->Model, "General") == 0)	srf->Model_id = SRF_MODEL_GENERAL;
+	else 											srf->Model_id = -1;
+}
+
+// Set Mode and its identifier (SRF_X, lib/Structs.h) together; Mode_id is what set_and_run_SRF() uses
+void set_SRF_mode(Spontaneous_release_functions *srf, const char *Mode)
+{
+	srf->Mode	= Mode;
+	if (strcmp(Mode, "Off") == 0)					srf->Mode_id = SRF_OFF;
+	else if (strcmp(Mode, "Direct_Control") == 0)	srf->Mode_id = SRF_DIRECT_CONTROL;
+	else if (strcmp(Mode, "Dynamic") == 0)			srf->Mode_id = SRF_DYNAMIC;
+	else if (strcmp(Mode, "Read") == 0)				srf->Mode_id = SRF_READ;
+	else 											srf->Mode_id = -1; // not valid; SRF_setup() reports
 }
 
 // Call apprpriate set parameters function
@@ -674,7 +692,7 @@ void determine_SRF_dynamic_general_duration_dist_widths(Spontaneous_release_func
 // Function select function
 void determine_SRF_params_from_CaSR(Spontaneous_release_functions *srf, double CaSR)
 {
-	if (strcmp(srf->Model, "3D_cell") == 0)
+	if (srf->Model_id == SRF_MODEL_3D_CELL)
 	{
 		determine_SRF_3D_cell_ti_sep(srf, CaSR-0.05);		// shift of 0.05 gives better fit for paced (vs Ca clamp on which derived)
 		determine_SRF_3D_cell_ti_dist_widths(srf, CaSR-0.05);
@@ -704,10 +722,10 @@ void need_to_recalculate(Spontaneous_release_functions *srf, double CaSR, double
 
 // run SRF functions ========================================================\\|
 // Set params and switches ====================\\|
-void set_and_run_SRF(Spontaneous_release_functions *srf, Dyad_variables *d, const char * Mode, RAND *rand, int ex_switch, double sim_time, double CaJSR)
+void set_and_run_SRF(Spontaneous_release_functions *srf, Dyad_variables *d, int Mode_id, RAND *rand, int ex_switch, double sim_time, double CaJSR)
 {
 	// Direct_Control model ================\\|
-	if (strcmp(Mode, "Direct_Control") == 0)
+	if (Mode_id == SRF_DIRECT_CONTROL)
 	{
 		if (srf->srf_set == 0) // if ready to be set
 		{
@@ -727,7 +745,7 @@ void set_and_run_SRF(Spontaneous_release_functions *srf, Dyad_variables *d, cons
 	} 
 	// end Direct_Control model ============//|
 	// Dynamic model ================\\|
-	else if (strcmp(Mode, "Dynamic") == 0)
+	else if (Mode_id == SRF_DYNAMIC)
 	{
 		if (srf->srf_set == 1 && ex_switch == 1)	// if it has been set, but cell is currently in excitation state (could be spont AP)
 		{
@@ -740,8 +758,8 @@ void set_and_run_SRF(Spontaneous_release_functions *srf, Dyad_variables *d, cons
 			srf->CaSR_t_calc	= CaJSR;			// set the CaSR_t_calc to current CaJSR
 			srf->rand[0] = rand->mtrand1();
 			// Set the probability of SCRE from CaSR
-			if (strcmp(srf->Model, "3D_cell") == 0)			determine_SRF_3D_cell_PSCR(srf, 1e-3*CaJSR); 	// CaSR in mM
-			else if (strcmp(srf->Model, "General") == 0)	determine_SRF_dynamic_general_PSCR(srf, 1e-3*CaJSR);
+			if (srf->Model_id == SRF_MODEL_3D_CELL)			determine_SRF_3D_cell_PSCR(srf, 1e-3*CaJSR); 	// CaSR in mM
+			else if (srf->Model_id == SRF_MODEL_GENERAL)	determine_SRF_dynamic_general_PSCR(srf, 1e-3*CaJSR);
 			if (srf->rand[0] < srf->PSCRE)	// Only need to produce other rands if event will happen
 			{
 				srf->srf_calc   =   1;
@@ -758,7 +776,7 @@ void set_and_run_SRF(Spontaneous_release_functions *srf, Dyad_variables *d, cons
 		if (srf->srf_set == -1 && d->Mi < 0.2 && ex_switch == 0) srf->srf_set = 0;  // if recovered and not in excitation mode, prepare to be set again
 		if (srf->srf_set == -2) need_to_recalculate(srf, CaJSR, srf->recalc_SR_diff /*micro M*/,  srf->NRyRo);   // if CaSR has changed by more than threshold since set, re-set
 	}
-    else if (strcmp(Mode, "Read") == 0)
+    else if (Mode_id == SRF_READ)
     {
         run_SRF(srf, d, sim_time); // if read, only need to run, as parameters have already been set directly from the file read in
     }
@@ -853,7 +871,8 @@ void run_SRF(Spontaneous_release_functions *srf, Dyad_variables *d, double sim_t
 }
 
 // Print SRF properties to file
-void print_SRF_properties_to_file(Spontaneous_release_functions *srf, std::ostream& out, int n)
+// Returns the number of rows written (0 or 1)
+int print_SRF_properties_to_file(Spontaneous_release_functions *srf, std::ostream& out, int n)
 {
     if (srf->init_write_flag == true)
     {
@@ -866,7 +885,9 @@ void print_SRF_properties_to_file(Spontaneous_release_functions *srf, std::ostre
             << " " << srf->thalf_plateau_1 << " " << srf->thalf_plateau_2 << " " << srf->k1_plateau << " " << srf->k2_plateau << std::endl;
 
         srf->init_write_flag = false; // has been written so no longer needs to be
+        return 1;
     }
+    return 0;
 }
 
 // Read SRF settings from a file for reproducing given simulations
@@ -911,7 +932,7 @@ void read_SRF_settings_from_file(Spontaneous_release_functions *srf, const char
             srf[n].k1_plateau       = k1_plateau;
             srf[n].k2_plateau       = k2_plateau;
 
-            srf[n].Mode             = "Read"; // and set mode to read for node n
+            set_SRF_mode(&srf[n], "Read"); // and set mode to read for node n
         }
 
         // note that this node has now had its parameters set
@@ -72,6 +72,7 @@
 
 // Defaults and setup
 void set_SRF_defaults(Spontaneous_release_functions *srf, Argument_parameters A);
+void set_SRF_mode(Spontaneous_release_functions *srf, const char *Mode);
 void SRF_tissue_heterogeneity(Spontaneous_release_functions *srf, double rand);
 void SRF_setup(Spontaneous_release_functions *srf, Argument_parameters A);
 
@@ -98,9 +99,9 @@ void determine_SRF_params_from_CaSR(Spontaneous_release_functions *srf, double C
 void need_to_recalculate(Spontaneous_release_functions *srf, double CaSR, double threshold, double NRyR);
 
 // Set and run
-void set_and_run_SRF(Spontaneous_release_functions *srf, Dyad_variables *d, const char * Mode, RAND *rand, int ex_switch, double sim_time, double CaJSR);
+void set_and_run_SRF(Spontaneous_release_functions *srf, Dyad_variables *d, int Mode_id, RAND *rand, int ex_switch, double sim_time, double CaJSR);
 void run_SRF(Spontaneous_release_functions *srf, Dyad_variables *d, double sim_time);
-void print_SRF_properties_to_file(Spontaneous_release_functions *srf, std::ostream& out, int n);
+int print_SRF_properties_to_file(Spontaneous_release_functions *srf, std::ostream& out, int n);
 void calc_SRF_mults(Spontaneous_release_functions *srf, Membrane_fluxes *mem, Dyad_variables *dyad);
 
 // Read
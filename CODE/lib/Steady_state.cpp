@@ -0,0 +1,222 @@
+// Source code associated with  ===========================  //
+// "Multi-scale cardiac simulation framework" =============  //
+// For simulation of cardiac cellular and tissue dynamics =  //
+// from the spatial cellular to full organ scales. ========  //
+// With implementation of multiple, published cell models =  //
+// as well as novel models developed in my lab. ===========  //
+// ========================================================  //
+// This file: Steady-state (convergence) ==================  //
+// detection during pacing ================================  //
+// ========================================================  //
+// GNU 3 LICENSE TEXT =====================================  //
+// COPYRIGHT (C) 2016-2019 MICHAEL A. COLMAN ==============  //
+// THIS PROGRAM IS FREE SOFTWARE: YOU CAN REDISTRIBUTE IT =  //
+// AND/OR MODIFY IT UNDER THE TERMS OF THE GNU GENERAL ====  //
+// PUBLIC LICENSE AS PUBLISHED BY THE FREE SOFTWARE =======  //
+// FOUNDATION, EITHER VERSION 3 OF THE LICENSE, OR (AT YOUR  //
+// OPTION) ANY LATER VERSION. =============================  //
+// THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE=  //
+// USEFUL, BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE =====  //
+// IMPLIED WARRANTY OF MERCHANTABILITY OR FITNESS FOR A ===  //
+// PARTICULAR PURPOSE.  SEE THE GNU GENERAL PUBLIC LICENSE=  //
+// FOR MORE DETAILS. ======================================  //
+// YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL =====  //
+// PUBLIC LICENSE ALONG WITH THIS PROGRAM.  IF NOT, SEE ===  //
+// <https://www.gnu.org/licenses/>. =======================  //
+// ========================================================  //
+// ADDITIONAL LICENSE TEXT ================================  //
+// THIS SOFTWARE IS PROVIDED OPEN SOURCE AND MAY BE FREELY=  //
+// USED, DISTRIBUTED AND UPDATED, PROVIDED: ===============  //
+//  (i) THE APPROPRIATE WORK(S) IS(ARE) CITED. THIS =======  //
+//      PERTAINS TO THE CITATION OF COLMAN 2019 PLOS COMP =  //
+//      BIOL (FOR THIS IMPLEMTATION) AND ALL WORKS ========  //
+//      ASSOCIATED WITH THE SPECIFIC MODELS AND COMPONENTS=  //
+//      USED IN PARTICULAR SIMULATIONS. IT IS THE USER'S ==  //
+//      RESPONSIBILITY TO ENSURE ALL RELEVANT WORKS ARE ===  //
+//      CITED. PLEASE SEE FULL DOCUMENTATION AND ON-SCREEN=  //
+//      DISCLAIMER OUTPUTS FOR A GUIDE. ===================  //
+//  (ii) ALL OF THIS TEXT IS RETAINED WITHIN OR ASSOCIATED=  //
+//      WITH THE SOURCE CODE AND/OR BINARY FORM OF THE ====  //
+//      SOFTWARE. =========================================  //
+// ========================================================  //
+// ANY INTENDED COMMERCIAL USE OF THIS SOFTWARE MUST BE BY   //
+// EXPRESS PERMISSION OF MICHAEL A COLMAN ONLY. IN NO EVENT  //
+// ARE THE COPYRIGHT HOLDERS LIABLE FOR ANY DIRECT, =======  //
+// INDIRECT INCIDENTAL, SPECIAL, EXEMPLARY OR CONSEQUENTIAL  //
+// DAMAGES ASSOCIATED WITH USE OF THIS SOFTWARE ===========  //
+// ========================================================  //
+// THIS SOFTWARE CONTAINS IMPLEMENTATIONS OF MODELS AND ===  //
+// COMPONENTS WHICH I (MICHAEL COLMAN) DID NOT DEVELOP.====  //
+// ALL OF THESE COMPONENTS HAVE BEEN CODED FROM PROVIDED ==  //
+// SOURCE CODE OR INFORMATION IN THE PUBLICATIONS. ========  //
+// I CLAIM NO RIGHTS OR INTELLECTUAL PROPERTY OWNERSHIP ===  //
+// FOR THESE MODELS AND COMPONENTS, OTHER THAN THEIR ======  //
+// SPECIFIC IMPLEMENTATION IN THIS CODE PACKAGE. FURTHER TO  //
+// THE ABOVE STATEMENT, ANY INDTENDED COMMERCIAL USE OF ===  //
+// THOSE COMPONENTS MUST BE BY EXPRESS PERMISSION OF THE ==  //
+// ORIGINAL COPYRIGHT HOLDERS. ============================  //
+// WHERE IMPLEMENTED FROM PROVIDED CODE, ANY DISCLAIMERS ==  //
+// PRESENT IN THE ORIGINAL CODE HAVE BEEN RETAINED IN THE =  //
+// RELEVANT FILE. =========================================  //
+// ========================================================  //
+// Contact: m.a.colman@leeds.ac.uk ========================  //
+// For updates, corrections etc, please check: ============  //
+// 1. http://physicsoftheheart.com/ =======================  //
+// 2. https://github.com/michaelcolman ====================  //
+// ========================================================  //
+
+#include "Steady_state.h"
+#include "Structs.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// Function list ================================================================================\\|
+//	steady_state_init()
+//	steady_state_reached()
+//	steady_state_finalise()
+//
+//	Internal
+//	    steady_state_measure()
+// End Function list ============================================================================//|
+
+// Notes ========================================================================================\\|
+// Pre-pacing runs for a fixed number of beats (e.g. Beats 200 before Write_state); most models 
+// converge far earlier. At the start of each paced beat the properties of the beat just completed
+// are compared with those of the beat before: APD90, CaT amplitude (CaT_max - CaT_min), and [Na]i 
+// and [Ca]SR at the time of the stimulus. Changes are relative to the previous beat and, in tissue,
+// the maximum over all cells. Once all four are within Steady_state_tol_X for Steady_state_beats 
+// consecutive beats, steady_state_reached() returns true and the main ends the time loop there: 
+// the state is then at the same point of the cycle as at the end of a full-length native run 
+// (start of the next beat), so Write_state writes it as usual.
+// Beat-by-beat changes are written to Steady_state_log.dat. Checks happen only during S1 pacing
+// (S2 is not allowed); after a restart from a checkpoint the comparison starts again from the 
+// first beat completed after the restart.
+// End Notes ====================================================================================//|
+
+// Internal =====================================================================================\\|
+// Beat values of cell n: APD90, CaT amplitude, Nai, CaSR
+static void steady_state_measure(Model_variables *var, State_variables *s, double *x)
+{
+	x[0] = var->APD_p[8];
+	x[1] = var->CaT_max - var->CaT_min;
+	x[2] = s->Nai;
+	x[3] = s->CanSR;
+}
+// End Internal =================================================================================//|
+
+// Setup ========================================================================================\\|
+void steady_state_init(Steady_state *ss, Simulation_parameters sim, int N, const char *directory)
+{
+	memset(ss, 0, sizeof(Steady_state));
+	if (strcmp(sim.Steady_state, "On") != 0) return;
+
+	if (sim.S2_CL > 0)
+	{
+		printf("ERROR: Steady_state ends pacing early and cannot be combined with S2; pre-pace and write state first, then read state for the S1-S2 protocol\n");
+		exit(1);
+	}
+	if (strcmp(sim.S2_sweep, "Off") != 0)
+	{
+		printf("ERROR: Steady_state cannot be combined with S2_sweep; pre-pace and write state first, then read state for the sweep\n");
+		exit(1);
+	}
+	if (strcmp(sim.Write_state, "phase") == 0)
+	{
+		printf("ERROR: Steady_state cannot be combined with Write_state phase (phase files are written during the final beat)\n");
+		exit(1);
+	}
+
+	ss->on          = true;
+	ss->N           = N;
+	ss->K           = sim.Steady_state_beats;
+	ss->tol[0]      = 0.01*sim.Steady_state_tol_APD90;
+	ss->tol[1]      = 0.01*sim.Steady_state_tol_CaT;
+	ss->tol[2]      = 0.01*sim.Steady_state_tol_Nai;
+	ss->tol[3]      = 0.01*sim.Steady_state_tol_CaSR;
+	ss->BCL_int     = (int)(sim.BCL/sim.dt + 0.5);
+	ss->Paced_int   = (int)(sim.Paced_time/sim.dt + 0.5);
+	ss->prev        = (double*)malloc(SS_NMEASURES*N*sizeof(double));
+
+	ss->log         = NULL;     // no log if directory is NULL (e.g. once per BCL in lib/Restitution.cpp)
+	if (directory != NULL)
+	{
+		char *filename  = (char*)malloc(1000);
+		if (sim.Windows == true)    sprintf(filename, "%s\\Steady_state_log.dat", directory);
+		else                        sprintf(filename, "%s/Steady_state_log.dat", directory);
+		ss->log         = fopen(filename, "wt");
+		if (ss->log == NULL)
+		{
+			printf("ERROR: cannot open %s\n", filename);
+			exit(1);
+		}
+		fprintf(ss->log, "# beat time(ms) | max relative change from previous beat (%%): APD90 CaT_amplitude Nai CaSR | consecutive beats within tolerance\n");
+		free(filename);
+	}
+
+	printf("Steady state detection: pacing ends once APD90, CaT amplitude, Nai and CaSR change by less than %g, %g, %g, %g %% for %d consecutive beats\n", 
+		sim.Steady_state_tol_APD90, sim.Steady_state_tol_CaT, sim.Steady_state_tol_Nai, sim.Steady_state_tol_CaSR, ss->K);
+}
+// End Setup ====================================================================================//|
+
+// Check ========================================================================================\\|
+// Called at the start of each step, before compute_Istim(); acts only on the step of a paced 
+// stimulus, when var[n] holds the measurements of the beat just completed
+bool steady_state_reached(Steady_state *ss, Model_variables *var, State_variables *s, int iteration_counter, double sim_time)
+{
+	if (ss->on == false || ss->converged_beat > 0) return false;
+	if (iteration_counter == 0 || iteration_counter % ss->BCL_int != 0 || iteration_counter > ss->Paced_int) return false;
+
+	double x[SS_NMEASURES];
+	for (int m = 0; m < SS_NMEASURES; m++) ss->change[m] = 0;
+
+	for (int n = 0; n < ss->N; n++)
+	{
+		steady_state_measure(&var[n], &s[n], x);
+		double *prev = &ss->prev[SS_NMEASURES*n];
+		for (int m = 0; m < SS_NMEASURES; m++)
+		{
+			if (ss->beat > 0)
+			{
+				double d = fabs(x[m] - prev[m]);
+				if (prev[m] != 0) d /= fabs(prev[m]);
+				if (d > ss->change[m]) ss->change[m] = d;
+			}
+			prev[m] = x[m];
+		}
+	}
+	ss->beat++;
+	if (ss->beat < 2) return false;
+
+	bool within = true;
+	for (int m = 0; m < SS_NMEASURES; m++) if (ss->change[m] > ss->tol[m]) within = false;
+	ss->Nconverged = (within == true) ? ss->Nconverged + 1 : 0;
+
+	if (ss->log != NULL) fprintf(ss->log, "%d %.2f %e %e %e %e %d\n", ss->beat, sim_time, 100*ss->change[0], 100*ss->change[1], 100*ss->change[2], 100*ss->change[3], ss->Nconverged);
+
+	if (ss->Nconverged < ss->K) return false;
+	ss->converged_beat  = ss->beat;
+	ss->converged_time  = sim_time;
+	printf("Steady state reached after beat %d (t = %.0f ms): changes APD90 %.3g%%, CaT amplitude %.3g%%, Nai %.3g%%, CaSR %.3g%% for %d consecutive beats; pacing ended\n",
+		ss->beat, sim_time, 100*ss->change[0], 100*ss->change[1], 100*ss->change[2], 100*ss->change[3], ss->K);
+	return true;
+}
+// End Check ====================================================================================//|
+
+// Finalise =====================================================================================\\|
+void steady_state_finalise(Steady_state *ss)
+{
+	if (ss->on == false) return;
+	if (ss->converged_beat == 0) printf("WARNING: steady state not reached within %d beats (last changes APD90 %.3g%%, CaT amplitude %.3g%%, Nai %.3g%%, CaSR %.3g%%)\n",
+			ss->beat, 100*ss->change[0], 100*ss->change[1], 100*ss->change[2], 100*ss->change[3]);
+	if (ss->log != NULL)
+	{
+		if (ss->converged_beat > 0) fprintf(ss->log, "# steady state reached after beat %d (t = %.2f ms)\n", ss->converged_beat, ss->converged_time);
+		else                        fprintf(ss->log, "# steady state not reached within %d beats\n", ss->beat);
+		fclose(ss->log);
+	}
+	free(ss->prev);
+	ss->on = false;
+}
+// End Finalise =================================================================================//|
@@ -100,6 +100,7 @@ typedef struct{
 	// Simulation conditions
 	char const	*Vclamp;		// "On" or "Off"
 	char const	*Write_state;	// "On" or "Off"
+	bool		Write_state_phase;	// Write_state == "phase" || set in set_simulation_settings()
 	char const 	*Read_state; 	// "On" or "Off"
 
 	// Interval to output spatial files
@@ -107,9 +108,97 @@ typedef struct{
 	int Spatial_output_interval_data;	// ms // for array
     int Spatial_output_start_time;      // lower bound of time to output spatial data
     int Spatial_output_end_time;        // upper bound of time to output spatial data
+    char const *Spatial_output_async;   // "On" or "Off" - write spatial outputs from background threads
+    int Spatial_output_writers;         // N background writer threads
+    int Spatial_output_buffers;         // N snapshot buffers (max queued outputs before the time loop waits)
+    char const *Spatial_output_vtk_format;  // "legacy" (ASCII .vtk), "vti" (binary full box) or "vtu" (binary real cells only)
+    char const *Spatial_output_precision;   // "float" or "double" (vti/vtu only)
+    char const *Spatial_output_compression; // "Off" or "zlib" (vti/vtu and container)
+    char const *Spatial_output_data_format; // "bin" (one file per frame) or "container" (single Spatial_data.msc)
+    int Spatial_output_interval_reduced;            // ms // for quantised, down-sampled outputs (0 = off)
+    char const *Spatial_output_reduced_variables;   // list of name[:min:max[:stride[:mode[:bits]]]] || lib/Output_reduced.cpp
+    int Spatial_output_reduced_stride;              // spatial stride / block size
+    char const *Spatial_output_reduced_mode;        // "average" (block average) or "stride" (point sample)
+    int Spatial_output_reduced_bits;                // 8 or 16
+    char const *Spatial_output_reduced_ROI;         // "full", "box" or "map"
+    char const *Spatial_output_reduced_box;         // "x0,x1,y0,y1,z0,z1"
+    char const *Spatial_output_reduced_map_file;    // full-box map; region = value > 0
+
+    // Checkpoint/restart || lib/Checkpoint.cpp
+    double Checkpoint_interval;         // ms (0 = off)
+    int Checkpoint_keep;                // N most recent checkpoints (or base + delta sets) kept (rotation)
+    int Checkpoint_deltas;              // incremental (XOR delta) checkpoints between full checkpoints (0 = all full)
+    char const *Checkpoint_compression; // "Off", "rle" (byte shuffle + zero-run) or "zlib" (byte shuffle + zlib level 1)
+    char const *Read_checkpoint;        // "Off", "latest" or checkpoint filename
+
+    // S1-S2 vulnerability window sweep || lib/S2_sweep.cpp
+    char const *S2_sweep;               // "Off", "scan" or "bisect"
+    char const *S2_sweep_locations;     // "S2" (S2_x_loc) or comma separated x locations
+    char const *S2_sweep_CL;            // "min,max,step" (ms)
+    int S2_sweep_resolution;            // ms, bisection
+    int S2_sweep_window;                // ms simulated after each S2
+    int S2_sweep_branches;              // branches run concurrently (0 = one per thread)
+
+    // Per-beat activation, repolarisation, APD and CV maps || lib/Beat_maps.cpp
+    char const *Beat_maps;              // "Off" or "On"
+    char const *Beat_maps_APD;          // comma-separated % repolarisation thresholds, e.g. "90,50"
+
+    // Pseudo-ECG and unipolar electrograms || lib/Pseudo_ECG.cpp
+    char const *Pseudo_ECG;             // "Off" or "On"
+    char const *Pseudo_ECG_electrodes;  // "auto" or "x,y,z:x,y,z:..." electrode positions (mm)
+    char const *Pseudo_ECG_leads;       // "none" or "a-b,c-d,..." bipolar leads (1-based electrode numbers)
+
+    // Phase singularity / filament detection and tracking || lib/Phase_singularity.cpp
+    char const *Phase_singularity;      // "Off" or "On"
+    int Phase_singularity_interval;     // ms between analyses
+    int Phase_singularity_delay;        // ms, time delay of the phase embedding
+    double Phase_singularity_radius;    // mm, max displacement between analyses for the same singularity
+
+    // Configurable cell probes || lib/Probes.cpp
+    char const *Probe_file;             // "Off" or probe definition file
+
+    // Per-region aggregates || lib/Regional_outputs.cpp
+    char const *Regional_outputs;       // "Off", "geo" (geometry/celltype labels) or region map file
+    char const *Regional_outputs_stats; // comma-separated: mean, min, max, active
+    int Regional_outputs_interval;      // ms between rows
+
+    // Tissue setup || lib/Tissue_cache.cpp
+    char const *Tissue_cache;           // "Off", "auto" (anatomical models) or "On"
+    char const *Setup_diagnostics;      // "Off" or "On": vtk of per-celltype geometry, fibres, D1/D2
+
+    // Steady-state detection during pacing || lib/Steady_state.cpp
+    char const *Steady_state;           // "Off" or "On" (end pacing once converged)
+    int Steady_state_beats;             // consecutive beats within tolerance
+    double Steady_state_tol_APD90;      // % change from previous beat
+    double Steady_state_tol_CaT;        // % change in CaT amplitude
+    double Steady_state_tol_Nai;        // % change
+    double Steady_state_tol_CaSR;       // % change
+
+    // Periodic orbit (limit cycle) solver || lib/Periodic_orbit.cpp
+    char const *Periodic_orbit;         // "Off" or "On" (solve for the limit cycle at BCL before the time loop)
+    double Periodic_orbit_tol;          // max relative residual |P(x) - x|/|x|
+    int Periodic_orbit_iterations;      // Newton iterations
+    int Periodic_orbit_krylov;          // max Krylov vectors per Newton iteration
+    int Periodic_orbit_prebeats;        // plain beats before acceleration
+    int Periodic_orbit_aitken;          // Aitken rounds on slow variables
+
+    // Restitution and ERP protocol || lib/Restitution.cpp
+    char const *Restitution;            // "Off", "Dynamic", "S1S2", "ERP" or "All" (replaces the time loop)
+    char const *Restitution_BCL;        // "min,max,step" (ms); paced from max down to min
+    int Restitution_beats;              // max beats per BCL (fewer if Steady_state is On)
+    char const *Restitution_S2;         // "min,max,step" (ms); S1-S2 intervals (<= BCL)
+    int Restitution_window;             // ms simulated after each S2
+    double Restitution_ERP_threshold;   // S2 captures if its amplitude >= threshold x S1 amplitude
+    int Restitution_ERP_resolution;     // ms, bisection
+
+    // Forward sensitivities of biomarkers || lib/Sensitivity.cpp
+    char const *Sensitivity;            // "On" or "Off"
+    char const *Sensitivity_parameters; // comma-separated Cell_parameters conductances, e.g. "GKr,GCaL,GK1"
+    double Sensitivity_step;            // relative perturbation of the tangent (directional derivative) evaluation
 
 	// Delayed impose CaSR functionality
 	const char *Delayed_CaSR_IC; 	// "On" or "Off"
+	bool		Delayed_CaSR_IC_on;	// Delayed_CaSR_IC == "On" || set in set_simulation_settings()
 	double		CaSR_IC_delay;		// ms
 	bool		CaSR_set;			// true or false if already been set
 
@@ -122,6 +211,32 @@ typedef struct{
 }Simulation_parameters;
 // End Define the simulation parameters struct ==================================================//|
 
+// Model identifiers ============================================================================\\|
+// Cell_parameters.Model_id: the Model string resolved once at setup (lib/Model.c -> model_id()) so
+// that the per-step dispatch compares integers. Add new models here and in model_id()
+#define MODEL_MINIMAL       0
+#define MODEL_HAM_CRN       1
+#define MODEL_HAM_GB        2
+#define MODEL_HAM_NG        3
+#define MODEL_HAM_MT        4
+#define MODEL_HAM_WL_CRN    5
+#define MODEL_HAM_CRN_MWL   6
+#define MODEL_HAM_WL_GB     7
+#define MODEL_HAM_GB_MWL    8
+#define MODEL_HAM_NG_MWL    9
+#define MODEL_HVM_ORD_S     10
+#define MODEL_HAM_CAZ_S     11
+#define MODEL_DAM_VA        12
+#define MODEL_MCRN          13
+#define MODEL_HVM_TT        14
+//#define MODEL_SPECIESCELL_MODEL 15 // NEW MODEL
+
+// Cell_parameters.Ca_handling_id (hAM_WL)
+#define CA_HANDLING_CRN     0
+#define CA_HANDLING_GB      1
+#define CA_HANDLING_NG      2
+// End Model identifiers ========================================================================//|
+
 // Define the Cell_parameters struct (set once) =================================================\\|
 // Contains model parameters and constants and scaling/shift variables (as not dynamically determined)
 typedef struct{
@@ -129,6 +244,7 @@ typedef struct{
 	// Global control variables ===================================\\|
 	double 		dt;						// Integration time-step	
 	char const* Model;					// The baseline model
+	int			Model_id;				// MODEL_X identifier of Model (set with Model in lib/Initialisation.c)
 	char const* Celltype;				// Region or other celltype
 	char const* Agent;					// Pharmacological agent
 	double		Agent_prop;				// Proportion of pharma agent to set (linear 0-1)
@@ -157,7 +273,9 @@ typedef struct{
 
 	// hAM specific settings
 	char const* Ca_handling; 	// Ca handling model, hAM_WL (chose between GB and CRN)
+	int			Ca_handling_id;	// CA_HANDLING_X identifier of Ca_handling
 	char const*	environment;	// isolated vs intact
+	bool		isolated;		// environment == "isolated"
 	// End global control variables ===============================//|	
 
 	// Constants ==================================================\\|
@@ -980,6 +1098,7 @@ typedef struct{
 	int 	ex_switch;				// Tracks whether cell is currently excited
 	int 	APD_t_switch;			// Tracks whether APD at threshold has been calculated
 	int		APD_p_switch[9];		// Tracks whether APD to % repolarisation has been calculated
+	int		APD_p_next;				// Next % repolarisation threshold to be crossed (9 = none pending)
 	double 	t_ex;					// Time at which cell was excited	(ms)
 	double 	dvdt;					// Rate of change of voltage		(mV/ms)
 	double 	dvdt_max;				// Maximum rate of change of voltage(mV/ms)
@@ -1293,9 +1412,15 @@ typedef struct{
 
 	// Arrays =====================================================\\|
 	// Geometry
-	int *geo;         // contains the geometry (NX*NY*NZ)
+	// 3D geometry is stored in 8*8*8 bricks; only bricks containing tissue are allocated. Use SC_geo(sc, idx) 
+	// for the celltype at 3D idx (0 = empty space) and SC_geo_index(sc, idx) for the 1D cell index || lib/Spatial_coupling.h
+	int BX, BY, BZ;     // bricks in each direction
+	int Nbricks;        // occupied bricks
+	int brick_capacity;
+	int *brick;         // brick table (BX*BY*BZ): storage slot of each brick, -1 = no tissue
+	int *brick_geo;     // celltype of each voxel of the occupied bricks (Nbricks*512)
+	int *brick_index;   // 1D cell index of each voxel of the occupied bricks (-1 = empty space)
 	int *geo_linear;  // contains linearised geometry (Ncell)
-	int *geo_index;   // returns the index of the 1D array (i; geo_linear) when passed 3D array (x, y, z; geo) value
 	int *geo_3D_index;	// returns 3D index from Ncell index
 	int *x_index;		// returns the x value at each Ncell
 	int *y_index;		// returns the y value at each Ncell
@@ -1457,6 +1582,7 @@ typedef struct{
 
 	// Global settings
 	char const *Tissue_order;		// 1D, 2D, 3D, geometry
+	bool		Tissue_order_geo;	// Tissue_order == "geo" || set in overwrite_tissue_properties_from_args()
 	char const *Tissue_model;		// specific tissue model to be run
 	char const *Tissue_type;		// homogeneous or heterogeneous
 	char const *Orientation_type;	// isotropic, aniostropic, orthotropic
@@ -1522,6 +1648,7 @@ typedef struct{
 
 	int **multi_stim_area;	// Stim area for multiple stimulus sites and timings
 	char const 	*Multi_stim;	// "On" or "Off"
+	bool		Multi_stim_on;	// Multi_stim == "On" || set in overwrite_tissue_properties_from_args()
 	int Nstims;				// Number of different stim sites/timings
 	int stim_delay[20];		// Delay (relative to first stim) for each stim
 
@@ -1626,11 +1753,22 @@ typedef struct{
 // End define the tissue parameters struct ======================================================//|
 
 // Define the Spontaneous Release Functions =====================================================\\|
+// Mode_id and Model_id identifiers: Mode and Model resolved at setup (lib/Spontaneous_release_functions.cpp)
+#define SRF_OFF             0
+#define SRF_DIRECT_CONTROL  1
+#define SRF_DYNAMIC         2
+#define SRF_READ            3
+
+#define SRF_MODEL_3D_CELL   0
+#define SRF_MODEL_GENERAL   1
+
 typedef struct{
 
 	// Modes, models, parameter sets
 	const char * Mode;			// "Defined" or "Dynamic" or "Read"
 	const char * Model;			// "3D_cell" or "General"  ; Dynamic modes only
+	int		Mode_id;			// SRF_X identifier of Mode || set with set_SRF_mode()
+	int		Model_id;			// SRF_MODEL_X identifier of Model
 	const char * Pset;			// Specific parameter set identifier (applies to defined and dynamic)
 	const char * SRF_het;		// tissue heterogeneity of SRF
     const char * write_SRF_settings;     // For writting CaSR dependent SRF settings at each CaSR as a DC file
@@ -1805,6 +1943,132 @@ typedef struct {
     bool        SORs_arg;           // True IF argument passed
     int         SORe;               // Spatial output range start time
     bool        SORe_arg;           // True IF argument passed
+    char const  *SOA;               // Spatial output asynchronous "On" or "Off"
+    bool        SOA_arg;            // True IF argument passed
+    int         SOW;                // Spatial output writer threads
+    bool        SOW_arg;            // True IF argument passed
+    int         SOB;                // Spatial output snapshot buffers
+    bool        SOB_arg;            // True IF argument passed
+    char const  *SOVF;              // Spatial output vtk format "legacy", "vti" or "vtu"
+    bool        SOVF_arg;           // True IF argument passed
+    char const  *SOP;               // Spatial output precision "float" or "double"
+    bool        SOP_arg;            // True IF argument passed
+    char const  *SOC;               // Spatial output compression "Off" or "zlib"
+    bool        SOC_arg;            // True IF argument passed
+    char const  *SODF;              // Spatial output data format "bin" or "container"
+    bool        SODF_arg;           // True IF argument passed
+    int         SOIr;               // Spatial output interval reduced
+    bool        SOIr_arg;           // True IF argument passed
+    char const  *SORv;              // Spatial output reduced variables
+    bool        SORv_arg;           // True IF argument passed
+    int         SORst;              // Spatial output reduced stride
+    bool        SORst_arg;          // True IF argument passed
+    char const  *SORm;              // Spatial output reduced mode "average" or "stride"
+    bool        SORm_arg;           // True IF argument passed
+    int         SORb;               // Spatial output reduced bits 8 or 16
+    bool        SORb_arg;           // True IF argument passed
+    char const  *SORR;              // Spatial output reduced ROI "full", "box" or "map"
+    bool        SORR_arg;           // True IF argument passed
+    char const  *SORbox;            // Spatial output reduced box
+    bool        SORbox_arg;         // True IF argument passed
+    char const  *SORmap;            // Spatial output reduced map file
+    bool        SORmap_arg;         // True IF argument passed
+    double      CKI;                // Checkpoint interval
+    bool        CKI_arg;            // True IF argument passed
+    int         CKK;                // Checkpoints kept
+    bool        CKK_arg;            // True IF argument passed
+    int         CKD;                // Checkpoint deltas between full checkpoints
+    bool        CKD_arg;            // True IF argument passed
+    char const  *CKC;               // Checkpoint compression "Off", "rle" or "zlib"
+    bool        CKC_arg;            // True IF argument passed
+    char const  *RCK;               // Read checkpoint "Off", "latest" or filename
+    bool        RCK_arg;            // True IF argument passed
+    char const  *S2SW;              // S2 sweep "Off", "scan" or "bisect"
+    bool        S2SW_arg;           // True IF argument passed
+    char const  *S2SWL;             // S2 sweep locations
+    bool        S2SWL_arg;          // True IF argument passed
+    char const  *S2SWC;             // S2 sweep coupling intervals min,max,step
+    bool        S2SWC_arg;          // True IF argument passed
+    int         S2SWR;              // S2 sweep bisection resolution
+    bool        S2SWR_arg;          // True IF argument passed
+    int         S2SWW;              // S2 sweep window after S2
+    bool        S2SWW_arg;          // True IF argument passed
+    int         S2SWB;              // S2 sweep concurrent branches
+    bool        S2SWB_arg;          // True IF argument passed
+    char const  *BM;                // Beat maps "Off" or "On"
+    bool        BM_arg;             // True IF argument passed
+    char const  *BMA;               // Beat maps APD thresholds "90,50"
+    bool        BMA_arg;            // True IF argument passed
+    char const  *PECG;              // Pseudo-ECG "Off" or "On"
+    bool        PECG_arg;           // True IF argument passed
+    char const  *PECGE;             // Pseudo-ECG electrode positions
+    bool        PECGE_arg;          // True IF argument passed
+    char const  *PECGL;             // Pseudo-ECG bipolar leads
+    bool        PECGL_arg;          // True IF argument passed
+    char const  *PSG;               // Phase singularity tracking "Off" or "On"
+    bool        PSG_arg;            // True IF argument passed
+    int         PSGI;               // Phase singularity analysis interval
+    bool        PSGI_arg;           // True IF argument passed
+    int         PSGD;               // Phase singularity embedding delay
+    bool        PSGD_arg;           // True IF argument passed
+    double      PSGR;               // Phase singularity tracking radius
+    bool        PSGR_arg;           // True IF argument passed
+    char const  *PRF;               // Probe definition file
+    bool        PRF_arg;            // True IF argument passed
+    char const  *RGO;               // Regional outputs "Off", "geo" or map file
+    bool        RGO_arg;            // True IF argument passed
+    char const  *RGOS;              // Regional output statistics
+    bool        RGOS_arg;           // True IF argument passed
+    int         RGOI;               // Regional output interval
+    bool        RGOI_arg;           // True IF argument passed
+    char const  *TCH;               // Tissue cache "Off", "auto" or "On"
+    bool        TCH_arg;            // True IF argument passed
+    char const  *SUD;               // Setup diagnostics "Off" or "On"
+    bool        SUD_arg;            // True IF argument passed
+    char const  *SS;                // Steady state detection "Off" or "On"
+    bool        SS_arg;             // True IF argument passed
+    int         SSB;                // Steady state consecutive beats
+    bool        SSB_arg;            // True IF argument passed
+    double      SSTA;               // Steady state tolerance APD90 (%)
+    bool        SSTA_arg;           // True IF argument passed
+    double      SSTC;               // Steady state tolerance CaT amplitude (%)
+    bool        SSTC_arg;           // True IF argument passed
+    double      SSTN;               // Steady state tolerance Nai (%)
+    bool        SSTN_arg;           // True IF argument passed
+    double      SSTS;               // Steady state tolerance CaSR (%)
+    bool        SSTS_arg;           // True IF argument passed
+    char const  *PO;                // Periodic orbit solver "Off" or "On"
+    bool        PO_arg;             // True IF argument passed
+    double      POT;                // Periodic orbit tolerance
+    bool        POT_arg;            // True IF argument passed
+    int         POI;                // Periodic orbit Newton iterations
+    bool        POI_arg;            // True IF argument passed
+    int         POK;                // Periodic orbit Krylov vectors
+    bool        POK_arg;            // True IF argument passed
+    int         POP;                // Periodic orbit pre-beats
+    bool        POP_arg;            // True IF argument passed
+    int         POA;                // Periodic orbit Aitken rounds
+    bool        POA_arg;            // True IF argument passed
+    char const  *RP;                // Restitution protocol "Off", "Dynamic", "S1S2", "ERP" or "All"
+    bool        RP_arg;             // True IF argument passed
+    char const  *RPB;               // Restitution BCLs "min,max,step"
+    bool        RPB_arg;            // True IF argument passed
+    int         RPN;                // Restitution beats per BCL
+    bool        RPN_arg;            // True IF argument passed
+    char const  *RPS;               // Restitution S2 intervals "min,max,step"
+    bool        RPS_arg;            // True IF argument passed
+    int         RPW;                // Restitution window after S2
+    bool        RPW_arg;            // True IF argument passed
+    double      RPT;                // Restitution ERP capture threshold
+    bool        RPT_arg;            // True IF argument passed
+    int         RPR;                // Restitution ERP resolution
+    bool        RPR_arg;            // True IF argument passed
+    char const  *SEN;               // Sensitivity "On" or "Off"
+    bool        SEN_arg;            // True IF argument passed
+    char const  *SENP;              // Sensitivity parameters "GKr,GCaL,..."
+    bool        SENP_arg;           // True IF argument passed
+    double      SENH;               // Sensitivity tangent step
+    bool        SENH_arg;           // True IF argument passed
 	char const 	*Multi_stim;		// "On" or "Off" for multiple stim sites
 	bool		Multi_stim_arg;		//	True IF argument passed 
 	// End simulation settings ====================================//|
@@ -67,15 +67,20 @@
 #include "Tissue.h"
 #include "Structs.h"
 #include "Spatial_coupling.h"
+#include "Binary_inputs.h"
 #include <fstream>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <omp.h>
 
 // Function list ================================================================================\\|
 //	Setup and tissue model
 //	    set_tissue_model_conditions()
 //	    tissue_array_allocation()
 //	    tissue_array_deallocation()
+//	    tissue_release_setup_arrays()
+//	    tissue_cell_configurations()
 //	    set_tissue_settings_idealised() 	** This is where to add a new model **
 //	    set_tissue_settings_anatomical()	** This is where to add a new model **
 //	    set_coord_stim_and_map_from_defined_type()
@@ -84,6 +89,7 @@
 //	
 //	Create and read geometry, stimulus and map functions
 //	    select_tissue_geometry_function()
+//	    tissue_geometry_vtk_output()
 //	    create_idealised_geometry_homogeneous()
 //	    create_idealised_geometry_heterogeneous()
 //	    select_stimulus_area_function()
@@ -93,6 +99,7 @@
 //	    set_orientation()
 //	    create_orientation_ideal()
 //	    read_orientation_anatomical()
+//	    read_orientation_binary()
 //	    output_fibre_orientation()
 //	    create_or_read_map_double()
 //	    create_map_patch()
@@ -111,6 +118,7 @@
 //	    calculate_CV()
 //	
 //	compute_conduction_success()
+//	conduction_success_type()
 // End Function list ============================================================================//|
 
 // Set tissue model and type ====================================================================\\|
@@ -215,6 +223,98 @@ void tissue_array_deallocation(Tissue_parameters *t)
 	for (int n = 0; n < 20; n++) delete t->multi_stim_area[n];
 	delete t->multi_stim_area;
 }
+
+// Cell maps are applied to Params and the D arrays during setup; only the stimulus areas are used
+// in the time loop. Released pointers are set to NULL (tissue_array_deallocation is unchanged).
+// Returns bytes released
+double tissue_release_setup_arrays(Tissue_parameters *t, int N)
+{
+	double bytes = 0;
+	double **maps[] = {&t->ISO_map, &t->Dscale_base_map, &t->Dscale_mod_map, &t->D_AR_scale_base_map, &t->D_AR_scale_mod_map, 
+		&t->remod_map, &t->ACh_map, &t->SRF_map, &t->Direct_modulation_map, &t->spatial_gradient_map};
+	for (int i = 0; i < 10; i++)
+	{
+		if (*maps[i] == NULL) continue;
+		delete [] *maps[i];
+		*maps[i] = NULL;
+		bytes += (double)N*sizeof(double);
+	}
+	if (t->phasemap != NULL)
+	{
+		delete [] t->phasemap;
+		t->phasemap = NULL;
+		bytes += (double)N*sizeof(int);
+	}
+	return bytes;
+}
+
+// Groups cells whose parameter setup is identical, so that it can be computed once per group.
+// The per-cell setup inputs are: the region (celltype/model number), the map-scaled conditions 
+// (ISO, remodelling, ACh, spatial gradient) and whether direct modulation applies; everything else
+// is global. config[n] = configuration of cell n; representative[c] = first cell of configuration c
+// Returns the number of configurations
+typedef struct{
+	int     region;
+	int     modulation;
+	double  ISO, Remodelling_prop, ACh, spatial_gradient_prop;
+}Tissue_cell_key;
+
+static Tissue_cell_key tissue_cell_key(Cell_parameters *Params, Tissue_parameters t, SC_variables sc, bool modulation_map, int n)
+{
+	Tissue_cell_key k;
+	memset(&k, 0, sizeof(Tissue_cell_key));
+	k.region                = sc.geo_linear[n];
+	k.modulation            = (modulation_map == false || t.Direct_modulation_map[n] > 0.0);
+	k.ISO                   = Params[n].ISO;
+	k.Remodelling_prop      = Params[n].Remodelling_prop;
+	k.ACh                   = Params[n].ACh;
+	k.spatial_gradient_prop = Params[n].spatial_gradient_prop;
+	return k;
+}
+
+int tissue_cell_configurations(Cell_parameters *Params, Tissue_parameters t, SC_variables sc, int *config, int *representative)
+{
+	bool modulation_map = (strcmp(t.Direct_modulation_map_on, "On") == 0);
+
+	// Hash of each cell's key (parallel)
+	uint64_t *hash = new uint64_t [sc.N];
+	#pragma omp parallel for schedule(static)
+	for (int n = 0; n < sc.N; n++)
+	{
+		Tissue_cell_key k = tissue_cell_key(Params, t, sc, modulation_map, n);
+		const unsigned char *d = (const unsigned char*)&k;
+		uint64_t h = 14695981039346656037ull;
+		for (size_t i = 0; i < sizeof(Tissue_cell_key); i++) { h ^= d[i]; h *= 1099511628211ull; }
+		hash[n] = h;
+	}
+
+	// Open addressing table of configurations (serial; keys compared in full)
+	int size = 64;
+	while (size < 2*sc.N) size *= 2;
+	int *table = new int [size];
+	for (int i = 0; i < size; i++) table[i] = -1;
+	int Nconfig = 0;
+	for (int n = 0; n < sc.N; n++)
+	{
+		Tissue_cell_key k = tissue_cell_key(Params, t, sc, modulation_map, n);
+		int slot = (int)(hash[n] & (uint64_t)(size - 1));
+		while (table[slot] >= 0)
+		{
+			Tissue_cell_key r = tissue_cell_key(Params, t, sc, modulation_map, representative[table[slot]]);
+			if (hash[representative[table[slot]]] == hash[n] && memcmp(&k, &r, sizeof(Tissue_cell_key)) == 0) break;
+			slot = (slot + 1) & (size - 1);
+		}
+		if (table[slot] < 0)
+		{
+			table[slot]                 = Nconfig;
+			representative[Nconfig++]   = n;
+		}
+		config[n] = table[slot];
+	}
+	delete [] hash;
+	delete [] table;
+	return Nconfig;
+}
 // End array allocation and deallocation ========================================================//|
 
 // Set tissue settings from model and type - IDEALISED ==========================================\\|
@@ -2309,14 +2409,17 @@ void overwrite_tissue_properties_from_args(Cell_parameters p, Tissue_parameters
         printf("ERROR! Tissue_type %s is invalid; must be \"homogeneous\" or \"heterogeneous\"\n", t->Tissue_type);
     }
 
+    // Flags consulted in the time loop
+    t->Multi_stim_on    = (strcmp(t->Multi_stim, "On") == 0);
+    t->Tissue_order_geo = (strcmp(t->Tissue_order, "geo") == 0);
 }
 // End overwrite properties from arguments ======================================================//|
 
 // Create or read geometries ====================================================================\\|
 // Select appropriate function
-void select_tissue_geometry_function(Tissue_parameters t, SC_variables *sc, const char * PATH, const char* Output_dir)
+void select_tissue_geometry_function(Tissue_parameters t, SC_variables *sc, const char * PATH, const char* Output_dir, bool diagnostics)
 {
-    if (strcmp(t.Tissue_order, "geo") == 0) sc->N = read_geo_file(sc, sc->geo, t.geo_file, "Tissue_geometries", PATH, Output_dir, "anatomy", t.Ncelltypes);  // read geo || lib/Spatial_coupling.cc
+    if (strcmp(t.Tissue_order, "geo") == 0) sc->N = read_geo_file(sc, t.geo_file, "Tissue_geometries", PATH, Output_dir, "anatomy", t.Ncelltypes, diagnostics);  // read geo || lib/Spatial_coupling.cc
     else if (strcmp(t.Tissue_order, "1D") == 0 || strcmp(t.Tissue_order, "2D") == 0 || strcmp(t.Tissue_order, "3D") == 0)
     {
         printf(">Creating idealised geometry....\n");
@@ -2328,49 +2431,61 @@ void select_tissue_geometry_function(Tissue_parameters t, SC_variables *sc, cons
             exit(1);
         }
 
-        // Write vtk of geo file
-        char *string = (char*)malloc(500);
-        FILE *out;
-        int idx;
-        sprintf(string,"%s/Geometry_idealised.vtk", Output_dir);
-        out = fopen(string, "wt");
-
-        fprintf(out, "# vtk DataFile Version 3.0\n");
-        fprintf(out, "vtk output\n");
-        fprintf(out, "ASCII\n");
-        fprintf(out, "DATASET STRUCTURED_POINTS\n");
-        fprintf(out, "DIMENSIONS %d %d %d\n", sc->NX, sc->NY, sc->NZ);
-        fprintf(out, "SPACING 1 1 1\n");
-        fprintf(out, "ORIGIN 0 0 0\n");
-        fprintf(out, "POINT_DATA %d\n", sc->NX*sc->NY*sc->NZ);
-        fprintf(out, "SCALARS geo float 1\n");
-        fprintf(out, "LOOKUP_TABLE default\n");
+        tissue_geometry_vtk_output(t, sc, Output_dir, diagnostics); // Geometry_idealised.vtk
+    }
+    else
+    {
+        printf("ERROR: \"%s\" is not a valid Tissue order. Please select from \"1D\", \"2D\", \"3D\", \"geo\"\n\n", t.Tissue_order);
+        exit(1);
+    }
+}
+
+// Write vtk of the geometry (Geometry_anatomy.vtk or Geometry_idealised.vtk); called on setup and after a tissue cache load
+void tissue_geometry_vtk_output(Tissue_parameters t, SC_variables *sc, const char* Output_dir, bool diagnostics)
+{
+    if (strcmp(t.Tissue_order, "geo") == 0)
+    {
+        geometry_vtk_output(sc, Output_dir, "anatomy", t.Ncelltypes, diagnostics); // lib/Spatial_coupling.cpp
+        return;
+    }
 
-        for (int k = 0; k < sc->NZ; k++)
+    // Write vtk of geo file
+    char *string = (char*)malloc(500);
+    FILE *out;
+    int idx;
+    sprintf(string,"%s/Geometry_idealised.vtk", Output_dir);
+    out = fopen(string, "wt");
+
+    fprintf(out, "# vtk DataFile Version 3.0\n");
+    fprintf(out, "vtk output\n");
+    fprintf(out, "ASCII\n");
+    fprintf(out, "DATASET STRUCTURED_POINTS\n");
+    fprintf(out, "DIMENSIONS %d %d %d\n", sc->NX, sc->NY, sc->NZ);
+    fprintf(out, "SPACING 1 1 1\n");
+    fprintf(out, "ORIGIN 0 0 0\n");
+    fprintf(out, "POINT_DATA %d\n", sc->NX*sc->NY*sc->NZ);
+    fprintf(out, "SCALARS geo float 1\n");
+    fprintf(out, "LOOKUP_TABLE default\n");
+
+    for (int k = 0; k < sc->NZ; k++)
+    {
+        for (int j = 0; j < sc->NY; j++)
         {
-            for (int j = 0; j < sc->NY; j++)
+            for (int i = 0; i < sc->NX; i++)
             {
-                for (int i = 0; i < sc->NX; i++)
+                idx = i + (sc->NX*j) + (sc->NX*sc->NY*k);
+                if (SC_geo(sc, idx) > 0)
                 {
-                    idx = i + (sc->NX*j) + (sc->NX*sc->NY*k);
-                    if (sc->geo[idx] > 0)
-                    {
-                        fprintf(out, "%d ", sc->geo[idx]);
-                    }
-                    else fprintf(out, "-100 ");
+                    fprintf(out, "%d ", SC_geo(sc, idx));
                 }
-                fprintf(out, "\n");
+                else fprintf(out, "-100 ");
             }
             fprintf(out, "\n");
         }
-        fclose(out);
-        free(string);
-    }
-    else
-    {
-        printf("ERROR: \"%s\" is not a valid Tissue order. Please select from \"1D\", \"2D\", \"3D\", \"geo\"\n\n", t.Tissue_order);
-        exit(1);
+        fprintf(out, "\n");
     }
+    fclose(out);
+    free(string);
 }
 
 // Idealised create functions
@@ -2386,8 +2501,7 @@ void create_idealised_geometry_homogeneous(SC_variables *sc)
             for (int i = 0; i < sc->NX; i++)
             {
                 idx = i + (sc->NX*j) + (sc->NX * sc->NY * k);
-                sc->geo[idx] = 0;       // Default to empty space
-                sc->geo[idx] = 1;		// In this case, all tissue is one celltype	
+                SC_set_geo(sc, idx, 1);		// In this case, all tissue is one celltype	
                 cell_count++;
             }
         }
@@ -2409,20 +2523,20 @@ void create_idealised_geometry_heterogeneous(SC_variables *sc, Tissue_parameters
             for (int i = 0; i < sc->NX; i++)
             {
                 idx = i + (sc->NX*j) + (sc->NX * sc->NY * k);
-                sc->geo[idx]	= 0;		// Default to empty space
+                SC_set_geo(sc, idx, 0);		// Default to empty space
 
                 // Set first celltype which starts from x=0 bounds
-                if (i < t.het_junction_X_location[1]) 	sc->geo[idx] = 1;
+                if (i < t.het_junction_X_location[1]) 	SC_set_geo(sc, idx, 1);
                 else
                 {
                     for (int c = 2; c < t.Ncelltypes; c++) // start from celltypes 2 up to second-to-last celltype
                     {
-                        if (i >= t.het_junction_X_location[c-1] && i < t.het_junction_X_location[c]) sc->geo[idx] = c;
+                        if (i >= t.het_junction_X_location[c-1] && i < t.het_junction_X_location[c]) SC_set_geo(sc, idx, c);
                     }
                     // And final celltype, x->NX
-                    if (i >= t.het_junction_X_location[t.Ncelltypes-1]) sc->geo[idx] = t.Ncelltypes;
+                    if (i >= t.het_junction_X_location[t.Ncelltypes-1]) SC_set_geo(sc, idx, t.Ncelltypes);
                 }
-                if (sc->geo[idx] > 0) cell_count++;	
+                if (SC_geo(sc, idx) > 0) cell_count++;	
             }
         }
     }
@@ -2505,7 +2619,7 @@ void select_stimulus_area_function_multi_stim(Tissue_parameters *t, SC_variables
                     for (int i = 0; i < sc.NX; i++)
                     {
                         idx = i + (sc.NX*j) + (sc.NX * sc.NY * k);
-                        if (sc.geo[idx] > 0) // if it is an actual cell/node
+                        if (SC_geo(&sc, idx) > 0) // if it is an actual cell/node
                         {
                             // default all maps to zero
                             for (int n = 1; n < Nstims; n++) t->multi_stim_area[n][cell_count] = 0;	
@@ -2527,7 +2641,7 @@ void select_stimulus_area_function_multi_stim(Tissue_parameters *t, SC_variables
                     for (int i = 0; i < sc.NX; i++)
                     {
                         idx = i + (sc.NX*j) + (sc.NX * sc.NY * k);
-                        if (sc.geo[idx] > 0) // if it is an actual cell/node
+                        if (SC_geo(&sc, idx) > 0) // if it is an actual cell/node
                         {
                             if (t->stim_area[cell_count] != 1) t->stim_area[cell_count] = 0; // only keep this map IF equal to 1
                             cell_count++;
@@ -2565,7 +2679,7 @@ void create_stimulus_area(SC_variables sc, const char *Tissue_order, int * stim_
             for (int i = 0; i < sc.NX; i++)
             {
                 idx = i + (sc.NX*j) + (sc.NX * sc.NY * k);
-                if (sc.geo[idx] > 0) // if it is an actual cell/node
+                if (SC_geo(&sc, idx) > 0) // if it is an actual cell/node
                 {
                     if (strcmp(Tissue_order, "1D") == 0) 
                     {
@@ -2629,7 +2743,7 @@ void create_stimulus_area(SC_variables sc, const char *Tissue_order, int * stim_
             for (int i = 0; i < sc.NX; i++)
             {
                 idx = i + (sc.NX*j) + (sc.NX*sc.NY*k);
-                if (sc.geo[idx] > 0)
+                if (SC_geo(&sc, idx) > 0)
                 {
                     fprintf(out, "%d ", stim_area[cell_count]);
                     cell_count++;
@@ -2658,7 +2772,7 @@ void create_stimulus_area_sphere(SC_variables sc, const char *Tissue_order, int
             for (int i = 0; i < sc.NX; i++)
             {
                 idx = i + (sc.NX*j) + (sc.NX * sc.NY * k);
-                if (sc.geo[idx] > 0) // if it is an actual cell/node
+                if (SC_geo(&sc, idx) > 0) // if it is an actual cell/node
                 {
                     if (strcmp(Tissue_order, "2D") == 0)
                     {
@@ -2715,7 +2829,7 @@ void create_stimulus_area_sphere(SC_variables sc, const char *Tissue_order, int
             for (int i = 0; i < sc.NX; i++)
             {
                 idx = i + (sc.NX*j) + (sc.NX*sc.NY*k);
-                if (sc.geo[idx] > 0)
+                if (SC_geo(&sc, idx) > 0)
                 {
                     fprintf(out, "%d ", stim_area[cell_count]);
                     cell_count++;
@@ -2781,6 +2895,66 @@ void create_orientation_ideal(SC_variables *sc, Tissue_parameters t)
     }
 }
 
+// Binary fibre files (convert_inputs) || lib/Binary_inputs.cpp
+// Same file names and types as the text files; index = "", "2" or "3" (transverse directions)
+// Returns false if the files are text, which are then read as before
+bool read_orientation_binary(SC_variables *sc, Tissue_parameters t, const char *PATH, const char *index, double *ox, double *oy, double *oz)
+{
+    char *string = (char*)malloc(500);
+    double *o[3] = {ox, oy, oz};
+    bool angles = (strcmp(t.orientation_file_type, "angles") == 0 || strcmp(t.orientation_file_type, "angles_short_axis") == 0);
+
+    if (strcmp(t.orientation_file_type, "orientation") == 0) sprintf(string, "%s/Tissue_geometries/%s_orientation%s.dat", PATH, t.orientation_file_root, index);
+    else if (angles) sprintf(string, "%s/Tissue_geometries/%s_theta.dat", PATH, t.orientation_file_root);
+    else sprintf(string, "%s/Tissue_geometries/%s_OX%s.dat", PATH, t.orientation_file_root, index);
+    if (binary_input_check(string) == false)
+    {
+        free(string);
+        return false;
+    }
+    printf("Reading fibres, binary %s style, from file %s...\n", t.orientation_file_type, string);
+
+    if (strcmp(t.orientation_file_type, "orientation") == 0) binary_input_read_cells_double(string, *sc, o, 3);
+    else if (angles) // theta and phi into ox and oy, converted below
+    {
+        binary_input_read_cells_double(string, *sc, &o[0], 1);
+        sprintf(string, "%s/Tissue_geometries/%s_phi.dat", PATH, t.orientation_file_root);
+        binary_input_read_cells_double(string, *sc, &o[1], 1);
+    }
+    else
+    {
+        const char *component[3] = {"OX", "OY", "OZ"};
+        for (int c = 0; c < 3; c++)
+        {
+            sprintf(string, "%s/Tissue_geometries/%s_%s%s.dat", PATH, t.orientation_file_root, component[c], index);
+            binary_input_read_cells_double(string, *sc, &o[c], 1);
+        }
+    }
+
+    bool short_axis = (strcmp(t.orientation_file_type, "angles_short_axis") == 0);
+    #pragma omp parallel for schedule(static)
+    for (int n = 0; n < sc->N; n++)
+    {
+        if (angles == true && short_axis == false)
+        {
+            double theta = ox[n], phi = oy[n];
+            ox[n]   = sin(theta)*cos(phi);
+            oy[n]   = cos(theta)*cos(phi);
+            oz[n]   = sin(phi);
+        }
+        else if (angles == true)
+        {
+            double theta = ox[n], phi = oy[n];
+            ox[n]   = cos(theta)*cos(phi);
+            oy[n]   = sin(theta)*cos(phi);
+            oz[n]   = sin(phi);
+        }
+        else for (int c = 0; c < 3; c++) if (o[c][n] > 1.0) o[c][n] = 1.0; // soft check, as text files
+    }
+    free(string);
+    return true;
+}
+
 void read_orientation_anatomical(SC_variables *sc, Tissue_parameters t, const char *PATH)
 {
     FILE *in1, *in2, *in3;
@@ -2789,6 +2963,8 @@ void read_orientation_anatomical(SC_variables *sc, Tissue_parameters t, const ch
     int idx;
     int count = 0;
 
+    if (read_orientation_binary(sc, t, PATH, "", sc->ox, sc->oy, sc->oz) == true) return;
+
     if (strcmp(t.orientation_file_type, "xyz") == 0)
     {
         printf("Reading fibres, xyz style, from file...\n");
@@ -2826,9 +3002,9 @@ void read_orientation_anatomical(SC_variables *sc, Tissue_parameters t, const ch
                     fscanf(in2, "%f ", &Y);
                     fscanf(in3, "%f ", &Z);
 
-                    //if (X != 0 && sc->geo[idx] == 0)  printf("Fibre error  - fibre present where there is no geometry. Continuing..\n");
+                    //if (X != 0 && SC_geo(sc, idx) == 0)  printf("Fibre error  - fibre present where there is no geometry. Continuing..\n");
 
-                    if (sc->geo[idx] > 0) // note that ox, oy, oz arrays are only size Ncell, not NX*NY*NZ
+                    if (SC_geo(sc, idx) > 0) // note that ox, oy, oz arrays are only size Ncell, not NX*NY*NZ
                     {
                         //if (X == 0) printf("Fibre error\n");
                         sc->ox[count]  = X;
@@ -2879,9 +3055,9 @@ void read_orientation_anatomical(SC_variables *sc, Tissue_parameters t, const ch
                     idx = i + (sc->NX*j) + (sc->NX * sc->NY * k);
 
                     fscanf(in1, "%f %f %f ", &X, &Y, &Z);
-                    //if (X != 0 && sc->geo[idx] == 0)  printf("Fibre error\n");
+                    //if (X != 0 && SC_geo(sc, idx) == 0)  printf("Fibre error\n");
 
-                    if (sc->geo[idx] > 0) // note that ox, oy, oz arrays are only size Ncell, not NX*NY*NZ
+                    if (SC_geo(sc, idx) > 0) // note that ox, oy, oz arrays are only size Ncell, not NX*NY*NZ
                     {
                         //if (X == 0 && Y == 0 && Z == 0) printf("Fibre error\n");
                         sc->ox[count]  = X;
@@ -2934,7 +3110,7 @@ void read_orientation_anatomical(SC_variables *sc, Tissue_parameters t, const ch
                     fscanf(in2, "%f ", &phi);
                     // radians
 
-                    if (sc->geo[idx] > 0) // note that ox, oy, oz arrays are only size Ncell, not NX*NY*NZ
+                    if (SC_geo(sc, idx) > 0) // note that ox, oy, oz arrays are only size Ncell, not NX*NY*NZ
                     {
                         sc->ox[count]  = sin(theta)*cos(phi);
                         sc->oy[count]  = cos(theta)*cos(phi);
@@ -2982,7 +3158,7 @@ void read_orientation_anatomical(SC_variables *sc, Tissue_parameters t, const ch
                     fscanf(in1, "%f ", &theta);
                     fscanf(in2, "%f ", &phi);
 
-                    if (sc->geo[idx] > 0) // note that ox, oy, oz arrays are only size Ncell, not NX*NY*NZ
+                    if (SC_geo(sc, idx) > 0) // note that ox, oy, oz arrays are only size Ncell, not NX*NY*NZ
                     {
                         sc->ox[count]  = cos(theta)*cos(phi);
                         sc->oy[count]  = sin(theta)*cos(phi);
@@ -3010,6 +3186,16 @@ void read_orientation_anatomical_transverse(SC_variables *sc, Tissue_parameters
     int idx;
     int count = 0;
 
+    if (read_orientation_binary(sc, t, PATH, "2", sc->ox2, sc->oy2, sc->oz2) == true)
+    {
+        if (read_orientation_binary(sc, t, PATH, "3", sc->ox3, sc->oy3, sc->oz3) == false)
+        {
+            printf("ERROR: transverse fibre files must be all binary or all text (%s)\n", t.orientation_file_root);
+            exit(1);
+        }
+        return;
+    }
+
     // Transverse 1 (in sheet) ================================================================\\|
 
     if (strcmp(t.orientation_file_type, "xyz") == 0)
@@ -3049,9 +3235,9 @@ void read_orientation_anatomical_transverse(SC_variables *sc, Tissue_parameters
                     fscanf(in2, "%f ", &Y);
                     fscanf(in3, "%f ", &Z);
 
-                    //if (X != 0 && sc->geo[idx] == 0)  printf("Fibre error  - fibre present where there is no geometry. Continuing..\n");
+                    //if (X != 0 && SC_geo(sc, idx) == 0)  printf("Fibre error  - fibre present where there is no geometry. Continuing..\n");
 
-                    if (sc->geo[idx] > 0) // note that ox, oy, oz arrays are only size Ncell, not NX*NY*NZ
+                    if (SC_geo(sc, idx) > 0) // note that ox, oy, oz arrays are only size Ncell, not NX*NY*NZ
                     {
                         //if (X == 0) printf("Fibre error\n");
                         sc->ox2[count]  = X;
@@ -3102,9 +3288,9 @@ void read_orientation_anatomical_transverse(SC_variables *sc, Tissue_parameters
                     idx = i + (sc->NX*j) + (sc->NX * sc->NY * k);
 
                     fscanf(in1, "%f %f %f ", &X, &Y, &Z);
-                    //if (X != 0 && sc->geo[idx] == 0)  printf("Fibre error\n");
+                    //if (X != 0 && SC_geo(sc, idx) == 0)  printf("Fibre error\n");
 
-                    if (sc->geo[idx] > 0) // note that ox, oy, oz arrays are only size Ncell, not NX*NY*NZ
+                    if (SC_geo(sc, idx) > 0) // note that ox, oy, oz arrays are only size Ncell, not NX*NY*NZ
                     {
                         //if (X == 0 && Y == 0 && Z == 0) printf("Fibre error\n");
                         sc->ox2[count]  = X;
@@ -3168,9 +3354,9 @@ void read_orientation_anatomical_transverse(SC_variables *sc, Tissue_parameters
                     fscanf(in2, "%f ", &Y);
                     fscanf(in3, "%f ", &Z);
 
-                    //if (X != 0 && sc->geo[idx] == 0)  printf("Fibre error  - fibre present where there is no geometry. Continuing..\n");
+                    //if (X != 0 && SC_geo(sc, idx) == 0)  printf("Fibre error  - fibre present where there is no geometry. Continuing..\n");
 
-                    if (sc->geo[idx] > 0) // note that ox, oy, oz arrays are only size Ncell, not NX*NY*NZ
+                    if (SC_geo(sc, idx) > 0) // note that ox, oy, oz arrays are only size Ncell, not NX*NY*NZ
                     {
                         //if (X == 0) printf("Fibre error\n");
                         sc->ox3[count]  = X;
@@ -3221,9 +3407,9 @@ void read_orientation_anatomical_transverse(SC_variables *sc, Tissue_parameters
                     idx = i + (sc->NX*j) + (sc->NX * sc->NY * k);
 
                     fscanf(in1, "%f %f %f ", &X, &Y, &Z);
-                    //if (X != 0 && sc->geo[idx] == 0)  printf("Fibre error\n");
+                    //if (X != 0 && SC_geo(sc, idx) == 0)  printf("Fibre error\n");
 
-                    if (sc->geo[idx] > 0) // note that ox, oy, oz arrays are only size Ncell, not NX*NY*NZ
+                    if (SC_geo(sc, idx) > 0) // note that ox, oy, oz arrays are only size Ncell, not NX*NY*NZ
                     {
                         //if (X == 0 && Y == 0 && Z == 0) printf("Fibre error\n");
                         sc->ox3[count]  = X;
@@ -3279,7 +3465,7 @@ void output_fibre_orientation(SC_variables sc, Tissue_parameters t, const char*
             for (int i = 0; i < sc.NX; i++)
             {
                 idx = i + (sc.NX*j) + (sc.NX*sc.NY*k);
-                if (sc.geo[idx] > 0)
+                if (SC_geo(&sc, idx) > 0)
                 { 
                     fprintf(out, "%f %f %f ", sc.ox[count], sc.oy[count], sc.oz[count]);
                     count++;
@@ -3322,7 +3508,7 @@ void output_fibre_orientation_o2(SC_variables sc, Tissue_parameters t, const cha
             for (int i = 0; i < sc.NX; i++)
             {
                 idx = i + (sc.NX*j) + (sc.NX*sc.NY*k);
-                if (sc.geo[idx] > 0)
+                if (SC_geo(&sc, idx) > 0)
                 {
                     fprintf(out, "%f %f %f ", sc.ox2[count], sc.oy2[count], sc.oz2[count]);
                     count++;
@@ -3365,7 +3551,7 @@ void output_fibre_orientation_o3(SC_variables sc, Tissue_parameters t, const cha
             for (int i = 0; i < sc.NX; i++)
             {
                 idx = i + (sc.NX*j) + (sc.NX*sc.NY*k);
-                if (sc.geo[idx] > 0)
+                if (SC_geo(&sc, idx) > 0)
                 {
                     fprintf(out, "%f %f %f ", sc.ox3[count], sc.oy3[count], sc.oz3[count]);
                     count++;
@@ -3449,7 +3635,7 @@ void create_map_patch(SC_variables sc, const char *Tissue_order, double * map_pa
             for (int i = 0; i < sc.NX; i++)
             {
                 idx = i + (sc.NX*j) + (sc.NX * sc.NY * k);
-                if (sc.geo[idx] > 0) // if it is an actual cell/node
+                if (SC_geo(&sc, idx) > 0) // if it is an actual cell/node
                 {
                     if (strcmp(Tissue_order, "1D") == 0)
                     {
@@ -3530,7 +3716,7 @@ void create_map_patch(SC_variables sc, const char *Tissue_order, double * map_pa
             for (int i = 0; i < sc.NX; i++)
             {
                 idx = i + (sc.NX*j) + (sc.NX*sc.NY*k);
-                if (sc.geo[idx] > 0)
+                if (SC_geo(&sc, idx) > 0)
                 {
                     fprintf(out, "%f ", map_patch[cell_count]);
                     cell_count++;
@@ -3692,99 +3878,99 @@ void Modify_neighbours_region_disconnect(SC_variables *sc, Tissue_parameters *t)
                 idx_xp_yp_zp = (i+1) + (sc->NX * (j+1)) + (sc->NX * sc->NY * (k+1));
 
 
-                if (sc->geo[idx] > 0) // if it is an actual cell/node
+                if (SC_geo(sc, idx) > 0) // if it is an actual cell/node
                 {
                     for (int DN = 0; DN < t->Ndisconnected_regions; DN++) // loop over number of disconnected region pairs
                     {
                         // x-1  -> if current node is region 0 for disconnect pair DN and xminus is region 1, or current node is region 1 and xminus is region 0, then disconnect (return self to neighbour map)
                         if (i > 0) 
-                            if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xm] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xm] == t->disconnect_regions[DN][0]) ) sc->xm[count] = count;
+                            if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xm) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xm) == t->disconnect_regions[DN][0]) ) sc->xm[count] = count;
 
                         // x+1  -> if current node is region 0 for disconnect pair DN and xplus is region 1, or current node is region 1 and xplus is region 0, then disconnect (return self to neighbour map)
                         if (i < sc->NX-1) 
-                            if( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xp] == t->disconnect_regions[DN][0]) ) sc->xp[count] = count;
+                            if( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xp) == t->disconnect_regions[DN][0]) ) sc->xp[count] = count;
 
                         // y-1
                         if (j > 0)
-                            if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_ym] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_ym] == t->disconnect_regions[DN][0]) ) sc->ym[count] = count;
+                            if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_ym) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_ym) == t->disconnect_regions[DN][0]) ) sc->ym[count] = count;
 
                         // y+1
                         if (j < sc->NY-1)
-                            if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_yp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_yp] == t->disconnect_regions[DN][0]) ) sc->yp[count] = count;
+                            if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_yp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_yp) == t->disconnect_regions[DN][0]) ) sc->yp[count] = count;
 
                         // z-1
                         if (k > 0)
-                            if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_zm] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_zm] == t->disconnect_regions[DN][0]) ) sc->zm[count] = count;
+                            if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_zm) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_zm) == t->disconnect_regions[DN][0]) ) sc->zm[count] = count;
 
                         // z+1
                         if (k < sc->NZ-1)
-                            if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_zp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_zp] == t->disconnect_regions[DN][0]) ) sc->zp[count] = count;
+                            if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_zp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_zp) == t->disconnect_regions[DN][0]) ) sc->zp[count] = count;
 
                         // x-1 y-1
                         if (i > 0 && j > 0)
-                            if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xm_ym] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xm_ym] == t->disconnect_regions[DN][0]) ) sc->xm_ym[count] = count;
+                            if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xm_ym) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xm_ym) == t->disconnect_regions[DN][0]) ) sc->xm_ym[count] = count;
 
                         // x-1 y+1
                         if (i > 0 && j < sc->NY-1)
-                            if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xm_yp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xm_yp] == t->disconnect_regions[DN][0]) ) sc->xm_yp[count] = count;
+                            if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xm_yp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xm_yp) == t->disconnect_regions[DN][0]) ) sc->xm_yp[count] = count;
 
                         // x-1 z-1
                         if (i > 0 && k > 0)
-                            if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xm_zm] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xm_zm] == t->disconnect_regions[DN][0]) ) sc->xm_zm[count] = count;
+                            if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xm_zm) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xm_zm) == t->disconnect_regions[DN][0]) ) sc->xm_zm[count] = count;
 
                         // x-1 z+1
                         if (i > 0 && k < sc->NZ-1)
-                            if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xm_zp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xm_zp] == t->disconnect_regions[DN][0]) ) sc->xm_zp[count] = count;
+                            if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xm_zp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xm_zp) == t->disconnect_regions[DN][0]) ) sc->xm_zp[count] = count;
 
                         // x+1 y-1
                         if (i < sc->NX-1 && j > 0)
-                            if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xp_ym] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xp_ym] == t->disconnect_regions[DN][0]) ) sc->xp_ym[count] = count;
+                            if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xp_ym) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xp_ym) == t->disconnect_regions[DN][0]) ) sc->xp_ym[count] = count;
 
                         // x+1 y+1
                         if (i < sc->NX-1 && j < sc->NY-1)
-                            if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xp_yp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xp_yp] == t->disconnect_regions[DN][0]) ) sc->xp_yp[count] = count;
+                            if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xp_yp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xp_yp) == t->disconnect_regions[DN][0]) ) sc->xp_yp[count] = count;
 
                         // x+1 z-1
                         if (i < sc->NX-1 && k > 0)
-                            if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xp_zm] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xp_zm] == t->disconnect_regions[DN][0]) ) sc->xp_zm[count] = count;
+                            if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xp_zm) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xp_zm) == t->disconnect_regions[DN][0]) ) sc->xp_zm[count] = count;
 
                         // x+1 z+1
                         if (i < sc->NX-1 && k < sc->NZ-1)
-                            if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xp_zp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xp_zp] == t->disconnect_regions[DN][0]) ) sc->xp_zp[count] = count;
+                            if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xp_zp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xp_zp) == t->disconnect_regions[DN][0]) ) sc->xp_zp[count] = count;
 
                         // y-1 z-1
                         if (j > 0 && k > 0)
-                            if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_ym_zm] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_ym_zm] == t->disconnect_regions[DN][0]) ) sc->ym_zm[count] = count;
+                            if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_ym_zm) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_ym_zm) == t->disconnect_regions[DN][0]) ) sc->ym_zm[count] = count;
 
                         // y-1 z+1
                         if (j > 0 && k < sc->NZ-1)
-                            if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_ym_zp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_ym_zp] == t->disconnect_regions[DN][0]) ) sc->ym_zp[count] = count;
+                            if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_ym_zp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_ym_zp) == t->disconnect_regions[DN][0]) ) sc->ym_zp[count] = count;
 
                         // y+1 z-1
                         if (j < sc->NY-1 && k > 0)
-                            if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_yp_zm] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_yp_zm] == t->disconnect_regions[DN][0]) ) sc->yp_zm[count] = count;
+                            if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_yp_zm) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_yp_zm) == t->disconnect_regions[DN][0]) ) sc->yp_zm[count] = count;
 
                         // y+1 z+1
                         if (j < sc->NY-1 && k < sc->NZ-1)
-                            if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_yp_zp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_yp_zp] == t->disconnect_regions[DN][0]) ) sc->yp_zp[count] = count;
+                            if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_yp_zp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_yp_zp) == t->disconnect_regions[DN][0]) ) sc->yp_zp[count] = count;
 
                         // x, y,z
                         if (i > 0 && j > 0 && k > 0)
-                            if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xm_ym_zm] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xm_ym_zm] == t->disconnect_regions[DN][0]) ) sc->xm_ym_zm[count] = count;
+                            if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xm_ym_zm) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xm_ym_zm) == t->disconnect_regions[DN][0]) ) sc->xm_ym_zm[count] = count;
                         if (i > 0 && j > 0 && k < sc->NZ-1)
-                            if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xm_ym_zp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xm_ym_zp] == t->disconnect_regions[DN][0]) ) sc->xm_ym_zp[count] = count;
+                            if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xm_ym_zp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xm_ym_zp) == t->disconnect_regions[DN][0]) ) sc->xm_ym_zp[count] = count;
                         if (i > 0 && j < sc->NY-1 && k > 0)
-                            if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xm_yp_zm] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xm_yp_zm] == t->disconnect_regions[DN][0]) ) sc->xm_yp_zm[count] = count;
+                            if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xm_yp_zm) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xm_yp_zm) == t->disconnect_regions[DN][0]) ) sc->xm_yp_zm[count] = count;
                         if (i > 0 && j < sc->NY-1 && k < sc->NZ-1)
-                            if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xm_yp_zp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xm_yp_zp] == t->disconnect_regions[DN][0]) ) sc->xm_yp_zp[count] = count;
+                            if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xm_yp_zp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xm_yp_zp) == t->disconnect_regions[DN][0]) ) sc->xm_yp_zp[count] = count;
                         if (i < sc->NX-1 && j > 0 && k > 0)
-                            if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xp_ym_zm] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xp_ym_zm] == t->disconnect_regions[DN][0]) ) sc->xp_ym_zm[count] = count;
+                            if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xp_ym_zm) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xp_ym_zm) == t->disconnect_regions[DN][0]) ) sc->xp_ym_zm[count] = count;
                         if (i < sc->NX-1 && j > 0 && k < sc->NZ-1)
-                            if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xp_ym_zp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xp_ym_zp] == t->disconnect_regions[DN][0]) ) sc->xp_ym_zp[count] = count;
+                            if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xp_ym_zp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xp_ym_zp) == t->disconnect_regions[DN][0]) ) sc->xp_ym_zp[count] = count;
                         if (i < sc->NX-1 && j < sc->NY-1 && k > 0)
-                            if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xp_yp_zm] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xp_yp_zm] == t->disconnect_regions[DN][0]) ) sc->xp_yp_zm[count] = count;
+                            if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xp_yp_zm) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xp_yp_zm) == t->disconnect_regions[DN][0]) ) sc->xp_yp_zm[count] = count;
                         if (i < sc->NX-1 && j < sc->NY-1 && k < sc->NZ-1)
-                            if ( (sc->geo[idx] == t->disconnect_regions[DN][0] && sc->geo[idx_xp_yp_zp] == t->disconnect_regions[DN][1]) || (sc->geo[idx] == t->disconnect_regions[DN][1] && sc->geo[idx_xp_yp_zp] == t->disconnect_regions[DN][0]) ) sc->xp_yp_zp[count] = count;
+                            if ( (SC_geo(sc, idx) == t->disconnect_regions[DN][0] && SC_geo(sc, idx_xp_yp_zp) == t->disconnect_regions[DN][1]) || (SC_geo(sc, idx) == t->disconnect_regions[DN][1] && SC_geo(sc, idx_xp_yp_zp) == t->disconnect_regions[DN][0]) ) sc->xp_yp_zp[count] = count;
 
                     } // end DN for
                     count++; // ensure count is updated for every node, independent of connection type
@@ -3913,7 +4099,7 @@ void create_phasemap_2D(int * phase, SC_variables sc, const char* Output_dir)
         for (int i = 0; i < sc.NX; i++)
         {
             int idx = i + (sc.NX*j);
-            if (sc.geo[idx] > 0)
+            if (SC_geo(&sc, idx) > 0)
             {
                 x = i - Cx;
                 y = j - Cy;
@@ -3959,7 +4145,7 @@ void create_phasemap_2D(int * phase, SC_variables sc, const char* Output_dir)
             for (int i = 0; i < sc.NX; i++)
             {
                 int idx = i + (sc.NX*j);
-                if (sc.geo[idx] > 0)
+                if (SC_geo(&sc, idx) > 0)
                 {
                     fprintf(out, "%d ", phase[cell_count]);
                     cell_count++;
@@ -3991,7 +4177,7 @@ void create_phasemap_3D(int * phase, SC_variables sc, const char* Output_dir)
             for (int i = 0; i < sc.NX; i++)
             {
                 int idx = i + (sc.NX*j) + (sc.NX * sc.NY * k);
-                if (sc.geo[idx] > 0)
+                if (SC_geo(&sc, idx) > 0)
                 {
                     x = i - Cx;
                     y = j - Cy;
@@ -4038,7 +4224,7 @@ void create_phasemap_3D(int * phase, SC_variables sc, const char* Output_dir)
             for (int i = 0; i < sc.NX; i++)
             {
                 int idx = i + (sc.NX*j) + (sc.NX * sc.NY * k);
-                if (sc.geo[idx] > 0)
+                if (SC_geo(&sc, idx) > 0)
                 {
                     fprintf(out, "%d ", phase[cell_count]);
                     cell_count++;
@@ -4250,20 +4436,8 @@ void compute_conduction_success(Tissue_parameters t, Model_variables *var, int N
 {
     int left_ex, right_ex, ex_type;
 
-    // if its most recent excitation is after the time of S2 stimulus, it was successful
-    // This is of course not infallable, if your situation is such that at time of S2, S1 is still propagating
-    // But works for almost all cases and doesn't seem worth the additional functionality
-
-    // Left success
-    if (var[3].t_ex > S2_time-5) left_ex = 1; 
-    else left_ex = 0;
-
-    // Right success
-    if (var[N - 3].t_ex > S2_time-5) right_ex = 1; 
-    else right_ex = 0;
-
     // Determine excitation type
-    ex_type = left_ex + right_ex; // 0 for no conduction, 1 for uni block, 2 for full conduction
+    ex_type = conduction_success_type(var, N, S2_time, &left_ex, &right_ex); // 0 for no conduction, 1 for uni block, 2 for full conduction
 
     // Print to screen
     printf("S2 loc = %d\t S2 = %f\tleft excitation = %d\tright excitation = %d\tconduction success type = %d\n", t.S2_x_loc, S2_CL, left_ex, right_ex, ex_type);
@@ -4279,5 +4453,23 @@ void compute_conduction_success(Tissue_parameters t, Model_variables *var, int N
 
     free(log_reference);
 }
+
+// Returns 0 for no conduction, 1 for uni-directional block, 2 for full conduction || also used by S2 sweeps (lib/S2_sweep.cpp)
+int conduction_success_type(Model_variables *var, int N, double S2_time, int *left_ex, int *right_ex)
+{
+    // if its most recent excitation is after the time of S2 stimulus, it was successful
+    // This is of course not infallable, if your situation is such that at time of S2, S1 is still propagating
+    // But works for almost all cases and doesn't seem worth the additional functionality
+
+    // Left success
+    if (var[3].t_ex > S2_time-5) *left_ex = 1; 
+    else *left_ex = 0;
+
+    // Right success
+    if (var[N - 3].t_ex > S2_time-5) *right_ex = 1; 
+    else *right_ex = 0;
+
+    return *left_ex + *right_ex;
+}
 // End Conduction success calculation ===========================================================//|
 
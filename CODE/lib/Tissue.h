@@ -83,9 +83,12 @@ void set_global_orientation_direction_from_arg(Cell_parameters p, Tissue_paramet
 // Array allocation and deallocation 
 void tissue_array_allocation(Tissue_parameters *t, int Ncell);
 void tissue_array_deallocation(Tissue_parameters *t);
+double tissue_release_setup_arrays(Tissue_parameters *t, int N);
+int tissue_cell_configurations(Cell_parameters *Params, Tissue_parameters t, SC_variables sc, int *config, int *representative);
 
 // Create or read geometries
-void select_tissue_geometry_function(Tissue_parameters t, SC_variables *sc, const char *PATH, const char* Output_dir);
+void select_tissue_geometry_function(Tissue_parameters t, SC_variables *sc, const char *PATH, const char* Output_dir, bool diagnostics);
+void tissue_geometry_vtk_output(Tissue_parameters t, SC_variables *sc, const char* Output_dir, bool diagnostics);
 void create_idealised_geometry_homogeneous(SC_variables *sc);
 void create_idealised_geometry_heterogeneous(SC_variables *sc, Tissue_parameters t);
 
@@ -100,6 +103,7 @@ void set_orientation(SC_variables *sc, Tissue_parameters t, const char *PATH, co
 void create_orientation_ideal(SC_variables *sc, Tissue_parameters t);
 void read_orientation_anatomical(SC_variables *sc, Tissue_parameters t, const char *PATH);
 void read_orientation_anatomical_transverse(SC_variables *sc, Tissue_parameters t, const char *PATH);
+bool read_orientation_binary(SC_variables *sc, Tissue_parameters t, const char *PATH, const char *index, double *ox, double *oy, double *oz);
 void output_fibre_orientation(SC_variables sc, Tissue_parameters t, const char* Output_dir);
 void output_fibre_orientation_o2(SC_variables sc, Tissue_parameters t, const char* Output_dir);
 void output_fibre_orientation_o3(SC_variables sc, Tissue_parameters t, const char* Output_dir);
@@ -124,6 +128,7 @@ void calculate_CV(Tissue_parameters t, Model_variables *var, const char* directo
 
 // Conduction success calculation
 void compute_conduction_success(Tissue_parameters t, Model_variables *var, int N, double S2_time, double S2_CL, const char* directory);
+int conduction_success_type(Model_variables *var, int N, double S2_time, int *left_ex, int *right_ex);
 
 // Disconnect regions
 void Modify_neighbours_region_disconnect(SC_variables *sc, Tissue_parameters *t);
@@ -0,0 +1,428 @@
+// Source code associated with  ===========================  //
+// "Multi-scale cardiac simulation framework" =============  //
+// For simulation of cardiac cellular and tissue dynamics =  //
+// from the spatial cellular to full organ scales. ========  //
+// With implementation of multiple, published cell models =  //
+// as well as novel models developed in my lab. ===========  //
+// ========================================================  //
+// This file: Content-hashed cache of the assembled =======  //
+// tissue geometry and spatial operator ===================  //
+// ========================================================  //
+// GNU 3 LICENSE TEXT =====================================  //
+// COPYRIGHT (C) 2016-2019 MICHAEL A. COLMAN ==============  //
+// THIS PROGRAM IS FREE SOFTWARE: YOU CAN REDISTRIBUTE IT =  //
+// AND/OR MODIFY IT UNDER THE TERMS OF THE GNU GENERAL ====  //
+// PUBLIC LICENSE AS PUBLISHED BY THE FREE SOFTWARE =======  //
+// FOUNDATION, EITHER VERSION 3 OF THE LICENSE, OR (AT YOUR  //
+// OPTION) ANY LATER VERSION. =============================  //
+// THIS PROGRAM IS DISTRIBUTED IN THE HOPE THAT IT WILL BE=  //
+// USEFUL, BUT WITHOUT ANY WARRANTY; WITHOUT EVEN THE =====  //
+// IMPLIED WARRANTY OF MERCHANTABILITY OR FITNESS FOR A ===  //
+// PARTICULAR PURPOSE.  SEE THE GNU GENERAL PUBLIC LICENSE=  //
+// FOR MORE DETAILS. ======================================  //
+// YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL =====  //
+// PUBLIC LICENSE ALONG WITH THIS PROGRAM.  IF NOT, SEE ===  //
+// <https://www.gnu.org/licenses/>. =======================  //
+// ========================================================  //
+// ADDITIONAL LICENSE TEXT ================================  //
+// THIS SOFTWARE IS PROVIDED OPEN SOURCE AND MAY BE FREELY=  //
+// USED, DISTRIBUTED AND UPDATED, PROVIDED: ===============  //
+//  (i) THE APPROPRIATE WORK(S) IS(ARE) CITED. THIS =======  //
+//      PERTAINS TO THE CITATION OF COLMAN 2019 PLOS COMP =  //
+//      BIOL (FOR THIS IMPLEMTATION) AND ALL WORKS ========  //
+//      ASSOCIATED WITH THE SPECIFIC MODELS AND COMPONENTS=  //
+//      USED IN PARTICULAR SIMULATIONS. IT IS THE USER'S ==  //
+//      RESPONSIBILITY TO ENSURE ALL RELEVANT WORKS ARE ===  //
+//      CITED. PLEASE SEE FULL DOCUMENTATION AND ON-SCREEN=  //
+//      DISCLAIMER OUTPUTS FOR A GUIDE. ===================  //
+//  (ii) ALL OF THIS TEXT IS RETAINED WITHIN OR ASSOCIATED=  //
+//      WITH THE SOURCE CODE AND/OR BINARY FORM OF THE ====  //
+//      SOFTWARE. =========================================  //
+// ========================================================  //
+// ANY INTENDED COMMERCIAL USE OF THIS SOFTWARE MUST BE BY   //
+// EXPRESS PERMISSION OF MICHAEL A COLMAN ONLY. IN NO EVENT  //
+// ARE THE COPYRIGHT HOLDERS LIABLE FOR ANY DIRECT, =======  //
+// INDIRECT INCIDENTAL, SPECIAL, EXEMPLARY OR CONSEQUENTIAL  //
+// DAMAGES ASSOCIATED WITH USE OF THIS SOFTWARE ===========  //
+// ========================================================  //
+// THIS SOFTWARE CONTAINS IMPLEMENTATIONS OF MODELS AND ===  //
+// COMPONENTS WHICH I (MICHAEL COLMAN) DID NOT DEVELOP.====  //
+// ALL OF THESE COMPONENTS HAVE BEEN CODED FROM PROVIDED ==  //
+// SOURCE CODE OR INFORMATION IN THE PUBLICATIONS. ========  //
+// I CLAIM NO RIGHTS OR INTELLECTUAL PROPERTY OWNERSHIP ===  //
+// FOR THESE MODELS AND COMPONENTS, OTHER THAN THEIR ======  //
+// SPECIFIC IMPLEMENTATION IN THIS CODE PACKAGE. FURTHER TO  //
+// THE ABOVE STATEMENT, ANY INDTENDED COMMERCIAL USE OF ===  //
+// THOSE COMPONENTS MUST BE BY EXPRESS PERMISSION OF THE ==  //
+// ORIGINAL COPYRIGHT HOLDERS. ============================  //
+// WHERE IMPLEMENTED FROM PROVIDED CODE, ANY DISCLAIMERS ==  //
+// PRESENT IN THE ORIGINAL CODE HAVE BEEN RETAINED IN THE =  //
+// RELEVANT FILE. =========================================  //
+// ========================================================  //
+// Contact: m.a.colman@leeds.ac.uk ========================  //
+// For updates, corrections etc, please check: ============  //
+// 1. http://physicsoftheheart.com/ =======================  //
+// 2. https://github.com/michaelcolman ====================  //
+// ========================================================  //
+
+#include "Tissue_cache.h"
+#include "Structs.h"
+#include "Spatial_coupling.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <omp.h>
+
+// Function list ================================================================================\\|
+//	tissue_cache_init()
+//	tissue_cache_load()
+//	tissue_cache_store()
+//
+//	Internal
+//	    tc_hash()
+//	    tc_hash_file()
+//	    tc_add_input()
+//	    tc_registry()
+//	    tc_count()
+// End Function list ============================================================================//|
+
+// Notes ========================================================================================\\|
+// Tissue setup (geometry text parsed per voxel, fibre files, index and neighbour maps, D tensor,
+// its differentials and the laplacian weights of every cell) depends only on the tissue settings
+// and the files in PATH/Tissue_geometries, so it is the same for every run on the same mesh. 
+// With Tissue_cache On (or auto and an anatomical geometry), the first run stores the assembled 
+// SC arrays in PATH/Tissue_cache/Tissue_cache_<key>.bin; later runs with the same key read them
+// back and skip the setup. The key is a 64-bit FNV-1a hash of:
+//  - every tissue setting used by the setup (sizes, dx, D, anisotropy, D scaling and maps, regions,
+//    file names), the cache version and the build time of the executable (any rebuild, which may
+//    change the setup code, starts a new cache)
+//  - the size and contents of every input file (geometry, fibres, D maps), hashed on every run
+// so edited inputs or settings never reuse a stale cache. Stale caches are not deleted.
+// File layout (native byte order): header, input file table (name, bytes, hash), array table
+// (name, element size, count, offset), then the arrays, each starting on a TC_ALIGN boundary so 
+// that the file may be mapped directly. Written to a temporary name and renamed when complete.
+// Not cached (always recomputed): stimulus areas and the cell parameter maps (ISO, ACh, ...).
+// End Notes ====================================================================================//|
+
+// File header
+typedef struct{
+	char        magic[8];
+	int32_t     version;
+	int32_t     Ninputs;
+	int32_t     Narrays;
+	int32_t     N, NX, NY, NZ;
+	int32_t     Nbricks;
+	double      dx, dy, dz;
+	uint64_t    key;
+	char        build[32];
+}TC_header;
+
+// SC array held in the cache
+typedef struct{
+	const char  *name;
+	void        **data;
+	int         size;
+	int         kind;
+}TC_entry;
+
+// Internal =====================================================================================\\|
+static uint64_t tc_hash(uint64_t h, const void *data, size_t n)
+{
+	const unsigned char *d = (const unsigned char*)data;
+	for (size_t i = 0; i < n; i++) { h ^= d[i]; h *= 1099511628211ull; }
+	return h;
+}
+
+static uint64_t tc_hash_file(const char *filename, int64_t *bytes)
+{
+	uint64_t h  = 14695981039346656037ull;
+	*bytes      = -1;
+	FILE *in    = fopen(filename, "rb");
+	if (in == NULL) return 0;
+
+	unsigned char *buffer = (unsigned char*)malloc(1 << 20);
+	size_t n;
+	*bytes = 0;
+	while ((n = fread(buffer, 1, 1 << 20, in)) > 0)
+	{
+		h = tc_hash(h, buffer, n);
+		*bytes += n;
+	}
+	free(buffer);
+	fclose(in);
+	return h;
+}
+
+static void tc_add_input(Tissue_cache *tc, const char *PATH, const char *name)
+{
+	if (name == NULL || tc->Ninputs == TC_MAX_INPUTS) return;
+	TC_input *in = &tc->input[tc->Ninputs++];
+	char filename[1000];
+	snprintf(in->name, TC_PATH_LENGTH, "%s", name);
+	sprintf(filename, "%s/Tissue_geometries/%s", PATH, name);
+	in->hash = tc_hash_file(filename, &in->bytes);
+}
+
+#define TC_INT(f)       { #f, (void**)&sc->f, (int)sizeof(int), TC_CELLS }
+#define TC_DOUBLE(f)    { #f, (void**)&sc->f, (int)sizeof(double), TC_CELLS }
+
+// All SC arrays set up before the time loop (FDM models)
+static int tc_registry(SC_variables *sc, TC_entry *e)
+{
+	TC_entry list[] = {
+		{ "brick", (void**)&sc->brick, (int)sizeof(int), TC_BRICK_TABLE },
+		{ "brick_geo", (void**)&sc->brick_geo, (int)sizeof(int), TC_BRICKS }, { "brick_index", (void**)&sc->brick_index, (int)sizeof(int), TC_BRICKS },
+		TC_INT(geo_linear), TC_INT(geo_3D_index), TC_INT(x_index), TC_INT(y_index), TC_INT(z_index),
+		TC_DOUBLE(D), TC_DOUBLE(D1), TC_DOUBLE(D2),
+		TC_DOUBLE(Dxx), TC_DOUBLE(Dyy), TC_DOUBLE(Dzz), TC_DOUBLE(Dxy), TC_DOUBLE(Dxz), TC_DOUBLE(Dyz),
+		TC_DOUBLE(dDxx_dx), TC_DOUBLE(dDxy_dx), TC_DOUBLE(dDxz_dx), TC_DOUBLE(dDyy_dy), TC_DOUBLE(dDxy_dy),
+		TC_DOUBLE(dDyz_dy), TC_DOUBLE(dDzz_dz), TC_DOUBLE(dDxz_dz), TC_DOUBLE(dDyz_dz),
+		TC_INT(xp), TC_INT(xm), TC_INT(yp), TC_INT(ym), TC_INT(zp), TC_INT(zm),
+		TC_INT(xp_yp), TC_INT(xp_ym), TC_INT(xp_zp), TC_INT(xp_zm), TC_INT(xm_yp), TC_INT(xm_ym),
+		TC_INT(xm_zp), TC_INT(xm_zm), TC_INT(yp_zp), TC_INT(yp_zm), TC_INT(ym_zp), TC_INT(ym_zm),
+		TC_INT(xm_ym_zm), TC_INT(xm_ym_zp), TC_INT(xm_yp_zm), TC_INT(xm_yp_zp),
+		TC_INT(xp_ym_zm), TC_INT(xp_ym_zp), TC_INT(xp_yp_zm), TC_INT(xp_yp_zp),
+		TC_DOUBLE(ox), TC_DOUBLE(oy), TC_DOUBLE(oz), TC_DOUBLE(ox2), TC_DOUBLE(oy2), TC_DOUBLE(oz2),
+		TC_DOUBLE(ox3), TC_DOUBLE(oy3), TC_DOUBLE(oz3),
+		TC_DOUBLE(lap_self), TC_DOUBLE(lap_xm), TC_DOUBLE(lap_xp), TC_DOUBLE(lap_ym), TC_DOUBLE(lap_yp),
+		TC_DOUBLE(lap_zm), TC_DOUBLE(lap_zp), TC_DOUBLE(lap_xm_ym), TC_DOUBLE(lap_xm_yp), TC_DOUBLE(lap_xp_ym),
+		TC_DOUBLE(lap_xp_yp), TC_DOUBLE(lap_xm_zm), TC_DOUBLE(lap_xm_zp), TC_DOUBLE(lap_xp_zm), TC_DOUBLE(lap_xp_zp),
+		TC_DOUBLE(lap_ym_zm), TC_DOUBLE(lap_ym_zp), TC_DOUBLE(lap_yp_zm), TC_DOUBLE(lap_yp_zp)
+	};
+	int n = sizeof(list)/sizeof(list[0]);
+	for (int i = 0; i < n; i++) e[i] = list[i];
+	return n;
+}
+
+static int64_t tc_count(SC_variables *sc, int kind)
+{
+	if (kind == TC_BRICK_TABLE) return (int64_t)sc->BX*sc->BY*sc->BZ;
+	if (kind == TC_BRICKS)      return (int64_t)sc->Nbricks*SC_BRICK_VOLUME;
+	return sc->N;
+}
+// End Internal =================================================================================//|
+
+// Key from settings and inputs; look for a matching cache ======================================\\|
+void tissue_cache_init(Tissue_cache *tc, Simulation_parameters sim, Tissue_parameters t, SC_variables *sc, const char *PATH)
+{
+	tc->on      = false;
+	tc->hit     = false;
+	tc->Windows = sim.Windows;
+	tc->Ninputs = 0;
+	tc->start   = omp_get_wtime();
+	if (strcmp(sim.Tissue_cache, "Off") == 0) return;
+	if (strcmp(sim.Tissue_cache, "auto") == 0 && strcmp(t.Tissue_order, "geo") != 0) return;
+	tc->on = true;
+
+	// Input files (anatomical models only; idealised geometries are created from the settings)
+	if (strcmp(t.Tissue_order, "geo") == 0)
+	{
+		tc_add_input(tc, PATH, t.geo_file);
+		if (strcmp(t.Orientation_type, "isotropic") != 0 && t.orientation_file_root != NULL)
+		{
+			const char *suffix[] = {"OX", "OY", "OZ", "orientation", "theta", "phi", "OX2", "OY2", "OZ2", "orientation2", "OX3", "OY3", "OZ3", "orientation3"};
+			char name[TC_PATH_LENGTH];
+			for (int i = 0; i < 14; i++)
+			{
+				snprintf(name, sizeof(name), "%s_%s.dat", t.orientation_file_root, suffix[i]);
+				tc_add_input(tc, PATH, name);
+			}
+		}
+		if (strcmp(t.map_in_type, "file") == 0)
+		{
+			if (strcmp(t.D_uniformity, "map") == 0 || strcmp(t.D_uniformity, "regional_map") == 0)
+			{
+				tc_add_input(tc, PATH, t.Dscale_base_map_file);
+				tc_add_input(tc, PATH, t.D_AR_scale_base_map_file);
+			}
+			if (strcmp(t.Dscale_map_on, "On") == 0)     tc_add_input(tc, PATH, t.Dscale_mod_map_file);
+			if (strcmp(t.D_AR_scale_map_on, "On") == 0) tc_add_input(tc, PATH, t.D_AR_scale_mod_map_file);
+		}
+	}
+
+	// Settings used by the setup (only those that apply, as the others may be unset)
+	char settings[20000];
+	bool regional   = (strcmp(t.D_uniformity, "regional") == 0 || strcmp(t.D_uniformity, "regional_map") == 0);
+	bool map_coords = (strcmp(t.map_in_type, "coords") == 0 && (strcmp(t.Dscale_map_on, "On") == 0 || strcmp(t.D_AR_scale_map_on, "On") == 0));
+	int len = snprintf(settings, sizeof(settings), "%d %s %s|%s %s %s %s %s|%d %d %d|%.17g %.17g|%.17g %.17g %.17g|%.17g %.17g %s %s %s|%d",
+		TC_VERSION, __DATE__, __TIME__,
+		t.Tissue_order, t.Tissue_model, t.Tissue_type, t.Orientation_type, t.D_uniformity,
+		t.NX, t.NY, t.NZ, t.D1, t.D_AR, t.dx, t.dy, t.dz,
+		t.Dscale, t.D_AR_scale, t.Dscale_map_on, t.D_AR_scale_map_on, t.map_in_type, t.Ncelltypes);
+	if (strcmp(t.Orientation_type, "isotropic") != 0)
+	{
+		len += snprintf(settings + len, sizeof(settings) - len, "|%s %.17g %.17g %.17g", t.Global_orientation_direction, t.OX, t.OY, t.OZ);
+		if (strcmp(t.Tissue_order, "geo") == 0) len += snprintf(settings + len, sizeof(settings) - len, " %s", t.orientation_file_type);
+	}
+	if (map_coords)
+		len += snprintf(settings + len, sizeof(settings) - len, "|%d %d %d %d %d %d %s", t.ideal_map_x_loc, t.ideal_map_x_size, t.ideal_map_y_loc, t.ideal_map_y_size, t.ideal_map_z_loc, t.ideal_map_z_size, t.ideal_map_shape);
+	if (strcmp(t.Tissue_type, "heterogeneous") == 0 || regional)
+		for (int i = 1; i <= t.Ncelltypes && i < 50; i++) len += snprintf(settings + len, sizeof(settings) - len, "|%d", t.het_junction_X_location[i]);
+	if (regional)
+		for (int i = 1; i <= t.Ncelltypes && i < 50; i++) len += snprintf(settings + len, sizeof(settings) - len, "|%.17g %.17g", t.non_uniform_D1_scale[i], t.non_uniform_AR_scale[i]);
+	if (t.disconnect_regions_flag == true)
+		for (int i = 0; i < t.Ndisconnected_regions && i < 50; i++) len += snprintf(settings + len, sizeof(settings) - len, "|%d-%d", t.disconnect_regions[i][0], t.disconnect_regions[i][1]);
+
+	uint64_t h = tc_hash(14695981039346656037ull, settings, strlen(settings));
+	for (int i = 0; i < tc->Ninputs; i++)
+	{
+		h = tc_hash(h, tc->input[i].name, strlen(tc->input[i].name));
+		h = tc_hash(h, &tc->input[i].bytes, sizeof(int64_t));
+		h = tc_hash(h, &tc->input[i].hash, sizeof(uint64_t));
+	}
+	tc->key = h;
+
+	if (tc->Windows == true)    sprintf(tc->filename, "%s\\Tissue_cache\\Tissue_cache_%016llx.bin", PATH, (unsigned long long)tc->key);
+	else                        sprintf(tc->filename, "%s/Tissue_cache/Tissue_cache_%016llx.bin", PATH, (unsigned long long)tc->key);
+
+	// Existing cache for this key?
+	FILE *in = fopen(tc->filename, "rb");
+	if (in == NULL)
+	{
+		printf(">Tissue cache: none for this setup; will be written to %s\n", tc->filename);
+		return;
+	}
+	TC_header head;
+	TC_input input[TC_MAX_INPUTS];
+	bool valid = (fread(&head, sizeof(TC_header), 1, in) == 1 && strcmp(head.magic, "MSCSFTC") == 0 && head.version == TC_VERSION && head.key == tc->key && head.Ninputs == tc->Ninputs 
+	                && head.NX == sc->NX && head.NY == sc->NY && head.NZ == sc->NZ);
+	if (valid && head.Ninputs > 0) valid = (fread(input, sizeof(TC_input), head.Ninputs, in) == (size_t)head.Ninputs);
+	for (int i = 0; valid && i < head.Ninputs; i++)
+		valid = (strcmp(input[i].name, tc->input[i].name) == 0 && input[i].bytes == tc->input[i].bytes && input[i].hash == tc->input[i].hash);
+	fclose(in);
+	if (valid == false)
+	{
+		printf(">Tissue cache: %s does not match this setup; will be rewritten\n", tc->filename);
+		return;
+	}
+
+	tc->hit = true;
+	sc->N   = head.N;
+	printf(">Tissue cache: setup read from %s (key checked in %.2f s)\n", tc->filename, omp_get_wtime() - tc->start);
+}
+// End Key from settings and inputs =============================================================//|
+
+// Read the arrays (after allocation of the Ncell arrays) =======================================\\|
+void tissue_cache_load(Tissue_cache *tc, SC_variables *sc)
+{
+	FILE *in = fopen(tc->filename, "rb");
+	if (in == NULL)
+	{
+		printf("ERROR: cannot open %s\n", tc->filename);
+		exit(1);
+	}
+	TC_header head;
+	TC_array array[TC_MAX_ARRAYS];
+	TC_entry entry[TC_MAX_ARRAYS];
+	int Nentries = tc_registry(sc, entry);
+	fread(&head, sizeof(TC_header), 1, in);
+	fseek(in, head.Ninputs*sizeof(TC_input), SEEK_CUR);
+	if (head.Narrays != Nentries || fread(array, sizeof(TC_array), head.Narrays, in) != (size_t)head.Narrays)
+	{
+		printf("ERROR: tissue cache %s is incomplete; delete it and rerun\n", tc->filename);
+		exit(1);
+	}
+
+	sc->dx = head.dx;
+	sc->dy = head.dy;
+	sc->dz = head.dz;
+	SC_brick_reserve(sc, head.Nbricks);     // lib/Spatial_coupling.cpp
+	sc->Nbricks = head.Nbricks;
+	for (int a = 0; a < head.Narrays; a++)
+	{
+		TC_entry *e     = &entry[a];
+		int64_t count   = tc_count(sc, e->kind);
+		if (strcmp(array[a].name, e->name) != 0 || array[a].size != e->size || array[a].count != count
+		        || fseek(in, array[a].offset, SEEK_SET) != 0 || fread(*e->data, e->size, count, in) != (size_t)count)
+		{
+			printf("ERROR: tissue cache %s is incomplete or from a different version (%s); delete it and rerun\n", tc->filename, array[a].name);
+			exit(1);
+		}
+	}
+	fclose(in);
+	printf(">Tissue cache: %d cells, %d arrays loaded in %.2f s\n", sc->N, head.Narrays, omp_get_wtime() - tc->start);
+}
+// End Read the arrays ==========================================================================//|
+
+// Write the cache (after the laplacian has been calculated) ====================================\\|
+void tissue_cache_store(Tissue_cache *tc, SC_variables *sc)
+{
+	if (tc->on == false || tc->hit == true) return;
+
+	char *mkdirectory = (char*)malloc(1100);
+	char dir[1000];
+	snprintf(dir, sizeof(dir), "%s", tc->filename);
+	*strrchr(dir, tc->Windows ? '\\' : '/') = '\0';
+	if (tc->Windows == true)    sprintf(mkdirectory, "if not exist %s mkdir %s", dir, dir);
+	else                        sprintf(mkdirectory, "mkdir -p %s", dir);
+	system(mkdirectory);
+	free(mkdirectory);
+
+	char tmpname[1100];
+	sprintf(tmpname, "%s.tmp", tc->filename);
+	FILE *out = fopen(tmpname, "wb");
+	if (out == NULL)
+	{
+		printf("WARNING: cannot write tissue cache %s; continuing without it\n", tmpname);
+		return;
+	}
+
+	TC_entry entry[TC_MAX_ARRAYS];
+	TC_array array[TC_MAX_ARRAYS];
+	int Narrays = tc_registry(sc, entry);
+
+	TC_header head;
+	memset(&head, 0, sizeof(TC_header));
+	strcpy(head.magic, "MSCSFTC");
+	head.version    = TC_VERSION;
+	head.Ninputs    = tc->Ninputs;
+	head.Narrays    = Narrays;
+	head.N          = sc->N;
+	head.NX         = sc->NX;
+	head.NY         = sc->NY;
+	head.NZ         = sc->NZ;
+	head.Nbricks    = sc->Nbricks;
+	head.dx         = sc->dx;
+	head.dy         = sc->dy;
+	head.dz         = sc->dz;
+	head.key        = tc->key;
+	snprintf(head.build, sizeof(head.build), "%s %s", __DATE__, __TIME__);
+
+	int64_t offset = sizeof(TC_header) + tc->Ninputs*sizeof(TC_input) + Narrays*sizeof(TC_array);
+	for (int a = 0; a < Narrays; a++)
+	{
+		memset(&array[a], 0, sizeof(TC_array));
+		snprintf(array[a].name, TC_NAME_LENGTH, "%s", entry[a].name);
+		array[a].size   = entry[a].size;
+		array[a].kind   = entry[a].kind;
+		array[a].count  = tc_count(sc, entry[a].kind);
+		offset          = (offset + TC_ALIGN - 1)/TC_ALIGN*TC_ALIGN;
+		array[a].offset = offset;
+		offset         += array[a].count*array[a].size;
+	}
+
+	fwrite(&head, sizeof(TC_header), 1, out);
+	fwrite(tc->input, sizeof(TC_input), tc->Ninputs, out);
+	fwrite(array, sizeof(TC_array), Narrays, out);
+	for (int a = 0; a < Narrays; a++)
+	{
+		fseek(out, array[a].offset, SEEK_SET);
+		fwrite(*entry[a].data, array[a].size, array[a].count, out);
+	}
+
+	if (ferror(out) != 0 || fclose(out) != 0)
+	{
+		printf("WARNING: failed writing tissue cache %s (disk full?); continuing without it\n", tmpname);
+		remove(tmpname);
+		return;
+	}
+	remove(tc->filename);   // rename does not overwrite on all systems
+	if (rename(tmpname, tc->filename) != 0)
+	{
+		printf("WARNING: cannot rename %s to %s\n", tmpname, tc->filename);
+		return;
+	}
+	printf(">Tissue cache: setup (%.1f MB) written to %s\n", offset/1048576.0, tc->filename);
+}
+// End Write the cache ==========================================================================//|
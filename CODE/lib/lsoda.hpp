@@ -102,6 +102,7 @@
 #include <fstream>
 #include <sstream>
 #include <cmath>
+#include <cstring>
 //typedef void    (*_lsoda_f) (double, double *, double *, void *);
 
 
@@ -3557,6 +3558,69 @@ BLAS : daxpy, dscal, idamax
         init = 0;
     }
 
+    //==========================
+    // Checkpoint/restart (lib/Checkpoint.cpp)
+    //==========================
+    // Solver state is the object itself (all scalars, el, elco, tesco etc) followed by rtol, atol
+    // and, once allocated, the contents of the work vectors. Pointers are not carried over:
+    // the ODE pointer and tolerance arrays of this object are kept, and work vectors are
+    // re-allocated at the stored size on unpack, so integration continues bit-identically.
+    size_t checkpoint_bytes()
+    {
+        size_t bytes = sizeof(*this) + 2*(m_neq + 1)*sizeof(double);
+        if (yh != NULL) bytes += ((g_lenyh + 1) + (g_nyh + 1) + 3)*(g_nyh + 1)*sizeof(double) + (g_nyh + 1)*sizeof(int);
+        return bytes;
+    }
+
+    void checkpoint_pack(unsigned char *buffer)
+    {
+        int i;
+        size_t row = (g_nyh + 1)*sizeof(double);
+        memcpy(buffer, this, sizeof(*this));                buffer += sizeof(*this);
+        memcpy(buffer, rtol, (m_neq + 1)*sizeof(double));   buffer += (m_neq + 1)*sizeof(double);
+        memcpy(buffer, atol, (m_neq + 1)*sizeof(double));   buffer += (m_neq + 1)*sizeof(double);
+        if (yh == NULL) return;
+        for (i = 0; i <= g_lenyh; i++) { memcpy(buffer, yh[i], row); buffer += row; }
+        for (i = 0; i <= g_nyh; i++)   { memcpy(buffer, wm[i], row); buffer += row; }
+        memcpy(buffer, ewt, row);   buffer += row;
+        memcpy(buffer, savf, row);  buffer += row;
+        memcpy(buffer, acor, row);  buffer += row;
+        memcpy(buffer, ipvt, (g_nyh + 1)*sizeof(int));
+    }
+
+    void checkpoint_unpack(const unsigned char *buffer)
+    {
+        int i;
+        ODE *ode_keep       = ode;
+        double *rtol_keep   = rtol;
+        double *atol_keep   = atol;
+
+        _freevectors();
+        memcpy(this, buffer, sizeof(*this));    buffer += sizeof(*this);
+        bool allocated = (yh != NULL);          // pointer values are stale; only used as a flag
+        ode = ode_keep; rtol = rtol_keep; atol = atol_keep;
+        yh = wm = NULL; ewt = savf = acor = NULL; ipvt = NULL;
+        yp1 = yp2 = y = NULL;
+
+        memcpy(rtol, buffer, (m_neq + 1)*sizeof(double));   buffer += (m_neq + 1)*sizeof(double);
+        memcpy(atol, buffer, (m_neq + 1)*sizeof(double));   buffer += (m_neq + 1)*sizeof(double);
+        if (allocated == false)
+        {
+            g_nyh = g_lenyh = 0;
+            return;
+        }
+
+        size_t row = (g_nyh + 1)*sizeof(double);
+        yh = new double * [1 + g_lenyh];
+        for (i = 0; i <= g_lenyh; i++) { yh[i] = new double [1 + g_nyh]; memcpy(yh[i], buffer, row); buffer += row; }
+        wm = new double * [1 + g_nyh];
+        for (i = 0; i <= g_nyh; i++)   { wm[i] = new double [1 + g_nyh]; memcpy(wm[i], buffer, row); buffer += row; }
+        ewt     = new double [1 + g_nyh];   memcpy(ewt, buffer, row);   buffer += row;
+        savf    = new double [1 + g_nyh];   memcpy(savf, buffer, row);  buffer += row;
+        acor    = new double [1 + g_nyh];   memcpy(acor, buffer, row);  buffer += row;
+        ipvt    = new int [1 + g_nyh];      memcpy(ipvt, buffer, (g_nyh + 1)*sizeof(int));
+    }
+
 
 private:
     int g_nyh, g_lenyh;
@@ -117,6 +117,35 @@ class Myofilament
 		void LSODA_solve();
 		void LSODA_set();
 
+		// Checkpoint/restart (lib/Checkpoint.cpp) || scalars and y_myofilament, followed by the LSODA integrator state
+		// Defined here so that lib/Checkpoint.cpp does not need lib/myofilament.cpp (native models)
+		size_t checkpoint_bytes()
+		{
+			return (NCHECKPOINT + NEQ_myofilament + 1)*sizeof(double) + lsoda_integrator_myofilament.checkpoint_bytes();
+		}
+
+		void checkpoint_pack(unsigned char *buffer)
+		{
+			double v[NCHECKPOINT] = {P0, P1, P2, P3, N0, N1, HTRPNCa, LTRPNCa, myo_Pim, myo_cai, myo_ATPi, myo_ADP,
+				t_myofilament, tout, dt_myof, t, V_AM, Jtrpn, Force, Norm_force};
+			memcpy(buffer, v, sizeof(v));
+			memcpy(buffer + sizeof(v), y_myofilament, (NEQ_myofilament + 1)*sizeof(double));
+			lsoda_integrator_myofilament.checkpoint_pack(buffer + sizeof(v) + (NEQ_myofilament + 1)*sizeof(double));
+		}
+
+		void checkpoint_unpack(const unsigned char *buffer)
+		{
+			double v[NCHECKPOINT];
+			memcpy(v, buffer, sizeof(v));
+			P0 = v[0];	P1 = v[1];	P2 = v[2];	P3 = v[3];
+			N0 = v[4];	N1 = v[5];	HTRPNCa = v[6];	LTRPNCa = v[7];
+			myo_Pim = v[8];	myo_cai = v[9];	myo_ATPi = v[10];	myo_ADP = v[11];
+			t_myofilament = v[12];	tout = v[13];	dt_myof = v[14];	t = v[15];
+			V_AM = v[16];	Jtrpn = v[17];	Force = v[18];	Norm_force = v[19];
+			memcpy(y_myofilament, buffer + sizeof(v), (NEQ_myofilament + 1)*sizeof(double));
+			lsoda_integrator_myofilament.checkpoint_unpack(buffer + sizeof(v) + (NEQ_myofilament + 1)*sizeof(double));
+		}
+
 		double dt_myof;
 		double t;
 		double V_AM;
@@ -141,6 +170,7 @@ class Myofilament
 		double myo_ADP;
 
 		static const int NEQ_myofilament = 8;
+		static const int NCHECKPOINT = 20;  // scalars in checkpoint_pack()
 		// static const int NEQ_myofilament_N = 5;
 		// double atol[NEQ_myofilament+1], rtol[NEQ_myofilament+1], 
 		double t_myofilament;
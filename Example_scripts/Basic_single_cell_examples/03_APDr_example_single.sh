@@ -18,3 +18,8 @@ done
 # Plot Outputs_single_native_APDr_example/Properties_log.dat using colums 1 vs 11 for BCL vs APD_90 and 1 vs 15 for BCL vs minimum voltage for final beat
 # properties
 # Check "BASIC_INSTRUCTIONS_USE.txt" and Full_documentation.pdf for output file contents
+
+# The same restitution curve in a single process, with members run in parallel (model_single_ensemble; see BASIC_USE section 9):
+#printf "version native\nbase Model $model Beats 200\ngrid BCL 250 300 350 400 500 750 1000 1500 2000\ntraces On\n" > APDr_ensemble.txt
+#./model_single_ensemble Ensemble_file APDr_ensemble.txt Reference APDr_example
+# Outputs_single_ensemble_APDr_example/Ensemble_summary.dat then has one line per BCL (columns as Properties_log.dat, shifted by one: 2 vs 12 for BCL vs APD_90)
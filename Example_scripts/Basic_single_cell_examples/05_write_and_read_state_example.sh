@@ -26,6 +26,19 @@ BCL=$(printf "%04d" 350)
 # with the 5 single beats of read simulation)
 # "Results_Write/Currents.dat" using column 1 (data minus 69300) vs 2, and "Results_Read/Currents.dat" using columns 1 vs 2
 
+# Rather than always pacing for 200 beats, Steady_state On ends pacing once APD90, CaT amplitude, Nai and CaSR change by
+# less than set tolerances (Steady_state_tol_{APD90/CaT/Nai/CaSR}, % per beat) for Steady_state_beats consecutive beats, 
+# and writes the state then; Beats is then the maximum. The beat reached is printed, and the change per beat is in 
+# "Outputs_single_native_State_write_read_example_SS/Steady_state_log.dat". With the settings above (alternans) the APD 
+# changes by ~20% every beat and so the run paces for all 200 beats and warns that steady state was not reached; 
+# without alternans (e.g. BCL 1000) it ends after a few tens of beats. 
+#./model_single_native Model $model BCL 1000 Beats 200 Steady_state On Write_state On Reference State_write_read_example_SS Results_Reference Write
+
+# Alternatively, Periodic_orbit On solves for the limit cycle at BCL directly (Newton-Krylov, one beat as a map from the state 
+# at the start of a beat to the state at the start of the next) and writes it; useful for models with slow [Na]i/[K]i drift
+# such as hAM_GB. Progress is in "Outputs_single_native_State_write_read_example_PO/Periodic_orbit_log.dat".
+#./model_single_native Model hAM_GB BCL 1000 Beats 1 Periodic_orbit On Write_state On Reference State_write_read_example_PO Results_Reference Write
+
 # Note that state files are saved independently of the results data (being placed in the PATH directory), and so you need not 
 # worry about accidentally deleting state files when deleting redundant or old data.
 
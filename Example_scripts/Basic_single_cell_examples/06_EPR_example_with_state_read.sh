@@ -60,3 +60,12 @@ done
 # specific to the finer simulation.
 # May also want dvdt_max: column 13 for final, S2 beat and 14 for penultimate, S1 beat.
 # Check "BASIC_INSTRUCTIONS_USE.txt" and Full_documentation.pdf for output file contents
+
+# Alternatively, the whole protocol runs as a single simulation per condition: each BCL is paced 
+# (from 1000 down to 400 ms, continuing from the previous BCL), S1-S2 beats branch from the paced state 
+# in memory, and the ERP is found by bisection to 1 ms (Outputs_single_native_ERP_X/Restitution_ERP.dat; 
+# Restitution_S1S2.dat holds the coarse S2 scan in the Properties_log format)
+#for remodelling in none AF_Col_4
+#do
+#    ./model_single_native Model $model Remodelling $remodelling Restitution All Restitution_BCL 400,1000,600 Restitution_beats 200 Steady_state On Restitution_S2 80,400,5 Reference ERP_${remodelling}
+#done
@@ -49,6 +49,15 @@ done
 #        ./model_tissue_native Tissue_model Vent_transmural Tissue_order 1D Beats 1  S2 ${S2} S2_x_loc ${S2_loc} Reference Vulnerability_window Results_Reference location_${S2_loc}_S2_${S2}
 #done
 
+# Alternatively, the whole calculation can be done in a single run with S2_sweep. The S1 beats are 
+# simulated once and every S2 is branched from an in-memory copy of the state, with branches run
+# concurrently (one per thread by default). "bisect" scans the coarse intervals and then refines 
+# the edges of the window to within S2_sweep_resolution ms; the window for each location is 
+# written to "Outputs_tissue_native_Vulnerability_window_sweep/S2_vulnerability_window.dat" and 
+# every branch is logged in 1D_conduction_success_log.dat as above. 
+
+#./model_tissue_native Tissue_model Vent_transmural Tissue_order 1D Beats 1 S2_sweep bisect S2_sweep_locations 25,75 S2_sweep_CL 150,200,5 Reference Vulnerability_window_sweep
+
 # Check "BASIC_INSTRUCTIONS_USE.txt" and Full_documentation.pdf for output file contents
 
 
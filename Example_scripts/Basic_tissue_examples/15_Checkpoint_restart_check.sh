@@ -0,0 +1,44 @@
+#!/bin/sh
+
+# Checking that a run restarted from a checkpoint reproduces an uninterrupted run.
+
+# A restart (Read_checkpoint) continues the outputs of the run that wrote the checkpoint: the Results
+# files keep their rows up to the checkpoint time and are appended to, and the spatial data container
+# keeps its frames up to the checkpoint and is appended to. So restarting part way through a completed
+# run must give byte-identical Results files and container (Settings.txt differs, as it records the
+# Read_checkpoint setting).
+
+# First, an uninterrupted run writing checkpoints every 50 ms, with spatial data in a container.
+# We keep a copy of its outputs:
+args="Tissue_order 1D Tissue_model basic Model minimal Total_time 200 Checkpoint_interval 50 Checkpoint_keep 10 Spatial_output_interval_data 5 Spatial_output_data_format container Reference Restart_check"
+./model_tissue_native $args
+rm -rf Restart_check_uninterrupted
+cp -r Outputs_tissue_native_Restart_check Restart_check_uninterrupted
+
+# Then restart from the checkpoint at 100 ms (step 100/dt) and run to the end again, in the same directory:
+./model_tissue_native $args Read_checkpoint Outputs_tissue_native_Restart_check/Checkpoints/Checkpoint_step5000.msck
+
+# The same for the integrated (0D) tissue model with spontaneous release, which also continues the list
+# of SRF events (SRF_properties.txt):
+args0D="Tissue_order 1D Tissue_model basic Model minimal BCL 500 Beats 1 Total_time 1000 SRF_mode Direct_Control SRF_Pset General_1 Checkpoint_interval 250 Checkpoint_keep 10 Spatial_output_interval_data 10 Spatial_output_data_format container Reference Restart_check"
+./model_tissue_0D $args0D
+rm -rf Restart_check_uninterrupted_0D
+cp -r Outputs_0Dtissue_Restart_check Restart_check_uninterrupted_0D
+./model_tissue_0D $args0D Read_checkpoint Outputs_0Dtissue_Restart_check/Checkpoints/Checkpoint_step50000.msck
+
+# Compare:
+failed=0
+for pair in "Restart_check_uninterrupted Outputs_tissue_native_Restart_check" "Restart_check_uninterrupted_0D Outputs_0Dtissue_Restart_check"
+do
+	set -- $pair
+	for file in $1/Results/*.txt $1/Spatial_Results/Spatial_data.msc
+	do
+		name=${file#$1/}
+		if [ "$name" = "Results/Settings.txt" ]; then continue; fi
+		if cmp -s $file $2/$name; then echo "same:   $2/$name"; else echo "DIFFER: $2/$name"; failed=1; fi
+	done
+done
+if [ $failed -eq 0 ]; then echo "Restarted runs reproduce the uninterrupted runs"; else echo "Restarted runs differ from the uninterrupted runs"; fi
+exit $failed
+
+# Check "BASIC_INSTRUCTIONS_USE.txt" and Full_documentation.pdf for output file contents